@@ -0,0 +1,58 @@
+#include <benchmark/benchmark.h>
+#include "Utilities/BCEncoder.h"
+#include "Utilities/Image.h"
+#include "Core/Paths.h"
+#include "Utilities/ThreadPool.h"
+
+namespace adria
+{
+	namespace
+	{
+		struct BCBenchmarkCase
+		{
+			GfxFormat format;
+			Char const* texture;
+		};
+		//each format on the kind of texture the material slots give it
+		BCBenchmarkCase const BCBenchmarkCases[] =
+		{
+			{ GfxFormat::BC1_UNORM, "ToyCar/ToyCar_basecolor.png" },
+			{ GfxFormat::BC3_UNORM, "ToyCar/ToyCar_basecolor.png" },
+			{ GfxFormat::BC4_UNORM, "ToyCar/ToyCar_occlusion_roughness_metallic.png" },
+			{ GfxFormat::BC5_UNORM, "ToyCar/ToyCar_normal.png" },
+			{ GfxFormat::BC7_UNORM, "ToyCar/ToyCar_basecolor.png" },
+		};
+	}
+
+	//compresses one 1024x1024 model texture, the second argument is the number of background threads, 0 encodes on the calling thread only
+	static void BM_CompressSurfaceBC(benchmark::State& state)
+	{
+		BCBenchmarkCase const& bc_case = BCBenchmarkCases[state.range(0)];
+		Image img(paths::ModelsDir + bc_case.texture);
+		if (img.Format() != GfxFormat::R8G8B8A8_UNORM)
+		{
+			state.SkipWithError("Texture not found");
+			return;
+		}
+		if (state.range(1) > 0)
+		{
+			g_ThreadPool.Initialize((Uint)state.range(1));
+		}
+
+		std::vector<Uint8> compressed(GetTextureByteSize(bc_case.format, img.Width(), img.Height()));
+		for (auto _ : state)
+		{
+			CompressSurfaceBC(bc_case.format, img.Data(), img.Width(), img.Height(), compressed.data());
+			benchmark::DoNotOptimize(compressed.data());
+		}
+		Float64 const megapixels = (Float64)img.Width() * img.Height() / 1e6;
+		state.SetLabel(GfxFormatToString(bc_case.format));
+		state.counters["megapixels"] = benchmark::Counter(state.iterations() * megapixels, benchmark::Counter::kIsRate);
+		state.counters["workers"] = (Float64)g_ThreadPool.GetWorkerCount();
+		if (state.range(1) > 0)
+		{
+			g_ThreadPool.Shutdown();
+		}
+	}
+	BENCHMARK(BM_CompressSurfaceBC)->ArgsProduct({ benchmark::CreateDenseRange(0, (Int64)std::size(BCBenchmarkCases) - 1, 1), { 0, 1 } })->Unit(benchmark::kMillisecond)->UseRealTime();
+}
@@ -0,0 +1,158 @@
+#include <benchmark/benchmark.h>
+#include "Math/FrustumCulling.h"
+#include "Utilities/ThreadPool.h"
+#include "Utilities/Random.h"
+
+using namespace DirectX;
+
+namespace adria
+{
+	namespace
+	{
+		constexpr Uint64 BOX_COUNT = 100000;
+		constexpr Uint64 CHUNK_SIZE = 8192;
+
+		struct CullingScene
+		{
+			CullingScene()
+			{
+				RealRandomGenerator<Float> random_position(-150.0f, 150.0f, std::mt19937{ 5 });
+				RealRandomGenerator<Float> random_extent(0.1f, 8.0f, std::mt19937{ 6 });
+				boxes.resize(BOX_COUNT);
+				streams.Resize(BOX_COUNT);
+				for (Uint64 i = 0; i < BOX_COUNT; ++i)
+				{
+					boxes[i].Center = XMFLOAT3(random_position(), random_position(), random_position() + 100.0f);
+					boxes[i].Extents = XMFLOAT3(random_extent(), random_extent(), random_extent());
+					streams.Set(i, boxes[i]);
+				}
+				frustum = BoundingFrustum(XMMatrixPerspectiveFovLH(1.0f, 16.0f / 9.0f, 0.1f, 200.0f));
+				frustum.Transform(frustum, XMMatrixRotationRollPitchYaw(0.1f, 0.3f, 0.0f));
+				planes = GetFrustumPlanes(frustum);
+				frustum.GetPlanes(&xm_planes[0], &xm_planes[1], &xm_planes[2], &xm_planes[3], &xm_planes[4], &xm_planes[5]);
+			}
+
+			//the stream test is the per plane box test, ContainedBy with the same planes is its scalar reference
+			void CullReference(std::vector<Uint32>& visible_indices) const
+			{
+				visible_indices.clear();
+				for (Uint64 i = 0; i < BOX_COUNT; ++i)
+				{
+					if (boxes[i].ContainedBy(xm_planes[0], xm_planes[1], xm_planes[2], xm_planes[3], xm_planes[4], xm_planes[5]) != DISJOINT)
+					{
+						visible_indices.push_back((Uint32)i);
+					}
+				}
+			}
+
+			std::vector<BoundingBox> boxes;
+			AABBStreams streams;
+			BoundingFrustum frustum;
+			FrustumPlanes planes;
+			XMVECTOR xm_planes[6];
+		};
+
+		CullingScene const& GetCullingScene()
+		{
+			static CullingScene const scene;
+			return scene;
+		}
+
+		void CheckAgainstReference(benchmark::State& state, std::vector<Uint32> const& visible_indices)
+		{
+			std::vector<Uint32> reference_indices;
+			GetCullingScene().CullReference(reference_indices);
+			if (visible_indices != reference_indices)
+			{
+				state.SkipWithError("visible set differs from the scalar reference");
+			}
+			state.counters["visible"] = (Float64)visible_indices.size();
+			state.SetItemsProcessed(state.iterations() * BOX_COUNT);
+		}
+	}
+
+	//what the renderer did before the box streams, one BoundingFrustum::Intersects per box
+	static void BM_CullScalarIntersects(benchmark::State& state)
+	{
+		CullingScene const& scene = GetCullingScene();
+		std::vector<Uint32> visible_indices;
+		visible_indices.reserve(BOX_COUNT);
+		for (auto _ : state)
+		{
+			visible_indices.clear();
+			for (Uint64 i = 0; i < BOX_COUNT; ++i)
+			{
+				if (scene.frustum.Intersects(scene.boxes[i]))
+				{
+					visible_indices.push_back((Uint32)i);
+				}
+			}
+			benchmark::DoNotOptimize(visible_indices.data());
+		}
+		state.counters["visible"] = (Float64)visible_indices.size();
+		state.SetItemsProcessed(state.iterations() * BOX_COUNT);
+	}
+	BENCHMARK(BM_CullScalarIntersects)->Unit(benchmark::kMicrosecond);
+
+	static void BM_CullScalarPlanes(benchmark::State& state)
+	{
+		CullingScene const& scene = GetCullingScene();
+		std::vector<Uint32> visible_indices;
+		visible_indices.reserve(BOX_COUNT);
+		for (auto _ : state)
+		{
+			scene.CullReference(visible_indices);
+			benchmark::DoNotOptimize(visible_indices.data());
+		}
+		state.counters["visible"] = (Float64)visible_indices.size();
+		state.SetItemsProcessed(state.iterations() * BOX_COUNT);
+	}
+	BENCHMARK(BM_CullScalarPlanes)->Unit(benchmark::kMicrosecond);
+
+	static void BM_CullAABBStreams(benchmark::State& state)
+	{
+		CullingScene const& scene = GetCullingScene();
+		std::vector<Uint32> visible_indices;
+		visible_indices.reserve(BOX_COUNT);
+		std::vector<Uint64> visibility((BOX_COUNT + 63) / 64);
+		for (auto _ : state)
+		{
+			visible_indices.clear();
+			CullAABBs(scene.planes, scene.streams, 0, BOX_COUNT, visible_indices, visibility.data());
+			benchmark::DoNotOptimize(visible_indices.data());
+		}
+		CheckAgainstReference(state, visible_indices);
+	}
+	BENCHMARK(BM_CullAABBStreams)->Unit(benchmark::kMicrosecond);
+
+	//same chunking as Renderer::CameraFrustumCulling, the argument is the number of background threads, which the pool clamps to the core count
+	static void BM_CullAABBStreamsParallel(benchmark::State& state)
+	{
+		CullingScene const& scene = GetCullingScene();
+		g_ThreadPool.Initialize((Uint)state.range(0));
+		Uint64 const chunk_count = (BOX_COUNT + CHUNK_SIZE - 1) / CHUNK_SIZE;
+		std::vector<std::vector<Uint32>> chunk_visible_indices(chunk_count);
+		std::vector<Uint32> visible_indices;
+		visible_indices.reserve(BOX_COUNT);
+		std::vector<Uint64> visibility((BOX_COUNT + 63) / 64);
+		for (auto _ : state)
+		{
+			g_ThreadPool.ParallelFor(0, chunk_count, 1, [&](Uint64 chunk)
+				{
+					chunk_visible_indices[chunk].clear();
+					Uint64 const begin = chunk * CHUNK_SIZE;
+					CullAABBs(scene.planes, scene.streams, begin, std::min(begin + CHUNK_SIZE, BOX_COUNT), chunk_visible_indices[chunk], visibility.data());
+				});
+			visible_indices.clear();
+			for (std::vector<Uint32> const& indices : chunk_visible_indices)
+			{
+				visible_indices.insert(visible_indices.end(), indices.begin(), indices.end());
+			}
+			benchmark::DoNotOptimize(visible_indices.data());
+		}
+		state.counters["workers"] = (Float64)g_ThreadPool.GetWorkerCount();
+		g_ThreadPool.Shutdown();
+		CheckAgainstReference(state, visible_indices);
+	}
+	BENCHMARK(BM_CullAABBStreamsParallel)->Arg(1)->Arg(2)->Arg(4)->Arg(8)->Unit(benchmark::kMicrosecond)->UseRealTime();
+}
@@ -0,0 +1,83 @@
+#include <benchmark/benchmark.h>
+#include <chrono>
+#include "Logging/Log.h"
+
+namespace adria
+{
+	namespace
+	{
+		//only the consumer thread calls into sinks, so a plain counter is enough
+		class CountingLogSink : public ILogSink
+		{
+		public:
+			virtual void Log(LogLevel, LogChannel, Char const* entry, Char const*, Uint32) override
+			{
+				bytes += strlen(entry);
+				++count;
+			}
+
+			Uint64 count = 0;
+			Uint64 bytes = 0;
+		};
+
+		std::unique_ptr<LogManager> bench_log_manager;
+
+		//every 16th call is timed so the clock reads do not dominate the cost being measured
+		constexpr Uint64 LATENCY_SAMPLE_INTERVAL = 16;
+	}
+
+	//producers share one log manager, the ring holds 4096 records so once it is full the producer rate settles at what the consumer drains,
+	//latency is the producer side cost of a LogFormat call including any wait for a free slot
+	static void BM_LogProducers(benchmark::State& state)
+	{
+		Bool const long_message = state.range(0) != 0;
+		if (state.thread_index() == 0)
+		{
+			bench_log_manager = std::make_unique<LogManager>();
+			bench_log_manager->Register<CountingLogSink>();
+		}
+
+		//longer than the inline record storage, so every message takes the heap path
+		std::string const padding(long_message ? 300 : 0, 'x');
+		Uint32 const producer = (Uint32)state.thread_index();
+		std::vector<Float64> latencies;
+		latencies.reserve(1 << 16);
+		Uint64 message = 0;
+		for (auto _ : state)
+		{
+			if (message % LATENCY_SAMPLE_INTERVAL == 0)
+			{
+				auto start = std::chrono::steady_clock::now();
+				bench_log_manager->LogFormat(LogLevel::LOG_INFO, LogChannel::Renderer, __FILE__, __LINE__, "producer %u message %llu %s", producer, (unsigned long long)message, padding.c_str());
+				auto end = std::chrono::steady_clock::now();
+				latencies.push_back(std::chrono::duration<Float64, std::nano>(end - start).count());
+			}
+			else
+			{
+				bench_log_manager->LogFormat(LogLevel::LOG_INFO, LogChannel::Renderer, __FILE__, __LINE__, "producer %u message %llu %s", producer, (unsigned long long)message, padding.c_str());
+			}
+			++message;
+		}
+
+		Float64 average_latency = 0.0, p99_latency = 0.0;
+		if (!latencies.empty())
+		{
+			for (Float64 latency : latencies) average_latency += latency;
+			average_latency /= latencies.size();
+			Uint64 const p99_index = latencies.size() * 99 / 100;
+			std::nth_element(latencies.begin(), latencies.begin() + p99_index, latencies.end());
+			p99_latency = latencies[p99_index];
+		}
+		state.SetItemsProcessed(state.iterations());
+		state.counters["latency_ns"] = benchmark::Counter(average_latency, benchmark::Counter::kAvgThreads);
+		state.counters["p99_latency_ns"] = benchmark::Counter(p99_latency, benchmark::Counter::kAvgThreads);
+		state.counters["producers"] = benchmark::Counter(1.0);
+
+		if (state.thread_index() == 0)
+		{
+			bench_log_manager->Flush();
+			bench_log_manager.reset();
+		}
+	}
+	BENCHMARK(BM_LogProducers)->ArgName("long")->Arg(0)->Arg(1)->Threads(1)->Threads(8)->UseRealTime();
+}
@@ -0,0 +1,78 @@
+#include <benchmark/benchmark.h>
+#include "Utilities/MipGenerator.h"
+#include "Utilities/Random.h"
+
+namespace adria
+{
+	namespace
+	{
+		constexpr Uint32 TEXTURE_SIZE = 2048;
+
+		enum MipBenchmarkMode : Int64
+		{
+			MipBenchmarkMode_Linear,
+			MipBenchmarkMode_SRGB,
+			MipBenchmarkMode_SRGBCoverage,
+			MipBenchmarkMode_Float
+		};
+		Char const* const MipBenchmarkModeNames[] = { "rgba8 linear", "rgba8 srgb", "rgba8 srgb coverage", "rgba32f" };
+
+		Uint64 GetMipChainSize(Uint32 size)
+		{
+			Uint64 texel_count = 0;
+			for (Uint32 mip = 0; mip < GetMipLevelCount(size, size); ++mip)
+			{
+				texel_count += (Uint64)std::max(size >> mip, 1u) * std::max(size >> mip, 1u);
+			}
+			return texel_count * 4;
+		}
+	}
+
+	//full chain of a 2048x2048 noise texture, only mip 0 is read so every iteration rebuilds the same chain.
+	//Megapixels are counted on mip 0
+	static void BM_GenerateMipChain(benchmark::State& state)
+	{
+		MipBenchmarkMode const mode = (MipBenchmarkMode)state.range(0);
+		Uint32 const mip_levels = GetMipLevelCount(TEXTURE_SIZE, TEXTURE_SIZE);
+		Uint64 const mip0_size = (Uint64)TEXTURE_SIZE * TEXTURE_SIZE * 4;
+		IntRandomGenerator<Uint32> random_byte(0, 255, std::mt19937{ 42 });
+		RealRandomGenerator<Float> random_float(0.0f, 4.0f, std::mt19937{ 42 });
+
+		std::vector<Uint8> data;
+		std::vector<Float> float_data;
+		if (mode == MipBenchmarkMode_Float)
+		{
+			float_data.resize(GetMipChainSize(TEXTURE_SIZE));
+			for (Uint64 i = 0; i < mip0_size; ++i) float_data[i] = random_float();
+		}
+		else
+		{
+			data.resize(GetMipChainSize(TEXTURE_SIZE));
+			for (Uint64 i = 0; i < mip0_size; ++i) data[i] = (Uint8)random_byte();
+		}
+
+		for (auto _ : state)
+		{
+			switch (mode)
+			{
+			case MipBenchmarkMode_Linear:
+				GenerateMipChainRGBA8(data.data(), TEXTURE_SIZE, TEXTURE_SIZE, mip_levels, false);
+				break;
+			case MipBenchmarkMode_SRGB:
+				GenerateMipChainRGBA8(data.data(), TEXTURE_SIZE, TEXTURE_SIZE, mip_levels, true);
+				break;
+			case MipBenchmarkMode_SRGBCoverage:
+				GenerateMipChainRGBA8(data.data(), TEXTURE_SIZE, TEXTURE_SIZE, mip_levels, true, 0.5f);
+				break;
+			case MipBenchmarkMode_Float:
+				GenerateMipChainRGBA32F(float_data.data(), TEXTURE_SIZE, TEXTURE_SIZE, mip_levels);
+				break;
+			}
+			benchmark::ClobberMemory();
+		}
+		Float64 const megapixels = TEXTURE_SIZE * TEXTURE_SIZE / 1e6;
+		state.SetLabel(MipBenchmarkModeNames[mode]);
+		state.counters["megapixels"] = benchmark::Counter(state.iterations() * megapixels, benchmark::Counter::kIsRate);
+	}
+	BENCHMARK(BM_GenerateMipChain)->DenseRange(MipBenchmarkMode_Linear, MipBenchmarkMode_Float)->Unit(benchmark::kMillisecond);
+}
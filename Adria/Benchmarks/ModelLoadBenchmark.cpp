@@ -0,0 +1,105 @@
+#include <benchmark/benchmark.h>
+#include "Rendering/SceneLoader.h"
+#include "Rendering/ModelCache.h"
+#include "Core/Paths.h"
+#include "Utilities/ThreadPool.h"
+
+namespace adria
+{
+	namespace
+	{
+		struct BenchmarkModel
+		{
+			Char const* dir;
+			Char const* file;
+		};
+		//models whose buffers are part of the repository
+		BenchmarkModel const BenchmarkModels[] = { { "ToyCar", "ToyCar.gltf" }, { "pica_pica", "scene.gltf" } };
+
+		//the second argument selects the compact vertex layout
+		ModelParameters GetBenchmarkModel(benchmark::State const& state)
+		{
+			BenchmarkModel const& model = BenchmarkModels[state.range(0)];
+			std::string const model_dir = paths::ModelsDir + model.dir + "/";
+			ModelParameters params{};
+			params.model_path = model_dir + model.file;
+			params.textures_path = model_dir;
+			params.compact_geometry = state.range(1) != 0;
+			return params;
+		}
+
+		//geometry per vertex includes the indices, so the two layouts can be compared directly
+		void SetModelLabel(benchmark::State& state, CookedModel const& cooked_model)
+		{
+			Uint64 vertex_count = 0;
+			for (SubMeshGPU const& submesh : cooked_model.GetSubMeshes())
+			{
+				vertex_count += submesh.vertices_count;
+			}
+			state.SetLabel(std::string(BenchmarkModels[state.range(0)].dir) + (state.range(1) ? " compact" : ""));
+			state.counters["geometry_mb"] = cooked_model.GetGeometry().size() / (1024.0 * 1024.0);
+			state.counters["bytes_per_vertex"] = vertex_count ? (Float64)cooked_model.GetGeometry().size() / vertex_count : 0.0;
+			state.counters["submeshes"] = (Float64)cooked_model.GetSubMeshes().size();
+		}
+	}
+
+	//full import of the source model: parsing, mesh processing and writing the cache file, what a load costs without a valid cache
+	static void BM_ModelImport(benchmark::State& state)
+	{
+		g_ThreadPool.Initialize();
+		ModelParameters const params = GetBenchmarkModel(state);
+		CookedModel cooked_model;
+		for (auto _ : state)
+		{
+			if (!SceneLoader::CookModel(params, false, &cooked_model))
+			{
+				state.SkipWithError("Model import failed");
+				break;
+			}
+		}
+		if (!state.error_occurred())
+		{
+			SetModelLabel(state, cooked_model);
+		}
+		g_ThreadPool.Shutdown();
+	}
+	BENCHMARK(BM_ModelImport)->ArgsProduct({ { 0, 1 }, { 0, 1 } })->Unit(benchmark::kMillisecond);
+
+	//opening the cooked model validates the dependency stamps and maps the file, the geometry is then copied once like the upload would
+	static void BM_ModelCacheLoad(benchmark::State& state)
+	{
+		g_ThreadPool.Initialize();
+		ModelParameters const params = GetBenchmarkModel(state);
+		Uint64 const options_hash = GetModelCookOptionsHash(params, false);
+		std::string const cache_path = GetModelCachePath(params, options_hash);
+		if (!SceneLoader::CookModel(params, false))
+		{
+			state.SkipWithError("Model import failed");
+			g_ThreadPool.Shutdown();
+			return;
+		}
+		g_ThreadPool.Shutdown();
+
+		std::vector<Uint8> upload;
+		CookedModel cooked_model;
+		for (auto _ : state)
+		{
+			if (!cooked_model.Open(cache_path, options_hash))
+			{
+				state.SkipWithError("Model cache miss");
+				break;
+			}
+			std::span<Uint8 const> geometry = cooked_model.GetGeometry();
+			upload.resize(geometry.size());
+			memcpy(upload.data(), geometry.data(), geometry.size());
+			benchmark::DoNotOptimize(upload.data());
+			cooked_model.Close();
+		}
+		if (!state.error_occurred() && cooked_model.Open(cache_path, options_hash))
+		{
+			SetModelLabel(state, cooked_model);
+			state.SetBytesProcessed(state.iterations() * cooked_model.GetGeometry().size());
+		}
+	}
+	BENCHMARK(BM_ModelCacheLoad)->ArgsProduct({ { 0, 1 }, { 0, 1 } })->Unit(benchmark::kMillisecond);
+}
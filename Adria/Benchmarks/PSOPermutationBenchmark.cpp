@@ -0,0 +1,103 @@
+#include <benchmark/benchmark.h>
+#include "Rendering/GBufferPass.h"
+#include "Rendering/Components.h"
+#include "Graphics/Null/NullDevice.h"
+
+namespace adria
+{
+	struct GBufferPassTestAccess
+	{
+		static GfxGraphicsPipelineStatePermutations& GetPSOPermutations(GBufferPass& gbuffer_pass) { return *gbuffer_pass.gbuffer_psos; }
+		static void ProcessBatches(GBufferPass& gbuffer_pass, std::span<Batch const* const> draws, GfxCommandList* cmd_list) { gbuffer_pass.ProcessBatches(draws, cmd_list); }
+	};
+
+	namespace
+	{
+		constexpr Uint64 DRAW_COUNT = 20000;
+
+		//a sorted camera draw list, most draws opaque without extension and the rest spread over the other material permutations
+		class GBufferDrawScene
+		{
+		public:
+			GBufferDrawScene() : gfx(nullptr), gbuffer_pass(reg, &gfx, 64, 64)
+			{
+				submesh.indices_count = 3;
+				submesh.topology = GfxPrimitiveTopology::TriangleList;
+				batches.resize(DRAW_COUNT);
+				for (Uint64 i = 0; i < DRAW_COUNT; ++i)
+				{
+					Batch& batch = batches[i];
+					batch.instance_id = (Uint32)i;
+					batch.submesh = &submesh;
+					batch.alpha_mode = i % 5 == 0 ? MaterialAlphaMode::Mask : MaterialAlphaMode::Opaque;
+					batch.shading_extension = (ShadingExtension)(i % 11 < 8 ? 0 : i % 11 - 7);
+					batch.material_permutation = GetMaterialPermutation(batch.alpha_mode, batch.shading_extension);
+				}
+				std::sort(batches.begin(), batches.end(), [](Batch const& lhs, Batch const& rhs) { return lhs.material_permutation < rhs.material_permutation; });
+				for (Batch const& batch : batches)
+				{
+					draws.push_back(&batch);
+				}
+				gfx.BeginFrame();
+			}
+			~GBufferDrawScene()
+			{
+				gfx.EndFrame();
+			}
+
+			GBufferPass& GetGBufferPass() { return gbuffer_pass; }
+			GfxCommandList* GetCommandList() const { return gfx.GetCommandList(GfxCommandListType::Graphics); }
+			std::span<Batch const* const> GetDraws() const { return draws; }
+
+		private:
+			NullDevice gfx;
+			entt::registry reg;
+			GBufferPass gbuffer_pass;
+			SubMeshGPU submesh{};
+			std::vector<Batch> batches;
+			std::vector<Batch const*> draws;
+		};
+	}
+
+	//what every gbuffer draw paid before the pso cache, adding its defines to the permutations and looking the pso up by the hash of the whole description
+	static void BM_PSOPermutationsGet(benchmark::State& state)
+	{
+		GBufferDrawScene scene;
+		GfxGraphicsPipelineStatePermutations& gbuffer_psos = GBufferPassTestAccess::GetPSOPermutations(scene.GetGBufferPass());
+		GfxCommandList* cmd_list = scene.GetCommandList();
+		for (auto _ : state)
+		{
+			for (Batch const* batch : scene.GetDraws())
+			{
+				using enum GfxShaderStage;
+				switch (batch->shading_extension)
+				{
+				case ShadingExtension::Anisotropy:	gbuffer_psos.AddDefine<PS>("SHADING_EXTENSION_ANISOTROPY", "1"); break;
+				case ShadingExtension::ClearCoat:	gbuffer_psos.AddDefine<PS>("SHADING_EXTENSION_CLEARCOAT", "1"); break;
+				case ShadingExtension::Sheen:		gbuffer_psos.AddDefine<PS>("SHADING_EXTENSION_SHEEN", "1"); break;
+				}
+				if (batch->alpha_mode == MaterialAlphaMode::Mask)
+				{
+					gbuffer_psos.AddDefine<PS>("MASK", "1");
+				}
+				cmd_list->SetPipelineState(gbuffer_psos.Get());
+			}
+		}
+		state.SetItemsProcessed(state.iterations() * DRAW_COUNT);
+	}
+	BENCHMARK(BM_PSOPermutationsGet)->Unit(benchmark::kMicrosecond);
+
+	//GBufferPass::ProcessBatches, the pso is an array load by material permutation and only set when it changes, this includes recording the draws
+	static void BM_GBufferProcessBatches(benchmark::State& state)
+	{
+		GBufferDrawScene scene;
+		GBufferPass& gbuffer_pass = scene.GetGBufferPass();
+		GfxCommandList* cmd_list = scene.GetCommandList();
+		for (auto _ : state)
+		{
+			GBufferPassTestAccess::ProcessBatches(gbuffer_pass, scene.GetDraws(), cmd_list);
+		}
+		state.SetItemsProcessed(state.iterations() * DRAW_COUNT);
+	}
+	BENCHMARK(BM_GBufferProcessBatches)->Unit(benchmark::kMicrosecond);
+}
@@ -0,0 +1,124 @@
+#include <benchmark/benchmark.h>
+#include "Rendering/Components.h"
+#include "Utilities/RadixSort.h"
+#include "Utilities/Random.h"
+
+namespace adria
+{
+	namespace
+	{
+		std::vector<RadixSortItem> MakeRandomItems(Uint64 count)
+		{
+			IntRandomGenerator<Uint64, std::mt19937_64> random_key(0, std::numeric_limits<Uint64>::max(), std::mt19937_64{ 9 });
+			std::vector<RadixSortItem> items(count);
+			for (Uint64 i = 0; i < count; ++i)
+			{
+				items[i] = RadixSortItem{ .key = random_key(), .value = (Uint32)i };
+			}
+			return items;
+		}
+
+		//batches spread over a few hundred meters with the alpha modes and shading extensions of a typical scene
+		void CreateBatches(entt::registry& reg, Uint64 count)
+		{
+			RealRandomGenerator<Float> random_position(-300.0f, 300.0f, std::mt19937{ 10 });
+			for (Uint64 i = 0; i < count; ++i)
+			{
+				Batch& batch = reg.emplace<Batch>(reg.create());
+				batch.instance_id = (Uint32)i;
+				batch.alpha_mode = i % 10 == 0 ? MaterialAlphaMode::Mask : MaterialAlphaMode::Opaque;
+				batch.shading_extension = i % 7 == 0 ? ShadingExtension::ClearCoat : ShadingExtension::None;
+				batch.bounding_box = BoundingBox(Vector3(random_position(), random_position() * 0.1f, random_position()), Vector3(1.0f, 1.0f, 1.0f));
+			}
+		}
+
+		//the camera circles the scene so the draw order changes every iteration, like it does between frames
+		Vector3 GetCameraPosition(Uint64 iteration)
+		{
+			Float const angle = (Float)iteration * 0.05f;
+			return Vector3(100.0f * std::cos(angle), 20.0f, 100.0f * std::sin(angle));
+		}
+	}
+
+	//both raw sorts copy the unsorted input back every iteration, the copy is part of the measured time
+	static void BM_RadixSort(benchmark::State& state)
+	{
+		std::vector<RadixSortItem> const input = MakeRandomItems((Uint64)state.range(0));
+		std::vector<RadixSortItem> items(input.size()), scratch(input.size());
+		for (auto _ : state)
+		{
+			std::copy(input.begin(), input.end(), items.begin());
+			RadixSort(items, scratch);
+			benchmark::DoNotOptimize(items.data());
+		}
+		state.SetItemsProcessed(state.iterations() * state.range(0));
+	}
+	BENCHMARK(BM_RadixSort)->RangeMultiplier(10)->Range(1000, 100000)->Unit(benchmark::kMicrosecond);
+
+	static void BM_StdSort(benchmark::State& state)
+	{
+		std::vector<RadixSortItem> const input = MakeRandomItems((Uint64)state.range(0));
+		std::vector<RadixSortItem> items(input.size());
+		for (auto _ : state)
+		{
+			std::copy(input.begin(), input.end(), items.begin());
+			std::sort(items.begin(), items.end(), [](RadixSortItem const& lhs, RadixSortItem const& rhs) { return lhs.key < rhs.key; });
+			benchmark::DoNotOptimize(items.data());
+		}
+		state.SetItemsProcessed(state.iterations() * state.range(0));
+	}
+	BENCHMARK(BM_StdSort)->RangeMultiplier(10)->Range(1000, 100000)->Unit(benchmark::kMicrosecond);
+
+	//what GBufferPass did before the draw keys, sorting the Batch pool with a comparator that measures both distances on every comparison
+	static void BM_EnttSortBatches(benchmark::State& state)
+	{
+		entt::registry reg;
+		CreateBatches(reg, (Uint64)state.range(0));
+		Uint64 iteration = 0;
+		for (auto _ : state)
+		{
+			Vector3 const camera_position = GetCameraPosition(iteration++);
+			reg.sort<Batch>([&camera_position](Batch const& lhs, Batch const& rhs)
+				{
+					if (lhs.alpha_mode != rhs.alpha_mode)
+					{
+						return lhs.alpha_mode < rhs.alpha_mode;
+					}
+					if (lhs.shading_extension != rhs.shading_extension)
+					{
+						return lhs.shading_extension < rhs.shading_extension;
+					}
+					return Vector3::DistanceSquared(camera_position, lhs.bounding_box.Center) < Vector3::DistanceSquared(camera_position, rhs.bounding_box.Center);
+				});
+		}
+		state.SetItemsProcessed(state.iterations() * state.range(0));
+	}
+	BENCHMARK(BM_EnttSortBatches)->RangeMultiplier(10)->Range(1000, 100000)->Unit(benchmark::kMicrosecond);
+
+	//key building as in Renderer::SortCameraDraws followed by the radix sort, the counterpart of the entt sort above
+	static void BM_DrawKeyRadixSort(benchmark::State& state)
+	{
+		entt::registry reg;
+		CreateBatches(reg, (Uint64)state.range(0));
+		auto batch_view = reg.view<Batch>();
+		std::vector<RadixSortItem> items, scratch;
+		Uint64 iteration = 0;
+		for (auto _ : state)
+		{
+			Vector3 const camera_position = GetCameraPosition(iteration++);
+			items.clear();
+			for (entt::entity batch_entity : batch_view)
+			{
+				Batch const& batch = batch_view.get<Batch>(batch_entity);
+				Uint64 const depth = std::bit_cast<Uint32>(Vector3::DistanceSquared(camera_position, batch.bounding_box.Center)) >> 7;
+				Uint64 const key = ((Uint64)batch.alpha_mode << 62) | ((Uint64)batch.shading_extension << 59) | (depth << 35);
+				items.push_back(RadixSortItem{ .key = key, .value = batch.instance_id });
+			}
+			scratch.resize(items.size());
+			RadixSort(items, scratch);
+			benchmark::DoNotOptimize(items.data());
+		}
+		state.SetItemsProcessed(state.iterations() * state.range(0));
+	}
+	BENCHMARK(BM_DrawKeyRadixSort)->RangeMultiplier(10)->Range(1000, 100000)->Unit(benchmark::kMicrosecond);
+}
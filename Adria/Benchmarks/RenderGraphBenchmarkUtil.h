@@ -0,0 +1,38 @@
+#pragma once
+#include <benchmark/benchmark.h>
+#include "RenderGraph/RenderGraph.h"
+#include "Graphics/Null/NullDevice.h"
+
+namespace adria
+{
+	//times only RenderGraph::Compile, building and executing the graph run with the timer paused
+	template<typename BuildFunc>
+	void BenchmarkRenderGraphCompile(benchmark::State& state, BuildFunc&& build, Bool use_cache)
+	{
+		NullDevice gfx(nullptr);
+		RGResourcePool pool(&gfx);
+		RGCompileCache cache;
+		RGAllocator allocator(RenderGraph::DefaultAllocatorSize);
+		for (auto _ : state)
+		{
+			state.PauseTiming();
+			gfx.BeginFrame();
+			{
+				RenderGraph rg(pool, &cache, &allocator);
+				build(rg);
+				if (!use_cache)
+				{
+					cache.Invalidate();
+				}
+				state.ResumeTiming();
+				rg.Compile();
+				state.PauseTiming();
+				rg.Execute();
+			}
+			gfx.EndFrame();
+			state.ResumeTiming();
+		}
+		state.counters["hits"] = (Float64)cache.GetHitCount();
+		state.counters["misses"] = (Float64)cache.GetMissCount();
+	}
+}
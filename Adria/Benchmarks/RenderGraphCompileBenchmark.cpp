@@ -0,0 +1,106 @@
+#include "RenderGraphBenchmarkUtil.h"
+
+namespace adria
+{
+	namespace
+	{
+		//chain of compute passes, each one creates a texture, reads the previous one and every 8th pass also reads one far back,
+		//so compilation sees long lifetimes, aliasing candidates and a non trivial dependency graph
+		void BuildChainGraph(RenderGraph& rg, Uint32 pass_count)
+		{
+			for (Uint32 i = 0; i < pass_count; ++i)
+			{
+				rg.AddPass<void>("Chain Pass",
+					[=](RenderGraphBuilder& builder)
+					{
+						RGTextureDesc desc{};
+						desc.width = 64;
+						desc.height = 64;
+						desc.format = GfxFormat::R16G16B16A16_FLOAT;
+						builder.DeclareTexture(RG_NAME_IDX(ChainTexture, i), desc);
+						std::ignore = builder.WriteTexture(RG_NAME_IDX(ChainTexture, i));
+						if (i > 0)
+						{
+							std::ignore = builder.ReadTexture(RG_NAME_IDX(ChainTexture, i - 1));
+						}
+						if (i >= 8 && i % 8 == 0)
+						{
+							std::ignore = builder.ReadTexture(RG_NAME_IDX(ChainTexture, i - 8));
+						}
+					},
+					[=](RenderGraphContext&) {}, RGPassType::Compute, i + 1 == pass_count ? RGPassFlags::ForceNoCull : RGPassFlags::None);
+			}
+		}
+	}
+
+	static void BM_RenderGraphCompileCold(benchmark::State& state)
+	{
+		Uint32 const pass_count = (Uint32)state.range(0);
+		BenchmarkRenderGraphCompile(state, [=](RenderGraph& rg) { BuildChainGraph(rg, pass_count); }, false);
+	}
+	BENCHMARK(BM_RenderGraphCompileCold)->Arg(100)->Arg(500)->Unit(benchmark::kMicrosecond);
+
+	//the first iteration misses, every later one reuses the cached compilation
+	static void BM_RenderGraphCompileWarm(benchmark::State& state)
+	{
+		Uint32 const pass_count = (Uint32)state.range(0);
+		BenchmarkRenderGraphCompile(state, [=](RenderGraph& rg) { BuildChainGraph(rg, pass_count); }, true);
+	}
+	BENCHMARK(BM_RenderGraphCompileWarm)->Arg(100)->Arg(500)->Unit(benchmark::kMicrosecond);
+
+	//cold and warm compilations of the same graph timed back to back, the reported time is the warm one. A hit only combines
+	//the hashes accumulated during setup and replays the cached result, so it has to stay well under the cost of compiling
+	static void BM_RenderGraphCompileCacheSpeedup(benchmark::State& state)
+	{
+		constexpr Float64 MaxWarmColdRatio = 0.4;
+		Uint32 const pass_count = (Uint32)state.range(0);
+
+		NullDevice gfx(nullptr);
+		RGResourcePool pool(&gfx);
+		RGCompileCache cold_cache, warm_cache;
+		RGAllocator allocator(RenderGraph::DefaultAllocatorSize);
+		auto TimeCompile = [&](RGCompileCache& cache)
+			{
+				gfx.BeginFrame();
+				Float64 compile_time = 0.0;
+				{
+					RenderGraph rg(pool, &cache, &allocator);
+					BuildChainGraph(rg, pass_count);
+					auto const start = std::chrono::high_resolution_clock::now();
+					rg.Compile();
+					compile_time = std::chrono::duration<Float64>(std::chrono::high_resolution_clock::now() - start).count();
+					rg.Execute();
+				}
+				gfx.EndFrame();
+				return compile_time;
+			};
+
+		//medians, a single preempted iteration would otherwise decide the ratio
+		std::vector<Float64> cold_times, warm_times;
+		TimeCompile(warm_cache);
+		for (auto _ : state)
+		{
+			cold_cache.Invalidate();
+			cold_times.push_back(TimeCompile(cold_cache));
+			warm_times.push_back(TimeCompile(warm_cache));
+			state.SetIterationTime(warm_times.back());
+		}
+		auto Median = [](std::vector<Float64>& times)
+			{
+				std::nth_element(times.begin(), times.begin() + times.size() / 2, times.end());
+				return times[times.size() / 2];
+			};
+
+		Float64 const warm_cold_ratio = Median(warm_times) / Median(cold_times);
+		state.counters["warm_cold_ratio"] = warm_cold_ratio;
+		if (warm_cache.GetMissCount() != 1)
+		{
+			state.SkipWithError("Warm compilation missed the cache");
+		}
+		else if (warm_cold_ratio > MaxWarmColdRatio)
+		{
+			state.SkipWithError("Cached compilation is not fast enough compared to a full compilation");
+		}
+	}
+	BENCHMARK(BM_RenderGraphCompileCacheSpeedup)->Arg(100)->Arg(500)->UseManualTime()->Unit(benchmark::kMicrosecond);
+}
@@ -0,0 +1,42 @@
+#include "RenderGraphBenchmarkUtil.h"
+
+namespace adria
+{
+	namespace
+	{
+		//every pass writes its own buffer and reads three of the sixteen written before it,
+		//so each pass has a constant number of accesses and edge construction should scale linearly
+		void BuildFanInGraph(RenderGraph& rg, Uint32 pass_count)
+		{
+			for (Uint32 i = 0; i < pass_count; ++i)
+			{
+				rg.AddPass<void>("Fan In Pass",
+					[=](RenderGraphBuilder& builder)
+					{
+						RGBufferDesc desc{};
+						desc.size = 256;
+						desc.stride = 4;
+						desc.misc_flags = GfxBufferMiscFlag::BufferStructured;
+						builder.DeclareBuffer(RG_NAME_IDX(FanInBuffer, i), desc);
+						std::ignore = builder.WriteBuffer(RG_NAME_IDX(FanInBuffer, i));
+						for (Uint32 k : { 1u, 5u, 16u })
+						{
+							if (i >= k)
+							{
+								std::ignore = builder.ReadBuffer(RG_NAME_IDX(FanInBuffer, i - k));
+							}
+						}
+					},
+					[=](RenderGraphContext&) {}, RGPassType::Compute, RGPassFlags::ForceNoCull);
+			}
+		}
+	}
+
+	static void BM_RenderGraphDependencies(benchmark::State& state)
+	{
+		Uint32 const pass_count = (Uint32)state.range(0);
+		BenchmarkRenderGraphCompile(state, [=](RenderGraph& rg) { BuildFanInGraph(rg, pass_count); }, false);
+		state.SetComplexityN(pass_count);
+	}
+	BENCHMARK(BM_RenderGraphDependencies)->Arg(100)->Arg(1000)->Arg(10000)->Unit(benchmark::kMicrosecond)->Complexity(benchmark::oN);
+}
@@ -0,0 +1,142 @@
+#include <benchmark/benchmark.h>
+#include "Rendering/Renderer.h"
+#include "Rendering/Camera.h"
+#include "Rendering/Components.h"
+#include "Rendering/GeometryBufferCache.h"
+#include "Rendering/TextureManager.h"
+#include "Graphics/Null/NullDevice.h"
+
+namespace adria
+{
+	struct RendererTestAccess
+	{
+		static void UpdateSceneBuffers(Renderer& renderer) { renderer.UpdateSceneBuffers(); }
+		static void ForceSceneBuffersRebuild(Renderer& renderer) { renderer.scene_buffers_rebuild = true; }
+		static Uint64 GetSceneBuffersUploadSize(Renderer const& renderer) { return renderer.scene_buffers_upload_size; }
+	};
+
+	namespace
+	{
+		//null device renderer over a scene of mesh_count meshes with instances_per_mesh instances each, the null buffers stand in for the gpu scene buffers
+		class SceneBufferBenchmarkScene
+		{
+		public:
+			SceneBufferBenchmarkScene(Uint32 mesh_count, Uint32 instances_per_mesh) : gfx(nullptr)
+			{
+				g_TextureManager.Initialize(&gfx);
+				g_GeometryBufferCache.Initialize(&gfx);
+				renderer = std::make_unique<Renderer>(reg, &gfx, 64, 64);
+
+				std::vector<Uint8> geometry(4096);
+				ArcGeometryBufferHandle geometry_buffer_handle = g_GeometryBufferCache.CreateAndInitializeGeometryBuffer(geometry);
+				g_GeometryBufferCache.OnSceneInitialized();
+				for (Uint32 i = 0; i < mesh_count; ++i)
+				{
+					entt::entity mesh_entity = reg.create();
+					Mesh& mesh = reg.emplace<Mesh>(mesh_entity);
+					mesh.geometry_buffer_handle = geometry_buffer_handle;
+					mesh.materials.emplace_back();
+					SubMeshGPU& submesh = mesh.submeshes.emplace_back();
+					submesh.material_index = 0;
+					submesh.bounding_box = BoundingBox(Vector3(0.0f, 0.0f, 0.0f), Vector3(1.0f, 1.0f, 1.0f));
+					for (Uint32 j = 0; j < instances_per_mesh; ++j)
+					{
+						SubMeshInstance& instance = mesh.instances.emplace_back();
+						instance.parent = mesh_entity;
+						instance.submesh_index = 0;
+						instance.world_transform = Matrix::CreateTranslation((Float)i, 0.0f, (Float)j);
+					}
+					mesh_entities.push_back(mesh_entity);
+				}
+
+				camera = Camera(CameraParameters{ .near_plane = 0.1f, .far_plane = 1000.0f, .fov = 1.0f, .position = Vector3(0.0f, 0.0f, -10.0f), .look_at = Vector3(0.0f, 0.0f, 0.0f) });
+				renderer->NewFrame(&camera);
+				RendererTestAccess::UpdateSceneBuffers(*renderer);
+			}
+			~SceneBufferBenchmarkScene()
+			{
+				renderer.reset();
+				g_GeometryBufferCache.Shutdown();
+				g_TextureManager.Shutdown();
+			}
+
+			//moves the instances of count meshes, starting at first and wrapping around, and marks those meshes dirty
+			void MoveMeshes(Uint32 first, Uint32 count)
+			{
+				for (Uint32 i = 0; i < count; ++i)
+				{
+					Mesh& mesh = reg.get<Mesh>(mesh_entities[(first + i) % mesh_entities.size()]);
+					for (SubMeshInstance& instance : mesh.instances)
+					{
+						instance.world_transform *= Matrix::CreateTranslation(0.0f, 0.01f, 0.0f);
+					}
+					mesh.dirty = true;
+				}
+			}
+
+			Renderer& GetRenderer() { return *renderer; }
+
+		private:
+			NullDevice gfx;
+			entt::registry reg;
+			std::unique_ptr<Renderer> renderer;
+			Camera camera;
+			std::vector<entt::entity> mesh_entities;
+		};
+
+		constexpr Uint32 MESH_COUNT = 500;
+		constexpr Uint32 INSTANCES_PER_MESH = 100;
+
+		void ReportUploadSize(benchmark::State& state, Uint64 upload_size)
+		{
+			state.counters["bytes_per_frame"] = benchmark::Counter((Float64)upload_size, benchmark::Counter::kAvgIterations);
+		}
+	}
+
+	//50k instances and nothing changes, a frame should neither write slots nor upload anything
+	static void BM_SceneBuffersStatic(benchmark::State& state)
+	{
+		SceneBufferBenchmarkScene scene(MESH_COUNT, INSTANCES_PER_MESH);
+		Uint64 upload_size = 0;
+		for (auto _ : state)
+		{
+			RendererTestAccess::UpdateSceneBuffers(scene.GetRenderer());
+			upload_size += RendererTestAccess::GetSceneBuffersUploadSize(scene.GetRenderer());
+		}
+		ReportUploadSize(state, upload_size);
+	}
+	BENCHMARK(BM_SceneBuffersStatic)->Unit(benchmark::kMicrosecond);
+
+	//the given number of meshes move every frame, only their slots are rewritten and uploaded
+	static void BM_SceneBuffersMovingMeshes(benchmark::State& state)
+	{
+		SceneBufferBenchmarkScene scene(MESH_COUNT, INSTANCES_PER_MESH);
+		Uint32 const moving_meshes = (Uint32)state.range(0);
+		Uint32 first = 0;
+		Uint64 upload_size = 0;
+		for (auto _ : state)
+		{
+			scene.MoveMeshes(first, moving_meshes);
+			first += moving_meshes;
+			RendererTestAccess::UpdateSceneBuffers(scene.GetRenderer());
+			upload_size += RendererTestAccess::GetSceneBuffersUploadSize(scene.GetRenderer());
+		}
+		ReportUploadSize(state, upload_size);
+	}
+	BENCHMARK(BM_SceneBuffersMovingMeshes)->Arg(1)->Arg(10)->Arg(MESH_COUNT)->Unit(benchmark::kMicrosecond);
+
+	//every frame reassigns all slots and recreates the batches, which is what the old per frame rebuild did
+	static void BM_SceneBuffersRebuild(benchmark::State& state)
+	{
+		SceneBufferBenchmarkScene scene(MESH_COUNT, INSTANCES_PER_MESH);
+		Uint64 upload_size = 0;
+		for (auto _ : state)
+		{
+			RendererTestAccess::ForceSceneBuffersRebuild(scene.GetRenderer());
+			RendererTestAccess::UpdateSceneBuffers(scene.GetRenderer());
+			upload_size += RendererTestAccess::GetSceneBuffersUploadSize(scene.GetRenderer());
+		}
+		ReportUploadSize(state, upload_size);
+	}
+	BENCHMARK(BM_SceneBuffersRebuild)->Unit(benchmark::kMicrosecond);
+}
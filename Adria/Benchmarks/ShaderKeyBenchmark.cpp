@@ -0,0 +1,172 @@
+#include <benchmark/benchmark.h>
+#include "Graphics/GfxShaderKey.h"
+#include "Graphics/GfxShader.h"
+#include "Rendering/ShaderManager.h"
+#include "Utilities/Hash.h"
+#include "Utilities/Random.h"
+
+namespace adria
+{
+	namespace
+	{
+		Char const* const DefineNames[] =
+		{
+			"MASK", "SHADING_EXTENSION_ANISOTROPY", "SHADING_EXTENSION_CLEARCOAT", "SHADING_EXTENSION_SHEEN", "RAIN", "TRIANGLE_OVERDRAW",
+			"DEBUG_VIEW", "VIEW_MIPMAPS", "SECOND_PHASE", "OCCLUSION_CULL", "CLUSTERED", "USE_TRANSPARENCY"
+		};
+
+		//the key before define interning, kept as the reference: the defines live in a heap allocated vector that every copy duplicates,
+		//and every hash and comparison concatenates them into a string and runs crc64 over it
+		class LegacyShaderKey
+		{
+			struct Impl
+			{
+				std::vector<GfxShaderDefine> defines;
+				ShaderID id = ShaderID_Invalid;
+			};
+
+		public:
+			LegacyShaderKey(ShaderID shader_id) : impl(std::make_unique<Impl>())
+			{
+				impl->id = shader_id;
+			}
+			LegacyShaderKey(LegacyShaderKey const& key) : impl(std::make_unique<Impl>(*key.impl)) {}
+
+			void AddDefine(Char const* name, Char const* value = "")
+			{
+				impl->defines.emplace_back(name, value);
+			}
+
+			Uint64 GetHash() const
+			{
+				std::string define_key;
+				for (GfxShaderDefine const& define : impl->defines)
+				{
+					define_key += define.name;
+					define_key += define.value;
+				}
+				define_key += std::to_string(impl->id);
+				return crc64(define_key.c_str(), define_key.size());
+			}
+
+			Bool operator==(LegacyShaderKey const& key) const
+			{
+				if (impl->id != key.impl->id) return false;
+				return GetHash() == key.GetHash();
+			}
+
+		private:
+			std::unique_ptr<Impl> impl;
+		};
+
+		struct LegacyShaderKeyHash
+		{
+			Uint64 operator()(LegacyShaderKey const& key) const
+			{
+				return key.GetHash();
+			}
+		};
+
+		//one permutation per bit pattern of the define list, the way pass permutations combine independent toggles
+		template<typename KeyT>
+		KeyT MakePermutationKey(ShaderID shader_id, Uint32 permutation)
+		{
+			KeyT key(shader_id);
+			for (Uint32 i = 0; i < std::size(DefineNames); ++i)
+			{
+				if (permutation & (1u << i))
+				{
+					key.AddDefine(DefineNames[i], "1");
+				}
+			}
+			return key;
+		}
+
+		template<typename KeyT>
+		std::vector<KeyT> MakePermutationKeys(Uint32 count)
+		{
+			std::vector<KeyT> keys;
+			keys.reserve(count);
+			for (Uint32 i = 0; i < count; ++i)
+			{
+				keys.push_back(MakePermutationKey<KeyT>(PS_GBuffer, i));
+			}
+			return keys;
+		}
+	}
+
+	//every benchmark runs on GfxShaderKey and on LegacyShaderKey, the ratio between the two is the gain of interning
+
+	//building a key with the given number of defines and copying it once, like a pso description does.
+	//For the interned key the strings are already in the table after the first iteration
+	template<typename KeyT, typename HashT>
+	static void BM_ShaderKeyBuild(benchmark::State& state)
+	{
+		Uint32 const define_count = (Uint32)state.range(0);
+		for (auto _ : state)
+		{
+			KeyT key(PS_GBuffer);
+			for (Uint32 i = 0; i < define_count; ++i)
+			{
+				key.AddDefine(DefineNames[i], "1");
+			}
+			KeyT key_copy(key);
+			benchmark::DoNotOptimize(key_copy);
+		}
+		state.SetItemsProcessed(state.iterations());
+	}
+	BENCHMARK_TEMPLATE(BM_ShaderKeyBuild, GfxShaderKey, GfxShaderKeyHash)->Arg(0)->Arg(1)->Arg(4)->Arg(8)->Arg(12);
+	BENCHMARK_TEMPLATE(BM_ShaderKeyBuild, LegacyShaderKey, LegacyShaderKeyHash)->Arg(0)->Arg(1)->Arg(4)->Arg(8)->Arg(12);
+
+	//the interned key accumulates its hash in AddDefine, so this only folds in the shader id
+	template<typename KeyT, typename HashT>
+	static void BM_ShaderKeyHash(benchmark::State& state)
+	{
+		std::vector<KeyT> const keys = MakePermutationKeys<KeyT>(1024);
+		for (auto _ : state)
+		{
+			for (KeyT const& key : keys)
+			{
+				benchmark::DoNotOptimize(HashT{}(key));
+			}
+		}
+		state.SetItemsProcessed(state.iterations() * keys.size());
+	}
+	BENCHMARK_TEMPLATE(BM_ShaderKeyHash, GfxShaderKey, GfxShaderKeyHash);
+	BENCHMARK_TEMPLATE(BM_ShaderKeyHash, LegacyShaderKey, LegacyShaderKeyHash);
+
+	//ShaderManager's shader map, every permutation is looked up once per iteration in random order
+	template<typename KeyT, typename HashT>
+	static void BM_ShaderKeyMapLookup(benchmark::State& state)
+	{
+		std::vector<KeyT> keys = MakePermutationKeys<KeyT>((Uint32)state.range(0));
+		std::unordered_map<KeyT, Uint32, HashT> shader_map;
+		for (Uint32 i = 0; i < keys.size(); ++i)
+		{
+			shader_map.emplace(keys[i], i);
+		}
+		std::vector<KeyT const*> lookup_order;
+		for (KeyT const& key : keys)
+		{
+			lookup_order.push_back(&key);
+		}
+		std::shuffle(lookup_order.begin(), lookup_order.end(), std::mt19937{ 42 });
+
+		Uint64 found = 0;
+		for (auto _ : state)
+		{
+			for (KeyT const* key : lookup_order)
+			{
+				found += shader_map.find(*key) != shader_map.end();
+			}
+		}
+		if (found != state.iterations() * keys.size())
+		{
+			state.SkipWithError("Shader key lookup missed");
+			return;
+		}
+		state.SetItemsProcessed(state.iterations() * keys.size());
+	}
+	BENCHMARK_TEMPLATE(BM_ShaderKeyMapLookup, GfxShaderKey, GfxShaderKeyHash)->Arg(16)->Arg(256)->Arg(4096);
+	BENCHMARK_TEMPLATE(BM_ShaderKeyMapLookup, LegacyShaderKey, LegacyShaderKeyHash)->Arg(16)->Arg(256)->Arg(4096);
+}
@@ -0,0 +1,140 @@
+#include <benchmark/benchmark.h>
+#include "Rendering/ShadowRenderer.h"
+#include "Rendering/Camera.h"
+#include "Rendering/Components.h"
+#include "Graphics/GfxTexture.h"
+#include "Graphics/Null/NullDevice.h"
+#include "Utilities/ThreadPool.h"
+#include "Utilities/Random.h"
+
+namespace adria
+{
+	struct ShadowRendererTestAccess
+	{
+		static std::vector<BoundingObject> const& GetBoundingObjects(ShadowRenderer const& shadow_renderer) { return shadow_renderer.bounding_objects; }
+		static Uint64 GetDrawCount(ShadowRenderer const& shadow_renderer)
+		{
+			Uint64 draw_count = 0;
+			for (auto const& draws : shadow_renderer.view_draws)
+			{
+				draw_count += draws.opaque_draws.size() + draws.masked_draws.size();
+			}
+			return draw_count;
+		}
+	};
+
+	namespace
+	{
+		constexpr Uint32 BATCH_COUNT = 20000;
+		constexpr Uint32 SUBMESH_COUNT = 64;
+
+		//one cascaded sun and two point lights make 4 + 2 * 6 shadow views over a scene of batches that share a few submeshes
+		class ShadowCullingScene
+		{
+		public:
+			ShadowCullingScene() : gfx(nullptr)
+			{
+				g_ThreadPool.Initialize();
+				shadow_renderer = std::make_unique<ShadowRenderer>(reg, &gfx, 64, 64);
+
+				RealRandomGenerator<Float> random_position(-200.0f, 200.0f, std::mt19937{ 3 });
+				RealRandomGenerator<Float> random_extent(0.5f, 4.0f, std::mt19937{ 4 });
+				submeshes.resize(SUBMESH_COUNT);
+				for (Uint32 i = 0; i < BATCH_COUNT; ++i)
+				{
+					entt::entity batch_entity = reg.create();
+					Batch& batch = reg.emplace<Batch>(batch_entity);
+					batch.instance_id = i;
+					batch.submesh = &submeshes[i / (BATCH_COUNT / SUBMESH_COUNT + 1)];
+					batch.alpha_mode = i % 10 == 0 ? MaterialAlphaMode::Mask : MaterialAlphaMode::Opaque;
+					batch.bounding_box = BoundingBox(Vector3(random_position(), random_position() * 0.1f, random_position()), Vector3(random_extent(), random_extent(), random_extent()));
+				}
+
+				Light& sun = reg.emplace<Light>(reg.create());
+				sun.type = LightType::Directional;
+				sun.direction = Vector4(0.3f, -1.0f, 0.2f, 0.0f);
+				sun.casts_shadows = true;
+				sun.use_cascades = true;
+				for (Float x : { -50.0f, 50.0f })
+				{
+					Light& point_light = reg.emplace<Light>(reg.create());
+					point_light.type = LightType::Point;
+					point_light.position = Vector4(x, 10.0f, 0.0f, 1.0f);
+					point_light.range = 80.0f;
+					point_light.casts_shadows = true;
+				}
+
+				camera = Camera(CameraParameters{ .near_plane = 0.1f, .far_plane = 300.0f, .fov = 1.0f, .position = Vector3(0.0f, 20.0f, -100.0f), .look_at = Vector3(0.0f, 0.0f, 0.0f) });
+				shadow_renderer->SetupShadows(&camera);
+			}
+			~ShadowCullingScene()
+			{
+				shadow_renderer.reset();
+				g_ThreadPool.Shutdown();
+			}
+
+			entt::registry& GetRegistry() { return reg; }
+			ShadowRenderer& GetShadowRenderer() { return *shadow_renderer; }
+
+		private:
+			NullDevice gfx;
+			entt::registry reg;
+			std::vector<SubMeshGPU> submeshes;
+			std::unique_ptr<ShadowRenderer> shadow_renderer;
+			Camera camera;
+		};
+	}
+
+	//one walk over the batches, then every shadow view culled on the thread pool into merged per view draw lists
+	static void BM_ShadowCullOnce(benchmark::State& state)
+	{
+		ShadowCullingScene scene;
+		ShadowRenderer& shadow_renderer = scene.GetShadowRenderer();
+		for (auto _ : state)
+		{
+			shadow_renderer.CullShadowCasters();
+		}
+		state.counters["views"] = (Float64)ShadowRendererTestAccess::GetBoundingObjects(shadow_renderer).size();
+		state.counters["scene_walks"] = 1;
+		state.counters["draws"] = (Float64)ShadowRendererTestAccess::GetDrawCount(shadow_renderer);
+	}
+	BENCHMARK(BM_ShadowCullOnce)->Unit(benchmark::kMicrosecond)->UseRealTime();
+
+	//what ShadowMapPass_Common used to do, every view walks the batches, splits them by alpha mode and culls them on its own
+	static void BM_ShadowCullPerViewWalk(benchmark::State& state)
+	{
+		ShadowCullingScene scene;
+		entt::registry& reg = scene.GetRegistry();
+		std::vector<BoundingObject> const& bounding_objects = ShadowRendererTestAccess::GetBoundingObjects(scene.GetShadowRenderer());
+		std::vector<Batch const*> opaque_batches, masked_batches;
+		Uint64 draw_count = 0;
+		for (auto _ : state)
+		{
+			draw_count = 0;
+			for (BoundingObject const& bounding_object : bounding_objects)
+			{
+				opaque_batches.clear();
+				masked_batches.clear();
+				for (entt::entity batch_entity : reg.view<Batch>())
+				{
+					Batch const& batch = reg.get<Batch>(batch_entity);
+					(batch.alpha_mode == MaterialAlphaMode::Opaque ? opaque_batches : masked_batches).push_back(&batch);
+				}
+				for (std::vector<Batch const*> const* batches : { &opaque_batches, &masked_batches })
+				{
+					for (Batch const* batch : *batches)
+					{
+						Bool const visible = bounding_object.type == BoundingObject::Box ? bounding_object.GetBox().Intersects(batch->bounding_box)
+																						  : bounding_object.GetFrustum().Intersects(batch->bounding_box);
+						draw_count += visible;
+					}
+				}
+			}
+			benchmark::DoNotOptimize(draw_count);
+		}
+		state.counters["views"] = (Float64)bounding_objects.size();
+		state.counters["scene_walks"] = (Float64)bounding_objects.size();
+		state.counters["draws"] = (Float64)draw_count;
+	}
+	BENCHMARK(BM_ShadowCullPerViewWalk)->Unit(benchmark::kMicrosecond)->UseRealTime();
+}
@@ -0,0 +1,85 @@
+#include <benchmark/benchmark.h>
+#include <thread>
+#include "Rendering/TextureManager.h"
+#include "Graphics/GfxTexture.h"
+#include "Graphics/Null/NullDevice.h"
+#include "Core/Paths.h"
+#include "Utilities/ThreadPool.h"
+
+namespace fs = std::filesystem;
+
+namespace adria
+{
+	namespace
+	{
+		//every png shipped with the models, the formats streaming decodes on workers
+		std::vector<std::string> GetStreamingTextures()
+		{
+			std::vector<std::string> textures;
+			for (fs::directory_entry const& entry : fs::recursive_directory_iterator(paths::ModelsDir))
+			{
+				if (entry.is_regular_file() && entry.path().extension() == ".png")
+				{
+					textures.push_back(entry.path().string());
+				}
+			}
+			std::sort(textures.begin(), textures.end());
+			return textures;
+		}
+
+		Int64 GetMaxBackgroundThreads()
+		{
+			return std::max<Int64>(std::thread::hardware_concurrency(), 2) - 1;
+		}
+	}
+
+	//streams every texture and runs frames until all of them are resident, the argument is the number of background threads decoding them.
+	//Mips and block compression are off so this measures decode and upload, cooked textures come from the texture cache instead
+	static void BM_TextureStreaming(benchmark::State& state)
+	{
+		std::vector<std::string> const textures = GetStreamingTextures();
+		if (textures.empty())
+		{
+			state.SkipWithError("No textures found");
+			return;
+		}
+
+		NullDevice gfx(nullptr);
+		g_ThreadPool.Initialize((Uint)state.range(0));
+		g_TextureManager.Initialize(&gfx);
+		g_TextureManager.EnableMipMaps(false);
+
+		std::vector<TextureHandle> handles(textures.size());
+		Uint64 frame_count = 0;
+		for (auto _ : state)
+		{
+			g_TextureManager.Clear();
+			for (Uint64 i = 0; i < textures.size(); ++i)
+			{
+				handles[i] = g_TextureManager.StreamTexture(textures[i], INVALID_TEXTURE_HANDLE, TextureCookParams{});
+			}
+			//a frame polls once, the yield stands in for the rest of the frame so the main thread does not starve the decoders
+			while (std::any_of(handles.begin(), handles.end(), [](TextureHandle handle) { return g_TextureManager.GetTexture(handle) == nullptr; }))
+			{
+				g_TextureManager.Update();
+				++frame_count;
+				std::this_thread::yield();
+			}
+		}
+
+		Uint64 decoded_size = 0;
+		for (TextureHandle handle : handles)
+		{
+			GfxTextureDesc const& desc = g_TextureManager.GetTexture(handle)->GetDesc();
+			decoded_size += GetTextureByteSize(desc.format, desc.width, desc.height, 1, desc.mip_levels);
+		}
+		state.SetItemsProcessed(state.iterations() * textures.size());
+		state.SetBytesProcessed(state.iterations() * decoded_size);
+		state.counters["frames"] = benchmark::Counter((Float64)frame_count, benchmark::Counter::kAvgIterations);
+		state.counters["workers"] = (Float64)g_ThreadPool.GetWorkerCount();
+
+		g_TextureManager.Shutdown();
+		g_ThreadPool.Shutdown();
+	}
+	BENCHMARK(BM_TextureStreaming)->DenseRange(1, GetMaxBackgroundThreads())->Unit(benchmark::kMillisecond)->UseRealTime();
+}
@@ -0,0 +1,117 @@
+#include <benchmark/benchmark.h>
+#include <thread>
+#include "Utilities/ThreadPool.h"
+
+namespace adria
+{
+	namespace
+	{
+		constexpr Uint64 ITEM_COUNT = 1 << 20;
+
+		//a few dozen flops per item, small enough that scheduling overhead shows up at fine grains
+		Float WorkItem(Uint64 i)
+		{
+			Float x = (Float)(i & 1023);
+			for (Uint32 k = 0; k < 8; ++k)
+			{
+				x = std::sqrt(x * 1.5f + 1.0f);
+			}
+			return x;
+		}
+
+		//the argument is the number of background threads, the pool clamps it to the core count and adds the calling thread as a worker
+		void ReportWorkers(benchmark::State& state)
+		{
+			state.counters["workers"] = (Float64)g_ThreadPool.GetWorkerCount();
+		}
+
+		//powers of two up to the core count minus the calling thread
+		std::vector<Int64> GetThreadCounts()
+		{
+			Int64 const max_threads = std::max<Int64>(std::thread::hardware_concurrency(), 2) - 1;
+			std::vector<Int64> thread_counts;
+			for (Int64 threads = 1; threads < max_threads; threads *= 2)
+			{
+				thread_counts.push_back(threads);
+			}
+			thread_counts.push_back(max_threads);
+			return thread_counts;
+		}
+	}
+
+	static void BM_ParallelForSerial(benchmark::State& state)
+	{
+		std::vector<Float> output(ITEM_COUNT);
+		for (auto _ : state)
+		{
+			for (Uint64 i = 0; i < ITEM_COUNT; ++i)
+			{
+				output[i] = WorkItem(i);
+			}
+			benchmark::DoNotOptimize(output.data());
+		}
+		state.SetItemsProcessed(state.iterations() * ITEM_COUNT);
+	}
+	BENCHMARK(BM_ParallelForSerial)->Unit(benchmark::kMicrosecond);
+
+	static void BM_ParallelForScaling(benchmark::State& state)
+	{
+		g_ThreadPool.Initialize((Uint)state.range(0));
+		Uint64 const grain = (Uint64)state.range(1);
+		std::vector<Float> output(ITEM_COUNT);
+		for (auto _ : state)
+		{
+			g_ThreadPool.ParallelFor(0, ITEM_COUNT, grain, [&](Uint64 i) { output[i] = WorkItem(i); });
+			benchmark::DoNotOptimize(output.data());
+		}
+		state.SetItemsProcessed(state.iterations() * ITEM_COUNT);
+		ReportWorkers(state);
+		g_ThreadPool.Shutdown();
+	}
+	BENCHMARK(BM_ParallelForScaling)->ArgsProduct({ GetThreadCounts(), { 256, 4096 } })->Unit(benchmark::kMicrosecond)->UseRealTime();
+
+	//cost of one Dispatch plus its execution, the jobs are empty
+	static void BM_DispatchEmptyJobs(benchmark::State& state)
+	{
+		g_ThreadPool.Initialize((Uint)state.range(0));
+		Uint64 const job_count = 1000;
+		for (auto _ : state)
+		{
+			JobCounter counter;
+			for (Uint64 i = 0; i < job_count; ++i)
+			{
+				g_ThreadPool.Dispatch(counter, []() {});
+			}
+			g_ThreadPool.Wait(counter);
+		}
+		state.SetItemsProcessed(state.iterations() * job_count);
+		ReportWorkers(state);
+		g_ThreadPool.Shutdown();
+	}
+	BENCHMARK(BM_DispatchEmptyJobs)->ArgsProduct({ GetThreadCounts() })->Unit(benchmark::kMicrosecond)->UseRealTime();
+
+	//the heap allocating packaged task path, what every task paid before the job system
+	static void BM_SubmitEmptyTasks(benchmark::State& state)
+	{
+		g_ThreadPool.Initialize((Uint)state.range(0));
+		Uint64 const task_count = 1000;
+		std::vector<std::future<void>> futures;
+		futures.reserve(task_count);
+		for (auto _ : state)
+		{
+			futures.clear();
+			for (Uint64 i = 0; i < task_count; ++i)
+			{
+				futures.push_back(g_ThreadPool.Submit([]() {}));
+			}
+			for (std::future<void>& future : futures)
+			{
+				future.wait();
+			}
+		}
+		state.SetItemsProcessed(state.iterations() * task_count);
+		ReportWorkers(state);
+		g_ThreadPool.Shutdown();
+	}
+	BENCHMARK(BM_SubmitEmptyTasks)->ArgsProduct({ GetThreadCounts() })->Unit(benchmark::kMicrosecond)->UseRealTime();
+}
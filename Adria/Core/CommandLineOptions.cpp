@@ -24,6 +24,9 @@ namespace adria::CommandLineOptions
 		Bool perf_report = false;
 		Bool perf_hud = false;
 		Bool wait_debugger = false;
+		Bool cook_models = false;
+		Bool null_gfx = false;
+		Int frame_count = 0;
 
 		void RegisterOptions(CLIParser& cli_parser)
 		{
@@ -47,6 +50,9 @@ namespace adria::CommandLineOptions
 			cli_parser.AddArg(false, "-perfreport");
 			cli_parser.AddArg(false, "-perfhud");
 			cli_parser.AddArg(false, "-waitdebugger");
+			cli_parser.AddArg(false, "-cook");
+			cli_parser.AddArg(false, "-nullgfx");
+			cli_parser.AddArg(true, "-frames");
 		}
 
 		void SetOptionValues(CLIParseResult const& parse_result)
@@ -70,6 +76,9 @@ namespace adria::CommandLineOptions
 			perf_report = parse_result["-perfreport"];
 			perf_hud = parse_result["-perfhud"];
 			wait_debugger = parse_result["-waitdebugger"];
+			cook_models = parse_result["-cook"];
+			null_gfx = parse_result["-nullgfx"];
+			frame_count = parse_result["-frames"].AsIntOr(300);
 		}
 	}
 
@@ -183,5 +192,20 @@ namespace adria::CommandLineOptions
 		return wait_debugger;
 	}
 
+	Bool GetCookModels()
+	{
+		return cook_models;
+	}
+
+	Bool GetNullGfx()
+	{
+		return null_gfx;
+	}
+
+	Int GetFrameCount()
+	{
+		return frame_count;
+	}
+
 }
 
@@ -26,6 +26,9 @@ namespace adria
 		Bool GetPerfReport();
 		Bool GetPerfHUD();
 		Bool WaitDebugger();
+		Bool GetCookModels();
+		Bool GetNullGfx();
+		Int GetFrameCount();
 	}
 }
 
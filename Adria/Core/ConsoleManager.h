@@ -236,7 +236,7 @@ namespace adria
 			if constexpr (std::is_same_v<T, Float>) return AsVariable()->GetFloat();
 			if constexpr (std::is_same_v<T, std::string>) return AsVariable()->GetString();
 		}
-		T* GetPtr() const
+		T* GetPtr()
 		{
 			if constexpr (std::is_same_v<T, Bool>) return AsVariable()->GetBoolPtr();
 			if constexpr (std::is_same_v<T, Int>) return  AsVariable()->GetIntPtr();
@@ -24,14 +24,23 @@ namespace adria
 	{
 		g_ThreadPool.Initialize();
 #if defined(ADRIA_PLATFORM_WINDOWS)
-		gfx = CreateGfxDevice(GfxBackend::D3D12, window);
+		GfxBackend backend = GfxBackend::D3D12;
 #elif defined(ADRIA_PLATFORM_MACOS)
-		gfx = CreateGfxDevice(GfxBackend::Metal, window);
+		GfxBackend backend = GfxBackend::Metal;
 #else
-		gfx = CreateGfxDevice(GfxBackend::Vulkan, window);
+		GfxBackend backend = GfxBackend::Null;
 #endif
-		GfxShaderCompiler::Initialize(gfx.get());
-		ShaderManager::Initialize();
+		if (CommandLineOptions::GetNullGfx())
+		{
+			backend = GfxBackend::Null;
+		}
+		gfx = CreateGfxDevice(backend, window);
+		//the null device never asks for bytecode, so it runs without dxc and the shader cache
+		if (backend != GfxBackend::Null)
+		{
+			GfxShaderCompiler::Initialize(gfx.get());
+			ShaderManager::Initialize();
+		}
 		g_TextureManager.Initialize(gfx.get());
 		renderer = std::make_unique<Renderer>(reg, gfx.get(), window->Width(), window->Height());
 		scene_loader = std::make_unique<SceneLoader>(reg, gfx.get());
@@ -62,8 +71,11 @@ namespace adria
 	Engine::~Engine()
 	{
 		g_TextureManager.Shutdown();
-		ShaderManager::Destroy();
-		GfxShaderCompiler::Destroy();
+		if (gfx->GetBackend() != GfxBackend::Null)
+		{
+			ShaderManager::Destroy();
+			GfxShaderCompiler::Destroy();
+		}
 		g_ThreadPool.Shutdown();
 	}
 
@@ -101,6 +113,11 @@ namespace adria
 	{
 		ZoneScopedN("Engine::Update");
 		HandleSceneRequest();
+		if (ShaderManager::HaveShadersChanged())
+		{
+			gfx->WaitForGPU();
+			ShaderManager::CheckIfShadersHaveChanged();
+		}
 		renderer->NewFrame(camera.get());
 		camera->Update(dt);
 		gfx->Update();
@@ -155,12 +172,14 @@ namespace adria
 			for (ModelParameters const& model : config.scene_models) scene_loader->LoadModel(model);
 			for (LightParameters const& light : config.scene_lights) scene_loader->LoadLight(light);
 
+			//geometry is uploaded on the copy queue, the buffers are back in the common state once the copies are done
+			g_GeometryBufferCache.WaitForUploads(cmd_list);
 			auto ray_tracing_view = reg.view<Mesh, RayTracing>();
 			for (entt::entity entity : reg.view<Mesh, RayTracing>())
 			{
 				auto const& mesh = ray_tracing_view.get<Mesh>(entity);
 				GfxBuffer* buffer = g_GeometryBufferCache.GetGeometryBuffer(mesh.geometry_buffer_handle);
-				cmd_list->BufferBarrier(*buffer, GfxResourceState::CopyDst, GfxResourceState::AllSRV);
+				cmd_list->BufferBarrier(*buffer, GfxResourceState::Common, GfxResourceState::AllSRV);
 			}
 
 			renderer->OnSceneInitialized();
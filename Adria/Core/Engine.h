@@ -29,6 +29,7 @@ namespace adria
 
 		Renderer* GetRenderer()   const { return renderer.get(); }
 		GfxDevice* GetGfxDevice() const { return gfx.get(); }
+		Camera* GetCamera()      const { return camera.get(); }
 
 	private:
 		Window* window = nullptr;
@@ -21,6 +21,8 @@ namespace adria::paths
 	extern std::string const RenderDocCapturesDir;
 	extern std::string const RenderGraphDir;
 	extern std::string const ShaderCacheDir;
+	extern std::string const ModelCacheDir;
+	extern std::string const TextureCacheDir;
 	extern std::string const ShaderPDBDir;
 	extern std::string const IniDir;
 	extern std::string const ScenesDir;
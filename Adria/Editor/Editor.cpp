@@ -116,15 +116,24 @@ namespace adria
 
 	Bool Editor::IsActive() const
 	{
-		return gui->IsVisible();
+		return gui && gui->IsVisible();
 	}
 
+	//commands are consumed by the editor pass, queueing them while it is not added would only grow the lists
 	void Editor::AddCommand(GUICommand&& command)
 	{
+		if (!IsActive())
+		{
+			return;
+		}
 		commands.emplace_back(std::move(command));
 	}
 	void Editor::AddDebugTexture(GUITexture&& debug_texture)
 	{
+		if (!IsActive())
+		{
+			return;
+		}
 		debug_textures.emplace_back(std::move(debug_texture));
 	}
 	void Editor::AddRenderPass(RenderGraph& rg)
@@ -2,6 +2,7 @@
 #include "D3D12Defines.h"
 #include "D3D12MemAlloc.h"
 #include "D3D12Device.h"
+#include "Graphics/GfxHeap.h"
 #include "Graphics/GfxCommandList.h"
 #include "Graphics/GfxLinearDynamicAllocator.h"
 #include "Utilities/Align.h"
@@ -9,10 +10,8 @@
 
 namespace adria
 {
-
-	D3D12Buffer::D3D12Buffer(GfxDevice* gfx, GfxBufferDesc const& desc, GfxBufferData initial_data /*= {}*/) : GfxBuffer(gfx, desc)
+	D3D12_RESOURCE_DESC ToD3D12ResourceDesc(GfxBufferDesc const& desc)
 	{
-		D3D12Device* d3d12_gfx = static_cast<D3D12Device*>(gfx);
 		Uint64 buffer_size = desc.size;
 		if (HasFlag(desc.misc_flags, GfxBufferMiscFlag::ConstantBuffer))
 		{
@@ -41,6 +40,14 @@ namespace adria
 		{
 			resource_desc.Flags |= D3D12_RESOURCE_FLAG_DENY_SHADER_RESOURCE;
 		}
+		return resource_desc;
+	}
+
+	D3D12Buffer::D3D12Buffer(GfxDevice* gfx, GfxBufferDesc const& desc, GfxBufferData initial_data /*= {}*/) : GfxBuffer(gfx, desc)
+	{
+		D3D12Device* d3d12_gfx = static_cast<D3D12Device*>(gfx);
+		D3D12_RESOURCE_DESC resource_desc = ToD3D12ResourceDesc(desc);
+		Uint64 buffer_size = resource_desc.Width;
 
 		D3D12_RESOURCE_STATES resource_state = D3D12_RESOURCE_STATE_COMMON;
 		if (HasFlag(desc.misc_flags, GfxBufferMiscFlag::AccelStruct))
@@ -121,6 +128,32 @@ namespace adria
 
 	}
 
+	D3D12Buffer::D3D12Buffer(GfxDevice* gfx, GfxBufferDesc const& desc, GfxHeap* heap, Uint64 heap_offset) : GfxBuffer(gfx, desc)
+	{
+		ADRIA_ASSERT(heap != nullptr);
+		ADRIA_ASSERT_MSG(desc.resource_usage == GfxResourceUsage::Default, "Only default heap buffers can be placed!");
+		ADRIA_ASSERT_MSG(!HasFlag(desc.misc_flags, GfxBufferMiscFlag::Shared), "Shared buffers cannot be placed!");
+		D3D12Device* d3d12_gfx = static_cast<D3D12Device*>(gfx);
+
+		D3D12_RESOURCE_DESC resource_desc = ToD3D12ResourceDesc(desc);
+		D3D12_RESOURCE_STATES resource_state = D3D12_RESOURCE_STATE_COMMON;
+		if (HasFlag(desc.misc_flags, GfxBufferMiscFlag::AccelStruct))
+		{
+			resource_state = D3D12_RESOURCE_STATE_RAYTRACING_ACCELERATION_STRUCTURE;
+		}
+
+		D3D12MA::Allocator* allocator = d3d12_gfx->GetD3D12Allocator();
+		HRESULT hr = allocator->CreateAliasingResource(
+			(D3D12MA::Allocation*)heap->GetHandle(),
+			heap_offset,
+			&resource_desc,
+			resource_state,
+			nullptr,
+			IID_PPV_ARGS(resource.GetAddressOf())
+		);
+		D3D12_CHECK_CALL(hr);
+	}
+
 	D3D12Buffer::~D3D12Buffer()
 	{
 		if (mapped_data != nullptr)
@@ -4,10 +4,15 @@
 
 namespace adria
 {
+	class GfxHeap;
+
+	D3D12_RESOURCE_DESC ToD3D12ResourceDesc(GfxBufferDesc const& desc);
+
 	class D3D12Buffer final : public GfxBuffer
 	{
 	public:
 		D3D12Buffer(GfxDevice* gfx, GfxBufferDesc const& desc, GfxBufferData initial_data = {});
+		D3D12Buffer(GfxDevice* gfx, GfxBufferDesc const& desc, GfxHeap* heap, Uint64 heap_offset);
 		virtual ~D3D12Buffer() override;
 
 		virtual void* GetNative() const override;
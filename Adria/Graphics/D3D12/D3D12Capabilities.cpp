@@ -84,6 +84,7 @@ namespace adria
 		work_graph_support = ConvertWorkGraphTier(feature_support.WorkGraphsTier());
 		shader_model = ConvertShaderModel(feature_support.HighestShaderModel());
 		enhanced_barriers_supported = feature_support.EnhancedBarriersSupported();
+		resource_aliasing_supported = true;
 		typed_uav_additional_formats_supported = feature_support.TypedUAVLoadAdditionalFormats();
 		shading_rate_image_tile_size = feature_support.ShadingRateImageTileSize();
 		additional_shading_rates_supported = feature_support.AdditionalShadingRatesSupported();
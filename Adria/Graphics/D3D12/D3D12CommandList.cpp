@@ -17,6 +17,7 @@
 #include "Graphics/GfxProfiler.h"
 #include "Graphics/GfxNsightPerfManager.h"
 #include "Utilities/StringConversions.h"
+#include "Utilities/Align.h"
 #include "pix3.h"
 
 namespace adria
@@ -384,6 +385,36 @@ namespace adria
 
 	void D3D12CommandList::TextureBarrier(GfxTexture const& texture, GfxResourceState flags_before, GfxResourceState flags_after, Uint32 subresource)
 	{
+		AddTextureBarrier(texture, flags_before, flags_after, subresource, GfxBarrierSplit::None);
+	}
+
+	void D3D12CommandList::BufferBarrier(GfxBuffer const& buffer, GfxResourceState flags_before, GfxResourceState flags_after)
+	{
+		AddBufferBarrier(buffer, flags_before, flags_after, GfxBarrierSplit::None);
+	}
+
+	void D3D12CommandList::SplitTextureBarrier(GfxTexture const& texture, GfxResourceState flags_before, GfxResourceState flags_after, GfxBarrierSplit split)
+	{
+		AddTextureBarrier(texture, flags_before, flags_after, D3D12_RESOURCE_BARRIER_ALL_SUBRESOURCES, split);
+	}
+
+	void D3D12CommandList::SplitBufferBarrier(GfxBuffer const& buffer, GfxResourceState flags_before, GfxResourceState flags_after, GfxBarrierSplit split)
+	{
+		AddBufferBarrier(buffer, flags_before, flags_after, split);
+	}
+
+	void D3D12CommandList::AddTextureBarrier(GfxTexture const& texture, GfxResourceState flags_before, GfxResourceState flags_after, Uint32 subresource, GfxBarrierSplit split)
+	{
+		//uav, aliasing and discard barriers cannot be split, the whole barrier is recorded at the end
+		if (split != GfxBarrierSplit::None && (HasAnyFlag(flags_before, GfxResourceState::Discard) || (flags_before == GfxResourceState::ComputeUAV && flags_after == GfxResourceState::ComputeUAV)))
+		{
+			if (split == GfxBarrierSplit::Begin)
+			{
+				return;
+			}
+			split = GfxBarrierSplit::None;
+		}
+
 		if (use_legacy_barriers)
 		{
 			if (flags_before == GfxResourceState::ComputeUAV && flags_after == GfxResourceState::ComputeUAV)
@@ -393,6 +424,34 @@ namespace adria
 				barrier.UAV.pResource = (ID3D12Resource*)texture.GetNative();
 				legacy_barriers.push_back(barrier);
 			}
+			else if (HasAnyFlag(flags_before, GfxResourceState::Discard))
+			{
+				D3D12_RESOURCE_BARRIER barrier{};
+				barrier.Type = D3D12_RESOURCE_BARRIER_TYPE_ALIASING;
+				barrier.Aliasing.pResourceBefore = nullptr;
+				barrier.Aliasing.pResourceAfter = (ID3D12Resource*)texture.GetNative();
+				legacy_barriers.push_back(barrier);
+
+				GfxResourceState initial_state = texture.GetDesc().initial_state;
+				GfxBindFlag const bind_flags = texture.GetDesc().bind_flags;
+				if (HasAnyFlag(bind_flags, GfxBindFlag::RenderTarget | GfxBindFlag::DepthStencil))
+				{
+					//an aliased render target or depth stencil must be cleared, copied to or discarded before first use,
+					//otherwise its contents, including compression metadata, are undefined
+					GfxResourceState const discard_state = HasAnyFlag(bind_flags, GfxBindFlag::DepthStencil) ? GfxResourceState::DSV : GfxResourceState::RTV;
+					if (initial_state != discard_state)
+					{
+						AddTextureBarrier(texture, initial_state, discard_state, subresource, GfxBarrierSplit::None);
+					}
+					FlushBarriers();
+					cmd_list->DiscardResource((ID3D12Resource*)texture.GetNative(), nullptr);
+					initial_state = discard_state;
+				}
+				if (initial_state != flags_after)
+				{
+					AddTextureBarrier(texture, initial_state, flags_after, subresource, GfxBarrierSplit::None);
+				}
+			}
 			else
 			{
 				D3D12_RESOURCE_BARRIER barrier{};
@@ -401,14 +460,22 @@ namespace adria
 				barrier.Transition.Subresource = D3D12_RESOURCE_BARRIER_ALL_SUBRESOURCES;
 				barrier.Transition.StateBefore = ToD3D12LegacyResourceState(flags_before);
 				barrier.Transition.StateAfter = ToD3D12LegacyResourceState(flags_after);
+				if (split == GfxBarrierSplit::Begin)
+				{
+					barrier.Flags = D3D12_RESOURCE_BARRIER_FLAG_BEGIN_ONLY;
+				}
+				else if (split == GfxBarrierSplit::End)
+				{
+					barrier.Flags = D3D12_RESOURCE_BARRIER_FLAG_END_ONLY;
+				}
 				legacy_barriers.push_back(barrier);
 			}
 		}
 		else
 		{
 			D3D12_TEXTURE_BARRIER barrier{};
-			barrier.SyncBefore = ToD3D12BarrierSync(flags_before);
-			barrier.SyncAfter = ToD3D12BarrierSync(flags_after);
+			barrier.SyncBefore = split == GfxBarrierSplit::End ? D3D12_BARRIER_SYNC_SPLIT : ToD3D12BarrierSync(flags_before);
+			barrier.SyncAfter = split == GfxBarrierSplit::Begin ? D3D12_BARRIER_SYNC_SPLIT : ToD3D12BarrierSync(flags_after);
 			barrier.AccessBefore = ToD3D12BarrierAccess(flags_before);
 			barrier.AccessAfter = ToD3D12BarrierAccess(flags_after);
 			barrier.LayoutBefore = ToD3D12BarrierLayout(flags_before);
@@ -424,8 +491,17 @@ namespace adria
 		}
 	}
 
-	void D3D12CommandList::BufferBarrier(GfxBuffer const& buffer, GfxResourceState flags_before, GfxResourceState flags_after)
+	void D3D12CommandList::AddBufferBarrier(GfxBuffer const& buffer, GfxResourceState flags_before, GfxResourceState flags_after, GfxBarrierSplit split)
 	{
+		if (split != GfxBarrierSplit::None && (HasAnyFlag(flags_before, GfxResourceState::Discard) || (flags_before == GfxResourceState::ComputeUAV && flags_after == GfxResourceState::ComputeUAV)))
+		{
+			if (split == GfxBarrierSplit::Begin)
+			{
+				return;
+			}
+			split = GfxBarrierSplit::None;
+		}
+
 		if (use_legacy_barriers)
 		{
 			if (flags_before == GfxResourceState::ComputeUAV && flags_after == GfxResourceState::ComputeUAV)
@@ -435,6 +511,19 @@ namespace adria
 				barrier.UAV.pResource = (ID3D12Resource*)buffer.GetNative();
 				legacy_barriers.push_back(barrier);
 			}
+			else if (HasAnyFlag(flags_before, GfxResourceState::Discard))
+			{
+				D3D12_RESOURCE_BARRIER barrier{};
+				barrier.Type = D3D12_RESOURCE_BARRIER_TYPE_ALIASING;
+				barrier.Aliasing.pResourceBefore = nullptr;
+				barrier.Aliasing.pResourceAfter = (ID3D12Resource*)buffer.GetNative();
+				legacy_barriers.push_back(barrier);
+
+				if (flags_after != GfxResourceState::Common)
+				{
+					AddBufferBarrier(buffer, GfxResourceState::Common, flags_after, GfxBarrierSplit::None);
+				}
+			}
 			else
 			{
 				D3D12_RESOURCE_BARRIER barrier{};
@@ -443,14 +532,22 @@ namespace adria
 				barrier.Transition.Subresource = D3D12_RESOURCE_BARRIER_ALL_SUBRESOURCES;
 				barrier.Transition.StateBefore = ToD3D12LegacyResourceState(flags_before);
 				barrier.Transition.StateAfter = ToD3D12LegacyResourceState(flags_after);
+				if (split == GfxBarrierSplit::Begin)
+				{
+					barrier.Flags = D3D12_RESOURCE_BARRIER_FLAG_BEGIN_ONLY;
+				}
+				else if (split == GfxBarrierSplit::End)
+				{
+					barrier.Flags = D3D12_RESOURCE_BARRIER_FLAG_END_ONLY;
+				}
 				legacy_barriers.push_back(barrier);
 			}
 		}
 		else
 		{
 			D3D12_BUFFER_BARRIER barrier{};
-			barrier.SyncBefore = ToD3D12BarrierSync(flags_before);
-			barrier.SyncAfter = ToD3D12BarrierSync(flags_after);
+			barrier.SyncBefore = split == GfxBarrierSplit::End ? D3D12_BARRIER_SYNC_SPLIT : ToD3D12BarrierSync(flags_before);
+			barrier.SyncAfter = split == GfxBarrierSplit::Begin ? D3D12_BARRIER_SYNC_SPLIT : ToD3D12BarrierSync(flags_after);
 			barrier.AccessBefore = ToD3D12BarrierAccess(flags_before);
 			barrier.AccessAfter = ToD3D12BarrierAccess(flags_after);
 			barrier.pResource = (ID3D12Resource*)buffer.GetNative();
@@ -585,10 +682,10 @@ namespace adria
 	{
 		GfxTextureDesc const& desc = dst_texture.GetDesc();
 
-		Uint32 min_width = GetGfxFormatBlockSize(desc.format);
-		Uint32 min_height = GetGfxFormatBlockSize(desc.format);
-		Uint32 w = std::max(desc.width >> mip_level, min_width);
-		Uint32 h = std::max(desc.height >> mip_level, min_height);
+		//block compressed footprints cover whole blocks, also for mips that are not a multiple of the block size
+		Uint32 block_size = GetGfxFormatBlockSize(desc.format);
+		Uint32 w = AlignUp(std::max(desc.width >> mip_level, 1u), block_size);
+		Uint32 h = AlignUp(std::max(desc.height >> mip_level, 1u), block_size);
 		Uint32 d = std::max(desc.depth >> mip_level, 1u);
 
 		D3D12_TEXTURE_COPY_LOCATION copy_dst{};
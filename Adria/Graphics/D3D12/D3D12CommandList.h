@@ -55,6 +55,8 @@ namespace adria
 		virtual void TextureBarrier(GfxTexture const& texture, GfxResourceState flags_before, GfxResourceState flags_after, Uint32 subresource = D3D12_RESOURCE_BARRIER_ALL_SUBRESOURCES) override;
 		virtual void BufferBarrier(GfxBuffer const& buffer, GfxResourceState flags_before, GfxResourceState flags_after) override;
 		virtual void GlobalBarrier(GfxResourceState flags_before, GfxResourceState flags_after) override;
+		virtual void SplitTextureBarrier(GfxTexture const& texture, GfxResourceState flags_before, GfxResourceState flags_after, GfxBarrierSplit split) override;
+		virtual void SplitBufferBarrier(GfxBuffer const& buffer, GfxResourceState flags_before, GfxResourceState flags_after, GfxBarrierSplit split) override;
 		virtual void FlushBarriers() override;
 
 		virtual void CopyBuffer(GfxBuffer& dst, GfxBuffer const& src) override;
@@ -137,5 +139,9 @@ namespace adria
 		std::unique_ptr<DrawIndexedIndirectSignature> draw_indexed_indirect_signature;
 		std::unique_ptr<DispatchIndirectSignature> dispatch_indirect_signature;
 		std::unique_ptr<DispatchMeshIndirectSignature> dispatch_mesh_indirect_signature;
+
+	private:
+		void AddTextureBarrier(GfxTexture const& texture, GfxResourceState flags_before, GfxResourceState flags_after, Uint32 subresource, GfxBarrierSplit split);
+		void AddBufferBarrier(GfxBuffer const& buffer, GfxResourceState flags_before, GfxResourceState flags_after, GfxBarrierSplit split);
 	};
 }
\ No newline at end of file
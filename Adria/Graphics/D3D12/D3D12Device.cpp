@@ -8,6 +8,7 @@
 #include "D3D12DescriptorHeap.h"
 #include "D3D12CommandSignature.h"
 #include "D3D12QueryHeap.h"
+#include "D3D12Heap.h"
 #include "D3D12PipelineState.h"
 #include "D3D12RayTracingAS.h"
 #include "D3D12RayTracingPipeline.h"
@@ -552,6 +553,21 @@ namespace adria
 		return std::make_shared<D3D12Buffer>(this, desc);
 	}
 
+	std::unique_ptr<GfxHeap> D3D12Device::CreateHeap(GfxHeapDesc const& desc)
+	{
+		return std::make_unique<D3D12Heap>(this, desc);
+	}
+
+	std::unique_ptr<GfxTexture> D3D12Device::CreatePlacedTexture(GfxTextureDesc const& desc, GfxHeap* heap, Uint64 heap_offset)
+	{
+		return std::make_unique<D3D12Texture>(this, desc, heap, heap_offset);
+	}
+
+	std::unique_ptr<GfxBuffer> D3D12Device::CreatePlacedBuffer(GfxBufferDesc const& desc, GfxHeap* heap, Uint64 heap_offset)
+	{
+		return std::make_unique<D3D12Buffer>(this, desc, heap, heap_offset);
+	}
+
 	std::unique_ptr<GfxPipelineState>	D3D12Device::CreateGraphicsPipelineState(GfxGraphicsPipelineStateDesc const& desc)
 	{
 		return std::make_unique<D3D12PipelineState>(this, desc);
@@ -827,6 +843,19 @@ namespace adria
 		return buffer_footprint.Footprint.RowPitch * buffer_footprint.Footprint.Height;
 	}
 
+	GfxAllocationInfo D3D12Device::GetAllocationInfo(GfxTextureDesc const& desc) const
+	{
+		D3D12_RESOURCE_DESC resource_desc = ToD3D12ResourceDesc(desc);
+		D3D12_RESOURCE_ALLOCATION_INFO allocation_info = device->GetResourceAllocationInfo(0, 1, &resource_desc);
+		return GfxAllocationInfo{ .size = allocation_info.SizeInBytes, .alignment = allocation_info.Alignment };
+	}
+	GfxAllocationInfo D3D12Device::GetAllocationInfo(GfxBufferDesc const& desc) const
+	{
+		D3D12_RESOURCE_DESC resource_desc = ToD3D12ResourceDesc(desc);
+		D3D12_RESOURCE_ALLOCATION_INFO allocation_info = device->GetResourceAllocationInfo(0, 1, &resource_desc);
+		return GfxAllocationInfo{ .size = allocation_info.SizeInBytes, .alignment = allocation_info.Alignment };
+	}
+
 	void D3D12Device::GetTimestampFrequency(Uint64& frequency) const
 	{
 		frequency = graphics_queue->GetTimestampFrequency();
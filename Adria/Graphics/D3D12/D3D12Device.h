@@ -80,6 +80,10 @@ namespace adria
 		virtual std::shared_ptr<GfxBuffer>  CreateBufferShared(GfxBufferDesc const& desc, GfxBufferData const& initial_data) override;
 		virtual std::shared_ptr<GfxBuffer>  CreateBufferShared(GfxBufferDesc const& desc) override;
 
+		virtual std::unique_ptr<GfxHeap>	CreateHeap(GfxHeapDesc const& desc) override;
+		virtual std::unique_ptr<GfxTexture> CreatePlacedTexture(GfxTextureDesc const& desc, GfxHeap* heap, Uint64 heap_offset) override;
+		virtual std::unique_ptr<GfxBuffer>  CreatePlacedBuffer(GfxBufferDesc const& desc, GfxHeap* heap, Uint64 heap_offset) override;
+
 		virtual std::unique_ptr<GfxPipelineState> CreateGraphicsPipelineState(GfxGraphicsPipelineStateDesc const& desc) override;
 		virtual std::unique_ptr<GfxPipelineState> CreateComputePipelineState(GfxComputePipelineStateDesc const& desc) override;
 		virtual std::unique_ptr<GfxPipelineState> CreateMeshShaderPipelineState(GfxMeshShaderPipelineStateDesc const& desc) override;
@@ -100,6 +104,8 @@ namespace adria
 
 		virtual Uint64 GetLinearBufferSize(GfxTexture const* texture) const override;
 		virtual Uint64 GetLinearBufferSize(GfxBuffer const* buffer) const override;
+		virtual GfxAllocationInfo GetAllocationInfo(GfxTextureDesc const& desc) const override;
+		virtual GfxAllocationInfo GetAllocationInfo(GfxBufferDesc const& desc) const override;
 
 		virtual void GetTimestampFrequency(Uint64& frequency) const override;
 		virtual GPUMemoryUsage GetMemoryUsage() const override;
@@ -0,0 +1,46 @@
+#include "D3D12Heap.h"
+#include "D3D12Defines.h"
+#include "D3D12Device.h"
+#include "Utilities/Align.h"
+
+namespace adria
+{
+	inline constexpr D3D12_HEAP_FLAGS ToD3D12HeapFlags(GfxHeapUsage usage)
+	{
+		switch (usage)
+		{
+		case GfxHeapUsage::Buffers:
+			return D3D12_HEAP_FLAG_ALLOW_ONLY_BUFFERS;
+		case GfxHeapUsage::Textures:
+			return D3D12_HEAP_FLAG_ALLOW_ONLY_NON_RT_DS_TEXTURES;
+		case GfxHeapUsage::RenderTargets:
+			return D3D12_HEAP_FLAG_ALLOW_ONLY_RT_DS_TEXTURES;
+		}
+		return D3D12_HEAP_FLAG_NONE;
+	}
+
+	D3D12Heap::D3D12Heap(GfxDevice* gfx, GfxHeapDesc const& desc) : GfxHeap(gfx, desc)
+	{
+		ADRIA_ASSERT(desc.size > 0);
+		this->desc.size = AlignUp(desc.size, D3D12_DEFAULT_RESOURCE_PLACEMENT_ALIGNMENT);
+
+		D3D12MA::ALLOCATION_DESC allocation_desc{};
+		allocation_desc.HeapType = D3D12_HEAP_TYPE_DEFAULT;
+		allocation_desc.ExtraHeapFlags = ToD3D12HeapFlags(desc.usage);
+		allocation_desc.Flags = D3D12MA::ALLOCATION_FLAG_COMMITTED;
+
+		D3D12_RESOURCE_ALLOCATION_INFO allocation_info{};
+		allocation_info.SizeInBytes = this->desc.size;
+		allocation_info.Alignment = desc.usage == GfxHeapUsage::RenderTargets ? D3D12_DEFAULT_MSAA_RESOURCE_PLACEMENT_ALIGNMENT : D3D12_DEFAULT_RESOURCE_PLACEMENT_ALIGNMENT;
+
+		D3D12MA::Allocator* allocator = ((D3D12Device*)gfx)->GetD3D12Allocator();
+		D3D12MA::Allocation* alloc = nullptr;
+		D3D12_CHECK_CALL(allocator->AllocateMemory(&allocation_desc, &allocation_info, &alloc));
+		allocation.reset(alloc);
+	}
+
+	D3D12Heap::~D3D12Heap()
+	{
+		gfx->AddToReleaseQueue(allocation.release());
+	}
+}
@@ -0,0 +1,18 @@
+#pragma once
+#include "Graphics/GfxHeap.h"
+#include "Utilities/Releasable.h"
+
+namespace adria
+{
+	class D3D12Heap final : public GfxHeap
+	{
+	public:
+		D3D12Heap(GfxDevice* gfx, GfxHeapDesc const& desc);
+		~D3D12Heap();
+
+		virtual void* GetHandle() const override { return allocation.get(); }
+
+	private:
+		ReleasablePtr<D3D12MA::Allocation> allocation = nullptr;
+	};
+}
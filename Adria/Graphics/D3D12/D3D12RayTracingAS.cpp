@@ -4,6 +4,7 @@
 #include "Graphics/GfxRayTracingAS.h"
 #include "Graphics/GfxCommandList.h"
 #include "Graphics/GfxBuffer.h"
+#include "Graphics/GfxLinearDynamicAllocator.h"
 
 namespace adria
 {
@@ -40,12 +41,12 @@ namespace adria
 			return d3d12_flags;
 		}
 
-		inline D3D12_RAYTRACING_GEOMETRY_DESC ConvertRayTracingGeometry(GfxRayTracingGeometry const& geometry)
+		inline D3D12_RAYTRACING_GEOMETRY_DESC ConvertRayTracingGeometry(GfxRayTracingGeometry const& geometry, Uint64 transform_address)
 		{
 			D3D12_RAYTRACING_GEOMETRY_DESC d3d12_desc{};
 			d3d12_desc.Type = D3D12_RAYTRACING_GEOMETRY_TYPE_TRIANGLES;
 			d3d12_desc.Flags = geometry.opaque ? D3D12_RAYTRACING_GEOMETRY_FLAG_OPAQUE : D3D12_RAYTRACING_GEOMETRY_FLAG_NONE;
-			d3d12_desc.Triangles.Transform3x4 = NULL;
+			d3d12_desc.Triangles.Transform3x4 = transform_address;
 			d3d12_desc.Triangles.VertexBuffer.StartAddress = geometry.vertex_buffer->GetGpuAddress() + geometry.vertex_buffer_offset;
 			d3d12_desc.Triangles.VertexBuffer.StrideInBytes = geometry.vertex_stride;
 			d3d12_desc.Triangles.VertexCount = geometry.vertex_count;
@@ -64,7 +65,15 @@ namespace adria
 		std::vector<D3D12_RAYTRACING_GEOMETRY_DESC> geo_descs; geo_descs.reserve(geometries.size());
 		for (GfxRayTracingGeometry& geometry : geometries)
 		{
-			geo_descs.push_back(ConvertRayTracingGeometry(geometry));
+			//the build is recorded this frame so the transforms can live in the dynamic allocator
+			Uint64 transform_address = 0;
+			if (geometry.use_vertex_transform)
+			{
+				GfxDynamicAllocation transform_allocation = gfx->GetDynamicAllocator()->Allocate(sizeof(geometry.vertex_transform), D3D12_RAYTRACING_TRANSFORM3X4_BYTE_ALIGNMENT);
+				transform_allocation.Update(geometry.vertex_transform, sizeof(geometry.vertex_transform));
+				transform_address = transform_allocation.gpu_address;
+			}
+			geo_descs.push_back(ConvertRayTracingGeometry(geometry, transform_address));
 		}
 
 		D3D12_BUILD_RAYTRACING_ACCELERATION_STRUCTURE_INPUTS inputs{};
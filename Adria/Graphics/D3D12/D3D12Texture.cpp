@@ -2,6 +2,7 @@
 #include "D3D12Defines.h"
 #include "D3D12Device.h"
 #include "D3D12Conversions.h"
+#include "Graphics/GfxHeap.h"
 #include "Graphics/GfxBuffer.h"
 #include "Graphics/GfxCommandList.h"
 #include "Graphics/GfxLinearDynamicAllocator.h"
@@ -10,15 +11,49 @@
 
 namespace adria
 {
-
-	D3D12Texture::D3D12Texture(GfxDevice* gfx, GfxTextureDesc const& desc, GfxTextureData const& data) : GfxTexture(gfx, desc)
+	namespace
 	{
-		D3D12Device* d3d12gfx = (D3D12Device*)gfx;
+		DXGI_FORMAT GetClearValueFormat(GfxFormat format, Bool depth_stencil)
+		{
+			switch (format)
+			{
+			case GfxFormat::R16_TYPELESS:
+				return depth_stencil ? DXGI_FORMAT_D16_UNORM : DXGI_FORMAT_R16_UNORM;
+			case GfxFormat::R32_TYPELESS:
+				return depth_stencil ? DXGI_FORMAT_D32_FLOAT : DXGI_FORMAT_R32_FLOAT;
+			case GfxFormat::R24G8_TYPELESS:
+				return depth_stencil ? DXGI_FORMAT_D24_UNORM_S8_UINT : DXGI_FORMAT_R24_UNORM_X8_TYPELESS;
+			case GfxFormat::R32G8X24_TYPELESS:
+				return depth_stencil ? DXGI_FORMAT_D32_FLOAT_S8X24_UINT : DXGI_FORMAT_R32_FLOAT_X8X24_TYPELESS;
+			default:
+				return ToDXGIFormat(format);
+			}
+		}
 
-		HRESULT hr = E_FAIL;
-		D3D12MA::ALLOCATION_DESC allocation_desc{};
-		allocation_desc.HeapType = D3D12_HEAP_TYPE_DEFAULT;
+		Bool GetD3D12ClearValue(GfxTextureDesc const& desc, D3D12_CLEAR_VALUE& clear_value)
+		{
+			if (HasFlag(desc.bind_flags, GfxBindFlag::DepthStencil) && desc.clear_value.active_member == GfxClearValue::GfxActiveMember::DepthStencil)
+			{
+				clear_value.DepthStencil.Depth = desc.clear_value.depth_stencil.depth;
+				clear_value.DepthStencil.Stencil = desc.clear_value.depth_stencil.stencil;
+				clear_value.Format = GetClearValueFormat(desc.format, true);
+				return true;
+			}
+			else if (HasFlag(desc.bind_flags, GfxBindFlag::RenderTarget) && desc.clear_value.active_member == GfxClearValue::GfxActiveMember::Color)
+			{
+				clear_value.Color[0] = desc.clear_value.color.color[0];
+				clear_value.Color[1] = desc.clear_value.color.color[1];
+				clear_value.Color[2] = desc.clear_value.color.color[2];
+				clear_value.Color[3] = desc.clear_value.color.color[3];
+				clear_value.Format = GetClearValueFormat(desc.format, false);
+				return true;
+			}
+			return false;
+		}
+	}
 
+	D3D12_RESOURCE_DESC ToD3D12ResourceDesc(GfxTextureDesc const& desc)
+	{
 		D3D12_RESOURCE_DESC resource_desc{};
 		resource_desc.Format = ToDXGIFormat(desc.format);
 		resource_desc.Width = desc.width;
@@ -64,58 +99,20 @@ namespace adria
 			ADRIA_ASSERT_MSG(false, "Invalid Texture Type!");
 			break;
 		}
-		D3D12_CLEAR_VALUE* clear_value_ptr = nullptr;
+		return resource_desc;
+	}
+
+	D3D12Texture::D3D12Texture(GfxDevice* gfx, GfxTextureDesc const& desc, GfxTextureData const& data) : GfxTexture(gfx, desc)
+	{
+		D3D12Device* d3d12gfx = (D3D12Device*)gfx;
+
+		HRESULT hr = E_FAIL;
+		D3D12MA::ALLOCATION_DESC allocation_desc{};
+		allocation_desc.HeapType = D3D12_HEAP_TYPE_DEFAULT;
+
+		D3D12_RESOURCE_DESC resource_desc = ToD3D12ResourceDesc(desc);
 		D3D12_CLEAR_VALUE clear_value{};
-		if (HasFlag(desc.bind_flags, GfxBindFlag::DepthStencil) && desc.clear_value.active_member == GfxClearValue::GfxActiveMember::DepthStencil)
-		{
-			clear_value.DepthStencil.Depth = desc.clear_value.depth_stencil.depth;
-			clear_value.DepthStencil.Stencil = desc.clear_value.depth_stencil.stencil;
-			switch (desc.format)
-			{
-			case GfxFormat::R16_TYPELESS:
-				clear_value.Format = DXGI_FORMAT_D16_UNORM;
-				break;
-			case GfxFormat::R32_TYPELESS:
-				clear_value.Format = DXGI_FORMAT_D32_FLOAT;
-				break;
-			case GfxFormat::R24G8_TYPELESS:
-				clear_value.Format = DXGI_FORMAT_D24_UNORM_S8_UINT;
-				break;
-			case GfxFormat::R32G8X24_TYPELESS:
-				clear_value.Format = DXGI_FORMAT_D32_FLOAT_S8X24_UINT;
-				break;
-			default:
-				clear_value.Format = ToDXGIFormat(desc.format);
-				break;
-			}
-			clear_value_ptr = &clear_value;
-		}
-		else if (HasFlag(desc.bind_flags, GfxBindFlag::RenderTarget) && desc.clear_value.active_member == GfxClearValue::GfxActiveMember::Color)
-		{
-			clear_value.Color[0] = desc.clear_value.color.color[0];
-			clear_value.Color[1] = desc.clear_value.color.color[1];
-			clear_value.Color[2] = desc.clear_value.color.color[2];
-			clear_value.Color[3] = desc.clear_value.color.color[3];
-			switch (desc.format)
-			{
-			case GfxFormat::R16_TYPELESS:
-				clear_value.Format = DXGI_FORMAT_R16_UNORM;
-				break;
-			case GfxFormat::R32_TYPELESS:
-				clear_value.Format = DXGI_FORMAT_R32_FLOAT;
-				break;
-			case GfxFormat::R24G8_TYPELESS:
-				clear_value.Format = DXGI_FORMAT_R24_UNORM_X8_TYPELESS;
-				break;
-			case GfxFormat::R32G8X24_TYPELESS:
-				clear_value.Format = DXGI_FORMAT_R32_FLOAT_X8X24_TYPELESS;
-				break;
-			default:
-				clear_value.Format = ToDXGIFormat(desc.format);
-				break;
-			}
-			clear_value_ptr = &clear_value;
-		}
+		D3D12_CLEAR_VALUE* clear_value_ptr = GetD3D12ClearValue(desc, clear_value) ? &clear_value : nullptr;
 
 		GfxResourceState initial_state = desc.initial_state;
 		if (data.sub_data != nullptr)
@@ -237,6 +234,51 @@ namespace adria
 	{
 	}
 
+	D3D12Texture::D3D12Texture(GfxDevice* gfx, GfxTextureDesc const& desc, GfxHeap* heap, Uint64 heap_offset) : GfxTexture(gfx, desc)
+	{
+		ADRIA_ASSERT(heap != nullptr);
+		ADRIA_ASSERT_MSG(desc.heap_type == GfxResourceUsage::Default, "Only default heap textures can be placed!");
+		ADRIA_ASSERT_MSG(!HasFlag(desc.misc_flags, GfxTextureMiscFlag::Shared), "Shared textures cannot be placed!");
+		D3D12Device* d3d12gfx = (D3D12Device*)gfx;
+
+		D3D12_RESOURCE_DESC resource_desc = ToD3D12ResourceDesc(desc);
+		D3D12_CLEAR_VALUE clear_value{};
+		D3D12_CLEAR_VALUE* clear_value_ptr = GetD3D12ClearValue(desc, clear_value) ? &clear_value : nullptr;
+
+		D3D12MA::Allocator* allocator = d3d12gfx->GetD3D12Allocator();
+		D3D12MA::Allocation* heap_allocation = (D3D12MA::Allocation*)heap->GetHandle();
+		HRESULT hr = E_FAIL;
+		if (gfx->GetCapabilities().SupportsEnhancedBarriers())
+		{
+			D3D12_RESOURCE_DESC1 resource_desc1 = CD3DX12_RESOURCE_DESC1(resource_desc);
+			hr = allocator->CreateAliasingResource2(
+				heap_allocation,
+				heap_offset,
+				&resource_desc1,
+				ToD3D12BarrierLayout(desc.initial_state),
+				clear_value_ptr, 0, nullptr,
+				IID_PPV_ARGS(resource.GetAddressOf())
+			);
+		}
+		else
+		{
+			hr = allocator->CreateAliasingResource(
+				heap_allocation,
+				heap_offset,
+				&resource_desc,
+				ToD3D12LegacyResourceState(desc.initial_state),
+				clear_value_ptr,
+				IID_PPV_ARGS(resource.GetAddressOf())
+			);
+		}
+		D3D12_CHECK_CALL(hr);
+
+		if (desc.mip_levels == 0)
+		{
+			const_cast<GfxTextureDesc&>(desc).mip_levels = (Uint32)log2(std::max<Uint32>(desc.width, desc.height)) + 1;
+		}
+	}
+
 	D3D12Texture::D3D12Texture(GfxDevice* gfx, GfxTextureDesc const& desc, void* backbuffer) : GfxTexture(gfx, desc, backbuffer), resource((ID3D12Resource*)backbuffer)
 	{
 	}
@@ -4,12 +4,17 @@
 
 namespace adria
 {
+	class GfxHeap;
+
+	D3D12_RESOURCE_DESC ToD3D12ResourceDesc(GfxTextureDesc const& desc);
+
 	class D3D12Texture final : public GfxTexture
 	{
 	public:
 		D3D12Texture(GfxDevice* gfx, GfxTextureDesc const& desc, GfxTextureData const& data);
 		D3D12Texture(GfxDevice* gfx, GfxTextureDesc const& desc);
 		D3D12Texture(GfxDevice* gfx, GfxTextureDesc const& desc, void* backbuffer);
+		D3D12Texture(GfxDevice* gfx, GfxTextureDesc const& desc, GfxHeap* heap, Uint64 heap_offset);
 		~D3D12Texture();
 
 		virtual void* GetNative() const override;
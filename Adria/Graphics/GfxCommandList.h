@@ -30,6 +30,14 @@ namespace adria
 		Copy
 	};
 
+	//split barriers let a transition run while unrelated work executes, Begin and End have to be recorded on the same command list
+	enum class GfxBarrierSplit : Uint8
+	{
+		None,
+		Begin,
+		End
+	};
+
 	class GfxCommandList
 	{
 	public:
@@ -78,6 +86,8 @@ namespace adria
 		virtual void TextureBarrier(GfxTexture const& texture, GfxResourceState flags_before, GfxResourceState flags_after, Uint32 subresource = static_cast<Uint32>(-1)) = 0;
 		virtual void BufferBarrier(GfxBuffer const& buffer, GfxResourceState flags_before, GfxResourceState flags_after) = 0;
 		virtual void GlobalBarrier(GfxResourceState flags_before, GfxResourceState flags_after) = 0;
+		virtual void SplitTextureBarrier(GfxTexture const& texture, GfxResourceState flags_before, GfxResourceState flags_after, GfxBarrierSplit split) = 0;
+		virtual void SplitBufferBarrier(GfxBuffer const& buffer, GfxResourceState flags_before, GfxResourceState flags_after, GfxBarrierSplit split) = 0;
 		virtual void FlushBarriers() = 0;
 
 		virtual void CopyBuffer(GfxBuffer& dst, GfxBuffer const& src) = 0;
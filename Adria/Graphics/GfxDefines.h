@@ -19,6 +19,7 @@ namespace adria
 {
 	static constexpr Uint32 GFX_CONSTANT_BUFFER_DATA_ALIGNMENT = 256;
 	static constexpr Uint32 GFX_BACKBUFFER_COUNT = 3;
+	static constexpr Uint32 GFX_MAX_RENDER_TARGETS = 8;
 
 	struct GfxDrawArguments
 	{
@@ -5,6 +5,7 @@
 #elif defined(ADRIA_PLATFORM_MACOS)
 #include "Metal/MetalDevice.h"
 #endif
+#include "Null/NullDevice.h"
 
 namespace adria
 {
@@ -25,6 +26,10 @@ namespace adria
 
 	std::unique_ptr<GfxDevice> CreateGfxDevice(GfxBackend backend, Window* window)
 	{
+		if (backend == GfxBackend::Null)
+		{
+			return std::make_unique<NullDevice>(window);
+		}
 #if defined(ADRIA_PLATFORM_WINDOWS)
 		if (backend == GfxBackend::D3D12)
 		{
@@ -6,6 +6,7 @@
 #include "GfxDefines.h"
 #include "GfxShadingRate.h"
 #include "GfxRayTracingAS.h"
+#include "GfxHeap.h"
 #include "Utilities/Releasable.h"
 
 namespace adria
@@ -77,6 +78,7 @@ namespace adria
 		D3D12,
 		Metal,
 		Vulkan,
+		Null,
 		Unknown
 	};
 
@@ -139,6 +141,10 @@ namespace adria
 		virtual std::shared_ptr<GfxBuffer>  CreateBufferShared(GfxBufferDesc const& desc, GfxBufferData const& initial_data) = 0;
 		virtual std::shared_ptr<GfxBuffer>  CreateBufferShared(GfxBufferDesc const& desc) = 0;
 
+		virtual std::unique_ptr<GfxHeap>	CreateHeap(GfxHeapDesc const& desc) = 0;
+		virtual std::unique_ptr<GfxTexture> CreatePlacedTexture(GfxTextureDesc const& desc, GfxHeap* heap, Uint64 heap_offset) = 0;
+		virtual std::unique_ptr<GfxBuffer>  CreatePlacedBuffer(GfxBufferDesc const& desc, GfxHeap* heap, Uint64 heap_offset) = 0;
+
 		virtual std::unique_ptr<GfxPipelineState> CreateGraphicsPipelineState(GfxGraphicsPipelineStateDesc const& desc) = 0;
 		virtual std::unique_ptr<GfxPipelineState> CreateComputePipelineState(GfxComputePipelineStateDesc const& desc) = 0;
 		virtual std::unique_ptr<GfxPipelineState> CreateMeshShaderPipelineState(GfxMeshShaderPipelineStateDesc const& desc) = 0;
@@ -158,6 +164,8 @@ namespace adria
 
 		virtual Uint64 GetLinearBufferSize(GfxTexture const* texture) const = 0;
 		virtual Uint64 GetLinearBufferSize(GfxBuffer const* buffer) const = 0;
+		virtual GfxAllocationInfo GetAllocationInfo(GfxTextureDesc const& desc) const = 0;
+		virtual GfxAllocationInfo GetAllocationInfo(GfxBufferDesc const& desc) const = 0;
 
 		virtual GfxShadingRateInfo const& GetShadingRateInfo() const = 0;
 		virtual void SetShadingRateInfo(GfxShadingRateInfo const& info) = 0;
@@ -0,0 +1,45 @@
+#pragma once
+
+namespace adria
+{
+	class GfxDevice;
+
+	enum class GfxHeapUsage : Uint8
+	{
+		Buffers,
+		Textures,
+		RenderTargets,
+		Count
+	};
+
+	struct GfxHeapDesc
+	{
+		Uint64 size;
+		GfxHeapUsage usage;
+	};
+
+	struct GfxAllocationInfo
+	{
+		Uint64 size;
+		Uint64 alignment;
+	};
+
+	class GfxHeap
+	{
+	public:
+		virtual ~GfxHeap() {}
+
+		GfxDevice* GetParent() const { return gfx; }
+		GfxHeapDesc const& GetDesc() const { return desc; }
+
+		virtual void* GetHandle() const = 0;
+
+	protected:
+		GfxDevice* gfx;
+		GfxHeapDesc desc;
+
+	protected:
+		GfxHeap(GfxDevice* gfx, GfxHeapDesc const& desc) : gfx(gfx), desc(desc) {}
+	};
+
+}
@@ -14,7 +14,7 @@ namespace adria
 
 	GfxDynamicAllocation GfxLinearDynamicAllocator::Allocate(Uint64 size_in_bytes, Uint64 alignment)
 	{
-		alignment = std::max(alignment, 1ull);
+		alignment = std::max<Uint64>(alignment, 1);
 
 		GfxAllocationPage* last_page = &alloc_pages[current_page]; // Use pointer to allow changing page
 		Uint64 current_page_offset = last_page->linear_offset_allocator.Top(); 
@@ -111,6 +111,12 @@ namespace adria
 			f(current_pso_desc);
 		}
 
+		//incremented whenever cached psos are destroyed, pso pointers kept by the caller are stale once it changes
+		Uint64 GetGeneration() const
+		{
+			return generation;
+		}
+
 		GfxPipelineState const* Get() const
 		{
 			Uint64 const pso_hash = PSODescHasher{}(current_pso_desc);
@@ -150,6 +156,7 @@ namespace adria
 
 		mutable PSOPermutationMap pso_permutations;
 		mutable ShaderDependencyMap shader_dependencies;
+		Uint64 generation = 0;
 		DelegateHandle event_handle;
 
 	private:
@@ -163,6 +170,7 @@ namespace adria
 					pso_permutations.erase(pso_hash);
 				}
 				shader_dependencies.erase(it);
+				++generation;
 			}
 		}
 		void RegisterDependencies(PSODesc const& desc, Uint64 pso_hash) const
@@ -43,6 +43,10 @@ namespace adria
 		Uint32 index_count = 0;
 		GfxFormat index_format = GfxFormat::UNKNOWN;
 
+		//row major 3x4 matrix applied to the vertices during the build, used to expand quantized positions
+		Float vertex_transform[3][4] = {};
+		Bool use_vertex_transform = false;
+
 		Bool opaque = true;
 	};
 
@@ -1,6 +1,7 @@
 #pragma once
 #include "GfxDescriptor.h"
 #include "GfxResource.h"
+#include "GfxDefines.h"
 
 namespace adria
 {
@@ -52,7 +53,8 @@ namespace adria
 
     struct GfxRenderPassDesc
     {
-        std::vector<GfxColorAttachmentDesc> rtv_attachments{};
+        //not owned, at most GFX_MAX_RENDER_TARGETS attachments
+        std::span<GfxColorAttachmentDesc const> rtv_attachments{};
         std::optional<GfxDepthAttachmentDesc> dsv_attachment = std::nullopt;
         GfxRenderPassFlags flags = GfxRenderPassFlagBit_None;
         Uint32 width = 0;
@@ -86,6 +86,8 @@ namespace adria
 		Bool operator==(GfxClearValue const& other) const
 		{
 			if (active_member != other.active_member) return false;
+			//the union holds whichever member was constructed last, without a clear value it is not part of the value
+			else if (active_member == GfxActiveMember::None) return true;
 			else if (active_member == GfxActiveMember::Color)
 			{
 				return color == other.color;
@@ -192,8 +194,26 @@ namespace adria
 
 	inline constexpr std::string ConvertBarrierFlagsToString(GfxResourceState flags)
 	{
-		ADRIA_TODO("Finish this");
 		std::string resource_state_string = "";
+		if (HasAnyFlag(flags, GfxResourceState::Present)) resource_state_string += "Present|";
+		if (HasAnyFlag(flags, GfxResourceState::RTV)) resource_state_string += "RTV|";
+		if (HasAnyFlag(flags, GfxResourceState::DSV)) resource_state_string += "DSV|";
+		if (HasAnyFlag(flags, GfxResourceState::DSV_ReadOnly)) resource_state_string += "DSV_ReadOnly|";
+		if (HasAnyFlag(flags, GfxResourceState::VertexSRV)) resource_state_string += "VertexSRV|";
+		if (HasAnyFlag(flags, GfxResourceState::PixelSRV)) resource_state_string += "PixelSRV|";
+		if (HasAnyFlag(flags, GfxResourceState::ComputeSRV)) resource_state_string += "ComputeSRV|";
+		if (HasAnyFlag(flags, GfxResourceState::VertexUAV)) resource_state_string += "VertexUAV|";
+		if (HasAnyFlag(flags, GfxResourceState::PixelUAV)) resource_state_string += "PixelUAV|";
+		if (HasAnyFlag(flags, GfxResourceState::ComputeUAV)) resource_state_string += "ComputeUAV|";
+		if (HasAnyFlag(flags, GfxResourceState::ClearUAV)) resource_state_string += "ClearUAV|";
+		if (HasAnyFlag(flags, GfxResourceState::CopyDst)) resource_state_string += "CopyDst|";
+		if (HasAnyFlag(flags, GfxResourceState::CopySrc)) resource_state_string += "CopySrc|";
+		if (HasAnyFlag(flags, GfxResourceState::ShadingRate)) resource_state_string += "ShadingRate|";
+		if (HasAnyFlag(flags, GfxResourceState::IndexBuffer)) resource_state_string += "IndexBuffer|";
+		if (HasAnyFlag(flags, GfxResourceState::IndirectArgs)) resource_state_string += "IndirectArgs|";
+		if (HasAnyFlag(flags, GfxResourceState::ASRead)) resource_state_string += "ASRead|";
+		if (HasAnyFlag(flags, GfxResourceState::ASWrite)) resource_state_string += "ASWrite|";
+		if (HasAnyFlag(flags, GfxResourceState::Discard)) resource_state_string += "Discard|";
 		if (!resource_state_string.empty())
 		{
 			resource_state_string.pop_back();
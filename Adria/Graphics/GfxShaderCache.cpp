@@ -0,0 +1,472 @@
+#include "GfxShaderCache.h"
+#include "Utilities/Hash.h"
+#include "Utilities/Align.h"
+
+namespace fs = std::filesystem;
+
+namespace adria
+{
+	ADRIA_LOG_CHANNEL(ShaderCompiler);
+
+	static constexpr Uint64 ShaderCacheMagic = 0x4b434148534e4441; //"ADNSHACK"
+	static constexpr Uint64 ShaderCacheVersion = 1;
+	static constexpr Uint64 ShaderCacheAlignment = 16;
+	//hash of a dependency set with a missing file, never matches a stored one
+	static constexpr Uint64 MissingDependencyHash = 0;
+
+	struct GfxShaderCache::PackHeader
+	{
+		Uint64 magic;
+		Uint64 version;
+		Uint64 entry_count;
+		Uint64 dependency_count;
+		Uint64 dependency_index_count;
+		Uint64 strings_size;
+		Uint64 data_size;
+	};
+	struct GfxShaderCache::PackEntry
+	{
+		Uint64 key;
+		Uint64 dependency_hash;
+		Uint64 shader_hash[2];
+		Uint64 binary_offset;
+		Uint64 binary_size;
+		Uint64 reflection_offset;
+		Uint64 reflection_size;
+		Uint32 first_dependency;
+		Uint32 dependency_count;
+	};
+	struct GfxShaderCache::PackDependency
+	{
+		Uint32 string_offset;
+		Uint32 string_length;
+	};
+
+	namespace
+	{
+		template<typename HeaderT, typename EntryT, typename DependencyT>
+		Uint64 GetShaderCacheVersion()
+		{
+			HashState state;
+			state.Combine(ShaderCacheVersion);
+			state.Combine(sizeof(HeaderT));
+			state.Combine(sizeof(EntryT));
+			state.Combine(sizeof(DependencyT));
+			return state;
+		}
+
+		//pack sections in file order, the data section holds the binaries and reflection blobs
+		struct PackLayout
+		{
+			Uint64 entries_offset;
+			Uint64 dependencies_offset;
+			Uint64 dependency_indices_offset;
+			Uint64 strings_offset;
+			Uint64 data_offset;
+			Uint64 size;
+		};
+		template<typename HeaderT, typename EntryT, typename DependencyT>
+		PackLayout GetPackLayout(HeaderT const& header)
+		{
+			PackLayout layout{};
+			layout.entries_offset = AlignUp(sizeof(HeaderT), ShaderCacheAlignment);
+			layout.dependencies_offset = layout.entries_offset + header.entry_count * sizeof(EntryT);
+			layout.dependency_indices_offset = layout.dependencies_offset + header.dependency_count * sizeof(DependencyT);
+			layout.strings_offset = layout.dependency_indices_offset + header.dependency_index_count * sizeof(Uint32);
+			layout.data_offset = AlignUp(layout.strings_offset + header.strings_size, ShaderCacheAlignment);
+			layout.size = layout.data_offset + header.data_size;
+			return layout;
+		}
+	}
+
+	Bool GfxShaderCache::Open(std::string const& _pack_path)
+	{
+		std::lock_guard lock(mutex);
+		pack_path = _pack_path;
+		return Map();
+	}
+
+	Bool GfxShaderCache::Save()
+	{
+		std::lock_guard lock(mutex);
+
+		struct SaveEntry
+		{
+			Uint64 key;
+			Uint64 dependency_hash;
+			Uint64 const* shader_hash;
+			std::span<Uint8 const> binary;
+			std::span<Uint8 const> reflection;
+			std::vector<std::string_view> dependencies;
+		};
+		std::vector<SaveEntry> save_entries;
+		save_entries.reserve(pending_entries.size() + packed_entry_count);
+
+		Bool dirty = !pending_entries.empty();
+		for (auto const& [key, entry] : pending_entries)
+		{
+			SaveEntry& save_entry = save_entries.emplace_back(key, entry.dependency_hash, entry.shader_hash, entry.binary, entry.reflection);
+			save_entry.dependencies.assign(entry.dependencies.begin(), entry.dependencies.end());
+		}
+		for (Uint64 i = 0; i < packed_entry_count; ++i)
+		{
+			PackEntry const& entry = packed_entries[i];
+			if (pending_entries.contains(entry.key))
+			{
+				continue;
+			}
+			Uint64 const dependency_hash = HashPackedDependencies(entry);
+			if (dependency_hash == MissingDependencyHash || dependency_hash != entry.dependency_hash)
+			{
+				dirty = true;
+				continue;
+			}
+			SaveEntry& save_entry = save_entries.emplace_back(entry.key, entry.dependency_hash, entry.shader_hash,
+				std::span<Uint8 const>(packed_data + entry.binary_offset, entry.binary_size), std::span<Uint8 const>(packed_data + entry.reflection_offset, entry.reflection_size));
+			for (Uint32 j = 0; j < entry.dependency_count; ++j)
+			{
+				save_entry.dependencies.push_back(GetPackedDependency(packed_dependency_indices[entry.first_dependency + j]));
+			}
+		}
+		if (!dirty)
+		{
+			return true;
+		}
+		std::sort(save_entries.begin(), save_entries.end(), [](SaveEntry const& lhs, SaveEntry const& rhs) { return lhs.key < rhs.key; });
+
+		std::vector<PackEntry> entries(save_entries.size());
+		std::vector<PackDependency> dependencies;
+		std::vector<Uint32> dependency_indices;
+		std::vector<Char> strings;
+		std::unordered_map<std::string_view, Uint32> dependency_map;
+		Uint64 data_size = 0;
+		for (Uint64 i = 0; i < save_entries.size(); ++i)
+		{
+			SaveEntry const& save_entry = save_entries[i];
+			PackEntry& entry = entries[i];
+			entry.key = save_entry.key;
+			entry.dependency_hash = save_entry.dependency_hash;
+			entry.shader_hash[0] = save_entry.shader_hash[0];
+			entry.shader_hash[1] = save_entry.shader_hash[1];
+			entry.binary_offset = data_size;
+			entry.binary_size = save_entry.binary.size();
+			data_size = AlignUp(data_size + entry.binary_size, ShaderCacheAlignment);
+			entry.reflection_offset = data_size;
+			entry.reflection_size = save_entry.reflection.size();
+			data_size = AlignUp(data_size + entry.reflection_size, ShaderCacheAlignment);
+
+			entry.first_dependency = (Uint32)dependency_indices.size();
+			entry.dependency_count = (Uint32)save_entry.dependencies.size();
+			for (std::string_view dependency : save_entry.dependencies)
+			{
+				auto [it, inserted] = dependency_map.emplace(dependency, (Uint32)dependencies.size());
+				if (inserted)
+				{
+					dependencies.emplace_back((Uint32)strings.size(), (Uint32)dependency.size());
+					strings.insert(strings.end(), dependency.begin(), dependency.end());
+				}
+				dependency_indices.push_back(it->second);
+			}
+		}
+
+		PackHeader header{};
+		header.magic = ShaderCacheMagic;
+		header.version = GetShaderCacheVersion<PackHeader, PackEntry, PackDependency>();
+		header.entry_count = entries.size();
+		header.dependency_count = dependencies.size();
+		header.dependency_index_count = dependency_indices.size();
+		header.strings_size = strings.size();
+		header.data_size = data_size;
+		PackLayout const layout = GetPackLayout<PackHeader, PackEntry, PackDependency>(header);
+
+		std::error_code ec;
+		fs::create_directories(fs::path(pack_path).parent_path(), ec);
+
+		//write to a temporary file first so a crash never leaves a truncated pack behind
+		std::string const temporary_path = pack_path + ".tmp";
+		FILE* pack_file = fopen(temporary_path.c_str(), "wb");
+		if (!pack_file)
+		{
+			ADRIA_LOG(WARNING, "Failed to create shader cache file '%s'", temporary_path.c_str());
+			return false;
+		}
+
+		Uint64 written_size = 0;
+		Bool written = true;
+		auto Write = [&](void const* data, Uint64 size)
+			{
+				if (size > 0)
+				{
+					written = written && fwrite(data, 1, size, pack_file) == size;
+				}
+				written_size += size;
+			};
+		auto Pad = [&](Uint64 offset)
+			{
+				static constexpr Uint8 Zeros[ShaderCacheAlignment] = {};
+				ADRIA_ASSERT(offset >= written_size && offset - written_size <= ShaderCacheAlignment);
+				Write(Zeros, offset - written_size);
+			};
+		Write(&header, sizeof(header));
+		Pad(layout.entries_offset);
+		Write(entries.data(), entries.size() * sizeof(PackEntry));
+		Write(dependencies.data(), dependencies.size() * sizeof(PackDependency));
+		Write(dependency_indices.data(), dependency_indices.size() * sizeof(Uint32));
+		Write(strings.data(), strings.size());
+		Pad(layout.data_offset);
+		for (Uint64 i = 0; i < save_entries.size(); ++i)
+		{
+			Write(save_entries[i].binary.data(), save_entries[i].binary.size());
+			Pad(layout.data_offset + entries[i].reflection_offset);
+			Write(save_entries[i].reflection.data(), save_entries[i].reflection.size());
+			Pad(AlignUp(written_size, ShaderCacheAlignment));
+		}
+		fclose(pack_file);
+		if (!written || written_size != layout.size)
+		{
+			fs::remove(temporary_path, ec);
+			return false;
+		}
+
+		//the saved entries reference the mapped pack until here
+		save_entries.clear();
+		dependency_map.clear();
+		Unmap();
+		fs::rename(temporary_path, pack_path, ec);
+		pending_entries.clear();
+		return Map() && !ec;
+	}
+
+	Bool GfxShaderCache::Lookup(Uint64 key, GfxShaderCacheRecord& record)
+	{
+		std::lock_guard lock(mutex);
+		if (auto it = pending_entries.find(key); it != pending_entries.end())
+		{
+			PendingEntry const& entry = it->second;
+			Uint64 const dependency_hash = HashDependencies(entry.dependencies);
+			if (dependency_hash == MissingDependencyHash || dependency_hash != entry.dependency_hash)
+			{
+				return false;
+			}
+			record.binary = entry.binary;
+			record.reflection = entry.reflection;
+			record.shader_hash[0] = entry.shader_hash[0];
+			record.shader_hash[1] = entry.shader_hash[1];
+			record.dependencies = entry.dependencies;
+			return true;
+		}
+
+		PackEntry const* entry = FindPackedEntry(key);
+		if (!entry)
+		{
+			return false;
+		}
+		Uint64 const dependency_hash = HashPackedDependencies(*entry);
+		if (dependency_hash == MissingDependencyHash || dependency_hash != entry->dependency_hash)
+		{
+			return false;
+		}
+		record.binary = std::span<Uint8 const>(packed_data + entry->binary_offset, entry->binary_size);
+		record.reflection = std::span<Uint8 const>(packed_data + entry->reflection_offset, entry->reflection_size);
+		record.shader_hash[0] = entry->shader_hash[0];
+		record.shader_hash[1] = entry->shader_hash[1];
+		record.dependencies.clear();
+		record.dependencies.reserve(entry->dependency_count);
+		for (Uint32 i = 0; i < entry->dependency_count; ++i)
+		{
+			record.dependencies.emplace_back(GetPackedDependency(packed_dependency_indices[entry->first_dependency + i]));
+		}
+		return true;
+	}
+
+	void GfxShaderCache::Store(Uint64 key, std::span<std::string const> dependencies, Uint64 const shader_hash[2], std::span<Uint8 const> binary, std::span<Uint8 const> reflection)
+	{
+		std::lock_guard lock(mutex);
+		PendingEntry& entry = pending_entries[key];
+		entry.dependencies.assign(dependencies.begin(), dependencies.end());
+		entry.dependency_hash = HashDependencies(dependencies);
+		entry.shader_hash[0] = shader_hash[0];
+		entry.shader_hash[1] = shader_hash[1];
+		entry.binary.assign(binary.begin(), binary.end());
+		entry.reflection.assign(reflection.begin(), reflection.end());
+	}
+
+	void GfxShaderCache::RefreshDependencies()
+	{
+		std::lock_guard lock(mutex);
+		file_hashes.clear();
+		std::fill(packed_dependency_hashes.begin(), packed_dependency_hashes.end(), MissingDependencyHash);
+	}
+
+	Uint64 GfxShaderCache::GetPackedEntryCount() const
+	{
+		return packed_entry_count;
+	}
+
+	Bool GfxShaderCache::Map()
+	{
+		Unmap();
+		if (!file.Open(pack_path.c_str()))
+		{
+			return false;
+		}
+
+		Uint8 const* data = file.GetData();
+		Uint64 const size = file.GetSize();
+		if (size < sizeof(PackHeader))
+		{
+			Unmap();
+			return false;
+		}
+		PackHeader const& header = *reinterpret_cast<PackHeader const*>(data);
+		if (header.magic != ShaderCacheMagic || header.version != GetShaderCacheVersion<PackHeader, PackEntry, PackDependency>() ||
+			header.entry_count > size || header.dependency_count > size || header.dependency_index_count > size || header.strings_size > size || header.data_size > size)
+		{
+			Unmap();
+			return false;
+		}
+		PackLayout const layout = GetPackLayout<PackHeader, PackEntry, PackDependency>(header);
+		if (layout.size != size)
+		{
+			Unmap();
+			return false;
+		}
+
+		PackEntry const* entries = reinterpret_cast<PackEntry const*>(data + layout.entries_offset);
+		PackDependency const* dependencies = reinterpret_cast<PackDependency const*>(data + layout.dependencies_offset);
+		Uint32 const* dependency_indices = reinterpret_cast<Uint32 const*>(data + layout.dependency_indices_offset);
+		for (Uint64 i = 0; i < header.entry_count; ++i)
+		{
+			PackEntry const& entry = entries[i];
+			Bool const valid = (i == 0 || entries[i - 1].key < entry.key) &&
+				entry.binary_offset <= header.data_size && entry.binary_size <= header.data_size - entry.binary_offset &&
+				entry.reflection_offset <= header.data_size && entry.reflection_size <= header.data_size - entry.reflection_offset &&
+				entry.first_dependency <= header.dependency_index_count && entry.dependency_count <= header.dependency_index_count - entry.first_dependency;
+			if (!valid)
+			{
+				Unmap();
+				return false;
+			}
+		}
+		for (Uint64 i = 0; i < header.dependency_index_count; ++i)
+		{
+			if (dependency_indices[i] >= header.dependency_count)
+			{
+				Unmap();
+				return false;
+			}
+		}
+		for (Uint64 i = 0; i < header.dependency_count; ++i)
+		{
+			if ((Uint64)dependencies[i].string_offset + dependencies[i].string_length > header.strings_size)
+			{
+				Unmap();
+				return false;
+			}
+		}
+
+		packed_entries = entries;
+		packed_dependencies = dependencies;
+		packed_dependency_indices = dependency_indices;
+		packed_strings = reinterpret_cast<Char const*>(data + layout.strings_offset);
+		packed_data = data + layout.data_offset;
+		packed_entry_count = header.entry_count;
+		packed_dependency_hashes.assign(header.dependency_count, MissingDependencyHash);
+		return true;
+	}
+
+	void GfxShaderCache::Unmap()
+	{
+		file.Close();
+		packed_entries = nullptr;
+		packed_dependencies = nullptr;
+		packed_dependency_indices = nullptr;
+		packed_strings = nullptr;
+		packed_data = nullptr;
+		packed_entry_count = 0;
+		packed_dependency_hashes.clear();
+	}
+
+	GfxShaderCache::PackEntry const* GfxShaderCache::FindPackedEntry(Uint64 key) const
+	{
+		PackEntry const* end = packed_entries + packed_entry_count;
+		PackEntry const* it = std::lower_bound(packed_entries, end, key, [](PackEntry const& entry, Uint64 key) { return entry.key < key; });
+		return it != end && it->key == key ? it : nullptr;
+	}
+
+	std::string_view GfxShaderCache::GetPackedDependency(Uint32 dependency_index) const
+	{
+		PackDependency const& dependency = packed_dependencies[dependency_index];
+		return std::string_view(packed_strings + dependency.string_offset, dependency.string_length);
+	}
+
+	Uint64 GfxShaderCache::GetFileHash(std::string const& path)
+	{
+		if (auto it = file_hashes.find(path); it != file_hashes.end())
+		{
+			return it->second;
+		}
+
+		Uint64 file_hash = MissingDependencyHash;
+		if (FILE* dependency_file = fopen(path.c_str(), "rb"))
+		{
+			std::vector<Char> contents;
+			Char buffer[4096];
+			Uint64 read_size = 0;
+			while ((read_size = fread(buffer, 1, sizeof(buffer), dependency_file)) > 0)
+			{
+				contents.insert(contents.end(), buffer, buffer + read_size);
+			}
+			fclose(dependency_file);
+			file_hash = crc64(contents.data(), contents.size());
+			if (file_hash == MissingDependencyHash)
+			{
+				file_hash = ~MissingDependencyHash;
+			}
+		}
+		file_hashes.emplace(path, file_hash);
+		return file_hash;
+	}
+
+	Uint64 GfxShaderCache::GetPackedDependencyHash(Uint32 dependency_index)
+	{
+		Uint64& dependency_hash = packed_dependency_hashes[dependency_index];
+		if (dependency_hash == MissingDependencyHash)
+		{
+			dependency_hash = GetFileHash(std::string(GetPackedDependency(dependency_index)));
+		}
+		return dependency_hash;
+	}
+
+	Uint64 GfxShaderCache::HashDependencies(std::span<std::string const> dependencies)
+	{
+		HashState state;
+		state.Combine(dependencies.size());
+		for (std::string const& dependency : dependencies)
+		{
+			Uint64 const file_hash = GetFileHash(dependency);
+			if (file_hash == MissingDependencyHash)
+			{
+				return MissingDependencyHash;
+			}
+			state.Combine(file_hash);
+		}
+		return state;
+	}
+
+	Uint64 GfxShaderCache::HashPackedDependencies(PackEntry const& entry)
+	{
+		HashState state;
+		state.Combine((Usize)entry.dependency_count);
+		for (Uint32 i = 0; i < entry.dependency_count; ++i)
+		{
+			Uint64 const file_hash = GetPackedDependencyHash(packed_dependency_indices[entry.first_dependency + i]);
+			if (file_hash == MissingDependencyHash)
+			{
+				return MissingDependencyHash;
+			}
+			state.Combine(file_hash);
+		}
+		return state;
+	}
+}
@@ -0,0 +1,75 @@
+#pragma once
+#include "Utilities/MemoryMappedFile.h"
+
+namespace adria
+{
+	//spans point into the pack or into a stored entry, they stay valid until the next Store or Save
+	struct GfxShaderCacheRecord
+	{
+		std::span<Uint8 const> binary;
+		std::span<Uint8 const> reflection;
+		Uint64 shader_hash[2];
+		std::vector<std::string> dependencies;
+	};
+
+	//every compiled permutation lives in one memory mapped pack, entries are sorted by key and binary searched.
+	//An entry is valid while the combined content hash of the files it was compiled from matches the one it was stored with.
+	//Files are hashed once on first use and the hashes are reused until RefreshDependencies. Safe to use from worker threads
+	class GfxShaderCache
+	{
+		struct PendingEntry
+		{
+			std::vector<std::string> dependencies;
+			Uint64 dependency_hash;
+			Uint64 shader_hash[2];
+			std::vector<Uint8> binary;
+			std::vector<Uint8> reflection;
+		};
+		struct PackHeader;
+		struct PackEntry;
+		struct PackDependency;
+
+	public:
+		GfxShaderCache() = default;
+		ADRIA_NONCOPYABLE_NONMOVABLE(GfxShaderCache)
+		~GfxShaderCache() = default;
+
+		//a missing or outdated pack leaves the cache empty
+		Bool Open(std::string const& pack_path);
+		//writes stored entries and the still valid packed ones to a new pack and maps it
+		Bool Save();
+
+		Bool Lookup(Uint64 key, GfxShaderCacheRecord& record);
+		void Store(Uint64 key, std::span<std::string const> dependencies, Uint64 const shader_hash[2], std::span<Uint8 const> binary, std::span<Uint8 const> reflection);
+		//dependency files are hashed again on their next use, called when shader sources change on disk
+		void RefreshDependencies();
+
+		Uint64 GetPackedEntryCount() const;
+
+	private:
+		std::string pack_path;
+		MemoryMappedFile file;
+		PackEntry const* packed_entries = nullptr;
+		PackDependency const* packed_dependencies = nullptr;
+		Uint32 const* packed_dependency_indices = nullptr;
+		Char const* packed_strings = nullptr;
+		Uint8 const* packed_data = nullptr;
+		Uint64 packed_entry_count = 0;
+
+		std::mutex mutex;
+		std::unordered_map<Uint64, PendingEntry> pending_entries;
+		std::unordered_map<std::string, Uint64> file_hashes;
+		std::vector<Uint64> packed_dependency_hashes;
+
+	private:
+		Bool Map();
+		void Unmap();
+		PackEntry const* FindPackedEntry(Uint64 key) const;
+		std::string_view GetPackedDependency(Uint32 dependency_index) const;
+
+		Uint64 GetFileHash(std::string const& path);
+		Uint64 GetPackedDependencyHash(Uint32 dependency_index);
+		Uint64 HashDependencies(std::span<std::string const> dependencies);
+		Uint64 HashPackedDependencies(PackEntry const& entry);
+	};
+}
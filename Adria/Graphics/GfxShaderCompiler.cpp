@@ -4,6 +4,7 @@
 #include "Metal/MetalShaderReflection.h"
 #endif
 #include "GfxShaderCompiler.h"
+#include "GfxShaderCache.h"
 #include "GfxDevice.h"
 #include "GfxDefines.h"
 #include "Core/Paths.h"
@@ -13,9 +14,6 @@
 #include "Utilities/Hash.h"
 #include "Utilities/Ref.h"
 #include "Utilities/DynamicLibrary.h"
-#include "cereal/archives/binary.hpp"
-#include "cereal/types/string.hpp"
-#include "cereal/types/vector.hpp"
 
 namespace adria
 {
@@ -26,23 +24,83 @@ namespace adria
 
 	namespace
 	{
-		Ref<IDxcLibrary> library = nullptr;
-		Ref<IDxcCompiler3> compiler = nullptr;
-		Ref<IDxcUtils> utils = nullptr;
-		Ref<IDxcIncludeHandler> include_handler = nullptr;
+		//dxc objects are not thread safe, every thread compiling at the same time gets its own set
+		struct GfxShaderCompilerContext
+		{
+			Ref<IDxcLibrary> library = nullptr;
+			Ref<IDxcCompiler3> compiler = nullptr;
+			Ref<IDxcUtils> utils = nullptr;
+			Ref<IDxcIncludeHandler> include_handler = nullptr;
+#if defined(ADRIA_PLATFORM_MACOS)
+			IRCompiler* metal_ir_compiler = nullptr;
+#endif
+		};
+
+		std::mutex context_mutex;
+		std::vector<std::unique_ptr<GfxShaderCompilerContext>> contexts;
+		std::vector<GfxShaderCompilerContext*> free_contexts;
+		GfxShaderCache shader_cache;
 		DynamicLibrary dxcompiler;
 		GfxBackend current_backend = GfxBackend::Unknown;
 
 #if defined(ADRIA_PLATFORM_MACOS)
-		IRCompiler* metal_ir_compiler = nullptr;
 		IRRootSignature* metal_root_signature = nullptr;
 #endif
+
+		GfxShaderCompilerContext* CreateContext()
+		{
+			std::unique_ptr<GfxShaderCompilerContext> context = std::make_unique<GfxShaderCompilerContext>();
+			HRESULT hr = S_OK;
+			hr = PFN_DxcCreateInstance(CLSID_DxcLibrary, IID_PPV_ARGS(context->library.GetAddressOf()));
+			ADRIA_ASSERT(SUCCEEDED(hr));
+			hr = PFN_DxcCreateInstance(CLSID_DxcCompiler, IID_PPV_ARGS(context->compiler.GetAddressOf()));
+			ADRIA_ASSERT(SUCCEEDED(hr));
+			hr = context->library->CreateIncludeHandler(context->include_handler.GetAddressOf());
+			ADRIA_ASSERT(SUCCEEDED(hr));
+			hr = PFN_DxcCreateInstance(CLSID_DxcUtils, IID_PPV_ARGS(context->utils.GetAddressOf()));
+			ADRIA_ASSERT(SUCCEEDED(hr));
+#if defined(ADRIA_PLATFORM_MACOS)
+			context->metal_ir_compiler = IRCompilerCreate();
+#endif
+			contexts.push_back(std::move(context));
+			return contexts.back().get();
+		}
+
+		class GfxShaderCompilerContextScope
+		{
+		public:
+			GfxShaderCompilerContextScope()
+			{
+				std::lock_guard lock(context_mutex);
+				if (free_contexts.empty())
+				{
+					context = CreateContext();
+				}
+				else
+				{
+					context = free_contexts.back();
+					free_contexts.pop_back();
+				}
+			}
+			ADRIA_NONCOPYABLE_NONMOVABLE(GfxShaderCompilerContextScope)
+			~GfxShaderCompilerContextScope()
+			{
+				std::lock_guard lock(context_mutex);
+				free_contexts.push_back(context);
+			}
+
+			GfxShaderCompilerContext* operator->() const { return context; }
+			GfxShaderCompilerContext& operator*() const { return *context; }
+
+		private:
+			GfxShaderCompilerContext* context = nullptr;
+		};
 	}
 
 	class GfxIncludeHandler : public IDxcIncludeHandler
 	{
 	public:
-		GfxIncludeHandler() {}
+		explicit GfxIncludeHandler(GfxShaderCompilerContext& context) : context(context) {}
 
 		HRESULT STDMETHODCALLTYPE LoadSource(_In_ LPCWSTR pFilename, _COM_Outptr_result_maybenull_ IDxcBlob** ppIncludeSource) override
 		{
@@ -67,13 +125,13 @@ namespace adria
 			if (already_included)
 			{
 				static const Char nullStr[] = " ";
-				utils->CreateBlob(nullStr, ARRAYSIZE(nullStr), CP_UTF8, encoding.GetAddressOf());
+				context.utils->CreateBlob(nullStr, ARRAYSIZE(nullStr), CP_UTF8, encoding.GetAddressOf());
 				*ppIncludeSource = encoding.Detach();
 				return S_OK;
 			}
 
 			std::wstring winclude_file = ToWideString(include_file);
-			HRESULT hr = utils->LoadFile(winclude_file.c_str(), nullptr, encoding.GetAddressOf());
+			HRESULT hr = context.utils->LoadFile(winclude_file.c_str(), nullptr, encoding.GetAddressOf());
 			if (SUCCEEDED(hr))
 			{
 				include_files.push_back(include_file);
@@ -85,13 +143,16 @@ namespace adria
 		}
 		HRESULT STDMETHODCALLTYPE QueryInterface(REFIID riid, _COM_Outptr_ void __RPC_FAR* __RPC_FAR* ppvObject) override
 		{
-			return include_handler->QueryInterface(riid, ppvObject);
+			return context.include_handler->QueryInterface(riid, ppvObject);
 		}
 
 		ULONG STDMETHODCALLTYPE AddRef(void) override { return 1; }
 		ULONG STDMETHODCALLTYPE Release(void) override { return 1; }
 
 		std::vector<std::string> include_files;
+
+	private:
+		GfxShaderCompilerContext& context;
 	};
 
 	class GfxShaderCompilerBlob : public IDxcBlob
@@ -207,87 +268,42 @@ namespace adria
 
 	namespace GfxShaderCompiler
 	{
-		static Bool CheckCache(Char const* cache_path, GfxShaderCompileInput const& input, GfxShaderCompileOutput& output)
+		static Uint64 GetCacheKey(GfxShaderCompileInput const& input)
 		{
-			std::string cache_binary(cache_path); cache_binary += ".bin";
-			std::string cache_metadata(cache_path); cache_metadata += ".meta";
-
-			if (!FileExists(cache_binary) || !FileExists(cache_metadata))
+			HashState state;
+			state.Combine(crc64(input.file.c_str(), input.file.size()));
+			state.Combine(crc64(input.entry_point.c_str(), input.entry_point.size()));
+			state.Combine((Uint64)input.stage);
+			state.Combine((Uint64)input.model);
+			state.Combine((Uint64)input.flags);
+			state.Combine((Uint64)current_backend);
+			for (GfxShaderDefine const& define : input.defines)
 			{
-				return false;
+				state.Combine(crc64(define.name.c_str(), define.name.size()));
+				state.Combine(crc64(define.value.c_str(), define.value.size()));
 			}
-			if (GetFileLastWriteTime(cache_binary) < GetFileLastWriteTime(input.file))
+			return state;
+		}
+		static Bool CheckCache(Uint64 cache_key, GfxShaderCompileInput const& input, GfxShaderCompileOutput& output)
+		{
+			GfxShaderCacheRecord record{};
+			if (!shader_cache.Lookup(cache_key, record))
 			{
 				return false;
 			}
-
-			std::ifstream is(cache_metadata, std::ios::binary);
-			cereal::BinaryInputArchive metadata_archive(is);
-
-			metadata_archive(output.shader_hash);
-			metadata_archive(output.includes);
-			Uint64 binary_size = 0;
-			metadata_archive(binary_size);
-
-#if defined(ADRIA_PLATFORM_MACOS)
-			Uint64 reflection_size = 0;
-			metadata_archive(reflection_size);
-#endif
-
-			for (std::string const& include : output.includes)
-			{
-				if (GetFileLastWriteTime(cache_binary) < GetFileLastWriteTime(include))
-				{
-					return false;
-				}
-			}
-
-			std::ifstream is2(cache_binary, std::ios::binary);
-			cereal::BinaryInputArchive binary_archive(is2);
-
-			std::unique_ptr<Char[]> binary_data(new Char[binary_size]);
-			binary_archive.loadBinary(binary_data.get(), binary_size);
-			output.shader.SetShaderData(binary_data.get(), binary_size);
+			output.shader_hash[0] = record.shader_hash[0];
+			output.shader_hash[1] = record.shader_hash[1];
+			output.includes = std::move(record.dependencies);
+			output.shader.SetShaderData(record.binary.data(), record.binary.size());
+			output.shader.SetReflectionData(record.reflection.data(), record.reflection.size());
 			output.shader.SetDesc(input);
-
-#if defined(ADRIA_PLATFORM_MACOS)
-			if (reflection_size > 0)
-			{
-				std::unique_ptr<Char[]> reflection_data(new Char[reflection_size]);
-				binary_archive.loadBinary(reflection_data.get(), reflection_size);
-				output.shader.SetReflectionData(reflection_data.get(), reflection_size);
-			}
-#endif
-
 			return true;
 		}
-		static Bool SaveToCache(Char const* cache_path, GfxShaderCompileOutput const& output)
+		static void SaveToCache(Uint64 cache_key, GfxShaderCompileOutput const& output)
 		{
-			std::string cache_metadata(cache_path); cache_metadata += ".meta";
-			std::ofstream os(cache_metadata, std::ios::binary);
-			cereal::BinaryOutputArchive metadata_archive(os);
-			metadata_archive(output.shader_hash);
-			metadata_archive(output.includes);
-			metadata_archive(output.shader.GetSize());
-
-#if defined(ADRIA_PLATFORM_MACOS)
-			Uint64 reflection_size = output.shader.GetReflectionSize();
-			metadata_archive(reflection_size);
-#endif
-
-			std::string cache_binary(cache_path); cache_binary += ".bin";
-			std::ofstream os2(cache_binary, std::ios::binary);
-			cereal::BinaryOutputArchive binary_archive(os2);
-			binary_archive.saveBinary(output.shader.GetData(), output.shader.GetSize());
-
-#if defined(ADRIA_PLATFORM_MACOS)
-			if (reflection_size > 0)
-			{
-				binary_archive.saveBinary(output.shader.GetReflectionData(), reflection_size);
-			}
-#endif
-
-			return true;
+			std::span<Uint8 const> binary((Uint8 const*)output.shader.GetData(), output.shader.GetSize());
+			std::span<Uint8 const> reflection((Uint8 const*)output.shader.GetReflectionData(), output.shader.GetReflectionSize());
+			shader_cache.Store(cache_key, output.includes, output.shader_hash, binary, reflection);
 		}
 
 		void Initialize(GfxDevice* gfx)
@@ -299,6 +315,8 @@ namespace adria
 			std::string dxcompiler_path = "dxcompiler.dll";
 #elif defined(ADRIA_PLATFORM_MACOS)
 			std::string dxcompiler_path = "@executable_path/dxcompiler.dylib";
+#else
+			std::string dxcompiler_path = "libdxcompiler.so";
 #endif
 			dxcompiler.Open(dxcompiler_path.c_str());
 			ADRIA_FATAL_ASSERT(dxcompiler.IsOpen(), "Couldn't open dxcompiler!");
@@ -306,21 +324,13 @@ namespace adria
 			Bool const success = dxcompiler.GetSymbol("DxcCreateInstance", &PFN_DxcCreateInstance);
 			ADRIA_FATAL_ASSERT(success && PFN_DxcCreateInstance != nullptr, "Couldn't get DxcCreateInstance symbol from dxcompiler!");
 
-			HRESULT hr = S_OK;
-			hr = PFN_DxcCreateInstance(CLSID_DxcLibrary, IID_PPV_ARGS(library.GetAddressOf()));
-			ADRIA_ASSERT(SUCCEEDED(hr));
-			hr = PFN_DxcCreateInstance(CLSID_DxcCompiler, IID_PPV_ARGS(compiler.GetAddressOf()));
-			ADRIA_ASSERT(SUCCEEDED(hr));
-			hr = library->CreateIncludeHandler(include_handler.GetAddressOf());
-			ADRIA_ASSERT(SUCCEEDED(hr));
-			hr = PFN_DxcCreateInstance(CLSID_DxcUtils, IID_PPV_ARGS(utils.GetAddressOf()));
-			ADRIA_ASSERT(SUCCEEDED(hr));
+			free_contexts.push_back(CreateContext());
 
 			std::filesystem::create_directory(paths::ShaderPDBDir);
+			shader_cache.Open(paths::ShaderCacheDir + "ShaderCache.pack");
+			ADRIA_LOG(INFO, "Shader cache opened with %llu entries", shader_cache.GetPackedEntryCount());
 
 #if defined(ADRIA_PLATFORM_MACOS)
-			metal_ir_compiler = IRCompilerCreate();
-
 			// Match D3D12 common root signature: CB0, 8 constants at register 1, CB2, CB3
 			IRRootParameter1 root_parameters[4] = {};
 			root_parameters[0].ParameterType = IRRootParameterTypeCBV;
@@ -512,51 +522,56 @@ namespace adria
 			}
 			destroyed = true;
 
+			SaveCache();
 #if defined(ADRIA_PLATFORM_MACOS)
 			if (metal_root_signature)
 			{
 				IRRootSignatureDestroy(metal_root_signature);
 				metal_root_signature = nullptr;
 			}
-			if (metal_ir_compiler)
+			for (std::unique_ptr<GfxShaderCompilerContext>& context : contexts)
 			{
-				IRCompilerDestroy(metal_ir_compiler);
-				metal_ir_compiler = nullptr;
+				if (context->metal_ir_compiler)
+				{
+					IRCompilerDestroy(context->metal_ir_compiler);
+					context->metal_ir_compiler = nullptr;
+				}
 			}
 #endif
-			if (include_handler) include_handler.Reset();
-			if (utils) utils.Reset();
-			if (compiler) compiler.Reset();
-			if (library) library.Reset();
+			free_contexts.clear();
+			contexts.clear();
 		}
 
-		Bool CompileShader(GfxShaderCompileInput const& input, GfxShaderCompileOutput& output)
+		void SaveCache()
 		{
-			std::string define_key;
-			for (GfxShaderDefine const& define : input.defines)
+			if (!shader_cache.Save())
 			{
-				define_key += define.name;
-				define_key += define.value;
+				ADRIA_LOG(WARNING, "Failed to save the shader cache");
 			}
-			Uint64 define_hash = crc64(define_key.c_str(), define_key.size());
-			std::string build_string = input.flags & GfxShaderCompilerFlag_Debug ? "debug" : "release";
-			Char cache_path[256];
-			snprintf(cache_path, sizeof(cache_path), "%s%s_%s_%llx_%s", paths::ShaderCacheDir.c_str(), GetFilenameWithoutExtension(input.file).c_str(),
-												     input.entry_point.c_str(), define_hash, build_string.c_str());
+		}
 
-			if (CheckCache(cache_path, input, output))
+		void InvalidateCacheDependencies()
+		{
+			shader_cache.RefreshDependencies();
+		}
+
+		Bool CompileShader(GfxShaderCompileInput const& input, GfxShaderCompileOutput& output)
+		{
+			Uint64 const cache_key = GetCacheKey(input);
+			if (CheckCache(cache_key, input, output))
 			{
 				return true;
 			}
 			ADRIA_LOG(INFO, "Shader '%s.%s' not found in cache. Compiling...", input.file.c_str(), input.entry_point.c_str());
 
+			GfxShaderCompilerContextScope context;
 			compile:
 			Uint32 code_page = CP_UTF8;
 			Ref<IDxcBlobEncoding> source_blob;
 
 			std::wstring shader_source = ToWideString(input.file);
 			ADRIA_LOG_SYNC(INFO, "Compiling shader: %s, entry: %s, stage: %d", input.file.c_str(), input.entry_point.c_str(), (int)input.stage);
-			HRESULT hr = library->CreateBlobFromFile(shader_source.data(), &code_page, source_blob.GetAddressOf());
+			HRESULT hr = context->library->CreateBlobFromFile(shader_source.data(), &code_page, source_blob.GetAddressOf());
 			if (FAILED(hr))
 			{
 				ADRIA_LOG(ERROR, "Failed to load shader file: %s", input.file.c_str());
@@ -645,10 +660,10 @@ namespace adria
 			source_buffer.Ptr = source_blob->GetBufferPointer();
 			source_buffer.Size = source_blob->GetBufferSize();
 			source_buffer.Encoding = DXC_CP_ACP;
-			GfxIncludeHandler custom_include_handler{};
+			GfxIncludeHandler custom_include_handler(*context);
 
 			Ref<IDxcResult> result;
-			hr = compiler->Compile(
+			hr = context->compiler->Compile(
 				&source_buffer,
 				compile_args.data(), (Uint32)compile_args.size(),
 				&custom_include_handler,
@@ -695,7 +710,7 @@ namespace adria
 				if (SUCCEEDED(result->GetOutput(DXC_OUT_PDB, IID_PPV_ARGS(pdb_blob.GetAddressOf()), pdb_path_utf16.GetAddressOf())))
 				{
 					Ref<IDxcBlobUtf8> pdb_path_utf8;
-					if (SUCCEEDED(utils->GetBlobAsUtf8(pdb_path_utf16.Get(), pdb_path_utf8.GetAddressOf())))
+					if (SUCCEEDED(context->utils->GetBlobAsUtf8(pdb_path_utf16.Get(), pdb_path_utf8.GetAddressOf())))
 					{
 						Char pdb_path[256];
 						snprintf(pdb_path, sizeof(pdb_path), "%s%s", paths::ShaderPDBDir.c_str(), pdb_path_utf8->GetStringPointer());
@@ -718,6 +733,7 @@ namespace adria
 			}
 
 #if defined(ADRIA_PLATFORM_MACOS)
+			IRCompiler* metal_ir_compiler = context->metal_ir_compiler;
 			ADRIA_ASSERT(metal_ir_compiler && metal_root_signature);
 			IRCompilerSetGlobalRootSignature(metal_ir_compiler, metal_root_signature);
 			IRCompilerSetMinimumGPUFamily(metal_ir_compiler, IRGPUFamilyApple7);
@@ -877,7 +893,7 @@ namespace adria
 #endif
 			output.includes = std::move(custom_include_handler.include_files);
 			output.includes.push_back(input.file);
-			SaveToCache(cache_path, output);
+			SaveToCache(cache_key, output);
 			return true;
 		}
 
@@ -886,7 +902,8 @@ namespace adria
 			std::wstring wide_filename = ToWideString(filename);
 			Uint32 code_page = CP_UTF8;
 			Ref<IDxcBlobEncoding> source_blob;
-			HRESULT hr = library->CreateBlobFromFile(wide_filename.data(), &code_page, source_blob.GetAddressOf());
+			GfxShaderCompilerContextScope context;
+			HRESULT hr = context->library->CreateBlobFromFile(wide_filename.data(), &code_page, source_blob.GetAddressOf());
 			if (FAILED(hr))
 			{
 				ADRIA_LOG(ERROR, "Failed to read blob from file: %s", filename.c_str());
@@ -19,7 +19,10 @@ namespace adria
 	{
 		void Initialize(GfxDevice* gfx);
 		void Destroy();
+		//safe to call from multiple threads at once
 		Bool CompileShader(GfxShaderCompileInput const& input, GfxShaderCompileOutput& output);
 		void ReadBlobFromFile(std::string const& filename, GfxShaderBlob& blob);
+		void SaveCache();
+		void InvalidateCacheDependencies();
 	}
 }
\ No newline at end of file
@@ -1,45 +1,75 @@
+#include <shared_mutex>
 #include "GfxShaderKey.h"
 #include "GfxShader.h"
 #include "Rendering/ShaderManager.h"
 #include "Utilities/Hash.h"
+#include "Core/FatalAssert.h"
 
 namespace adria
 {
-	struct GfxShaderKey::Impl
+	namespace
 	{
-		std::vector<GfxShaderDefine> defines;
-		ShaderID id = ShaderID_Invalid;
-	};
-
-	GfxShaderKey::GfxShaderKey()
-	{
-		impl = std::make_unique<Impl>();
-	}
-
-	GfxShaderKey::GfxShaderKey(ShaderID shader_id) : GfxShaderKey()
-	{
-		impl->id = shader_id;
-	}
-
-	GfxShaderKey::GfxShaderKey(GfxShaderKey const& k) 
-	{
-		impl = std::make_unique<Impl>();
-		impl->id = k.impl->id;
-		impl->defines = k.impl->defines;
+		//define names and values live for the whole run, keys only keep their ids. Keys are built on worker threads too
+		class ShaderDefineStringTable
+		{
+		public:
+			struct InternedString
+			{
+				Uint32 id;
+				Uint64 hash;
+			};
+
+			InternedString Intern(Char const* str)
+			{
+				std::string_view const view(str);
+				{
+					std::shared_lock lock(mutex);
+					if (auto it = ids.find(view); it != ids.end())
+					{
+						return { it->second, strings[it->second].hash };
+					}
+				}
+
+				std::unique_lock lock(mutex);
+				if (auto it = ids.find(view); it != ids.end())
+				{
+					return { it->second, strings[it->second].hash };
+				}
+				Uint32 const id = (Uint32)strings.size();
+				Entry const& entry = strings.emplace_back(std::string(view), crc64(view.data(), view.size()));
+				ids.emplace(entry.str, id);
+				return { id, entry.hash };
+			}
+
+			std::string Get(Uint32 id) const
+			{
+				std::shared_lock lock(mutex);
+				return strings[id].str;
+			}
+
+		private:
+			struct Entry
+			{
+				std::string str;
+				Uint64 hash;
+			};
+			mutable std::shared_mutex mutex;
+			std::deque<Entry> strings;
+			std::unordered_map<std::string_view, Uint32> ids;
+		};
+
+		ShaderDefineStringTable& GetDefineStringTable()
+		{
+			static ShaderDefineStringTable table;
+			return table;
+		}
 	}
 
-	GfxShaderKey::~GfxShaderKey() = default;
+	GfxShaderKey::GfxShaderKey(ShaderID shader_id) : id(shader_id) {}
 
 	void GfxShaderKey::Init(ShaderID shader_id)
 	{
-		impl->id = shader_id;
-	}
-
-	GfxShaderKey& GfxShaderKey::operator=(GfxShaderKey const& k)
-	{
-		impl->id = k.impl->id;
-		impl->defines = k.impl->defines;
-		return *this;
+		id = shader_id;
 	}
 
 	void GfxShaderKey::operator=(ShaderID shader_id)
@@ -49,51 +79,68 @@ namespace adria
 
 	void GfxShaderKey::AddDefine(Char const* name, Char const* value)
 	{
-		impl->defines.emplace_back(name, value);
+		//dropping a define would give two permutations the same key and hand out the wrong shader
+		ADRIA_FATAL_ASSERT(define_count < MaxDefines, "Too many defines in a shader key, increase GfxShaderKey::MaxDefines (define %s)", name);
+		ShaderDefineStringTable& table = GetDefineStringTable();
+		ShaderDefineStringTable::InternedString const interned_name = table.Intern(name);
+		ShaderDefineStringTable::InternedString const interned_value = table.Intern(value);
+		defines[define_count++] = { interned_name.id, interned_value.id };
+
+		HashState state;
+		state.Combine(defines_hash);
+		state.Combine(interned_name.hash);
+		state.Combine(interned_value.hash);
+		defines_hash = state;
 	}
 
 	Bool GfxShaderKey::IsValid() const
 	{
-		return impl->id != ShaderID_Invalid;
+		return id != ShaderID_Invalid;
 	}
 
 	GfxShaderKey::operator ShaderID() const
 	{
-		return impl->id;
+		return id;
 	}
 
-	std::vector<GfxShaderDefine> const& GfxShaderKey::GetDefines() const
+	std::vector<GfxShaderDefine> GfxShaderKey::GetDefines() const
 	{
-		return impl->defines;
+		ShaderDefineStringTable const& table = GetDefineStringTable();
+		std::vector<GfxShaderDefine> shader_defines;
+		shader_defines.reserve(define_count);
+		for (Uint32 i = 0; i < define_count; ++i)
+		{
+			shader_defines.emplace_back(table.Get(defines[i].name), table.Get(defines[i].value));
+		}
+		return shader_defines;
 	}
 
 	ShaderID GfxShaderKey::GetShaderID() const
 	{
-		return impl->id;
+		return id;
 	}
 
 	Uint64 GfxShaderKey::GetHash() const
 	{
-		if (!impl)
-		{
-			return 0;
-		}
-
-		std::string define_key;
-		for (GfxShaderDefine const& define : impl->defines)
-		{
-			define_key += define.name;
-			define_key += define.value;
-		}
-		define_key += std::to_string(impl->id);
-		Uint64 define_hash = crc64(define_key.c_str(), define_key.size());
-		return define_hash;
+		HashState state;
+		state.Combine(defines_hash);
+		state.Combine((Uint64)id);
+		return state;
 	}
 
 	Bool GfxShaderKey::operator==(GfxShaderKey const& key) const
 	{
-		if (impl->id != key.impl->id) return false;
-		return GetHash() == key.GetHash();
+		if (id != key.id || define_count != key.define_count || defines_hash != key.defines_hash)
+		{
+			return false;
+		}
+		for (Uint32 i = 0; i < define_count; ++i)
+		{
+			if (defines[i].name != key.defines[i].name || defines[i].value != key.defines[i].value)
+			{
+				return false;
+			}
+		}
+		return true;
 	}
-
 }
@@ -5,16 +5,16 @@ namespace adria
 	enum ShaderID : Uint8;
 	struct GfxShaderDefine;
 
+	//value type key of a shader permutation. Define names and values are interned once so the key stores
+	//two ids per define inline, the hash is updated as defines are added and copying never allocates
 	class GfxShaderKey
 	{
-		struct Impl;
 	public:
-		GfxShaderKey();
-		GfxShaderKey(ShaderID shader_id);
-		~GfxShaderKey();
+		static constexpr Uint32 MaxDefines = 16;
 
-		GfxShaderKey(GfxShaderKey const&);
-		GfxShaderKey& operator=(GfxShaderKey const&);
+	public:
+		GfxShaderKey() = default;
+		GfxShaderKey(ShaderID shader_id);
 
 		void Init(ShaderID shader_id);
 		void operator=(ShaderID shader_id);
@@ -22,7 +22,7 @@ namespace adria
 		void AddDefine(Char const* name, Char const* value = "");
 		Bool IsValid() const;
 
-		std::vector<GfxShaderDefine> const& GetDefines() const;
+		std::vector<GfxShaderDefine> GetDefines() const;
 		ShaderID GetShaderID() const;
 		Uint64 GetHash() const;
 
@@ -30,7 +30,16 @@ namespace adria
 		Bool operator==(GfxShaderKey const& key) const;
 
 	private:
-		std::unique_ptr<Impl> impl;
+		struct DefineEntry
+		{
+			Uint32 name;
+			Uint32 value;
+		};
+
+		DefineEntry defines[MaxDefines] = {};
+		Uint64 defines_hash = 0;
+		Uint32 define_count = 0;
+		ShaderID id{};
 	};
 
 	struct GfxShaderKeyHash
@@ -41,4 +50,3 @@ namespace adria
 		}
 	};
 }
-
@@ -57,6 +57,8 @@ namespace adria
         virtual void TextureBarrier(GfxTexture const& texture, GfxResourceState flags_before, GfxResourceState flags_after, Uint32 subresource = 0) override {}
         virtual void BufferBarrier(GfxBuffer const& buffer, GfxResourceState flags_before, GfxResourceState flags_after) override {}
         virtual void GlobalBarrier(GfxResourceState flags_before, GfxResourceState flags_after) override {}
+        virtual void SplitTextureBarrier(GfxTexture const& texture, GfxResourceState flags_before, GfxResourceState flags_after, GfxBarrierSplit split) override {}
+        virtual void SplitBufferBarrier(GfxBuffer const& buffer, GfxResourceState flags_before, GfxResourceState flags_after, GfxBarrierSplit split) override {}
         virtual void FlushBarriers() override {}
 
         virtual void CopyBuffer(GfxBuffer& dst, GfxBuffer const& src) override;
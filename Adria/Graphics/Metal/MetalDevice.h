@@ -114,6 +114,10 @@ namespace adria
         std::shared_ptr<GfxBuffer> CreateBufferShared(GfxBufferDesc const& desc, GfxBufferData const& initial_data) override;
         std::shared_ptr<GfxBuffer> CreateBufferShared(GfxBufferDesc const& desc) override;
 
+        std::unique_ptr<GfxHeap> CreateHeap(GfxHeapDesc const& desc) override { return nullptr; }
+        std::unique_ptr<GfxTexture> CreatePlacedTexture(GfxTextureDesc const& desc, GfxHeap* heap, Uint64 heap_offset) override { return nullptr; }
+        std::unique_ptr<GfxBuffer> CreatePlacedBuffer(GfxBufferDesc const& desc, GfxHeap* heap, Uint64 heap_offset) override { return nullptr; }
+
         std::unique_ptr<GfxPipelineState> CreateGraphicsPipelineState(GfxGraphicsPipelineStateDesc const& desc) override;
         std::unique_ptr<GfxPipelineState> CreateComputePipelineState(GfxComputePipelineStateDesc const& desc) override;
         std::unique_ptr<GfxPipelineState> CreateMeshShaderPipelineState(GfxMeshShaderPipelineStateDesc const& desc) override;
@@ -133,6 +137,8 @@ namespace adria
 
         Uint64 GetLinearBufferSize(GfxTexture const* texture) const override { return 0; }
         Uint64 GetLinearBufferSize(GfxBuffer const* buffer) const override { return 0; }
+        GfxAllocationInfo GetAllocationInfo(GfxTextureDesc const& desc) const override { return {}; }
+        GfxAllocationInfo GetAllocationInfo(GfxBufferDesc const& desc) const override { return {}; }
 
         GfxShadingRateInfo const& GetShadingRateInfo() const override;
         void SetShadingRateInfo(GfxShadingRateInfo const& info) override {}
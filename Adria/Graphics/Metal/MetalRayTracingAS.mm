@@ -41,7 +41,18 @@ namespace adria
             triangleGeometry.vertexBuffer = vertex_buffer->GetMetalBuffer();
             triangleGeometry.vertexBufferOffset = geom.vertex_buffer_offset;
             triangleGeometry.vertexStride = geom.vertex_stride;
-            triangleGeometry.vertexFormat = MTLAttributeFormatFloat3;
+            triangleGeometry.vertexFormat = (MTLAttributeFormat)ToMTLVertexFormat(geom.vertex_format);
+            if (geom.use_vertex_transform)
+            {
+                //metal expects a column major 4x3 matrix, the build waits for completion so the buffer only has to outlive this scope
+                MTLPackedFloat4x3 transform;
+                for (Uint32 column = 0; column < 4; ++column)
+                {
+                    transform.columns[column] = MTLPackedFloat3Make(geom.vertex_transform[0][column], geom.vertex_transform[1][column], geom.vertex_transform[2][column]);
+                }
+                triangleGeometry.transformationMatrixBuffer = [device newBufferWithBytes:&transform length:sizeof(transform) options:MTLResourceStorageModeShared];
+                triangleGeometry.transformationMatrixBufferOffset = 0;
+            }
 
             if (geom.index_buffer)
             {
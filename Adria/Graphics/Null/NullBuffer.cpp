@@ -0,0 +1,20 @@
+#include "NullBuffer.h"
+#include "NullDevice.h"
+
+namespace adria
+{
+	NullBuffer::NullBuffer(GfxDevice* gfx, GfxBufferDesc const& desc, GfxBufferData initial_data) : GfxBuffer(gfx, desc)
+	{
+		gpu_address = static_cast<NullDevice*>(gfx)->AllocateGpuAddress(desc.size);
+		if (desc.resource_usage == GfxResourceUsage::Upload || desc.resource_usage == GfxResourceUsage::Readback)
+		{
+			//nothing is ever copied back, so readback memory starts zeroed to keep the results deterministic
+			memory.reset(desc.resource_usage == GfxResourceUsage::Readback ? new Uint8[desc.size]() : new Uint8[desc.size]);
+			mapped_data = memory.get();
+			if (initial_data && desc.resource_usage == GfxResourceUsage::Upload)
+			{
+				memcpy(mapped_data, initial_data, desc.size);
+			}
+		}
+	}
+}
@@ -0,0 +1,23 @@
+#pragma once
+#include "Graphics/GfxBuffer.h"
+
+namespace adria
+{
+	//only upload and readback buffers get cpu memory, default heap buffers are never touched by the cpu
+	class NullBuffer final : public GfxBuffer
+	{
+	public:
+		NullBuffer(GfxDevice* gfx, GfxBufferDesc const& desc, GfxBufferData initial_data = {});
+
+		virtual void* GetNative() const override { return nullptr; }
+		virtual Uint64 GetGpuAddress() const override { return gpu_address; }
+		virtual void* GetSharedHandle() const override { return nullptr; }
+		virtual void* Map() override { return mapped_data; }
+		virtual void Unmap() override {}
+		virtual void SetName(Char const*) override {}
+
+	private:
+		std::unique_ptr<Uint8[]> memory;
+		Uint64 gpu_address = 0;
+	};
+}
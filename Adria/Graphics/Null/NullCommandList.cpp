@@ -0,0 +1,220 @@
+#include "NullCommandList.h"
+#include "NullDevice.h"
+#include "NullRayTracingPipeline.h"
+#include "Graphics/GfxBuffer.h"
+#include "Graphics/GfxCommandQueue.h"
+#include "Graphics/GfxLinearDynamicAllocator.h"
+#include "Graphics/GfxPipelineState.h"
+#include "Graphics/GfxQueryHeap.h"
+
+namespace adria
+{
+	NullCommandList::NullCommandList(GfxDevice* gfx, GfxCommandListType type)
+		: gfx(static_cast<NullDevice*>(gfx)), type(type), cmd_queue(gfx->GetCommandQueue(type))
+	{
+	}
+
+	NullCommandList::~NullCommandList() = default;
+
+	GfxDevice* NullCommandList::GetDevice()
+	{
+		return gfx;
+	}
+
+	void NullCommandList::Begin()
+	{
+		ResetState();
+		stats = {};
+		queued_barriers = 0;
+		recording = true;
+	}
+
+	void NullCommandList::End()
+	{
+		ADRIA_ASSERT(recording);
+		ADRIA_ASSERT(current_render_pass == nullptr);
+		FlushBarriers();
+		recording = false;
+		++stats.command_lists;
+		gfx->AddFrameStats(stats);
+		stats = {};
+	}
+
+	void NullCommandList::FlushBarriers()
+	{
+		if (queued_barriers > 0)
+		{
+			++stats.barrier_batches;
+			queued_barriers = 0;
+		}
+	}
+
+	void NullCommandList::Signal(GfxFence& fence, Uint64 value)
+	{
+		pending_signals.emplace_back(fence, value);
+	}
+
+	void NullCommandList::Submit()
+	{
+		SignalAll();
+	}
+
+	void NullCommandList::SignalAll()
+	{
+		for (Uint64 i = 0; i < pending_signals.size(); ++i)
+		{
+			cmd_queue->Signal(pending_signals[i].first, pending_signals[i].second);
+		}
+		pending_signals.clear();
+	}
+
+	void NullCommandList::ResetState()
+	{
+		current_pso = nullptr;
+		current_render_pass = nullptr;
+		current_rt_bindings.reset();
+		current_context = Context::Invalid;
+	}
+
+	void NullCommandList::ResolveQueryData(GfxQueryHeap const&, Uint32, Uint32 count, GfxBuffer& dst_buffer, Uint64 dst_offset)
+	{
+		if (dst_buffer.IsMapped())
+		{
+			memset(dst_buffer.GetMappedData<Uint8>() + dst_offset, 0, count * sizeof(Uint64));
+		}
+	}
+
+	void NullCommandList::Draw(Uint32 vertex_count, Uint32 instance_count, Uint32, Uint32)
+	{
+		ADRIA_ASSERT(current_context == Context::Graphics);
+		if (vertex_count == 0 || instance_count == 0)
+		{
+			return;
+		}
+		++stats.draw_calls;
+	}
+
+	void NullCommandList::DrawIndexed(Uint32 index_count, Uint32 instance_count, Uint32, Uint32, Uint32)
+	{
+		ADRIA_ASSERT(current_context == Context::Graphics);
+		if (index_count == 0 || instance_count == 0)
+		{
+			return;
+		}
+		++stats.draw_calls;
+	}
+
+	void NullCommandList::Dispatch(Uint32 group_count_x, Uint32 group_count_y, Uint32 group_count_z)
+	{
+		ADRIA_ASSERT(current_context == Context::Compute);
+		if (group_count_x == 0 || group_count_y == 0 || group_count_z == 0)
+		{
+			return;
+		}
+		++stats.dispatches;
+	}
+
+	void NullCommandList::DispatchMesh(Uint32 group_count_x, Uint32 group_count_y, Uint32 group_count_z)
+	{
+		ADRIA_ASSERT(current_context == Context::Graphics);
+		if (group_count_x == 0 || group_count_y == 0 || group_count_z == 0)
+		{
+			return;
+		}
+		++stats.draw_calls;
+	}
+
+	void NullCommandList::DrawIndirect(GfxBuffer const&, Uint32)
+	{
+		ADRIA_ASSERT(current_context == Context::Graphics);
+		++stats.draw_calls;
+	}
+
+	void NullCommandList::DrawIndexedIndirect(GfxBuffer const&, Uint32)
+	{
+		ADRIA_ASSERT(current_context == Context::Graphics);
+		++stats.draw_calls;
+	}
+
+	void NullCommandList::DispatchIndirect(GfxBuffer const&, Uint32)
+	{
+		ADRIA_ASSERT(current_context == Context::Compute);
+		++stats.dispatches;
+	}
+
+	void NullCommandList::DispatchMeshIndirect(GfxBuffer const&, Uint32)
+	{
+		ADRIA_ASSERT(current_context == Context::Graphics);
+		++stats.draw_calls;
+	}
+
+	void NullCommandList::DispatchRays(Uint32 dispatch_width, Uint32 dispatch_height, Uint32 dispatch_depth)
+	{
+		ADRIA_ASSERT(current_context == Context::Compute);
+		if (dispatch_width == 0 || dispatch_height == 0 || dispatch_depth == 0)
+		{
+			return;
+		}
+		ADRIA_ASSERT(current_rt_bindings != nullptr);
+		++stats.dispatches;
+	}
+
+	void NullCommandList::BeginRenderPass(GfxRenderPassDesc const& render_pass_desc)
+	{
+		ADRIA_ASSERT(current_context == Context::Graphics);
+		ADRIA_ASSERT(current_render_pass == nullptr);
+		current_render_pass = &render_pass_desc;
+		++stats.render_passes;
+	}
+
+	void NullCommandList::EndRenderPass()
+	{
+		ADRIA_ASSERT(current_context == Context::Graphics);
+		ADRIA_ASSERT(current_render_pass != nullptr);
+		current_render_pass = nullptr;
+	}
+
+	void NullCommandList::SetPipelineState(GfxPipelineState const* pso)
+	{
+		if (pso != current_pso)
+		{
+			current_pso = pso;
+			if (pso != nullptr)
+			{
+				if (pso->GetType() == GfxPipelineStateType::Graphics || pso->GetType() == GfxPipelineStateType::MeshShader)
+				{
+					ADRIA_ASSERT(current_context == Context::Graphics);
+				}
+				else
+				{
+					ADRIA_ASSERT(current_context == Context::Compute);
+				}
+			}
+			++stats.pipeline_changes;
+		}
+	}
+
+	GfxRayTracingShaderBindings* NullCommandList::BeginRayTracingShaderBindings(ADRIA_MAYBE_UNUSED GfxRayTracingPipeline const* pipeline)
+	{
+		ADRIA_ASSERT(pipeline != nullptr);
+		ADRIA_ASSERT(pipeline->IsValid());
+		current_rt_bindings = std::make_unique<NullRayTracingShaderBindings>();
+		++stats.pipeline_changes;
+		return current_rt_bindings.get();
+	}
+
+	void NullCommandList::SetRootCBV(Uint32, void const* data, Uint64 data_size)
+	{
+		ADRIA_ASSERT(current_context != Context::Invalid);
+
+		GfxDynamicAllocation alloc = gfx->GetDynamicAllocator()->Allocate(data_size, 256);
+		alloc.Update(data, data_size);
+		stats.transient_bytes += data_size;
+	}
+
+	GfxDynamicAllocation NullCommandList::AllocateTransient(Uint32 size, Uint32 align)
+	{
+		stats.transient_bytes += size;
+		return gfx->GetDynamicAllocator()->Allocate(size, align);
+	}
+}
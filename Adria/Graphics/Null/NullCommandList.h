@@ -0,0 +1,156 @@
+#pragma once
+#include "Graphics/GfxCommandList.h"
+
+namespace adria
+{
+	class NullDevice;
+	class NullRayTracingShaderBindings;
+
+	struct NullFrameStats
+	{
+		Uint64 command_lists = 0;
+		Uint64 draw_calls = 0;
+		Uint64 dispatches = 0;
+		Uint64 barriers = 0;
+		Uint64 split_barriers = 0;
+		Uint64 barrier_batches = 0;
+		Uint64 copies = 0;
+		Uint64 render_passes = 0;
+		Uint64 pipeline_changes = 0;
+		Uint64 transient_bytes = 0;
+
+		NullFrameStats& operator+=(NullFrameStats const& other)
+		{
+			command_lists += other.command_lists;
+			draw_calls += other.draw_calls;
+			dispatches += other.dispatches;
+			barriers += other.barriers;
+			split_barriers += other.split_barriers;
+			barrier_batches += other.barrier_batches;
+			copies += other.copies;
+			render_passes += other.render_passes;
+			pipeline_changes += other.pipeline_changes;
+			transient_bytes += other.transient_bytes;
+			return *this;
+		}
+	};
+
+	//records nothing, it only counts what the renderer submits and hands the totals to the device when closed
+	class NullCommandList final : public GfxCommandList
+	{
+	public:
+		explicit NullCommandList(GfxDevice* gfx, GfxCommandListType type = GfxCommandListType::Graphics);
+		virtual ~NullCommandList() override;
+		ADRIA_NONCOPYABLE(NullCommandList)
+
+		virtual GfxDevice* GetDevice() override;
+		virtual void* GetNative() const override { return nullptr; }
+		virtual GfxCommandQueue* GetQueue() const override { return cmd_queue; }
+
+		virtual void ResetAllocator() override {}
+		virtual void Begin() override;
+		virtual void End() override;
+		virtual void Wait(GfxFence&, Uint64) override {}
+		virtual void Signal(GfxFence& fence, Uint64 value) override;
+		virtual void WaitAll() override {}
+		virtual void Submit() override;
+		virtual void SignalAll() override;
+		virtual void ResetState() override;
+
+		virtual void BeginEvent(Char const*) override {}
+		virtual void BeginEvent(Char const*, Uint32) override {}
+		virtual void EndEvent() override {}
+
+		virtual void BeginQuery(GfxQueryHeap&, Uint32) override {}
+		virtual void EndQuery(GfxQueryHeap&, Uint32) override {}
+		virtual void ResolveQueryData(GfxQueryHeap const& query_heap, Uint32 start, Uint32 count, GfxBuffer& dst_buffer, Uint64 dst_offset) override;
+
+		virtual void Draw(Uint32 vertex_count, Uint32 instance_count = 1, Uint32 start_vertex_location = 0, Uint32 start_instance_location = 0) override;
+		virtual void DrawIndexed(Uint32 index_count, Uint32 instance_count = 1, Uint32 index_offset = 0, Uint32 base_vertex_location = 0, Uint32 start_instance_location = 0) override;
+		virtual void Dispatch(Uint32 group_count_x, Uint32 group_count_y, Uint32 group_count_z = 1) override;
+		virtual void DispatchMesh(Uint32 group_count_x, Uint32 group_count_y, Uint32 group_count_z = 1) override;
+		virtual void DrawIndirect(GfxBuffer const& buffer, Uint32 offset) override;
+		virtual void DrawIndexedIndirect(GfxBuffer const& buffer, Uint32 offset) override;
+		virtual void DispatchIndirect(GfxBuffer const& buffer, Uint32 offset) override;
+		virtual void DispatchMeshIndirect(GfxBuffer const& buffer, Uint32 offset) override;
+		virtual void DispatchRays(Uint32 dispatch_width, Uint32 dispatch_height, Uint32 dispatch_depth = 1) override;
+
+		//barriers are queued like on d3d12, every flush with queued barriers counts as one batch
+		virtual void TextureBarrier(GfxTexture const&, GfxResourceState, GfxResourceState, Uint32 = static_cast<Uint32>(-1)) override { QueueBarrier(); }
+		virtual void BufferBarrier(GfxBuffer const&, GfxResourceState, GfxResourceState) override { QueueBarrier(); }
+		virtual void GlobalBarrier(GfxResourceState, GfxResourceState) override { QueueBarrier(); }
+		virtual void SplitTextureBarrier(GfxTexture const&, GfxResourceState, GfxResourceState, GfxBarrierSplit) override { QueueBarrier(); ++stats.split_barriers; }
+		virtual void SplitBufferBarrier(GfxBuffer const&, GfxResourceState, GfxResourceState, GfxBarrierSplit) override { QueueBarrier(); ++stats.split_barriers; }
+		virtual void FlushBarriers() override;
+
+		virtual void CopyBuffer(GfxBuffer&, GfxBuffer const&) override { ++stats.copies; }
+		virtual void CopyBuffer(GfxBuffer&, Uint64, GfxBuffer const&, Uint64, Uint64) override { ++stats.copies; }
+		virtual void CopyTexture(GfxTexture&, GfxTexture const&) override { ++stats.copies; }
+		virtual void CopyTexture(GfxTexture&, Uint32, Uint32, GfxTexture const&, Uint32, Uint32) override { ++stats.copies; }
+		virtual void CopyTextureToBuffer(GfxBuffer&, Uint64, GfxTexture const&, Uint32, Uint32) override { ++stats.copies; }
+		virtual void CopyBufferToTexture(GfxTexture&, Uint32, Uint32, GfxBuffer const&, Uint32) override { ++stats.copies; }
+
+		virtual void ClearBuffer(GfxBuffer const&, GfxBufferDescriptorDesc const&, Float const[4]) override {}
+		virtual void ClearTexture(GfxTexture const&, GfxTextureDescriptorDesc const&, Float const[4]) override {}
+		virtual void ClearBuffer(GfxBuffer const&, GfxBufferDescriptorDesc const&, Uint32 const[4]) override {}
+		virtual void ClearTexture(GfxTexture const&, GfxTextureDescriptorDesc const&, Uint32 const[4]) override {}
+		virtual void WriteBufferImmediate(GfxBuffer&, Uint32, Uint32) override {}
+
+		virtual void BeginRenderPass(GfxRenderPassDesc const& render_pass_desc) override;
+		virtual void EndRenderPass() override;
+
+		virtual void SetPipelineState(GfxPipelineState const* state) override;
+		virtual GfxRayTracingShaderBindings* BeginRayTracingShaderBindings(GfxRayTracingPipeline const* pipeline) override;
+		virtual void SetStencilReference(Uint8) override {}
+		virtual void SetBlendFactor(Float const*) override {}
+		virtual void SetPrimitiveTopology(GfxPrimitiveTopology) override {}
+		virtual void SetIndexBuffer(GfxIndexBufferView*) override {}
+		virtual void SetVertexBuffer(GfxVertexBufferView const&, Uint32 = 0) override {}
+		virtual void SetVertexBuffers(std::span<GfxVertexBufferView const>, Uint32 = 0) override {}
+		virtual void SetViewport(Uint32, Uint32, Uint32, Uint32) override {}
+		virtual void SetScissorRect(Uint32, Uint32, Uint32, Uint32) override {}
+
+		virtual void SetShadingRate(GfxShadingRate) override {}
+		virtual void SetShadingRate(GfxShadingRate, std::span<GfxShadingRateCombiner, SHADING_RATE_COMBINER_COUNT>) override {}
+		virtual void SetShadingRateImage(GfxTexture const*) override {}
+		virtual void BeginVRS(GfxShadingRateInfo const&) override {}
+		virtual void EndVRS(GfxShadingRateInfo const&) override {}
+
+		virtual void SetRootConstant(Uint32, Uint32, Uint32 = 0) override {}
+		virtual void SetRootConstants(Uint32, void const*, Uint32, Uint32 = 0) override {}
+		virtual void SetRootCBV(Uint32 slot, void const* data, Uint64 data_size) override;
+		virtual void SetRootCBV(Uint32, Uint64) override {}
+		virtual void SetRootSRV(Uint32, Uint64) override {}
+		virtual void SetRootUAV(Uint32, Uint64) override {}
+		virtual void SetRootDescriptorTable(Uint32, GfxDescriptor) override {}
+		virtual GfxDynamicAllocation AllocateTransient(Uint32 size, Uint32 align = 0) override;
+
+		virtual void ClearRenderTarget(GfxDescriptor, Float const*) override {}
+		virtual void ClearDepth(GfxDescriptor, Float = 1.0f, Uint8 = 0, Bool = false) override {}
+		virtual void SetRenderTargets(std::span<GfxDescriptor const>, GfxDescriptor const* = nullptr, Bool = false) override {}
+
+		virtual void SetContext(Context ctx) override { current_context = ctx; }
+
+	private:
+		NullDevice* gfx;
+		GfxCommandListType type;
+		GfxCommandQueue* cmd_queue;
+		std::vector<std::pair<GfxFence&, Uint64>> pending_signals;
+
+		GfxPipelineState const* current_pso = nullptr;
+		GfxRenderPassDesc const* current_render_pass = nullptr;
+		Context current_context = Context::Invalid;
+		std::unique_ptr<NullRayTracingShaderBindings> current_rt_bindings;
+		//open on creation like a d3d12 list, so init time work can be recorded before the first frame
+		Bool recording = true;
+		NullFrameStats stats;
+		Uint32 queued_barriers = 0;
+
+	private:
+		void QueueBarrier()
+		{
+			++stats.barriers;
+			++queued_barriers;
+		}
+	};
+}
@@ -0,0 +1,23 @@
+#pragma once
+#include "Graphics/GfxCommandQueue.h"
+#include "Graphics/GfxCommandList.h"
+
+namespace adria
+{
+	class NullCommandQueue final : public GfxCommandQueue
+	{
+	public:
+		explicit NullCommandQueue(GfxCommandListType type) : type(type) {}
+
+		virtual void ExecuteCommandLists(std::span<GfxCommandList*>) override {}
+		virtual void Signal(GfxFence& fence, Uint64 fence_value) override { fence.Signal(fence_value); }
+		virtual void Wait(GfxFence&, Uint64) override {}
+
+		virtual Uint64 GetTimestampFrequency() const override { return 1000000000ull; }
+		virtual GfxCommandListType GetType() const override { return type; }
+		virtual void* GetNative() const override { return nullptr; }
+
+	private:
+		GfxCommandListType type;
+	};
+}
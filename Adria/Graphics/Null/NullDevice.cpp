@@ -0,0 +1,412 @@
+#include "NullDevice.h"
+#include "NullBuffer.h"
+#include "NullTexture.h"
+#include "NullCommandQueue.h"
+#include "NullHeap.h"
+#include "NullQueryHeap.h"
+#include "NullPipelineState.h"
+#include "NullRayTracingAS.h"
+#include "NullRayTracingPipeline.h"
+#include "Graphics/GfxLinearDynamicAllocator.h"
+#include "Platform/Window.h"
+#include "tracy/Tracy.hpp"
+
+namespace adria
+{
+	ADRIA_LOG_CHANNEL(Graphics);
+
+	namespace
+	{
+		//matches the d3d12 placement alignment so pooled and aliased resources are laid out the same way
+		constexpr Uint64 NULL_RESOURCE_ALIGNMENT = 64 * 1024;
+		constexpr Uint64 NULL_ROW_PITCH_ALIGNMENT = 256;
+		constexpr Uint64 NULL_GPU_ADDRESS_BASE = 1ull << 32;
+		constexpr Uint32 NULL_DEFAULT_WIDTH = 1280;
+		constexpr Uint32 NULL_DEFAULT_HEIGHT = 1024;
+	}
+
+	Bool NullCapabilities::Initialize(GfxDevice*)
+	{
+		ray_tracing_support = RayTracingSupport::TierNotSupported;
+		vrs_support = VRSSupport::TierNotSupported;
+		mesh_shader_support = MeshShaderSupport::Tier1;
+		work_graph_support = WorkGraphSupport::TierNotSupported;
+		shader_model = SM_6_6;
+		enhanced_barriers_supported = false;
+		resource_aliasing_supported = true;
+		typed_uav_additional_formats_supported = true;
+		additional_shading_rates_supported = false;
+		shading_rate_image_tile_size = 0;
+		return true;
+	}
+
+	NullDevice::NullDevice(Window* window) : window(window), next_gpu_address(NULL_GPU_ADDRESS_BASE)
+	{
+		width = window ? window->Width() : NULL_DEFAULT_WIDTH;
+		height = window ? window->Height() : NULL_DEFAULT_HEIGHT;
+		capabilities.Initialize(this);
+
+		graphics_queue = std::make_unique<NullCommandQueue>(GfxCommandListType::Graphics);
+		compute_queue = std::make_unique<NullCommandQueue>(GfxCommandListType::Compute);
+		copy_queue = std::make_unique<NullCommandQueue>(GfxCommandListType::Copy);
+
+		for (Uint32 i = 0; i < GFX_BACKBUFFER_COUNT; ++i)
+		{
+			graphics_cmd_list_pool[i] = std::make_unique<GfxGraphicsCommandListPool>(this);
+			compute_cmd_list_pool[i] = std::make_unique<GfxComputeCommandListPool>(this);
+			copy_cmd_list_pool[i] = std::make_unique<GfxCopyCommandListPool>(this);
+		}
+		for (Uint32 i = 0; i < GFX_BACKBUFFER_COUNT; ++i)
+		{
+			dynamic_allocators.emplace_back(new GfxLinearDynamicAllocator(this, 1 << 20));
+		}
+		dynamic_allocator_on_init.reset(new GfxLinearDynamicAllocator(this, 1 << 30));
+
+		CreateBackbuffers();
+		ADRIA_LOG(INFO, "Null device created (%ux%u), no GPU work will be executed", width, height);
+	}
+
+	NullDevice::~NullDevice() = default;
+
+	void NullDevice::OnResize(Uint32 w, Uint32 h)
+	{
+		if ((width != w || height != h) && w > 0 && h > 0)
+		{
+			width = w;
+			height = h;
+			CreateBackbuffers();
+		}
+	}
+
+	GfxTexture* NullDevice::GetBackbuffer() const
+	{
+		return backbuffers[backbuffer_index].get();
+	}
+
+	void NullDevice::SetRenderingNotStarted()
+	{
+		rendering_not_started = true;
+		dynamic_allocator_on_init.reset(new GfxLinearDynamicAllocator(this, 1 << 30));
+	}
+
+	void NullDevice::BeginFrame()
+	{
+		ZoneScopedN("GfxDevice::BeginFrame");
+		if (rendering_not_started) [[unlikely]]
+		{
+			dynamic_allocator_on_init.reset();
+			first_frame = true;
+			rendering_not_started = false;
+		}
+		{
+			std::lock_guard<std::mutex> lock(stats_mutex);
+			frame_stats = {};
+		}
+
+		graphics_cmd_list_pool[backbuffer_index]->BeginCmdLists();
+		compute_cmd_list_pool[backbuffer_index]->BeginCmdLists();
+		copy_cmd_list_pool[backbuffer_index]->BeginCmdLists();
+		dynamic_allocators[backbuffer_index]->Clear();
+	}
+
+	void NullDevice::EndFrame()
+	{
+		ZoneScopedN("GfxDevice::EndFrame");
+		if (first_frame) [[unlikely]]
+		{
+			first_frame = false;
+		}
+
+		graphics_cmd_list_pool[backbuffer_index]->EndCmdLists();
+		compute_cmd_list_pool[backbuffer_index]->EndCmdLists();
+		copy_cmd_list_pool[backbuffer_index]->EndCmdLists();
+
+		ExecuteCommandListPool(graphics_queue.get(), *graphics_cmd_list_pool[backbuffer_index]);
+		ExecuteCommandListPool(compute_queue.get(), *compute_cmd_list_pool[backbuffer_index]);
+		ExecuteCommandListPool(copy_queue.get(), *copy_cmd_list_pool[backbuffer_index]);
+
+		{
+			std::lock_guard<std::mutex> lock(stats_mutex);
+			last_frame_stats = frame_stats;
+		}
+
+		++frame_index;
+		backbuffer_index = frame_index % GFX_BACKBUFFER_COUNT;
+	}
+
+	void* NullDevice::GetWindowHandle() const
+	{
+		return window ? window->Handle() : nullptr;
+	}
+
+	GfxCommandQueue* NullDevice::GetCommandQueue(GfxCommandListType type) const
+	{
+		switch (type)
+		{
+		case GfxCommandListType::Graphics:
+			return graphics_queue.get();
+		case GfxCommandListType::Compute:
+			return compute_queue.get();
+		case GfxCommandListType::Copy:
+			return copy_queue.get();
+		default:
+			return graphics_queue.get();
+		}
+		ADRIA_UNREACHABLE();
+	}
+
+	GfxFence& NullDevice::GetFence(GfxCommandListType type)
+	{
+		switch (type)
+		{
+		case GfxCommandListType::Graphics: return graphics_fence;
+		case GfxCommandListType::Compute:  return compute_fence;
+		case GfxCommandListType::Copy:	   return copy_fence;
+		default: ADRIA_UNREACHABLE();
+		}
+		return graphics_fence;
+	}
+
+	Uint64 NullDevice::GetFenceValue(GfxCommandListType type) const
+	{
+		switch (type)
+		{
+		case GfxCommandListType::Graphics: return graphics_fence_value;
+		case GfxCommandListType::Compute:  return compute_fence_value;
+		case GfxCommandListType::Copy:	   return copy_fence_value;
+		default: ADRIA_UNREACHABLE();
+		}
+		return graphics_fence_value;
+	}
+
+	void NullDevice::SetFenceValue(GfxCommandListType type, Uint64 value)
+	{
+		switch (type)
+		{
+		case GfxCommandListType::Graphics: graphics_fence_value = value; break;
+		case GfxCommandListType::Compute:  compute_fence_value = value; break;
+		case GfxCommandListType::Copy:	   copy_fence_value = value; break;
+		default: ADRIA_UNREACHABLE();
+		}
+	}
+
+	GfxCommandList* NullDevice::GetCommandList(GfxCommandListType type) const
+	{
+		switch (type)
+		{
+		case GfxCommandListType::Graphics:
+			return graphics_cmd_list_pool[backbuffer_index]->GetMainCmdList();
+		case GfxCommandListType::Compute:
+			return compute_cmd_list_pool[backbuffer_index]->GetMainCmdList();
+		case GfxCommandListType::Copy:
+			return copy_cmd_list_pool[backbuffer_index]->GetMainCmdList();
+		default:
+			return graphics_cmd_list_pool[backbuffer_index]->GetMainCmdList();
+		}
+		ADRIA_UNREACHABLE();
+	}
+	GfxCommandList* NullDevice::GetLatestCommandList(GfxCommandListType type) const
+	{
+		switch (type)
+		{
+		case GfxCommandListType::Graphics:
+			return graphics_cmd_list_pool[backbuffer_index]->GetLatestCmdList();
+		case GfxCommandListType::Compute:
+			return compute_cmd_list_pool[backbuffer_index]->GetLatestCmdList();
+		case GfxCommandListType::Copy:
+			return copy_cmd_list_pool[backbuffer_index]->GetLatestCmdList();
+		default:
+			return graphics_cmd_list_pool[backbuffer_index]->GetLatestCmdList();
+		}
+		ADRIA_UNREACHABLE();
+	}
+	GfxCommandList* NullDevice::AllocateCommandList(GfxCommandListType type) const
+	{
+		switch (type)
+		{
+		case GfxCommandListType::Graphics:
+			return graphics_cmd_list_pool[backbuffer_index]->AllocateCmdList();
+		case GfxCommandListType::Compute:
+			return compute_cmd_list_pool[backbuffer_index]->AllocateCmdList();
+		case GfxCommandListType::Copy:
+			return copy_cmd_list_pool[backbuffer_index]->AllocateCmdList();
+		default:
+			return graphics_cmd_list_pool[backbuffer_index]->AllocateCmdList();
+		}
+		ADRIA_UNREACHABLE();
+	}
+	void NullDevice::FreeCommandList(GfxCommandList* cmd_list, GfxCommandListType type)
+	{
+		switch (type)
+		{
+		case GfxCommandListType::Graphics:
+			return graphics_cmd_list_pool[backbuffer_index]->FreeCmdList(cmd_list);
+		case GfxCommandListType::Compute:
+			return compute_cmd_list_pool[backbuffer_index]->FreeCmdList(cmd_list);
+		case GfxCommandListType::Copy:
+			return copy_cmd_list_pool[backbuffer_index]->FreeCmdList(cmd_list);
+		default:
+			return graphics_cmd_list_pool[backbuffer_index]->FreeCmdList(cmd_list);
+		}
+		ADRIA_UNREACHABLE();
+	}
+
+	GfxLinearDynamicAllocator* NullDevice::GetDynamicAllocator() const
+	{
+		return rendering_not_started ? dynamic_allocator_on_init.get() : dynamic_allocators[backbuffer_index].get();
+	}
+
+	std::unique_ptr<GfxCommandList> NullDevice::CreateCommandList(GfxCommandListType type)
+	{
+		return std::make_unique<NullCommandList>(this, type);
+	}
+
+	std::unique_ptr<GfxTexture> NullDevice::CreateTexture(GfxTextureDesc const& desc)
+	{
+		return std::make_unique<NullTexture>(this, desc);
+	}
+	std::unique_ptr<GfxTexture> NullDevice::CreateTexture(GfxTextureDesc const& desc, GfxTextureData const&)
+	{
+		return std::make_unique<NullTexture>(this, desc);
+	}
+	std::unique_ptr<GfxTexture> NullDevice::CreateBackbufferTexture(GfxTextureDesc const& desc, void* backbuffer)
+	{
+		return std::make_unique<NullTexture>(this, desc, backbuffer);
+	}
+
+	std::unique_ptr<GfxBuffer> NullDevice::CreateBuffer(GfxBufferDesc const& desc, GfxBufferData const& initial_data)
+	{
+		return std::make_unique<NullBuffer>(this, desc, initial_data);
+	}
+	std::unique_ptr<GfxBuffer> NullDevice::CreateBuffer(GfxBufferDesc const& desc)
+	{
+		return std::make_unique<NullBuffer>(this, desc);
+	}
+	std::shared_ptr<GfxBuffer> NullDevice::CreateBufferShared(GfxBufferDesc const& desc, GfxBufferData const& initial_data)
+	{
+		return std::make_shared<NullBuffer>(this, desc, initial_data);
+	}
+	std::shared_ptr<GfxBuffer> NullDevice::CreateBufferShared(GfxBufferDesc const& desc)
+	{
+		return std::make_shared<NullBuffer>(this, desc);
+	}
+
+	std::unique_ptr<GfxHeap> NullDevice::CreateHeap(GfxHeapDesc const& desc)
+	{
+		return std::make_unique<NullHeap>(this, desc);
+	}
+	std::unique_ptr<GfxTexture> NullDevice::CreatePlacedTexture(GfxTextureDesc const& desc, GfxHeap*, Uint64)
+	{
+		return std::make_unique<NullTexture>(this, desc);
+	}
+	std::unique_ptr<GfxBuffer> NullDevice::CreatePlacedBuffer(GfxBufferDesc const& desc, GfxHeap*, Uint64)
+	{
+		ADRIA_ASSERT_MSG(desc.resource_usage == GfxResourceUsage::Default, "Only default heap buffers can be placed!");
+		return std::make_unique<NullBuffer>(this, desc);
+	}
+
+	std::unique_ptr<GfxPipelineState> NullDevice::CreateGraphicsPipelineState(GfxGraphicsPipelineStateDesc const&)
+	{
+		return std::make_unique<NullPipelineState>(GfxPipelineStateType::Graphics);
+	}
+	std::unique_ptr<GfxPipelineState> NullDevice::CreateComputePipelineState(GfxComputePipelineStateDesc const&)
+	{
+		return std::make_unique<NullPipelineState>(GfxPipelineStateType::Compute);
+	}
+	std::unique_ptr<GfxPipelineState> NullDevice::CreateMeshShaderPipelineState(GfxMeshShaderPipelineStateDesc const&)
+	{
+		return std::make_unique<NullPipelineState>(GfxPipelineStateType::MeshShader);
+	}
+	std::unique_ptr<GfxFence> NullDevice::CreateFence(Char const* name)
+	{
+		std::unique_ptr<GfxFence> fence = std::make_unique<NullFence>();
+		fence->Create(this, name);
+		return fence;
+	}
+	std::unique_ptr<GfxQueryHeap> NullDevice::CreateQueryHeap(GfxQueryHeapDesc const& desc)
+	{
+		return std::make_unique<NullQueryHeap>(this, desc);
+	}
+	std::unique_ptr<GfxRayTracingTLAS> NullDevice::CreateRayTracingTLAS(std::span<GfxRayTracingInstance> instances, GfxRayTracingASFlags flags)
+	{
+		return std::make_unique<NullRayTracingTLAS>(this, instances, flags);
+	}
+	std::unique_ptr<GfxRayTracingBLAS> NullDevice::CreateRayTracingBLAS(std::span<GfxRayTracingGeometry> geometries, GfxRayTracingASFlags flags)
+	{
+		return std::make_unique<NullRayTracingBLAS>(this, geometries, flags);
+	}
+	std::unique_ptr<GfxRayTracingPipeline> NullDevice::CreateRayTracingPipeline(GfxRayTracingPipelineDesc const&)
+	{
+		return std::make_unique<NullRayTracingPipeline>();
+	}
+
+	Uint64 NullDevice::GetLinearBufferSize(GfxTexture const* texture) const
+	{
+		ADRIA_ASSERT(texture);
+		GfxTextureDesc const& desc = texture->GetDesc();
+		Uint64 const row_pitch = GetRowPitch(desc.format, desc.width);
+		Uint64 const row_count = GetSlicePitch(desc.format, desc.width, desc.height) / row_pitch;
+		return AlignUp(row_pitch, NULL_ROW_PITCH_ALIGNMENT) * row_count;
+	}
+	Uint64 NullDevice::GetLinearBufferSize(GfxBuffer const* buffer) const
+	{
+		ADRIA_ASSERT(buffer);
+		return buffer->GetSize();
+	}
+
+	GfxAllocationInfo NullDevice::GetAllocationInfo(GfxTextureDesc const& desc) const
+	{
+		Uint32 const depth = desc.type == GfxTextureType_3D ? desc.depth : 1;
+		Uint32 const mip_levels = desc.mip_levels ? desc.mip_levels : (Uint32)log2(std::max<Uint32>(desc.width, desc.height)) + 1;
+		Uint64 const size = GetTextureByteSize(desc.format, desc.width, desc.height, depth, mip_levels) * desc.array_size * desc.sample_count;
+		return GfxAllocationInfo{ .size = AlignUp(size, NULL_RESOURCE_ALIGNMENT), .alignment = NULL_RESOURCE_ALIGNMENT };
+	}
+	GfxAllocationInfo NullDevice::GetAllocationInfo(GfxBufferDesc const& desc) const
+	{
+		return GfxAllocationInfo{ .size = AlignUp(desc.size, NULL_RESOURCE_ALIGNMENT), .alignment = NULL_RESOURCE_ALIGNMENT };
+	}
+
+	void NullDevice::GetTimestampFrequency(Uint64& frequency) const
+	{
+		frequency = graphics_queue->GetTimestampFrequency();
+	}
+
+	Uint64 NullDevice::AllocateGpuAddress(Uint64 size)
+	{
+		return next_gpu_address.fetch_add(AlignUp(std::max<Uint64>(size, 1), NULL_RESOURCE_ALIGNMENT), std::memory_order_relaxed);
+	}
+
+	void NullDevice::AddFrameStats(NullFrameStats const& stats)
+	{
+		std::lock_guard<std::mutex> lock(stats_mutex);
+		frame_stats += stats;
+	}
+
+	GfxDescriptor NullDevice::AllocateDescriptor()
+	{
+		GfxDescriptor descriptor{};
+		descriptor.opaque_data[0] = next_descriptor_index.fetch_add(1, std::memory_order_relaxed);
+		return descriptor;
+	}
+
+	void NullDevice::CreateBackbuffers()
+	{
+		for (Uint32 i = 0; i < GFX_BACKBUFFER_COUNT; ++i)
+		{
+			GfxTextureDesc backbuffer_desc{};
+			backbuffer_desc.width = width;
+			backbuffer_desc.height = height;
+			backbuffer_desc.format = GfxFormat::R8G8B8A8_UNORM_SRGB;
+			backbuffer_desc.initial_state = GfxResourceState::Present;
+			backbuffer_desc.clear_value = GfxClearValue(0.0f, 0.0f, 0.0f, 0.0f);
+			backbuffer_desc.bind_flags = GfxBindFlag::RenderTarget;
+			backbuffers[i] = CreateBackbufferTexture(backbuffer_desc, nullptr);
+		}
+	}
+
+	void NullDevice::AddToReleaseQueue_Internal(ReleasableObject* _obj)
+	{
+		//nothing can still be in flight, so deferred releases happen right away
+		delete _obj;
+	}
+}
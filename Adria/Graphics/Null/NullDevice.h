@@ -0,0 +1,153 @@
+#pragma once
+#include <atomic>
+#include "NullFence.h"
+#include "NullCommandList.h"
+#include "Graphics/GfxDevice.h"
+#include "Graphics/GfxCapabilities.h"
+#include "Graphics/GfxCommandListPool.h"
+#include "Graphics/GfxShadingRate.h"
+
+namespace adria
+{
+	class NullCommandQueue;
+
+	struct NullCapabilities : GfxCapabilities
+	{
+		virtual Bool Initialize(GfxDevice* gfx) override;
+	};
+
+	//device without a gpu behind it: every frame is recorded and counted but nothing executes,
+	//which leaves only the cpu side of the renderer to measure
+	class NullDevice final : public GfxDevice
+	{
+	public:
+		explicit NullDevice(Window* window);
+		~NullDevice() override;
+
+		void OnResize(Uint32 w, Uint32 h) override;
+		GfxTexture* GetBackbuffer() const override;
+		Uint32 GetBackbufferIndex() const override { return backbuffer_index; }
+		Uint32 GetFrameIndex() const override { return frame_index; }
+		constexpr Uint32 GetBackbufferCount() const override { return GFX_BACKBUFFER_COUNT; }
+
+		void SetRenderingNotStarted() override;
+
+		void Update() override {}
+		void BeginFrame() override;
+		void EndFrame() override;
+		Bool IsFirstFrame() override { return first_frame; }
+
+		void* GetNative() const override { return nullptr; }
+		void* GetWindowHandle() const override;
+
+		GfxCapabilities const& GetCapabilities() const override { return capabilities; }
+		GfxVendor GetVendor() const override { return GfxVendor::Unknown; }
+		GfxBackend GetBackend() const override { return GfxBackend::Null; }
+
+		GfxNsightPerfManager* GetNsightPerfManager() const override { return nullptr; }
+
+		void WaitForGPU() override {}
+		GfxCommandQueue* GetCommandQueue(GfxCommandListType type) const override;
+		GfxFence& GetFence(GfxCommandListType type) override;
+		Uint64 GetFenceValue(GfxCommandListType type) const override;
+		void SetFenceValue(GfxCommandListType type, Uint64 value) override;
+
+		GfxCommandList* GetCommandList(GfxCommandListType type) const override;
+		GfxCommandList* GetLatestCommandList(GfxCommandListType type) const override;
+		GfxCommandList* AllocateCommandList(GfxCommandListType type) const override;
+		void FreeCommandList(GfxCommandList*, GfxCommandListType type) override;
+
+		GfxLinearDynamicAllocator* GetDynamicAllocator() const override;
+
+		void FreeCPUDescriptor(GfxDescriptor) override {}
+		Uint32 GetBindlessDescriptorIndex(GfxDescriptor descriptor) const override { return static_cast<Uint32>(descriptor.opaque_data[0]); }
+
+		std::unique_ptr<GfxCommandList> CreateCommandList(GfxCommandListType type) override;
+		std::unique_ptr<GfxTexture> CreateTexture(GfxTextureDesc const& desc) override;
+		std::unique_ptr<GfxTexture> CreateTexture(GfxTextureDesc const& desc, GfxTextureData const& data) override;
+		std::unique_ptr<GfxTexture> CreateBackbufferTexture(GfxTextureDesc const& desc, void* backbuffer) override;
+		std::unique_ptr<GfxBuffer>  CreateBuffer(GfxBufferDesc const& desc, GfxBufferData const& initial_data) override;
+		std::unique_ptr<GfxBuffer>  CreateBuffer(GfxBufferDesc const& desc) override;
+
+		std::shared_ptr<GfxBuffer>  CreateBufferShared(GfxBufferDesc const& desc, GfxBufferData const& initial_data) override;
+		std::shared_ptr<GfxBuffer>  CreateBufferShared(GfxBufferDesc const& desc) override;
+
+		std::unique_ptr<GfxHeap>	CreateHeap(GfxHeapDesc const& desc) override;
+		std::unique_ptr<GfxTexture> CreatePlacedTexture(GfxTextureDesc const& desc, GfxHeap* heap, Uint64 heap_offset) override;
+		std::unique_ptr<GfxBuffer>  CreatePlacedBuffer(GfxBufferDesc const& desc, GfxHeap* heap, Uint64 heap_offset) override;
+
+		std::unique_ptr<GfxPipelineState> CreateGraphicsPipelineState(GfxGraphicsPipelineStateDesc const& desc) override;
+		std::unique_ptr<GfxPipelineState> CreateComputePipelineState(GfxComputePipelineStateDesc const& desc) override;
+		std::unique_ptr<GfxPipelineState> CreateMeshShaderPipelineState(GfxMeshShaderPipelineStateDesc const& desc) override;
+		std::unique_ptr<GfxFence> CreateFence(Char const* name) override;
+		std::unique_ptr<GfxQueryHeap> CreateQueryHeap(GfxQueryHeapDesc const& desc) override;
+		std::unique_ptr<GfxRayTracingTLAS> CreateRayTracingTLAS(std::span<GfxRayTracingInstance> instances, GfxRayTracingASFlags flags) override;
+		std::unique_ptr<GfxRayTracingBLAS> CreateRayTracingBLAS(std::span<GfxRayTracingGeometry> geometries, GfxRayTracingASFlags flags) override;
+		std::unique_ptr<GfxRayTracingPipeline> CreateRayTracingPipeline(GfxRayTracingPipelineDesc const& desc) override;
+
+		GfxDescriptor CreateBufferSRV(GfxBuffer const*, GfxBufferDescriptorDesc const* = nullptr) override { return AllocateDescriptor(); }
+		GfxDescriptor CreateBufferUAV(GfxBuffer const*, GfxBufferDescriptorDesc const* = nullptr) override { return AllocateDescriptor(); }
+		GfxDescriptor CreateBufferUAV(GfxBuffer const*, GfxBuffer const*, GfxBufferDescriptorDesc const* = nullptr) override { return AllocateDescriptor(); }
+		GfxDescriptor CreateTextureSRV(GfxTexture const*, GfxTextureDescriptorDesc const* = nullptr) override { return AllocateDescriptor(); }
+		GfxDescriptor CreateTextureUAV(GfxTexture const*, GfxTextureDescriptorDesc const* = nullptr) override { return AllocateDescriptor(); }
+		GfxDescriptor CreateTextureRTV(GfxTexture const*, GfxTextureDescriptorDesc const* = nullptr) override { return AllocateDescriptor(); }
+		GfxDescriptor CreateTextureDSV(GfxTexture const*, GfxTextureDescriptorDesc const* = nullptr) override { return AllocateDescriptor(); }
+
+		Uint64 GetLinearBufferSize(GfxTexture const* texture) const override;
+		Uint64 GetLinearBufferSize(GfxBuffer const* buffer) const override;
+		GfxAllocationInfo GetAllocationInfo(GfxTextureDesc const& desc) const override;
+		GfxAllocationInfo GetAllocationInfo(GfxBufferDesc const& desc) const override;
+
+		GfxShadingRateInfo const& GetShadingRateInfo() const override { return shading_rate_info; }
+		void SetShadingRateInfo(GfxShadingRateInfo const& info) override { shading_rate_info = info; }
+
+		void GetTimestampFrequency(Uint64& frequency) const override;
+		GPUMemoryUsage GetMemoryUsage() const override { return { 0, 0 }; }
+
+		Uint64 AllocateGpuAddress(Uint64 size);
+		void AddFrameStats(NullFrameStats const& stats);
+		NullFrameStats const& GetLastFrameStats() const { return last_frame_stats; }
+
+	private:
+		Window* window = nullptr;
+		Uint32 width = 0;
+		Uint32 height = 0;
+
+		std::unique_ptr<NullCommandQueue> graphics_queue;
+		std::unique_ptr<NullCommandQueue> compute_queue;
+		std::unique_ptr<NullCommandQueue> copy_queue;
+
+		NullFence graphics_fence;
+		Uint64 graphics_fence_value = 0;
+		NullFence compute_fence;
+		Uint64 compute_fence_value = 0;
+		NullFence copy_fence;
+		Uint64 copy_fence_value = 0;
+
+		std::unique_ptr<GfxTexture> backbuffers[GFX_BACKBUFFER_COUNT];
+		std::unique_ptr<GfxGraphicsCommandListPool> graphics_cmd_list_pool[GFX_BACKBUFFER_COUNT];
+		std::unique_ptr<GfxComputeCommandListPool> compute_cmd_list_pool[GFX_BACKBUFFER_COUNT];
+		std::unique_ptr<GfxCopyCommandListPool> copy_cmd_list_pool[GFX_BACKBUFFER_COUNT];
+		std::vector<std::unique_ptr<GfxLinearDynamicAllocator>> dynamic_allocators;
+		std::unique_ptr<GfxLinearDynamicAllocator> dynamic_allocator_on_init;
+
+		Uint32 frame_index = 0;
+		Uint32 backbuffer_index = 0;
+		Bool first_frame = false;
+		Bool rendering_not_started = true;
+		NullCapabilities capabilities;
+		GfxShadingRateInfo shading_rate_info;
+
+		std::atomic<Uint64> next_descriptor_index = 0;
+		std::atomic<Uint64> next_gpu_address;
+
+		std::mutex stats_mutex;
+		NullFrameStats frame_stats;
+		NullFrameStats last_frame_stats;
+
+	private:
+		GfxDescriptor AllocateDescriptor();
+		void CreateBackbuffers();
+		void AddToReleaseQueue_Internal(ReleasableObject* _obj) override;
+	};
+}
@@ -0,0 +1,25 @@
+#pragma once
+#include <atomic>
+#include "Graphics/GfxFence.h"
+
+namespace adria
+{
+	//work submitted to the null device completes immediately, so signaling is all a fence has to track
+	class NullFence final : public GfxFence
+	{
+	public:
+		virtual Bool Create(GfxDevice*, Char const*) override { return true; }
+		virtual void Wait(Uint64) override {}
+		virtual void Signal(Uint64 value) override
+		{
+			Uint64 completed = completed_value.load(std::memory_order_relaxed);
+			while (completed < value && !completed_value.compare_exchange_weak(completed, value, std::memory_order_relaxed));
+		}
+		virtual Bool IsCompleted(Uint64 value) override { return GetCompletedValue() >= value; }
+		virtual Uint64 GetCompletedValue() const override { return completed_value.load(std::memory_order_relaxed); }
+		virtual void* GetHandle() const override { return nullptr; }
+
+	private:
+		std::atomic<Uint64> completed_value = 0;
+	};
+}
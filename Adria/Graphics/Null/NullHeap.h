@@ -0,0 +1,13 @@
+#pragma once
+#include "Graphics/GfxHeap.h"
+
+namespace adria
+{
+	class NullHeap final : public GfxHeap
+	{
+	public:
+		NullHeap(GfxDevice* gfx, GfxHeapDesc const& desc) : GfxHeap(gfx, desc) {}
+
+		virtual void* GetHandle() const override { return nullptr; }
+	};
+}
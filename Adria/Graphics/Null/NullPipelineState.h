@@ -0,0 +1,18 @@
+#pragma once
+#include "Graphics/GfxPipelineState.h"
+
+namespace adria
+{
+	//never asks the shader manager for bytecode, so the null device runs without a shader compiler
+	class NullPipelineState final : public GfxPipelineState
+	{
+	public:
+		explicit NullPipelineState(GfxPipelineStateType type) : type(type) {}
+
+		virtual GfxPipelineStateType GetType() const override { return type; }
+		virtual void* GetNative() const override { return nullptr; }
+
+	private:
+		GfxPipelineStateType type;
+	};
+}
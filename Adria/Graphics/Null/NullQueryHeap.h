@@ -0,0 +1,13 @@
+#pragma once
+#include "Graphics/GfxQueryHeap.h"
+
+namespace adria
+{
+	class NullQueryHeap final : public GfxQueryHeap
+	{
+	public:
+		NullQueryHeap(GfxDevice* gfx, GfxQueryHeapDesc const& desc) : GfxQueryHeap(gfx, desc) {}
+
+		virtual void* GetHandle() const override { return nullptr; }
+	};
+}
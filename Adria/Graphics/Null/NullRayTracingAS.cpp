@@ -0,0 +1,48 @@
+#include "NullRayTracingAS.h"
+#include "Graphics/GfxDevice.h"
+#include "Graphics/GfxBuffer.h"
+
+namespace adria
+{
+	namespace
+	{
+		//rough size of a bvh node per primitive, only used to give the result buffer a plausible footprint
+		constexpr Uint64 BYTES_PER_PRIMITIVE = 64;
+
+		std::unique_ptr<GfxBuffer> CreateResultBuffer(GfxDevice* gfx, Uint64 primitive_count)
+		{
+			GfxBufferDesc desc{};
+			desc.size = std::max<Uint64>(primitive_count * BYTES_PER_PRIMITIVE, BYTES_PER_PRIMITIVE);
+			desc.bind_flags = GfxBindFlag::ShaderResource | GfxBindFlag::UnorderedAccess;
+			desc.misc_flags = GfxBufferMiscFlag::AccelStruct;
+			return gfx->CreateBuffer(desc);
+		}
+	}
+
+	NullRayTracingBLAS::NullRayTracingBLAS(GfxDevice* gfx, std::span<GfxRayTracingGeometry> geometries, GfxRayTracingASFlags)
+	{
+		Uint64 primitive_count = 0;
+		for (GfxRayTracingGeometry const& geometry : geometries)
+		{
+			primitive_count += (geometry.index_count ? geometry.index_count : geometry.vertex_count) / 3;
+		}
+		result_buffer = CreateResultBuffer(gfx, primitive_count);
+	}
+	NullRayTracingBLAS::~NullRayTracingBLAS() = default;
+
+	Uint64 NullRayTracingBLAS::GetGpuAddress() const
+	{
+		return result_buffer->GetGpuAddress();
+	}
+
+	NullRayTracingTLAS::NullRayTracingTLAS(GfxDevice* gfx, std::span<GfxRayTracingInstance> instances, GfxRayTracingASFlags)
+	{
+		result_buffer = CreateResultBuffer(gfx, instances.size());
+	}
+	NullRayTracingTLAS::~NullRayTracingTLAS() = default;
+
+	Uint64 NullRayTracingTLAS::GetGpuAddress() const
+	{
+		return result_buffer->GetGpuAddress();
+	}
+}
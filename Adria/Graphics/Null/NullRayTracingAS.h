@@ -0,0 +1,31 @@
+#pragma once
+#include "Graphics/GfxRayTracingAS.h"
+
+namespace adria
+{
+	class NullRayTracingBLAS final : public GfxRayTracingBLAS
+	{
+	public:
+		NullRayTracingBLAS(GfxDevice* gfx, std::span<GfxRayTracingGeometry> geometries, GfxRayTracingASFlags flags);
+		virtual ~NullRayTracingBLAS() override;
+
+		virtual Uint64 GetGpuAddress() const override;
+		virtual GfxBuffer const& GetBuffer() const override { return *result_buffer; }
+
+	private:
+		std::unique_ptr<GfxBuffer> result_buffer;
+	};
+
+	class NullRayTracingTLAS final : public GfxRayTracingTLAS
+	{
+	public:
+		NullRayTracingTLAS(GfxDevice* gfx, std::span<GfxRayTracingInstance> instances, GfxRayTracingASFlags flags);
+		virtual ~NullRayTracingTLAS() override;
+
+		virtual Uint64 GetGpuAddress() const override;
+		virtual GfxBuffer const& GetBuffer() const override { return *result_buffer; }
+
+	private:
+		std::unique_ptr<GfxBuffer> result_buffer;
+	};
+}
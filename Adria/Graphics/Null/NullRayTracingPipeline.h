@@ -0,0 +1,48 @@
+#pragma once
+#include "Graphics/GfxRayTracingPipeline.h"
+#include "Graphics/GfxRayTracingShaderBindings.h"
+
+namespace adria
+{
+	class NullRayTracingPipeline final : public GfxRayTracingPipeline
+	{
+	public:
+		NullRayTracingPipeline() = default;
+
+		virtual Bool IsValid() const override { return true; }
+		virtual void* GetNative() const override { return nullptr; }
+		virtual Bool HasShader(Char const*) const override { return true; }
+	};
+
+	//hands out sequential indices so passes that build shader tables see the same layout as on a real device
+	class NullRayTracingShaderBindings final : public GfxRayTracingShaderBindings
+	{
+	public:
+		NullRayTracingShaderBindings() = default;
+
+		virtual void SetRayGenShader(Char const*, void const* = nullptr, Uint32 = 0) override {}
+		virtual GfxShaderGroupHandle AddMissShader(Char const*, void const* = nullptr, Uint32 = 0) override
+		{
+			return GfxShaderGroupHandle(miss_shader_count++);
+		}
+		virtual GfxShaderGroupHandle AddHitGroup(Char const*, void const* = nullptr, Uint32 = 0) override
+		{
+			return GfxShaderGroupHandle(hit_group_count++);
+		}
+		virtual GfxShaderGroupHandle AddCallableShader(Char const*, void const* = nullptr, Uint32 = 0) override
+		{
+			return GfxShaderGroupHandle(callable_shader_count++);
+		}
+
+		virtual void Commit() override {}
+
+		virtual Uint32 GetMissShaderIndex(GfxShaderGroupHandle handle) const override { return handle.index; }
+		virtual Uint32 GetHitGroupIndex(GfxShaderGroupHandle handle) const override { return handle.index; }
+		virtual Uint32 GetCallableShaderIndex(GfxShaderGroupHandle handle) const override { return handle.index; }
+
+	private:
+		Uint32 miss_shader_count = 0;
+		Uint32 hit_group_count = 0;
+		Uint32 callable_shader_count = 0;
+	};
+}
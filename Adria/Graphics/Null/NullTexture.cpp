@@ -0,0 +1,30 @@
+#include "NullTexture.h"
+#include "NullDevice.h"
+
+namespace adria
+{
+	NullTexture::NullTexture(GfxDevice* gfx, GfxTextureDesc const& desc) : GfxTexture(gfx, desc)
+	{
+		if (this->desc.mip_levels == 0)
+		{
+			this->desc.mip_levels = (Uint32)log2(std::max<Uint32>(desc.width, desc.height)) + 1;
+		}
+		Uint64 const size = gfx->GetAllocationInfo(this->desc).size;
+		gpu_address = static_cast<NullDevice*>(gfx)->AllocateGpuAddress(size);
+		if (desc.heap_type == GfxResourceUsage::Upload || desc.heap_type == GfxResourceUsage::Readback)
+		{
+			memory.reset(desc.heap_type == GfxResourceUsage::Readback ? new Uint8[size]() : new Uint8[size]);
+			mapped_data = memory.get();
+		}
+	}
+
+	NullTexture::NullTexture(GfxDevice* gfx, GfxTextureDesc const& desc, void* backbuffer) : GfxTexture(gfx, desc, backbuffer)
+	{
+		gpu_address = static_cast<NullDevice*>(gfx)->AllocateGpuAddress(gfx->GetAllocationInfo(desc).size);
+	}
+
+	Uint32 NullTexture::GetRowPitch(Uint32 mip_level) const
+	{
+		return static_cast<Uint32>(adria::GetRowPitch(desc.format, desc.width, mip_level));
+	}
+}
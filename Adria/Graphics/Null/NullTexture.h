@@ -0,0 +1,24 @@
+#pragma once
+#include "Graphics/GfxTexture.h"
+
+namespace adria
+{
+	class NullTexture final : public GfxTexture
+	{
+	public:
+		NullTexture(GfxDevice* gfx, GfxTextureDesc const& desc);
+		NullTexture(GfxDevice* gfx, GfxTextureDesc const& desc, void* backbuffer);
+
+		virtual void* GetNative() const override { return nullptr; }
+		virtual void* GetSharedHandle() const override { return nullptr; }
+		virtual Uint64 GetGpuAddress() const override { return gpu_address; }
+		virtual void* Map() override { return mapped_data; }
+		virtual void Unmap() override {}
+		virtual void SetName(Char const*) override {}
+		virtual Uint32 GetRowPitch(Uint32 mip_level = 0) const override;
+
+	private:
+		std::unique_ptr<Uint8[]> memory;
+		Uint64 gpu_address = 0;
+	};
+}
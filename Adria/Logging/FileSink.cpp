@@ -9,6 +9,15 @@ namespace adria
 	FileSink::FileSink(Char const* log_file, LogLevel log_level, Bool append_mode)
 		: log_level{ log_level }
 	{
+		for (Uint32 i = 0; i < std::size(level_strings); ++i)
+		{
+			level_strings[i] = LevelToString((LogLevel)i);
+		}
+		for (Uint32 i = 0; i < std::size(channel_strings); ++i)
+		{
+			channel_strings[i] = ChannelToString((LogChannel)i);
+		}
+
 		fs::path fullLogPath = fs::path(paths::LogDir) / log_file;
 		fs::path directoryPath = fullLogPath.parent_path();
 		if (!directoryPath.empty() && !fs::exists(directoryPath))
@@ -41,17 +50,22 @@ namespace adria
 			return;
 		}
 
-		std::string const time_str = GetLogTime();
-		std::string const line_info_str = LineInfoToString(file, line);
-		std::string const level_str = LevelToString(level);
-		std::string const channel_str = ChannelToString(channel);
+		//sinks can be called from several threads through LogSync, so the cache is per thread
+		thread_local time_t cached_time = 0;
+		thread_local Char cached_time_str[32] = {};
+		time_t const current_time = std::chrono::system_clock::to_time_t(std::chrono::system_clock::now());
+		if (current_time != cached_time)
+		{
+			cached_time = current_time;
+			snprintf(cached_time_str, sizeof(cached_time_str), "%s", GetLogTime().c_str());
+		}
 
-		fprintf(log_handle, "%s%s%s%s%s\n",
-			time_str.c_str(),
-			line_info_str.c_str(),
-			level_str.c_str(),
-			channel_str.c_str(),
-			entry); 
+		fprintf(log_handle, "%s[File: %s  Line: %u]%s%s%s\n",
+			cached_time_str,
+			file, line,
+			level_strings[(Uint32)level].c_str(),
+			channel_strings[(Uint32)channel].c_str(),
+			entry);
 	}
 
 	void FileSink::Flush()
@@ -16,5 +16,7 @@ namespace adria
 	private:
 		FILE* log_handle = nullptr;
 		LogLevel const log_level;
+		std::string level_strings[(Uint32)LogLevel::LOG_FATAL + 1];
+		std::string channel_strings[(Uint32)LogChannel::MaxCount];
 	};
 }
\ No newline at end of file
@@ -1,26 +1,43 @@
 #include <ctime>
+#include <cstdarg>
 #include "Log.h"
-#include "Utilities/ConcurrentQueue.h"
 
 namespace adria
 {
-	struct QueueEntry
+	static constexpr Uint64 LogRecordSize = 256;
+	static constexpr Uint64 LogRecordCapacity = 4096;
+
+	//fixed size record, messages that do not fit the inline storage are copied to the heap
+	struct alignas(64) LogRecord
 	{
+		std::atomic<Uint64> sequence;
+		Char const* file;
+		Char* long_message;
+		Uint32 line;
 		LogLevel level;
 		LogChannel channel;
-		std::string str;
-		std::string filename;
-		Uint32 line;
+		Char message[LogRecordSize - 32];
 	};
+	static_assert(sizeof(LogRecord) == LogRecordSize);
 
+	//bounded multi producer single consumer ring, every slot carries a sequence number that tells producers and the consumer whose turn it is
 	class LogManagerImpl
 	{
 	public:
 
-		LogManagerImpl() : log_thread(&LogManagerImpl::ProcessLogs, this) {}
+		LogManagerImpl() : records(std::make_unique<LogRecord[]>(LogRecordCapacity))
+		{
+			for (Uint64 i = 0; i < LogRecordCapacity; ++i)
+			{
+				records[i].sequence.store(i, std::memory_order_relaxed);
+				records[i].long_message = nullptr;
+			}
+			log_thread = std::thread(&LogManagerImpl::ProcessLogs, this);
+		}
 		~LogManagerImpl()
 		{
 			exit.store(true);
+			WakeConsumer();
 			log_thread.join();
 		}
 
@@ -34,7 +51,39 @@ namespace adria
 		}
 		void Log(LogLevel level, LogChannel channel, Char const* str, Char const* filename, Uint32 line)
 		{
-			log_queue.Push(QueueEntry{ level, channel, str, filename, line });
+			Uint64 position;
+			LogRecord& record = BeginRecord(level, channel, filename, line, position);
+			Uint64 const length = strlen(str);
+			if (length < sizeof(record.message))
+			{
+				memcpy(record.message, str, length + 1);
+			}
+			else
+			{
+				record.long_message = new Char[length + 1];
+				memcpy(record.long_message, str, length + 1);
+			}
+			EndRecord(record, position);
+		}
+		void LogFormat(LogLevel level, LogChannel channel, Char const* filename, Uint32 line, Char const* format, va_list args)
+		{
+			va_list args_copy;
+			va_copy(args_copy, args);
+
+			Uint64 position;
+			LogRecord& record = BeginRecord(level, channel, filename, line, position);
+			Int const length = vsnprintf(record.message, sizeof(record.message), format, args);
+			if (length >= (Int)sizeof(record.message))
+			{
+				record.long_message = new Char[length + 1];
+				vsnprintf(record.long_message, length + 1, format, args_copy);
+			}
+			else if (length < 0)
+			{
+				record.message[0] = '\0';
+			}
+			EndRecord(record, position);
+			va_end(args_copy);
 		}
 		void LogSync(LogLevel level, LogChannel channel, Char const* str, Char const* filename, Uint32 line)
 		{
@@ -48,46 +97,145 @@ namespace adria
 		}
 		void Flush()
 		{
-			pause.store(true);
-			for (auto& logger : log_sinks)
+			//the consumer flushes the sinks once it has written everything logged before this call
+			Uint64 const target = enqueue_position.load(std::memory_order_acquire);
+			do
 			{
-				logger->Flush();
-			}
-			pause.store(false);
+				Uint32 const flush_epoch = flush_count.load(std::memory_order_acquire);
+				flush_requested.store(true, std::memory_order_release);
+				WakeConsumer();
+				flush_count.wait(flush_epoch, std::memory_order_acquire);
+			} while (flushed_position.load(std::memory_order_acquire) < target);
 		}
 
+	private:
 		std::vector<std::unique_ptr<ILogSink>> log_sinks;
-		ConcurrentQueue<QueueEntry> log_queue;
+		std::unique_ptr<LogRecord[]> records;
+		alignas(64) std::atomic<Uint64> enqueue_position = 0;
+		alignas(64) Uint64 dequeue_position = 0;
+		std::atomic<Uint64> flushed_position = 0;
+		std::atomic<Uint32> flush_count = 0;
+		std::atomic<Bool> flush_requested = false;
+		std::atomic<Uint32> wake_epoch = 0;
+		std::atomic<Bool> consumer_sleeping = false;
+		std::atomic<Bool> exit = false;
 		std::thread log_thread;
-		std::atomic_bool exit = false;
-		std::atomic_bool pause = false;
 
 	private:
+		LogRecord& BeginRecord(LogLevel level, LogChannel channel, Char const* filename, Uint32 line, Uint64& position)
+		{
+			position = enqueue_position.load(std::memory_order_relaxed);
+			while (true)
+			{
+				LogRecord& record = records[position & (LogRecordCapacity - 1)];
+				Int64 const diff = (Int64)record.sequence.load(std::memory_order_acquire) - (Int64)position;
+				if (diff == 0)
+				{
+					if (enqueue_position.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+					{
+						record.level = level;
+						record.channel = channel;
+						record.file = filename;
+						record.line = line;
+						return record;
+					}
+				}
+				else if (diff < 0)
+				{
+					//ring is full, let the consumer catch up
+					WakeConsumer();
+					std::this_thread::yield();
+					position = enqueue_position.load(std::memory_order_relaxed);
+				}
+				else
+				{
+					position = enqueue_position.load(std::memory_order_relaxed);
+				}
+			}
+		}
+		void EndRecord(LogRecord& record, Uint64 position)
+		{
+			record.sequence.store(position + 1, std::memory_order_release);
+			WakeConsumer();
+		}
+
+		void WakeConsumer()
+		{
+			std::atomic_thread_fence(std::memory_order_seq_cst);
+			if (consumer_sleeping.load(std::memory_order_relaxed))
+			{
+				wake_epoch.fetch_add(1, std::memory_order_relaxed);
+				wake_epoch.notify_one();
+			}
+		}
+
+		Bool HasRecord() const
+		{
+			LogRecord const& record = records[dequeue_position & (LogRecordCapacity - 1)];
+			return record.sequence.load(std::memory_order_acquire) == dequeue_position + 1;
+		}
+
+		Bool ProcessRecord()
+		{
+			if (!HasRecord())
+			{
+				return false;
+			}
+
+			LogRecord& record = records[dequeue_position & (LogRecordCapacity - 1)];
+			Char const* message = record.long_message ? record.long_message : record.message;
+			for (auto& log_sink : log_sinks)
+			{
+				if (log_sink)
+				{
+					log_sink->Log(record.level, record.channel, message, record.file, record.line);
+				}
+			}
+			delete[] record.long_message;
+			record.long_message = nullptr;
+			record.sequence.store(dequeue_position + LogRecordCapacity, std::memory_order_release);
+			++dequeue_position;
+			return true;
+		}
+
 		void ProcessLogs()
 		{
-			QueueEntry entry{};
 			while (true)
 			{
-				if (pause.load())
+				Bool processed = false;
+				while (ProcessRecord())
 				{
-					continue;
+					processed = true;
 				}
 
-				Bool success = log_queue.TryPop(entry);
-				if (success)
+				if (flush_requested.exchange(false, std::memory_order_acq_rel))
 				{
 					for (auto& log_sink : log_sinks)
 					{
-						if (log_sink)
-						{
-							log_sink->Log(entry.level, entry.channel, entry.str.c_str(), entry.filename.c_str(), entry.line);
-						}
+						log_sink->Flush();
 					}
+					flushed_position.store(dequeue_position, std::memory_order_release);
+					flush_count.fetch_add(1, std::memory_order_release);
+					flush_count.notify_all();
+					continue;
+				}
+				if (processed)
+				{
+					continue;
 				}
-				if (exit.load() && log_queue.Empty())
+				if (exit.load(std::memory_order_acquire))
 				{
 					break;
 				}
+
+				consumer_sleeping.store(true, std::memory_order_seq_cst);
+				std::atomic_thread_fence(std::memory_order_seq_cst);
+				Uint32 const epoch = wake_epoch.load(std::memory_order_seq_cst);
+				if (!HasRecord() && !flush_requested.load(std::memory_order_acquire) && !exit.load(std::memory_order_acquire))
+				{
+					wake_epoch.wait(epoch, std::memory_order_seq_cst);
+				}
+				consumer_sleeping.store(false, std::memory_order_relaxed);
 			}
 		}
 	};
@@ -153,6 +301,14 @@ namespace adria
 		pimpl->Log(level, channel, str, filename, line);
 	}
 
+	void LogManager::LogFormat(LogLevel level, LogChannel channel, Char const* filename, Uint32 line, Char const* format, ...)
+	{
+		va_list args;
+		va_start(args, format);
+		pimpl->LogFormat(level, channel, filename, line, format, args);
+		va_end(args);
+	}
+
 	void LogManager::LogSync(LogLevel level, LogChannel channel, Char const* str, Char const* filename, Uint32 line)
 	{
 		pimpl->LogSync(level, channel, str, filename, line);
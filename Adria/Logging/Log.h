@@ -46,7 +46,9 @@ namespace adria
 			Register(new LogSinkT(std::forward<Args>(args)...));
 			return static_cast<LogSinkT*>(GetLastSink());
 		}
+		//file is stored as a pointer and has to outlive the log call, e.g. __FILE__
 		void Log(LogLevel level, LogChannel channel, Char const* str, Char const* file, Uint32 line);
+		void LogFormat(LogLevel level, LogChannel channel, Char const* file, Uint32 line, Char const* format, ...);
 		void LogSync(LogLevel level, LogChannel channel, Char const* str, Char const* file, Uint32 line);
 		void Flush();
 
@@ -63,13 +65,7 @@ namespace adria
 
 	#define ADRIA_LOG_CHANNEL(name) ADRIA_MAYBE_UNUSED static constexpr LogChannel ___LogChannel___ = LogChannel::name
 
-	#define ADRIA_LOG(level, ... ) [&]()  \
-		{ \
-			Uint64 const size = snprintf(nullptr, 0, __VA_ARGS__) + 1; \
-			std::unique_ptr<Char[]> buf = std::make_unique<Char[]>(size); \
-			snprintf(buf.get(), size, __VA_ARGS__); \
-			g_Log.Log(LogLevel::LOG_##level, ___LogChannel___, buf.get(), __FILE__, __LINE__);  \
-		}()
+	#define ADRIA_LOG(level, ... ) (g_Log.LogFormat(LogLevel::LOG_##level, ___LogChannel___, __FILE__, __LINE__, __VA_ARGS__))
 	#define ADRIA_DEBUG(...)	ADRIA_LOG(DEBUG, __VA_ARGS__)
 	#define ADRIA_INFO(...)		ADRIA_LOG(INFO, __VA_ARGS__)
 	#define ADRIA_WARNING(...)  ADRIA_LOG(WARNING, __VA_ARGS__)
@@ -47,7 +47,7 @@ namespace adria
         return AABBFromRange(vertices.begin(), vertices.end());
     }
 
-	static BoundingBox AABBFromPositions(std::vector<Vector3> const& positions)
+	static BoundingBox AABBFromPositions(std::span<Vector3 const> positions)
 	{
         auto begin = positions.begin();
         auto end = positions.end();
@@ -0,0 +1,195 @@
+#include "FrustumCulling.h"
+#if defined(__AVX__)
+#include <immintrin.h>
+#endif
+
+using namespace DirectX;
+
+namespace adria
+{
+	void AABBStreams::Resize(Uint64 new_count)
+	{
+		count = new_count;
+		Uint64 const padded_count = (new_count + Width - 1) / Width * Width;
+		center_x.resize(padded_count, 0.0f);
+		center_y.resize(padded_count, 0.0f);
+		center_z.resize(padded_count, 0.0f);
+		extents_x.resize(padded_count, 0.0f);
+		extents_y.resize(padded_count, 0.0f);
+		extents_z.resize(padded_count, 0.0f);
+	}
+
+	void AABBStreams::Clear()
+	{
+		count = 0;
+		center_x.clear();
+		center_y.clear();
+		center_z.clear();
+		extents_x.clear();
+		extents_y.clear();
+		extents_z.clear();
+	}
+
+	void AABBStreams::Set(Uint64 index, BoundingBox const& aabb)
+	{
+		ADRIA_ASSERT(index < count);
+		center_x[index] = aabb.Center.x;
+		center_y[index] = aabb.Center.y;
+		center_z[index] = aabb.Center.z;
+		extents_x[index] = aabb.Extents.x;
+		extents_y[index] = aabb.Extents.y;
+		extents_z[index] = aabb.Extents.z;
+	}
+
+	FrustumPlanes GetFrustumPlanes(BoundingFrustum const& frustum)
+	{
+		XMVECTOR planes[6];
+		frustum.GetPlanes(&planes[0], &planes[1], &planes[2], &planes[3], &planes[4], &planes[5]);
+
+		FrustumPlanes frustum_planes{};
+		for (Uint32 i = 0; i < 6; ++i)
+		{
+			XMFLOAT4 plane;
+			XMStoreFloat4(&plane, planes[i]);
+			frustum_planes.normal_x[i] = plane.x;
+			frustum_planes.normal_y[i] = plane.y;
+			frustum_planes.normal_z[i] = plane.z;
+			frustum_planes.d[i] = plane.w;
+		}
+		return frustum_planes;
+	}
+
+	FrustumPlanes GetBoxPlanes(BoundingBox const& box)
+	{
+		FrustumPlanes box_planes{};
+		Float const center[3] = { box.Center.x, box.Center.y, box.Center.z };
+		Float const extents[3] = { box.Extents.x, box.Extents.y, box.Extents.z };
+		for (Uint32 axis = 0; axis < 3; ++axis)
+		{
+			for (Uint32 side = 0; side < 2; ++side)
+			{
+				Uint32 const i = axis * 2 + side;
+				Float const sign = side == 0 ? 1.0f : -1.0f;
+				box_planes.normal_x[i] = axis == 0 ? sign : 0.0f;
+				box_planes.normal_y[i] = axis == 1 ? sign : 0.0f;
+				box_planes.normal_z[i] = axis == 2 ? sign : 0.0f;
+				box_planes.d[i] = -(sign * center[axis] + extents[axis]);
+			}
+		}
+		return box_planes;
+	}
+
+	void CullAABBs(FrustumPlanes const& planes, AABBStreams const& aabbs, Uint64 begin, Uint64 end, std::vector<Uint32>& visible_indices, Uint64* visibility)
+	{
+		ADRIA_ASSERT(begin % 64 == 0 && end <= aabbs.Size());
+
+		//a box is outside a plane when its center is further in front of it than the projection of its extents on the normal
+#if defined(__AVX__)
+		__m256 normal_x[6], normal_y[6], normal_z[6], abs_normal_x[6], abs_normal_y[6], abs_normal_z[6], d[6];
+		for (Uint32 p = 0; p < 6; ++p)
+		{
+			normal_x[p] = _mm256_set1_ps(planes.normal_x[p]);
+			normal_y[p] = _mm256_set1_ps(planes.normal_y[p]);
+			normal_z[p] = _mm256_set1_ps(planes.normal_z[p]);
+			abs_normal_x[p] = _mm256_set1_ps(std::abs(planes.normal_x[p]));
+			abs_normal_y[p] = _mm256_set1_ps(std::abs(planes.normal_y[p]));
+			abs_normal_z[p] = _mm256_set1_ps(std::abs(planes.normal_z[p]));
+			d[p] = _mm256_set1_ps(planes.d[p]);
+		}
+
+		auto TestAABBs = [&](Uint64 index) -> Uint64
+			{
+				__m256 const center_x = _mm256_loadu_ps(aabbs.CenterX() + index);
+				__m256 const center_y = _mm256_loadu_ps(aabbs.CenterY() + index);
+				__m256 const center_z = _mm256_loadu_ps(aabbs.CenterZ() + index);
+				__m256 const extents_x = _mm256_loadu_ps(aabbs.ExtentsX() + index);
+				__m256 const extents_y = _mm256_loadu_ps(aabbs.ExtentsY() + index);
+				__m256 const extents_z = _mm256_loadu_ps(aabbs.ExtentsZ() + index);
+
+				__m256 outside = _mm256_setzero_ps();
+				for (Uint32 p = 0; p < 6; ++p)
+				{
+					__m256 distance = _mm256_add_ps(_mm256_mul_ps(normal_x[p], center_x), d[p]);
+					distance = _mm256_add_ps(_mm256_mul_ps(normal_y[p], center_y), distance);
+					distance = _mm256_add_ps(_mm256_mul_ps(normal_z[p], center_z), distance);
+
+					__m256 radius = _mm256_mul_ps(abs_normal_x[p], extents_x);
+					radius = _mm256_add_ps(_mm256_mul_ps(abs_normal_y[p], extents_y), radius);
+					radius = _mm256_add_ps(_mm256_mul_ps(abs_normal_z[p], extents_z), radius);
+
+					outside = _mm256_or_ps(outside, _mm256_cmp_ps(distance, radius, _CMP_GT_OQ));
+				}
+				return ~(Uint64)_mm256_movemask_ps(outside) & 0xff;
+			};
+#else
+		//DirectXMath maps these to SSE or NEON, two 4 wide halves make up one group of the stream width
+		XMVECTOR normal_x[6], normal_y[6], normal_z[6], abs_normal_x[6], abs_normal_y[6], abs_normal_z[6], d[6];
+		for (Uint32 p = 0; p < 6; ++p)
+		{
+			normal_x[p] = XMVectorReplicate(planes.normal_x[p]);
+			normal_y[p] = XMVectorReplicate(planes.normal_y[p]);
+			normal_z[p] = XMVectorReplicate(planes.normal_z[p]);
+			abs_normal_x[p] = XMVectorAbs(normal_x[p]);
+			abs_normal_y[p] = XMVectorAbs(normal_y[p]);
+			abs_normal_z[p] = XMVectorAbs(normal_z[p]);
+			d[p] = XMVectorReplicate(planes.d[p]);
+		}
+
+		auto TestAABBs = [&](Uint64 index) -> Uint64
+			{
+				Uint64 mask = 0;
+				for (Uint64 half = 0; half < AABBStreams::Width; half += 4)
+				{
+					XMVECTOR const center_x = XMLoadFloat4(reinterpret_cast<XMFLOAT4 const*>(aabbs.CenterX() + index + half));
+					XMVECTOR const center_y = XMLoadFloat4(reinterpret_cast<XMFLOAT4 const*>(aabbs.CenterY() + index + half));
+					XMVECTOR const center_z = XMLoadFloat4(reinterpret_cast<XMFLOAT4 const*>(aabbs.CenterZ() + index + half));
+					XMVECTOR const extents_x = XMLoadFloat4(reinterpret_cast<XMFLOAT4 const*>(aabbs.ExtentsX() + index + half));
+					XMVECTOR const extents_y = XMLoadFloat4(reinterpret_cast<XMFLOAT4 const*>(aabbs.ExtentsY() + index + half));
+					XMVECTOR const extents_z = XMLoadFloat4(reinterpret_cast<XMFLOAT4 const*>(aabbs.ExtentsZ() + index + half));
+
+					XMVECTOR outside = XMVectorFalseInt();
+					for (Uint32 p = 0; p < 6; ++p)
+					{
+						XMVECTOR distance = XMVectorMultiplyAdd(normal_x[p], center_x, d[p]);
+						distance = XMVectorMultiplyAdd(normal_y[p], center_y, distance);
+						distance = XMVectorMultiplyAdd(normal_z[p], center_z, distance);
+
+						XMVECTOR radius = XMVectorMultiply(abs_normal_x[p], extents_x);
+						radius = XMVectorMultiplyAdd(abs_normal_y[p], extents_y, radius);
+						radius = XMVectorMultiplyAdd(abs_normal_z[p], extents_z, radius);
+
+						outside = XMVectorOrInt(outside, XMVectorGreater(distance, radius));
+					}
+
+					Uint32 outside_mask[4];
+					XMStoreInt4(outside_mask, outside);
+					for (Uint64 lane = 0; lane < 4; ++lane)
+					{
+						mask |= (Uint64)(outside_mask[lane] == 0) << (half + lane);
+					}
+				}
+				return mask;
+			};
+#endif
+
+		for (Uint64 word_begin = begin; word_begin < end; word_begin += 64)
+		{
+			Uint64 const word_end = std::min<Uint64>(word_begin + 64, end);
+			Uint64 word = 0;
+			for (Uint64 i = word_begin; i < word_end; i += AABBStreams::Width)
+			{
+				word |= TestAABBs(i) << (i - word_begin);
+			}
+			if (word_end - word_begin < 64)
+			{
+				word &= (1ull << (word_end - word_begin)) - 1;
+			}
+			visibility[word_begin / 64] = word;
+
+			for (Uint64 bits = word; bits != 0; bits &= bits - 1)
+			{
+				visible_indices.push_back(static_cast<Uint32>(word_begin + std::countr_zero(bits)));
+			}
+		}
+	}
+}
@@ -0,0 +1,50 @@
+#pragma once
+
+namespace adria
+{
+	//bounding boxes stored as separate center and extent streams, padded to the SIMD width so the culling loop never needs a remainder
+	class AABBStreams
+	{
+	public:
+		static constexpr Uint64 Width = 8;
+
+		void Resize(Uint64 count);
+		void Clear();
+		void Set(Uint64 index, BoundingBox const& aabb);
+
+		Uint64 Size() const { return count; }
+
+		Float const* CenterX() const { return center_x.data(); }
+		Float const* CenterY() const { return center_y.data(); }
+		Float const* CenterZ() const { return center_z.data(); }
+		Float const* ExtentsX() const { return extents_x.data(); }
+		Float const* ExtentsY() const { return extents_y.data(); }
+		Float const* ExtentsZ() const { return extents_z.data(); }
+
+	private:
+		Uint64 count = 0;
+		std::vector<Float> center_x;
+		std::vector<Float> center_y;
+		std::vector<Float> center_z;
+		std::vector<Float> extents_x;
+		std::vector<Float> extents_y;
+		std::vector<Float> extents_z;
+	};
+
+	//frustum planes with outward facing normals, a point is inside when dot(normal, point) + d <= 0 for all planes
+	struct FrustumPlanes
+	{
+		Float normal_x[6];
+		Float normal_y[6];
+		Float normal_z[6];
+		Float d[6];
+	};
+
+	FrustumPlanes GetFrustumPlanes(BoundingFrustum const& frustum);
+	//the six faces of an axis aligned box, culling against them is the exact box overlap test
+	FrustumPlanes GetBoxPlanes(BoundingBox const& box);
+
+	//appends the indices of boxes in [begin, end) that are not fully outside one of the planes and sets their bits in visibility.
+	//begin has to be a multiple of 64 so concurrent calls on disjoint ranges write disjoint visibility words
+	void CullAABBs(FrustumPlanes const& planes, AABBStreams const& aabbs, Uint64 begin, Uint64 end, std::vector<Uint32>& visible_indices, Uint64* visibility);
+}
@@ -41,4 +41,89 @@ namespace adria
 		Uint32 packed_value = (static_cast<Uint32>(value1) << 16) | static_cast<Uint32>(value2);
 		return packed_value;
 	}
+
+	namespace
+	{
+		//plain scalar math, the SSE float3 load/store in DirectXMath goes through double pointers which gcc's strict aliasing
+		//lets it reorder against the float writes that built the vector, corrupting the encoded tangents at -O2
+		Vector2 EncodeOctahedron(Float x, Float y, Float z)
+		{
+			Float const inv_l1 = 1.0f / (std::abs(x) + std::abs(y) + std::abs(z));
+			x *= inv_l1;
+			y *= inv_l1;
+			z *= inv_l1;
+			if (z < 0.0f)
+			{
+				return Vector2((1.0f - std::abs(y)) * (x >= 0.0f ? 1.0f : -1.0f), (1.0f - std::abs(x)) * (y >= 0.0f ? 1.0f : -1.0f));
+			}
+			return Vector2(x, y);
+		}
+		Vector3 DecodeOctahedron(Float fx, Float fy)
+		{
+			Float x = fx, y = fy;
+			Float const z = 1.0f - std::abs(fx) - std::abs(fy);
+			Float const t = std::max(-z, 0.0f);
+			x += x >= 0.0f ? -t : t;
+			y += y >= 0.0f ? -t : t;
+			Float const inv_length = 1.0f / std::sqrt(x * x + y * y + z * z);
+			return Vector3(x * inv_length, y * inv_length, z * inv_length);
+		}
+		//degenerate normals from the importer would divide by zero in the octahedral mapping
+		Vector2 SafeEncodeOctahedron(Float x, Float y, Float z)
+		{
+			return x * x + y * y + z * z > 1e-16f ? EncodeOctahedron(x, y, z) : Vector2(0.0f, 0.0f);
+		}
+		Uint32 QuantizeUnorm(Float value, Float scale)
+		{
+			return (Uint32)std::lround(std::clamp(value * 0.5f + 0.5f, 0.0f, 1.0f) * scale);
+		}
+	}
+
+	Vector2 UnpackTwoFloatsFromUint32(Uint32 packed)
+	{
+		DirectX::PackedVector::XMHALF2 half2(packed);
+		DirectX::XMFLOAT2 unpacked;
+		DirectX::XMStoreFloat2(&unpacked, DirectX::PackedVector::XMLoadHalf2(&half2));
+		return Vector2(unpacked.x, unpacked.y);
+	}
+
+	Uint64 PackPositionSnorm16x4(Vector3 const& position, Vector3 const& center, Vector3 const& extents)
+	{
+		//flat bounds would divide by zero, every position then equals the center anyway
+		Float const x = extents.x > 0.0f ? (position.x - center.x) / extents.x : 0.0f;
+		Float const y = extents.y > 0.0f ? (position.y - center.y) / extents.y : 0.0f;
+		Float const z = extents.z > 0.0f ? (position.z - center.z) / extents.z : 0.0f;
+		DirectX::PackedVector::XMSHORTN4 packed(x, y, z, 0.0f);
+		return packed.v;
+	}
+	Vector3 UnpackPositionSnorm16x4(Uint64 packed, Vector3 const& center, Vector3 const& extents)
+	{
+		DirectX::PackedVector::XMSHORTN4 shortn4;
+		shortn4.v = packed;
+		DirectX::XMFLOAT3 unpacked;
+		DirectX::XMStoreFloat3(&unpacked, DirectX::PackedVector::XMLoadShortN4(&shortn4));
+		return center + Vector3(unpacked.x, unpacked.y, unpacked.z) * extents;
+	}
+
+	Uint32 PackNormalOctahedron16x2(Vector3 const& normal)
+	{
+		Vector2 const f = SafeEncodeOctahedron(normal.x, normal.y, normal.z);
+		return (QuantizeUnorm(f.x, 65535.0f) << 16) | QuantizeUnorm(f.y, 65535.0f);
+	}
+	Vector3 UnpackNormalOctahedron16x2(Uint32 packed)
+	{
+		return DecodeOctahedron((packed >> 16) / 65535.0f * 2.0f - 1.0f, (packed & 0xffff) / 65535.0f * 2.0f - 1.0f);
+	}
+
+	Uint32 PackTangentOctahedron16x2(Vector4 const& tangent)
+	{
+		Vector2 const f = SafeEncodeOctahedron(tangent.x, tangent.y, tangent.z);
+		Uint32 const sign = tangent.w < 0.0f ? 1u : 0u;
+		return (QuantizeUnorm(f.x, 65535.0f) << 16) | (QuantizeUnorm(f.y, 32767.0f) << 1) | sign;
+	}
+	Vector4 UnpackTangentOctahedron16x2(Uint32 packed)
+	{
+		Vector3 const t = DecodeOctahedron((packed >> 16) / 65535.0f * 2.0f - 1.0f, ((packed & 0xffff) >> 1) / 32767.0f * 2.0f - 1.0f);
+		return Vector4(t.x, t.y, t.z, (packed & 1) ? -1.0f : 1.0f);
+	}
 }
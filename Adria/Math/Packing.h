@@ -1,4 +1,5 @@
 #pragma once
+#include "MathTypes.h"
 
 namespace adria
 {
@@ -9,4 +10,13 @@ namespace adria
 	Uint64 PackFourFloatsToUint64(Float x, Float y, Float z, Float w);
 
 	Uint32 PackTwoUint16ToUint32(Uint16 value1, Uint16 value2);
+
+	//vertex stream encodings, the shader side decoders live in Scene.hlsli and Packing.hlsli
+	Vector2 UnpackTwoFloatsFromUint32(Uint32 packed);
+	Uint64  PackPositionSnorm16x4(Vector3 const& position, Vector3 const& center, Vector3 const& extents);
+	Vector3 UnpackPositionSnorm16x4(Uint64 packed, Vector3 const& center, Vector3 const& extents);
+	Uint32  PackNormalOctahedron16x2(Vector3 const& normal);
+	Vector3 UnpackNormalOctahedron16x2(Uint32 packed);
+	Uint32  PackTangentOctahedron16x2(Vector4 const& tangent);
+	Vector4 UnpackTangentOctahedron16x2(Uint32 packed);
 }
\ No newline at end of file
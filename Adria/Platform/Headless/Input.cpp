@@ -0,0 +1,35 @@
+#include "Platform/Input.h"
+#include "Platform/Window.h"
+
+namespace adria
+{
+	Input::Input() : input_events{}, keys{}, prev_keys{}
+	{
+	}
+
+	void Input::Tick()
+	{
+		prev_keys = keys;
+		prev_mouse_position_x = mouse_position_x;
+		prev_mouse_position_y = mouse_position_y;
+		mmouse_wheel_delta = 0.0f;
+	}
+
+	void Input::OnWindowEvent(WindowEventInfo const& data)
+	{
+		if (data.width > 0 && data.height > 0)
+		{
+			input_events.window_resized_event.Broadcast((Uint32)data.width, (Uint32)data.height);
+		}
+	}
+
+	void Input::SetMouseVisibility(Bool)
+	{
+	}
+
+	void Input::SetMousePosition(Float xpos, Float ypos)
+	{
+		mouse_position_x = xpos;
+		mouse_position_y = ypos;
+	}
+}
@@ -0,0 +1,69 @@
+#include "Platform/Window.h"
+
+namespace adria
+{
+	namespace
+	{
+		struct HeadlessWindowState
+		{
+			Uint32 width;
+			Uint32 height;
+		};
+	}
+
+	Window::Window(WindowCreationParams const& init)
+	{
+		window_handle = new HeadlessWindowState{ .width = init.width, .height = init.height };
+	}
+
+	Window::~Window()
+	{
+		delete static_cast<HeadlessWindowState*>(window_handle);
+		window_handle = nullptr;
+	}
+
+	Uint32 Window::Width() const
+	{
+		return static_cast<HeadlessWindowState*>(window_handle)->width;
+	}
+
+	Uint32 Window::Height() const
+	{
+		return static_cast<HeadlessWindowState*>(window_handle)->height;
+	}
+
+	Uint32 Window::PositionX() const
+	{
+		return 0;
+	}
+
+	Uint32 Window::PositionY() const
+	{
+		return 0;
+	}
+
+	Bool Window::Loop()
+	{
+		return !should_quit;
+	}
+
+	void Window::Quit(Int32)
+	{
+		should_quit = true;
+	}
+
+	void* Window::Handle() const
+	{
+		return window_handle;
+	}
+
+	Bool Window::IsActive() const
+	{
+		return false;
+	}
+
+	void Window::BroadcastEvent(WindowEventInfo const& data)
+	{
+		window_event.Broadcast(data);
+	}
+}
@@ -0,0 +1,143 @@
+#include <cstdio>
+#include "Core/Engine.h"
+#include "Core/CommandLineOptions.h"
+#include "Platform/Input.h"
+#include "Platform/Window.h"
+#include "Logging/FileSink.h"
+#include "Logging/ConsoleSink.h"
+#include "Graphics/GfxDevice.h"
+#include "Graphics/Null/NullDevice.h"
+#include "Rendering/Camera.h"
+#include "Rendering/Renderer.h"
+#include "Rendering/SceneConfig.h"
+#include "Math/Constants.h"
+#include "Utilities/ThreadPool.h"
+#include "Utilities/Timer.h"
+
+using namespace adria;
+
+namespace
+{
+	//the first frames pay for scene uploads and pipeline creation, they are run but not measured
+	constexpr Int WARMUP_FRAMES = 10;
+
+	struct TimingSamples
+	{
+		Char const* name;
+		std::vector<Float> samples = {};
+	};
+
+	void PrintTimingSamples(TimingSamples& timing)
+	{
+		if (timing.samples.empty())
+		{
+			return;
+		}
+		std::sort(timing.samples.begin(), timing.samples.end());
+		Float sum = 0.0f;
+		for (Float sample : timing.samples)
+		{
+			sum += sample;
+		}
+		Usize const count = timing.samples.size();
+		Usize const p95_index = std::min(count - 1, (count * 95) / 100);
+		std::printf("%-22s %10.3f %10.3f %10.3f %10.3f\n", timing.name, sum / count, timing.samples.front(), timing.samples.back(), timing.samples[p95_index]);
+	}
+}
+
+int main(int argc, char* argv[])
+{
+	CommandLineOptions::Initialize(argc, argv);
+
+	std::string log_file = CommandLineOptions::GetLogFile();
+	LogLevel log_level = static_cast<LogLevel>(CommandLineOptions::GetLogLevel());
+	ADRIA_SINK(FileSink, log_file.c_str(), log_level);
+	ADRIA_SINK(ConsoleSink, false, log_level);
+
+	if (CommandLineOptions::GetCookModels())
+	{
+		g_ThreadPool.Initialize();
+		SceneConfig scene_config{};
+		Bool const cooked = ParseSceneConfig(CommandLineOptions::GetSceneFile(), scene_config) && SceneLoader::CookModels(scene_config.scene_models);
+		g_ThreadPool.Shutdown();
+		return cooked ? 0 : 1;
+	}
+
+	WindowCreationParams window_params{};
+	window_params.width = CommandLineOptions::GetWindowWidth();
+	window_params.height = CommandLineOptions::GetWindowHeight();
+	window_params.maximize = false;
+	std::string window_title = CommandLineOptions::GetWindowTitle();
+	window_params.title = window_title.c_str();
+	Window window(window_params);
+	g_Input.Initialize(&window);
+
+	Int const frame_count = std::max(CommandLineOptions::GetFrameCount(), 1);
+	TimingSamples frame_time{ "frame" };
+	TimingSamples scene_buffers_update{ "scene buffers update" };
+	TimingSamples culling{ "culling" };
+	TimingSamples render_graph_build{ "render graph build" };
+	TimingSamples render_graph_compile{ "render graph compile" };
+	TimingSamples pass_recording{ "pass recording" };
+	NullFrameStats total_stats{};
+	Int measured_frames = 0;
+	{
+		Engine engine(&window, CommandLineOptions::GetSceneFile());
+		Camera* camera = engine.GetCamera();
+		Renderer* renderer = engine.GetRenderer();
+		GfxDevice* gfx = engine.GetGfxDevice();
+
+		//scripted camera: stays at the scene camera position and pans a full turn over the run,
+		//so the visible set and the draw lists change every frame
+		Vector3 const camera_position = camera->Position();
+		Vector3 const camera_forward = camera->Forward();
+		Float const start_yaw = std::atan2(camera_forward.x, camera_forward.z);
+		Float const horizontal_length = std::sqrt(camera_forward.x * camera_forward.x + camera_forward.z * camera_forward.z);
+
+		Timer frame_timer;
+		for (Int frame = 0; frame < frame_count && window.Loop(); ++frame)
+		{
+			Float const yaw = start_yaw + pi_times_2<Float> * frame / frame_count;
+			camera->SetLookAt(camera_position + Vector3(horizontal_length * std::sin(yaw), camera_forward.y, horizontal_length * std::cos(yaw)));
+
+			frame_timer.Mark();
+			engine.Run();
+			Float const frame_ms = frame_timer.Mark() / 1000.0f;
+			if (frame < WARMUP_FRAMES && frame_count > WARMUP_FRAMES)
+			{
+				continue;
+			}
+
+			RendererCPUTimings const& timings = renderer->GetCPUTimings();
+			frame_time.samples.push_back(frame_ms);
+			scene_buffers_update.samples.push_back(timings.scene_buffers_update);
+			culling.samples.push_back(timings.culling);
+			render_graph_build.samples.push_back(timings.render_graph_build);
+			render_graph_compile.samples.push_back(timings.render_graph_compile);
+			pass_recording.samples.push_back(timings.pass_recording);
+			if (gfx->GetBackend() == GfxBackend::Null)
+			{
+				total_stats += static_cast<NullDevice*>(gfx)->GetLastFrameStats();
+			}
+			++measured_frames;
+		}
+	}
+
+	std::printf("%s: %d frames measured (%d warmup)\n", CommandLineOptions::GetSceneFile().c_str(), measured_frames, frame_count - measured_frames);
+	std::printf("%-22s %10s %10s %10s %10s\n", "cpu time (ms)", "avg", "min", "max", "p95");
+	PrintTimingSamples(frame_time);
+	PrintTimingSamples(scene_buffers_update);
+	PrintTimingSamples(culling);
+	PrintTimingSamples(render_graph_build);
+	PrintTimingSamples(render_graph_compile);
+	PrintTimingSamples(pass_recording);
+	if (measured_frames > 0 && total_stats.command_lists > 0)
+	{
+		std::printf("per frame: %.1f command lists, %.1f draws, %.1f dispatches, %.1f barriers (%.1f split halves) in %.1f batches, %.1f copies, %.1f pipeline changes, %.1f KB transient\n",
+			Float(total_stats.command_lists) / measured_frames, Float(total_stats.draw_calls) / measured_frames, Float(total_stats.dispatches) / measured_frames,
+			Float(total_stats.barriers) / measured_frames, Float(total_stats.split_barriers) / measured_frames, Float(total_stats.barrier_batches) / measured_frames,
+			Float(total_stats.copies) / measured_frames, Float(total_stats.pipeline_changes) / measured_frames,
+			Float(total_stats.transient_bytes) / measured_frames / 1024.0f);
+	}
+	return 0;
+}
@@ -6,6 +6,8 @@
 #include "Logging/FileSink.h"
 #include "Logging/Windows/DebuggerSink.h"
 #include "Editor/Editor.h"
+#include "Rendering/SceneConfig.h"
+#include "Utilities/ThreadPool.h"
 #include "Utilities/CLIParser.h"
 
 using namespace adria;
@@ -31,6 +33,15 @@ int APIENTRY wWinMain(
     ADRIA_SINK(FileSink, log_file.c_str(), log_level);
     ADRIA_SINK(DebuggerSink, log_level);
 
+    if (CommandLineOptions::GetCookModels())
+    {
+        g_ThreadPool.Initialize();
+        SceneConfig scene_config{};
+        Bool const cooked = ParseSceneConfig(CommandLineOptions::GetSceneFile(), scene_config) && SceneLoader::CookModels(scene_config.scene_models);
+        g_ThreadPool.Shutdown();
+        return cooked ? 0 : 1;
+    }
+
     WindowCreationParams window_params{};
     window_params.width = CommandLineOptions::GetWindowWidth();
     window_params.height = CommandLineOptions::GetWindowHeight();
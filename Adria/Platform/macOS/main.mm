@@ -7,6 +7,8 @@
 #include "Logging/FileSink.h"
 #include "Logging/ConsoleSink.h"
 #include "Editor/Editor.h"
+#include "Rendering/SceneConfig.h"
+#include "Utilities/ThreadPool.h"
 #include "Utilities/CLIParser.h"
 
 using namespace adria;
@@ -39,6 +41,15 @@ int main(int argc, char* argv[])
         LogLevel log_level = static_cast<LogLevel>(CommandLineOptions::GetLogLevel());
         ADRIA_SINK(FileSink, log_file.c_str(), log_level);
         ADRIA_SINK(ConsoleSink, false, log_level); 
+
+        if (CommandLineOptions::GetCookModels())
+        {
+            g_ThreadPool.Initialize();
+            SceneConfig scene_config{};
+            Bool const cooked = ParseSceneConfig(CommandLineOptions::GetSceneFile(), scene_config) && SceneLoader::CookModels(scene_config.scene_models);
+            g_ThreadPool.Shutdown();
+            return cooked ? 0 : 1;
+        }
         
         WindowCreationParams window_params{};
         window_params.width = CommandLineOptions::GetWindowWidth();
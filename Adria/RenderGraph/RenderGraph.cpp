@@ -6,6 +6,8 @@
 #include "Core/ConsoleManager.h"
 #include "Utilities/StringConversions.h"
 #include "Utilities/PathHelpers.h"
+#include "Utilities/Hash.h"
+#include "Utilities/ThreadPool.h"
 #include "tracy/Tracy.hpp"
 
 #if GFX_MULTITHREADED
@@ -18,7 +20,7 @@ namespace adria
 {
 	ADRIA_LOG_CHANNEL(RenderGraph);
 
-	extern Bool g_DumpRenderGraph = false;
+	Bool g_DumpRenderGraph = false;
 #if GFX_PROFILING
 	static constexpr Bool g_UseDependencyLevels = false;
 #else
@@ -27,12 +29,76 @@ namespace adria
 
 	static TAutoConsoleVariable<Bool> RGCullPasses("rg.CullPasses", true, "Determines if the render graph should cull unused passes or not");
 	static TAutoConsoleVariable<Bool> RGAsyncCompute("rg.AsyncCompute", false, "Determines if the async compute is enabled or not");
+	static TAutoConsoleVariable<Bool> RGResourceAliasing("rg.ResourceAliasing", true, "Determines if transient resources with disjoint lifetimes should share heap memory");
+	static TAutoConsoleVariable<Bool> RGCacheCompilation("rg.CacheCompilation", true, "Determines if the compiled render graph should be reused across frames with unchanged topology");
+	static TAutoConsoleVariable<Bool> RGSplitBarriers("rg.SplitBarriers", true, "Determines if transitions should begin right after the last level that used the previous state");
+	static TAutoConsoleVariable<Int>  RGMinPassesPerCommandList("rg.MinPassesPerCommandList", 8, "Minimum number of passes recorded on one command list when the render graph records in parallel");
+
+	namespace
+	{
+		Uint64 HashClearValue(GfxClearValue const& clear_value)
+		{
+			HashState hash;
+			hash.Combine(clear_value.active_member);
+			hash.Combine(clear_value.format);
+			if (clear_value.active_member == GfxClearValue::GfxActiveMember::Color)
+			{
+				for (Float c : clear_value.color.color)
+				{
+					hash.Combine(c);
+				}
+			}
+			else if (clear_value.active_member == GfxClearValue::GfxActiveMember::DepthStencil)
+			{
+				hash.Combine(clear_value.depth_stencil.depth);
+				hash.Combine(clear_value.depth_stencil.stencil);
+			}
+			return hash;
+		}
+
+		//bind flags and initial states added by the builder are not part of it, the calls adding them are hashed with the pass
+		Uint64 HashTextureDeclaration(RGResourceName name, Bool imported, GfxTextureDesc const& desc)
+		{
+			HashState hash;
+			hash.Combine(name.hashed_name);
+			hash.Combine(imported);
+			hash.Combine(desc.type);
+			hash.Combine(desc.width);
+			hash.Combine(desc.height);
+			hash.Combine(desc.depth);
+			hash.Combine(desc.array_size);
+			hash.Combine(desc.mip_levels);
+			hash.Combine(desc.sample_count);
+			hash.Combine(desc.heap_type);
+			hash.Combine(desc.bind_flags);
+			hash.Combine(desc.misc_flags);
+			hash.Combine(desc.initial_state);
+			hash.Combine(desc.format);
+			hash.Combine(HashClearValue(desc.clear_value));
+			return hash;
+		}
+
+		Uint64 HashBufferDeclaration(RGResourceName name, Bool imported, GfxBufferDesc const& desc)
+		{
+			HashState hash;
+			hash.Combine(name.hashed_name);
+			hash.Combine(imported);
+			hash.Combine(desc.size);
+			hash.Combine(desc.resource_usage);
+			hash.Combine(desc.bind_flags);
+			hash.Combine(desc.misc_flags);
+			hash.Combine(desc.stride);
+			hash.Combine(desc.format);
+			return hash;
+		}
+	}
 
 	RGTextureId RenderGraph::DeclareTexture(RGResourceName name, RGTextureDesc const& desc)
 	{
 		ADRIA_ASSERT_MSG(texture_name_id_map.find(name) == texture_name_id_map.end(), "Texture with that name has already been declared");
 		GfxTextureDesc tex_desc{}; InitGfxTextureDesc(desc, tex_desc);
-		textures.emplace_back(new RGTexture(textures.size(), tex_desc, name));
+		AddTexture(allocator.AllocateObject<RGTexture>(textures.size(), tex_desc, name));
+		textures.back()->declaration_hash = HashTextureDeclaration(name, false, tex_desc);
 		texture_name_id_map[name] = RGTextureId(textures.size() - 1);
 		return RGTextureId(textures.size() - 1);
 	}
@@ -41,7 +107,8 @@ namespace adria
 	{
 		ADRIA_ASSERT_MSG(buffer_name_id_map.find(name) == buffer_name_id_map.end(), "Buffer with that name has already been declared");
 		GfxBufferDesc buf_desc{}; InitGfxBufferDesc(desc, buf_desc);
-		buffers.emplace_back(new RGBuffer(buffers.size(), buf_desc, name));
+		AddBuffer(allocator.AllocateObject<RGBuffer>(buffers.size(), buf_desc, name));
+		buffers.back()->declaration_hash = HashBufferDeclaration(name, false, buf_desc);
 		buffer_name_id_map[name] = RGBufferId(buffers.size() - 1);
 		return RGBufferId(buffers.size() - 1);
 	}
@@ -60,8 +127,9 @@ namespace adria
 	{
 		ADRIA_ASSERT(texture);
 		texture->SetPersistent(false);
-		textures.emplace_back(new RGTexture(textures.size(), texture, name));
+		AddTexture(allocator.AllocateObject<RGTexture>(textures.size(), texture, name));
 		textures.back()->SetName();
+		textures.back()->declaration_hash = HashTextureDeclaration(name, true, textures.back()->desc);
 		texture_name_id_map[name] = RGTextureId(textures.size() - 1);
 	}
 
@@ -69,8 +137,9 @@ namespace adria
 	{
 		ADRIA_ASSERT(buffer);
 		buffer->SetPersistent(false);
-		buffers.emplace_back(new RGBuffer(buffers.size(), buffer, name));
+		AddBuffer(allocator.AllocateObject<RGBuffer>(buffers.size(), buffer, name));
 		buffers.back()->SetName();
+		buffers.back()->declaration_hash = HashBufferDeclaration(name, true, buffers.back()->desc);
 		buffer_name_id_map[name] = RGBufferId(buffers.size() - 1);
 	}
 
@@ -86,6 +155,30 @@ namespace adria
 		AddExportBufferCopyPass(name, buffer);
 	}
 
+	void RenderGraph::AddTexture(RGTexture* texture)
+	{
+		textures.push_back(texture);
+		texture_view_descs.emplace_back(allocator);
+		texture_views.emplace_back(allocator);
+	}
+
+	void RenderGraph::AddBuffer(RGBuffer* buffer)
+	{
+		buffers.push_back(buffer);
+		buffer_view_descs.emplace_back(allocator);
+		buffer_views.emplace_back(allocator);
+	}
+
+	Uint64 RenderGraph::GetHeapAllocationCount() const
+	{
+		Uint64 heap_allocation_count = allocator.GetHeapAllocationCount();
+		if (compile_cache)
+		{
+			heap_allocation_count += compile_cache->allocator.GetHeapAllocationCount();
+		}
+		return heap_allocation_count;
+	}
+
 	Bool RenderGraph::IsValidTextureHandle(RGTextureId handle) const
 	{
 		return handle.IsValid() && handle.id < textures.size();
@@ -96,6 +189,18 @@ namespace adria
 		return handle.IsValid() && handle.id < buffers.size();
 	}
 
+	RenderGraph::RenderGraph(RGResourcePool& pool, RGCompileCache* compile_cache, RGAllocator* frame_allocator)
+		: pool(pool), compile_cache(compile_cache), gfx(pool.GetDevice()),
+		  allocator(frame_allocator ? *frame_allocator : owned_allocator.emplace(DefaultAllocatorSize)), allocator_reset{ frame_allocator },
+		  heap_allocations_at_start(GetHeapAllocationCount()), blackboard(allocator),
+		  passes(allocator), textures(allocator), buffers(allocator), events(allocator), pending_event_indices(allocator),
+		  adjacency_lists(allocator), topologically_sorted_passes(allocator), dependency_levels(allocator), barrier_plans(allocator),
+		  texture_name_id_map(allocator), buffer_name_id_map(allocator), buffer_uav_counter_map(allocator),
+		  texture_view_descs(allocator), texture_views(allocator), texture_views_to_free(allocator),
+		  buffer_view_descs(allocator), buffer_views(allocator)
+	{
+	}
+
 	RenderGraph::~RenderGraph()
 	{
 		for (GfxDescriptor const& view : texture_views_to_free)
@@ -107,30 +212,48 @@ namespace adria
 	void RenderGraph::Compile()
 	{
 		ZoneScopedN("RenderGraph::Compile");
-		BuildAdjacencyLists();
-		TopologicalSort();
-		if (g_UseDependencyLevels)
+		Bool const use_compile_cache = compile_cache != nullptr && RGCacheCompilation.Get();
+		Uint64 const topology_hash = use_compile_cache ? HashTopology() : 0;
+		if (use_compile_cache && compile_cache->valid && compile_cache->topology_hash == topology_hash)
 		{
-			BuildDependencyLevels();
+			++compile_cache->hit_count;
+			LoadCompiledGraph();
 		}
 		else
 		{
-			Uint64 max_level = passes.size();
-			dependency_levels.reserve(max_level);
-			for (Uint32 i = 0; i < max_level; ++i)
+			BuildAdjacencyLists();
+			TopologicalSort();
+			if (g_UseDependencyLevels)
 			{
-				dependency_levels.emplace_back(*this, i);
-				dependency_levels[i].AddPass(passes[i]);
+				BuildDependencyLevels();
+			}
+			else
+			{
+				Uint64 max_level = passes.size();
+				dependency_levels.reserve(max_level);
+				for (Uint32 i = 0; i < max_level; ++i)
+				{
+					dependency_levels.emplace_back(*this, i);
+					dependency_levels[i].AddPass(passes[i]);
+				}
+			}
+			CullPasses();
+			ResolveAsync();
+			ResolveEvents();
+			CalculateResourcesLifetime();
+			for (DependencyLevel& dependency_level : dependency_levels)
+			{
+				dependency_level.Setup();
+			}
+			CalculateResourceAliasing();
+			BuildBarrierPlans();
+			if (use_compile_cache)
+			{
+				++compile_cache->miss_count;
+				StoreCompiledGraph(topology_hash);
 			}
 		}
-		CullPasses();
-		ResolveAsync();
-		ResolveEvents();
-		CalculateResourcesLifetime();
-		for (DependencyLevel& dependency_level : dependency_levels)
-		{
-			dependency_level.Setup();
-		}
+		CreateImportedResourceViews();
 
 		if (g_DumpRenderGraph)
 		{
@@ -160,6 +283,13 @@ namespace adria
 		exec_ctx.compute_fence = &gfx->GetComputeFence();
 		exec_ctx.graphics_fence_value = gfx->GetGraphicsFenceValue();
 		exec_ctx.compute_fence_value = gfx->GetComputeFenceValue();
+		exec_ctx.batch_begin = 0;
+		exec_ctx.batch_end = dependency_levels.size();
+		exec_ctx.split_barriers = RGSplitBarriers.Get();
+#if GFX_ASYNC_COMPUTE
+		//async compute passes submit the graphics list in the middle of a level, so the halves could end up on different submissions
+		exec_ctx.split_barriers &= !RGAsyncCompute.Get();
+#endif
 
 		for (Uint64 i = 0; i < dependency_levels.size(); ++i)
 		{
@@ -170,15 +300,119 @@ namespace adria
 
 	void RenderGraph::Execute_Multithreaded()
 	{
-		ADRIA_ASSERT_MSG(false, "Not yet implemented!");
+#if GFX_ASYNC_COMPUTE
+		//async compute passes submit and wait on fences in the middle of recording, which only works in submission order
+		if (RGAsyncCompute.Get())
+		{
+			Execute_Singlethreaded();
+			return;
+		}
+#endif
+		pool.Tick();
+
+		//pool and view allocation is not thread safe, replaying it in level order hands out the same resources as the single threaded path
+		for (DependencyLevel& dependency_level : dependency_levels)
+		{
+			dependency_level.AllocateResources();
+			dependency_level.ReleaseResources();
+		}
+
+		RenderGraphExecutionContext exec_ctx{};
+		exec_ctx.gfx = gfx;
+		exec_ctx.graphics_cmd_list = gfx->GetGraphicsCommandList();
+		exec_ctx.compute_cmd_list = gfx->GetComputeCommandList();
+		exec_ctx.graphics_fence = &gfx->GetGraphicsFence();
+		exec_ctx.compute_fence = &gfx->GetComputeFence();
+		exec_ctx.graphics_fence_value = gfx->GetGraphicsFenceValue();
+		exec_ctx.compute_fence_value = gfx->GetComputeFenceValue();
+		exec_ctx.split_barriers = RGSplitBarriers.Get();
+
+		RGVector<std::pair<Uint64, Uint64>> const batches = BuildExecutionBatches();
+		RGVector<GfxCommandList*> batch_cmd_lists(batches.size(), nullptr, allocator);
+		batch_cmd_lists[0] = exec_ctx.graphics_cmd_list;
+		for (Uint64 i = 1; i < batches.size(); ++i)
+		{
+			batch_cmd_lists[i] = pool.GetCommandList((Uint32)i - 1);
+		}
+
+		auto RecordBatch = [this, &exec_ctx, &batches, &batch_cmd_lists](Uint64 batch_index)
+		{
+			ZoneScopedN("RenderGraph::RecordBatch");
+			RenderGraphExecutionContext batch_exec_ctx = exec_ctx;
+			batch_exec_ctx.graphics_cmd_list = batch_cmd_lists[batch_index];
+			batch_exec_ctx.batch_begin = batches[batch_index].first;
+			batch_exec_ctx.batch_end = batches[batch_index].second;
+			for (Uint64 i = batch_exec_ctx.batch_begin; i < batch_exec_ctx.batch_end; ++i)
+			{
+				dependency_levels[i].Record(batch_exec_ctx);
+			}
+		};
+
+		g_ThreadPool.ParallelFor(0, batches.size(), 1, RecordBatch);
+
+		if (batches.size() > 1)
+		{
+			//every list is reopened so work recorded after the graph, and the end of frame submission, stay behind the graph
+			for (GfxCommandList* cmd_list : batch_cmd_lists)
+			{
+				cmd_list->End();
+				cmd_list->Submit();
+				cmd_list->Begin();
+			}
+		}
+	}
+
+	RGVector<std::pair<Uint64, Uint64>> RenderGraph::BuildExecutionBatches() const
+	{
+		Uint64 active_pass_count = 0;
+		for (DependencyLevel const& dependency_level : dependency_levels)
+		{
+			active_pass_count += dependency_level.GetActivePassCount();
+		}
+		//one command list per thread that can record, the workers of the pool include the calling thread
+		Uint64 const max_batch_count = std::max<Uint64>(g_ThreadPool.GetWorkerCount(), 1);
+		Uint64 const min_passes_per_batch = std::max<Int>(RGMinPassesPerCommandList.Get(), 1);
+		Uint64 const batch_count = std::clamp<Uint64>(active_pass_count / min_passes_per_batch, 1, max_batch_count);
+		Uint64 const passes_per_batch = (active_pass_count + batch_count - 1) / batch_count;
+
+		//batches are contiguous ranges of dependency levels, so barriers between levels stay at batch boundaries.
+		//a batch can only end when no event is open, otherwise Begin/EndEvent would be split across command lists
+		RGVector<std::pair<Uint64, Uint64>> batches(allocator);
+		Uint64 batch_begin = 0;
+		Uint64 batch_pass_count = 0;
+		Int64 event_depth = 0;
+		for (Uint64 i = 0; i < dependency_levels.size(); ++i)
+		{
+			for (RGPassBase* pass : dependency_levels[i].passes)
+			{
+				if (!pass->IsCulled())
+				{
+					event_depth += (Int64)pass->events_to_start.size() - (Int64)pass->num_events_to_end;
+				}
+			}
+			batch_pass_count += dependency_levels[i].GetActivePassCount();
+			if (batch_pass_count >= passes_per_batch && event_depth == 0 && batches.size() + 1 < batch_count)
+			{
+				batches.emplace_back(batch_begin, i + 1);
+				batch_begin = i + 1;
+				batch_pass_count = 0;
+			}
+		}
+		if (batch_begin < dependency_levels.size() || batches.empty())
+		{
+			batches.emplace_back(batch_begin, dependency_levels.size());
+		}
+		return batches;
 	}
 
 	void RenderGraph::AddExportBufferCopyPass(RGResourceName export_buffer, GfxBuffer* buffer)
 	{
+		//formatted on the stack, the pass copies its name into the graph allocator
+		Char buffer_copy_pass_name[128];
 #if RG_DEBUG
-		std::string const buffer_copy_pass_name = "Export Buffer Copy Pass " + std::string(export_buffer.name);
+		std::snprintf(buffer_copy_pass_name, sizeof(buffer_copy_pass_name), "Export Buffer Copy Pass %s", export_buffer.name);
 #else 
-		std::string const buffer_copy_pass_name = "Export Texture Copy Pass " + std::to_string(export_buffer.hashed_name);
+		std::snprintf(buffer_copy_pass_name, sizeof(buffer_copy_pass_name), "Export Buffer Copy Pass %llu", (unsigned long long)export_buffer.hashed_name);
 #endif
 
 		struct ExportBufferCopyPassData
@@ -186,7 +420,7 @@ namespace adria
 			RGBufferCopySrcId src;
 		};
 
-		AddPass<ExportBufferCopyPassData>(buffer_copy_pass_name.c_str(),
+		AddPass<ExportBufferCopyPassData>(buffer_copy_pass_name,
 			[=, this](ExportBufferCopyPassData& data, RenderGraphBuilder& builder)
 			{
 				ADRIA_ASSERT(IsBufferDeclared(export_buffer));
@@ -202,10 +436,11 @@ namespace adria
 
 	void RenderGraph::AddExportTextureCopyPass(RGResourceName export_texture, GfxTexture* texture)
 	{
+		Char texture_copy_pass_name[128];
 #if RG_DEBUG
-		std::string const texture_copy_pass_name = "Export Texture Copy Pass " + std::string(export_texture.name);
+		std::snprintf(texture_copy_pass_name, sizeof(texture_copy_pass_name), "Export Texture Copy Pass %s", export_texture.name);
 #else 
-		std::string const texture_copy_pass_name = "Export Texture Copy Pass " + std::to_string(export_texture.hashed_name);
+		std::snprintf(texture_copy_pass_name, sizeof(texture_copy_pass_name), "Export Texture Copy Pass %llu", (unsigned long long)export_texture.hashed_name);
 #endif
 
 		struct ExportTextureCopyPassData
@@ -213,7 +448,7 @@ namespace adria
 			RGTextureCopySrcId src;
 		};
 
-		AddPass<ExportTextureCopyPassData>(texture_copy_pass_name.c_str(),
+		AddPass<ExportTextureCopyPassData>(texture_copy_pass_name,
 			[=, this](ExportTextureCopyPassData& data, RenderGraphBuilder& builder)
 			{
 				ADRIA_ASSERT(IsTextureDeclared(export_texture));
@@ -229,46 +464,58 @@ namespace adria
 
 	void RenderGraph::BuildAdjacencyLists()
 	{
-		adjacency_lists.resize(passes.size());
-		for (Uint64 i = 0; i < passes.size(); ++i)
-		{
-			RGPassBase* pass = passes[i];
-			std::vector<Uint64>& pass_adjacency_list = adjacency_lists[i];
-			for (Uint64 j = i + 1; j < passes.size(); ++j)
+		ZoneScopedN("RenderGraph::BuildAdjacencyLists");
+		adjacency_lists.resize(passes.size(), RGVector<Uint64>(allocator));
+
+		//edges always point to the pass being swept, so a duplicate can only be the last edge added
+		auto AddEdge = [this](Uint64 from, Uint64 to)
 			{
-				RGPassBase* other_pass = passes[j];
-				Bool depends = false;
-				for (RGTextureId other_node_read : other_pass->texture_reads)
+				RGVector<Uint64>& adjacency_list = adjacency_lists[from];
+				if (from != to && (adjacency_list.empty() || adjacency_list.back() != to))
 				{
-					if (pass->texture_writes.find(other_node_read) != pass->texture_writes.end())
-					{
-						pass_adjacency_list.push_back(j);
-						depends = true;
-						break;
-					}
+					adjacency_list.push_back(to);
 				}
-
-				if (depends)
+			};
+		auto SweepResources = [&AddEdge](Uint64 pass_idx, auto const& reads, auto const& writes, RGVector<Uint64>& last_writers, RGVector<RGVector<Uint64>>& readers)
+			{
+				for (auto const& id : reads)
 				{
-					continue;
+					if (last_writers[id.id] != UINT64_MAX)
+					{
+						AddEdge(last_writers[id.id], pass_idx);
+					}
+					readers[id.id].push_back(pass_idx);
 				}
-
-				for (RGBufferId other_node_read : other_pass->buffer_reads)
+				for (auto const& id : writes)
 				{
-					if (pass->buffer_writes.find(other_node_read) != pass->buffer_writes.end())
+					for (Uint64 reader : readers[id.id])
 					{
-						pass_adjacency_list.push_back(j);
-						break;
+						AddEdge(reader, pass_idx);
 					}
+					if (last_writers[id.id] != UINT64_MAX)
+					{
+						AddEdge(last_writers[id.id], pass_idx);
+					}
+					last_writers[id.id] = pass_idx;
+					readers[id.id].clear();
 				}
-			}
+			};
+
+		RGVector<Uint64> texture_last_writers(textures.size(), UINT64_MAX, allocator);
+		RGVector<RGVector<Uint64>> texture_readers(textures.size(), RGVector<Uint64>(allocator), allocator);
+		RGVector<Uint64> buffer_last_writers(buffers.size(), UINT64_MAX, allocator);
+		RGVector<RGVector<Uint64>> buffer_readers(buffers.size(), RGVector<Uint64>(allocator), allocator);
+		for (Uint64 i = 0; i < passes.size(); ++i)
+		{
+			RGPassBase* pass = passes[i];
+			SweepResources(i, pass->texture_reads, pass->texture_writes, texture_last_writers, texture_readers);
+			SweepResources(i, pass->buffer_reads, pass->buffer_writes, buffer_last_writers, buffer_readers);
 		}
 	}
 
 	void RenderGraph::TopologicalSort()
 	{
-		std::vector<Uint64> sort{};
-		std::vector<Bool>  visited(passes.size(), false);
+		RGVector<Bool> visited(passes.size(), false, allocator);
 		for (Uint64 i = 0; i < passes.size(); i++)
 		{
 			if (visited[i] == false)
@@ -281,7 +528,7 @@ namespace adria
 
 	void RenderGraph::BuildDependencyLevels()
 	{
-		std::vector<Uint64> distances(topologically_sorted_passes.size(), 0);
+		RGVector<Uint64> distances(topologically_sorted_passes.size(), 0, allocator);
 		for (Uint64 u = 0; u < topologically_sorted_passes.size(); ++u)
 		{
 			Uint64 i = topologically_sorted_passes[u];
@@ -340,26 +587,26 @@ namespace adria
 			return;
 		}
 
-		std::stack<RenderGraphResource*> zero_ref_resources;
-		for (auto& texture : textures)
+		RGVector<RenderGraphResource*> zero_ref_resources(allocator);
+		for (RGTexture* texture : textures)
 		{
 			if (texture->ref_count == 0)
 			{
-				zero_ref_resources.push(texture.get());
+				zero_ref_resources.push_back(texture);
 			}
 		}
-		for (auto& buffer : buffers)
+		for (RGBuffer* buffer : buffers)
 		{
 			if (buffer->ref_count == 0)
 			{
-				zero_ref_resources.push(buffer.get());
+				zero_ref_resources.push_back(buffer);
 			}
 		}
 
 		while (!zero_ref_resources.empty())
 		{
-			RenderGraphResource* unreferenced_resource = zero_ref_resources.top();
-			zero_ref_resources.pop();
+			RenderGraphResource* unreferenced_resource = zero_ref_resources.back();
+			zero_ref_resources.pop_back();
 
 			RGPassBase* writer = unreferenced_resource->writer;
 			if (writer == nullptr || !writer->CanBeCulled())
@@ -374,7 +621,7 @@ namespace adria
 					RGTexture* texture = GetRGTexture(id);
 					if (--texture->ref_count == 0)
 					{
-						zero_ref_resources.push(texture);
+						zero_ref_resources.push_back(texture);
 					}
 				}
 
@@ -383,7 +630,7 @@ namespace adria
 					RGBuffer* buffer = GetRGBuffer(id);
 					if (--buffer->ref_count == 0)
 					{
-						zero_ref_resources.push(buffer);
+						zero_ref_resources.push_back(buffer);
 					}
 				}
 			}
@@ -453,143 +700,468 @@ namespace adria
 			{
 				textures[i]->last_used_by->texture_destroys.insert(RGTextureId(i));
 			}
+		}
+		for (Uint64 i = 0; i < buffers.size(); ++i)
+		{
+			if (buffers[i]->last_used_by != nullptr)
+			{
+				buffers[i]->last_used_by->buffer_destroys.insert(RGBufferId(i));
+			}
+		}
+	}
 
-			if (textures[i]->imported)
+	void RenderGraph::CalculateResourceAliasing()
+	{
+		if (!RGResourceAliasing.Get() || !gfx->GetCapabilities().SupportsResourceAliasing())
+		{
+			return;
+		}
+
+		RGResourceSet<RGTextureId> async_textures;
+		RGResourceSet<RGBufferId> async_buffers;
+		async_textures.Initialize(allocator, textures.size());
+		async_buffers.Initialize(allocator, buffers.size());
+#if GFX_ASYNC_COMPUTE
+		if (RGAsyncCompute.Get())
+		{
+			for (RGPassBase* pass : passes)
 			{
-				CreateTextureViews(RGTextureId(i));
+				if (pass->IsCulled() || pass->type != RGPassType::AsyncCompute)
+				{
+					continue;
+				}
+				async_textures.insert(pass->texture_creates.begin(), pass->texture_creates.end());
+				async_textures.insert(pass->texture_reads.begin(), pass->texture_reads.end());
+				async_textures.insert(pass->texture_writes.begin(), pass->texture_writes.end());
+				async_buffers.insert(pass->buffer_creates.begin(), pass->buffer_creates.end());
+				async_buffers.insert(pass->buffer_reads.begin(), pass->buffer_reads.end());
+				async_buffers.insert(pass->buffer_writes.begin(), pass->buffer_writes.end());
+			}
+		}
+#endif
+
+		RGVector<Uint32> texture_first_level(textures.size(), UINT32_MAX, allocator), texture_last_level(textures.size(), UINT32_MAX, allocator);
+		RGVector<Uint32> buffer_first_level(buffers.size(), UINT32_MAX, allocator), buffer_last_level(buffers.size(), UINT32_MAX, allocator);
+		for (Uint32 i = 0; i < dependency_levels.size(); ++i)
+		{
+			DependencyLevel const& dependency_level = dependency_levels[i];
+			for (RGTextureId id : dependency_level.texture_creates)  texture_first_level[id.id] = i;
+			for (RGTextureId id : dependency_level.texture_destroys) texture_last_level[id.id] = i;
+			for (RGBufferId id : dependency_level.buffer_creates)    buffer_first_level[id.id] = i;
+			for (RGBufferId id : dependency_level.buffer_destroys)   buffer_last_level[id.id] = i;
+		}
+
+		static constexpr Uint32 HeapUsageCount = (Uint32)GfxHeapUsage::Count;
+		RGVector<RGVector<RGAliasingRequest>> requests(HeapUsageCount, RGVector<RGAliasingRequest>(allocator), allocator);
+		RGVector<RGVector<RenderGraphResource*>> aliased_resources(HeapUsageCount, RGVector<RenderGraphResource*>(allocator), allocator);
+		for (Uint64 i = 0; i < textures.size(); ++i)
+		{
+			RGTexture* rg_texture = textures[i];
+			GfxTextureDesc const& desc = rg_texture->desc;
+			if (rg_texture->imported || desc.heap_type != GfxResourceUsage::Default || HasFlag(desc.misc_flags, GfxTextureMiscFlag::Shared))
+			{
+				continue;
+			}
+			if (texture_first_level[i] == UINT32_MAX || texture_last_level[i] == UINT32_MAX || async_textures.contains(RGTextureId(i)))
+			{
+				continue;
 			}
+
+			GfxHeapUsage usage = HasAnyFlag(desc.bind_flags, GfxBindFlag::RenderTarget | GfxBindFlag::DepthStencil) ? GfxHeapUsage::RenderTargets : GfxHeapUsage::Textures;
+			GfxAllocationInfo allocation_info = gfx->GetAllocationInfo(desc);
+			requests[(Uint32)usage].push_back(RGAliasingRequest{ allocation_info.size, allocation_info.alignment, texture_first_level[i], texture_last_level[i] });
+			aliased_resources[(Uint32)usage].push_back(rg_texture);
 		}
 		for (Uint64 i = 0; i < buffers.size(); ++i)
 		{
-			if (buffers[i]->last_used_by != nullptr)
+			RGBuffer* rg_buffer = buffers[i];
+			GfxBufferDesc const& desc = rg_buffer->desc;
+			if (rg_buffer->imported || desc.resource_usage != GfxResourceUsage::Default || HasAnyFlag(desc.misc_flags, GfxBufferMiscFlag::Shared | GfxBufferMiscFlag::AccelStruct))
 			{
-				buffers[i]->last_used_by->buffer_destroys.insert(RGBufferId(i));
+				continue;
+			}
+			if (buffer_first_level[i] == UINT32_MAX || buffer_last_level[i] == UINT32_MAX || async_buffers.contains(RGBufferId(i)))
+			{
+				continue;
 			}
 
-			if (buffers[i]->imported)
+			GfxAllocationInfo allocation_info = gfx->GetAllocationInfo(desc);
+			requests[(Uint32)GfxHeapUsage::Buffers].push_back(RGAliasingRequest{ allocation_info.size, allocation_info.alignment, buffer_first_level[i], buffer_last_level[i] });
+			aliased_resources[(Uint32)GfxHeapUsage::Buffers].push_back(rg_buffer);
+		}
+
+		aliasing_stats = {};
+		aliasing_heap_sizes = {};
+		for (Uint32 usage = 0; usage < HeapUsageCount; ++usage)
+		{
+			if (requests[usage].empty())
 			{
-				CreateBufferViews(RGBufferId(i));
+				continue;
+			}
+
+			RGVector<Uint64> offsets(requests[usage].size(), 0, allocator);
+			RGAliasingStats stats = SolveResourceAliasing(requests[usage], offsets, allocator);
+			aliasing_heap_sizes[usage] = stats.heap_size;
+			GfxHeap* heap = pool.AllocateHeap((GfxHeapUsage)usage, stats.heap_size);
+			for (Uint64 i = 0; i < aliased_resources[usage].size(); ++i)
+			{
+				aliased_resources[usage][i]->heap = heap;
+				aliased_resources[usage][i]->heap_offset = offsets[i];
 			}
+			aliasing_stats += stats;
 		}
 	}
 
-	void RenderGraph::DepthFirstSearch(Uint64 i, std::vector<Bool>& visited, std::vector<Uint64>& topologically_sorted_passes)
+	void RenderGraph::BuildBarrierPlans()
 	{
-		visited[i] = true;
-		for (auto j : adjacency_lists[i])
+		barrier_plans.resize(dependency_levels.size(), RGBarrierPlan(allocator));
+		for (Uint64 i = 0; i < dependency_levels.size(); ++i)
 		{
-			if (!visited[j])
+			dependency_levels[i].BuildBarrierPlan(barrier_plans[i]);
+			dependency_levels[i].barrier_plan = &barrier_plans[i];
+		}
+
+		//a transition can begin once the last level using the previous state is done, the end stays in front of the first level using the new state
+		for (Uint64 i = 0; i < barrier_plans.size(); ++i)
+		{
+			for (RGTextureBarrier const& barrier : barrier_plans[i].pre_texture_barriers)
+			{
+				if (barrier.split_level != RG_INVALID_LEVEL)
+				{
+					RGTextureBarrier begin_barrier = barrier;
+					begin_barrier.split_level = (Uint32)i;
+					barrier_plans[barrier.split_level].begin_texture_barriers.push_back(begin_barrier);
+				}
+			}
+			for (RGBufferBarrier const& barrier : barrier_plans[i].pre_buffer_barriers)
 			{
-				DepthFirstSearch(j, visited, topologically_sorted_passes);
+				if (barrier.split_level != RG_INVALID_LEVEL)
+				{
+					RGBufferBarrier begin_barrier = barrier;
+					begin_barrier.split_level = (Uint32)i;
+					barrier_plans[barrier.split_level].begin_buffer_barriers.push_back(begin_barrier);
+				}
 			}
 		}
-		topologically_sorted_passes.push_back(i);
+
+		//released pool resources can be handed out again in the next level, their transitions have to be flushed separately
+		for (Uint64 i = 0; i + 1 < dependency_levels.size(); ++i)
+		{
+			DependencyLevel const& next_level = dependency_levels[i + 1];
+			barrier_plans[i].flush_post_barriers = !next_level.texture_creates.empty() || !next_level.buffer_creates.empty();
+		}
 	}
 
-	void RenderGraph::ResolveAsync()
+	//everything the compilation depends on was hashed while the graph was built, see RenderGraphBuilder and the declarations
+	Uint64 RenderGraph::HashTopology() const
 	{
-#if GFX_ASYNC_COMPUTE
-		if (!RGAsyncCompute.Get())
+		ZoneScopedN("RenderGraph::HashTopology");
+		HashState hash;
+		hash.Combine(RGCullPasses.Get());
+		hash.Combine(RGAsyncCompute.Get());
+		hash.Combine(RGResourceAliasing.Get());
+
+		hash.Combine(passes.size());
+		for (RGPassBase const* pass : passes)
 		{
-			return;
+			hash.Combine((Uint64)pass->setup_hash);
 		}
+		hash.Combine(textures.size());
+		for (RGTexture const* texture : textures)
+		{
+			hash.Combine(texture->declaration_hash);
+		}
+		hash.Combine(buffers.size());
+		for (RGBuffer const* buffer : buffers)
+		{
+			hash.Combine(buffer->declaration_hash);
+		}
+		return hash;
+	}
 
-		std::vector<RGPassBase*> compute_queue_passes;
-		std::unordered_set<RGPassBase*> pre_graphics_queue_passes;
-		std::unordered_set<RGPassBase*> post_graphics_queue_passes;
-		Uint64 compute_fence = 0;
-		Uint64 graphics_fence = 0;
+	void RenderGraph::LoadCompiledGraph()
+	{
+		ZoneScopedN("RenderGraph::LoadCompiledGraph");
+		RGCompileCache::CompiledGraph const& cache = *compile_cache->compiled_graph;
+		ADRIA_ASSERT(cache.passes.size() == passes.size());
+		ADRIA_ASSERT(cache.textures.size() == textures.size() && cache.buffers.size() == buffers.size());
 
-		for (Uint64 pass_index : topologically_sorted_passes)
+		adjacency_lists.reserve(cache.adjacency_lists.size());
+		for (RGVector<Uint64> const& adjacency_list : cache.adjacency_lists)
 		{
-			RGPassBase* pass = passes[pass_index];
-			if (pass->IsCulled())
+			adjacency_lists.emplace_back(adjacency_list.begin(), adjacency_list.end(), allocator);
+		}
+		topologically_sorted_passes.assign(cache.topologically_sorted_passes.begin(), cache.topologically_sorted_passes.end());
+		dependency_levels.reserve(cache.level_count);
+		for (Uint32 i = 0; i < cache.level_count; ++i)
+		{
+			dependency_levels.emplace_back(*this, i);
+		}
+		for (Uint64 i = 0; i < passes.size(); ++i)
+		{
+			RGPassBase* pass = passes[i];
+			RGCompileCache::CompiledPass const& compiled_pass = cache.passes[i];
+			pass->ref_count = compiled_pass.ref_count;
+			pass->wait_graphics_pass_id = compiled_pass.wait_graphics_pass_id;
+			pass->signal_graphics_pass_id = compiled_pass.signal_graphics_pass_id;
+			pass->signal_value = compiled_pass.signal_value;
+			pass->wait_value = compiled_pass.wait_value;
+			auto const events_to_start_begin = cache.events_to_start.begin() + compiled_pass.first_event_to_start;
+			pass->events_to_start.assign(events_to_start_begin, events_to_start_begin + compiled_pass.event_to_start_count);
+			pass->num_events_to_end = compiled_pass.num_events_to_end;
+			dependency_levels[compiled_pass.level].AddPass(pass);
+		}
+
+		std::array<GfxHeap*, (Uint32)GfxHeapUsage::Count> heaps{};
+		for (Uint32 usage = 0; usage < heaps.size(); ++usage)
+		{
+			if (cache.heap_sizes[usage] > 0)
 			{
-				continue;
+				heaps[usage] = pool.AllocateHeap((GfxHeapUsage)usage, cache.heap_sizes[usage]);
+			}
+		}
+		for (Uint64 i = 0; i < textures.size(); ++i)
+		{
+			RGTexture* rg_texture = textures[i];
+			RGCompileCache::CompiledResource const& compiled_texture = cache.textures[i];
+			rg_texture->ref_count = compiled_texture.ref_count;
+			if (compiled_texture.last_used_by != UINT64_MAX)
+			{
+				rg_texture->last_used_by = passes[compiled_texture.last_used_by];
+				rg_texture->last_used_by->texture_destroys.insert(RGTextureId(i));
+			}
+			if (compiled_texture.heap_usage != GfxHeapUsage::Count)
+			{
+				rg_texture->heap = heaps[(Uint32)compiled_texture.heap_usage];
+				rg_texture->heap_offset = compiled_texture.heap_offset;
 			}
+		}
+		for (Uint64 i = 0; i < buffers.size(); ++i)
+		{
+			RGBuffer* rg_buffer = buffers[i];
+			RGCompileCache::CompiledResource const& compiled_buffer = cache.buffers[i];
+			rg_buffer->ref_count = compiled_buffer.ref_count;
+			if (compiled_buffer.last_used_by != UINT64_MAX)
+			{
+				rg_buffer->last_used_by = passes[compiled_buffer.last_used_by];
+				rg_buffer->last_used_by->buffer_destroys.insert(RGBufferId(i));
+			}
+			if (compiled_buffer.heap_usage != GfxHeapUsage::Count)
+			{
+				rg_buffer->heap = heaps[(Uint32)compiled_buffer.heap_usage];
+				rg_buffer->heap_offset = compiled_buffer.heap_offset;
+			}
+		}
 
-			if (pass->type == RGPassType::AsyncCompute)
+		for (Uint64 i = 0; i < dependency_levels.size(); ++i)
+		{
+			dependency_levels[i].Setup();
+			dependency_levels[i].barrier_plan = &cache.barrier_plans[i];
+		}
+		aliasing_stats = cache.aliasing_stats;
+		aliasing_heap_sizes = cache.heap_sizes;
+	}
+
+	void RenderGraph::StoreCompiledGraph(Uint64 topology_hash)
+	{
+		ZoneScopedN("RenderGraph::StoreCompiledGraph");
+		compile_cache->valid = true;
+		compile_cache->topology_hash = topology_hash;
+		compile_cache->compiled_graph.reset();
+		compile_cache->allocator.Reset();
+		RGAllocator& cache_allocator = compile_cache->allocator;
+		RGCompileCache::CompiledGraph& cache = compile_cache->compiled_graph.emplace(cache_allocator);
+
+		cache.adjacency_lists.reserve(adjacency_lists.size());
+		for (RGVector<Uint64> const& adjacency_list : adjacency_lists)
+		{
+			cache.adjacency_lists.emplace_back(adjacency_list.begin(), adjacency_list.end(), cache_allocator);
+		}
+		cache.topologically_sorted_passes.assign(topologically_sorted_passes.begin(), topologically_sorted_passes.end());
+		cache.level_count = (Uint32)dependency_levels.size();
+
+		cache.passes.resize(passes.size());
+		for (Uint32 level = 0; level < dependency_levels.size(); ++level)
+		{
+			for (RGPassBase const* pass : dependency_levels[level].passes)
+			{
+				RGCompileCache::CompiledPass& compiled_pass = cache.passes[pass->id];
+				compiled_pass.level = level;
+				compiled_pass.ref_count = pass->ref_count;
+				compiled_pass.wait_graphics_pass_id = pass->wait_graphics_pass_id;
+				compiled_pass.signal_graphics_pass_id = pass->signal_graphics_pass_id;
+				compiled_pass.signal_value = pass->signal_value;
+				compiled_pass.wait_value = pass->wait_value;
+				compiled_pass.first_event_to_start = (Uint32)cache.events_to_start.size();
+				compiled_pass.event_to_start_count = (Uint32)pass->events_to_start.size();
+				cache.events_to_start.insert(cache.events_to_start.end(), pass->events_to_start.begin(), pass->events_to_start.end());
+				compiled_pass.num_events_to_end = pass->num_events_to_end;
+			}
+		}
+
+		auto StoreResource = [](RenderGraphResource const& resource, RGCompileCache::CompiledResource& compiled_resource)
 			{
-				for (RGTextureId read_texture : pass->texture_reads)
-				{
-					for (Int64 i = (Int64)pass_index - 1; i >= 0; --i)
-					{
-						RGPassBase* pre_pass = passes[i];
-						if (pre_pass->IsCulled() || pre_pass->type == RGPassType::AsyncCompute)
-						{
-							continue;
-						}
+				compiled_resource.ref_count = resource.ref_count;
+				compiled_resource.last_used_by = resource.last_used_by ? resource.last_used_by->id : UINT64_MAX;
+				compiled_resource.heap_usage = resource.heap ? resource.heap->GetDesc().usage : GfxHeapUsage::Count;
+				compiled_resource.heap_offset = resource.heap_offset;
+			};
+		cache.textures.resize(textures.size());
+		for (Uint64 i = 0; i < textures.size(); ++i)
+		{
+			StoreResource(*textures[i], cache.textures[i]);
+		}
+		cache.buffers.resize(buffers.size());
+		for (Uint64 i = 0; i < buffers.size(); ++i)
+		{
+			StoreResource(*buffers[i], cache.buffers[i]);
+		}
 
-						if (pre_pass->texture_writes.find(read_texture) != pre_pass->texture_writes.end())
-						{
-							pre_graphics_queue_passes.insert(pre_pass);
-							break;
-						}
-					}
+		cache.barrier_plans.reserve(barrier_plans.size());
+		for (RGBarrierPlan const& barrier_plan : barrier_plans)
+		{
+			cache.barrier_plans.emplace_back(barrier_plan, cache_allocator);
+		}
+		for (Uint64 i = 0; i < dependency_levels.size(); ++i)
+		{
+			dependency_levels[i].barrier_plan = &cache.barrier_plans[i];
+		}
+		cache.heap_sizes = aliasing_heap_sizes;
+		cache.aliasing_stats = aliasing_stats;
+	}
+
+	void RenderGraph::DepthFirstSearch(Uint64 i, RGVector<Bool>& visited, RGVector<Uint64>& topologically_sorted_passes)
+	{
+		RGVector<std::pair<Uint64, Uint64>> stack(allocator);
+		visited[i] = true;
+		stack.emplace_back(i, 0);
+		while (!stack.empty())
+		{
+			auto& [pass_idx, next_edge] = stack.back();
+			RGVector<Uint64> const& adjacency_list = adjacency_lists[pass_idx];
+			if (next_edge < adjacency_list.size())
+			{
+				Uint64 j = adjacency_list[next_edge++];
+				if (!visited[j])
+				{
+					visited[j] = true;
+					stack.emplace_back(j, 0);
 				}
-				for (RGBufferId read_buffer : pass->buffer_reads)
+			}
+			else
+			{
+				topologically_sorted_passes.push_back(pass_idx);
+				stack.pop_back();
+			}
+		}
+	}
+
+	void RenderGraph::ResolveAsync()
+	{
+#if GFX_ASYNC_COMPUTE
+		if (!RGAsyncCompute.Get())
+		{
+			return;
+		}
+
+		//for every async compute pass find the latest graphics pass writing one of its reads
+		//and the earliest graphics pass reading one of its writes
+		RGVector<Uint64> async_pre_pass(passes.size(), UINT64_MAX, allocator);
+		RGVector<Uint64> async_post_pass(passes.size(), UINT64_MAX, allocator);
+		{
+			RGVector<Uint64> texture_graphics_writers(textures.size(), UINT64_MAX, allocator);
+			RGVector<Uint64> buffer_graphics_writers(buffers.size(), UINT64_MAX, allocator);
+			auto FindPrePass = [](Uint64& pre_pass, auto const& reads, RGVector<Uint64> const& graphics_writers)
 				{
-					for (Int64 i = (Int64)pass_index - 1; i >= 0; --i)
+					for (auto const& id : reads)
 					{
-						RGPassBase* pre_pass = passes[i];
-						if (pre_pass->IsCulled() || pre_pass->type == RGPassType::AsyncCompute)
-						{
-							continue;
-						}
-
-						if (pre_pass->buffer_writes.find(read_buffer) != pre_pass->buffer_writes.end())
+						Uint64 writer = graphics_writers[id.id];
+						if (writer != UINT64_MAX && (pre_pass == UINT64_MAX || writer > pre_pass))
 						{
-							pre_graphics_queue_passes.insert(pre_pass);
-							break;
+							pre_pass = writer;
 						}
 					}
+				};
+			for (Uint64 i = 0; i < passes.size(); ++i)
+			{
+				RGPassBase* pass = passes[i];
+				if (pass->IsCulled())
+				{
+					continue;
+				}
+
+				if (pass->type == RGPassType::AsyncCompute)
+				{
+					FindPrePass(async_pre_pass[i], pass->texture_reads, texture_graphics_writers);
+					FindPrePass(async_pre_pass[i], pass->buffer_reads, buffer_graphics_writers);
+				}
+				else
+				{
+					for (RGTextureId id : pass->texture_writes) texture_graphics_writers[id.id] = i;
+					for (RGBufferId id : pass->buffer_writes)   buffer_graphics_writers[id.id] = i;
 				}
-				for (RGTextureId write_texture : pass->texture_writes)
+			}
+		}
+		{
+			RGVector<Uint64> texture_graphics_readers(textures.size(), UINT64_MAX, allocator);
+			RGVector<Uint64> buffer_graphics_readers(buffers.size(), UINT64_MAX, allocator);
+			auto FindPostPass = [](Uint64& post_pass, auto const& writes, RGVector<Uint64> const& graphics_readers)
 				{
-					for (Uint64 i = pass_index + 1; i < passes.size(); ++i)
+					for (auto const& id : writes)
 					{
-						RGPassBase* post_pass = passes[i];
-						if (post_pass->IsCulled() || post_pass->type == RGPassType::AsyncCompute)
-						{
-							continue;
-						}
-
-						if (post_pass->texture_reads.find(write_texture) != post_pass->texture_reads.end())
-						{
-							post_graphics_queue_passes.insert(post_pass);
-							break;
-						}
+						post_pass = std::min(post_pass, graphics_readers[id.id]);
 					}
+				};
+			for (Int64 i = (Int64)passes.size() - 1; i >= 0; --i)
+			{
+				RGPassBase* pass = passes[i];
+				if (pass->IsCulled())
+				{
+					continue;
 				}
-				for (RGBufferId write_buffer : pass->buffer_writes)
+
+				if (pass->type == RGPassType::AsyncCompute)
 				{
-					for (Uint64 i = pass_index + 1; i < passes.size(); ++i)
-					{
-						RGPassBase* post_pass = passes[i];
-						if (post_pass->IsCulled() || post_pass->type == RGPassType::AsyncCompute)
-						{
-							continue;
-						}
+					FindPostPass(async_post_pass[i], pass->texture_writes, texture_graphics_readers);
+					FindPostPass(async_post_pass[i], pass->buffer_writes, buffer_graphics_readers);
+				}
+				else
+				{
+					for (RGTextureId id : pass->texture_reads) texture_graphics_readers[id.id] = i;
+					for (RGBufferId id : pass->buffer_reads)   buffer_graphics_readers[id.id] = i;
+				}
+			}
+		}
 
-						if (post_pass->buffer_reads.find(write_buffer) != post_pass->buffer_reads.end())
-						{
-							pre_graphics_queue_passes.insert(post_pass);
-							break;
-						}
-					}
+		RGVector<RGPassBase*> compute_queue_passes(allocator);
+		Uint64 last_pre_pass_idx = UINT64_MAX;
+		Uint64 first_post_pass_idx = UINT64_MAX;
+		Uint64 compute_fence = 0;
+		Uint64 graphics_fence = 0;
+
+		for (Uint64 pass_index : topologically_sorted_passes)
+		{
+			RGPassBase* pass = passes[pass_index];
+			if (pass->IsCulled())
+			{
+				continue;
+			}
+
+			if (pass->type == RGPassType::AsyncCompute)
+			{
+				Uint64 pre_pass_idx = async_pre_pass[pass_index];
+				if (pre_pass_idx != UINT64_MAX && (last_pre_pass_idx == UINT64_MAX || pre_pass_idx > last_pre_pass_idx))
+				{
+					last_pre_pass_idx = pre_pass_idx;
 				}
+				first_post_pass_idx = std::min(first_post_pass_idx, async_post_pass[pass_index]);
 				compute_queue_passes.push_back(pass);
 			}
 			else if (!compute_queue_passes.empty())
 			{
-				if (!pre_graphics_queue_passes.empty())
+				if (last_pre_pass_idx != UINT64_MAX)
 				{
-					RGPassBase* last_pre_pass = *std::max_element(
-						pre_graphics_queue_passes.begin(),
-						pre_graphics_queue_passes.end(),
-						[](RGPassBase* a, RGPassBase* b) { return a->id < b->id; }
-					);
-
+					RGPassBase* last_pre_pass = passes[last_pre_pass_idx];
 					if (last_pre_pass->signal_value == Uint64(-1))
 					{
 						last_pre_pass->signal_value = ++graphics_fence;
@@ -599,14 +1171,9 @@ namespace adria
 					first_compute_pass->wait_graphics_pass_id = last_pre_pass->id;
 				}
 
-				if (!post_graphics_queue_passes.empty())
+				if (first_post_pass_idx != UINT64_MAX)
 				{
-					RGPassBase* first_post_pass = *std::min_element(
-						post_graphics_queue_passes.begin(),
-						post_graphics_queue_passes.end(),
-						[](RGPassBase* a, RGPassBase* b) { return a->id < b->id; }
-					);
-
+					RGPassBase* first_post_pass = passes[first_post_pass_idx];
 					RGPassBase* last_compute_pass = compute_queue_passes.back();
 					if (last_compute_pass->signal_value == Uint64(-1))
 					{
@@ -617,8 +1184,8 @@ namespace adria
 					last_compute_pass->signal_graphics_pass_id = first_post_pass->id;
 				}
 				compute_queue_passes.clear();
-				pre_graphics_queue_passes.clear();
-				post_graphics_queue_passes.clear();
+				last_pre_pass_idx = UINT64_MAX;
+				first_post_pass_idx = UINT64_MAX;
 			}
 		}
 #endif
@@ -626,7 +1193,7 @@ namespace adria
 
 	void RenderGraph::ResolveEvents()
 	{
-		std::vector<Uint32> events_to_start;
+		RGVector<Uint32> events_to_start(allocator);
 		Uint32 events_to_add = 0;
 		RGPassBase* last_active_pass = nullptr;
 		for (RGPassBase* const pass : passes)
@@ -665,12 +1232,12 @@ namespace adria
 
 	RGTexture* RenderGraph::GetRGTexture(RGTextureId handle) const
 	{
-		return textures[handle.id].get();
+		return textures[handle.id];
 	}
 
 	RGBuffer* RenderGraph::GetRGBuffer(RGBufferId handle) const
 	{
-		return buffers[handle.id].get();
+		return buffers[handle.id];
 	}
 
 	GfxTexture* RenderGraph::GetTexture(RGTextureId res_id) const
@@ -685,7 +1252,8 @@ namespace adria
 
 	void RenderGraph::CreateTextureViews(RGTextureId res_id)
 	{
-		auto const& view_descs = texture_view_desc_map[res_id];
+		auto const& view_descs = texture_view_descs[res_id.id];
+		Bool const imported = GetRGTexture(res_id)->imported;
 		for (auto const& [view_desc, type] : view_descs)
 		{
 			GfxTexture* texture = GetTexture(res_id);
@@ -693,12 +1261,26 @@ namespace adria
 			switch (type)
 			{
 			case RGDescriptorType::RenderTarget:
-				view = gfx->CreateTextureRTV(texture, &view_desc);
-				texture_views_to_free.push_back(view);
+				if (imported)
+				{
+					view = gfx->CreateTextureRTV(texture, &view_desc);
+					texture_views_to_free.push_back(view);
+				}
+				else
+				{
+					view = pool.GetTextureView(texture, GfxSubresourceType::RTV, view_desc);
+				}
 				break;
 			case RGDescriptorType::DepthStencil:
-				view = gfx->CreateTextureDSV(texture, &view_desc);
-				texture_views_to_free.push_back(view);
+				if (imported)
+				{
+					view = gfx->CreateTextureDSV(texture, &view_desc);
+					texture_views_to_free.push_back(view);
+				}
+				else
+				{
+					view = pool.GetTextureView(texture, GfxSubresourceType::DSV, view_desc);
+				}
 				break;
 			case RGDescriptorType::ReadOnly:
 				view = gfx->CreateTextureSRV(texture, &view_desc);
@@ -709,13 +1291,13 @@ namespace adria
 			default:
 				ADRIA_ASSERT_MSG(false, "invalid resource view type for texture");
 			}
-			texture_view_map[res_id].push_back(view);
+			texture_views[res_id.id].push_back(view);
 		}
 	}
 
 	void RenderGraph::CreateBufferViews(RGBufferId res_id)
 	{
-		auto const& view_descs = buffer_view_desc_map[res_id];
+		auto const& view_descs = buffer_view_descs[res_id.id];
 		for (Uint64 i = 0; i < view_descs.size(); ++i)
 		{
 			auto const& [view_desc, type] = view_descs[i];
@@ -747,7 +1329,25 @@ namespace adria
 			default:
 				ADRIA_ASSERT_MSG(false, "invalid resource view type for buffer");
 			}
-			buffer_view_map[res_id].push_back(view);
+			buffer_views[res_id.id].push_back(view);
+		}
+	}
+
+	void RenderGraph::CreateImportedResourceViews()
+	{
+		for (Uint64 i = 0; i < textures.size(); ++i)
+		{
+			if (textures[i]->imported)
+			{
+				CreateTextureViews(RGTextureId(i));
+			}
+		}
+		for (Uint64 i = 0; i < buffers.size(); ++i)
+		{
+			if (buffers[i]->imported)
+			{
+				CreateBufferViews(RGBufferId(i));
+			}
 		}
 	}
 
@@ -873,7 +1473,7 @@ namespace adria
 		{
 			rg_texture->desc.initial_state = GfxResourceState::RTV;
 		}
-		std::vector<std::pair<GfxTextureDescriptorDesc, RGDescriptorType>>& view_descs = texture_view_desc_map[handle];
+		auto& view_descs = texture_view_descs[handle.id];
 		for (Uint64 i = 0; i < view_descs.size(); ++i)
 		{
 			auto const& [_desc, _type] = view_descs[i];
@@ -897,7 +1497,7 @@ namespace adria
 		{
 			rg_texture->desc.initial_state = GfxResourceState::DSV;
 		}
-		std::vector<std::pair<GfxTextureDescriptorDesc, RGDescriptorType>>& view_descs = texture_view_desc_map[handle];
+		auto& view_descs = texture_view_descs[handle.id];
 		for (Uint64 i = 0; i < view_descs.size(); ++i)
 		{
 			auto const& [_desc, _type] = view_descs[i];
@@ -921,7 +1521,7 @@ namespace adria
 		{
 			rg_texture->desc.initial_state = GfxResourceState::PixelSRV | GfxResourceState::ComputeSRV;
 		}
-		std::vector<std::pair<GfxTextureDescriptorDesc, RGDescriptorType>>& view_descs = texture_view_desc_map[handle];
+		auto& view_descs = texture_view_descs[handle.id];
 		for (Uint64 i = 0; i < view_descs.size(); ++i)
 		{
 			auto const& [_desc, _type] = view_descs[i];
@@ -945,7 +1545,7 @@ namespace adria
 		{
 			rg_texture->desc.initial_state = GfxResourceState::AllUAV;
 		}
-		std::vector<std::pair<GfxTextureDescriptorDesc, RGDescriptorType>>& view_descs = texture_view_desc_map[handle];
+		auto& view_descs = texture_view_descs[handle.id];
 		for (Uint64 i = 0; i < view_descs.size(); ++i)
 		{
 			auto const& [_desc, _type] = view_descs[i];
@@ -965,7 +1565,7 @@ namespace adria
 		ADRIA_ASSERT_MSG(IsValidBufferHandle(handle), "Resource has not been declared!");
 		RGBuffer* rg_buffer = GetRGBuffer(handle);
 		rg_buffer->desc.bind_flags |= GfxBindFlag::ShaderResource;
-		std::vector<std::pair<GfxBufferDescriptorDesc, RGDescriptorType>>& view_descs = buffer_view_desc_map[handle];
+		auto& view_descs = buffer_view_descs[handle.id];
 		for (Uint64 i = 0; i < view_descs.size(); ++i)
 		{
 			auto const& [_desc, _type] = view_descs[i];
@@ -985,7 +1585,7 @@ namespace adria
 		ADRIA_ASSERT_MSG(IsValidBufferHandle(handle), "Resource has not been declared!");
 		RGBuffer* rg_buffer = GetRGBuffer(handle);
 		rg_buffer->desc.bind_flags |= GfxBindFlag::UnorderedAccess;
-		std::vector<std::pair<GfxBufferDescriptorDesc, RGDescriptorType>>& view_descs = buffer_view_desc_map[handle];
+		auto& view_descs = buffer_view_descs[handle.id];
 		for (Uint64 i = 0; i < view_descs.size(); ++i)
 		{
 			auto const& [_desc, _type] = view_descs[i];
@@ -1012,7 +1612,7 @@ namespace adria
 		rg_buffer->desc.bind_flags |= GfxBindFlag::UnorderedAccess;
 		rg_counter_buffer->desc.bind_flags |= GfxBindFlag::UnorderedAccess;
 
-		std::vector<std::pair<GfxBufferDescriptorDesc, RGDescriptorType>>& view_descs = buffer_view_desc_map[handle];
+		auto& view_descs = buffer_view_descs[handle.id];
 		for (Uint64 i = 0; i < view_descs.size(); ++i)
 		{
 			auto const& [_desc, _type] = view_descs[i];
@@ -1078,42 +1678,42 @@ namespace adria
 	GfxDescriptor RenderGraph::GetRenderTarget(RGRenderTargetId res_id) const
 	{
 		RGTextureId tex_id = res_id.GetResourceId();
-		auto const& views = texture_view_map[tex_id];
+		auto const& views = texture_views[tex_id.id];
 		return views[res_id.GetViewId()];
 	}
 
 	GfxDescriptor RenderGraph::GetDepthStencil(RGDepthStencilId res_id) const
 	{
 		RGTextureId tex_id = res_id.GetResourceId();
-		auto const& views = texture_view_map[tex_id];
+		auto const& views = texture_views[tex_id.id];
 		return views[res_id.GetViewId()];
 	}
 
 	GfxDescriptor RenderGraph::GetReadOnlyTexture(RGTextureReadOnlyId res_id) const
 	{
 		RGTextureId tex_id = res_id.GetResourceId();
-		auto const& views = texture_view_map[tex_id];
+		auto const& views = texture_views[tex_id.id];
 		return views[res_id.GetViewId()];
 	}
 
 	GfxDescriptor RenderGraph::GetReadWriteTexture(RGTextureReadWriteId res_id) const
 	{
 		RGTextureId tex_id = res_id.GetResourceId();
-		auto const& views = texture_view_map[tex_id];
+		auto const& views = texture_views[tex_id.id];
 		return views[res_id.GetViewId()];
 	}
 
 	GfxDescriptor RenderGraph::GetReadOnlyBuffer(RGBufferReadOnlyId res_id) const
 	{
 		RGBufferId buf_id = res_id.GetResourceId();
-		auto const& views = buffer_view_map[buf_id];
+		auto const& views = buffer_views[buf_id.id];
 		return views[res_id.GetViewId()];
 	}
 
 	GfxDescriptor RenderGraph::GetReadWriteBuffer(RGBufferReadWriteId res_id) const
 	{
 		RGBufferId buf_id = res_id.GetResourceId();
-		auto const& views = buffer_view_map[buf_id];
+		auto const& views = buffer_views[buf_id.id];
 		return views[res_id.GetViewId()];
 	}
 
@@ -1141,6 +1741,22 @@ namespace adria
 		return gfx->GetBindlessDescriptorIndex(descriptor);
 	}
 
+	RenderGraph::DependencyLevel::DependencyLevel(RenderGraph& rg, Uint32 level_index) : rg(rg), level_index(level_index), passes(rg.allocator)
+	{
+		Uint64 const texture_count = rg.textures.size();
+		Uint64 const buffer_count = rg.buffers.size();
+		texture_creates.Initialize(rg.allocator, texture_count);
+		texture_reads.Initialize(rg.allocator);
+		texture_writes.Initialize(rg.allocator);
+		texture_destroys.Initialize(rg.allocator);
+		texture_state_map.Initialize(rg.allocator, texture_count);
+		buffer_creates.Initialize(rg.allocator, buffer_count);
+		buffer_reads.Initialize(rg.allocator);
+		buffer_writes.Initialize(rg.allocator);
+		buffer_destroys.Initialize(rg.allocator);
+		buffer_state_map.Initialize(rg.allocator, buffer_count);
+	}
+
 	void RenderGraph::DependencyLevel::AddPass(RenderGraphPassBase* pass)
 	{
 		passes.push_back(pass);
@@ -1177,7 +1793,27 @@ namespace adria
 
 	void RenderGraph::DependencyLevel::Execute(RenderGraphExecutionContext const& exec_ctx)
 	{
-		PreExecute(exec_ctx.graphics_cmd_list);
+		AllocateResources();
+		Record(exec_ctx);
+		ReleaseResources();
+	}
+
+	Uint32 RenderGraph::DependencyLevel::GetActivePassCount() const
+	{
+		Uint32 active_pass_count = 0;
+		for (RenderGraphPassBase* pass : passes)
+		{
+			if (!pass->IsCulled())
+			{
+				++active_pass_count;
+			}
+		}
+		return active_pass_count;
+	}
+
+	void RenderGraph::DependencyLevel::Record(RenderGraphExecutionContext const& exec_ctx)
+	{
+		PreExecute(exec_ctx);
 		for (auto& pass : passes)
 		{
 			if (pass->IsCulled())
@@ -1213,9 +1849,11 @@ namespace adria
 			RenderGraphContext render_graph_ctx(rg, *pass, cmd_list);
 			if (pass->type == RGPassType::Graphics)
 			{
+				ADRIA_ASSERT(pass->render_targets_info.size() <= GFX_MAX_RENDER_TARGETS);
+				std::array<GfxColorAttachmentDesc, GFX_MAX_RENDER_TARGETS> rtv_attachments{};
+				Uint32 rtv_attachment_count = 0;
 				GfxRenderPassDesc render_pass_desc{};
 				render_pass_desc.flags = GfxRenderPassFlagBit_None;
-				render_pass_desc.rtv_attachments.reserve(pass->render_targets_info.size());
 				for (auto const& render_target_info : pass->render_targets_info)
 				{
 					GfxColorAttachmentDesc rtv_desc{};
@@ -1278,8 +1916,9 @@ namespace adria
 					}
 
 					rtv_desc.cpu_handle = rg.GetRenderTarget(render_target_info.render_target_handle);
-					render_pass_desc.rtv_attachments.push_back(rtv_desc);
+					rtv_attachments[rtv_attachment_count++] = rtv_desc;
 				}
+				render_pass_desc.rtv_attachments = std::span<GfxColorAttachmentDesc const>(rtv_attachments.data(), rtv_attachment_count);
 
 				if (pass->depth_stencil.has_value())
 				{
@@ -1356,8 +1995,8 @@ namespace adria
 				render_pass_desc.height = pass->viewport_height;
 				render_pass_desc.legacy = pass->UseLegacyRenderPasses();
 
-				ZoneTransientN(__tracy, pass->name.c_str(), true);
-				AdriaGfxScopedEvent(cmd_list, pass->name.c_str());
+				ZoneTransientN(__tracy, pass->name, true);
+				AdriaGfxScopedEvent(cmd_list, pass->name);
 				cmd_list->SetContext(GfxCommandList::Context::Graphics);
 				cmd_list->BeginRenderPass(render_pass_desc);
 				pass->Execute(render_graph_ctx);
@@ -1365,8 +2004,8 @@ namespace adria
 			}
 			else
 			{
-				ZoneTransientN(__tracy, pass->name.c_str(), true);
-				AdriaGfxScopedEvent(cmd_list, pass->name.c_str());
+				ZoneTransientN(__tracy, pass->name, true);
+				AdriaGfxScopedEvent(cmd_list, pass->name);
 				cmd_list->SetContext(GfxCommandList::Context::Compute);
 				pass->Execute(render_graph_ctx);
 			}
@@ -1393,54 +2032,54 @@ namespace adria
 				cmd_list->Begin();
 			}
 		} 
-		PostExecute(exec_ctx.graphics_cmd_list);
+		PostExecute(exec_ctx);
 	}
 
-	void RenderGraph::DependencyLevel::PreExecute(GfxCommandList* cmd_list)
+	void RenderGraph::DependencyLevel::BuildBarrierPlan(RGBarrierPlan& plan) const
 	{
 		for (RGTextureId tex_id : texture_creates)
 		{
 			RGTexture* rg_texture = rg.GetRGTexture(tex_id);
-			if (!rg_texture->imported)
+			if (rg_texture->heap != nullptr && !texture_state_map.contains(tex_id))
 			{
-				rg_texture->resource = rg.pool.AllocateTexture(rg_texture->desc);
+				plan.pre_texture_barriers.push_back(RGTextureBarrier{ tex_id, GfxResourceState::Discard, rg_texture->desc.initial_state, false });
 			}
-			rg.CreateTextureViews(tex_id);
-			rg_texture->SetName();
 		}
 		for (RGBufferId buf_id : buffer_creates)
 		{
 			RGBuffer* rg_buffer = rg.GetRGBuffer(buf_id);
-			if (!rg_buffer->imported)
+			if (rg_buffer->heap != nullptr && !buffer_state_map.contains(buf_id))
 			{
-				rg_buffer->resource = rg.pool.AllocateBuffer(rg_buffer->desc);
+				plan.pre_buffer_barriers.push_back(RGBufferBarrier{ buf_id, GfxResourceState::Discard, GfxResourceState::Common });
 			}
-			rg.CreateBufferViews(buf_id);
-			rg_buffer->SetName();
 		}
 
 		for (auto const& [tex_id, state] : texture_state_map)
 		{
 			RGTexture* rg_texture = rg.GetRGTexture(tex_id);
-			GfxTexture* texture = rg_texture->resource;
 			if (texture_creates.contains(tex_id))
 			{
-				if (!HasFlag(texture->GetDesc().initial_state, state))
+				if (rg_texture->heap != nullptr)
+				{
+					plan.pre_texture_barriers.push_back(RGTextureBarrier{ tex_id, GfxResourceState::Discard, state, false });
+				}
+				else
 				{
-					cmd_list->TextureBarrier(*texture, texture->GetDesc().initial_state, state);
+					plan.pre_texture_barriers.push_back(RGTextureBarrier{ tex_id, GfxResourceState::Common, state, true });
 				}
 				continue;
 			}
 			Bool found = false;
 			for (Int32 j = (Int32)level_index - 1; j >= 0; --j)
 			{
-				auto& prev_dependency_level = rg.dependency_levels[j];
-				if (prev_dependency_level.texture_state_map.contains(tex_id))
+				auto const& prev_texture_state_map = rg.dependency_levels[j].texture_state_map;
+				if (prev_texture_state_map.contains(tex_id))
 				{
-					GfxResourceState prev_state = prev_dependency_level.texture_state_map[tex_id];
+					GfxResourceState prev_state = prev_texture_state_map.at(tex_id);
 					if (prev_state != state)
 					{
-						cmd_list->TextureBarrier(*texture, prev_state, state);
+						Uint32 split_level = (Uint32)j + 1 < level_index ? (Uint32)j : RG_INVALID_LEVEL;
+						plan.pre_texture_barriers.push_back(RGTextureBarrier{ tex_id, prev_state, state, false, split_level });
 					}
 					found = true;
 					break;
@@ -1451,32 +2090,36 @@ namespace adria
 				GfxResourceState prev_state = rg_texture->desc.initial_state;
 				if (prev_state != state)
 				{
-					cmd_list->TextureBarrier(*texture, prev_state, state);
+					plan.pre_texture_barriers.push_back(RGTextureBarrier{ tex_id, prev_state, state, false });
 				}
 			}
 		}
 		for (auto const& [buf_id, state] : buffer_state_map)
 		{
 			RGBuffer* rg_buffer = rg.GetRGBuffer(buf_id);
-			GfxBuffer* buffer = rg_buffer->resource;
 			if (buffer_creates.contains(buf_id))
 			{
-				if (state != GfxResourceState::Common)
+				if (rg_buffer->heap != nullptr)
 				{
-					cmd_list->BufferBarrier(*buffer, GfxResourceState::Common, state);
+					plan.pre_buffer_barriers.push_back(RGBufferBarrier{ buf_id, GfxResourceState::Discard, state });
+				}
+				else if (state != GfxResourceState::Common)
+				{
+					plan.pre_buffer_barriers.push_back(RGBufferBarrier{ buf_id, GfxResourceState::Common, state });
 				}
 				continue;
 			}
 			Bool found = false;
 			for (Int32 j = (Int32)level_index - 1; j >= 0; --j)
 			{
-				auto& prev_dependency_level = rg.dependency_levels[j];
-				if (prev_dependency_level.buffer_state_map.contains(buf_id))
+				auto const& prev_buffer_state_map = rg.dependency_levels[j].buffer_state_map;
+				if (prev_buffer_state_map.contains(buf_id))
 				{
-					GfxResourceState prev_state = prev_dependency_level.buffer_state_map[buf_id];
+					GfxResourceState prev_state = prev_buffer_state_map.at(buf_id);
 					if (prev_state != state)
 					{
-						cmd_list->BufferBarrier(*buffer, prev_state, state);
+						Uint32 split_level = (Uint32)j + 1 < level_index ? (Uint32)j : RG_INVALID_LEVEL;
+						plan.pre_buffer_barriers.push_back(RGBufferBarrier{ buf_id, prev_state, state, split_level });
 					}
 					found = true;
 					break;
@@ -1486,26 +2129,56 @@ namespace adria
 			{
 				if (GfxResourceState::Common != state)
 				{
-					cmd_list->BufferBarrier(*buffer, GfxResourceState::Common, state);
+					plan.pre_buffer_barriers.push_back(RGBufferBarrier{ buf_id, GfxResourceState::Common, state });
 				}
 			}
 		}
-		cmd_list->FlushBarriers();
+
+		for (RGTextureId tex_id : texture_destroys)
+		{
+			ADRIA_ASSERT(texture_state_map.contains(tex_id));
+			plan.post_texture_barriers.push_back(RGTextureBarrier{ tex_id, texture_state_map.at(tex_id), GfxResourceState::Common, true });
+		}
+		for (RGBufferId buf_id : buffer_destroys)
+		{
+			ADRIA_ASSERT(buffer_state_map.contains(buf_id));
+			GfxResourceState state = buffer_state_map.at(buf_id);
+			if (state != GfxResourceState::Common)
+			{
+				plan.post_buffer_barriers.push_back(RGBufferBarrier{ buf_id, state, GfxResourceState::Common });
+			}
+		}
 	}
 
-	void RenderGraph::DependencyLevel::PostExecute(GfxCommandList* cmd_list)
+	void RenderGraph::DependencyLevel::AllocateResources()
 	{
-		for (RGTextureId tex_id : texture_destroys)
+		for (RGTextureId tex_id : texture_creates)
 		{
 			RGTexture* rg_texture = rg.GetRGTexture(tex_id);
-			GfxTexture* texture = rg_texture->resource;
-			GfxResourceState initial_state = texture->GetDesc().initial_state;
-			ADRIA_ASSERT(texture_state_map.contains(tex_id));
-			GfxResourceState state = texture_state_map[tex_id];
-			if (initial_state != state)
+			if (!rg_texture->imported)
 			{
-				cmd_list->TextureBarrier(*texture, state, initial_state);
+				rg_texture->resource = rg_texture->heap ? rg.pool.AllocatePlacedTexture(rg_texture->desc, rg_texture->heap, rg_texture->heap_offset) : rg.pool.AllocateTexture(rg_texture->desc);
 			}
+			rg.CreateTextureViews(tex_id);
+			rg_texture->SetName();
+		}
+		for (RGBufferId buf_id : buffer_creates)
+		{
+			RGBuffer* rg_buffer = rg.GetRGBuffer(buf_id);
+			if (!rg_buffer->imported)
+			{
+				rg_buffer->resource = rg_buffer->heap ? rg.pool.AllocatePlacedBuffer(rg_buffer->desc, rg_buffer->heap, rg_buffer->heap_offset) : rg.pool.AllocateBuffer(rg_buffer->desc);
+			}
+			rg.CreateBufferViews(buf_id);
+			rg_buffer->SetName();
+		}
+	}
+
+	void RenderGraph::DependencyLevel::ReleaseResources()
+	{
+		for (RGTextureId tex_id : texture_destroys)
+		{
+			RGTexture* rg_texture = rg.GetRGTexture(tex_id);
 			if (!rg_texture->imported)
 			{
 				rg.pool.ReleaseTexture(rg_texture->resource);
@@ -1514,21 +2187,99 @@ namespace adria
 		for (RGBufferId buf_id : buffer_destroys)
 		{
 			RGBuffer* rg_buffer = rg.GetRGBuffer(buf_id);
-			GfxBuffer* buffer = rg_buffer->resource;
-			ADRIA_ASSERT(buffer_state_map.contains(buf_id));
-			GfxResourceState state = buffer_state_map[buf_id];
-			if (state != GfxResourceState::Common)
-			{
-				cmd_list->BufferBarrier(*buffer, state, GfxResourceState::Common);
-			}
 			if (!rg_buffer->imported)
 			{
 				rg.pool.ReleaseBuffer(rg_buffer->resource);
 			}
 		}
+	}
+
+	void RenderGraph::DependencyLevel::PreExecute(RenderGraphExecutionContext const& exec_ctx)
+	{
+		GfxCommandList* cmd_list = exec_ctx.graphics_cmd_list;
+		//the begin half was only recorded if its level is part of the same batch
+		auto IsSplit = [&exec_ctx](Uint32 split_level)
+			{
+				return exec_ctx.split_barriers && split_level != RG_INVALID_LEVEL && split_level >= exec_ctx.batch_begin;
+			};
+
+		ADRIA_ASSERT(barrier_plan != nullptr);
+		for (RGTextureBarrier const& barrier : barrier_plan->pre_texture_barriers)
+		{
+			GfxTexture* texture = rg.GetTexture(barrier.id);
+			if (barrier.use_texture_initial_state)
+			{
+				GfxResourceState initial_state = texture->GetDesc().initial_state;
+				if (!HasFlag(initial_state, barrier.after))
+				{
+					cmd_list->TextureBarrier(*texture, initial_state, barrier.after);
+				}
+			}
+			else if (IsSplit(barrier.split_level))
+			{
+				cmd_list->SplitTextureBarrier(*texture, barrier.before, barrier.after, GfxBarrierSplit::End);
+			}
+			else
+			{
+				cmd_list->TextureBarrier(*texture, barrier.before, barrier.after);
+			}
+		}
+		for (RGBufferBarrier const& barrier : barrier_plan->pre_buffer_barriers)
+		{
+			if (IsSplit(barrier.split_level))
+			{
+				cmd_list->SplitBufferBarrier(*rg.GetBuffer(barrier.id), barrier.before, barrier.after, GfxBarrierSplit::End);
+			}
+			else
+			{
+				cmd_list->BufferBarrier(*rg.GetBuffer(barrier.id), barrier.before, barrier.after);
+			}
+		}
 		cmd_list->FlushBarriers();
 	}
 
+	void RenderGraph::DependencyLevel::PostExecute(RenderGraphExecutionContext const& exec_ctx)
+	{
+		GfxCommandList* cmd_list = exec_ctx.graphics_cmd_list;
+		ADRIA_ASSERT(barrier_plan != nullptr);
+		for (RGTextureBarrier const& barrier : barrier_plan->post_texture_barriers)
+		{
+			GfxTexture* texture = rg.GetTexture(barrier.id);
+			GfxResourceState after = barrier.use_texture_initial_state ? texture->GetDesc().initial_state : barrier.after;
+			if (after != barrier.before)
+			{
+				cmd_list->TextureBarrier(*texture, barrier.before, after);
+			}
+		}
+		for (RGBufferBarrier const& barrier : barrier_plan->post_buffer_barriers)
+		{
+			cmd_list->BufferBarrier(*rg.GetBuffer(barrier.id), barrier.before, barrier.after);
+		}
+
+		if (exec_ctx.split_barriers)
+		{
+			for (RGTextureBarrier const& barrier : barrier_plan->begin_texture_barriers)
+			{
+				if (barrier.split_level < exec_ctx.batch_end)
+				{
+					cmd_list->SplitTextureBarrier(*rg.GetTexture(barrier.id), barrier.before, barrier.after, GfxBarrierSplit::Begin);
+				}
+			}
+			for (RGBufferBarrier const& barrier : barrier_plan->begin_buffer_barriers)
+			{
+				if (barrier.split_level < exec_ctx.batch_end)
+				{
+					cmd_list->SplitBufferBarrier(*rg.GetBuffer(barrier.id), barrier.before, barrier.after, GfxBarrierSplit::Begin);
+				}
+			}
+		}
+
+		if (barrier_plan->flush_post_barriers || level_index + 1 == exec_ctx.batch_end)
+		{
+			cmd_list->FlushBarriers();
+		}
+	}
+
 	void RenderGraph::PushEvent(Char const* name)
 	{
 		if (g_UseDependencyLevels)
@@ -1552,6 +2303,7 @@ namespace adria
 		else
 		{
 			passes.back()->num_events_to_end++;
+			passes.back()->setup_hash.Combine(passes.back()->num_events_to_end);
 		}
 	}
 
@@ -1582,6 +2334,7 @@ namespace adria
 					Char const* read{ "olivedrab3" };
 					Char const* write{ "orangered" };
 				} edge;
+				Char const* barriers{ "lightyellow" };
 			} color;
 		} style;
 
@@ -1688,6 +2441,60 @@ namespace adria
 			}
 		}
 
+		auto BarrierPlacement = [](Char const* phase, Uint32 split_level)
+			{
+				return split_level == RG_INVALID_LEVEL ? std::string(phase) : std::format("{} (split with level {})", phase, split_level);
+			};
+		for (Uint64 i = 0; i < dependency_levels.size(); ++i)
+		{
+			RGBarrierPlan const* plan = dependency_levels[i].barrier_plan;
+			if (!plan)
+			{
+				continue;
+			}
+
+			std::string barriers;
+			for (RGTextureBarrier const& barrier : plan->pre_texture_barriers)
+			{
+				barriers += std::format("{}: {} {} -&gt; {}<br/>", BarrierPlacement(barrier.split_level == RG_INVALID_LEVEL ? "pre" : "end", barrier.split_level),
+					GetRGTexture(barrier.id)->name, ConvertBarrierFlagsToString(barrier.before), ConvertBarrierFlagsToString(barrier.after));
+			}
+			for (RGBufferBarrier const& barrier : plan->pre_buffer_barriers)
+			{
+				barriers += std::format("{}: {} {} -&gt; {}<br/>", BarrierPlacement(barrier.split_level == RG_INVALID_LEVEL ? "pre" : "end", barrier.split_level),
+					GetRGBuffer(barrier.id)->name, ConvertBarrierFlagsToString(barrier.before), ConvertBarrierFlagsToString(barrier.after));
+			}
+			for (RGTextureBarrier const& barrier : plan->begin_texture_barriers)
+			{
+				barriers += std::format("{}: {} {} -&gt; {}<br/>", BarrierPlacement("begin", barrier.split_level),
+					GetRGTexture(barrier.id)->name, ConvertBarrierFlagsToString(barrier.before), ConvertBarrierFlagsToString(barrier.after));
+			}
+			for (RGBufferBarrier const& barrier : plan->begin_buffer_barriers)
+			{
+				barriers += std::format("{}: {} {} -&gt; {}<br/>", BarrierPlacement("begin", barrier.split_level),
+					GetRGBuffer(barrier.id)->name, ConvertBarrierFlagsToString(barrier.before), ConvertBarrierFlagsToString(barrier.after));
+			}
+			for (RGTextureBarrier const& barrier : plan->post_texture_barriers)
+			{
+				barriers += std::format("post: {} {} -&gt; {}<br/>", GetRGTexture(barrier.id)->name, ConvertBarrierFlagsToString(barrier.before),
+					barrier.use_texture_initial_state ? "Initial" : ConvertBarrierFlagsToString(barrier.after));
+			}
+			for (RGBufferBarrier const& barrier : plan->post_buffer_barriers)
+			{
+				barriers += std::format("post: {} {} -&gt; {}<br/>", GetRGBuffer(barrier.id)->name, ConvertBarrierFlagsToString(barrier.before), ConvertBarrierFlagsToString(barrier.after));
+			}
+			if (barriers.empty())
+			{
+				continue;
+			}
+
+			graphviz.declarations += std::format("L{} [shape=\"note\", style=\"filled\", fillcolor={}, label=<Level {} barriers<br/>{}>] \n", i, style.color.barriers, i, barriers);
+			for (auto const& pass : dependency_levels[i].passes)
+			{
+				graphviz.dependencies += std::format("L{}->P{} [style=dashed, color=gray]\n", i, pass->id);
+			}
+		}
+
 		std::string absolute_graph_path = paths::RenderGraphDir + graph_file_name;
 		std::ofstream graph_file(absolute_graph_path);
 		graph_file << "digraph RenderGraph{ \n";
@@ -1761,13 +2568,24 @@ namespace adria
 		for (Uint64 i = 0; i < textures.size(); ++i)
 		{
 			auto& texture = textures[i];
-			render_graph_data += std::format("Texture: id = {}, name = {}, last used by: {} \n", texture->id, texture->name, texture->last_used_by->name);
+			render_graph_data += std::format("Texture: id = {}, name = {}, last used by: {}{} \n", texture->id, texture->name, texture->last_used_by->name,
+				texture->heap ? std::format(", heap offset: {}", texture->heap_offset) : "");
 		}
 		render_graph_data += "\nBuffers: \n";
 		for (Uint64 i = 0; i < buffers.size(); ++i)
 		{
 			auto& buffer = buffers[i];
-			render_graph_data += std::format("Buffer: id = {}, name = {}, last used by: {} \n", buffer->id, buffer->name, buffer->last_used_by->name);
+			render_graph_data += std::format("Buffer: id = {}, name = {}, last used by: {}{} \n", buffer->id, buffer->name, buffer->last_used_by->name,
+				buffer->heap ? std::format(", heap offset: {}", buffer->heap_offset) : "");
+		}
+		render_graph_data += "\nResource aliasing: \n";
+		render_graph_data += std::format("Aliased resources: {}, heap memory: {} bytes, memory without aliasing: {} bytes\n",
+			aliasing_stats.resource_count, aliasing_stats.heap_size, aliasing_stats.naive_size);
+		render_graph_data += std::format("\nAllocator: {} allocations, {} bytes, {} overflow blocks, {} heap allocations this frame\n",
+			allocator.GetAllocationCount(), allocator.GetSize(), allocator.GetOverflowBlockCount(), GetHeapAllocationCount() - heap_allocations_at_start);
+		if (compile_cache)
+		{
+			render_graph_data += std::format("\nCompile cache: {} hits, {} misses\n", compile_cache->GetHitCount(), compile_cache->GetMissCount());
 		}
 		ADRIA_LOG(DEBUG, "[RenderGraph]\n%s", render_graph_data.c_str());
 	}
@@ -4,6 +4,8 @@
 #include "RenderGraphResourcePool.h"
 #include "RenderGraphEvent.h"
 #include "RenderGraphAllocator.h"
+#include "RenderGraphResourceAliasing.h"
+#include "RenderGraphCompileCache.h"
 #include "Graphics/GfxDevice.h"
 
 namespace adria
@@ -12,6 +14,7 @@ namespace adria
 	{
 		friend class RenderGraphBuilder;
 		friend class RenderGraphContext;
+		friend struct RenderGraphTestAccess;
 
 		struct RenderGraphExecutionContext
 		{
@@ -22,6 +25,9 @@ namespace adria
 			GfxFence* compute_fence;
 			Uint64 graphics_fence_value;
 			Uint64 compute_fence_value;
+			Uint64 batch_begin;
+			Uint64 batch_end;
+			Bool split_barriers;
 		};
 
 		class DependencyLevel
@@ -29,34 +35,44 @@ namespace adria
 			friend RenderGraph;
 		public:
 
-			DependencyLevel(RenderGraph& rg, Uint32 level_index) : rg(rg), level_index(level_index) {}
+			DependencyLevel(RenderGraph& rg, Uint32 level_index);
 			void AddPass(RenderGraphPassBase* pass);
 			void Setup();
 			void Execute(RenderGraphExecutionContext const& exec_ctx);
+			void BuildBarrierPlan(RGBarrierPlan& barrier_plan) const;
+			Uint32 GetActivePassCount() const;
 
 		private:
 			RenderGraph& rg;
 			Uint32 level_index;
-			std::vector<RenderGraphPassBase*> passes;
-			std::unordered_set<RGTextureId> texture_creates;
-			std::unordered_set<RGTextureId> texture_reads;
-			std::unordered_set<RGTextureId> texture_writes;
-			std::unordered_set<RGTextureId> texture_destroys;
-			std::unordered_map<RGTextureId, GfxResourceState> texture_state_map;
-
-			std::unordered_set<RGBufferId> buffer_creates;
-			std::unordered_set<RGBufferId> buffer_reads;
-			std::unordered_set<RGBufferId> buffer_writes;
-			std::unordered_set<RGBufferId> buffer_destroys;
-			std::unordered_map<RGBufferId, GfxResourceState> buffer_state_map;
+			RGBarrierPlan const* barrier_plan = nullptr;
+			RGVector<RenderGraphPassBase*> passes;
+			RGResourceSet<RGTextureId> texture_creates;
+			RGResourceSet<RGTextureId> texture_reads;
+			RGResourceSet<RGTextureId> texture_writes;
+			RGResourceSet<RGTextureId> texture_destroys;
+			RGResourceStateMap<RGTextureId> texture_state_map;
+
+			RGResourceSet<RGBufferId> buffer_creates;
+			RGResourceSet<RGBufferId> buffer_reads;
+			RGResourceSet<RGBufferId> buffer_writes;
+			RGResourceSet<RGBufferId> buffer_destroys;
+			RGResourceStateMap<RGBufferId> buffer_state_map;
 
 		private:
-			void PreExecute(GfxCommandList*);
-			void PostExecute(GfxCommandList*);
+			void AllocateResources();
+			void ReleaseResources();
+			void Record(RenderGraphExecutionContext const& exec_ctx);
+			void PreExecute(RenderGraphExecutionContext const& exec_ctx);
+			void PostExecute(RenderGraphExecutionContext const& exec_ctx);
 		};
 
 	public:
-		RenderGraph(RGResourcePool& pool) : pool(pool), allocator(128 * 1024), gfx(pool.GetDevice()) {}
+		static constexpr Uint64 DefaultAllocatorSize = 512 * 1024;
+
+		//the allocator is reset when the graph is destroyed, so a persistent one keeps its memory from frame to frame.
+		//Without one the graph allocates its own
+		RenderGraph(RGResourcePool& pool, RGCompileCache* compile_cache = nullptr, RGAllocator* frame_allocator = nullptr);
 		ADRIA_NONCOPYABLE(RenderGraph)
 		ADRIA_NONMOVABLE(RenderGraph)
 		~RenderGraph();
@@ -64,22 +80,32 @@ namespace adria
 		void Compile();
 		void Execute();
 
-		template<typename PassData, typename... Args> requires std::is_constructible_v<RenderGraphPass<PassData>, Args...>
-		ADRIA_MAYBE_UNUSED decltype(auto) AddPass(Args&&... args)
+		template<typename PassData, typename SetupFunc, typename ExecuteFunc>
+		ADRIA_MAYBE_UNUSED decltype(auto) AddPass(Char const* name, SetupFunc&& setup, ExecuteFunc&& execute, RGPassType type = RGPassType::Graphics, RGPassFlags flags = RGPassFlags::None)
 		{
-			passes.emplace_back(allocator.AllocateObject<RenderGraphPass<PassData>>(std::forward<Args>(args)...));
-			RGPassBase*& pass = passes.back(); pass->id = passes.size() - 1;
+			using PassType = RenderGraphPass<PassData, std::decay_t<ExecuteFunc>>;
+			PassType* pass = allocator.AllocateObject<PassType>(allocator, name, std::forward<ExecuteFunc>(execute), type, flags);
+			passes.push_back(pass);
+			pass->id = passes.size() - 1;
 
 			RenderGraphBuilder builder(*this, *pass);
-			pass->Setup(builder);
+			if constexpr (std::is_void_v<PassData>)
+			{
+				setup(builder);
+			}
+			else
+			{
+				setup(pass->data, builder);
+			}
 
 			for (Uint32 event_idx : pending_event_indices)
 			{
 				pass->events_to_start.push_back(event_idx);
+				pass->setup_hash.Combine(event_idx);
 			}
 			pending_event_indices.clear();
 
-			return *dynamic_cast<RenderGraphPass<PassData>*>(pass);
+			return *pass;
 		}
 
 		void ImportTexture(RGResourceName name, GfxTexture* texture);
@@ -99,31 +125,44 @@ namespace adria
 
 	private:
 		RGResourcePool& pool;
+		RGCompileCache* compile_cache;
 		GfxDevice* gfx;
-		RGAllocator allocator;
+		std::optional<RGAllocator> owned_allocator;
+		RGAllocator& allocator;
+		//declared before everything that lives in the allocator, so the reset runs once all of it is destroyed
+		struct AllocatorReset
+		{
+			RGAllocator* frame_allocator;
+			~AllocatorReset() { if (frame_allocator) frame_allocator->Reset(); }
+		} allocator_reset;
+		Uint64 const heap_allocations_at_start;
 		RGBlackboard blackboard;
 
-		std::vector<RGPassBase*> passes;
-		std::vector<std::unique_ptr<RGTexture>> textures;
-		std::vector<std::unique_ptr<RGBuffer>> buffers;
+		RGVector<RGPassBase*> passes;
+		RGVector<RGTexture*> textures;
+		RGVector<RGBuffer*> buffers;
 
-		std::vector<RGEvent> events;
-		std::vector<Uint32>  pending_event_indices;
+		RGVector<RGEvent> events;
+		RGVector<Uint32>  pending_event_indices;
 
-		std::vector<std::vector<Uint64>> adjacency_lists;
-		std::vector<Uint64> topologically_sorted_passes;
-		std::vector<DependencyLevel> dependency_levels;
+		RGVector<RGVector<Uint64>> adjacency_lists;
+		RGVector<Uint64> topologically_sorted_passes;
+		RGVector<DependencyLevel> dependency_levels;
+		RGVector<RGBarrierPlan> barrier_plans;
+		RGAliasingStats aliasing_stats;
+		std::array<Uint64, (Uint32)GfxHeapUsage::Count> aliasing_heap_sizes{};
 
-		std::unordered_map<RGResourceName, RGTextureId> texture_name_id_map;
-		std::unordered_map<RGResourceName, RGBufferId>  buffer_name_id_map;
-		std::unordered_map<RGBufferReadWriteId, RGBufferId> buffer_uav_counter_map;
+		RGHashMap<RGResourceName, RGTextureId> texture_name_id_map;
+		RGHashMap<RGResourceName, RGBufferId>  buffer_name_id_map;
+		RGHashMap<RGBufferReadWriteId, RGBufferId> buffer_uav_counter_map;
 
-		mutable std::unordered_map<RGTextureId, std::vector<std::pair<GfxTextureDescriptorDesc, RGDescriptorType>>> texture_view_desc_map;
-		mutable std::unordered_map<RGTextureId, std::vector<GfxDescriptor>> texture_view_map;
-		mutable std::vector<GfxDescriptor> texture_views_to_free;
+		//indexed by resource id, view ids index into the inner vectors
+		RGVector<RGVector<std::pair<GfxTextureDescriptorDesc, RGDescriptorType>>> texture_view_descs;
+		RGVector<RGVector<GfxDescriptor>> texture_views;
+		RGVector<GfxDescriptor> texture_views_to_free;
 
-		mutable std::unordered_map<RGBufferId, std::vector<std::pair<GfxBufferDescriptorDesc, RGDescriptorType>>> buffer_view_desc_map;
-		mutable std::unordered_map<RGBufferId, std::vector<GfxDescriptor>> buffer_view_map;
+		RGVector<RGVector<std::pair<GfxBufferDescriptorDesc, RGDescriptorType>>> buffer_view_descs;
+		RGVector<RGVector<GfxDescriptor>> buffer_views;
 
 	private:
 
@@ -132,7 +171,12 @@ namespace adria
 		void BuildDependencyLevels();
 		void CullPasses();
 		void CalculateResourcesLifetime();
-		void DepthFirstSearch(Uint64 i, std::vector<Bool>& visited, std::vector<Uint64>& sort);
+		void CalculateResourceAliasing();
+		void BuildBarrierPlans();
+		Uint64 HashTopology() const;
+		void LoadCompiledGraph();
+		void StoreCompiledGraph(Uint64 topology_hash);
+		void DepthFirstSearch(Uint64 i, RGVector<Bool>& visited, RGVector<Uint64>& sort);
 		void ResolveAsync();
 		void ResolveEvents();
 		Uint32 AddEvent(Char const* name)
@@ -141,6 +185,9 @@ namespace adria
 			return static_cast<Uint32>(events.size() - 1);
 		}
 		
+		void AddTexture(RGTexture* texture);
+		void AddBuffer(RGBuffer* buffer);
+		Uint64 GetHeapAllocationCount() const;
 		RGTextureId DeclareTexture(RGResourceName name, RGTextureDesc const& desc);
 		RGBufferId DeclareBuffer(RGResourceName name, RGBufferDesc const& desc);
 
@@ -204,8 +251,10 @@ namespace adria
 
 		void CreateTextureViews(RGTextureId);
 		void CreateBufferViews(RGBufferId);
+		void CreateImportedResourceViews();
 		void Execute_Singlethreaded();
 		void Execute_Multithreaded();
+		RGVector<std::pair<Uint64, Uint64>> BuildExecutionBatches() const;
 
 		void AddExportBufferCopyPass(RGResourceName export_buffer, GfxBuffer* buffer);
 		void AddExportTextureCopyPass(RGResourceName export_texture, GfxTexture* texture);
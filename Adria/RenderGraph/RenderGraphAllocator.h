@@ -1,8 +1,11 @@
 #pragma once
+#include "Utilities/Align.h"
 
 namespace adria
 {
 	class RenderGraph;
+	//linear allocator for everything a render graph builds during a frame. It outlives the graphs using it and is reset
+	//at the end of every frame, so once the memory of a frame fits in the first block, frames stop touching the heap
 	class RenderGraphAllocator
 	{
 		friend class RenderGraph;
@@ -10,8 +13,9 @@ namespace adria
 		struct AllocatedObject
 		{
 			virtual ~AllocatedObject() = default;
+			AllocatedObject* previous = nullptr;
 		};
-		template<typename T> requires (!std::is_trivial_v<T>)
+		template<typename T>
 		struct NonTrivialAllocatedObject : public AllocatedObject
 		{
 			template<typename... Args>
@@ -21,54 +25,182 @@ namespace adria
 
 			T object;
 		};
+
+		struct Block
+		{
+			Uint8* data;
+			Uint64 capacity;
+		};
+
 	public:
-		RenderGraphAllocator(Uint64 size)
-			: capacity(size), data(new Uint8[size]), current_offset(data)
+		explicit RenderGraphAllocator(Uint64 size)
+			: capacity(size), data(AllocateBlock(size)), current_offset(data)
 		{
 		}
+		ADRIA_NONCOPYABLE_NONMOVABLE(RenderGraphAllocator)
 		~RenderGraphAllocator()
 		{
-			for (Uint32 i = 0; i < non_trivial_object_allocations.size(); ++i)
+			DestroyObjects();
+			for (Block const& block : blocks)
 			{
-				non_trivial_object_allocations[i]->~AllocatedObject();
+				delete[] block.data;
 			}
-			delete[] data;
 		}
 
 		template<typename T, typename ...Args>
 		ADRIA_NODISCARD T* AllocateObject(Args&&... args)
 		{
-			using AllocatedType = std::conditional_t<std::is_trivial_v<T>, T, NonTrivialAllocatedObject<T>>;
-			void* alloc = Allocate(sizeof(AllocatedType));
+			using AllocatedType = std::conditional_t<std::is_trivially_destructible_v<T>, T, NonTrivialAllocatedObject<T>>;
+			void* alloc = Allocate(sizeof(AllocatedType), alignof(AllocatedType));
 			AllocatedType* allocation = new (alloc) AllocatedType(std::forward<Args>(args)...);
 
-			if constexpr (std::is_trivial_v<T>)
+			if constexpr (std::is_trivially_destructible_v<T>)
 			{
 				return allocation;
 			}
 			else
 			{
-				non_trivial_object_allocations.push_back(allocation);
+				allocation->previous = last_object;
+				last_object = allocation;
 				return &allocation->object;
 			}
 		}
 
-		ADRIA_NODISCARD void* Allocate(Uint64 size)
+		template<typename T> requires std::is_trivially_copyable_v<T>
+		ADRIA_NODISCARD T* AllocateArray(Uint64 count)
+		{
+			return static_cast<T*>(Allocate(sizeof(T) * count, alignof(T)));
+		}
+
+		ADRIA_NODISCARD Char const* AllocateString(Char const* str)
 		{
-			ADRIA_ASSERT(current_offset - data + size < capacity);
-			void* current_data = current_offset;
-			current_offset += size;
-			return current_data;
+			Uint64 const size = std::strlen(str) + 1;
+			Char* copy = AllocateArray<Char>(size);
+			std::memcpy(copy, str, size);
+			return copy;
 		}
 
-		Uint64 GetSize() const { return static_cast<Uint64>(current_offset - data); }
-		Uint64 GetCapacity() const { return capacity; }
+		//runs out of the current block into a new heap block instead of failing, overflow_block_count tracks how often that happens
+		ADRIA_NODISCARD void* Allocate(Uint64 size, Uint64 alignment = alignof(std::max_align_t))
+		{
+			Uint8* aligned_offset = AlignPointer(current_offset, alignment);
+			if (aligned_offset + size > data + capacity)
+			{
+				capacity = std::max(capacity, size + alignment);
+				data = AllocateBlock(capacity);
+				++overflow_block_count;
+				aligned_offset = AlignPointer(data, alignment);
+			}
+			current_offset = aligned_offset + size;
+			++allocation_count;
+			allocated_size += size;
+			return aligned_offset;
+		}
+
+		//destroys the objects of the frame and rewinds to the first block. Blocks added by overflows are merged into one block
+		//of their combined size, so the next frame fits without overflowing again
+		void Reset()
+		{
+			DestroyObjects();
+			if (blocks.size() > 1)
+			{
+				Uint64 const total_capacity = GetCapacity();
+				for (Block const& block : blocks)
+				{
+					delete[] block.data;
+				}
+				blocks.clear();
+				AllocateBlock(total_capacity);
+			}
+			data = blocks[0].data;
+			capacity = blocks[0].capacity;
+			current_offset = data;
+			allocation_count = 0;
+			allocated_size = 0;
+			overflow_block_count = 0;
+		}
+
+		Uint64 GetSize() const { return allocated_size; }
+		Uint64 GetCapacity() const
+		{
+			Uint64 total_capacity = 0;
+			for (Block const& block : blocks)
+			{
+				total_capacity += block.capacity;
+			}
+			return total_capacity;
+		}
+		Uint64 GetAllocationCount() const { return allocation_count; }
+		Uint64 GetOverflowBlockCount() const { return overflow_block_count; }
+		//every heap allocation made since construction, blocks and the block list included. Never reset
+		Uint64 GetHeapAllocationCount() const { return heap_allocation_count; }
 
 	private:
-		std::vector<AllocatedObject*> non_trivial_object_allocations;
+		static Uint8* AlignPointer(Uint8* ptr, Uint64 alignment)
+		{
+			return reinterpret_cast<Uint8*>(AlignUp<Uint64>(reinterpret_cast<Uint64>(ptr), alignment));
+		}
+
+		Uint8* AllocateBlock(Uint64 size)
+		{
+			if (blocks.size() == blocks.capacity())
+			{
+				++heap_allocation_count;
+			}
+			Uint8* block_data = new Uint8[size];
+			++heap_allocation_count;
+			blocks.push_back(Block{ block_data, size });
+			return block_data;
+		}
+
+		//objects are destroyed in the reverse order of their allocation
+		void DestroyObjects()
+		{
+			while (last_object)
+			{
+				AllocatedObject* previous = last_object->previous;
+				last_object->~AllocatedObject();
+				last_object = previous;
+			}
+		}
+
+	private:
+		std::vector<Block> blocks;
+		Uint64 heap_allocation_count = 0;
+		AllocatedObject* last_object = nullptr;
 		Uint64 capacity;
 		Uint8* data;
 		Uint8* current_offset;
+		Uint64 allocation_count = 0;
+		Uint64 allocated_size = 0;
+		Uint64 overflow_block_count = 0;
 	};
 	using RGAllocator = RenderGraphAllocator;
+
+	//standard allocator on top of the render graph allocator, memory is only given back when the allocator is reset
+	template<typename T>
+	struct RenderGraphStlAllocator
+	{
+		using value_type = T;
+
+		RenderGraphStlAllocator(RGAllocator& allocator) : allocator(&allocator) {}
+		template<typename U>
+		RenderGraphStlAllocator(RenderGraphStlAllocator<U> const& other) : allocator(other.allocator) {}
+
+		T* allocate(Uint64 count)
+		{
+			return static_cast<T*>(allocator->Allocate(sizeof(T) * count, alignof(T)));
+		}
+		void deallocate(T*, Uint64) {}
+
+		template<typename U>
+		Bool operator==(RenderGraphStlAllocator<U> const& other) const { return allocator == other.allocator; }
+
+		RGAllocator* allocator;
+	};
+
+	template<typename T>
+	using RGVector = std::vector<T, RenderGraphStlAllocator<T>>;
+	template<typename Key, typename Value, typename Hash = std::hash<Key>>
+	using RGHashMap = std::unordered_map<Key, Value, Hash, std::equal_to<Key>, RenderGraphStlAllocator<std::pair<Key const, Value>>>;
 }
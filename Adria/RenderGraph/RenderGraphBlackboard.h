@@ -1,5 +1,6 @@
 #pragma once
 #include <typeindex>
+#include "RenderGraphAllocator.h"
 #include "Utilities/TemplatesUtil.h"
 
 namespace adria
@@ -8,7 +9,7 @@ namespace adria
 	class RenderGraphBlackboard
 	{
 	public:
-		RenderGraphBlackboard() = default;
+		explicit RenderGraphBlackboard(RGAllocator& allocator) : allocator(allocator), board_data(allocator) {}
 		ADRIA_NONCOPYABLE(RenderGraphBlackboard)
 		~RenderGraphBlackboard() = default;
 
@@ -23,9 +24,8 @@ namespace adria
 		{
 			static_assert(std::is_trivial_v<T> && std::is_standard_layout_v<T>);
 			ADRIA_ASSERT_MSG(board_data.find(typeid(T)) == board_data.end(), "Cannot create same type more than once in blackboard!");
-			board_data[typeid(T)] = std::make_unique<Uint8[]>(sizeof(T));
-			T* data_entry = reinterpret_cast<T*>(board_data[typeid(T)].get());
-			*data_entry = T{ std::forward<Args>(args)... };
+			T* data_entry = allocator.AllocateObject<T>(T{ std::forward<Args>(args)... });
+			board_data[typeid(T)] = data_entry;
 			return *data_entry;
 		}
 
@@ -34,7 +34,7 @@ namespace adria
 		{
 			if (auto it = board_data.find(typeid(T)); it != board_data.end())
 			{
-				return reinterpret_cast<T const*>(it->second.get());
+				return static_cast<T const*>(it->second);
 			}
 			else return nullptr;
 		}
@@ -53,7 +53,8 @@ namespace adria
 		}
 
 	private:
-		std::unordered_map<std::type_index, std::unique_ptr<Uint8[]>> board_data;
+		RGAllocator& allocator;
+		RGHashMap<std::type_index, void*> board_data;
 	};
 
 	using RGBlackboard = RenderGraphBlackboard;
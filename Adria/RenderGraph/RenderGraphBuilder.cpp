@@ -3,6 +3,65 @@
 
 namespace adria
 {
+	namespace
+	{
+		enum class SetupCall : Uint8
+		{
+			DeclareTexture,
+			DeclareBuffer,
+			DummyWriteTexture,
+			DummyReadTexture,
+			DummyReadBuffer,
+			DummyWriteBuffer,
+			ReadCopySrcTexture,
+			WriteCopyDstTexture,
+			ReadTexture,
+			WriteTexture,
+			WriteRenderTarget,
+			WriteDepthStencil,
+			ReadDepthStencil,
+			ReadCopySrcBuffer,
+			WriteCopyDstBuffer,
+			ReadIndirectArgsBuffer,
+			ReadIndexBuffer,
+			ReadBuffer,
+			WriteBuffer,
+			WriteBufferWithCounter,
+			AddBufferBindFlags,
+			AddTextureBindFlags
+		};
+
+		Uint64 HashViewDesc(GfxTextureDescriptorDesc const& desc)
+		{
+			HashState hash;
+			hash.Combine(desc.first_slice);
+			hash.Combine(desc.slice_count);
+			hash.Combine(desc.first_mip);
+			hash.Combine(desc.mip_count);
+			hash.Combine((Uint32)desc.flags);
+			hash.Combine((Uint32)desc.channel_mapping);
+			return hash;
+		}
+
+		Uint64 HashViewDesc(GfxBufferDescriptorDesc const& desc)
+		{
+			HashState hash;
+			hash.Combine(desc.offset);
+			hash.Combine(desc.size);
+			return hash;
+		}
+
+		//resource ids, views, states and bind flags all follow from the sequence of calls and the declarations,
+		//so hashing the calls as they are made leaves only a combine per pass for RenderGraph::HashTopology
+		template<typename... Args>
+		void HashSetupCall(HashState& hash, SetupCall call, RGResourceName name, Args const&... args)
+		{
+			hash.Combine((Uint8)call);
+			hash.Combine(name.hashed_name);
+			(hash.Combine(args), ...);
+		}
+	}
+
 	RenderGraphBuilder::RenderGraphBuilder(RenderGraph& rg, RenderGraphPassBase& rg_pass)
 		: rg(rg), rg_pass(rg_pass)
 	{}
@@ -29,36 +88,43 @@ namespace adria
 
 	void RenderGraphBuilder::DeclareTexture(RGResourceName name, RGTextureDesc const& desc)
 	{
+		HashSetupCall(rg_pass.setup_hash, SetupCall::DeclareTexture, name);
 		rg_pass.texture_creates.insert(rg.DeclareTexture(name, desc));
 	}
 
 	void RenderGraphBuilder::DeclareBuffer(RGResourceName name, RGBufferDesc const& desc)
 	{
+		HashSetupCall(rg_pass.setup_hash, SetupCall::DeclareBuffer, name);
 		rg_pass.buffer_creates.insert(rg.DeclareBuffer(name, desc));
 	}
 
 	void RenderGraphBuilder::DummyWriteTexture(RGResourceName name)
 	{
+		HashSetupCall(rg_pass.setup_hash, SetupCall::DummyWriteTexture, name);
 		rg_pass.texture_writes.insert(rg.GetTextureId(name));
 	}
 
 	void RenderGraphBuilder::DummyReadTexture(RGResourceName name)
 	{
+		HashSetupCall(rg_pass.setup_hash, SetupCall::DummyReadTexture, name);
 		rg_pass.texture_reads.insert(rg.GetTextureId(name));
 	}
 
 	void RenderGraphBuilder::DummyReadBuffer(RGResourceName name)
 	{
+		HashSetupCall(rg_pass.setup_hash, SetupCall::DummyReadBuffer, name);
 		rg_pass.buffer_reads.insert(rg.GetBufferId(name));
 	}
 
 	void RenderGraphBuilder::DummyWriteBuffer(RGResourceName name)
 	{
+		HashSetupCall(rg_pass.setup_hash, SetupCall::DummyWriteBuffer, name);
 		rg_pass.buffer_writes.insert(rg.GetBufferId(name));
 	}
 
 	RGTextureCopySrcId RenderGraphBuilder::ReadCopySrcTexture(RGResourceName name)
 	{
+		HashSetupCall(rg_pass.setup_hash, SetupCall::ReadCopySrcTexture, name);
 		RGTextureCopySrcId copy_src_id = rg.ReadCopySrcTexture(name);
 		RGTextureId res_id(copy_src_id);
 		rg_pass.texture_state_map[res_id] = GfxResourceState::CopySrc;
@@ -68,6 +134,7 @@ namespace adria
 
 	RGTextureCopyDstId RenderGraphBuilder::WriteCopyDstTexture(RGResourceName name)
 	{
+		HashSetupCall(rg_pass.setup_hash, SetupCall::WriteCopyDstTexture, name);
 		RGTextureCopyDstId copy_dst_id = rg.WriteCopyDstTexture(name);
 		RGTextureId res_id(copy_dst_id);
 		rg_pass.texture_state_map[res_id] = GfxResourceState::CopyDst;
@@ -86,6 +153,7 @@ namespace adria
 
 	RGTextureReadOnlyId RenderGraphBuilder::ReadTextureImpl(RGResourceName name, RGReadAccess read_access, GfxTextureDescriptorDesc const& desc /*= {}*/)
 	{
+		HashSetupCall(rg_pass.setup_hash, SetupCall::ReadTexture, name, read_access, HashViewDesc(desc));
 		ADRIA_ASSERT_MSG(rg_pass.type != RGPassType::Copy, "Invalid Call in Copy Pass");
 		RGTextureReadOnlyId read_only_id = rg.ReadTexture(name, desc);
 		RGTextureId res_id = read_only_id.GetResourceId();
@@ -117,6 +185,7 @@ namespace adria
 
 	RGTextureReadWriteId RenderGraphBuilder::WriteTextureImpl(RGResourceName name, GfxTextureDescriptorDesc const& desc /*= {}*/)
 	{
+		HashSetupCall(rg_pass.setup_hash, SetupCall::WriteTexture, name, HashViewDesc(desc));
 		ADRIA_ASSERT_MSG(rg_pass.type != RGPassType::Copy, "Invalid Call in Copy Pass");
 		RGTextureReadWriteId read_write_id = rg.WriteTexture(name, desc);
 		RGTextureId res_id = read_write_id.GetResourceId();
@@ -136,6 +205,7 @@ namespace adria
 
 	RGRenderTargetId RenderGraphBuilder::WriteRenderTargetImpl(RGResourceName name, RGLoadStoreAccessOp load_store_op, GfxTextureDescriptorDesc const& desc /*= {}*/)
 	{
+		HashSetupCall(rg_pass.setup_hash, SetupCall::WriteRenderTarget, name, load_store_op, HashViewDesc(desc));
 		ADRIA_ASSERT_MSG(rg_pass.type != RGPassType::Copy, "Invalid Call in Copy Pass");
 		RGRenderTargetId render_target_id = rg.RenderTarget(name, desc);
 		RGTextureId res_id = render_target_id.GetResourceId();
@@ -156,6 +226,7 @@ namespace adria
 
 	RGDepthStencilId RenderGraphBuilder::WriteDepthStencilImpl(RGResourceName name, RGLoadStoreAccessOp load_store_op, RGLoadStoreAccessOp stencil_load_store_op /*= ERGLoadStoreAccessOp::NoAccess_NoAccess*/, GfxTextureDescriptorDesc const& desc /*= {}*/)
 	{
+		HashSetupCall(rg_pass.setup_hash, SetupCall::WriteDepthStencil, name, load_store_op, stencil_load_store_op, HashViewDesc(desc));
 		ADRIA_ASSERT_MSG(rg_pass.type != RGPassType::Copy, "Invalid Call in Copy Pass");
 		RGDepthStencilId depth_stencil_id = rg.DepthStencil(name, desc);
 		RGTextureId res_id = depth_stencil_id.GetResourceId();
@@ -176,6 +247,7 @@ namespace adria
 
 	RGDepthStencilId RenderGraphBuilder::ReadDepthStencilImpl(RGResourceName name, RGLoadStoreAccessOp load_store_op, RGLoadStoreAccessOp stencil_load_store_op /*= ERGLoadStoreAccessOp::NoAccess_NoAccess*/, GfxTextureDescriptorDesc const& desc /*= {}*/)
 	{
+		HashSetupCall(rg_pass.setup_hash, SetupCall::ReadDepthStencil, name, load_store_op, stencil_load_store_op, HashViewDesc(desc));
 		ADRIA_ASSERT_MSG(rg_pass.type != RGPassType::Copy, "Invalid Call in Copy Pass");
 		RGDepthStencilId depth_stencil_id = rg.DepthStencil(name, desc);
 		RGTextureId res_id = depth_stencil_id.GetResourceId();
@@ -194,6 +266,7 @@ namespace adria
 
 	RGBufferCopySrcId RenderGraphBuilder::ReadCopySrcBuffer(RGResourceName name)
 	{
+		HashSetupCall(rg_pass.setup_hash, SetupCall::ReadCopySrcBuffer, name);
 		RGBufferCopySrcId copy_src_id = rg.ReadCopySrcBuffer(name);
 		RGBufferId res_id(copy_src_id);
 		rg_pass.buffer_state_map[res_id] = GfxResourceState::CopySrc;
@@ -203,6 +276,7 @@ namespace adria
 
 	RGBufferCopyDstId RenderGraphBuilder::WriteCopyDstBuffer(RGResourceName name)
 	{
+		HashSetupCall(rg_pass.setup_hash, SetupCall::WriteCopyDstBuffer, name);
 		RGBufferCopyDstId copy_dst_id = rg.WriteCopyDstBuffer(name);
 		RGBufferId res_id(copy_dst_id);
 		rg_pass.buffer_state_map[res_id] = GfxResourceState::CopyDst;
@@ -221,6 +295,7 @@ namespace adria
 
 	RGBufferIndirectArgsId RenderGraphBuilder::ReadIndirectArgsBuffer(RGResourceName name)
 	{
+		HashSetupCall(rg_pass.setup_hash, SetupCall::ReadIndirectArgsBuffer, name);
 		RGBufferIndirectArgsId indirect_args_id = rg.ReadIndirectArgsBuffer(name);
 		RGBufferId res_id(indirect_args_id);
 		rg_pass.buffer_state_map[res_id] = GfxResourceState::IndirectArgs;
@@ -230,6 +305,7 @@ namespace adria
 
 	RGBufferIndexId RenderGraphBuilder::ReadIndexBuffer(RGResourceName name)
 	{
+		HashSetupCall(rg_pass.setup_hash, SetupCall::ReadIndexBuffer, name);
 		RGBufferIndexId index_buf_id = rg.ReadVertexBuffer(name);
 		RGBufferId res_id(index_buf_id);
 		rg_pass.buffer_state_map[res_id] = GfxResourceState::IndexBuffer;
@@ -239,6 +315,7 @@ namespace adria
 
 	RGBufferReadOnlyId RenderGraphBuilder::ReadBufferImpl(RGResourceName name, RGReadAccess read_access, GfxBufferDescriptorDesc const& desc /*= {}*/)
 	{
+		HashSetupCall(rg_pass.setup_hash, SetupCall::ReadBuffer, name, read_access, HashViewDesc(desc));
 		ADRIA_ASSERT_MSG(rg_pass.type != RGPassType::Copy, "Invalid Call in Copy Pass");
 		RGBufferReadOnlyId read_only_id = rg.ReadBuffer(name, desc);
 		if (rg_pass.type == RGPassType::Compute)
@@ -274,6 +351,7 @@ namespace adria
 
 	RGBufferReadWriteId RenderGraphBuilder::WriteBufferImpl(RGResourceName name, GfxBufferDescriptorDesc const& desc /*= {}*/)
 	{
+		HashSetupCall(rg_pass.setup_hash, SetupCall::WriteBuffer, name, HashViewDesc(desc));
 		ADRIA_ASSERT_MSG(rg_pass.type != RGPassType::Copy, "Invalid Call in Copy Pass");
 		RGBufferReadWriteId read_write_id = rg.WriteBuffer(name, desc);
 		RGBufferId res_id = read_write_id.GetResourceId();
@@ -293,6 +371,7 @@ namespace adria
 
 	RGBufferReadWriteId RenderGraphBuilder::WriteBufferImpl(RGResourceName name, RGResourceName counter_name, GfxBufferDescriptorDesc const& desc)
 	{
+		HashSetupCall(rg_pass.setup_hash, SetupCall::WriteBufferWithCounter, name, counter_name.hashed_name, HashViewDesc(desc));
 		ADRIA_ASSERT_MSG(rg_pass.type != RGPassType::Copy, "Invalid Call in Copy Pass");
 		RGBufferReadWriteId read_write_id = rg.WriteBuffer(name, counter_name, desc);
 
@@ -334,11 +413,13 @@ namespace adria
 
 	void RenderGraphBuilder::AddBufferBindFlags(RGResourceName name, GfxBindFlag flags)
 	{
+		HashSetupCall(rg_pass.setup_hash, SetupCall::AddBufferBindFlags, name, flags);
 		rg.AddBufferBindFlags(name, flags);
 	}
 
 	void RenderGraphBuilder::AddTextureBindFlags(RGResourceName name, GfxBindFlag flags)
 	{
+		HashSetupCall(rg_pass.setup_hash, SetupCall::AddTextureBindFlags, name, flags);
 		rg.AddTextureBindFlags(name, flags);
 	}
 }
\ No newline at end of file
@@ -0,0 +1,130 @@
+#pragma once
+#include "RenderGraphResourceId.h"
+#include "RenderGraphResourceAliasing.h"
+#include "RenderGraphAllocator.h"
+#include "Graphics/GfxResource.h"
+#include "Graphics/GfxHeap.h"
+
+namespace adria
+{
+	inline constexpr Uint32 RG_INVALID_LEVEL = Uint32(-1);
+
+	struct RenderGraphTextureBarrier
+	{
+		RGTextureId id;
+		GfxResourceState before;
+		GfxResourceState after;
+		//the pool can return a compatible texture with a different initial state, so for barriers
+		//of non-aliased creates (before) and destroys (after) the state is read from the texture at execution
+		Bool use_texture_initial_state;
+		//level holding the other half of a split barrier, RG_INVALID_LEVEL if the barrier is not split
+		Uint32 split_level = RG_INVALID_LEVEL;
+	};
+	using RGTextureBarrier = RenderGraphTextureBarrier;
+
+	struct RenderGraphBufferBarrier
+	{
+		RGBufferId id;
+		GfxResourceState before;
+		GfxResourceState after;
+		Uint32 split_level = RG_INVALID_LEVEL;
+	};
+	using RGBufferBarrier = RenderGraphBufferBarrier;
+
+	struct RenderGraphBarrierPlan
+	{
+		explicit RenderGraphBarrierPlan(RGAllocator& allocator)
+			: pre_texture_barriers(allocator), pre_buffer_barriers(allocator), post_texture_barriers(allocator), post_buffer_barriers(allocator),
+			  begin_texture_barriers(allocator), begin_buffer_barriers(allocator)
+		{}
+		//copies the barriers into the given allocator, a plain copy would keep using the allocator of the source
+		RenderGraphBarrierPlan(RenderGraphBarrierPlan const& plan, RGAllocator& allocator)
+			: pre_texture_barriers(plan.pre_texture_barriers.begin(), plan.pre_texture_barriers.end(), allocator),
+			  pre_buffer_barriers(plan.pre_buffer_barriers.begin(), plan.pre_buffer_barriers.end(), allocator),
+			  post_texture_barriers(plan.post_texture_barriers.begin(), plan.post_texture_barriers.end(), allocator),
+			  post_buffer_barriers(plan.post_buffer_barriers.begin(), plan.post_buffer_barriers.end(), allocator),
+			  begin_texture_barriers(plan.begin_texture_barriers.begin(), plan.begin_texture_barriers.end(), allocator),
+			  begin_buffer_barriers(plan.begin_buffer_barriers.begin(), plan.begin_buffer_barriers.end(), allocator),
+			  flush_post_barriers(plan.flush_post_barriers)
+		{}
+
+		RGVector<RGTextureBarrier> pre_texture_barriers;
+		RGVector<RGBufferBarrier>  pre_buffer_barriers;
+		RGVector<RGTextureBarrier> post_texture_barriers;
+		RGVector<RGBufferBarrier>  post_buffer_barriers;
+		//begin halves of split barriers that end in a later level, recorded after the passes of this level
+		RGVector<RGTextureBarrier> begin_texture_barriers;
+		RGVector<RGBufferBarrier>  begin_buffer_barriers;
+		//post barriers are merged with the pre barriers of the next level unless it creates resources
+		Bool flush_post_barriers = true;
+	};
+	using RGBarrierPlan = RenderGraphBarrierPlan;
+
+	class RenderGraphCompileCache
+	{
+		friend class RenderGraph;
+
+		static constexpr Uint64 AllocatorSize = 64 * 1024;
+
+		struct CompiledPass
+		{
+			Uint32 level;
+			Uint64 ref_count;
+			Uint64 wait_graphics_pass_id;
+			Uint64 signal_graphics_pass_id;
+			Uint64 signal_value;
+			Uint64 wait_value;
+			//range in CompiledGraph::events_to_start
+			Uint32 first_event_to_start;
+			Uint32 event_to_start_count;
+			Uint32 num_events_to_end;
+		};
+
+		struct CompiledResource
+		{
+			Uint64 ref_count;
+			Uint64 last_used_by;
+			GfxHeapUsage heap_usage;
+			Uint64 heap_offset;
+		};
+
+		struct CompiledGraph
+		{
+			explicit CompiledGraph(RGAllocator& allocator)
+				: adjacency_lists(allocator), topologically_sorted_passes(allocator), passes(allocator), events_to_start(allocator),
+				  textures(allocator), buffers(allocator), barrier_plans(allocator)
+			{}
+
+			RGVector<RGVector<Uint64>> adjacency_lists;
+			RGVector<Uint64> topologically_sorted_passes;
+			Uint32 level_count = 0;
+			RGVector<CompiledPass> passes;
+			RGVector<Uint32> events_to_start;
+			RGVector<CompiledResource> textures;
+			RGVector<CompiledResource> buffers;
+			RGVector<RGBarrierPlan> barrier_plans;
+			std::array<Uint64, (Uint32)GfxHeapUsage::Count> heap_sizes{};
+			RGAliasingStats aliasing_stats;
+		};
+
+	public:
+		RenderGraphCompileCache() : allocator(AllocatorSize) {}
+		ADRIA_NONCOPYABLE(RenderGraphCompileCache)
+
+		void Invalidate() { valid = false; }
+
+		Uint64 GetHitCount() const { return hit_count; }
+		Uint64 GetMissCount() const { return miss_count; }
+
+	private:
+		Bool valid = false;
+		Uint64 topology_hash = 0;
+		Uint64 hit_count = 0;
+		Uint64 miss_count = 0;
+
+		//the compiled graph lives in an allocator of its own, reset every time a new graph is stored
+		RGAllocator allocator;
+		std::optional<CompiledGraph> compiled_graph;
+	};
+	using RGCompileCache = RenderGraphCompileCache;
+}
\ No newline at end of file
@@ -12,6 +12,7 @@ namespace adria
 {
 	class RenderGraphPassBase;
 	class RenderGraph;
+	class GfxHeap;
 	struct RGTextureDesc;
 	struct RGBufferDesc;
 
@@ -46,6 +47,12 @@ namespace adria
 		RenderGraphPassBase* writer = nullptr;
 		RenderGraphPassBase* last_used_by = nullptr;
 		Char const* name = "";
+
+		GfxHeap* heap = nullptr;
+		Uint64 heap_offset = 0;
+
+		//name, desc and whether it is imported, computed once when the resource is declared or imported
+		Uint64 declaration_hash = 0;
 	};
 	using RGResource = RenderGraphResource;
 
@@ -1,6 +1,8 @@
 #pragma once
 #include "RenderGraphContext.h"
+#include "RenderGraphResourceSet.h"
 #include "Utilities/Enum.h"
+#include "Utilities/Hash.h"
 
 namespace adria
 {
@@ -92,15 +94,19 @@ namespace adria
 		inline static Uint32 unique_pass_id = 0;
 
 	public:
-		explicit RenderGraphPassBase(Char const* name, RGPassType type = RGPassType::Graphics, RGPassFlags flags = RGPassFlags::None)
-			: name(name), type(type), flags(flags), id(0) 
+		//everything the pass owns lives in the allocator of the graph, the name included since callers can pass temporaries
+		RenderGraphPassBase(RGAllocator& allocator, Char const* name, RGPassType type = RGPassType::Graphics, RGPassFlags flags = RGPassFlags::None)
+			: name(allocator.AllocateString(name)), type(type), flags(flags), id(0), render_targets_info(allocator), events_to_start(allocator)
 		{
+			InitializeResourceSets(allocator);
+			setup_hash.Combine(std::string_view(this->name));
+			setup_hash.Combine(type);
+			setup_hash.Combine(flags);
 		}
 		virtual ~RenderGraphPassBase() = default;
 
 	protected:
 
-		virtual void Setup(RenderGraphBuilder&) = 0;
 		virtual void Execute(RenderGraphContext&) const = 0;
 
 		Bool IsCulled() const { return CanBeCulled() && ref_count == 0; }
@@ -108,48 +114,66 @@ namespace adria
 		Bool UseLegacyRenderPasses() const { return HasFlag(flags, RGPassFlags::LegacyRenderPass); }
 
 	private:
-		std::string const name;
+		void InitializeResourceSets(RGAllocator& allocator)
+		{
+			texture_creates.Initialize(allocator);
+			texture_reads.Initialize(allocator);
+			texture_writes.Initialize(allocator);
+			texture_destroys.Initialize(allocator);
+			texture_state_map.Initialize(allocator);
+			buffer_creates.Initialize(allocator);
+			buffer_reads.Initialize(allocator);
+			buffer_writes.Initialize(allocator);
+			buffer_destroys.Initialize(allocator);
+			buffer_state_map.Initialize(allocator);
+		}
+
+	private:
+		Char const* const name;
 		Uint64 ref_count = 0ull;
 		RGPassType type;
 		RGPassFlags flags = RGPassFlags::None;
 		Uint64 id;
 
-		std::unordered_set<RGTextureId> texture_creates;
-		std::unordered_set<RGTextureId> texture_reads;
-		std::unordered_set<RGTextureId> texture_writes;
-		std::unordered_set<RGTextureId> texture_destroys;
-		std::unordered_map<RGTextureId, GfxResourceState> texture_state_map;
+		RGResourceSet<RGTextureId> texture_creates;
+		RGResourceSet<RGTextureId> texture_reads;
+		RGResourceSet<RGTextureId> texture_writes;
+		RGResourceSet<RGTextureId> texture_destroys;
+		RGResourceStateMap<RGTextureId> texture_state_map;
 		
-		std::unordered_set<RGBufferId> buffer_creates;
-		std::unordered_set<RGBufferId> buffer_reads;
-		std::unordered_set<RGBufferId> buffer_writes;
-		std::unordered_set<RGBufferId> buffer_destroys;
-		std::unordered_map<RGBufferId, GfxResourceState> buffer_state_map;
+		RGResourceSet<RGBufferId> buffer_creates;
+		RGResourceSet<RGBufferId> buffer_reads;
+		RGResourceSet<RGBufferId> buffer_writes;
+		RGResourceSet<RGBufferId> buffer_destroys;
+		RGResourceStateMap<RGBufferId> buffer_state_map;
 
-		std::vector<RenderTargetInfo> render_targets_info;
+		RGVector<RenderTargetInfo> render_targets_info;
 		std::optional<DepthStencilInfo> depth_stencil = std::nullopt;
 		Uint32 viewport_width = 0, viewport_height = 0;
 
-		std::vector<Uint32>				events_to_start;
+		RGVector<Uint32>				events_to_start;
 		Uint32							num_events_to_end = 0;
 
 		Uint64 wait_graphics_pass_id	= UINT64_MAX;
 		Uint64 signal_graphics_pass_id	= UINT64_MAX;
 		Uint64 signal_value				= UINT64_MAX;
 		Uint64 wait_value				= UINT64_MAX;
+
+		//accumulated while the pass is set up, every builder call that changes how the graph compiles is combined in call order
+		HashState setup_hash;
 	};
 	using RGPassBase = RenderGraphPassBase;
 
-	template<typename PassData>
+	//setup runs once when the pass is added, only the execute callback is kept. It is stored as is instead of
+	//in a std::function, so passes never allocate outside of the graph allocator whatever their lambdas capture
+	template<typename PassData, typename ExecuteFunc>
 	class RenderGraphPass final : public RenderGraphPassBase
 	{
+		friend RenderGraph;
 	public:
-		using SetupFunc = std::function<void(PassData&, RenderGraphBuilder&)>;
-		using ExecuteFunc = std::function<void(PassData const&, RenderGraphContext&)>;
-
-	public:
-		RenderGraphPass(Char const* name, SetupFunc&& setup, ExecuteFunc&& execute, RGPassType type = RGPassType::Graphics, RGPassFlags flags = RGPassFlags::None)
-			: RenderGraphPassBase(name, type, flags), setup(std::move(setup)), execute(std::move(execute))
+		template<typename Func>
+		RenderGraphPass(RGAllocator& allocator, Char const* name, Func&& execute, RGPassType type = RGPassType::Graphics, RGPassFlags flags = RGPassFlags::None)
+			: RenderGraphPassBase(allocator, name, type, flags), execute(std::forward<Func>(execute))
 		{}
 
 		PassData const& GetPassData() const
@@ -159,34 +183,22 @@ namespace adria
 
 	private:
 		PassData data;
-		SetupFunc setup;
-		ExecuteFunc execute;
+		mutable ExecuteFunc execute;
 
 	private:
-
-		void Setup(RenderGraphBuilder& builder) override
-		{
-			ADRIA_ASSERT_MSG(setup != nullptr, "setup function is null!");
-			setup(data, builder);
-		}
-
 		void Execute(RenderGraphContext& context) const override
 		{
-			ADRIA_ASSERT_MSG(execute != nullptr, "execute function is null!");
 			execute(data, context);
 		}
 	};
 
-	template<>
-	class RenderGraphPass<void> final : public RenderGraphPassBase
+	template<typename ExecuteFunc>
+	class RenderGraphPass<void, ExecuteFunc> final : public RenderGraphPassBase
 	{
 	public:
-		using SetupFunc = std::function<void(RenderGraphBuilder&)>;
-		using ExecuteFunc = std::function<void(RenderGraphContext&)>;
-
-	public:
-		RenderGraphPass(Char const* name, SetupFunc&& setup, ExecuteFunc&& execute, RGPassType type = RGPassType::Graphics, RGPassFlags flags = RGPassFlags::None)
-			: RenderGraphPassBase(name, type, flags), setup(std::move(setup)), execute(std::move(execute))
+		template<typename Func>
+		RenderGraphPass(RGAllocator& allocator, Char const* name, Func&& execute, RGPassType type = RGPassType::Graphics, RGPassFlags flags = RGPassFlags::None)
+			: RenderGraphPassBase(allocator, name, type, flags), execute(std::forward<Func>(execute))
 		{}
 
 		void GetPassData() const
@@ -195,25 +207,17 @@ namespace adria
 		}
 
 	private:
-		SetupFunc setup;
-		ExecuteFunc execute;
+		mutable ExecuteFunc execute;
 
 	private:
-		void Setup(RenderGraphBuilder& builder) override
-		{
-			ADRIA_ASSERT_MSG(setup != nullptr, "setup function is null!");
-			setup(builder);
-		}
-
 		void Execute(RenderGraphContext& context) const override
 		{
-			ADRIA_ASSERT_MSG(execute != nullptr, "execute function is null!");
 			execute(context);
 		}
 	};
 
-	template<typename PassData>
-	using RGPass = RenderGraphPass<PassData>;
+	template<typename PassData, typename ExecuteFunc>
+	using RGPass = RenderGraphPass<PassData, ExecuteFunc>;
 
 	inline std::string RGPassTypeToString(RGPassType type)
 	{
@@ -0,0 +1,108 @@
+#include "RenderGraphResourceAliasing.h"
+#include "Utilities/Align.h"
+
+namespace adria
+{
+	namespace
+	{
+		struct PlacedRange
+		{
+			Uint64 begin;
+			Uint64 end;
+		};
+
+		Bool LifetimesOverlap(RGAliasingRequest const& a, RGAliasingRequest const& b)
+		{
+			return a.first_pass <= b.last_pass && b.first_pass <= a.last_pass;
+		}
+	}
+
+	RGAliasingStats SolveResourceAliasing(std::span<RGAliasingRequest const> requests, std::span<Uint64> offsets, RGAllocator& allocator)
+	{
+		ADRIA_ASSERT(offsets.size() == requests.size());
+		RGAliasingStats stats{};
+		std::fill(offsets.begin(), offsets.end(), 0);
+		if (requests.empty())
+		{
+			return stats;
+		}
+
+		RGVector<Uint32> order(requests.size(), 0, allocator);
+		for (Uint32 i = 0; i < order.size(); ++i)
+		{
+			order[i] = i;
+		}
+		//ties are broken by index instead of using std::stable_sort, which allocates its own buffer
+		std::sort(order.begin(), order.end(), [&requests](Uint32 a, Uint32 b)
+			{
+				if (requests[a].size != requests[b].size)
+				{
+					return requests[a].size > requests[b].size;
+				}
+				if (requests[a].first_pass != requests[b].first_pass)
+				{
+					return requests[a].first_pass < requests[b].first_pass;
+				}
+				return a < b;
+			});
+
+		//placed requests are bucketed by first pass, a placed lifetime can only overlap the request if it starts
+		//no earlier than the longest placed lifetime before the request, so only that window of buckets is scanned
+		Uint32 last_pass = 0;
+		for (RGAliasingRequest const& request : requests)
+		{
+			ADRIA_ASSERT(request.first_pass <= request.last_pass);
+			last_pass = std::max(last_pass, request.last_pass);
+		}
+		RGVector<RGVector<Uint32>> placed_by_first_pass(last_pass + 1, RGVector<Uint32>(allocator), allocator);
+		Uint32 longest_lifetime = 0;
+
+		RGVector<PlacedRange> live_ranges(allocator);
+		live_ranges.reserve(requests.size());
+		for (Uint32 request_idx : order)
+		{
+			RGAliasingRequest const& request = requests[request_idx];
+			Uint64 const alignment = std::max<Uint64>(request.alignment, 1);
+			stats.naive_size = AlignUp(stats.naive_size, alignment) + request.size;
+			++stats.resource_count;
+
+			live_ranges.clear();
+			Uint32 const window_begin = request.first_pass > longest_lifetime ? request.first_pass - longest_lifetime : 0;
+			for (Uint32 pass = window_begin; pass <= request.last_pass; ++pass)
+			{
+				for (Uint32 placed_idx : placed_by_first_pass[pass])
+				{
+					if (LifetimesOverlap(request, requests[placed_idx]))
+					{
+						live_ranges.push_back(PlacedRange{ offsets[placed_idx], offsets[placed_idx] + requests[placed_idx].size });
+					}
+				}
+			}
+			std::sort(live_ranges.begin(), live_ranges.end(), [](PlacedRange const& a, PlacedRange const& b) { return a.begin < b.begin; });
+
+			Uint64 best_offset = UINT64_MAX;
+			Uint64 best_gap = UINT64_MAX;
+			Uint64 gap_begin = 0;
+			for (PlacedRange const& range : live_ranges)
+			{
+				Uint64 const candidate = AlignUp(gap_begin, alignment);
+				if (candidate + request.size <= range.begin && range.begin - candidate < best_gap)
+				{
+					best_offset = candidate;
+					best_gap = range.begin - candidate;
+				}
+				gap_begin = std::max(gap_begin, range.end);
+			}
+			if (best_offset == UINT64_MAX)
+			{
+				best_offset = AlignUp(gap_begin, alignment);
+			}
+
+			offsets[request_idx] = best_offset;
+			stats.heap_size = std::max(stats.heap_size, best_offset + request.size);
+			placed_by_first_pass[request.first_pass].push_back(request_idx);
+			longest_lifetime = std::max(longest_lifetime, request.last_pass - request.first_pass);
+		}
+		return stats;
+	}
+}
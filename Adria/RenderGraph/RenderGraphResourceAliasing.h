@@ -0,0 +1,35 @@
+#pragma once
+#include "RenderGraphAllocator.h"
+
+namespace adria
+{
+	struct RenderGraphAliasingRequest
+	{
+		Uint64 size = 0;
+		Uint64 alignment = 1;
+		Uint32 first_pass = 0;
+		Uint32 last_pass = 0;
+	};
+	using RGAliasingRequest = RenderGraphAliasingRequest;
+
+	struct RenderGraphAliasingStats
+	{
+		Uint64 heap_size = 0;
+		Uint64 naive_size = 0;
+		Uint32 resource_count = 0;
+
+		RenderGraphAliasingStats& operator+=(RenderGraphAliasingStats const& other)
+		{
+			heap_size += other.heap_size;
+			naive_size += other.naive_size;
+			resource_count += other.resource_count;
+			return *this;
+		}
+	};
+	using RGAliasingStats = RenderGraphAliasingStats;
+
+	//places resources with disjoint [first_pass, last_pass] lifetimes at overlapping offsets of a single heap,
+	//offsets[i] receives the placement of requests[i], heap_size of the returned stats is the peak memory needed.
+	//Scratch memory comes from the allocator
+	RGAliasingStats SolveResourceAliasing(std::span<RGAliasingRequest const> requests, std::span<Uint64> offsets, RGAllocator& allocator);
+}
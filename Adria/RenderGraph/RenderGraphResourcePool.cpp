@@ -0,0 +1,452 @@
+#include "RenderGraphResourcePool.h"
+#include "Core/ConsoleManager.h"
+#include "Utilities/Hash.h"
+#include "tracy/Tracy.hpp"
+
+namespace adria
+{
+	static TAutoConsoleVariable<Int> RGPoolBudget("rg.Pool.Budget", 2048, "Memory in MB the render graph resource pool can use before idle resources are evicted");
+	static TAutoConsoleVariable<Int> RGPoolMaxIdleFrames("rg.Pool.MaxIdleFrames", 120, "Number of frames an idle render graph resource is kept even when the pool is under budget");
+
+	//idle resources can still be referenced by frames in flight until then
+	static constexpr Uint64 MinIdleFrames = 4;
+
+	namespace
+	{
+		Uint64 HashTextureDesc(GfxTextureDesc const& desc, GfxHeap const* heap, Uint64 heap_offset)
+		{
+			HashState state;
+			state.Combine(desc.type);
+			state.Combine(desc.width);
+			state.Combine(desc.height);
+			state.Combine(desc.array_size);
+			state.Combine(desc.format);
+			state.Combine(desc.sample_count);
+			state.Combine(desc.heap_type);
+			if (heap)
+			{
+				state.Combine(heap);
+				state.Combine(heap_offset);
+				state.Combine(desc.mip_levels);
+				state.Combine(desc.depth);
+			}
+			return state;
+		}
+
+		Uint64 HashBufferDesc(GfxBufferDesc const& desc, GfxHeap const* heap, Uint64 heap_offset)
+		{
+			HashState state;
+			state.Combine(desc.size);
+			state.Combine(desc.resource_usage);
+			state.Combine(desc.bind_flags);
+			state.Combine(desc.misc_flags);
+			state.Combine(desc.stride);
+			state.Combine(desc.format);
+			if (heap)
+			{
+				state.Combine(heap);
+				state.Combine(heap_offset);
+			}
+			return state;
+		}
+
+		template<typename T>
+		void RemoveIdle(std::unordered_map<Uint64, std::vector<T*>>& idle_resources, Uint64 bucket, T const* resource)
+		{
+			auto it = idle_resources.find(bucket);
+			ADRIA_ASSERT(it != idle_resources.end());
+			std::erase(it->second, resource);
+		}
+	}
+
+	RenderGraphResourcePool::~RenderGraphResourcePool()
+	{
+		for (auto& [texture, pooled_texture] : textures)
+		{
+			FreeTextureViews(pooled_texture.views);
+		}
+	}
+
+	void RenderGraphResourcePool::Tick()
+	{
+		EvictIdleResources();
+
+		stats.hits = frame_stats.hits;
+		stats.misses = frame_stats.misses;
+		stats.evictions = frame_stats.evictions;
+		frame_stats = {};
+
+		TracyPlot("RG Pool Live Bytes", (Int64)stats.live_bytes);
+		TracyPlot("RG Pool Pooled Bytes", (Int64)stats.pooled_bytes);
+		TracyPlot("RG Pool Heap Bytes", (Int64)stats.heap_bytes);
+		TracyPlot("RG Pool Peak Bytes", (Int64)stats.peak_bytes);
+		TracyPlot("RG Pool Hit Rate", stats.hits + stats.misses > 0 ? stats.hits * 100.0f / (stats.hits + stats.misses) : 100.0f);
+		TracyPlot("RG Pool Created", (Int64)stats.misses);
+		TracyPlot("RG Pool Evicted", (Int64)stats.evictions);
+		++frame_index;
+	}
+
+	GfxHeap* RenderGraphResourcePool::AllocateHeap(GfxHeapUsage usage, Uint64 size)
+	{
+		std::unique_ptr<GfxHeap>& heap = heaps[(Uint32)usage];
+		if (heap == nullptr || heap->GetDesc().size < size)
+		{
+			if (GfxHeap* old_heap = heap.get())
+			{
+				std::vector<GfxTexture const*> old_textures;
+				for (auto const& [texture, pooled_texture] : textures)
+				{
+					if (pooled_texture.heap == old_heap)
+					{
+						old_textures.push_back(texture);
+					}
+				}
+				std::vector<GfxBuffer const*> old_buffers;
+				for (auto const& [buffer, pooled_buffer] : buffers)
+				{
+					if (pooled_buffer.heap == old_heap)
+					{
+						old_buffers.push_back(buffer);
+					}
+				}
+				for (GfxTexture const* texture : old_textures)
+				{
+					EraseTexture(texture);
+				}
+				for (GfxBuffer const* buffer : old_buffers)
+				{
+					EraseBuffer(buffer);
+				}
+			}
+			heap = device->CreateHeap(GfxHeapDesc{ .size = size, .usage = usage });
+
+			stats.heap_bytes = 0;
+			for (std::unique_ptr<GfxHeap> const& pool_heap : heaps)
+			{
+				stats.heap_bytes += pool_heap ? pool_heap->GetDesc().size : 0;
+			}
+			UpdatePeak();
+		}
+		return heap.get();
+	}
+
+	GfxTexture* RenderGraphResourcePool::AllocatePlacedTexture(GfxTextureDesc const& desc, GfxHeap* heap, Uint64 heap_offset)
+	{
+		Uint64 const bucket = HashTextureDesc(desc, heap, heap_offset);
+		auto it = idle_textures.find(bucket);
+		if (it != idle_textures.end())
+		{
+			std::vector<GfxTexture*>& idle = it->second;
+			for (Uint64 i = idle.size(); i-- > 0;)
+			{
+				PooledTexture& pooled_texture = textures.find(idle[i])->second;
+				GfxTextureDesc const& placed_desc = pooled_texture.texture->GetDesc();
+				if (pooled_texture.heap == heap && pooled_texture.heap_offset == heap_offset &&
+					placed_desc.IsCompatible(desc) && desc.IsCompatible(placed_desc) && placed_desc.mip_levels == desc.mip_levels && placed_desc.depth == desc.depth)
+				{
+					return AcquireIdleTexture(it, i);
+				}
+			}
+		}
+		//placed memory belongs to the heap and is accounted for there
+		return AddTexture(device->CreatePlacedTexture(desc, heap, heap_offset), heap, heap_offset, bucket, 0);
+	}
+
+	GfxBuffer* RenderGraphResourcePool::AllocatePlacedBuffer(GfxBufferDesc const& desc, GfxHeap* heap, Uint64 heap_offset)
+	{
+		Uint64 const bucket = HashBufferDesc(desc, heap, heap_offset);
+		auto it = idle_buffers.find(bucket);
+		if (it != idle_buffers.end())
+		{
+			std::vector<GfxBuffer*>& idle = it->second;
+			for (Uint64 i = idle.size(); i-- > 0;)
+			{
+				PooledBuffer& pooled_buffer = buffers.find(idle[i])->second;
+				if (pooled_buffer.heap == heap && pooled_buffer.heap_offset == heap_offset && pooled_buffer.buffer->GetDesc() == desc)
+				{
+					return AcquireIdleBuffer(it, i);
+				}
+			}
+		}
+		return AddBuffer(device->CreatePlacedBuffer(desc, heap, heap_offset), heap, heap_offset, bucket, 0);
+	}
+
+	GfxTexture* RenderGraphResourcePool::AllocateTexture(GfxTextureDesc const& desc)
+	{
+		Uint64 const bucket = HashTextureDesc(desc, nullptr, 0);
+		auto it = idle_textures.find(bucket);
+		if (it != idle_textures.end())
+		{
+			std::vector<GfxTexture*>& idle = it->second;
+			for (Uint64 i = idle.size(); i-- > 0;)
+			{
+				PooledTexture& pooled_texture = textures.find(idle[i])->second;
+				if (pooled_texture.heap == nullptr && pooled_texture.texture->GetDesc().IsCompatible(desc))
+				{
+					return AcquireIdleTexture(it, i);
+				}
+			}
+		}
+		return AddTexture(device->CreateTexture(desc), nullptr, 0, bucket, device->GetAllocationInfo(desc).size);
+	}
+
+	void RenderGraphResourcePool::ReleaseTexture(GfxTexture* texture)
+	{
+		auto it = textures.find(texture);
+		if (it == textures.end() || !it->second.active)
+		{
+			return;
+		}
+		PooledTexture& pooled_texture = it->second;
+		pooled_texture.active = false;
+		pooled_texture.last_used_frame = frame_index;
+		idle_textures[pooled_texture.bucket].push_back(texture);
+		stats.live_bytes -= pooled_texture.size;
+		stats.pooled_bytes += pooled_texture.size;
+	}
+
+	GfxBuffer* RenderGraphResourcePool::AllocateBuffer(GfxBufferDesc const& desc)
+	{
+		Uint64 const bucket = HashBufferDesc(desc, nullptr, 0);
+		auto it = idle_buffers.find(bucket);
+		if (it != idle_buffers.end())
+		{
+			std::vector<GfxBuffer*>& idle = it->second;
+			for (Uint64 i = idle.size(); i-- > 0;)
+			{
+				PooledBuffer& pooled_buffer = buffers.find(idle[i])->second;
+				if (pooled_buffer.heap == nullptr && pooled_buffer.buffer->GetDesc() == desc)
+				{
+					return AcquireIdleBuffer(it, i);
+				}
+			}
+		}
+		return AddBuffer(device->CreateBuffer(desc), nullptr, 0, bucket, device->GetAllocationInfo(desc).size);
+	}
+
+	void RenderGraphResourcePool::ReleaseBuffer(GfxBuffer* buffer)
+	{
+		auto it = buffers.find(buffer);
+		if (it == buffers.end() || !it->second.active)
+		{
+			return;
+		}
+		PooledBuffer& pooled_buffer = it->second;
+		pooled_buffer.active = false;
+		pooled_buffer.last_used_frame = frame_index;
+		idle_buffers[pooled_buffer.bucket].push_back(buffer);
+		stats.live_bytes -= pooled_buffer.size;
+		stats.pooled_bytes += pooled_buffer.size;
+	}
+
+	GfxDescriptor RenderGraphResourcePool::GetTextureView(GfxTexture* texture, GfxSubresourceType type, GfxTextureDescriptorDesc const& desc)
+	{
+		ADRIA_ASSERT(type == GfxSubresourceType::RTV || type == GfxSubresourceType::DSV);
+		auto it = textures.find(texture);
+		ADRIA_ASSERT_MSG(it != textures.end(), "Texture is not owned by the resource pool");
+		std::vector<PooledTextureView>& views = it->second.views;
+		for (PooledTextureView const& view : views)
+		{
+			if (view.type == type && view.desc == desc)
+			{
+				return view.descriptor;
+			}
+		}
+		GfxDescriptor descriptor = type == GfxSubresourceType::RTV ? device->CreateTextureRTV(texture, &desc) : device->CreateTextureDSV(texture, &desc);
+		views.push_back(PooledTextureView{ desc, type, descriptor });
+		return descriptor;
+	}
+
+	GfxCommandList* RenderGraphResourcePool::GetCommandList(Uint32 index)
+	{
+		std::vector<GfxCommandList*>& cmd_lists = command_lists[device->GetBackbufferIndex()];
+		while (cmd_lists.size() <= index)
+		{
+			cmd_lists.push_back(device->AllocateGraphicsCommandList());
+		}
+		return cmd_lists[index];
+	}
+
+	GfxTexture* RenderGraphResourcePool::AcquireIdleTexture(IdleTextureMap::iterator bucket_it, Uint64 index)
+	{
+		std::vector<GfxTexture*>& idle = bucket_it->second;
+		GfxTexture* texture = idle[index];
+		idle.erase(idle.begin() + index);
+
+		PooledTexture& pooled_texture = textures.find(texture)->second;
+		pooled_texture.active = true;
+		pooled_texture.last_used_frame = frame_index;
+		stats.pooled_bytes -= pooled_texture.size;
+		stats.live_bytes += pooled_texture.size;
+		++frame_stats.hits;
+		return texture;
+	}
+
+	GfxBuffer* RenderGraphResourcePool::AcquireIdleBuffer(IdleBufferMap::iterator bucket_it, Uint64 index)
+	{
+		std::vector<GfxBuffer*>& idle = bucket_it->second;
+		GfxBuffer* buffer = idle[index];
+		idle.erase(idle.begin() + index);
+
+		PooledBuffer& pooled_buffer = buffers.find(buffer)->second;
+		pooled_buffer.active = true;
+		pooled_buffer.last_used_frame = frame_index;
+		stats.pooled_bytes -= pooled_buffer.size;
+		stats.live_bytes += pooled_buffer.size;
+		++frame_stats.hits;
+		return buffer;
+	}
+
+	GfxTexture* RenderGraphResourcePool::AddTexture(std::unique_ptr<GfxTexture>&& texture, GfxHeap* heap, Uint64 heap_offset, Uint64 bucket, Uint64 size)
+	{
+		GfxTexture* texture_ptr = texture.get();
+		textures.emplace(texture_ptr, PooledTexture{ std::move(texture), heap, heap_offset, bucket, size, frame_index, true, {} });
+		stats.live_bytes += size;
+		++frame_stats.misses;
+		UpdatePeak();
+		return texture_ptr;
+	}
+
+	GfxBuffer* RenderGraphResourcePool::AddBuffer(std::unique_ptr<GfxBuffer>&& buffer, GfxHeap* heap, Uint64 heap_offset, Uint64 bucket, Uint64 size)
+	{
+		GfxBuffer* buffer_ptr = buffer.get();
+		buffers.emplace(buffer_ptr, PooledBuffer{ std::move(buffer), heap, heap_offset, bucket, size, frame_index, true });
+		stats.live_bytes += size;
+		++frame_stats.misses;
+		UpdatePeak();
+		return buffer_ptr;
+	}
+
+	void RenderGraphResourcePool::EraseTexture(GfxTexture const* texture)
+	{
+		auto it = textures.find(texture);
+		ADRIA_ASSERT(it != textures.end());
+		PooledTexture& pooled_texture = it->second;
+		if (pooled_texture.active)
+		{
+			stats.live_bytes -= pooled_texture.size;
+		}
+		else
+		{
+			RemoveIdle(idle_textures, pooled_texture.bucket, texture);
+			stats.pooled_bytes -= pooled_texture.size;
+		}
+		FreeTextureViews(pooled_texture.views);
+		textures.erase(it);
+	}
+
+	void RenderGraphResourcePool::EraseBuffer(GfxBuffer const* buffer)
+	{
+		auto it = buffers.find(buffer);
+		ADRIA_ASSERT(it != buffers.end());
+		PooledBuffer& pooled_buffer = it->second;
+		if (pooled_buffer.active)
+		{
+			stats.live_bytes -= pooled_buffer.size;
+		}
+		else
+		{
+			RemoveIdle(idle_buffers, pooled_buffer.bucket, buffer);
+			stats.pooled_bytes -= pooled_buffer.size;
+		}
+		buffers.erase(it);
+	}
+
+	void RenderGraphResourcePool::EvictIdleResources()
+	{
+		struct EvictionCandidate
+		{
+			Uint64 last_used_frame;
+			GfxTexture const* texture;
+			GfxBuffer const* buffer;
+		};
+		std::vector<EvictionCandidate> candidates;
+		std::vector<GfxTexture const*> evicted_textures;
+		std::vector<GfxBuffer const*> evicted_buffers;
+
+		//placed resources cost no memory of their own, they go once idle for a few frames like before.
+		//Committed ones stay while the pool is under budget unless they have not been used for a long time
+		Uint64 const max_idle_frames = std::max<Uint64>(RGPoolMaxIdleFrames.Get(), MinIdleFrames);
+		for (auto const& [bucket, idle] : idle_textures)
+		{
+			for (GfxTexture const* texture : idle)
+			{
+				PooledTexture const& pooled_texture = textures.find(texture)->second;
+				if (pooled_texture.last_used_frame + MinIdleFrames >= frame_index)
+				{
+					continue;
+				}
+				if (pooled_texture.heap || pooled_texture.last_used_frame + max_idle_frames < frame_index)
+				{
+					evicted_textures.push_back(texture);
+				}
+				else
+				{
+					candidates.emplace_back(pooled_texture.last_used_frame, texture, nullptr);
+				}
+			}
+		}
+		for (auto const& [bucket, idle] : idle_buffers)
+		{
+			for (GfxBuffer const* buffer : idle)
+			{
+				PooledBuffer const& pooled_buffer = buffers.find(buffer)->second;
+				if (pooled_buffer.last_used_frame + MinIdleFrames >= frame_index)
+				{
+					continue;
+				}
+				if (pooled_buffer.heap || pooled_buffer.last_used_frame + max_idle_frames < frame_index)
+				{
+					evicted_buffers.push_back(buffer);
+				}
+				else
+				{
+					candidates.emplace_back(pooled_buffer.last_used_frame, nullptr, buffer);
+				}
+			}
+		}
+
+		for (GfxTexture const* texture : evicted_textures)
+		{
+			EraseTexture(texture);
+		}
+		for (GfxBuffer const* buffer : evicted_buffers)
+		{
+			EraseBuffer(buffer);
+		}
+		frame_stats.evictions += (Uint32)(evicted_textures.size() + evicted_buffers.size());
+		//buckets stay around while in use so release does not allocate, the ones left empty after a resize are dropped here
+		std::erase_if(idle_textures, [](auto const& bucket) { return bucket.second.empty(); });
+		std::erase_if(idle_buffers, [](auto const& bucket) { return bucket.second.empty(); });
+
+		Uint64 const budget = (Uint64)std::max(RGPoolBudget.Get(), 0) * 1024 * 1024;
+		if (stats.live_bytes + stats.pooled_bytes + stats.heap_bytes <= budget || candidates.empty())
+		{
+			return;
+		}
+		std::sort(candidates.begin(), candidates.end(), [](EvictionCandidate const& lhs, EvictionCandidate const& rhs) { return lhs.last_used_frame < rhs.last_used_frame; });
+		for (EvictionCandidate const& candidate : candidates)
+		{
+			if (stats.live_bytes + stats.pooled_bytes + stats.heap_bytes <= budget)
+			{
+				break;
+			}
+			candidate.texture ? EraseTexture(candidate.texture) : EraseBuffer(candidate.buffer);
+			++frame_stats.evictions;
+		}
+	}
+
+	void RenderGraphResourcePool::UpdatePeak()
+	{
+		stats.peak_bytes = std::max(stats.peak_bytes, stats.live_bytes + stats.pooled_bytes + stats.heap_bytes);
+	}
+
+	void RenderGraphResourcePool::FreeTextureViews(std::vector<PooledTextureView>& views)
+	{
+		for (PooledTextureView const& view : views)
+		{
+			device->FreeCPUDescriptor(view.descriptor);
+		}
+		views.clear();
+	}
+}
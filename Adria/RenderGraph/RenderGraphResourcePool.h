@@ -2,107 +2,110 @@
 #include "Graphics/GfxDevice.h"
 #include "Graphics/GfxBuffer.h"
 #include "Graphics/GfxTexture.h"
+#include "Graphics/GfxHeap.h"
 
 namespace adria
 {
+	struct RenderGraphResourcePoolStats
+	{
+		Uint64 live_bytes = 0;
+		Uint64 pooled_bytes = 0;
+		Uint64 heap_bytes = 0;
+		Uint64 peak_bytes = 0;
+		Uint32 hits = 0;
+		Uint32 misses = 0;
+		Uint32 evictions = 0;
+	};
+
+	//committed and placed resources are owned by pointer and idle ones are bucketed by a hash of their description,
+	//so allocation only checks resources that can match and release is a single lookup.
+	//Idle committed resources are evicted least recently used first when the pool goes over rg.Pool.Budget
 	class RenderGraphResourcePool
 	{
+		struct PooledTextureView
+		{
+			GfxTextureDescriptorDesc desc;
+			GfxSubresourceType type;
+			GfxDescriptor descriptor;
+		};
+
 		struct PooledTexture
 		{
 			std::unique_ptr<GfxTexture> texture;
+			GfxHeap* heap;
+			Uint64 heap_offset;
+			Uint64 bucket;
+			Uint64 size;
 			Uint64 last_used_frame;
+			Bool active;
+			std::vector<PooledTextureView> views;
 		};
 
 		struct PooledBuffer
 		{
 			std::unique_ptr<GfxBuffer> buffer;
+			GfxHeap* heap;
+			Uint64 heap_offset;
+			Uint64 bucket;
+			Uint64 size;
 			Uint64 last_used_frame;
+			Bool active;
 		};
 
+		using IdleTextureMap = std::unordered_map<Uint64, std::vector<GfxTexture*>>;
+		using IdleBufferMap = std::unordered_map<Uint64, std::vector<GfxBuffer*>>;
+
 	public:
 		explicit RenderGraphResourcePool(GfxDevice* device) : device(device) {}
+		ADRIA_NONCOPYABLE(RenderGraphResourcePool)
+		~RenderGraphResourcePool();
 
-		void Tick()
-		{
-			for (Uint64 i = 0; i < texture_pool.size();)
-			{
-				PooledTexture& resource = texture_pool[i].first;
-				Bool active = texture_pool[i].second;
-				if (!active && resource.last_used_frame + 4 < frame_index)
-				{
-					std::swap(texture_pool[i], texture_pool.back());
-					texture_pool.pop_back();
-				}
-				else
-				{
-					++i;
-				}
-			}
-			++frame_index;
-		}
-
-		GfxTexture* AllocateTexture(GfxTextureDesc const& desc)
-		{
-			for (auto& [pool_texture, active] : texture_pool)
-			{
-				if (!active && pool_texture.texture->GetDesc().IsCompatible(desc))
-				{
-					pool_texture.last_used_frame = frame_index;
-					active = true;
-					return pool_texture.texture.get();
-				}
-			}
-			auto& texture = texture_pool.emplace_back(std::pair{ PooledTexture{ device->CreateTexture(desc), frame_index}, true}).first.texture;
-			return texture.get();
-		}
-		void ReleaseTexture(GfxTexture* texture)
-		{
-			for (auto& [pooled_texture, active] : texture_pool)
-			{
-				auto& texture_ptr = pooled_texture.texture;
-				if (active && texture_ptr.get() == texture)
-				{
-					active = false;
-					return;
-				}
-			}
-		}
-
-		GfxBuffer* AllocateBuffer(GfxBufferDesc const& desc)
-		{
-			for (auto& [pool_buffer, active] : buffer_pool)
-			{
-				if (!active && pool_buffer.buffer->GetDesc() == desc)
-				{
-					pool_buffer.last_used_frame = frame_index;
-					active = true;
-					return pool_buffer.buffer.get();
-				}
-			}
-			auto& buffer = buffer_pool.emplace_back(std::pair{ PooledBuffer{ device->CreateBuffer(desc), frame_index}, true }).first.buffer;
-			return buffer.get();
-		}
-		void ReleaseBuffer(GfxBuffer* buffer)
-		{
-			for (auto& [pooled_buffer, active] : buffer_pool)
-			{
-				auto& buffer_ptr = pooled_buffer.buffer;
-				if (active && buffer_ptr.get() == buffer)
-				{
-					active = false;
-					return;
-				}
-			}
-		}
+		void Tick();
+
+		GfxHeap* AllocateHeap(GfxHeapUsage usage, Uint64 size);
+		GfxTexture* AllocatePlacedTexture(GfxTextureDesc const& desc, GfxHeap* heap, Uint64 heap_offset);
+		GfxBuffer* AllocatePlacedBuffer(GfxBufferDesc const& desc, GfxHeap* heap, Uint64 heap_offset);
+
+		GfxTexture* AllocateTexture(GfxTextureDesc const& desc);
+		void ReleaseTexture(GfxTexture* texture);
+
+		GfxBuffer* AllocateBuffer(GfxBufferDesc const& desc);
+		void ReleaseBuffer(GfxBuffer* buffer);
+
+		//render target and depth stencil views are CPU descriptors, so they live as long as the pooled texture
+		GfxDescriptor GetTextureView(GfxTexture* texture, GfxSubresourceType type, GfxTextureDescriptorDesc const& desc);
+
+		//extra command lists for parallel recording, the device allocates them per backbuffer so they are requested once and reused
+		GfxCommandList* GetCommandList(Uint32 index);
 
 		GfxDevice* GetDevice() const { return device; }
+		//byte counts are current, hit, miss and eviction counts are for the last ticked frame
+		RenderGraphResourcePoolStats const& GetStats() const { return stats; }
 
 	private:
 		GfxDevice* device = nullptr;
 		Uint64 frame_index = 0;
-		std::vector<std::pair<PooledTexture, Bool>> texture_pool;
-		std::vector<std::pair<PooledBuffer, Bool>>  buffer_pool;
+		std::unordered_map<GfxTexture const*, PooledTexture> textures;
+		std::unordered_map<GfxBuffer const*, PooledBuffer> buffers;
+		IdleTextureMap idle_textures;
+		IdleBufferMap idle_buffers;
+		std::array<std::unique_ptr<GfxHeap>, (Uint32)GfxHeapUsage::Count> heaps;
+		std::array<std::vector<GfxCommandList*>, GFX_BACKBUFFER_COUNT> command_lists;
+		RenderGraphResourcePoolStats stats;
+		RenderGraphResourcePoolStats frame_stats;
+
+	private:
+		GfxTexture* AcquireIdleTexture(IdleTextureMap::iterator bucket_it, Uint64 index);
+		GfxBuffer* AcquireIdleBuffer(IdleBufferMap::iterator bucket_it, Uint64 index);
+		GfxTexture* AddTexture(std::unique_ptr<GfxTexture>&& texture, GfxHeap* heap, Uint64 heap_offset, Uint64 bucket, Uint64 size);
+		GfxBuffer* AddBuffer(std::unique_ptr<GfxBuffer>&& buffer, GfxHeap* heap, Uint64 heap_offset, Uint64 bucket, Uint64 size);
+		void EraseTexture(GfxTexture const* texture);
+		void EraseBuffer(GfxBuffer const* buffer);
+		void EvictIdleResources();
+		void UpdatePeak();
+
+		void FreeTextureViews(std::vector<PooledTextureView>& views);
 	};
 	using RGResourcePool = RenderGraphResourcePool;
 
-}
\ No newline at end of file
+}
@@ -0,0 +1,175 @@
+#pragma once
+#include "RenderGraphAllocator.h"
+#include "Graphics/GfxResource.h"
+
+namespace adria
+{
+	//resource ids are small dense integers, so sets are flat arrays allocated from the graph allocator.
+	//Lookups scan linearly. A set initialized with the final resource count adds an id -> slot table once it holds
+	//IndexThreshold elements, so the many small sets of a deep graph never pay for a table sized by the resource count.
+	template<typename T>
+	class RenderGraphFlatArray
+	{
+		static constexpr Uint32 InitialCapacity = 8;
+		static constexpr Uint32 IndexThreshold = 32;
+
+	public:
+		void Initialize(RGAllocator& _allocator, Uint64 resource_count = 0)
+		{
+			allocator = &_allocator;
+			slot_count = resource_count;
+		}
+
+		T* begin() { return elements; }
+		T* end() { return elements + element_count; }
+		T const* begin() const { return elements; }
+		T const* end() const { return elements + element_count; }
+		Uint64 size() const { return element_count; }
+		Bool empty() const { return element_count == 0; }
+
+	protected:
+		static constexpr Uint32 InvalidSlot = Uint32(-1);
+
+		RGAllocator* allocator = nullptr;
+		T* elements = nullptr;
+		Uint32 element_count = 0;
+		Uint32 element_capacity = 0;
+		Uint32* slots = nullptr;
+		Uint64 slot_count = 0;
+
+	protected:
+		Uint32 FindSlot(Uint32 id) const
+		{
+			if (slots)
+			{
+				return id < slot_count ? slots[id] : InvalidSlot;
+			}
+			for (Uint32 i = 0; i < element_count; ++i)
+			{
+				if (GetId(elements[i]) == id)
+				{
+					return i;
+				}
+			}
+			return InvalidSlot;
+		}
+
+		T& Append(Uint32 id, T const& element)
+		{
+			ADRIA_ASSERT_MSG(allocator != nullptr, "Resource set used before Initialize");
+			if (element_count == element_capacity)
+			{
+				Grow(std::max<Uint32>(element_capacity * 2, InitialCapacity));
+			}
+			if (slots)
+			{
+				ADRIA_ASSERT(id < slot_count);
+				slots[id] = element_count;
+			}
+			T* appended = new (elements + element_count) T(element);
+			++element_count;
+			if (!slots && slot_count > 0 && element_count == IndexThreshold)
+			{
+				BuildIndex();
+			}
+			return *appended;
+		}
+
+	private:
+		void BuildIndex()
+		{
+			slots = allocator->AllocateArray<Uint32>(slot_count);
+			std::fill_n(slots, slot_count, InvalidSlot);
+			for (Uint32 i = 0; i < element_count; ++i)
+			{
+				slots[GetId(elements[i])] = i;
+			}
+		}
+
+		void Grow(Uint64 capacity)
+		{
+			T* new_elements = allocator->AllocateArray<T>(capacity);
+			if (element_count > 0)
+			{
+				std::memcpy(new_elements, elements, sizeof(T) * element_count);
+			}
+			elements = new_elements;
+			element_capacity = (Uint32)capacity;
+		}
+
+		static Uint32 GetId(T const& element)
+		{
+			if constexpr (requires { element.state; })
+			{
+				return element.id.id;
+			}
+			else
+			{
+				return element.id;
+			}
+		}
+	};
+
+	template<typename ResourceId>
+	class RenderGraphResourceSet : public RenderGraphFlatArray<ResourceId>
+	{
+		using Base = RenderGraphFlatArray<ResourceId>;
+	public:
+		void insert(ResourceId id)
+		{
+			if (Base::FindSlot(id.id) == Base::InvalidSlot)
+			{
+				Base::Append(id.id, id);
+			}
+		}
+		template<typename It>
+		void insert(It first, It last)
+		{
+			for (; first != last; ++first)
+			{
+				insert(*first);
+			}
+		}
+		Bool contains(ResourceId id) const
+		{
+			return Base::FindSlot(id.id) != Base::InvalidSlot;
+		}
+	};
+	template<typename ResourceId>
+	using RGResourceSet = RenderGraphResourceSet<ResourceId>;
+
+	template<typename ResourceId>
+	struct RenderGraphResourceState
+	{
+		ResourceId id;
+		GfxResourceState state;
+	};
+
+	template<typename ResourceId>
+	class RenderGraphResourceStateMap : public RenderGraphFlatArray<RenderGraphResourceState<ResourceId>>
+	{
+		using Base = RenderGraphFlatArray<RenderGraphResourceState<ResourceId>>;
+	public:
+		GfxResourceState& operator[](ResourceId id)
+		{
+			Uint32 slot = Base::FindSlot(id.id);
+			if (slot == Base::InvalidSlot)
+			{
+				return Base::Append(id.id, RenderGraphResourceState<ResourceId>{ id, GfxResourceState::None }).state;
+			}
+			return Base::elements[slot].state;
+		}
+		GfxResourceState at(ResourceId id) const
+		{
+			Uint32 slot = Base::FindSlot(id.id);
+			ADRIA_ASSERT(slot != Base::InvalidSlot);
+			return Base::elements[slot].state;
+		}
+		Bool contains(ResourceId id) const
+		{
+			return Base::FindSlot(id.id) != Base::InvalidSlot;
+		}
+	};
+	template<typename ResourceId>
+	using RGResourceStateMap = RenderGraphResourceStateMap<ResourceId>;
+}
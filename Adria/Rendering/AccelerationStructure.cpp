@@ -28,14 +28,28 @@ namespace adria
 			GfxRayTracingGeometry& rt_geometry = rt_geometries.emplace_back();
 			rt_geometry.vertex_buffer = geometry_buffer;
 			rt_geometry.vertex_buffer_offset = submesh.positions_offset;
-			rt_geometry.vertex_format = GfxFormat::R32G32B32_FLOAT;
+			rt_geometry.vertex_format = (submesh.flags & SubMeshFlag_QuantizedPositions) ? GfxFormat::R16G16B16A16_SNORM : GfxFormat::R32G32B32_FLOAT;
 			rt_geometry.vertex_stride = GetGfxFormatStride(rt_geometry.vertex_format);
 			rt_geometry.vertex_count = submesh.vertices_count;
+			if (submesh.flags & SubMeshFlag_QuantizedPositions)
+			{
+				//the build expands the snorm positions back to the submesh bounds
+				Vector3 const center = submesh.bounding_box.Center;
+				Vector3 const extents = submesh.bounding_box.Extents;
+				Float const vertex_transform[3][4] =
+				{
+					{ extents.x, 0.0f, 0.0f, center.x },
+					{ 0.0f, extents.y, 0.0f, center.y },
+					{ 0.0f, 0.0f, extents.z, center.z }
+				};
+				memcpy(rt_geometry.vertex_transform, vertex_transform, sizeof(vertex_transform));
+				rt_geometry.use_vertex_transform = true;
+			}
 
 			rt_geometry.index_buffer = geometry_buffer;
 			rt_geometry.index_buffer_offset = submesh.indices_offset;
 			rt_geometry.index_count = submesh.indices_count;
-			rt_geometry.index_format = GfxFormat::R32_UINT;
+			rt_geometry.index_format = submesh.GetIndexFormat();
 			rt_geometry.opaque = material.alpha_mode == MaterialAlphaMode::Opaque;
 
 			GfxRayTracingInstance& rt_instance = rt_instances.emplace_back();
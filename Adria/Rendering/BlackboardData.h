@@ -2,6 +2,8 @@
 
 namespace adria
 {
+	struct Batch;
+
 	struct FrameBlackboardData
 	{
 		DirectX::XMMATRIX			camera_view;
@@ -18,6 +20,15 @@ namespace adria
 		Uint64						frame_cbuffer_address;
 	};
 
+	//visible batches sorted once per frame, by pso and front to back for the opaque passes and back to front for transparent ones
+	struct CameraDrawsBlackboardData
+	{
+		Batch const* const* draws;
+		Uint64				draw_count;
+		Batch const* const* transparent_draws;
+		Uint64				transparent_draw_count;
+	};
+
 	struct DoFBlackboardData
 	{
 		Float dof_focus_distance;
@@ -35,6 +35,7 @@ namespace adria
 		Float AspectRatio() const;
 
 		void SetPosition(Vector3 const& pos);
+		void SetLookAt(Vector3 const& look_at);
 		void SetNearAndFar(Float n, Float f);
 		void SetAspectRatio(Float ar);
 		void SetFov(Float fov);
@@ -40,6 +40,13 @@ namespace adria
 		Count
 	};
 
+	//material state that selects a pipeline state permutation, packed into a small index so passes can cache psos per batch
+	inline constexpr Uint32 MaterialPermutationCount = 3 * (Uint32)ShadingExtension::Count;
+	constexpr Uint8 GetMaterialPermutation(MaterialAlphaMode alpha_mode, ShadingExtension shading_extension)
+	{
+		return (Uint8)((Uint32)alpha_mode * (Uint32)ShadingExtension::Count + (Uint32)shading_extension);
+	}
+
 	struct COMPONENT Transform
 	{
 		Matrix current_transform = Matrix::Identity;
@@ -154,6 +161,17 @@ namespace adria
 	struct COMPONENT Ocean {};
 	struct COMPONENT Transparent {};
 
+	//compact vertex streams written by the cooker, mirrored by the MeshFlag_ defines in Scene.hlsli
+	enum SubMeshFlagBit : Uint32
+	{
+		SubMeshFlag_None = 0,
+		SubMeshFlag_QuantizedPositions = BIT(0),
+		SubMeshFlag_OctahedralNormals = BIT(1),
+		SubMeshFlag_HalfUVs = BIT(2),
+		SubMeshFlag_16BitIndices = BIT(3)
+	};
+	using SubMeshFlags = Uint32;
+
 	struct SubMeshGPU
 	{
 		Uint64 buffer_address;
@@ -175,6 +193,9 @@ namespace adria
 		Uint32 material_index;
 		DirectX::BoundingBox bounding_box;
 		GfxPrimitiveTopology topology;
+		SubMeshFlags flags;
+
+		GfxFormat GetIndexFormat() const { return (flags & SubMeshFlag_16BitIndices) ? GfxFormat::R16_UINT : GfxFormat::R32_UINT; }
 	};
 	struct SubMeshInstance
 	{
@@ -188,6 +209,8 @@ namespace adria
 		std::vector<Material> materials;
 		std::vector<SubMeshGPU> submeshes;
 		std::vector<SubMeshInstance> instances;
+		//set after changing instances, submeshes or materials so the renderer rewrites the scene buffer slots of this mesh
+		Bool dirty = true;
 	};
 
 	struct COMPONENT Batch
@@ -196,6 +219,7 @@ namespace adria
 		SubMeshGPU*  submesh;
 		ShadingExtension shading_extension;
 		MaterialAlphaMode alpha_mode;
+		Uint8 material_permutation;
 		Matrix world_transform;
 		BoundingBox bounding_box;
 		Bool camera_visibility = true;
@@ -26,6 +26,7 @@ namespace adria
 	void GBufferPass::AddPass(RenderGraph& rg)
 	{
 		FrameBlackboardData const& frame_data = rg.GetBlackboard().Get<FrameBlackboardData>();
+		CameraDrawsBlackboardData const& draws_data = rg.GetBlackboard().Get<CameraDrawsBlackboardData>();
 		rg.AddPass<void>("GBuffer Pass",
 			[=, this](RenderGraphBuilder& builder)
 			{
@@ -58,36 +59,13 @@ namespace adria
 			{
 				GfxCommandList* cmd_list = ctx.GetCommandList();
 
-				reg.sort<Batch>([&frame_data](Batch const& lhs, Batch const& rhs)
-					{ 
-						if (lhs.alpha_mode != rhs.alpha_mode)
-						{
-							return lhs.alpha_mode < rhs.alpha_mode;
-						}
-						if (lhs.shading_extension != rhs.shading_extension)
-						{
-							return lhs.shading_extension < rhs.shading_extension;
-						}
-						Vector3 camera_position(frame_data.camera_position);
-						Float lhs_distance = Vector3::DistanceSquared(camera_position, lhs.bounding_box.Center);
-						Float rhs_distance = Vector3::DistanceSquared(camera_position, rhs.bounding_box.Center);
-						return lhs_distance < rhs_distance;
-					});
-
 				cmd_list->SetRootCBV(0, frame_data.frame_cbuffer_address);
 				GfxDevice* gfx = cmd_list->GetDevice();
 
 				GfxShadingRateInfo const& vrs = gfx->GetShadingRateInfo();
 				cmd_list->BeginVRS(vrs);
 
-				if (skip_alpha_blended)
-				{
-					ProcessBatches(reg.view<Batch>(entt::exclude_t<Transparent>()), cmd_list);
-				}
-				else
-				{
-					ProcessBatches(reg.view<Batch>(), cmd_list);
-				}
+				ProcessBatches(std::span(draws_data.draws, draws_data.draw_count), cmd_list);
 
 				cmd_list->EndVRS(vrs);
 			}, RGPassType::Graphics, RGPassFlags::None);
@@ -125,16 +103,15 @@ namespace adria
 		gbuffer_psos = std::make_unique<GfxGraphicsPipelineStatePermutations>(gfx, gbuffer_pso_desc);
 	}
 
-	template<typename View>
-	void GBufferPass::ProcessBatches(View view, GfxCommandList* cmd_list)
+	void GBufferPass::ProcessBatches(std::span<Batch const* const> draws, GfxCommandList* cmd_list)
 	{
-		auto GetPSO = [this](ShadingExtension extension, MaterialAlphaMode alpha_mode)
+		auto CreatePSO = [this](Uint32 pass_permutation, ShadingExtension extension, MaterialAlphaMode alpha_mode)
 			{
 				using enum GfxShaderStage;
-				if (raining) gbuffer_psos->AddDefine<PS>("RAIN", "1");
-				if (debug_mipmaps) gbuffer_psos->AddDefine<PS>("VIEW_MIPMAPS", "1");
-				if (triangle_overdraw) gbuffer_psos->AddDefine<PS>("TRIANGLE_OVERDRAW", "1");
-				if (material_ids) gbuffer_psos->AddDefine<PS>("MATERIAL_ID", "1");
+				if (pass_permutation & GBufferPermutation_Rain) gbuffer_psos->AddDefine<PS>("RAIN", "1");
+				if (pass_permutation & GBufferPermutation_ViewMipMaps) gbuffer_psos->AddDefine<PS>("VIEW_MIPMAPS", "1");
+				if (pass_permutation & GBufferPermutation_TriangleOverdraw) gbuffer_psos->AddDefine<PS>("TRIANGLE_OVERDRAW", "1");
+				if (pass_permutation & GBufferPermutation_MaterialID) gbuffer_psos->AddDefine<PS>("MATERIAL_ID", "1");
 
 				switch (extension)
 				{
@@ -152,16 +129,39 @@ namespace adria
 				return gbuffer_psos->Get();
 			};
 
-		for (entt::entity batch_entity : view)
+		//a shader recompile destroys the cached psos
+		if (gbuffer_pso_cache_generation != gbuffer_psos->GetGeneration())
+		{
+			gbuffer_pso_cache.fill(nullptr);
+			gbuffer_pso_cache_generation = gbuffer_psos->GetGeneration();
+		}
+
+		Uint32 pass_permutation = 0;
+		if (raining) pass_permutation |= GBufferPermutation_Rain;
+		if (debug_mipmaps) pass_permutation |= GBufferPermutation_ViewMipMaps;
+		if (triangle_overdraw) pass_permutation |= GBufferPermutation_TriangleOverdraw;
+		if (material_ids) pass_permutation |= GBufferPermutation_MaterialID;
+		GfxPipelineState const** pass_psos = &gbuffer_pso_cache[pass_permutation * MaterialPermutationCount];
+
+		GfxPipelineState const* current_pso = nullptr;
+		for (Batch const* draw : draws)
 		{
-			Batch& batch = view.template get<Batch>(batch_entity);
-			if (!batch.camera_visibility)
+			Batch const& batch = *draw;
+			if (skip_alpha_blended && batch.alpha_mode == MaterialAlphaMode::Blend)
 			{
 				continue;
 			}
 
-			GfxPipelineState const* pso = GetPSO(batch.shading_extension, batch.alpha_mode);
-			cmd_list->SetPipelineState(pso);
+			GfxPipelineState const*& pso = pass_psos[batch.material_permutation];
+			if (!pso)
+			{
+				pso = CreatePSO(pass_permutation, batch.shading_extension, batch.alpha_mode);
+			}
+			if (pso != current_pso)
+			{
+				cmd_list->SetPipelineState(pso);
+				current_pso = pso;
+			}
 
 			struct GBufferConstants
 			{
@@ -169,11 +169,10 @@ namespace adria
 			} constants{ .instance_id = batch.instance_id };
 			cmd_list->SetRootConstants(1, constants);
 
-			GfxIndexBufferView ibv(batch.submesh->buffer_address + batch.submesh->indices_offset, batch.submesh->indices_count);
+			GfxIndexBufferView ibv(batch.submesh->buffer_address + batch.submesh->indices_offset, batch.submesh->indices_count, batch.submesh->GetIndexFormat());
 			cmd_list->SetPrimitiveTopology(batch.submesh->topology);
 			cmd_list->SetIndexBuffer(&ibv);
 			cmd_list->DrawIndexed(batch.submesh->indices_count);
 		}
 	}
 }
-
@@ -1,6 +1,7 @@
 #pragma once
 #include "Graphics/GfxPipelineStatePermutations.h"
 #include "RenderGraph/RenderGraphResourceId.h"
+#include "Components.h"
 #include "entt/entity/fwd.hpp"
 
 namespace adria
@@ -12,6 +13,16 @@ namespace adria
 
 	class GBufferPass
 	{
+		friend struct GBufferPassTestAccess;
+		enum GBufferPermutation : Uint32
+		{
+			GBufferPermutation_Rain = 0x1,
+			GBufferPermutation_ViewMipMaps = 0x2,
+			GBufferPermutation_TriangleOverdraw = 0x4,
+			GBufferPermutation_MaterialID = 0x8,
+			GBufferPermutation_Count = 0x10
+		};
+
 	public:
 		GBufferPass(entt::registry& reg, GfxDevice* gfx, Uint32 w, Uint32 h);
 		~GBufferPass();
@@ -38,10 +49,12 @@ namespace adria
 		Bool material_ids = false;
 		Bool skip_alpha_blended = false;
 		std::unique_ptr<GfxGraphicsPipelineStatePermutations> gbuffer_psos;
+		//resolved psos indexed by pass permutation and batch material permutation, filled on first use
+		std::array<GfxPipelineState const*, GBufferPermutation_Count * MaterialPermutationCount> gbuffer_pso_cache{};
+		Uint64 gbuffer_pso_cache_generation = 0;
 
 	private:
 		void CreatePSOs();
-		template<typename View>
-		void ProcessBatches(View view, GfxCommandList* cmd_list);
+		void ProcessBatches(std::span<Batch const* const> draws, GfxCommandList* cmd_list);
 	};
 }
\ No newline at end of file
@@ -1,4 +1,4 @@
-#include "GpuDebugFeature.h"
+#include "GPUDebugFeature.h"
 #include "Graphics/GfxBufferView.h"
 #include "Graphics/GfxDevice.h"
 #include "Graphics/GfxCommandList.h"
@@ -2,12 +2,18 @@
 #include "Graphics/GfxBuffer.h"
 #include "Graphics/GfxDevice.h"
 #include "Graphics/GfxCommandList.h"
+#include "Graphics/GfxFence.h"
+#include "Utilities/MemoryTracker.h"
 
 namespace adria
 {
+	GeometryBufferCache::GeometryBufferCache() = default;
+	GeometryBufferCache::~GeometryBufferCache() = default;
+
 	void GeometryBufferCache::Initialize(GfxDevice* _gfx)
 	{
 		gfx = _gfx;
+		upload_fence = gfx->CreateFence("Geometry Upload Fence");
 	}
 
     void GeometryBufferCache::OnSceneInitialized()
@@ -20,27 +26,69 @@ namespace adria
 
     void GeometryBufferCache::Shutdown()
 	{
+		if (upload_fence)
+		{
+			upload_fence->Wait(upload_fence_value);
+			ReleaseCompletedUploads();
+		}
+		upload_fence.reset();
 		buffer_map.clear();
 		gfx = nullptr;
 	}
 
-	ArcGeometryBufferHandle GeometryBufferCache::CreateAndInitializeGeometryBuffer(GfxBuffer* staging_buffer, Uint64 total_buffer_size, Uint64 src_offset)
+	ArcGeometryBufferHandle GeometryBufferCache::CreateAndInitializeGeometryBuffer(std::span<Uint8 const> geometry)
 	{
+		ReleaseCompletedUploads();
+
 		GfxBufferDesc desc{};
-		desc.size = total_buffer_size;
+		desc.size = geometry.size();
 		desc.bind_flags = GfxBindFlag::ShaderResource;
 		desc.misc_flags = GfxBufferMiscFlag::BufferRaw;
 		desc.resource_usage = GfxResourceUsage::Default;
 
 		++current_handle;
-		buffer_map[current_handle] = gfx->CreateBuffer(desc);
-		if(staging_buffer) 
+		GfxBuffer* geometry_buffer = buffer_map.emplace(current_handle, gfx->CreateBuffer(desc)).first->second.get();
+		if (geometry.empty())
 		{
-			gfx->GetGraphicsCommandList()->CopyBuffer(*buffer_map[current_handle], 0, *staging_buffer, src_offset, total_buffer_size);
+			return current_handle;
 		}
+
+		//the cooked geometry is copied once into its own upload buffer, nothing else shares it so it can be freed as soon as the copy is done
+		GfxBufferDesc staging_desc{};
+		staging_desc.size = geometry.size();
+		staging_desc.resource_usage = GfxResourceUsage::Upload;
+
+		PendingUpload& upload = pending_uploads.emplace();
+		upload.staging_buffer = gfx->CreateBuffer(staging_desc, geometry.data());
+		upload.cmd_list = gfx->CreateCommandList(GfxCommandListType::Copy);
+		upload.fence_value = ++upload_fence_value;
+		MemoryTracker::Allocate(MemoryCategory::GeometryStaging, staging_desc.size);
+
+		upload.cmd_list->Begin();
+		upload.cmd_list->CopyBuffer(*geometry_buffer, 0, *upload.staging_buffer, 0, geometry.size());
+		upload.cmd_list->End();
+		upload.cmd_list->Signal(*upload_fence, upload.fence_value);
+		upload.cmd_list->Submit();
 		return current_handle;
 	}
 
+	void GeometryBufferCache::WaitForUploads(GfxCommandList* cmd_list)
+	{
+		if (upload_fence_value > 0)
+		{
+			cmd_list->Wait(*upload_fence, upload_fence_value);
+		}
+	}
+
+	void GeometryBufferCache::ReleaseCompletedUploads()
+	{
+		while (!pending_uploads.empty() && upload_fence->IsCompleted(pending_uploads.front().fence_value))
+		{
+			MemoryTracker::Free(MemoryCategory::GeometryStaging, pending_uploads.front().staging_buffer->GetSize());
+			pending_uploads.pop();
+		}
+	}
+
 	void GeometryBufferCache::DestroyGeometryBuffer(GeometryBufferHandle& handle)
 	{
 		if (buffer_map.empty())
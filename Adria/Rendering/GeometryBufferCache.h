@@ -6,6 +6,8 @@ namespace adria
 {
 	class GfxDevice;
 	class GfxBuffer;
+	class GfxCommandList;
+	class GfxFence;
 
 	inline constexpr Uint64 INVALID_GEOMETRY_BUFFER_HANDLE = -1;
 
@@ -51,16 +53,35 @@ namespace adria
 		void OnSceneInitialized();
 		void Shutdown();
 
-		ADRIA_NODISCARD ArcGeometryBufferHandle CreateAndInitializeGeometryBuffer(GfxBuffer* staging_buffer, Uint64 total_buffer_size, Uint64 src_offset);
+		//the geometry is uploaded on the copy queue, its staging buffer is released once the upload fence passes it
+		ADRIA_NODISCARD ArcGeometryBufferHandle CreateAndInitializeGeometryBuffer(std::span<Uint8 const> geometry);
 		ADRIA_NODISCARD GfxBuffer* GetGeometryBuffer(GeometryBufferHandle& handle) const;
 		ADRIA_NODISCARD GfxDescriptor GetGeometryBufferSRV(GeometryBufferHandle& handle) const;
 		void DestroyGeometryBuffer(GeometryBufferHandle& handle);
 
+		//makes cmd_list wait on the GPU for every upload submitted so far
+		void WaitForUploads(GfxCommandList* cmd_list);
+		void ReleaseCompletedUploads();
+
 	private:
+		GeometryBufferCache();
+		~GeometryBufferCache();
+
+		struct PendingUpload
+		{
+			std::unique_ptr<GfxCommandList> cmd_list;
+			std::unique_ptr<GfxBuffer> staging_buffer;
+			Uint64 fence_value;
+		};
+
 		GfxDevice* gfx;
 		Uint64 current_handle = INVALID_GEOMETRY_BUFFER_HANDLE;
 		std::unordered_map<Uint64, std::unique_ptr<GfxBuffer>> buffer_map;
 		std::unordered_map<Uint64, GfxDescriptor> buffer_srv_map;
+
+		std::unique_ptr<GfxFence> upload_fence;
+		Uint64 upload_fence_value = 0;
+		std::queue<PendingUpload> pending_uploads;
 	};
 	#define g_GeometryBufferCache GeometryBufferCache::Get()
 }
\ No newline at end of file
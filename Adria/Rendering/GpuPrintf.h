@@ -1,5 +1,5 @@
 #pragma once
-#include "GpuDebugFeature.h"
+#include "GPUDebugFeature.h"
 
 namespace adria
 {
@@ -0,0 +1,314 @@
+#include <cinttypes>
+#include "ModelCache.h"
+#include "SceneLoader.h"
+#include "Core/Paths.h"
+#include "Utilities/PathHelpers.h"
+#include "Utilities/Hash.h"
+#include "Utilities/Align.h"
+
+namespace fs = std::filesystem;
+
+namespace adria
+{
+	ADRIA_LOG_CHANNEL(Scene);
+
+	static constexpr Uint64 CookedModelMagic = 0x4c444f4d41495244; //"DRIAMODL"
+	static constexpr Uint64 CookedModelVersion = 2;
+	static constexpr Uint64 CookedModelAlignment = 16;
+
+	static_assert(std::is_trivially_copyable_v<SubMeshGPU>);
+	static_assert(std::is_trivially_copyable_v<CookedMaterial>);
+	static_assert(std::is_trivially_copyable_v<CookedInstance>);
+	static_assert(std::is_trivially_copyable_v<CookedLight>);
+
+	namespace
+	{
+		//layout changes of the stored structs have to invalidate old cache files
+		Uint64 GetCookedModelVersion()
+		{
+			HashState state;
+			state.Combine(CookedModelVersion);
+			state.Combine(sizeof(SubMeshGPU));
+			state.Combine(sizeof(CookedMaterial));
+			state.Combine(sizeof(CookedInstance));
+			state.Combine(sizeof(CookedLight));
+			state.Combine(sizeof(CookedDependency));
+			return state;
+		}
+
+		Bool GetDependencyStamp(Char const* path, Uint64& size, Int64& last_write_time)
+		{
+			std::error_code ec;
+			size = fs::file_size(path, ec);
+			if (ec)
+			{
+				return false;
+			}
+			last_write_time = GetFileLastWriteTime(path);
+			return true;
+		}
+
+		Bool WriteCookedModel(std::string const& cache_path, std::span<Uint8 const> blob)
+		{
+			std::error_code ec;
+			fs::create_directories(fs::path(cache_path).parent_path(), ec);
+
+			//write to a temporary file first so a crash never leaves a truncated cache file behind
+			std::string const temporary_path = cache_path + ".tmp";
+			FILE* cache_file = fopen(temporary_path.c_str(), "wb");
+			if (!cache_file)
+			{
+				ADRIA_LOG(WARNING, "Failed to create model cache file '%s'", temporary_path.c_str());
+				return false;
+			}
+			Bool const written = fwrite(blob.data(), 1, blob.size(), cache_file) == blob.size();
+			fclose(cache_file);
+			if (!written)
+			{
+				fs::remove(temporary_path, ec);
+				return false;
+			}
+			fs::rename(temporary_path, cache_path, ec);
+			return !ec;
+		}
+	}
+
+	TextureHandle Material::* GetMaterialTextureMember(MaterialTextureSlot slot)
+	{
+		static constexpr TextureHandle Material::* Members[] =
+		{
+			&Material::albedo_texture,
+			&Material::metallic_roughness_texture,
+			&Material::normal_texture,
+			&Material::emissive_texture,
+			&Material::anisotropy_texture,
+			&Material::clear_coat_texture,
+			&Material::clear_coat_roughness_texture,
+			&Material::clear_coat_normal_texture,
+			&Material::sheen_color_texture,
+			&Material::sheen_roughness_texture
+		};
+		static_assert(std::size(Members) == MaterialTextureSlot_Count);
+		return Members[slot];
+	}
+
+	GfxFormat GetMaterialTextureCompressedFormat(MaterialTextureSlot slot, MaterialAlphaMode alpha_mode)
+	{
+		switch (slot)
+		{
+		case MaterialTextureSlot_Albedo:
+			return alpha_mode == MaterialAlphaMode::Opaque ? GfxFormat::BC1_UNORM : GfxFormat::BC7_UNORM;
+		case MaterialTextureSlot_Emissive:
+		case MaterialTextureSlot_SheenColor:
+			return GfxFormat::BC1_UNORM;
+		case MaterialTextureSlot_Normal:
+		case MaterialTextureSlot_ClearCoatNormal:
+		case MaterialTextureSlot_ClearCoatRoughness:
+			return GfxFormat::BC5_UNORM;
+		case MaterialTextureSlot_ClearCoat:
+		case MaterialTextureSlot_SheenRoughness:
+			return GfxFormat::BC4_UNORM;
+		case MaterialTextureSlot_MetallicRoughness:
+		case MaterialTextureSlot_Anisotropy:
+		default:
+			return GfxFormat::BC7_UNORM;
+		}
+	}
+
+	Bool CookedModel::Open(std::string const& cache_path, Uint64 options_hash)
+	{
+		memory.clear();
+		if (!file.Open(cache_path.c_str()))
+		{
+			return false;
+		}
+		data = file.GetData();
+		size = file.GetSize();
+		if (!Validate(options_hash))
+		{
+			Close();
+			return false;
+		}
+		return true;
+	}
+
+	void CookedModel::Adopt(CookedModelBlob&& blob)
+	{
+		file.Close();
+		memory = std::move(blob);
+		data = memory.data();
+		size = memory.size();
+	}
+
+	Bool CookedModel::Save(std::string const& cache_path, CookedModelBlob&& blob)
+	{
+		//the mapping may be of the file the rename replaces
+		Close();
+		Bool const saved = WriteCookedModel(cache_path, blob);
+		Adopt(std::move(blob));
+		return saved;
+	}
+
+	void CookedModel::Close()
+	{
+		file.Close();
+		memory.clear();
+		data = nullptr;
+		size = 0;
+	}
+
+	Bool CookedModel::Validate(Uint64 options_hash) const
+	{
+		if (size < sizeof(CookedModelHeader))
+		{
+			return false;
+		}
+		CookedModelHeader const& header = GetHeader();
+		if (header.magic != CookedModelMagic || header.version != GetCookedModelVersion() || header.options_hash != options_hash)
+		{
+			return false;
+		}
+
+		auto SectionFits = [this](CookedModelSection const& section, Uint64 element_size)
+			{
+				return section.offset <= size && section.count <= (size - section.offset) / element_size;
+			};
+		if (!SectionFits(header.geometry, 1) || !SectionFits(header.submeshes, sizeof(SubMeshGPU)) ||
+			!SectionFits(header.materials, sizeof(CookedMaterial)) || !SectionFits(header.instances, sizeof(CookedInstance)) ||
+			!SectionFits(header.lights, sizeof(CookedLight)) || !SectionFits(header.dependencies, sizeof(CookedDependency)) ||
+			!SectionFits(header.strings, 1))
+		{
+			return false;
+		}
+		if (header.strings.count > 0 && data[header.strings.offset + header.strings.count - 1] != '\0')
+		{
+			return false;
+		}
+
+		HashState source_hash;
+		for (CookedDependency const& dependency : GetSection<CookedDependency>(header.dependencies))
+		{
+			if (dependency.path >= header.strings.count)
+			{
+				return false;
+			}
+			Uint64 dependency_size = 0;
+			Int64 last_write_time = 0;
+			if (!GetDependencyStamp(GetString(dependency.path), dependency_size, last_write_time) ||
+				dependency_size != dependency.size || last_write_time != dependency.last_write_time)
+			{
+				return false;
+			}
+			source_hash.Combine(dependency_size);
+			source_hash.Combine(last_write_time);
+		}
+		return source_hash == header.source_hash;
+	}
+
+	Uint32 CookedModelBuilder::AddString(std::string_view str)
+	{
+		Uint32 const offset = (Uint32)strings.size();
+		strings.insert(strings.end(), str.begin(), str.end());
+		strings.push_back('\0');
+		return offset;
+	}
+
+	void CookedModelBuilder::AddDependency(std::string const& path)
+	{
+		CookedDependency& dependency = dependencies.emplace_back();
+		dependency.size = 0;
+		dependency.last_write_time = 0;
+		if (!GetDependencyStamp(path.c_str(), dependency.size, dependency.last_write_time))
+		{
+			ADRIA_LOG(WARNING, "Model dependency '%s' not found", path.c_str());
+		}
+		dependency.path = AddString(path);
+	}
+
+	std::span<Uint8> CookedModelBuilder::AllocateGeometry(Uint64 _geometry_size)
+	{
+		ADRIA_ASSERT(blob.empty());
+		geometry_size = _geometry_size;
+		CookedModelHeader header{};
+		blob.resize(ReserveSections(header));
+		return std::span<Uint8>(blob.data() + header.geometry.offset, geometry_size);
+	}
+
+	CookedModelBlob CookedModelBuilder::Build(Uint64 options_hash)
+	{
+		CookedModelHeader header{};
+		header.magic = CookedModelMagic;
+		header.version = GetCookedModelVersion();
+		header.options_hash = options_hash;
+
+		HashState source_hash;
+		for (CookedDependency const& dependency : dependencies)
+		{
+			source_hash.Combine(dependency.size);
+			source_hash.Combine(dependency.last_write_time);
+		}
+		header.source_hash = source_hash;
+
+		Uint64 const blob_size = ReserveSections(header);
+		if (blob.empty())
+		{
+			blob.resize(blob_size);
+		}
+		ADRIA_ASSERT_MSG(blob.size() == blob_size, "Cooked model tables changed after the geometry was allocated");
+
+		memcpy(blob.data(), &header, sizeof(header));
+		auto WriteSection = [this]<typename T>(CookedModelSection const& section, std::vector<T> const& elements)
+			{
+				if (!elements.empty())
+				{
+					memcpy(blob.data() + section.offset, elements.data(), elements.size() * sizeof(T));
+				}
+			};
+		WriteSection(header.submeshes, submeshes);
+		WriteSection(header.materials, materials);
+		WriteSection(header.instances, instances);
+		WriteSection(header.lights, lights);
+		WriteSection(header.dependencies, dependencies);
+		WriteSection(header.strings, strings);
+		geometry_size = 0;
+		return std::move(blob);
+	}
+
+	Uint64 CookedModelBuilder::ReserveSections(CookedModelHeader& header) const
+	{
+		Uint64 blob_size = AlignUp(sizeof(CookedModelHeader), CookedModelAlignment);
+		auto ReserveSection = [&blob_size](CookedModelSection& section, Uint64 count, Uint64 element_size)
+			{
+				section.offset = blob_size;
+				section.count = count;
+				blob_size = AlignUp(blob_size + count * element_size, CookedModelAlignment);
+			};
+		ReserveSection(header.geometry, geometry_size, 1);
+		ReserveSection(header.submeshes, submeshes.size(), sizeof(SubMeshGPU));
+		ReserveSection(header.materials, materials.size(), sizeof(CookedMaterial));
+		ReserveSection(header.instances, instances.size(), sizeof(CookedInstance));
+		ReserveSection(header.lights, lights.size(), sizeof(CookedLight));
+		ReserveSection(header.dependencies, dependencies.size(), sizeof(CookedDependency));
+		ReserveSection(header.strings, strings.size(), sizeof(Char));
+		return blob_size;
+	}
+
+	Uint64 GetModelCookOptionsHash(ModelParameters const& params, Bool build_meshlets)
+	{
+		HashState state;
+		state.Combine(crc64(params.model_path.c_str(), params.model_path.size()));
+		state.Combine(crc64(params.textures_path.c_str(), params.textures_path.size()));
+		state.Combine((Uint64)params.triangle_ccw);
+		state.Combine((Uint64)params.force_mask_alpha_usage);
+		state.Combine((Uint64)params.compact_geometry);
+		state.Combine((Uint64)build_meshlets);
+		return state;
+	}
+
+	std::string GetModelCachePath(ModelParameters const& params, Uint64 options_hash)
+	{
+		Char cache_path[512];
+		snprintf(cache_path, sizeof(cache_path), "%s%s_%" PRIx64 ".admodel", paths::ModelCacheDir.c_str(), GetFilenameWithoutExtension(params.model_path).c_str(), options_hash);
+		return cache_path;
+	}
+}
@@ -0,0 +1,149 @@
+#pragma once
+#include "Components.h"
+#include "Utilities/MemoryMappedFile.h"
+#include "Utilities/MemoryTracker.h"
+
+namespace adria
+{
+	struct ModelParameters;
+
+	enum MaterialTextureSlot : Uint32
+	{
+		MaterialTextureSlot_Albedo,
+		MaterialTextureSlot_MetallicRoughness,
+		MaterialTextureSlot_Normal,
+		MaterialTextureSlot_Emissive,
+		MaterialTextureSlot_Anisotropy,
+		MaterialTextureSlot_ClearCoat,
+		MaterialTextureSlot_ClearCoatRoughness,
+		MaterialTextureSlot_ClearCoatNormal,
+		MaterialTextureSlot_SheenColor,
+		MaterialTextureSlot_SheenRoughness,
+		MaterialTextureSlot_Count
+	};
+	TextureHandle Material::* GetMaterialTextureMember(MaterialTextureSlot slot);
+	//block compression format of a streamed slot texture, chosen by the channels the material shaders sample
+	GfxFormat GetMaterialTextureCompressedFormat(MaterialTextureSlot slot, MaterialAlphaMode alpha_mode);
+
+	inline constexpr Uint32 CookedModelInvalidString = Uint32(-1);
+	using CookedModelBlob = TrackedVector<Uint8, MemoryCategory::ModelImport>;
+
+	//material with its texture handles left at their defaults, textures are referenced by path and loaded when the model is created
+	struct CookedMaterial
+	{
+		Material material;
+		Uint32 texture_paths[MaterialTextureSlot_Count];
+		Uint32 srgb_mask;
+	};
+	struct CookedInstance
+	{
+		Matrix local_to_world;
+		Uint32 submesh_index;
+	};
+	//light in model space, the model matrix is applied when the model is created
+	struct CookedLight
+	{
+		Light light_data;
+	};
+	struct CookedDependency
+	{
+		Uint64 path;
+		Uint64 size;
+		Int64  last_write_time;
+	};
+
+	struct CookedModelSection
+	{
+		Uint64 offset;
+		Uint64 count;
+	};
+	struct CookedModelHeader
+	{
+		Uint64 magic;
+		Uint64 version;
+		Uint64 source_hash;
+		Uint64 options_hash;
+		CookedModelSection geometry;
+		CookedModelSection submeshes;
+		CookedModelSection materials;
+		CookedModelSection instances;
+		CookedModelSection lights;
+		CookedModelSection dependencies;
+		CookedModelSection strings;
+	};
+
+	//cooked model is a single blob: header, the geometry buffer exactly as it is uploaded, then the tables referencing it.
+	//It is either memory mapped from the model cache or owned after a fresh import
+	class CookedModel
+	{
+	public:
+		CookedModel() = default;
+		ADRIA_NONCOPYABLE_NONMOVABLE(CookedModel)
+
+		Bool Open(std::string const& cache_path, Uint64 options_hash);
+		void Adopt(CookedModelBlob&& blob);
+		//writes the blob to the cache and owns it afterwards, a previously opened cache file is unmapped before it is replaced
+		Bool Save(std::string const& cache_path, CookedModelBlob&& blob);
+		void Close();
+
+		std::span<Uint8 const> GetGeometry() const { return GetSection<Uint8>(GetHeader().geometry); }
+		std::span<SubMeshGPU const> GetSubMeshes() const { return GetSection<SubMeshGPU>(GetHeader().submeshes); }
+		std::span<CookedMaterial const> GetMaterials() const { return GetSection<CookedMaterial>(GetHeader().materials); }
+		std::span<CookedInstance const> GetInstances() const { return GetSection<CookedInstance>(GetHeader().instances); }
+		std::span<CookedLight const> GetLights() const { return GetSection<CookedLight>(GetHeader().lights); }
+		Char const* GetString(Uint64 offset) const
+		{
+			return reinterpret_cast<Char const*>(data + GetHeader().strings.offset + offset);
+		}
+
+	private:
+		MemoryMappedFile file;
+		CookedModelBlob memory;
+		Uint8 const* data = nullptr;
+		Uint64 size = 0;
+
+	private:
+		CookedModelHeader const& GetHeader() const
+		{
+			return *reinterpret_cast<CookedModelHeader const*>(data);
+		}
+		template<typename T>
+		std::span<T const> GetSection(CookedModelSection const& section) const
+		{
+			return std::span<T const>(reinterpret_cast<T const*>(data + section.offset), section.count);
+		}
+		Bool Validate(Uint64 options_hash) const;
+	};
+
+	class CookedModelBuilder
+	{
+	public:
+		Uint32 AddString(std::string_view str);
+		void AddDependency(std::string const& path);
+
+		std::vector<SubMeshGPU>& GetSubMeshes() { return submeshes; }
+		std::vector<CookedMaterial>& GetMaterials() { return materials; }
+		std::vector<CookedInstance>& GetInstances() { return instances; }
+		std::vector<CookedLight>& GetLights() { return lights; }
+
+		//sizes the blob once the tables are filled, the geometry is written in place into the returned span
+		std::span<Uint8> AllocateGeometry(Uint64 geometry_size);
+		CookedModelBlob Build(Uint64 options_hash);
+
+	private:
+		CookedModelBlob blob;
+		Uint64 geometry_size = 0;
+		std::vector<SubMeshGPU> submeshes;
+		std::vector<CookedMaterial> materials;
+		std::vector<CookedInstance> instances;
+		std::vector<CookedLight> lights;
+		std::vector<CookedDependency> dependencies;
+		std::vector<Char> strings;
+
+	private:
+		Uint64 ReserveSections(CookedModelHeader& header) const;
+	};
+
+	Uint64 GetModelCookOptionsHash(ModelParameters const& params, Bool build_meshlets);
+	std::string GetModelCachePath(ModelParameters const& params, Uint64 options_hash);
+}
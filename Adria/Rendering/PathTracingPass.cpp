@@ -198,6 +198,7 @@ namespace adria
 	void PathTracingPass::AddPTGBufferPass(RenderGraph& rg)
 	{
 		FrameBlackboardData const& frame_data = rg.GetBlackboard().Get<FrameBlackboardData>();
+		CameraDrawsBlackboardData const& draws_data = rg.GetBlackboard().Get<CameraDrawsBlackboardData>();
 		rg.AddPass<void>("Path Tracing GBuffer Pass",
 			[=, this](RenderGraphBuilder& builder)
 			{
@@ -233,33 +234,11 @@ namespace adria
 				GfxDevice* gfx = context.GetDevice();
 				GfxCommandList* cmd_list = context.GetCommandList();
 
-				reg.sort<Batch>([&frame_data](Batch const& lhs, Batch const& rhs)
-					{
-						if (lhs.alpha_mode != rhs.alpha_mode)
-						{
-							return lhs.alpha_mode < rhs.alpha_mode;
-						}
-						if (lhs.shading_extension != rhs.shading_extension)
-						{
-							return lhs.shading_extension < rhs.shading_extension;
-						}
-						Vector3 camera_position(frame_data.camera_position);
-						Float lhs_distance = Vector3::DistanceSquared(camera_position, lhs.bounding_box.Center);
-						Float rhs_distance = Vector3::DistanceSquared(camera_position, rhs.bounding_box.Center);
-						return lhs_distance < rhs_distance;
-					});
-
 				cmd_list->SetRootCBV(0, frame_data.frame_cbuffer_address);
 
-				auto view = reg.view<Batch>();
-				for (entt::entity batch_entity : view)
+				for (Uint64 i = 0; i < draws_data.draw_count; ++i)
 				{
-					Batch& batch = view.get<Batch>(batch_entity);
-					if (!batch.camera_visibility)
-					{
-						continue;
-					}
-
+					Batch const& batch = *draws_data.draws[i];
 					GfxPipelineState const* pso = pt_gbuffer_pso->Get();
 					cmd_list->SetPipelineState(pso);
 
@@ -269,7 +248,7 @@ namespace adria
 					} constants{ .instance_id = batch.instance_id };
 					cmd_list->SetRootConstants(1, constants);
 
-					GfxIndexBufferView ibv(batch.submesh->buffer_address + batch.submesh->indices_offset, batch.submesh->indices_count);
+					GfxIndexBufferView ibv(batch.submesh->buffer_address + batch.submesh->indices_offset, batch.submesh->indices_count, batch.submesh->GetIndexFormat());
 					cmd_list->SetPrimitiveTopology(batch.submesh->topology);
 					cmd_list->SetIndexBuffer(&ibv);
 					cmd_list->DrawIndexed(batch.submesh->indices_count);
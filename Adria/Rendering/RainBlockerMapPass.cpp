@@ -87,7 +87,7 @@ namespace adria
 					} constants{ .instance_id = batch.instance_id };
 					cmd_list->SetRootConstants(1, constants);
 
-					GfxIndexBufferView ibv(batch.submesh->buffer_address + batch.submesh->indices_offset, batch.submesh->indices_count);
+					GfxIndexBufferView ibv(batch.submesh->buffer_address + batch.submesh->indices_offset, batch.submesh->indices_count, batch.submesh->GetIndexFormat());
 					cmd_list->SetPrimitiveTopology(batch.submesh->topology);
 					cmd_list->SetIndexBuffer(&ibv);
 					cmd_list->DrawIndexed(batch.submesh->indices_count);
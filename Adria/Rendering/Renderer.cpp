@@ -16,6 +16,8 @@
 #include "Graphics/GfxProfiler.h"
 #include "RenderGraph/RenderGraph.h"
 #include "Utilities/ThreadPool.h"
+#include "Utilities/Align.h"
+#include "Utilities/Timer.h"
 #include "Utilities/Random.h"
 #include "Utilities/ImageWrite.h"
 #include "Math/Constants.h"
@@ -31,8 +33,25 @@ namespace adria
 	ADRIA_LOG_CHANNEL(Renderer);
 
 	static TAutoConsoleVariable<Int>  LightingPathType("r.LightingPath", 0, "0 - Deferred, 1 - Tiled Deferred, 2 - Clustered Deferred, 3 - Path Tracing");
+	static TAutoConsoleVariable<Int>  CameraCullingChunkSize("r.CameraCullingChunkSize", 8192, "Number of instances culled by one thread pool task, rounded up to a multiple of 64");
 
-	Renderer::Renderer(entt::registry& reg, GfxDevice* gfx, Uint32 width, Uint32 height) : reg(reg), gfx(gfx), resource_pool(gfx),
+	static void MarkSceneBufferDirty(std::vector<std::pair<Uint64, Uint64>>& dirty_ranges, Uint64 begin, Uint64 count)
+	{
+		if (count == 0)
+		{
+			return;
+		}
+		if (!dirty_ranges.empty() && dirty_ranges.back().second == begin)
+		{
+			dirty_ranges.back().second = begin + count;
+		}
+		else
+		{
+			dirty_ranges.emplace_back(begin, begin + count);
+		}
+	}
+
+	Renderer::Renderer(entt::registry& reg, GfxDevice* gfx, Uint32 width, Uint32 height) : reg(reg), gfx(gfx), resource_pool(gfx), render_graph_allocator(RenderGraph::DefaultAllocatorSize),
 		accel_structure(gfx), camera(nullptr), display_width(width), display_height(height), render_width(width), render_height(height),
 		backbuffer_count(gfx->GetBackbufferCount()), backbuffer_index(gfx->GetBackbufferIndex()), final_texture(nullptr),
 		frame_cbuffer(gfx, backbuffer_count), gpu_driven_renderer(reg, gfx, width, height),
@@ -86,18 +105,31 @@ namespace adria
 	}
 	void Renderer::Update(Float dt)
 	{
+		//streamed textures that became resident replace their placeholders, materials have to resolve their bindless indices again
+		scene_materials_dirty |= g_TextureManager.Update();
+		g_GeometryBufferCache.ReleaseCompletedUploads();
 		shadow_renderer.SetupShadows(camera);
+		Timer timer;
 		UpdateSceneBuffers();
+		cpu_timings.scene_buffers_update = timer.Mark() / 1000.0f;
 		UpdateFrameConstants(dt);
+		timer.Mark();
 		CameraFrustumCulling();
+		SortCameraDraws();
+		shadow_renderer.CullShadowCasters();
+		cpu_timings.culling = timer.Mark() / 1000.0f;
 	}
 	void Renderer::Render()
 	{
 		ZoneScopedN("Renderer::Render");
-		RenderGraph render_graph(resource_pool);
+		Timer timer;
+		RenderGraph render_graph(resource_pool, &render_graph_cache, &render_graph_allocator);
 		RenderImpl(render_graph);
+		cpu_timings.render_graph_build = timer.Mark() / 1000.0f;
 		render_graph.Compile();
+		cpu_timings.render_graph_compile = timer.Mark() / 1000.0f;
 		render_graph.Execute();
+		cpu_timings.pass_recording = timer.Mark() / 1000.0f;
 		g_Editor.EndFrame();
 	}
 
@@ -153,6 +185,7 @@ namespace adria
 		CreateAS();
 
 		g_TextureManager.OnSceneInitialized();
+		scene_buffers_rebuild = true;
 		g_GeometryBufferCache.OnSceneInitialized();
 	}
 
@@ -252,10 +285,44 @@ namespace adria
 
 	void Renderer::UpdateSceneBuffers()
 	{
-		for (entt::entity e : reg.view<Batch>()) reg.destroy(e);
-		reg.clear<Batch>();
+		ZoneScopedN("Renderer::UpdateSceneBuffers");
+		UpdateSceneLights();
+		UpdateSceneMeshes();
 
+		scene_buffers_upload_size = 0;
+		auto CopyBuffer = [&]<typename T>(std::vector<T> const& data, SceneBuffer& scene_buffer)
+		{
+			if (data.empty())
+			{
+				scene_buffer.dirty_ranges.clear();
+				return;
+			}
+			if (!scene_buffer.buffer || scene_buffer.buffer->GetCount() < data.size())
+			{
+				Uint64 const count = std::max<Uint64>(data.size(), scene_buffer.buffer ? scene_buffer.buffer->GetCount() * 3 / 2 : 0);
+				scene_buffer.buffer = gfx->CreateBuffer(StructuredBufferDesc<T>(count, false, true));
+				scene_buffer.buffer_srv = gfx->CreateBufferSRV(scene_buffer.buffer.get());
+				scene_buffer.dirty_ranges.assign(1, { 0, data.size() });
+			}
+			for (auto const& [begin, end] : scene_buffer.dirty_ranges)
+			{
+				scene_buffer.buffer->Update(data.data() + begin, (end - begin) * sizeof(T), begin * sizeof(T));
+				scene_buffers_upload_size += (end - begin) * sizeof(T);
+			}
+			scene_buffer.dirty_ranges.clear();
+			scene_buffer.buffer_srv_gpu_index = gfx->GetBindlessDescriptorIndex(scene_buffer.buffer_srv);
+		};
+		CopyBuffer(scene_lights, scene_buffers[SceneBuffer_Light]);
+		CopyBuffer(scene_meshes, scene_buffers[SceneBuffer_Mesh]);
+		CopyBuffer(scene_instances, scene_buffers[SceneBuffer_Instance]);
+		CopyBuffer(scene_materials, scene_buffers[SceneBuffer_Material]);
+		TracyPlot("Scene Buffers Upload Size", (Int64)scene_buffers_upload_size);
+	}
+
+	void Renderer::UpdateSceneLights()
+	{
 		std::vector<LightGPU> hlsl_lights{};
+		hlsl_lights.reserve(scene_lights.size());
 		Uint32 light_index = 0;
 		Matrix light_transform = lighting_path == LightingPath::PathTracing ? Matrix::Identity : camera->View();
 		for (entt::entity light_entity : reg.view<Light>())
@@ -281,115 +348,209 @@ namespace adria
 			hlsl_light.use_cascades = light.use_cascades;
 		}
 
-		std::vector<MeshGPU> meshes;
-		std::vector<InstanceGPU> instances;
-		std::vector<MaterialGPU> materials;
-		Uint32 instanceID = 0;
-
-		for (entt::entity mesh_entity : reg.view<Mesh>())
+		//lights are written by the editor, the shadow renderer and follow the camera, so they are compared with the uploaded data instead of tracked
+		std::vector<std::pair<Uint64, Uint64>>& dirty_ranges = scene_buffers[SceneBuffer_Light].dirty_ranges;
+		if (hlsl_lights.size() != scene_lights.size())
 		{
-			Mesh& mesh = reg.get<Mesh>(mesh_entity);
+			scene_lights = std::move(hlsl_lights);
+			dirty_ranges.assign(1, { 0, scene_lights.size() });
+			return;
+		}
+		for (Uint64 i = 0; i < hlsl_lights.size(); ++i)
+		{
+			if (memcmp(&hlsl_lights[i], &scene_lights[i], sizeof(LightGPU)) != 0)
+			{
+				scene_lights[i] = hlsl_lights[i];
+				if (!dirty_ranges.empty() && dirty_ranges.back().second == i)
+				{
+					dirty_ranges.back().second = i + 1;
+				}
+				else
+				{
+					dirty_ranges.emplace_back(i, i + 1);
+				}
+			}
+		}
+	}
 
-			GfxBuffer* mesh_buffer = g_GeometryBufferCache.GetGeometryBuffer(mesh.geometry_buffer_handle);
-			GfxDescriptor mesh_buffer_srv = g_GeometryBufferCache.GetGeometryBufferSRV(mesh.geometry_buffer_handle);
-			for (SubMeshInstance const& instance : mesh.instances)
+	void Renderer::UpdateSceneMeshes()
+	{
+		auto mesh_view = reg.view<Mesh>();
+		Bool rebuild = scene_buffers_rebuild;
+		for (auto const& [mesh_entity, slots] : scene_mesh_slots)
+		{
+			if (rebuild)
 			{
-				SubMeshGPU& submesh = mesh.submeshes[instance.submesh_index];
-				Material& material = mesh.materials[submesh.material_index];
+				break;
+			}
+			Mesh const* mesh = reg.valid(mesh_entity) ? reg.try_get<Mesh>(mesh_entity) : nullptr;
+			rebuild = !mesh || (mesh->dirty && (mesh->instances.size() != slots.instance_count || mesh->submeshes.size() != slots.mesh_count || mesh->materials.size() != slots.material_count));
+		}
 
-				submesh.buffer_address = mesh_buffer->GetGpuAddress();
+		//removed meshes and meshes that changed their instance, submesh or material count reassign all slots so instance ids stay dense
+		if (rebuild)
+		{
+			for (auto const& [mesh_entity, slots] : scene_mesh_slots)
+			{
+				for (entt::entity batch_entity : slots.batch_entities)
+				{
+					reg.destroy(batch_entity);
+				}
+			}
+			scene_mesh_slots.clear();
+			scene_meshes.clear();
+			scene_instances.clear();
+			scene_instance_batches.clear();
+			scene_materials.clear();
+			scene_instance_bounds.Clear();
+			scene_buffers[SceneBuffer_Mesh].dirty_ranges.clear();
+			scene_buffers[SceneBuffer_Instance].dirty_ranges.clear();
+			scene_buffers[SceneBuffer_Material].dirty_ranges.clear();
+			scene_buffers_rebuild = false;
+		}
 
-				entt::entity batch_entity = reg.create();
-				if (material.alpha_mode == MaterialAlphaMode::Blend)
+		for (entt::entity mesh_entity : mesh_view)
+		{
+			Mesh& mesh = mesh_view.get<Mesh>(mesh_entity);
+			auto slots_it = scene_mesh_slots.find(mesh_entity);
+			if (slots_it == scene_mesh_slots.end())
+			{
+				SceneMeshSlots slots{};
+				slots.instance_offset = (Uint32)scene_instances.size();
+				slots.instance_count = (Uint32)mesh.instances.size();
+				slots.mesh_offset = (Uint32)scene_meshes.size();
+				slots.mesh_count = (Uint32)mesh.submeshes.size();
+				slots.material_offset = (Uint32)scene_materials.size();
+				slots.material_count = (Uint32)mesh.materials.size();
+				slots.batch_entities.resize(mesh.instances.size());
+				for (entt::entity& batch_entity : slots.batch_entities)
 				{
-					reg.emplace<Transparent>(batch_entity);
+					batch_entity = reg.create();
+					reg.emplace<Batch>(batch_entity);
 				}
-				Batch& batch = reg.emplace<Batch>(batch_entity);
-				batch.instance_id = instanceID;
-				batch.alpha_mode = material.alpha_mode;
-				batch.shading_extension = material.shading_extension;
-				batch.submesh = &submesh;
-				batch.world_transform = instance.world_transform;
-				submesh.bounding_box.Transform(batch.bounding_box, batch.world_transform);
-				
-				InstanceGPU& instance_gpu = instances.emplace_back();
-				instance_gpu.instance_id = instanceID;
-				instance_gpu.material_idx = static_cast<Uint32>(materials.size() + submesh.material_index);
-				instance_gpu.mesh_index = static_cast<Uint32>(meshes.size() + instance.submesh_index);
-				instance_gpu.world_matrix = instance.world_transform;
-				instance_gpu.inverse_world_matrix = XMMatrixInverse(nullptr, instance.world_transform);
-				instance_gpu.bb_origin = submesh.bounding_box.Center;
-				instance_gpu.bb_extents = submesh.bounding_box.Extents;
-
-				++instanceID;
+				scene_instances.resize(scene_instances.size() + slots.instance_count);
+				scene_instance_batches.insert(scene_instance_batches.end(), slots.batch_entities.begin(), slots.batch_entities.end());
+				scene_meshes.resize(scene_meshes.size() + slots.mesh_count);
+				scene_materials.resize(scene_materials.size() + slots.material_count);
+				scene_instance_bounds.Resize(scene_instances.size());
+				slots_it = scene_mesh_slots.emplace(mesh_entity, std::move(slots)).first;
+				mesh.dirty = true;
 			}
-			for (SubMeshGPU const& submesh : mesh.submeshes)
+			if (mesh.dirty)
 			{
-				MeshGPU& mesh_gpu = meshes.emplace_back();
-				mesh_gpu.buffer_idx = gfx->GetBindlessDescriptorIndex(mesh_buffer_srv);
-				mesh_gpu.indices_offset = submesh.indices_offset;
-				mesh_gpu.positions_offset = submesh.positions_offset;
-				mesh_gpu.normals_offset = submesh.normals_offset;
-				mesh_gpu.tangents_offset = submesh.tangents_offset;
-				mesh_gpu.uvs_offset = submesh.uvs_offset;
-
-				mesh_gpu.meshlet_offset = submesh.meshlet_offset;
-				mesh_gpu.meshlet_vertices_offset = submesh.meshlet_vertices_offset;
-				mesh_gpu.meshlet_triangles_offset = submesh.meshlet_triangles_offset;
-				mesh_gpu.meshlet_count = submesh.meshlet_count;
+				WriteSceneMesh(mesh, slots_it->second);
+				mesh.dirty = false;
 			}
-
-			for (Material const& material : mesh.materials)
+			else if (scene_materials_dirty)
 			{
-				MaterialGPU& material_gpu = materials.emplace_back();
-				material_gpu.shading_extension = (Uint32)material.shading_extension;
-				material_gpu.albedo_color = Vector3(material.albedo_color);
-				material_gpu.albedo_idx = g_TextureManager.GetBindlessIndex(material.albedo_texture);
-				material_gpu.roughness_metallic_idx = g_TextureManager.GetBindlessIndex(material.metallic_roughness_texture);
-				material_gpu.metallic_factor = material.metallic_factor;
-				material_gpu.roughness_factor = material.roughness_factor;
-
-				material_gpu.normal_idx = g_TextureManager.GetBindlessIndex(material.normal_texture);
-				material_gpu.emissive_idx = g_TextureManager.GetBindlessIndex(material.emissive_texture);
-				material_gpu.emissive_factor = material.emissive_factor;
-				material_gpu.alpha_cutoff = material.alpha_cutoff;
-				material_gpu.alpha_blended = material.alpha_mode == MaterialAlphaMode::Blend;
-
-				material_gpu.anisotropy_idx = g_TextureManager.GetBindlessIndex(material.anisotropy_texture);
-				material_gpu.anisotropy_strength = material.anisotropy_strength;
-				material_gpu.anisotropy_rotation = material.anisotropy_rotation;
-
-				material_gpu.clear_coat_idx = g_TextureManager.GetBindlessIndex(material.clear_coat_texture);
-				material_gpu.clear_coat_roughness_idx = g_TextureManager.GetBindlessIndex(material.clear_coat_roughness_texture);
-				material_gpu.clear_coat_normal_idx = g_TextureManager.GetBindlessIndex(material.clear_coat_normal_texture);
-				material_gpu.clear_coat = material.clear_coat;
-				material_gpu.clear_coat_roughness = material.clear_coat_roughness;
-
-				material_gpu.sheen_color = Vector3(material.sheen_color);
-				material_gpu.sheen_color_idx = g_TextureManager.GetBindlessIndex(material.sheen_color_texture);
-				material_gpu.sheen_roughness = material.sheen_roughness;
-				material_gpu.sheen_roughness_idx = g_TextureManager.GetBindlessIndex(material.sheen_roughness_texture);
+				WriteSceneMaterials(mesh, slots_it->second);
 			}
 		}
+		scene_materials_dirty = false;
+	}
 
-		auto CopyBuffer = [&]<typename T>(std::vector<T> const& data, SceneBuffer& scene_buffer)
+	void Renderer::WriteSceneMesh(Mesh& mesh, SceneMeshSlots const& slots)
+	{
+		GfxBuffer* mesh_buffer = g_GeometryBufferCache.GetGeometryBuffer(mesh.geometry_buffer_handle);
+		GfxDescriptor mesh_buffer_srv = g_GeometryBufferCache.GetGeometryBufferSRV(mesh.geometry_buffer_handle);
+		for (Uint32 i = 0; i < slots.instance_count; ++i)
 		{
-			if (data.empty())
+			SubMeshInstance const& instance = mesh.instances[i];
+			SubMeshGPU& submesh = mesh.submeshes[instance.submesh_index];
+			Material& material = mesh.materials[submesh.material_index];
+			Uint32 const instance_id = slots.instance_offset + i;
+
+			submesh.buffer_address = mesh_buffer->GetGpuAddress();
+
+			entt::entity batch_entity = slots.batch_entities[i];
+			if (material.alpha_mode == MaterialAlphaMode::Blend)
 			{
-				return;
+				reg.emplace_or_replace<Transparent>(batch_entity);
 			}
-			if (!scene_buffer.buffer || scene_buffer.buffer->GetCount() < data.size())
+			else
 			{
-				scene_buffer.buffer = gfx->CreateBuffer(StructuredBufferDesc<T>(data.size(), false, true));
-				scene_buffer.buffer_srv = gfx->CreateBufferSRV(scene_buffer.buffer.get());
+				reg.remove<Transparent>(batch_entity);
 			}
-			scene_buffer.buffer->Update(data.data(), data.size() * sizeof(T));
-			scene_buffer.buffer_srv_gpu_index = gfx->GetBindlessDescriptorIndex(scene_buffer.buffer_srv);
-		};
-		CopyBuffer(hlsl_lights, scene_buffers[SceneBuffer_Light]);
-		CopyBuffer(meshes, scene_buffers[SceneBuffer_Mesh]);
-		CopyBuffer(instances, scene_buffers[SceneBuffer_Instance]);
-		CopyBuffer(materials, scene_buffers[SceneBuffer_Material]);
+			Batch& batch = reg.get<Batch>(batch_entity);
+			batch.instance_id = instance_id;
+			batch.alpha_mode = material.alpha_mode;
+			batch.shading_extension = material.shading_extension;
+			batch.material_permutation = GetMaterialPermutation(material.alpha_mode, material.shading_extension);
+			batch.submesh = &submesh;
+			batch.world_transform = instance.world_transform;
+			submesh.bounding_box.Transform(batch.bounding_box, batch.world_transform);
+			scene_instance_bounds.Set(instance_id, batch.bounding_box);
+
+			InstanceGPU& instance_gpu = scene_instances[instance_id];
+			instance_gpu.instance_id = instance_id;
+			instance_gpu.material_idx = slots.material_offset + submesh.material_index;
+			instance_gpu.mesh_index = slots.mesh_offset + instance.submesh_index;
+			instance_gpu.world_matrix = instance.world_transform;
+			instance_gpu.inverse_world_matrix = XMMatrixInverse(nullptr, instance.world_transform);
+			instance_gpu.bb_origin = submesh.bounding_box.Center;
+			instance_gpu.bb_extents = submesh.bounding_box.Extents;
+		}
+		MarkSceneBufferDirty(scene_buffers[SceneBuffer_Instance].dirty_ranges, slots.instance_offset, slots.instance_count);
+
+		for (Uint32 i = 0; i < slots.mesh_count; ++i)
+		{
+			SubMeshGPU const& submesh = mesh.submeshes[i];
+			MeshGPU& mesh_gpu = scene_meshes[slots.mesh_offset + i];
+			mesh_gpu.buffer_idx = gfx->GetBindlessDescriptorIndex(mesh_buffer_srv);
+			mesh_gpu.indices_offset = submesh.indices_offset;
+			mesh_gpu.positions_offset = submesh.positions_offset;
+			mesh_gpu.normals_offset = submesh.normals_offset;
+			mesh_gpu.tangents_offset = submesh.tangents_offset;
+			mesh_gpu.uvs_offset = submesh.uvs_offset;
+
+			mesh_gpu.meshlet_offset = submesh.meshlet_offset;
+			mesh_gpu.meshlet_vertices_offset = submesh.meshlet_vertices_offset;
+			mesh_gpu.meshlet_triangles_offset = submesh.meshlet_triangles_offset;
+			mesh_gpu.meshlet_count = submesh.meshlet_count;
+			mesh_gpu.flags = submesh.flags;
+			mesh_gpu.position_center = submesh.bounding_box.Center;
+			mesh_gpu.position_extents = submesh.bounding_box.Extents;
+		}
+		MarkSceneBufferDirty(scene_buffers[SceneBuffer_Mesh].dirty_ranges, slots.mesh_offset, slots.mesh_count);
+
+		WriteSceneMaterials(mesh, slots);
+	}
+
+	void Renderer::WriteSceneMaterials(Mesh const& mesh, SceneMeshSlots const& slots)
+	{
+		for (Uint32 i = 0; i < slots.material_count; ++i)
+		{
+			Material const& material = mesh.materials[i];
+			MaterialGPU& material_gpu = scene_materials[slots.material_offset + i];
+			material_gpu.shading_extension = (Uint32)material.shading_extension;
+			material_gpu.albedo_color = Vector3(material.albedo_color);
+			material_gpu.albedo_idx = g_TextureManager.GetBindlessIndex(material.albedo_texture);
+			material_gpu.roughness_metallic_idx = g_TextureManager.GetBindlessIndex(material.metallic_roughness_texture);
+			material_gpu.metallic_factor = material.metallic_factor;
+			material_gpu.roughness_factor = material.roughness_factor;
+
+			material_gpu.normal_idx = g_TextureManager.GetBindlessIndex(material.normal_texture);
+			material_gpu.emissive_idx = g_TextureManager.GetBindlessIndex(material.emissive_texture);
+			material_gpu.emissive_factor = material.emissive_factor;
+			material_gpu.alpha_cutoff = material.alpha_cutoff;
+			material_gpu.alpha_blended = material.alpha_mode == MaterialAlphaMode::Blend;
+
+			material_gpu.anisotropy_idx = g_TextureManager.GetBindlessIndex(material.anisotropy_texture);
+			material_gpu.anisotropy_strength = material.anisotropy_strength;
+			material_gpu.anisotropy_rotation = material.anisotropy_rotation;
+
+			material_gpu.clear_coat_idx = g_TextureManager.GetBindlessIndex(material.clear_coat_texture);
+			material_gpu.clear_coat_roughness_idx = g_TextureManager.GetBindlessIndex(material.clear_coat_roughness_texture);
+			material_gpu.clear_coat_normal_idx = g_TextureManager.GetBindlessIndex(material.clear_coat_normal_texture);
+			material_gpu.clear_coat = material.clear_coat;
+			material_gpu.clear_coat_roughness = material.clear_coat_roughness;
+
+			material_gpu.sheen_color = Vector3(material.sheen_color);
+			material_gpu.sheen_color_idx = g_TextureManager.GetBindlessIndex(material.sheen_color_texture);
+			material_gpu.sheen_roughness = material.sheen_roughness;
+			material_gpu.sheen_roughness_idx = g_TextureManager.GetBindlessIndex(material.sheen_roughness_texture);
+		}
+		MarkSceneBufferDirty(scene_buffers[SceneBuffer_Material].dirty_ranges, slots.material_offset, slots.material_count);
 	}
 
 	void Renderer::UpdateFrameConstants(Float dt)
@@ -435,7 +596,7 @@ namespace adria
 		frame_cbuf_data.materials_idx = (Int32)scene_buffers[SceneBuffer_Material].buffer_srv_gpu_index;
 		frame_cbuf_data.instances_idx = (Int32)scene_buffers[SceneBuffer_Instance].buffer_srv_gpu_index;
 		frame_cbuf_data.lights_idx = (Int32)scene_buffers[SceneBuffer_Light].buffer_srv_gpu_index;
-		frame_cbuf_data.light_count = (Int32)scene_buffers[SceneBuffer_Light].buffer->GetCount();
+		frame_cbuf_data.light_count = (Int32)scene_lights.size();
 		shadow_renderer.FillFrameCBuffer(frame_cbuf_data);
 		frame_cbuf_data.ddgi_volumes_idx = ddgi.IsEnabled() ? ddgi.GetDDGIVolumeIndex() : -1;
 		frame_cbuf_data.printf_buffer_idx = gpu_printf.GetPrintfBufferIndex();
@@ -480,17 +641,93 @@ namespace adria
 	}
 	void Renderer::CameraFrustumCulling()
 	{
-		BoundingFrustum camera_frustum = camera->Frustum();
+		ZoneScopedN("Renderer::CameraFrustumCulling");
+		FrustumPlanes const camera_planes = GetFrustumPlanes(camera->Frustum());
+
+		Uint64 const instance_count = scene_instance_bounds.Size();
+		Uint64 const chunk_size = AlignUp<Uint64>(std::max<Int>(CameraCullingChunkSize.Get(), 1), 64);
+		Uint64 const chunk_count = (instance_count + chunk_size - 1) / chunk_size;
+		instance_visibility.resize((instance_count + 63) / 64);
+		culling_chunk_visible_instances.resize(std::max<Uint64>(chunk_count, 1));
+
+		auto CullChunk = [&](Uint64 chunk)
+		{
+			std::vector<Uint32>& chunk_visible_instances = culling_chunk_visible_instances[chunk];
+			chunk_visible_instances.clear();
+			Uint64 const begin = chunk * chunk_size;
+			Uint64 const end = std::min(begin + chunk_size, instance_count);
+			CullAABBs(camera_planes, scene_instance_bounds, begin, end, chunk_visible_instances, instance_visibility.data());
+		};
+
+		g_ThreadPool.ParallelFor(0, chunk_count, 1, CullChunk);
+
+		visible_instances.clear();
+		for (Uint64 chunk = 0; chunk < chunk_count; ++chunk)
+		{
+			visible_instances.insert(visible_instances.end(), culling_chunk_visible_instances[chunk].begin(), culling_chunk_visible_instances[chunk].end());
+		}
+		TracyPlot("Visible Instances", (Int64)visible_instances.size());
+
 		auto batch_view = reg.view<Batch>();
-		auto light_view = reg.view<Light>();
 		for (entt::entity e : batch_view)
 		{
 			Batch& batch = batch_view.get<Batch>(e);
-			auto& aabb = batch.bounding_box;
-			batch.camera_visibility = camera_frustum.Intersects(aabb);
+			batch.camera_visibility = (instance_visibility[batch.instance_id / 64] >> (batch.instance_id % 64)) & 1;
 		}
 	}
 
+	void Renderer::SortCameraDraws()
+	{
+		ZoneScopedN("Renderer::SortCameraDraws");
+
+		//positive floats order like their bit patterns, the top 24 bits of the squared distance are enough to order draws
+		auto QuantizeDepth = [](Float distance_squared) -> Uint64
+		{
+			return std::bit_cast<Uint32>(distance_squared) >> 7;
+		};
+
+		Vector3 const camera_position = camera->Position();
+		Uint64 const draw_count = visible_instances.size();
+		draw_sort_items.resize(draw_count);
+		g_ThreadPool.ParallelFor(0, draw_count, 1024, [&](Uint64 i)
+			{
+				Uint32 const instance_id = visible_instances[i];
+				Batch const& batch = reg.get<Batch>(scene_instance_batches[instance_id]);
+				Uint64 const depth = QuantizeDepth(Vector3::DistanceSquared(camera_position, batch.bounding_box.Center));
+				Uint64 const material = scene_instances[instance_id].material_idx & 0xfffff;
+
+				//alpha mode and shading extension select the pso, materials are bindless so they only break depth ties
+				draw_sort_items[i].key = ((Uint64)batch.alpha_mode << 62) | ((Uint64)batch.shading_extension << 59) | (depth << 35) | (material << 15);
+				draw_sort_items[i].value = instance_id;
+			});
+
+		transparent_draw_sort_items.clear();
+		for (RadixSortItem const& item : draw_sort_items)
+		{
+			if ((MaterialAlphaMode)(item.key >> 62) == MaterialAlphaMode::Blend)
+			{
+				Uint64 const depth = (item.key >> 35) & 0xffffff;
+				transparent_draw_sort_items.push_back(RadixSortItem{ .key = (0xffffff - depth) << 40, .value = item.value });
+			}
+		}
+
+		draw_sort_scratch.resize(draw_count);
+		RadixSort(draw_sort_items, draw_sort_scratch);
+		RadixSort(transparent_draw_sort_items, draw_sort_scratch);
+
+		auto GatherBatches = [this](std::vector<RadixSortItem> const& items, std::vector<Batch const*>& draws)
+		{
+			draws.resize(items.size());
+			for (Uint64 i = 0; i < items.size(); ++i)
+			{
+				draws[i] = &reg.get<Batch>(scene_instance_batches[items[i].value]);
+			}
+		};
+		GatherBatches(draw_sort_items, camera_draws);
+		GatherBatches(transparent_draw_sort_items, camera_transparent_draws);
+		TracyPlot("Camera Draws", (Int64)camera_draws.size());
+	}
+
 	void Renderer::RenderImpl(RenderGraph& render_graph)
 	{
 		ZoneScopedN("Renderer::RenderImpl");
@@ -516,6 +753,7 @@ namespace adria
 			frame_data.frame_cbuffer_address = frame_cbuffer.GetGpuAddress(backbuffer_index);
 		}
 		rg_blackboard.Add<FrameBlackboardData>(std::move(frame_data));
+		rg_blackboard.Add<CameraDrawsBlackboardData>({ camera_draws.data(), camera_draws.size(), camera_transparent_draws.data(), camera_transparent_draws.size() });
 		render_graph.ImportTexture(RG_NAME(Backbuffer), gfx->GetBackbuffer());
 		render_graph.ImportTexture(RG_NAME(FinalTexture), final_texture.get());
 		postprocessor.ImportHistoryResources(render_graph);
@@ -28,6 +28,9 @@
 #include "Graphics/GfxShaderCompiler.h"
 #include "Graphics/GfxConstantBuffer.h"
 #include "RenderGraph/RenderGraphResourcePool.h"
+#include "RenderGraph/RenderGraphCompileCache.h"
+#include "Math/FrustumCulling.h"
+#include "Utilities/RadixSort.h"
 
 namespace adria
 {
@@ -36,6 +39,8 @@ namespace adria
 	class GfxCommandList;
 	class GfxTexture;
 	struct Light;
+	struct Mesh;
+	struct Batch;
 
 	enum class LightingPath : Uint8
 	{
@@ -45,8 +50,19 @@ namespace adria
 		PathTracing
 	};
 
+	//cpu time of the renderer stages in milliseconds, refreshed every frame
+	struct RendererCPUTimings
+	{
+		Float scene_buffers_update = 0.0f;
+		Float culling = 0.0f;
+		Float render_graph_build = 0.0f;
+		Float render_graph_compile = 0.0f;
+		Float pass_recording = 0.0f;
+	};
+
 	class Renderer
 	{
+		friend struct RendererTestAccess;
 	public:
 		Renderer(entt::registry& reg, GfxDevice* gfx, Uint32 width, Uint32 height);
 		~Renderer();
@@ -63,6 +79,7 @@ namespace adria
 		void OnLightChanged();
 
 		PickingData const& GetPickingData() const { return picking_data; }
+		RendererCPUTimings const& GetCPUTimings() const { return cpu_timings; }
 		Vector2u GetDisplayResolution() const { return Vector2u(display_width, display_height); }
 
 		void SetLightingPath(LightingPath path);
@@ -75,6 +92,8 @@ namespace adria
 		entt::registry& reg;
 		GfxDevice* gfx;
 		RGResourcePool resource_pool;
+		RGCompileCache render_graph_cache;
+		RGAllocator render_graph_allocator;
 
 		Camera const* camera;
 		Vector2 camera_jitter;
@@ -104,9 +123,43 @@ namespace adria
 			std::unique_ptr<GfxBuffer>  buffer;
 			GfxDescriptor				buffer_srv;
 			Uint32						buffer_srv_gpu_index;
+			std::vector<std::pair<Uint64, Uint64>> dirty_ranges;
 		};
 		std::array<SceneBuffer, SceneBuffer_Count> scene_buffers;
 
+		//every mesh entity owns contiguous ranges of the scene buffers for as long as it exists
+		struct SceneMeshSlots
+		{
+			Uint32 instance_offset;
+			Uint32 instance_count;
+			Uint32 mesh_offset;
+			Uint32 mesh_count;
+			Uint32 material_offset;
+			Uint32 material_count;
+			std::vector<entt::entity> batch_entities;
+		};
+		std::unordered_map<entt::entity, SceneMeshSlots> scene_mesh_slots;
+		std::vector<LightGPU>	 scene_lights;
+		std::vector<MeshGPU>	 scene_meshes;
+		std::vector<InstanceGPU> scene_instances;
+		std::vector<entt::entity> scene_instance_batches;
+		std::vector<MaterialGPU> scene_materials;
+		AABBStreams				 scene_instance_bounds;
+		Bool					 scene_buffers_rebuild = true;
+		Bool					 scene_materials_dirty = false;
+		Uint64					 scene_buffers_upload_size = 0;
+		RendererCPUTimings		 cpu_timings;
+
+		//camera culling results, indexed by instance id
+		std::vector<Uint32> visible_instances;
+		std::vector<Uint64> instance_visibility;
+		std::vector<std::vector<Uint32>> culling_chunk_visible_instances;
+		std::vector<RadixSortItem> draw_sort_items;
+		std::vector<RadixSortItem> transparent_draw_sort_items;
+		std::vector<RadixSortItem> draw_sort_scratch;
+		std::vector<Batch const*> camera_draws;
+		std::vector<Batch const*> camera_transparent_draws;
+
 		//passes
 		GBufferPass  gbuffer_pass;
 		GPUDrivenGBufferPass gpu_driven_renderer;
@@ -172,8 +225,13 @@ namespace adria
 
 		void GUI();
 		void UpdateSceneBuffers();
+		void UpdateSceneLights();
+		void UpdateSceneMeshes();
+		void WriteSceneMesh(Mesh& mesh, SceneMeshSlots const& slots);
+		void WriteSceneMaterials(Mesh const& mesh, SceneMeshSlots const& slots);
 		void UpdateFrameConstants(Float dt);
 		void CameraFrustumCulling();
+		void SortCameraDraws();
 
 		void RenderImpl(RenderGraph& rg);
 		void Render_Deferred(RenderGraph& rg);
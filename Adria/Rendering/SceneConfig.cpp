@@ -63,7 +63,9 @@ namespace adria
 			model_params.Find<Bool>("force_alpha_mask", force_mask);
 			Bool load_model_lights = false;
 			model_params.Find<Bool>("load_model_lights", load_model_lights);
-			config.scene_models.emplace_back(path, tex_path, transform, triangle_ccw, force_mask, load_model_lights);
+			Bool compact_geometry = false;
+			model_params.Find<Bool>("compact_geometry", compact_geometry);
+			config.scene_models.emplace_back(path, tex_path, transform, triangle_ccw, force_mask, load_model_lights, compact_geometry);
 		}
 
 		for (auto&& light_json : lights)
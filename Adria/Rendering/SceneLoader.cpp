@@ -7,12 +7,15 @@
 #include "SceneLoader.h"
 #include "Components.h"
 #include "Graphics/GfxDevice.h"
-#include "Graphics/GfxLinearDynamicAllocator.h"
+#include "ModelCache.h"
 #include "Math/BoundingVolumeUtil.h"
+#include "Math/Packing.h"
 #include "Core/Paths.h"
 #include "Utilities/StringConversions.h"
 #include "Utilities/PathHelpers.h"
 #include "Utilities/Heightmap.h"
+#include "Utilities/ThreadPool.h"
+#include "Utilities/Timer.h"
 
 
 using namespace DirectX;
@@ -387,6 +390,30 @@ namespace adria
 
 	entt::entity SceneLoader::LoadModel(ModelParameters const& params)
 	{
+		Timer<> load_timer;
+		MemoryTracker::ResetPeak(MemoryCategory::ModelImport);
+		Bool const build_meshlets = gfx->GetCapabilities().SupportsMeshShaders();
+		Uint64 const options_hash = GetModelCookOptionsHash(params, build_meshlets);
+
+		CookedModel cooked_model;
+		Bool const cache_hit = cooked_model.Open(GetModelCachePath(params, options_hash), options_hash);
+		if (!cache_hit && !CookModel(params, build_meshlets, &cooked_model))
+		{
+			return entt::null;
+		}
+
+		entt::entity mesh_entity = CreateModel(params, cooked_model);
+		Float const peak_import_memory = MemoryTracker::GetPeak(MemoryCategory::ModelImport) / (1024.0f * 1024.0f);
+		ADRIA_LOG(INFO, "Model %s loaded in %.2f ms (%s, peak import memory %.1f MB)", params.model_path.c_str(), load_timer.ElapsedInSeconds() * 1000.0f,
+			cache_hit ? "cooked" : "imported", peak_import_memory);
+		return mesh_entity;
+	}
+
+	Bool SceneLoader::CookModel(ModelParameters const& params, Bool build_meshlets, CookedModel* cooked_model, ModelImportStats* stats)
+	{
+		Uint64 const base_import_bytes = MemoryTracker::GetCurrent(MemoryCategory::ModelImport);
+		MemoryTracker::ResetPeak(MemoryCategory::ModelImport);
+
 		enum class ModelFormat : Uint8
 		{
 			OBJ,
@@ -400,17 +427,209 @@ namespace adria
 			else return ModelFormat::Unknown;
 		};
 
+		CookedModelBuilder builder;
+		std::vector<MeshData> mesh_datas{};
+		Bool imported = false;
 		ModelFormat format = GetModelFormat(params.model_path);
 		switch (format)
 		{
-		case ModelFormat::GLTF: return LoadModel_GLTF(params);
-		case ModelFormat::OBJ:  return LoadModel_OBJ(params);
+		case ModelFormat::GLTF: imported = ImportModel_GLTF(params, builder, mesh_datas); break;
+		case ModelFormat::OBJ:  imported = ImportModel_OBJ(params, builder, mesh_datas); break;
 		case ModelFormat::Unknown: ADRIA_ASSERT_MSG(false, "Unknown model format!");
 		}
-		return entt::null;
+		if (!imported)
+		{
+			return false;
+		}
+
+		Uint64 const total_buffer_size = CalculateTotalBufferSize(mesh_datas, build_meshlets, params.compact_geometry);
+		//offsets are assigned serially in mesh order, the streams are then written straight into the cooked blob
+		Uint32 current_offset = 0;
+		auto ReserveData = [&current_offset]<typename T>(MeshStream<T> const& _data)
+		{
+			Uint32 const offset = current_offset;
+			current_offset += (Uint32)AlignUp(_data.size() * sizeof(T), 16);
+			return offset;
+		};
+		//the unused stream of each pair is empty or ignored, see CompactMeshData
+		auto ReserveStream = [&ReserveData]<typename T, typename U>(Bool packed, MeshStream<T> const& _data, MeshStream<U> const& _packed_data)
+		{
+			return packed ? ReserveData(_packed_data) : ReserveData(_data);
+		};
+
+		std::vector<SubMeshGPU>& submeshes = builder.GetSubMeshes();
+		submeshes.resize(mesh_datas.size());
+		for (Uint64 i = 0; i < mesh_datas.size(); ++i)
+		{
+			MeshData const& mesh_data = mesh_datas[i];
+			SubMeshGPU& submesh = submeshes[i];
+			submesh.buffer_address = 0;
+
+			SubMeshFlags const flags = mesh_data.flags;
+			submesh.flags = flags;
+			submesh.indices_offset = ReserveStream(flags & SubMeshFlag_16BitIndices, mesh_data.indices, mesh_data.packed_indices);
+			submesh.indices_count = (Uint32)mesh_data.indices.size();
+
+			submesh.vertices_count = (Uint32)mesh_data.positions_stream.size();
+			submesh.positions_offset = ReserveStream(flags & SubMeshFlag_QuantizedPositions, mesh_data.positions_stream, mesh_data.packed_positions_stream);
+			submesh.uvs_offset = ReserveStream(flags & SubMeshFlag_HalfUVs, mesh_data.uvs_stream, mesh_data.packed_uvs_stream);
+			submesh.normals_offset = ReserveStream(flags & SubMeshFlag_OctahedralNormals, mesh_data.normals_stream, mesh_data.packed_normals_stream);
+			submesh.tangents_offset = ReserveStream(flags & SubMeshFlag_OctahedralNormals, mesh_data.tangents_stream, mesh_data.packed_tangents_stream);
+			submesh.meshlet_offset = ReserveData(mesh_data.meshlets);
+			submesh.meshlet_vertices_offset = ReserveData(mesh_data.meshlet_vertices);
+			submesh.meshlet_triangles_offset = ReserveData(mesh_data.meshlet_triangles);
+			submesh.meshlet_count = (Uint32)mesh_data.meshlets.size();
+
+			submesh.bounding_box = mesh_data.bounding_box;
+			submesh.topology = mesh_data.topology;
+			submesh.material_index = mesh_data.material_index;
+		}
+		ADRIA_ASSERT(current_offset == total_buffer_size);
+
+		ModelImportStats import_stats{};
+		import_stats.stream_peak_bytes = MemoryTracker::GetPeak(MemoryCategory::ModelImport) - base_import_bytes;
+		import_stats.stream_bytes = MemoryTracker::GetCurrent(MemoryCategory::ModelImport) - base_import_bytes;
+
+		std::span<Uint8> geometry = builder.AllocateGeometry(total_buffer_size);
+		g_ThreadPool.ParallelFor(0, mesh_datas.size(), 1, [&](Uint64 i)
+			{
+				MeshData const& mesh_data = mesh_datas[i];
+				SubMeshGPU const& submesh = submeshes[i];
+				auto CopyData = [&geometry]<typename T>(MeshStream<T> const& _data, Uint32 offset)
+				{
+					if (!_data.empty())
+					{
+						memcpy(geometry.data() + offset, _data.data(), _data.size() * sizeof(T));
+					}
+				};
+				auto CopyStream = [&CopyData]<typename T, typename U>(Bool packed, MeshStream<T> const& _data, MeshStream<U> const& _packed_data, Uint32 offset)
+				{
+					if (packed) CopyData(_packed_data, offset);
+					else CopyData(_data, offset);
+				};
+				SubMeshFlags const flags = mesh_data.flags;
+				CopyStream(flags & SubMeshFlag_16BitIndices, mesh_data.indices, mesh_data.packed_indices, submesh.indices_offset);
+				CopyStream(flags & SubMeshFlag_QuantizedPositions, mesh_data.positions_stream, mesh_data.packed_positions_stream, submesh.positions_offset);
+				CopyStream(flags & SubMeshFlag_HalfUVs, mesh_data.uvs_stream, mesh_data.packed_uvs_stream, submesh.uvs_offset);
+				CopyStream(flags & SubMeshFlag_OctahedralNormals, mesh_data.normals_stream, mesh_data.packed_normals_stream, submesh.normals_offset);
+				CopyStream(flags & SubMeshFlag_OctahedralNormals, mesh_data.tangents_stream, mesh_data.packed_tangents_stream, submesh.tangents_offset);
+				CopyData(mesh_data.meshlets, submesh.meshlet_offset);
+				CopyData(mesh_data.meshlet_vertices, submesh.meshlet_vertices_offset);
+				CopyData(mesh_data.meshlet_triangles, submesh.meshlet_triangles_offset);
+			});
+
+		mesh_datas.clear();
+
+		Uint64 const options_hash = GetModelCookOptionsHash(params, build_meshlets);
+		CookedModelBlob blob = builder.Build(options_hash);
+		import_stats.cooked_bytes = blob.size();
+		std::string const cache_path = GetModelCachePath(params, options_hash);
+		CookedModel saved_model;
+		if (!(cooked_model ? *cooked_model : saved_model).Save(cache_path, std::move(blob)))
+		{
+			ADRIA_LOG(WARNING, "Failed to write model cache '%s'", cache_path.c_str());
+		}
+		import_stats.peak_bytes = MemoryTracker::GetPeak(MemoryCategory::ModelImport) - base_import_bytes;
+		if (stats)
+		{
+			*stats = import_stats;
+		}
+		return true;
 	}
 
-	entt::entity SceneLoader::LoadModel_GLTF(ModelParameters const& params)
+	Bool SceneLoader::CookModels(std::vector<ModelParameters> const& models)
+	{
+		Bool success = true;
+		for (ModelParameters const& params : models)
+		{
+			//the device is not known ahead of time so both meshlet variants are cooked
+			for (Bool build_meshlets : { false, true })
+			{
+				Timer<> cook_timer;
+				if (!CookModel(params, build_meshlets))
+				{
+					ADRIA_LOG(ERROR, "Failed to cook model %s", params.model_path.c_str());
+					success = false;
+					break;
+				}
+				ADRIA_LOG(INFO, "Model %s cooked in %.2f ms (meshlets: %s)", params.model_path.c_str(), cook_timer.ElapsedInSeconds() * 1000.0f, build_meshlets ? "yes" : "no");
+			}
+		}
+		return success;
+	}
+
+	entt::entity SceneLoader::CreateModel(ModelParameters const& params, CookedModel const& cooked_model)
+	{
+		std::string model_name = GetFilename(params.model_path);
+		entt::entity mesh_entity = reg.create();
+		Mesh mesh{};
+
+		std::span<CookedMaterial const> cooked_materials = cooked_model.GetMaterials();
+		mesh.materials.reserve(cooked_materials.size());
+		for (CookedMaterial const& cooked_material : cooked_materials)
+		{
+			Material& material = mesh.materials.emplace_back(cooked_material.material);
+			for (Uint32 slot = 0; slot < MaterialTextureSlot_Count; ++slot)
+			{
+				if (cooked_material.texture_paths[slot] != CookedModelInvalidString)
+				{
+					//the slot default stays bound until the streamed texture is resident
+					Bool const alpha_tested = slot == MaterialTextureSlot_Albedo && material.alpha_mode == MaterialAlphaMode::Mask;
+					TextureCookParams cook_params{};
+					cook_params.srgb = cooked_material.srgb_mask & (1u << slot);
+					cook_params.alpha_cutoff = alpha_tested ? material.alpha_cutoff : 0.0f;
+					cook_params.compressed_format = GetMaterialTextureCompressedFormat((MaterialTextureSlot)slot, material.alpha_mode);
+					TextureHandle& texture = material.*GetMaterialTextureMember((MaterialTextureSlot)slot);
+					texture = g_TextureManager.StreamTexture(cooked_model.GetString(cooked_material.texture_paths[slot]), texture, cook_params);
+				}
+			}
+		}
+
+		std::span<SubMeshGPU const> submeshes = cooked_model.GetSubMeshes();
+		mesh.submeshes.assign(submeshes.begin(), submeshes.end());
+		mesh.geometry_buffer_handle = g_GeometryBufferCache.CreateAndInitializeGeometryBuffer(cooked_model.GetGeometry());
+
+		std::span<CookedInstance const> cooked_instances = cooked_model.GetInstances();
+		mesh.instances.reserve(cooked_instances.size());
+		for (CookedInstance const& cooked_instance : cooked_instances)
+		{
+			SubMeshInstance& instance = mesh.instances.emplace_back();
+			instance.submesh_index = cooked_instance.submesh_index;
+			instance.world_transform = cooked_instance.local_to_world * params.model_matrix;
+			instance.parent = mesh_entity;
+		}
+
+		if (params.load_model_lights)
+		{
+			for (CookedLight const& cooked_light : cooked_model.GetLights())
+			{
+				LightParameters light_params{};
+				light_params.mesh_size = 150;
+				light_params.mesh_type = LightMesh::NoMesh;
+				light_params.light_data = cooked_light.light_data;
+
+				//modify some light data using model matrix
+				Vector3 translation, scale;
+				Quaternion rotation;
+				light_params.light_data.position = Vector4::Transform(light_params.light_data.position, params.model_matrix);
+				params.model_matrix.Decompose(scale, rotation, translation);
+				light_params.light_data.range *= (scale.x + scale.y + scale.z) / 3;
+
+				LoadLight(light_params);
+			}
+		}
+
+		reg.emplace<Mesh>(mesh_entity, mesh);
+		reg.emplace<Tag>(mesh_entity, model_name + " mesh");
+
+		if (gfx->GetCapabilities().SupportsRayTracing())
+		{
+			reg.emplace<RayTracing>(mesh_entity);
+		}
+		return mesh_entity;
+	}
+
+	Bool SceneLoader::ImportModel_GLTF(ModelParameters const& params, CookedModelBuilder& builder, std::vector<MeshData>& mesh_datas)
 	{
 		cgltf_options options{};
 		cgltf_data* gltf_data = nullptr;
@@ -418,24 +637,38 @@ namespace adria
 		if (result != cgltf_result_success)
 		{
 			ADRIA_LOG(WARNING, "GLTF - Failed to load '%s'", params.model_path.c_str());
-			return entt::null;
+			return false;
 		}
 		result = cgltf_load_buffers(&options, gltf_data, params.model_path.c_str());
 		if (result != cgltf_result_success)
 		{
 			ADRIA_LOG(WARNING, "GLTF - Failed to load buffers '%s'", params.model_path.c_str());
-			return entt::null;
+			cgltf_free(gltf_data);
+			return false;
 		}
 
-		std::string model_name = GetFilename(params.model_path);
-		entt::entity mesh_entity = reg.create();
-		Mesh mesh{};
+		builder.AddDependency(params.model_path);
+		std::string const model_dir = GetParentPath(params.model_path);
+		for (Uint64 i = 0; i < gltf_data->buffers_count; ++i)
+		{
+			Char const* uri = gltf_data->buffers[i].uri;
+			if (uri && strncmp(uri, "data:", 5) != 0)
+			{
+				builder.AddDependency(model_dir + "/" + uri);
+			}
+		}
 
-		mesh.materials.reserve(gltf_data->materials_count);
+		std::vector<CookedMaterial>& materials = builder.GetMaterials();
+		materials.reserve(gltf_data->materials_count);
 		for (Uint32 i = 0; i < gltf_data->materials_count; ++i)
 		{
 			cgltf_material const& gltf_material = gltf_data->materials[i];
-			Material& material = mesh.materials.emplace_back();
+			CookedMaterial& cooked_material = materials.emplace_back();
+			std::fill(std::begin(cooked_material.texture_paths), std::end(cooked_material.texture_paths), CookedModelInvalidString);
+			cooked_material.srgb_mask = 0;
+
+			Material& material = cooked_material.material;
+			material = Material{};
 			material.alpha_cutoff = (Float)gltf_material.alpha_cutoff;
 			material.double_sided = gltf_material.double_sided;
 			material.emissive_factor = (Float)gltf_material.emissive_factor[0];
@@ -472,14 +705,17 @@ namespace adria
 				}
 				return texture->image->uri;
 			};
-			auto GetTexture = [&](cgltf_texture* texture, bool srgb, TextureHandle default_handle)
+			auto SetTexture = [&](MaterialTextureSlot slot, cgltf_texture* texture, bool srgb, TextureHandle default_handle)
 			{
+				material.*GetMaterialTextureMember(slot) = default_handle;
 				if (texture)
 				{
-					std::string texbase = params.textures_path + GetImageURI(texture);
-					return g_TextureManager.LoadTexture(texbase, srgb);
+					cooked_material.texture_paths[slot] = builder.AddString(params.textures_path + GetImageURI(texture));
+					if (srgb)
+					{
+						cooked_material.srgb_mask |= 1u << slot;
+					}
 				}
-				return default_handle;
 			};
 			if (gltf_material.has_pbr_metallic_roughness)
 			{
@@ -489,13 +725,13 @@ namespace adria
 				material.albedo_color[2] = (Float)pbr_metallic_roughness.base_color_factor[2];
 				material.metallic_factor = (Float)pbr_metallic_roughness.metallic_factor;
 				material.roughness_factor = (Float)pbr_metallic_roughness.roughness_factor;
-				material.albedo_texture = GetTexture(pbr_metallic_roughness.base_color_texture.texture, true, DEFAULT_WHITE_TEXTURE_HANDLE);
-				material.metallic_roughness_texture = GetTexture(pbr_metallic_roughness.metallic_roughness_texture.texture, false, DEFAULT_METALLIC_ROUGHNESS_TEXTURE_HANDLE);
+				SetTexture(MaterialTextureSlot_Albedo, pbr_metallic_roughness.base_color_texture.texture, true, DEFAULT_WHITE_TEXTURE_HANDLE);
+				SetTexture(MaterialTextureSlot_MetallicRoughness, pbr_metallic_roughness.metallic_roughness_texture.texture, false, DEFAULT_METALLIC_ROUGHNESS_TEXTURE_HANDLE);
 			}
 			else if (gltf_material.has_pbr_specular_glossiness)
 			{
 				cgltf_pbr_specular_glossiness pbr_specular_glossiness = gltf_material.pbr_specular_glossiness;
-				material.albedo_texture = GetTexture(pbr_specular_glossiness.diffuse_texture.texture, true, DEFAULT_WHITE_TEXTURE_HANDLE);
+				SetTexture(MaterialTextureSlot_Albedo, pbr_specular_glossiness.diffuse_texture.texture, true, DEFAULT_WHITE_TEXTURE_HANDLE);
 				material.roughness_factor = 1.0f - gltf_material.pbr_specular_glossiness.glossiness_factor;
 				material.albedo_color[0] = gltf_material.pbr_specular_glossiness.diffuse_factor[0];
 				material.albedo_color[1] = gltf_material.pbr_specular_glossiness.diffuse_factor[1];
@@ -507,68 +743,58 @@ namespace adria
 			if (gltf_material.has_anisotropy)
 			{
 				material.shading_extension = ShadingExtension::Anisotropy;
-				material.anisotropy_texture = GetTexture(gltf_material.anisotropy.anisotropy_texture.texture, true, INVALID_TEXTURE_HANDLE);
+				SetTexture(MaterialTextureSlot_Anisotropy, gltf_material.anisotropy.anisotropy_texture.texture, true, INVALID_TEXTURE_HANDLE);
 				material.anisotropy_strength = gltf_material.anisotropy.anisotropy_strength;
 				material.anisotropy_rotation = gltf_material.anisotropy.anisotropy_rotation;
 			}
 			if (gltf_material.has_clearcoat)
 			{
 				material.shading_extension = ShadingExtension::ClearCoat;
-				material.clear_coat_texture = GetTexture(gltf_material.clearcoat.clearcoat_texture.texture, false, DEFAULT_WHITE_TEXTURE_HANDLE);
-				material.clear_coat_roughness_texture = GetTexture(gltf_material.clearcoat.clearcoat_roughness_texture.texture, false, DEFAULT_WHITE_TEXTURE_HANDLE);
-				material.clear_coat_normal_texture = GetTexture(gltf_material.clearcoat.clearcoat_normal_texture.texture, false, DEFAULT_NORMAL_TEXTURE_HANDLE);
+				SetTexture(MaterialTextureSlot_ClearCoat, gltf_material.clearcoat.clearcoat_texture.texture, false, DEFAULT_WHITE_TEXTURE_HANDLE);
+				SetTexture(MaterialTextureSlot_ClearCoatRoughness, gltf_material.clearcoat.clearcoat_roughness_texture.texture, false, DEFAULT_WHITE_TEXTURE_HANDLE);
+				SetTexture(MaterialTextureSlot_ClearCoatNormal, gltf_material.clearcoat.clearcoat_normal_texture.texture, false, DEFAULT_NORMAL_TEXTURE_HANDLE);
 				material.clear_coat = gltf_material.clearcoat.clearcoat_factor;
 				material.clear_coat_roughness = gltf_material.clearcoat.clearcoat_roughness_factor;
 			}
 			if (gltf_material.has_sheen)
 			{
 				material.shading_extension = ShadingExtension::Sheen;
-				material.sheen_color_texture = GetTexture(gltf_material.sheen.sheen_color_texture.texture, true, DEFAULT_WHITE_TEXTURE_HANDLE);
-				material.sheen_roughness_texture = GetTexture(gltf_material.sheen.sheen_roughness_texture.texture, false, DEFAULT_WHITE_TEXTURE_HANDLE);
+				SetTexture(MaterialTextureSlot_SheenColor, gltf_material.sheen.sheen_color_texture.texture, true, DEFAULT_WHITE_TEXTURE_HANDLE);
+				SetTexture(MaterialTextureSlot_SheenRoughness, gltf_material.sheen.sheen_roughness_texture.texture, false, DEFAULT_WHITE_TEXTURE_HANDLE);
 				material.sheen_color[0] = gltf_material.sheen.sheen_color_factor[0];
 				material.sheen_color[1] = gltf_material.sheen.sheen_color_factor[1];
 				material.sheen_color[2] = gltf_material.sheen.sheen_color_factor[2];
 				material.sheen_roughness = gltf_material.sheen.sheen_roughness_factor;
 			}
 
-			if (cgltf_texture* texture = gltf_material.normal_texture.texture)
-			{
-				std::string texnormal = params.textures_path + GetImageURI(texture);
-				material.normal_texture = g_TextureManager.LoadTexture(texnormal, false);
-			}
-			else
-			{
-				material.normal_texture = DEFAULT_NORMAL_TEXTURE_HANDLE;
-			}
-
-			if (cgltf_texture* texture = gltf_material.emissive_texture.texture)
-			{
-				std::string texemissive = params.textures_path + GetImageURI(texture);
-				material.emissive_texture = g_TextureManager.LoadTexture(texemissive, true);
-			}
-			else
-			{
-				material.emissive_texture = DEFAULT_BLACK_TEXTURE_HANDLE;
-			}
+			SetTexture(MaterialTextureSlot_Normal, gltf_material.normal_texture.texture, false, DEFAULT_NORMAL_TEXTURE_HANDLE);
+			SetTexture(MaterialTextureSlot_Emissive, gltf_material.emissive_texture.texture, true, DEFAULT_BLACK_TEXTURE_HANDLE);
 		}
 
 		std::unordered_map<cgltf_mesh const*, std::vector<Int32>> mesh_primitives_map; //mesh -> vector of primitive indices
-		Int32 primitive_count = 0;
-
-		std::vector<MeshData> mesh_datas{};
+		std::vector<cgltf_primitive const*> gltf_primitives;
 		for (Uint32 i = 0; i < gltf_data->meshes_count; ++i)
 		{
 			cgltf_mesh const& gltf_mesh = gltf_data->meshes[i];
 			std::vector<Int32>& primitives = mesh_primitives_map[&gltf_mesh];
 			for (Uint32 j = 0; j < gltf_mesh.primitives_count; ++j)
 			{
-				cgltf_primitive const& gltf_primitive = gltf_mesh.primitives[j];
+				primitives.push_back((Int32)gltf_primitives.size());
+				gltf_primitives.push_back(&gltf_mesh.primitives[j]);
+			}
+		}
+
+		//primitives are independent, each one is read into its own slot so the result does not depend on the job order
+		mesh_datas.resize(gltf_primitives.size());
+		g_ThreadPool.ParallelFor(0, gltf_primitives.size(), 1, [&](Uint64 primitive_index)
+			{
+				cgltf_primitive const& gltf_primitive = *gltf_primitives[primitive_index];
 				ADRIA_ASSERT(gltf_primitive.indices->count >= 0);
 
-				MeshData& mesh_data = mesh_datas.emplace_back();
+				MeshData& mesh_data = mesh_datas[primitive_index];
 				mesh_data.material_index = (Int32)(gltf_primitive.material - gltf_data->materials);
 				mesh_data.indices.reserve(gltf_primitive.indices->count);
-				
+
 				Uint32 triangle_cw[] = { 0, 1, 2 };
 				Uint32 triangle_ccw[] = { 0, 2, 1 };
 				Uint32* order = params.triangle_ccw ? triangle_ccw : triangle_cw;
@@ -603,11 +829,11 @@ namespace adria
 				for (Uint32 k = 0; k < gltf_primitive.attributes_count; ++k)
 				{
 					cgltf_attribute const& gltf_attribute = gltf_primitive.attributes[k];
-					std::string const& attr_name = gltf_attribute.name;
+					std::string_view const attr_name = gltf_attribute.name;
 
-					auto ReadAttributeData = [&]<typename T>(std::vector<T>& stream, const Char* stream_name)
+					auto ReadAttributeData = [&]<typename T>(MeshStream<T>& stream, const Char* stream_name)
 					{
-						if (!attr_name.compare(stream_name))
+						if (attr_name == stream_name)
 						{
 							stream.resize(gltf_attribute.data->count);
 							for (Uint64 i = 0; i < gltf_attribute.data->count; ++i)
@@ -621,59 +847,7 @@ namespace adria
 					ReadAttributeData(mesh_data.tangents_stream, "TANGENT");
 					ReadAttributeData(mesh_data.uvs_stream, "TEXCOORD_0");
 				}
-				primitives.push_back(primitive_count++);
-			}
-		}
-
-		Uint64 const total_buffer_size = CalculateTotalBufferSize(mesh_datas);
-		GfxDynamicAllocation staging_buffer = gfx->GetDynamicAllocator()->Allocate(total_buffer_size, 16);
-		Uint32 current_offset = 0;
-		auto CopyData = [&staging_buffer, &current_offset]<typename T>(std::vector<T> const& _data)
-		{
-			Uint64 current_copy_size = _data.size() * sizeof(T);
-			staging_buffer.Update(_data.data(), current_copy_size, current_offset);
-			current_offset += (Uint32)AlignUp(current_copy_size, 16);
-		};
-
-		mesh.submeshes.reserve(mesh_datas.size());
-		for (Uint64 i = 0; i < mesh_datas.size(); ++i)
-		{
-			MeshData const& mesh_data = mesh_datas[i];
-			SubMeshGPU& submesh = mesh.submeshes.emplace_back();
-
-			submesh.indices_offset = current_offset;
-			submesh.indices_count = (Uint32)mesh_data.indices.size();
-			CopyData(mesh_data.indices);
-
-			submesh.vertices_count = (Uint32)mesh_data.positions_stream.size();
-			submesh.positions_offset = current_offset;
-			CopyData(mesh_data.positions_stream);
-
-			submesh.uvs_offset = current_offset;
-			CopyData(mesh_data.uvs_stream);
-
-			submesh.normals_offset = current_offset;
-			CopyData(mesh_data.normals_stream);
-
-			submesh.tangents_offset = current_offset;
-			CopyData(mesh_data.tangents_stream);
-
-			submesh.meshlet_offset = current_offset;
-			CopyData(mesh_data.meshlets);
-
-			submesh.meshlet_vertices_offset = current_offset;
-			CopyData(mesh_data.meshlet_vertices);
-
-			submesh.meshlet_triangles_offset = current_offset;
-			CopyData(mesh_data.meshlet_triangles);
-
-			submesh.meshlet_count = (Uint32)mesh_data.meshlets.size();
-
-			submesh.bounding_box = mesh_data.bounding_box;
-			submesh.topology = mesh_data.topology;
-			submesh.material_index = mesh_data.material_index;
-		}
-		mesh.geometry_buffer_handle = g_GeometryBufferCache.CreateAndInitializeGeometryBuffer(staging_buffer.buffer, total_buffer_size, staging_buffer.offset);
+			});
 
 		for (Uint64 i = 0; i < gltf_data->nodes_count; ++i)
 		{
@@ -686,14 +860,13 @@ namespace adria
 			{
 				for (Int32 primitive : mesh_primitives_map[gltf_node.mesh])
 				{
-					SubMeshInstance& instance = mesh.instances.emplace_back();
+					CookedInstance& instance = builder.GetInstances().emplace_back();
 					instance.submesh_index = primitive;
-					instance.world_transform = local_to_world * params.model_matrix;
-					instance.parent = mesh_entity;
+					instance.local_to_world = local_to_world;
 				}
 			}
 
-			if (params.load_model_lights && gltf_node.light)
+			if (gltf_node.light)
 			{
 				cgltf_light const& gltf_light = *gltf_node.light;
 			
@@ -701,61 +874,44 @@ namespace adria
 				Quaternion rotation;
 				local_to_world.Decompose(scale, rotation,translation);
 
-				LightParameters light_params{};
-				light_params.mesh_size = 150;
-				light_params.mesh_type = LightMesh::NoMesh;
-				light_params.light_data.color.x = gltf_light.color[0];
-				light_params.light_data.color.y = gltf_light.color[1];
-				light_params.light_data.color.z = gltf_light.color[2];
-				light_params.light_data.intensity = gltf_light.intensity;
-				light_params.light_data.inner_cosine = cos(gltf_light.spot_inner_cone_angle);
-				light_params.light_data.outer_cosine = cos(gltf_light.spot_outer_cone_angle);
-				light_params.light_data.range = gltf_light.range > 0 ? gltf_light.range : FLT_MAX;
-				light_params.light_data.position = Vector4(translation.x, translation.y, translation.z, 1.0f);
+				Light& light_data = builder.GetLights().emplace_back().light_data;
+				light_data = Light{};
+				light_data.color.x = gltf_light.color[0];
+				light_data.color.y = gltf_light.color[1];
+				light_data.color.z = gltf_light.color[2];
+				light_data.intensity = gltf_light.intensity;
+				light_data.inner_cosine = cos(gltf_light.spot_inner_cone_angle);
+				light_data.outer_cosine = cos(gltf_light.spot_outer_cone_angle);
+				light_data.range = gltf_light.range > 0 ? gltf_light.range : FLT_MAX;
+				light_data.position = Vector4(translation.x, translation.y, translation.z, 1.0f);
 				Vector3 forward(0.0f, 0.0f, -1.0f);
 				Vector3 direction = Vector3::Transform(forward, Matrix::CreateFromQuaternion(rotation));
-				light_params.light_data.direction = Vector4(direction.x, direction.y, direction.z, 0.0f);
+				light_data.direction = Vector4(direction.x, direction.y, direction.z, 0.0f);
 
 				switch (gltf_light.type)
 				{
 				case cgltf_light_type_directional: 
-					light_params.light_data.type = LightType::Directional;
-					light_params.light_data.casts_shadows = true;
-					light_params.light_data.use_cascades = true;
+					light_data.type = LightType::Directional;
+					light_data.casts_shadows = true;
+					light_data.use_cascades = true;
 					break;
 				case cgltf_light_type_point:	   
-					light_params.light_data.type = LightType::Point;
-					light_params.light_data.intensity /= 10;
+					light_data.type = LightType::Point;
+					light_data.intensity /= 10;
 					break;
 				case cgltf_light_type_spot:		   
-					light_params.light_data.type = LightType::Spot;
-					light_params.light_data.intensity /= 100;
+					light_data.type = LightType::Spot;
+					light_data.intensity /= 100;
 					break;
 				}
-
-				//modify some light data using model matrix
-				light_params.light_data.position = Vector4::Transform(light_params.light_data.position, params.model_matrix);
-				params.model_matrix.Decompose(scale, rotation, translation);
-				light_params.light_data.range *= (scale.x + scale.y + scale.z) / 3;
-
-				LoadLight(light_params);
 			}
 		}
 
-		reg.emplace<Mesh>(mesh_entity, mesh);
-		reg.emplace<Tag>(mesh_entity, model_name + " mesh");
-
-		if (gfx->GetCapabilities().SupportsRayTracing()) 
-		{
-			reg.emplace<RayTracing>(mesh_entity);
-		}
-
-		ADRIA_LOG(INFO, "GLTF Model %s successfully loaded!", params.model_path.c_str());
 		cgltf_free(gltf_data);
-		return mesh_entity;
+		return true;
 	}
 
-	entt::entity SceneLoader::LoadModel_OBJ(ModelParameters const& params)
+	Bool SceneLoader::ImportModel_OBJ(ModelParameters const& params, CookedModelBuilder& builder, std::vector<MeshData>& mesh_datas)
 	{
 		tinyobj::ObjReaderConfig reader_config{};
 		tinyobj::ObjReader reader;
@@ -765,7 +921,7 @@ namespace adria
 			{
 				ADRIA_LOG(ERROR, "TinyOBJ error: %s", reader.Error().c_str());
 			}
-			return entt::null;
+			return false;
 		}
 		if (!reader.Warning().empty())
 		{
@@ -775,13 +931,23 @@ namespace adria
 		std::vector<tinyobj::shape_t> const& shapes = reader.GetShapes();
 		std::vector<tinyobj::material_t> const& obj_materials = reader.GetMaterials();
 
-		std::string model_name = GetFilename(params.model_path);
-		entt::entity mesh_entity = reg.create();
-		Mesh mesh;
-		mesh.materials.reserve(obj_materials.size());
+		builder.AddDependency(params.model_path);
+		std::string const mtl_path = GetParentPath(params.model_path) + "/" + GetFilenameWithoutExtension(params.model_path) + ".mtl";
+		if (FileExists(mtl_path))
+		{
+			builder.AddDependency(mtl_path);
+		}
+
+		std::vector<CookedMaterial>& materials = builder.GetMaterials();
+		materials.reserve(obj_materials.size());
 		for (tinyobj::material_t const& obj_material : obj_materials)
 		{
-			Material material{};
+			CookedMaterial& cooked_material = materials.emplace_back();
+			std::fill(std::begin(cooked_material.texture_paths), std::end(cooked_material.texture_paths), CookedModelInvalidString);
+			cooked_material.srgb_mask = 0;
+
+			Material& material = cooked_material.material;
+			material = Material{};
 			memcpy(material.albedo_color, obj_material.diffuse, sizeof(material.albedo_color));
 			material.emissive_factor = (obj_material.emission[0] + obj_material.emission[1] + obj_material.emission[2]) / 3;
 			material.roughness_factor = Clamp(1.0f - (obj_material.shininess / 1000.0f), 0.0f, 1.0f);
@@ -794,26 +960,22 @@ namespace adria
 			material.anisotropy_strength = obj_material.anisotropy;
 			material.anisotropy_rotation = obj_material.anisotropy_rotation;
 
-			if (!obj_material.diffuse_texname.empty())
-			{
-				std::string diffuse_texture = params.textures_path + obj_material.diffuse_texname;
-				material.albedo_texture = g_TextureManager.LoadTexture(diffuse_texture, true);
-			}
-			if (!obj_material.normal_texname.empty())
+			auto SetTexture = [&](MaterialTextureSlot slot, std::string const& texture_name, Bool srgb)
 			{
-				std::string normal_texture = params.textures_path + obj_material.normal_texname;
-				material.normal_texture = g_TextureManager.LoadTexture(normal_texture, false);
-			}
-			if (!obj_material.emissive_texname.empty())
-			{
-				std::string emissive_texture = params.textures_path + obj_material.emissive_texname;
-				material.emissive_texture = g_TextureManager.LoadTexture(emissive_texture, false);
-			}
-			mesh.materials.push_back(material);
+				if (!texture_name.empty())
+				{
+					cooked_material.texture_paths[slot] = builder.AddString(params.textures_path + texture_name);
+					if (srgb)
+					{
+						cooked_material.srgb_mask |= 1u << slot;
+					}
+				}
+			};
+			SetTexture(MaterialTextureSlot_Albedo, obj_material.diffuse_texname, true);
+			SetTexture(MaterialTextureSlot_Normal, obj_material.normal_texname, false);
+			SetTexture(MaterialTextureSlot_Emissive, obj_material.emissive_texname, false);
 		}
 
-		std::vector<MeshData> mesh_datas{};
-		mesh.submeshes.reserve(shapes.size());
 		for (Uint64 s = 0; s < shapes.size(); s++)
 		{
 			tinyobj::mesh_t const& obj_mesh = shapes[s].mesh;
@@ -854,163 +1016,183 @@ namespace adria
 			}
 		}
 
-		Bool const supports_meshlets = gfx->GetCapabilities().SupportsMeshShaders();
-		Uint64 const total_buffer_size = CalculateTotalBufferSize(mesh_datas);
-		GfxDynamicAllocation staging_buffer = gfx->GetDynamicAllocator()->Allocate(total_buffer_size, 16);
-
-		Uint32 current_offset = 0;
-		auto CopyData = [&staging_buffer, &current_offset]<typename T>(std::vector<T> const& _data)
-		{
-			Uint64 current_copy_size = _data.size() * sizeof(T);
-			staging_buffer.Update(_data.data(), current_copy_size, current_offset);
-			current_offset += (Uint32)AlignUp(current_copy_size, 16);
-		};
-
-		mesh.submeshes.reserve(mesh_datas.size());
-		mesh.instances.reserve(mesh_datas.size());
+		std::vector<CookedInstance>& instances = builder.GetInstances();
+		instances.reserve(mesh_datas.size());
 		for (Uint32 i = 0; i < mesh_datas.size(); ++i)
 		{
-			MeshData const& mesh_data = mesh_datas[i];
-			SubMeshGPU& submesh = mesh.submeshes.emplace_back();
-
-			submesh.indices_offset = current_offset;
-			submesh.indices_count = (Uint32)mesh_data.indices.size();
-			CopyData(mesh_data.indices);
-
-			submesh.vertices_count = (Uint32)mesh_data.positions_stream.size();
-			submesh.positions_offset = current_offset;
-			CopyData(mesh_data.positions_stream);
-
-			submesh.uvs_offset = current_offset;
-			CopyData(mesh_data.uvs_stream);
-
-			submesh.normals_offset = current_offset;
-			CopyData(mesh_data.normals_stream);
-
-			submesh.tangents_offset = current_offset;
-			CopyData(mesh_data.tangents_stream);
-
-			submesh.meshlet_offset = current_offset;
-			CopyData(mesh_data.meshlets);
+			instances.emplace_back(Matrix::Identity, i);
+		}
+		return true;
+	}
 
-			submesh.meshlet_vertices_offset = current_offset;
-			CopyData(mesh_data.meshlet_vertices);
+	Uint64 SceneLoader::CalculateTotalBufferSize(std::vector<MeshData>& mesh_datas, Bool build_meshlets, Bool compact_geometry)
+	{
+		//meshes are processed as independent jobs, the sizes are reduced in mesh order afterwards so the result matches the serial path
+		std::vector<Uint64> buffer_sizes(mesh_datas.size());
+		g_ThreadPool.ParallelFor(0, mesh_datas.size(), 1, [&](Uint64 i)
+			{
+				buffer_sizes[i] = ProcessMeshData(mesh_datas[i], build_meshlets, compact_geometry);
+			});
 
-			submesh.meshlet_triangles_offset = current_offset;
-			CopyData(mesh_data.meshlet_triangles);
+		Uint64 total_buffer_size = 0;
+		for (Uint64 buffer_size : buffer_sizes)
+		{
+			total_buffer_size += buffer_size;
+		}
+		return total_buffer_size;
+	}
 
-			submesh.meshlet_count = (Uint32)mesh_data.meshlets.size();
+	Uint64 SceneLoader::ProcessMeshData(MeshData& mesh_data, Bool build_meshlets, Bool compact_geometry)
+	{
+		Uint64 vertex_count = mesh_data.positions_stream.size();
 
-			submesh.bounding_box = mesh_data.bounding_box;
-			submesh.topology = mesh_data.topology;
-			submesh.material_index = mesh_data.material_index;
+		Bool has_tangents = !mesh_data.tangents_stream.empty();
+		if (mesh_data.normals_stream.size() != vertex_count) mesh_data.normals_stream.resize(vertex_count);
+		if (mesh_data.uvs_stream.size() != vertex_count) mesh_data.uvs_stream.resize(vertex_count);
+		if (mesh_data.tangents_stream.size() != vertex_count) mesh_data.tangents_stream.resize(vertex_count);
 
-			mesh.instances.emplace_back(mesh_entity, i, Matrix::Identity);
+		if (!has_tangents)
+		{
+			ComputeTangentFrame(mesh_data.indices.data(), mesh_data.indices.size(), mesh_data.positions_stream.data(),
+				mesh_data.normals_stream.data(), mesh_data.uvs_stream.data(), vertex_count, mesh_data.tangents_stream.data());
 		}
-		mesh.geometry_buffer_handle = g_GeometryBufferCache.CreateAndInitializeGeometryBuffer(staging_buffer.buffer, total_buffer_size, staging_buffer.offset);
 
-		reg.emplace<Mesh>(mesh_entity, mesh);
-		reg.emplace<Tag>(mesh_entity, model_name + " mesh");
-		if (gfx->GetCapabilities().SupportsRayTracing()) reg.emplace<RayTracing>(mesh_entity);
+		mesh_data.bounding_box = AABBFromPositions(mesh_data.positions_stream);
 
-		ADRIA_LOG(INFO, "GLTF Model %s successfully loaded!", params.model_path.c_str());
-		return mesh_entity;
+		if (build_meshlets)
+		{
+			BuildMeshlets(mesh_data);
+		}
+		//packing runs last, meshlet building and its bounds work on the float streams
+		if (compact_geometry)
+		{
+			CompactMeshData(mesh_data);
+		}
+		return GetMeshDataBufferSize(mesh_data);
 	}
 
-	Uint64 SceneLoader::CalculateTotalBufferSize(std::vector<MeshData>& mesh_datas)
+	void SceneLoader::BuildMeshlets(MeshData& mesh_data)
 	{
-		Bool const supports_meshlets = gfx->GetCapabilities().SupportsMeshShaders();
-		Uint64 total_buffer_size = 0;
-		for (auto& mesh_data : mesh_datas)
+		Uint64 vertex_count = mesh_data.positions_stream.size();
+		meshopt_optimizeVertexCache(mesh_data.indices.data(), mesh_data.indices.data(), mesh_data.indices.size(), vertex_count);
+		meshopt_optimizeOverdraw(mesh_data.indices.data(), mesh_data.indices.data(), mesh_data.indices.size(), &mesh_data.positions_stream[0].x, vertex_count, sizeof(Vector3), 1.05f);
+		std::vector<Uint32> remap(vertex_count);
+		meshopt_optimizeVertexFetchRemap(&remap[0], mesh_data.indices.data(), mesh_data.indices.size(), vertex_count);
+		meshopt_remapIndexBuffer(mesh_data.indices.data(), mesh_data.indices.data(), mesh_data.indices.size(), &remap[0]);
+		meshopt_remapVertexBuffer(mesh_data.positions_stream.data(), mesh_data.positions_stream.data(), vertex_count, sizeof(Vector3), &remap[0]);
+		meshopt_remapVertexBuffer(mesh_data.normals_stream.data(), mesh_data.normals_stream.data(), mesh_data.normals_stream.size(), sizeof(Vector3), &remap[0]);
+		meshopt_remapVertexBuffer(mesh_data.tangents_stream.data(), mesh_data.tangents_stream.data(), mesh_data.tangents_stream.size(), sizeof(Vector4), &remap[0]);
+		meshopt_remapVertexBuffer(mesh_data.uvs_stream.data(), mesh_data.uvs_stream.data(), mesh_data.uvs_stream.size(), sizeof(Vector2), &remap[0]);
+
+		Uint64 const max_meshlets = meshopt_buildMeshletsBound(mesh_data.indices.size(), MESHLET_MAX_VERTICES, MESHLET_MAX_TRIANGLES);
+		mesh_data.meshlets.resize(max_meshlets);
+		mesh_data.meshlet_vertices.resize(max_meshlets * MESHLET_MAX_VERTICES);
+
+		std::vector<Uchar> meshlet_triangles(max_meshlets * MESHLET_MAX_TRIANGLES * 3);
+		std::vector<meshopt_Meshlet> meshlets(max_meshlets);
+
+		Uint64 meshlet_count = meshopt_buildMeshlets(meshlets.data(), mesh_data.meshlet_vertices.data(), meshlet_triangles.data(),
+			mesh_data.indices.data(), mesh_data.indices.size(), &mesh_data.positions_stream[0].x, mesh_data.positions_stream.size(), sizeof(Vector3),
+			MESHLET_MAX_VERTICES, MESHLET_MAX_TRIANGLES, 0);
+
+		meshopt_Meshlet const& last = meshlets[meshlet_count - 1];
+		meshlet_triangles.resize(last.triangle_offset + ((last.triangle_count * 3 + 3) & ~3));
+		meshlets.resize(meshlet_count);
+
+		mesh_data.meshlets.resize(meshlet_count);
+		mesh_data.meshlet_vertices.resize(last.vertex_offset + last.vertex_count);
+		mesh_data.meshlet_triangles.resize(meshlet_triangles.size() / 3);
+		//the unused bits of MeshletTriangle are never written, clear them so the cooked geometry does not depend on heap contents
+		std::memset(mesh_data.meshlet_triangles.data(), 0, mesh_data.meshlet_triangles.size() * sizeof(MeshletTriangle));
+
+		Uint32 triangle_offset = 0;
+		for (Uint64 i = 0; i < meshlet_count; ++i)
 		{
-			std::vector<Uint32> const& indices = mesh_data.indices;
-			Uint64 vertex_count = mesh_data.positions_stream.size();
-
-			Bool has_tangents = !mesh_data.tangents_stream.empty();
-			if (mesh_data.normals_stream.size() != vertex_count) mesh_data.normals_stream.resize(vertex_count);
-			if (mesh_data.uvs_stream.size() != vertex_count) mesh_data.uvs_stream.resize(vertex_count);
-			if (mesh_data.tangents_stream.size() != vertex_count) mesh_data.tangents_stream.resize(vertex_count);
-
-			if (!has_tangents)
-			{
-				ComputeTangentFrame(mesh_data.indices.data(), mesh_data.indices.size(), mesh_data.positions_stream.data(),
-					mesh_data.normals_stream.data(), mesh_data.uvs_stream.data(), vertex_count, mesh_data.tangents_stream.data());
-			}
+			meshopt_Meshlet const& m = meshlets[i];
+			meshopt_Bounds meshopt_bounds = meshopt_computeMeshletBounds(&mesh_data.meshlet_vertices[m.vertex_offset], &meshlet_triangles[m.triangle_offset],
+				m.triangle_count, reinterpret_cast<Float const*>(mesh_data.positions_stream.data()), vertex_count, sizeof(Vector3));
 
-			total_buffer_size += AlignUp(mesh_data.indices.size() * sizeof(Uint32), 16);
-			total_buffer_size += AlignUp(mesh_data.positions_stream.size() * sizeof(Vector3), 16);
-			total_buffer_size += AlignUp(mesh_data.uvs_stream.size() * sizeof(Vector2), 16);
-			total_buffer_size += AlignUp(mesh_data.normals_stream.size() * sizeof(Vector3), 16);
-			total_buffer_size += AlignUp(mesh_data.tangents_stream.size() * sizeof(Vector4), 16);
-
-			mesh_data.bounding_box = AABBFromPositions(mesh_data.positions_stream);
-
-			if (!supports_meshlets)
+			Uchar* src_triangles = meshlet_triangles.data() + m.triangle_offset;
+			for (Uint32 triangle_idx = 0; triangle_idx < m.triangle_count; ++triangle_idx)
 			{
-				continue;
+				MeshletTriangle& tri = mesh_data.meshlet_triangles[triangle_idx + triangle_offset];
+				tri.V0 = *src_triangles++;
+				tri.V1 = *src_triangles++;
+				tri.V2 = *src_triangles++;
 			}
 
-			meshopt_optimizeVertexCache(mesh_data.indices.data(), mesh_data.indices.data(), mesh_data.indices.size(), vertex_count);
-			meshopt_optimizeOverdraw(mesh_data.indices.data(), mesh_data.indices.data(), mesh_data.indices.size(), &mesh_data.positions_stream[0].x, vertex_count, sizeof(Vector3), 1.05f);
-			std::vector<Uint32> remap(vertex_count);
-			meshopt_optimizeVertexFetchRemap(&remap[0], mesh_data.indices.data(), mesh_data.indices.size(), vertex_count);
-			meshopt_remapIndexBuffer(mesh_data.indices.data(), mesh_data.indices.data(), mesh_data.indices.size(), &remap[0]);
-			meshopt_remapVertexBuffer(mesh_data.positions_stream.data(), mesh_data.positions_stream.data(), vertex_count, sizeof(Vector3), &remap[0]);
-			meshopt_remapVertexBuffer(mesh_data.normals_stream.data(), mesh_data.normals_stream.data(), mesh_data.normals_stream.size(), sizeof(Vector3), &remap[0]);
-			meshopt_remapVertexBuffer(mesh_data.tangents_stream.data(), mesh_data.tangents_stream.data(), mesh_data.tangents_stream.size(), sizeof(Vector4), &remap[0]);
-			meshopt_remapVertexBuffer(mesh_data.uvs_stream.data(), mesh_data.uvs_stream.data(), mesh_data.uvs_stream.size(), sizeof(Vector2), &remap[0]);
-
-			Uint64 const max_meshlets = meshopt_buildMeshletsBound(mesh_data.indices.size(), MESHLET_MAX_VERTICES, MESHLET_MAX_TRIANGLES);
-			mesh_data.meshlets.resize(max_meshlets);
-			mesh_data.meshlet_vertices.resize(max_meshlets * MESHLET_MAX_VERTICES);
-
-			std::vector<Uchar> meshlet_triangles(max_meshlets * MESHLET_MAX_TRIANGLES * 3);
-			std::vector<meshopt_Meshlet> meshlets(max_meshlets);
-
-			Uint64 meshlet_count = meshopt_buildMeshlets(meshlets.data(), mesh_data.meshlet_vertices.data(), meshlet_triangles.data(),
-				mesh_data.indices.data(), mesh_data.indices.size(), &mesh_data.positions_stream[0].x, mesh_data.positions_stream.size(), sizeof(Vector3),
-				MESHLET_MAX_VERTICES, MESHLET_MAX_TRIANGLES, 0);
-
-			meshopt_Meshlet const& last = meshlets[meshlet_count - 1];
-			meshlet_triangles.resize(last.triangle_offset + ((last.triangle_count * 3 + 3) & ~3));
-			meshlets.resize(meshlet_count);
-
-			mesh_data.meshlets.resize(meshlet_count);
-			mesh_data.meshlet_vertices.resize(last.vertex_offset + last.vertex_count);
-			mesh_data.meshlet_triangles.resize(meshlet_triangles.size() / 3);
-
-			Uint32 triangle_offset = 0;
-			for (Uint64 i = 0; i < meshlet_count; ++i)
-			{
-				meshopt_Meshlet const& m = meshlets[i];
-				meshopt_Bounds meshopt_bounds = meshopt_computeMeshletBounds(&mesh_data.meshlet_vertices[m.vertex_offset], &meshlet_triangles[m.triangle_offset],
-					m.triangle_count, reinterpret_cast<Float const*>(mesh_data.positions_stream.data()), vertex_count, sizeof(Vector3));
+			Meshlet& meshlet = mesh_data.meshlets[i];
+			std::memcpy(meshlet.center, meshopt_bounds.center, sizeof(Float) * 3);
 
-				Uchar* src_triangles = meshlet_triangles.data() + m.triangle_offset;
-				for (Uint32 triangle_idx = 0; triangle_idx < m.triangle_count; ++triangle_idx)
-				{
-					MeshletTriangle& tri = mesh_data.meshlet_triangles[triangle_idx + triangle_offset];
-					tri.V0 = *src_triangles++;
-					tri.V1 = *src_triangles++;
-					tri.V2 = *src_triangles++;
-				}
+			meshlet.radius = meshopt_bounds.radius;
+			meshlet.vertex_count = m.vertex_count;
+			meshlet.triangle_count = m.triangle_count;
+			meshlet.vertex_offset = m.vertex_offset;
+			meshlet.triangle_offset = triangle_offset;
+			triangle_offset += m.triangle_count;
 
-				Meshlet& meshlet = mesh_data.meshlets[i];
-				std::memcpy(meshlet.center, meshopt_bounds.center, sizeof(Float) * 3);
+		}
+		mesh_data.meshlet_triangles.resize(triangle_offset);
+	}
 
-				meshlet.radius = meshopt_bounds.radius;
-				meshlet.vertex_count = m.vertex_count;
-				meshlet.triangle_count = m.triangle_count;
-				meshlet.vertex_offset = m.vertex_offset;
-				meshlet.triangle_offset = triangle_offset;
-				triangle_offset += m.triangle_count;
+	void SceneLoader::CompactMeshData(MeshData& mesh_data)
+	{
+		//half uvs lose precision quickly outside of [-1, 1], tiled uvs keep the float stream
+		static constexpr Float MaxHalfUVError = 1.0f / 4096.0f;
+
+		Uint64 const vertex_count = mesh_data.positions_stream.size();
+		Vector3 const center = mesh_data.bounding_box.Center;
+		Vector3 const extents = mesh_data.bounding_box.Extents;
+
+		mesh_data.packed_positions_stream.resize(vertex_count);
+		mesh_data.packed_normals_stream.resize(vertex_count);
+		mesh_data.packed_tangents_stream.resize(vertex_count);
+		mesh_data.packed_uvs_stream.resize(vertex_count);
+		Bool half_uvs = true;
+		for (Uint64 i = 0; i < vertex_count; ++i)
+		{
+			mesh_data.packed_positions_stream[i] = PackPositionSnorm16x4(mesh_data.positions_stream[i], center, extents);
+			mesh_data.packed_normals_stream[i] = PackNormalOctahedron16x2(mesh_data.normals_stream[i]);
+			mesh_data.packed_tangents_stream[i] = PackTangentOctahedron16x2(mesh_data.tangents_stream[i]);
+
+			Vector2 const& uv = mesh_data.uvs_stream[i];
+			mesh_data.packed_uvs_stream[i] = PackTwoFloatsToUint32(uv.x, uv.y);
+			Vector2 const uv_error = UnpackTwoFloatsFromUint32(mesh_data.packed_uvs_stream[i]) - uv;
+			half_uvs = half_uvs && std::abs(uv_error.x) <= MaxHalfUVError && std::abs(uv_error.y) <= MaxHalfUVError;
+		}
+		mesh_data.flags = SubMeshFlag_QuantizedPositions | SubMeshFlag_OctahedralNormals;
+		if (half_uvs)
+		{
+			mesh_data.flags |= SubMeshFlag_HalfUVs;
+		}
+		else
+		{
+			mesh_data.packed_uvs_stream.clear();
+		}
 
-			}
-			mesh_data.meshlet_triangles.resize(triangle_offset);
-			total_buffer_size += AlignUp(mesh_data.meshlets.size() * sizeof(Meshlet), 16);
-			total_buffer_size += AlignUp(mesh_data.meshlet_vertices.size() * sizeof(Uint32), 16);
-			total_buffer_size += AlignUp(mesh_data.meshlet_triangles.size() * sizeof(MeshletTriangle), 16);
+		if (vertex_count <= UINT16_MAX + 1)
+		{
+			mesh_data.packed_indices.assign(mesh_data.indices.begin(), mesh_data.indices.end());
+			mesh_data.flags |= SubMeshFlag_16BitIndices;
 		}
+	}
+
+	Uint64 SceneLoader::GetMeshDataBufferSize(MeshData const& mesh_data)
+	{
+		auto StreamSize = []<typename T>(MeshStream<T> const& stream)
+		{
+			return AlignUp(stream.size() * sizeof(T), 16);
+		};
+		SubMeshFlags const flags = mesh_data.flags;
+		Uint64 total_buffer_size = 0;
+		total_buffer_size += (flags & SubMeshFlag_16BitIndices) ? StreamSize(mesh_data.packed_indices) : StreamSize(mesh_data.indices);
+		total_buffer_size += (flags & SubMeshFlag_QuantizedPositions) ? StreamSize(mesh_data.packed_positions_stream) : StreamSize(mesh_data.positions_stream);
+		total_buffer_size += (flags & SubMeshFlag_HalfUVs) ? StreamSize(mesh_data.packed_uvs_stream) : StreamSize(mesh_data.uvs_stream);
+		total_buffer_size += (flags & SubMeshFlag_OctahedralNormals) ? StreamSize(mesh_data.packed_normals_stream) : StreamSize(mesh_data.normals_stream);
+		total_buffer_size += (flags & SubMeshFlag_OctahedralNormals) ? StreamSize(mesh_data.packed_tangents_stream) : StreamSize(mesh_data.tangents_stream);
+		total_buffer_size += StreamSize(mesh_data.meshlets);
+		total_buffer_size += StreamSize(mesh_data.meshlet_vertices);
+		total_buffer_size += StreamSize(mesh_data.meshlet_triangles);
 		return total_buffer_size;
 	}
 
@@ -3,6 +3,7 @@
 #include "Meshlet.h"
 #include "Math/NormalsUtil.h"
 #include "Utilities/Heightmap.h"
+#include "Utilities/MemoryTracker.h"
 #include "entt/entity/registry.hpp"
 
 namespace adria
@@ -22,6 +23,7 @@ namespace adria
 		Bool triangle_ccw = true;
 		Bool force_mask_alpha_usage = false;
 		Bool load_model_lights = false;
+		Bool compact_geometry = false;
     };
     struct SkyboxParameters
     {
@@ -65,24 +67,46 @@ namespace adria
 		Vector3 normal;
 	};
 
+	//import streams are tracked so the peak memory of a model import can be reported
+	template<typename T>
+	using MeshStream = TrackedVector<T, MemoryCategory::ModelImport>;
+
 	struct MeshData
 	{
 		DirectX::BoundingBox bounding_box;
 		Int32 material_index = -1;
 		GfxPrimitiveTopology topology = GfxPrimitiveTopology::TriangleList;
 
-		std::vector<Vector3>		 positions_stream;
-		std::vector<Vector3>		 normals_stream;
-		std::vector<Vector4>		 tangents_stream;
-		std::vector<Vector2>		 uvs_stream;
-		std::vector<Uint32>			 indices;
+		MeshStream<Vector3>			 positions_stream;
+		MeshStream<Vector3>			 normals_stream;
+		MeshStream<Vector4>			 tangents_stream;
+		MeshStream<Vector2>			 uvs_stream;
+		MeshStream<Uint32>			 indices;
+
+		SubMeshFlags				 flags = SubMeshFlag_None;
+		MeshStream<Uint64>			 packed_positions_stream;
+		MeshStream<Uint32>			 packed_normals_stream;
+		MeshStream<Uint32>			 packed_tangents_stream;
+		MeshStream<Uint32>			 packed_uvs_stream;
+		MeshStream<Uint16>			 packed_indices;
+
+		MeshStream<Meshlet>			 meshlets;
+		MeshStream<Uint32>			 meshlet_vertices;
+		MeshStream<MeshletTriangle>	 meshlet_triangles;
+	};
 
-		std::vector<Meshlet>		 meshlets;
-		std::vector<Uint32>			 meshlet_vertices;
-		std::vector<MeshletTriangle> meshlet_triangles;
+	//tracked ModelImport bytes of one cook, counted from the usage when the cook started
+	struct ModelImportStats
+	{
+		Uint64 stream_peak_bytes = 0;	//highest usage while the mesh streams are imported and processed
+		Uint64 stream_bytes = 0;		//mesh streams alive when the cooked blob is allocated
+		Uint64 cooked_bytes = 0;
+		Uint64 peak_bytes = 0;
 	};
 
     class GfxDevice;
+	class CookedModel;
+	class CookedModelBuilder;
  
 	class SceneLoader
 	{
@@ -96,15 +120,26 @@ namespace adria
 		ADRIA_MAYBE_UNUSED std::vector<entt::entity> LoadOcean(OceanParameters const&);
 		ADRIA_MAYBE_UNUSED entt::entity LoadDecal(DecalParameters const&);
 		ADRIA_MAYBE_UNUSED entt::entity LoadModel(ModelParameters const&);
+
+		//imports the model and writes it to the model cache, usable without a device to cook models ahead of time
+		static Bool CookModel(ModelParameters const&, Bool build_meshlets, CookedModel* cooked_model = nullptr, ModelImportStats* stats = nullptr);
+		static Bool CookModels(std::vector<ModelParameters> const&);
+
 	private:
         entt::registry& reg;
         GfxDevice* gfx;
 
 	private:
 		ADRIA_NODISCARD std::vector<entt::entity> LoadGrid(GridParameters const&);
-		ADRIA_MAYBE_UNUSED entt::entity LoadModel_GLTF(ModelParameters const&);
-		ADRIA_MAYBE_UNUSED entt::entity LoadModel_OBJ(ModelParameters const&);
-		ADRIA_NODISCARD Uint64 CalculateTotalBufferSize(std::vector<MeshData>& mesh_data);
+		entt::entity CreateModel(ModelParameters const&, CookedModel const&);
+
+		static Bool ImportModel_GLTF(ModelParameters const&, CookedModelBuilder&, std::vector<MeshData>&);
+		static Bool ImportModel_OBJ(ModelParameters const&, CookedModelBuilder&, std::vector<MeshData>&);
+		ADRIA_NODISCARD static Uint64 CalculateTotalBufferSize(std::vector<MeshData>& mesh_data, Bool build_meshlets, Bool compact_geometry);
+		static Uint64 ProcessMeshData(MeshData& mesh_data, Bool build_meshlets, Bool compact_geometry);
+		static void BuildMeshlets(MeshData& mesh_data);
+		static void CompactMeshData(MeshData& mesh_data);
+		ADRIA_NODISCARD static Uint64 GetMeshDataBufferSize(MeshData const& mesh_data);
 	};
 }
 
@@ -1,3 +1,4 @@
+#include <sstream>
 #include "ShaderManager.h"
 #include "Core/Paths.h"
 #include "Core/ConsoleManager.h"
@@ -8,13 +9,17 @@
 #include "Graphics/GfxPipelineState.h"
 #include "Utilities/Timer.h"
 #include "Utilities/FileWatcher.h"
+#include "Utilities/ThreadPool.h"
 
 namespace fs = std::filesystem;
 
 namespace adria
 {
+	ADRIA_LOG_CHANNEL(ShaderManager);
+
 	static TAutoConsoleVariable<Bool> OptimizeShaders("r.Shaders.Optimize", true, "Whether to optimize shaders");
 	static TAutoConsoleVariable<Bool> ShaderDebugInfo("r.Shaders.DebugInfo", false, "Whether to keep debug data from shader bytecode");
+	static TAutoConsoleVariable<Bool> ShaderHotReload("r.Shaders.HotReload", true, "Whether to recompile shaders as soon as their files change on disk");
 
 	namespace
 	{
@@ -23,6 +28,9 @@ namespace adria
 		LibraryRecompiledEvent library_recompiled_event;
 		std::unordered_map<GfxShaderKey, GfxShader, GfxShaderKeyHash> shader_map;
 		std::unordered_map<fs::path, std::set<GfxShaderKey>> file_shader_map;
+		//every permutation compiled in previous runs, one "source entry stage NAME=VALUE..." line each
+		std::set<std::string> shader_manifest;
+		Bool shader_manifest_dirty = false;
 
 		inline GfxShaderCompilerFlags GetShaderCompilerFlags()
 		{
@@ -623,13 +631,8 @@ namespace adria
 			return SM_6_7;
 		}
 
-		void CompileShader(GfxShaderKey const& shader)
+		GfxShaderDesc GetShaderDesc(GfxShaderKey const& shader)
 		{
-			if (!shader.IsValid())
-			{
-				return;
-			}
-
 			GfxShaderDesc shader_desc{};
 			shader_desc.entry_point = GetEntryPoint(shader);
 			shader_desc.stage = GetShaderStage(shader);
@@ -637,24 +640,164 @@ namespace adria
 			shader_desc.file = paths::ShaderDir + GetShaderSource(shader);
 			shader_desc.flags = GetShaderCompilerFlags();
 			shader_desc.defines = shader.GetDefines();
+			return shader_desc;
+		}
 
-			GfxShaderCompileOutput output;
-			Bool compile_result = GfxShaderCompiler::CompileShader(shader_desc, output);
-			ADRIA_ASSERT(compile_result);
-			if (!compile_result)
+		std::string GetShaderManifestEntry(GfxShaderKey const& shader)
+		{
+			std::string entry = GetShaderSource(shader) + " " + GetEntryPoint(shader) + " " + std::to_string((Uint32)GetShaderStage(shader));
+			for (GfxShaderDefine const& define : shader.GetDefines())
+			{
+				entry += " " + define.name + "=" + define.value;
+			}
+			return entry;
+		}
+		//shader ids are not stable across builds so entries are matched by source, entry point and stage
+		GfxShaderKey ParseShaderManifestEntry(std::string const& entry)
+		{
+			std::istringstream entry_stream(entry);
+			std::string source, entry_point;
+			Uint32 stage = 0;
+			if (!(entry_stream >> source >> entry_point >> stage))
+			{
+				return GfxShaderKey{};
+			}
+
+			GfxShaderKey shader{};
+			for (Uint32 i = ShaderID_Invalid + 1; i < ShaderID_Count; ++i)
+			{
+				ShaderID const shader_id = (ShaderID)i;
+				if (GetShaderSource(shader_id) == source && GetEntryPoint(shader_id) == entry_point && (Uint32)GetShaderStage(shader_id) == stage)
+				{
+					shader = shader_id;
+					break;
+				}
+			}
+			if (!shader.IsValid())
+			{
+				return shader;
+			}
+
+			std::string define;
+			Uint32 define_count = 0;
+			while (entry_stream >> define)
+			{
+				Usize const separator = define.find('=');
+				if (separator == std::string::npos || define_count++ >= GfxShaderKey::MaxDefines)
+				{
+					return GfxShaderKey{};
+				}
+				shader.AddDefine(define.substr(0, separator).c_str(), define.substr(separator + 1).c_str());
+			}
+			return shader;
+		}
+		void LoadShaderManifest()
+		{
+			std::ifstream manifest_file(paths::ShaderCacheDir + "ShaderManifest.txt");
+			std::string entry;
+			while (std::getline(manifest_file, entry))
+			{
+				if (!entry.empty())
+				{
+					shader_manifest.insert(entry);
+				}
+			}
+		}
+		void SaveShaderManifest()
+		{
+			if (!shader_manifest_dirty)
 			{
 				return;
 			}
+			std::ofstream manifest_file(paths::ShaderCacheDir + "ShaderManifest.txt");
+			for (std::string const& entry : shader_manifest)
+			{
+				manifest_file << entry << "\n";
+			}
+			shader_manifest_dirty = false;
+		}
+
+		void RegisterShader(GfxShaderKey const& shader, GfxShaderDesc const& shader_desc, GfxShaderCompileOutput& output)
+		{
 			shader_map[shader] = std::move(output.shader);
 			file_shader_map[fs::path(shader_desc.file)].insert(shader);
 			for (std::string const& include : output.includes)
 			{
 				file_shader_map[fs::path(include)].insert(shader);
 			}
+			if (shader_manifest.insert(GetShaderManifestEntry(shader)).second)
+			{
+				shader_manifest_dirty = true;
+			}
 			shader_desc.stage == GfxShaderStage::LIB ? library_recompiled_event.Broadcast(shader) : shader_recompiled_event.Broadcast(shader);
 		}
-		void OnShaderFileChanged(std::string const& filename)
+
+		void CompileShader(GfxShaderKey const& shader)
+		{
+			if (!shader.IsValid())
+			{
+				return;
+			}
+
+			GfxShaderDesc shader_desc = GetShaderDesc(shader);
+			GfxShaderCompileOutput output;
+			Bool compile_result = GfxShaderCompiler::CompileShader(shader_desc, output);
+			ADRIA_ASSERT(compile_result);
+			if (!compile_result)
+			{
+				return;
+			}
+			RegisterShader(shader, shader_desc, output);
+		}
+		//compiles or loads from the cache every permutation used in previous runs on all worker threads
+		void CompileShaderManifest()
 		{
+			Timer<> compile_timer;
+			std::vector<GfxShaderKey> shaders;
+			shaders.reserve(shader_manifest.size());
+			for (std::string const& entry : shader_manifest)
+			{
+				GfxShaderKey const shader = ParseShaderManifestEntry(entry);
+				if (shader.IsValid())
+				{
+					shaders.push_back(shader);
+				}
+			}
+			//entries of removed or renamed shaders are dropped on the next save
+			if (shaders.size() != shader_manifest.size())
+			{
+				shader_manifest.clear();
+				shader_manifest_dirty = true;
+			}
+
+			std::vector<GfxShaderDesc> shader_descs(shaders.size());
+			std::vector<GfxShaderCompileOutput> outputs(shaders.size());
+			std::unique_ptr<Bool[]> compile_results(new Bool[shaders.size()]);
+			g_ThreadPool.ParallelFor(0, shaders.size(), 1, [&](Uint64 i)
+				{
+					shader_descs[i] = GetShaderDesc(shaders[i]);
+					compile_results[i] = GfxShaderCompiler::CompileShader(shader_descs[i], outputs[i]);
+				});
+
+			Uint64 compiled_count = 0;
+			for (Uint64 i = 0; i < shaders.size(); ++i)
+			{
+				if (compile_results[i])
+				{
+					RegisterShader(shaders[i], shader_descs[i], outputs[i]);
+					++compiled_count;
+				}
+			}
+			GfxShaderCompiler::SaveCache();
+			ADRIA_LOG(INFO, "%llu shader permutations from the manifest ready in %.2f s", compiled_count, compile_timer.ElapsedInSeconds());
+		}
+		void OnShaderFileChanged(std::string const& filename, FileStatus status)
+		{
+			if (status == FileStatus::Deleted)
+			{
+				return;
+			}
+			GfxShaderCompiler::InvalidateCacheDependencies();
 			for (GfxShaderKey const& shader_key : file_shader_map[fs::path(filename)])
 			{
 				CompileShader(shader_key);
@@ -673,20 +816,33 @@ namespace adria
 			OptimizeShaders->Set(false);
 			ShaderDebugInfo->Set(true);
 		}
+		LoadShaderManifest();
+		CompileShaderManifest();
 	}
 	void ShaderManager::Destroy()
 	{
+		SaveShaderManifest();
 		file_watcher = nullptr;
 		shader_map.clear();
 	}
 	void ShaderManager::CheckIfShadersHaveChanged()
 	{
-		file_watcher->CheckWatchedFiles();
+		if (file_watcher)
+		{
+			file_watcher->CheckWatchedFiles();
+		}
+	}
+	Bool ShaderManager::HaveShadersChanged()
+	{
+		return ShaderHotReload.Get() && file_watcher && file_watcher->HasPendingChanges();
 	}
 
 	GfxShader const& ShaderManager::GetGfxShader(GfxShaderKey const& shader_key)
 	{
-		if (shader_map.contains(shader_key)) return shader_map[shader_key];
+		if (auto it = shader_map.find(shader_key); it != shader_map.end())
+		{
+			return it->second;
+		}
 		CompileShader(shader_key);
 		return shader_map[shader_key];
 	}
@@ -141,6 +141,7 @@ namespace adria
 		static void Initialize();
 		static void Destroy();
 		static void CheckIfShadersHaveChanged();
+		static Bool HaveShadersChanged();
 
 		static ShaderRecompiledEvent& GetShaderRecompiledEvent();
 		static LibraryRecompiledEvent& GetLibraryRecompiledEvent();
@@ -97,6 +97,9 @@ namespace adria
 		Uint32 meshlet_vertices_offset;
 		Uint32 meshlet_triangles_offset;
 		Uint32 meshlet_count;
+		Uint32 flags;
+		Vector3 position_center;
+		Vector3 position_extents;
 	};
 
 	struct MaterialGPU
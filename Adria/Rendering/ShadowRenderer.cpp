@@ -13,6 +13,8 @@
 #include "RenderGraph/RenderGraph.h"
 #include "Editor/GUICommand.h"
 #include "Core/ConsoleManager.h"
+#include "Utilities/ThreadPool.h"
+#include "tracy/Tracy.hpp"
 
 using namespace DirectX;
 
@@ -476,7 +478,7 @@ namespace adria
 							{
 								GfxCommandList* cmd_list = context.GetCommandList();
 								cmd_list->SetRootCBV(0, frame_data.frame_cbuffer_address);
-								ShadowMapPass_Common(cmd_list, light.type, light_index, light_matrix_index, i);
+								ShadowMapPass_Common(cmd_list, light_index, light_matrix_index, i);
 							}, RGPassType::Graphics);
 
 						shadow_rendered_event.Broadcast(RG_NAME_IDX(ShadowMap, light_matrix_index + i));
@@ -496,7 +498,7 @@ namespace adria
 						{
 							GfxCommandList* cmd_list = context.GetCommandList();
 							cmd_list->SetRootCBV(0, frame_data.frame_cbuffer_address);
-							ShadowMapPass_Common(cmd_list, light.type, light_index, light_matrix_index, 0);
+							ShadowMapPass_Common(cmd_list, light_index, light_matrix_index, 0);
 						}, RGPassType::Graphics);
 
 					shadow_rendered_event.Broadcast(RG_NAME_IDX(ShadowMap, light.shadow_matrix_index));
@@ -518,7 +520,7 @@ namespace adria
 						{
 							GfxCommandList* cmd_list = context.GetCommandList();
 							cmd_list->SetRootCBV(0, frame_data.frame_cbuffer_address);
-							ShadowMapPass_Common(cmd_list, light.type, light_index, light_matrix_index, i);
+							ShadowMapPass_Common(cmd_list, light_index, light_matrix_index, i);
 						}, RGPassType::Graphics);
 
 					shadow_rendered_event.Broadcast(RG_NAME_IDX(ShadowMap, light.shadow_matrix_index + i));
@@ -538,7 +540,7 @@ namespace adria
 					{
 						GfxCommandList* cmd_list = context.GetCommandList();
 						cmd_list->SetRootCBV(0, frame_data.frame_cbuffer_address);
-						ShadowMapPass_Common(cmd_list, light.type, light_index, light_matrix_index, 0);
+						ShadowMapPass_Common(cmd_list, light_index, light_matrix_index, 0);
 					}, RGPassType::Graphics);
 
 				shadow_rendered_event.Broadcast(RG_NAME_IDX(ShadowMap, light_matrix_index));
@@ -590,7 +592,91 @@ namespace adria
 		shadow_psos = std::make_unique<GfxGraphicsPipelineStatePermutations>(gfx, gfx_pso_desc);
 	}
 
-	void ShadowRenderer::ShadowMapPass_Common(GfxCommandList* cmd_list, LightType light_type, Uint64 light_index, Uint64 matrix_index, Uint64 matrix_offset)
+	void ShadowRenderer::CullShadowCasters()
+	{
+		ZoneScopedN("ShadowRenderer::CullShadowCasters");
+		opaque_casters.clear();
+		masked_casters.clear();
+		for (entt::entity batch_entity : reg.view<Batch>())
+		{
+			Batch const& batch = reg.get<Batch>(batch_entity);
+			ShadowCaster caster{ .bounding_box = batch.bounding_box, .submesh = batch.submesh, .instance_id = batch.instance_id };
+			if (batch.alpha_mode == MaterialAlphaMode::Opaque)
+			{
+				opaque_casters.push_back(caster);
+			}
+			else
+			{
+				masked_casters.push_back(caster);
+			}
+		}
+
+		//sorted once per frame, so every view gets its surviving casters grouped by submesh and can merge consecutive instances while culling
+		auto CasterOrder = [](ShadowCaster const& lhs, ShadowCaster const& rhs)
+			{
+				return lhs.submesh != rhs.submesh ? lhs.submesh < rhs.submesh : lhs.instance_id < rhs.instance_id;
+			};
+		std::sort(opaque_casters.begin(), opaque_casters.end(), CasterOrder);
+		std::sort(masked_casters.begin(), masked_casters.end(), CasterOrder);
+		auto FillCasterBounds = [](std::vector<ShadowCaster> const& casters, AABBStreams& caster_bounds)
+			{
+				caster_bounds.Resize(casters.size());
+				for (Uint64 i = 0; i < casters.size(); ++i)
+				{
+					caster_bounds.Set(i, casters[i].bounding_box);
+				}
+			};
+		FillCasterBounds(opaque_casters, opaque_caster_bounds);
+		FillCasterBounds(masked_casters, masked_caster_bounds);
+
+		Uint64 const view_count = bounding_objects.size();
+		view_draws.resize(view_count);
+		g_ThreadPool.ParallelFor(0, view_count, 1, [this](Uint64 view_index) { CullShadowView(view_index); });
+
+		Uint64 draw_count = 0;
+		for (ShadowViewDraws const& draws : view_draws)
+		{
+			draw_count += draws.opaque_draws.size() + draws.masked_draws.size();
+		}
+		TracyPlot("Shadow Views", (Int64)view_count);
+		TracyPlot("Shadow Casters", (Int64)(opaque_casters.size() + masked_casters.size()));
+		TracyPlot("Shadow Draws", (Int64)draw_count);
+	}
+
+	void ShadowRenderer::CullShadowView(Uint64 view_index)
+	{
+		//cascades and directional maps are world space boxes, their planes give the exact overlap test, the frustum plane test of spot and point views is conservative
+		BoundingObject const& bounding_object = bounding_objects[view_index];
+		FrustumPlanes const planes = bounding_object.type == BoundingObject::Box ? GetBoxPlanes(bounding_object.GetBox()) : GetFrustumPlanes(bounding_object.GetFrustum());
+
+		ShadowViewDraws& view = view_draws[view_index];
+		auto CullCasters = [&](std::vector<ShadowCaster> const& casters, AABBStreams const& caster_bounds, std::vector<ShadowDraw>& draws)
+		{
+			draws.clear();
+			view.visible_casters.clear();
+			view.caster_visibility.resize((casters.size() + 63) / 64);
+			CullAABBs(planes, caster_bounds, 0, casters.size(), view.visible_casters, view.caster_visibility.data());
+			for (Uint32 caster_index : view.visible_casters)
+			{
+				ShadowCaster const& caster = casters[caster_index];
+				//instances of the same submesh with consecutive instance ids only differ in the instance id, so they are drawn instanced
+				if (!draws.empty())
+				{
+					ShadowDraw& last_draw = draws.back();
+					if (last_draw.submesh == caster.submesh && last_draw.instance_id + last_draw.instance_count == caster.instance_id)
+					{
+						++last_draw.instance_count;
+						continue;
+					}
+				}
+				draws.push_back(ShadowDraw{ .submesh = caster.submesh, .instance_id = caster.instance_id, .instance_count = 1 });
+			}
+		};
+		CullCasters(opaque_casters, opaque_caster_bounds, view.opaque_draws);
+		CullCasters(masked_casters, masked_caster_bounds, view.masked_draws);
+	}
+
+	void ShadowRenderer::ShadowMapPass_Common(GfxCommandList* cmd_list, Uint64 light_index, Uint64 matrix_index, Uint64 matrix_offset)
 	{
 		struct ShadowConstants
 		{
@@ -601,67 +687,43 @@ namespace adria
 			.light_index = (Uint32)light_index,
 			.matrix_offset = (Uint32)matrix_offset
 		};
-		auto view = reg.view<Batch>();
-		std::vector<Batch*> masked_batches, opaque_batches;
-		for (entt::entity batch_entity : reg.view<Batch>())
+
+		auto DrawShadowCasters = [&](std::vector<ShadowDraw> const& draws, Bool masked)
 		{
-			Batch& batch = reg.get<Batch>(batch_entity);
-			if (batch.alpha_mode == MaterialAlphaMode::Opaque)
+			if (draws.empty())
 			{
-				opaque_batches.push_back(&batch);
+				return;
 			}
-			else
-			{
-				masked_batches.push_back(&batch);
-			}
-		}
-
-		auto DrawBatch = [&](GfxCommandList* cmd_list, Bool masked_batch)
-		{
-			std::vector<Batch*>& batches = masked_batch ? masked_batches : opaque_batches;
-			if (masked_batch)
+			if (masked)
 			{
 				shadow_psos->AddDefine("TRANSPARENT", "1");
 			}
 			GfxPipelineState const* pso = shadow_psos->Get();
 			cmd_list->SetRootConstants(1, constants);
 			cmd_list->SetPipelineState(pso);
-			for (Batch* batch : batches)
-			{
-				Bool skip_batch = false;
-				switch (light_type)
-				{
-				case LightType::Directional:
-					ADRIA_ASSERT(bounding_objects[matrix_index].type == BoundingObject::Box);
-					skip_batch = !bounding_objects[matrix_index].GetBox().Intersects(batch->bounding_box);
-					break;
-				case LightType::Spot:
-				case LightType::Point:
-					ADRIA_ASSERT(bounding_objects[matrix_index].type == BoundingObject::Frustum);
-					skip_batch = !bounding_objects[matrix_index].GetFrustum().Intersects(batch->bounding_box);
-					break;
-				default:
-					ADRIA_ASSERT(false);
-				}
-				if (skip_batch)
-				{
-					continue;
-				}
 
+			SubMeshGPU const* current_submesh = nullptr;
+			for (ShadowDraw const& draw : draws)
+			{
 				struct ModelConstants
 				{
 					Uint32 instance_id;
-				} model_constants{ .instance_id = batch->instance_id };
+				} model_constants{ .instance_id = draw.instance_id };
 				cmd_list->SetRootCBV(2, model_constants);
-				GfxIndexBufferView ibv(batch->submesh->buffer_address + batch->submesh->indices_offset, batch->submesh->indices_count);
-				cmd_list->SetPrimitiveTopology(batch->submesh->topology);
-				cmd_list->SetIndexBuffer(&ibv);
-				cmd_list->DrawIndexed(batch->submesh->indices_count);
+				if (draw.submesh != current_submesh)
+				{
+					GfxIndexBufferView ibv(draw.submesh->buffer_address + draw.submesh->indices_offset, draw.submesh->indices_count, draw.submesh->GetIndexFormat());
+					cmd_list->SetPrimitiveTopology(draw.submesh->topology);
+					cmd_list->SetIndexBuffer(&ibv);
+					current_submesh = draw.submesh;
+				}
+				cmd_list->DrawIndexed(draw.submesh->indices_count, draw.instance_count);
 			}
 		};
 
-		DrawBatch(cmd_list, false);
-		DrawBatch(cmd_list, true);
+		ShadowViewDraws const& draws = view_draws[matrix_index + matrix_offset];
+		DrawShadowCasters(draws.opaque_draws, false);
+		DrawShadowCasters(draws.masked_draws, true);
 	}
 	std::array<Matrix, ShadowRenderer::SHADOW_CASCADE_COUNT> ShadowRenderer::RecalculateProjectionMatrices(Camera const& camera, Float split_lambda, std::array<Float, SHADOW_CASCADE_COUNT>& split_distances)
 	{
@@ -3,6 +3,7 @@
 #include "Graphics/GfxDefines.h"
 #include "Graphics/GfxDescriptor.h"
 #include "Graphics/GfxPipelineStateFwd.h"
+#include "Math/FrustumCulling.h"
 #include "Utilities/Delegate.h"
 
 namespace adria
@@ -14,6 +15,7 @@ namespace adria
 	class RenderGraph;
 	class Camera;
 	struct FrameCBuffer;
+	struct SubMeshGPU;
 	enum class LightType : Int32;
 
 	struct BoundingObject
@@ -25,7 +27,7 @@ namespace adria
 		} type = Box;
 
 		BoundingObject(BoundingBox const& box) : data(box) {}
-		BoundingObject(BoundingFrustum const& frustum) : data(frustum) {}
+		BoundingObject(BoundingFrustum const& frustum) : type(Frustum), data(frustum) {}
 
 		BoundingBox const& GetBox() const
 		{
@@ -43,6 +45,7 @@ namespace adria
 
 	class ShadowRenderer
 	{
+		friend struct ShadowRendererTestAccess;
 		static constexpr Uint32 SHADOW_MAP_SIZE = 1024;
 		static constexpr Uint32 SHADOW_CASCADE_MAP_SIZE = 2048;
 		static constexpr Uint32 SHADOW_CUBE_SIZE = 512;
@@ -62,6 +65,7 @@ namespace adria
 			}
 		}
 		void SetupShadows(Camera const* camera);
+		void CullShadowCasters();
 
 		void AddShadowMapPasses(RenderGraph& rg);
 		void AddRayTracingShadowPasses(RenderGraph& rg);
@@ -89,13 +93,40 @@ namespace adria
 		Int32						   light_matrices_gpu_index = -1;
 
 		std::vector<BoundingObject>						bounding_objects;
+
+		//batches gathered once per frame and the draws that survive culling against each shadow view, indexed like bounding_objects
+		struct ShadowCaster
+		{
+			BoundingBox bounding_box;
+			SubMeshGPU const* submesh;
+			Uint32 instance_id;
+		};
+		struct ShadowDraw
+		{
+			SubMeshGPU const* submesh;
+			Uint32 instance_id;
+			Uint32 instance_count;
+		};
+		struct ShadowViewDraws
+		{
+			std::vector<ShadowDraw> opaque_draws;
+			std::vector<ShadowDraw> masked_draws;
+			std::vector<Uint32> visible_casters;
+			std::vector<Uint64> caster_visibility;
+		};
+		std::vector<ShadowCaster>						opaque_casters;
+		std::vector<ShadowCaster>						masked_casters;
+		AABBStreams										opaque_caster_bounds;
+		AABBStreams										masked_caster_bounds;
+		std::vector<ShadowViewDraws>					view_draws;
 		std::array<Float, SHADOW_CASCADE_COUNT>		    split_distances{};
 
 		ShadowTextureRenderedEvent shadow_rendered_event;
 
 	private:
 		void CreatePSOs();
-		void ShadowMapPass_Common(GfxCommandList* cmd_list, LightType light_type, Uint64 light_index, Uint64 matrix_index, Uint64 matrix_offset);
+		void CullShadowView(Uint64 view_index);
+		void ShadowMapPass_Common(GfxCommandList* cmd_list, Uint64 light_index, Uint64 matrix_index, Uint64 matrix_offset);
 		static std::array<Matrix, SHADOW_CASCADE_COUNT> RecalculateProjectionMatrices(Camera const& camera, Float split_lambda, std::array<Float, SHADOW_CASCADE_COUNT>& split_distances);
 	};
 }
\ No newline at end of file
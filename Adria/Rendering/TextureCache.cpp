@@ -0,0 +1,166 @@
+#include <cinttypes>
+#include "TextureCache.h"
+#include "Core/Paths.h"
+#include "Utilities/Image.h"
+#include "Utilities/PathHelpers.h"
+#include "Utilities/Hash.h"
+#include "tracy/Tracy.hpp"
+
+namespace fs = std::filesystem;
+
+namespace adria
+{
+	ADRIA_LOG_CHANNEL(Scene);
+
+	static constexpr Uint64 CookedTextureMagic = 0x5845544d41495244; //"DRIAMTEX"
+	static constexpr Uint64 CookedTextureVersion = 1;
+
+	namespace
+	{
+		struct CookedTextureHeader
+		{
+			Uint64 magic;
+			Uint64 version;
+			Uint64 params_hash;
+			Uint64 source_size;
+			Int64  source_last_write_time;
+			Uint32 format;
+			Uint32 width;
+			Uint32 height;
+			Uint32 mip_levels;
+			Uint64 data_size;
+		};
+
+		Bool NeedsCooking(std::string const& path, TextureCookParams const& params)
+		{
+			if (!params.generate_mips && params.compressed_format == GfxFormat::UNKNOWN)
+			{
+				return false;
+			}
+			std::string extension = GetExtension(path);
+			std::transform(extension.begin(), extension.end(), extension.begin(), [](Char c) { return (Char)std::tolower(c); });
+			return extension != ".dds";
+		}
+
+		Uint64 GetTextureCookParamsHash(std::string const& path, TextureCookParams const& params)
+		{
+			HashState state;
+			state.Combine(CookedTextureVersion);
+			state.Combine(crc64(path.c_str(), path.size()));
+			state.Combine((Uint64)params.srgb);
+			state.Combine((Uint64)params.generate_mips);
+			state.Combine(std::bit_cast<Uint32>(params.alpha_cutoff));
+			state.Combine((Uint64)params.compressed_format);
+			return state;
+		}
+
+		std::string GetTextureCachePath(std::string const& path, Uint64 params_hash)
+		{
+			Char cache_path[512];
+			snprintf(cache_path, sizeof(cache_path), "%s%s_%" PRIx64 ".adtex", paths::TextureCacheDir.c_str(), GetFilenameWithoutExtension(path).c_str(), params_hash);
+			return cache_path;
+		}
+
+		std::unique_ptr<Image> LoadCachedTexture(std::string const& cache_path, Uint64 params_hash, Uint64 source_size, Int64 source_last_write_time)
+		{
+			FILE* cache_file = fopen(cache_path.c_str(), "rb");
+			if (!cache_file)
+			{
+				return nullptr;
+			}
+
+			std::unique_ptr<Image> img = nullptr;
+			CookedTextureHeader header{};
+			if (fread(&header, sizeof(header), 1, cache_file) == 1 &&
+				header.magic == CookedTextureMagic && header.version == CookedTextureVersion && header.params_hash == params_hash &&
+				header.source_size == source_size && header.source_last_write_time == source_last_write_time)
+			{
+				GfxFormat const format = (GfxFormat)header.format;
+				if (header.data_size == GetTextureByteSize(format, header.width, header.height, 1, header.mip_levels))
+				{
+					std::vector<Uint8> pixels(header.data_size);
+					if (fread(pixels.data(), 1, pixels.size(), cache_file) == pixels.size())
+					{
+						img = std::make_unique<Image>(format, header.width, header.height, header.mip_levels, std::move(pixels));
+					}
+				}
+			}
+			fclose(cache_file);
+			return img;
+		}
+
+		void SaveCachedTexture(std::string const& cache_path, Image const& img, Uint64 params_hash, Uint64 source_size, Int64 source_last_write_time)
+		{
+			CookedTextureHeader header{};
+			header.magic = CookedTextureMagic;
+			header.version = CookedTextureVersion;
+			header.params_hash = params_hash;
+			header.source_size = source_size;
+			header.source_last_write_time = source_last_write_time;
+			header.format = (Uint32)img.Format();
+			header.width = img.Width();
+			header.height = img.Height();
+			header.mip_levels = img.MipLevels();
+			header.data_size = img.DataSize();
+
+			std::error_code ec;
+			fs::create_directories(paths::TextureCacheDir, ec);
+
+			//same as the model cache, a crash never leaves a truncated cache file behind
+			std::string const temporary_path = cache_path + ".tmp";
+			FILE* cache_file = fopen(temporary_path.c_str(), "wb");
+			if (!cache_file)
+			{
+				ADRIA_LOG(WARNING, "Failed to create texture cache file '%s'", temporary_path.c_str());
+				return;
+			}
+			Bool const written = fwrite(&header, sizeof(header), 1, cache_file) == 1 &&
+								 fwrite(img.Data(), 1, img.DataSize(), cache_file) == img.DataSize();
+			fclose(cache_file);
+			if (!written)
+			{
+				fs::remove(temporary_path, ec);
+				return;
+			}
+			fs::rename(temporary_path, cache_path, ec);
+		}
+	}
+
+	std::unique_ptr<Image> LoadCookedTexture(std::string const& path, TextureCookParams const& params)
+	{
+		ZoneScopedN("LoadCookedTexture");
+		if (!NeedsCooking(path, params))
+		{
+			return std::make_unique<Image>(path);
+		}
+
+		std::error_code ec;
+		Uint64 const source_size = fs::file_size(path, ec);
+		Int64 const source_last_write_time = ec ? 0 : GetFileLastWriteTime(path);
+		Uint64 const params_hash = GetTextureCookParamsHash(path, params);
+		std::string const cache_path = GetTextureCachePath(path, params_hash);
+		if (!ec)
+		{
+			if (std::unique_ptr<Image> cached_img = LoadCachedTexture(cache_path, params_hash, source_size, source_last_write_time))
+			{
+				return cached_img;
+			}
+		}
+
+		std::unique_ptr<Image> img = std::make_unique<Image>(path);
+		GfxFormat const source_format = img->Format();
+		if (params.generate_mips)
+		{
+			img->GenerateMips(params.srgb, params.alpha_cutoff);
+		}
+		if (params.compressed_format != GfxFormat::UNKNOWN)
+		{
+			img->Compress(params.compressed_format);
+		}
+		if (!ec && (img->MipLevels() > 1 || img->Format() != source_format))
+		{
+			SaveCachedTexture(cache_path, *img, params_hash, source_size, source_last_write_time);
+		}
+		return img;
+	}
+}
@@ -0,0 +1,19 @@
+#pragma once
+#include "Graphics/GfxFormat.h"
+
+namespace adria
+{
+	class Image;
+
+	struct TextureCookParams
+	{
+		Bool srgb = false;
+		Bool generate_mips = false;
+		Float alpha_cutoff = 0.0f;
+		GfxFormat compressed_format = GfxFormat::UNKNOWN;
+	};
+
+	//loads the image and applies the cook steps, results that differ from the source are kept in the texture cache
+	//and reused as long as the source file is unchanged. Safe to call from worker threads
+	std::unique_ptr<Image> LoadCookedTexture(std::string const& path, TextureCookParams const& params);
+}
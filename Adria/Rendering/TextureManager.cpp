@@ -3,13 +3,29 @@
 #include "Graphics/GfxDevice.h"
 #include "Graphics/GfxCommon.h"
 #include "Graphics/GfxCommandList.h"
+#include "Graphics/GfxCommandQueue.h"
+#include "Graphics/GfxBuffer.h"
+#include "Graphics/GfxFence.h"
 #include "Graphics/GfxShaderCompiler.h"
+#include "Core/ConsoleManager.h"
 #include "Utilities/Image.h"
 #include "Utilities/PathHelpers.h"
+#include "Utilities/ThreadPool.h"
+#include "Utilities/MemoryTracker.h"
+#include "Utilities/Align.h"
+#include "tracy/Tracy.hpp"
 
 
 namespace adria
 {
+	static TAutoConsoleVariable<Int> TextureStreamingUploadBudget("r.TextureStreaming.UploadBudget", 64, "Megabytes of staging memory streamed textures can take per frame, at least one texture is uploaded every frame");
+	static TAutoConsoleVariable<Bool> TextureStreamingCompression("r.TextureStreaming.Compression", true, "Block compress streamed non-DDS textures in the format chosen for their material slot");
+
+	namespace
+	{
+		//placement alignment of subresources in a buffer a texture is copied from (D3D12_TEXTURE_DATA_PLACEMENT_ALIGNMENT)
+		constexpr Uint64 TextureUploadPlacementAlignment = 512;
+	}
 
     TextureManager::TextureManager() {}
     TextureManager::~TextureManager() = default;
@@ -17,11 +33,16 @@ namespace adria
 	void TextureManager::Initialize(GfxDevice* _gfx)
 	{
         gfx = _gfx;
+		upload_fence = gfx->CreateFence("Texture Upload Fence");
 	}
 
 	void TextureManager::Clear()
 	{
+		//the copy queue may still be writing textures that are about to be destroyed
+		WaitForAllUploads();
 		handle = TEXTURE_MANAGER_START_HANDLE;
+		streaming_textures.clear();
+		streaming_placeholders.clear();
 		texture_srv_map.clear();
 		texture_map.clear();
 		loaded_textures.clear();
@@ -31,6 +52,7 @@ namespace adria
 	void TextureManager::Shutdown()
 	{
 		Clear();
+		upload_fence.reset();
 		gfx = nullptr;
 	}
 
@@ -42,50 +64,90 @@ namespace adria
 			TextureHandle texture_handle = handle++;
             loaded_textures.insert({ texture_name, texture_handle });
             Image img(texture_name);
+			CreateTexture(texture_handle, img, srgb);
+			return texture_handle;
+        }
+	    else
+		{
+			FinishStreaming(it->second);
+			return it->second;
+		}
+    }
+
+	TextureHandle TextureManager::StreamTexture(std::string_view path, TextureHandle placeholder, TextureCookParams cook_params)
+	{
+		cook_params.generate_mips = enable_mipmaps;
+		if (!TextureStreamingCompression.Get())
+		{
+			cook_params.compressed_format = GfxFormat::UNKNOWN;
+		}
+
+		//the same file can be used by slots that compress it differently, e.g. clear coat and its roughness
+		std::string texture_name = NormalizePath(path);
+		std::string texture_key = texture_name;
+		if (cook_params.compressed_format != GfxFormat::UNKNOWN)
+		{
+			texture_key += '|';
+			texture_key += GfxFormatToString(cook_params.compressed_format);
+		}
+		if (auto it = loaded_textures.find(texture_key); it != loaded_textures.end())
+		{
+			return it->second;
+		}
+
+		TextureHandle texture_handle = handle++;
+		loaded_textures.insert({ std::move(texture_key), texture_handle });
+		streaming_placeholders[texture_handle] = placeholder;
 
-			GfxTextureDesc desc{};
-			desc.type = img.Depth() > 1 ? GfxTextureType_3D : GfxTextureType_2D;
-			desc.misc_flags = GfxTextureMiscFlag::None;
-			desc.width = img.Width();
-			desc.height = img.Height();
-			desc.array_size = img.IsCubemap() ? 6 : 1;
-			desc.depth = img.Depth();
-			desc.bind_flags = GfxBindFlag::ShaderResource;
-			desc.format = img.Format();
-			desc.initial_state = GfxResourceState::AllSRV; 
-			desc.heap_type = GfxResourceUsage::Default;
-			desc.mip_levels = img.MipLevels();
-            desc.misc_flags = img.IsCubemap() ? GfxTextureMiscFlag::TextureCube : GfxTextureMiscFlag::None;
-			if (srgb)
+		StreamingTexture& streaming_texture = streaming_textures.emplace_back();
+		streaming_texture.handle = texture_handle;
+		streaming_texture.srgb = cook_params.srgb;
+		streaming_texture.image = g_ThreadPool.Submit([](std::string const& texture_name, TextureCookParams const& cook_params)
 			{
-				desc.misc_flags |= GfxTextureMiscFlag::SRGB;
-			}
+				return LoadCookedTexture(texture_name, cook_params);
+			}, std::move(texture_name), cook_params);
+		return texture_handle;
+	}
+
+	Bool TextureManager::Update()
+	{
+		ReleaseCompletedUploads();
+		if (streaming_textures.empty())
+		{
+			return false;
+		}
+		ZoneScopedN("TextureManager::Update");
 
-            std::vector<GfxTextureSubData> tex_data;
-			Image const* curr_img = &img;
-			while (curr_img)
+		//every upload gets its own staging buffer that lives until the copy queue is done with it, the budget bounds how much staging one frame adds
+		Uint64 const upload_budget = (Uint64)std::max(TextureStreamingUploadBudget.Get(), 0) << 20;
+		Uint64 upload_size = 0;
+		Bool any_resident = false;
+		for (auto it = streaming_textures.begin(); it != streaming_textures.end() && (!any_resident || upload_size < upload_budget);)
+		{
+			if (it->image.wait_for(std::chrono::seconds(0)) != std::future_status::ready)
 			{
-				for (Uint32 i = 0; i < desc.mip_levels; ++i)
-				{
-                    GfxTextureSubData& data = tex_data.emplace_back();
-					data.data = curr_img->MipData(i);
-					data.row_pitch = GetRowPitch(curr_img->Format(), desc.width, i);
-					data.slice_pitch = GetSlicePitch(img.Format(), desc.width, desc.height, i);
-				}
-                curr_img = curr_img->NextImage();
+				++it;
+				continue;
 			}
+			std::unique_ptr<Image> img = it->image.get();
+			upload_size += CreateTexture(it->handle, *img, it->srgb);
+			streaming_placeholders.erase(it->handle);
+			it = streaming_textures.erase(it);
+			any_resident = true;
+		}
+		TracyPlot("Texture Streaming Upload Size", (Int64)upload_size);
+		TracyPlot("Texture Streaming Pending", (Int64)streaming_textures.size());
+		return any_resident;
+	}
 
-			GfxTextureData init_data{};
-			init_data.sub_data = tex_data.data();
-			init_data.sub_count = (Uint32)tex_data.size();
-            std::unique_ptr<GfxTexture> tex = gfx->CreateTexture(desc, init_data);
-
-            texture_map[texture_handle] = std::move(tex);
-			CreateViewForTexture(texture_handle);
-			return texture_handle;
-        }
-	    else return it->second;
-    }
+	void TextureManager::ReleaseCompletedUploads()
+	{
+		while (!pending_uploads.empty() && upload_fence->IsCompleted(pending_uploads.front().fence_value))
+		{
+			MemoryTracker::Free(MemoryCategory::TextureStaging, pending_uploads.front().staging_buffer->GetSize());
+			pending_uploads.pop();
+		}
+	}
 
 	TextureHandle TextureManager::LoadCubemap(std::array<std::string, 6> const& cubemap_textures)
 	{
@@ -131,6 +193,10 @@ namespace adria
 		{
 			return GfxCommon::GetCommonViewBindlessIndex(static_cast<GfxCommonViewType>(handle));
 		}
+		if (auto it = streaming_placeholders.find(handle); it != streaming_placeholders.end())
+		{
+			return GetBindlessIndex(it->second);
+		}
 		GfxDescriptor descriptor = GetDescriptor(handle);
 		return descriptor.IsValid() ? gfx->GetBindlessDescriptorIndex(descriptor) : Uint32(-1);
 	}
@@ -179,6 +245,125 @@ namespace adria
         is_scene_initialized = true;
 	}
 
+	Uint64 TextureManager::CreateTexture(TextureHandle texture_handle, Image const& img, Bool srgb)
+	{
+		GfxTextureDesc desc{};
+		desc.type = img.Depth() > 1 ? GfxTextureType_3D : GfxTextureType_2D;
+		desc.misc_flags = GfxTextureMiscFlag::None;
+		desc.width = img.Width();
+		desc.height = img.Height();
+		desc.array_size = img.IsCubemap() ? 6 : 1;
+		desc.depth = img.Depth();
+		desc.bind_flags = GfxBindFlag::ShaderResource;
+		desc.format = img.Format();
+		//the copy queue can only access textures in the common state, shader reads on the graphics queue promote them from it
+		desc.initial_state = GfxResourceState::Common;
+		desc.heap_type = GfxResourceUsage::Default;
+		desc.mip_levels = img.MipLevels();
+		desc.misc_flags = img.IsCubemap() ? GfxTextureMiscFlag::TextureCube : GfxTextureMiscFlag::None;
+		if (srgb)
+		{
+			desc.misc_flags |= GfxTextureMiscFlag::SRGB;
+		}
+
+		std::unique_ptr<GfxTexture> tex = gfx->CreateTexture(desc);
+		Uint64 const staging_size = UploadTexture(*tex, img);
+		texture_map[texture_handle] = std::move(tex);
+		CreateViewForTexture(texture_handle);
+		return staging_size;
+	}
+
+	Uint64 TextureManager::UploadTexture(GfxTexture& texture, Image const& img)
+	{
+		GfxTextureDesc const& desc = texture.GetDesc();
+		Uint32 const block_size = GetGfxFormatBlockSize(desc.format);
+
+		//subresources are laid out the way the copy reads them: aligned offsets, the texture's row pitch and one block row per row
+		struct SubresourceUpload
+		{
+			Uint8 const* data;
+			Uint32 mip_level;
+			Uint32 array_slice;
+			Uint64 offset;
+			Uint32 row_count;
+			Uint32 depth;
+		};
+		std::vector<SubresourceUpload> subresources;
+		Uint64 staging_size = 0;
+		Uint32 array_slice = 0;
+		for (Image const* curr_img = &img; curr_img; curr_img = curr_img->NextImage(), ++array_slice)
+		{
+			for (Uint32 mip = 0; mip < desc.mip_levels; ++mip)
+			{
+				SubresourceUpload& subresource = subresources.emplace_back();
+				subresource.data = curr_img->MipData<Uint8>(mip);
+				subresource.mip_level = mip;
+				subresource.array_slice = array_slice;
+				subresource.offset = AlignUp(staging_size, TextureUploadPlacementAlignment);
+				subresource.row_count = std::max(1u, DivideAndRoundUp(desc.height >> mip, block_size));
+				subresource.depth = std::max(1u, desc.depth >> mip);
+				staging_size = subresource.offset + (Uint64)texture.GetRowPitch(mip) * subresource.row_count * subresource.depth;
+			}
+		}
+
+		GfxBufferDesc staging_desc{};
+		staging_desc.size = staging_size;
+		staging_desc.resource_usage = GfxResourceUsage::Upload;
+
+		PendingUpload& upload = pending_uploads.emplace();
+		upload.staging_buffer = gfx->CreateBuffer(staging_desc);
+		upload.cmd_list = gfx->CreateCommandList(GfxCommandListType::Copy);
+		upload.fence_value = ++upload_fence_value;
+		MemoryTracker::Allocate(MemoryCategory::TextureStaging, staging_size);
+
+		Uint8* staging_data = upload.staging_buffer->GetMappedData<Uint8>();
+		upload.cmd_list->Begin();
+		for (SubresourceUpload const& subresource : subresources)
+		{
+			Uint64 const src_row_pitch = GetRowPitch(desc.format, desc.width, subresource.mip_level);
+			Uint64 const src_slice_pitch = GetSlicePitch(desc.format, desc.width, desc.height, subresource.mip_level);
+			Uint64 const dst_row_pitch = texture.GetRowPitch(subresource.mip_level);
+			for (Uint32 z = 0; z < subresource.depth; ++z)
+			{
+				for (Uint32 row = 0; row < subresource.row_count; ++row)
+				{
+					memcpy(staging_data + subresource.offset + (z * subresource.row_count + row) * dst_row_pitch,
+						   subresource.data + z * src_slice_pitch + row * src_row_pitch, src_row_pitch);
+				}
+			}
+			upload.cmd_list->CopyBufferToTexture(texture, subresource.mip_level, subresource.array_slice, *upload.staging_buffer, (Uint32)subresource.offset);
+		}
+		upload.cmd_list->End();
+		upload.cmd_list->Signal(*upload_fence, upload.fence_value);
+		upload.cmd_list->Submit();
+
+		//the frame's command lists are executed as a pool, which skips waits recorded on them, so the graphics queue waits itself
+		gfx->GetCommandQueue(GfxCommandListType::Graphics)->Wait(*upload_fence, upload.fence_value);
+		return staging_size;
+	}
+
+	void TextureManager::WaitForAllUploads()
+	{
+		if (upload_fence)
+		{
+			upload_fence->Wait(upload_fence_value);
+			ReleaseCompletedUploads();
+		}
+	}
+
+	void TextureManager::FinishStreaming(TextureHandle texture_handle)
+	{
+		auto it = std::find_if(streaming_textures.begin(), streaming_textures.end(), [texture_handle](StreamingTexture const& streaming_texture) { return streaming_texture.handle == texture_handle; });
+		if (it == streaming_textures.end())
+		{
+			return;
+		}
+		std::unique_ptr<Image> img = it->image.get();
+		CreateTexture(texture_handle, *img, it->srgb);
+		streaming_placeholders.erase(texture_handle);
+		streaming_textures.erase(it);
+	}
+
 	void TextureManager::CreateViewForTexture(TextureHandle handle, Bool flag)
 	{
 		if (!is_scene_initialized && !flag)
@@ -1,5 +1,7 @@
 #pragma once
+#include <future>
 #include "TextureHandle.h"
+#include "TextureCache.h"
 #include "Graphics/GfxDescriptor.h"
 #include "Utilities/Singleton.h"
 #include "Utilities/Ref.h"
@@ -8,6 +10,10 @@ namespace adria
 {
 	class GfxDevice;
 	class GfxTexture;
+	class GfxBuffer;
+	class GfxCommandList;
+	class GfxFence;
+	class Image;
 
 	class TextureManager : public Singleton<TextureManager>
 	{
@@ -20,6 +26,9 @@ namespace adria
 		void Shutdown();
 
 		ADRIA_NODISCARD TextureHandle LoadTexture(std::string_view path, Bool srgb = false);
+		//returns immediately, the image is decoded and cooked on a worker and the handle resolves to the placeholder until the texture is uploaded.
+		//Mip generation follows EnableMipMaps, block compression can be turned off with r.TextureStreaming.Compression
+		ADRIA_NODISCARD TextureHandle StreamTexture(std::string_view path, TextureHandle placeholder, TextureCookParams cook_params);
 		ADRIA_NODISCARD TextureHandle LoadCubemap(std::array<std::string, 6> const& cubemap_textures);
 
 		ADRIA_NODISCARD Uint32		  GetBindlessIndex(TextureHandle handle) const;
@@ -28,6 +37,9 @@ namespace adria
 
 		void EnableMipMaps(Bool);
 		void OnSceneInitialized();
+		//uploads decoded textures within the per frame staging budget, returns true if any streamed texture became resident
+		Bool Update();
+		void ReleaseCompletedUploads();
 
 	private:
 		GfxDevice* gfx = nullptr;
@@ -36,13 +48,37 @@ namespace adria
 		std::unordered_map<TextureHandle, std::unique_ptr<GfxTexture>> texture_map;
 		std::unordered_map<TextureHandle, GfxDescriptor> texture_srv_map;
 		TextureHandle handle = TEXTURE_MANAGER_START_HANDLE;
+
+		struct StreamingTexture
+		{
+			TextureHandle handle;
+			Bool srgb;
+			std::future<std::unique_ptr<Image>> image;
+		};
+		std::vector<StreamingTexture> streaming_textures;
+		std::unordered_map<TextureHandle, TextureHandle> streaming_placeholders;
 		Bool enable_mipmaps = true;
 		Bool is_scene_initialized = false;
 
+		struct PendingUpload
+		{
+			std::unique_ptr<GfxCommandList> cmd_list;
+			std::unique_ptr<GfxBuffer> staging_buffer;
+			Uint64 fence_value;
+		};
+		std::unique_ptr<GfxFence> upload_fence;
+		Uint64 upload_fence_value = 0;
+		std::queue<PendingUpload> pending_uploads;
+
 	private:
 		TextureManager();
 		~TextureManager();
 
+		//returns the staging bytes the upload took
+		Uint64 CreateTexture(TextureHandle handle, Image const& img, Bool srgb);
+		Uint64 UploadTexture(GfxTexture& texture, Image const& img);
+		void WaitForAllUploads();
+		void FinishStreaming(TextureHandle handle);
 		void CreateViewForTexture(TextureHandle handle, Bool flag = false);
 	};
 	#define g_TextureManager TextureManager::Get()
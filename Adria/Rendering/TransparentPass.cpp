@@ -69,6 +69,7 @@ namespace adria
 		};
 
 		FrameBlackboardData const& frame_data = rg.GetBlackboard().Get<FrameBlackboardData>();
+		CameraDrawsBlackboardData const& draws_data = rg.GetBlackboard().Get<CameraDrawsBlackboardData>();
 		rg.AddPass<TransparentPassData>("Transparent Pass",
 			[=, this](TransparentPassData& data, RenderGraphBuilder& builder)
 			{
@@ -88,27 +89,13 @@ namespace adria
 
 				cmd_list->SetRootCBV(0, frame_data.frame_cbuffer_address);
 
-				Vector3 camera_position(frame_data.camera_position);
-				reg.sort<Batch>([&camera_position](Batch const& lhs, Batch const& rhs)
-					{
-						Float lhs_distance = Vector3::DistanceSquared(camera_position, lhs.bounding_box.Center);
-						Float rhs_distance = Vector3::DistanceSquared(camera_position, rhs.bounding_box.Center);
-						return lhs_distance > rhs_distance;
-					});
-
 				transparent_psos->AddDefine("USE_SSR", reflections_enabled ? "1" : "0");
 				GfxPipelineState const* pso = transparent_psos->Get();
 				cmd_list->SetPipelineState(pso);
 
-				auto batch_view = reg.view<Batch, Transparent>();
-				for (entt::entity batch_entity : batch_view)
+				for (Uint64 i = 0; i < draws_data.transparent_draw_count; ++i)
 				{
-					Batch& batch = batch_view.get<Batch>(batch_entity);
-					if (!batch.camera_visibility)
-					{
-						continue;
-					}
-
+					Batch const& batch = *draws_data.transparent_draws[i];
 					struct TransparentConstants
 					{
 						Uint32 instance_id;
@@ -123,7 +110,7 @@ namespace adria
 					}
 					cmd_list->SetRootConstants(1, constants);
 
-					GfxIndexBufferView ibv(batch.submesh->buffer_address + batch.submesh->indices_offset, batch.submesh->indices_count);
+					GfxIndexBufferView ibv(batch.submesh->buffer_address + batch.submesh->indices_offset, batch.submesh->indices_count, batch.submesh->GetIndexFormat());
 					cmd_list->SetPrimitiveTopology(batch.submesh->topology);
 					cmd_list->SetIndexBuffer(&ibv);
 					cmd_list->DrawIndexed(batch.submesh->indices_count);
@@ -35,10 +35,10 @@ VSToPS GBufferVS(uint vertexId : SV_VertexID)
     Instance instanceData = GetInstanceData(GBufferPassCB.instanceId);
     Mesh meshData = GetMeshData(instanceData.meshIndex);
 
-	float3 pos = LoadMeshBuffer<float3>(meshData.bufferIdx, meshData.positionsOffset, vertexId);
-	float2 uv  = LoadMeshBuffer<float2>(meshData.bufferIdx, meshData.uvsOffset, vertexId);
-	float3 nor = LoadMeshBuffer<float3>(meshData.bufferIdx, meshData.normalsOffset, vertexId);
-	float4 tan = LoadMeshBuffer<float4>(meshData.bufferIdx, meshData.tangentsOffset, vertexId);
+	float3 pos = LoadMeshPosition(meshData, vertexId);
+	float2 uv  = LoadMeshUV(meshData, vertexId);
+	float3 nor = LoadMeshNormal(meshData, vertexId);
+	float4 tan = LoadMeshTangent(meshData, vertexId);
     
 	float4 posWS = mul(float4(pos, 1.0), instanceData.worldMatrix);
 	output.PositionWS = posWS.xyz;
@@ -90,7 +90,7 @@ PSOutput GBufferPS(VSToPS input)
 	float3 normal = normalize(input.NormalWS);
 	float3 tangent = normalize(input.TangentWS);
 	float3 bitangent = normalize(input.BitangentWS);
-    float3 normalTS = normalize(normalTexture.Sample(LinearWrapSampler, input.Uvs).xyz * 2.0f - 1.0f);
+    float3 normalTS = DecodeNormalMap(normalTexture.Sample(LinearWrapSampler, input.Uvs));
     float3x3 TBN = float3x3(tangent, bitangent, normal); 
     normal = normalize(mul(normalTS, TBN));
 
@@ -136,7 +136,7 @@ PSOutput GBufferPS(VSToPS input)
 	clearCoatRoughness *= clearCoatRoughnessTexture.Sample(LinearWrapSampler, input.Uvs).g;
 
 	Texture2D clearCoatNormalTexture = ResourceDescriptorHeap[materialData.clearCoatNormalIdx];
-    float3 clearCoatNormalTS = normalize(clearCoatNormalTexture.Sample(LinearWrapSampler, input.Uvs).xyz * 2.0f - 1.0f);
+    float3 clearCoatNormalTS = DecodeNormalMap(clearCoatNormalTexture.Sample(LinearWrapSampler, input.Uvs));
     float3 clearCoatNormal = normalize(mul(clearCoatNormalTS, TBN));
 	float3 clearCoatNormalVS = normalize(mul(clearCoatNormal, (float3x3) FrameCB.view));
 	customData = EncodeClearCoat(clearCoat, clearCoatRoughness, clearCoatNormalVS);
@@ -20,27 +20,29 @@ struct VSToPS
 	float4 Pos : SV_POSITION;
 #if TRANSPARENT
 	float2 TexCoords : TEX;
+	nointerpolation uint InstanceId : INSTANCE_ID;
 #endif
 };
 
-VSToPS ShadowVS(uint VertexId : SV_VertexID)
+VSToPS ShadowVS(uint VertexId : SV_VertexID, uint InstanceId : SV_InstanceID)
 {
 	StructuredBuffer<float4x4> lightViewProjections = ResourceDescriptorHeap[FrameCB.lightsMatricesIdx];
 	LightInfo lightInfo = LoadLightInfo(ShadowPassCB.lightIndex);
 	float4x4 lightViewProjection = lightViewProjections[lightInfo.shadowMatrixIndex + ShadowPassCB.matrixIndex];
 
 	VSToPS output = (VSToPS)0;
-	Instance instanceData = GetInstanceData(ModelCB.instanceId);
+	Instance instanceData = GetInstanceData(ModelCB.instanceId + InstanceId);
 	Mesh meshData = GetMeshData(instanceData.meshIndex);
 
-	float3 pos = LoadMeshBuffer<float3>(meshData.bufferIdx, meshData.positionsOffset, VertexId);
+	float3 pos = LoadMeshPosition(meshData, VertexId);
 	float4 posWS = mul(float4(pos, 1.0f), instanceData.worldMatrix);
 	float4 posLS = mul(posWS, lightViewProjection);
 	output.Pos = posLS;
 
 #if TRANSPARENT
-	float2 uv = LoadMeshBuffer<float2>(meshData.bufferIdx, meshData.uvsOffset, VertexId);
+	float2 uv = LoadMeshUV(meshData, VertexId);
 	output.TexCoords = uv;
+	output.InstanceId = ModelCB.instanceId + InstanceId;
 #endif
 	return output;
 }
@@ -48,7 +50,7 @@ VSToPS ShadowVS(uint VertexId : SV_VertexID)
 void ShadowPS(VSToPS input)
 {
 #if TRANSPARENT 
-	Instance instanceData = GetInstanceData(ModelCB.instanceId);
+	Instance instanceData = GetInstanceData(input.InstanceId);
 	Material materialData = GetMaterialData(instanceData.materialIdx);
 
 	Texture2D albedoTexture = ResourceDescriptorHeap[materialData.diffuseIdx];
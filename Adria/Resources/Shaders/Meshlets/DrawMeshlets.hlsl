@@ -29,10 +29,10 @@ struct MSToPS
 MSToPS GetVertex(Mesh mesh, Instance instance, uint vertexId)
 {
 	MSToPS output;
-	float3 pos = LoadMeshBuffer<float3>(mesh.bufferIdx,  mesh.positionsOffset, vertexId);
-	float2 uv  = LoadMeshBuffer<float2>(mesh.bufferIdx,  mesh.uvsOffset, vertexId);
-	float3 nor = LoadMeshBuffer<float3>(mesh.bufferIdx,  mesh.normalsOffset, vertexId);
-	float4 tan = LoadMeshBuffer<float4>(mesh.bufferIdx,  mesh.tangentsOffset, vertexId);
+	float3 pos = LoadMeshPosition(mesh, vertexId);
+	float2 uv  = LoadMeshUV(mesh, vertexId);
+	float3 nor = LoadMeshNormal(mesh, vertexId);
+	float4 tan = LoadMeshTangent(mesh, vertexId);
 	
 	float4 posWS = mul(float4(pos, 1.0), instance.worldMatrix);
 	output.PositionWS = posWS.xyz;
@@ -133,7 +133,7 @@ PSOutput DrawMeshletsPS(MSToPS input)
 	float3 normal = normalize(input.NormalWS);
 	float3 tangent = normalize(input.TangentWS);
 	float3 bitangent = normalize(input.BitangentWS);
-    float3 normalTS = normalize(normalTexture.Sample(LinearWrapSampler, input.Uvs).xyz * 2.0f - 1.0f);
+    float3 normalTS = DecodeNormalMap(normalTexture.Sample(LinearWrapSampler, input.Uvs));
     float3x3 TBN = float3x3(tangent, bitangent, normal); 
     normal = normalize(mul(normalTS, TBN));
 
@@ -161,7 +161,7 @@ PSOutput DrawMeshletsPS(MSToPS input)
 	clearCoatRoughness *= clearCoatRoughnessTexture.Sample(LinearWrapSampler, input.Uvs).g;
 
 	Texture2D clearCoatNormalTexture = ResourceDescriptorHeap[material.clearCoatNormalIdx];
-    float3 clearCoatNormalTS = normalize(clearCoatNormalTexture.Sample(LinearWrapSampler, input.Uvs).xyz * 2.0f - 1.0f);
+    float3 clearCoatNormalTS = DecodeNormalMap(clearCoatNormalTexture.Sample(LinearWrapSampler, input.Uvs));
     float3 clearCoatNormal = normalize(mul(clearCoatNormal, TBN));
 	clearCoatNormalVS = normalize(mul(clearCoatNormal, (float3x3) FrameCB.view));
 	customData = EncodeClearCoat(clearCoat, clearCoatRoughness, clearCoatNormalVS);
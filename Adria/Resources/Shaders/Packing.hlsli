@@ -78,6 +78,13 @@ float3 DecodeNormal16x2(uint f)
     return DecodeNormalOctahedron(n * 2.0 - 1.0);
 }
 
+//tangent direction with 16 and 15 bits, the lowest bit of y stores the sign of the bitangent
+float4 DecodeTangent16x2(uint f)
+{
+    float2 t = float2(f >> 16, (f & 0xffff) >> 1) / float2(65535.0, 32767.0);
+    float sign = (f & 1) ? -1.0 : 1.0;
+    return float4(DecodeNormalOctahedron(t * 2.0 - 1.0), sign);
+}
 
 float4 EncodeGBufferNormalRT(float3 viewNormal, float metallic, uint shadingExtension)
 {
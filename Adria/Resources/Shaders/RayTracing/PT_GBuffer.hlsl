@@ -32,10 +32,10 @@ VSToPS PT_GBufferVS(uint vertexId : SV_VertexID)
     Instance instanceData = GetInstanceData(PT_GBufferPassCB.instanceId);
     Mesh meshData = GetMeshData(instanceData.meshIndex);
 
-	float3 pos = LoadMeshBuffer<float3>(meshData.bufferIdx, meshData.positionsOffset, vertexId);
-	float2 uv  = LoadMeshBuffer<float2>(meshData.bufferIdx, meshData.uvsOffset, vertexId);
-	float3 nor = LoadMeshBuffer<float3>(meshData.bufferIdx, meshData.normalsOffset, vertexId);
-	float4 tan = LoadMeshBuffer<float4>(meshData.bufferIdx, meshData.tangentsOffset, vertexId);
+	float3 pos = LoadMeshPosition(meshData, vertexId);
+	float2 uv  = LoadMeshUV(meshData, vertexId);
+	float3 nor = LoadMeshNormal(meshData, vertexId);
+	float4 tan = LoadMeshTangent(meshData, vertexId);
     
 	float4 posWS = mul(float4(pos, 1.0), instanceData.worldMatrix);
 	output.PositionWS = posWS.xyz;
@@ -69,7 +69,7 @@ PSOutput PT_GBufferPS(VSToPS input)
     float3 tangent = normalize(input.TangentWS);
     float3 bitangent = normalize(input.BitangentWS);
 
-    float3 normalTS = normalTexture.Sample(LinearWrapSampler, input.Uvs).xyz * 2.0f - 1.0f;
+    float3 normalTS = DecodeNormalMap(normalTexture.Sample(LinearWrapSampler, input.Uvs));
     float3x3 TBN = float3x3(tangent, bitangent, normal);
     normal = normalize(mul(normalTS, TBN)); 
     float3 normalOS = normalize(mul(normal, (float3x3)instanceData.inverseWorldMatrix));
@@ -1,6 +1,7 @@
 #ifndef _SCENE_
 #define _SCENE_
 #include "CommonResources.hlsli"
+#include "Packing.hlsli"
 
 struct Mesh
 {
@@ -14,8 +15,16 @@ struct Mesh
 	uint meshletVerticesOffset;
 	uint meshletTrianglesOffset;
 	uint meshletCount;
+	uint flags;
+	float3 positionCenter;
+	float3 positionExtents;
 };
 
+#define MeshFlag_QuantizedPositions 0x1
+#define MeshFlag_OctahedralNormals 0x2
+#define MeshFlag_HalfUVs 0x4
+#define MeshFlag_16BitIndices 0x8
+
 
 #define ShadingExtension_Default 0 
 #define ShadingExtension_Anisotropy 1
@@ -86,6 +95,13 @@ Material GetMaterialData(uint materialIdx)
 	return materials[materialIdx];
 }
 
+//normal maps can be two channel (BC5), z is always reconstructed from xy
+float3 DecodeNormalMap(float4 normalSample)
+{
+	float2 xy = normalSample.xy * 2.0f - 1.0f;
+	return float3(xy, sqrt(saturate(1.0f - dot(xy, xy))));
+}
+
 template<typename T>
 T LoadMeshBuffer(uint bufferIdx, uint bufferOffset, uint vertexId)
 {
@@ -93,6 +109,57 @@ T LoadMeshBuffer(uint bufferIdx, uint bufferOffset, uint vertexId)
 	return meshBuffer.Load<T>(bufferOffset + sizeof(T) * vertexId);
 }
 
+//compact meshes store snorm16 positions relative to the submesh bounds, 16x2 octahedral normals and tangents,
+//half uvs and 16 bit indices, see SubMeshFlagBit
+uint LoadMeshIndex(Mesh meshData, uint index)
+{
+	if (meshData.flags & MeshFlag_16BitIndices)
+	{
+		uint packedIndices = LoadMeshBuffer<uint>(meshData.bufferIdx, meshData.indicesOffset, index / 2);
+		return (index & 1) ? packedIndices >> 16 : packedIndices & 0xffff;
+	}
+	return LoadMeshBuffer<uint>(meshData.bufferIdx, meshData.indicesOffset, index);
+}
+
+float3 LoadMeshPosition(Mesh meshData, uint vertexId)
+{
+	if (meshData.flags & MeshFlag_QuantizedPositions)
+	{
+		uint2 packedPosition = LoadMeshBuffer<uint2>(meshData.bufferIdx, meshData.positionsOffset, vertexId);
+		int3 quantizedPosition = int3(packedPosition.x << 16, packedPosition.x, packedPosition.y << 16) >> 16;
+		float3 position = max(quantizedPosition / 32767.0f, -1.0f);
+		return meshData.positionCenter + position * meshData.positionExtents;
+	}
+	return LoadMeshBuffer<float3>(meshData.bufferIdx, meshData.positionsOffset, vertexId);
+}
+
+float2 LoadMeshUV(Mesh meshData, uint vertexId)
+{
+	if (meshData.flags & MeshFlag_HalfUVs)
+	{
+		return UnpackHalf2(LoadMeshBuffer<uint>(meshData.bufferIdx, meshData.uvsOffset, vertexId));
+	}
+	return LoadMeshBuffer<float2>(meshData.bufferIdx, meshData.uvsOffset, vertexId);
+}
+
+float3 LoadMeshNormal(Mesh meshData, uint vertexId)
+{
+	if (meshData.flags & MeshFlag_OctahedralNormals)
+	{
+		return DecodeNormal16x2(LoadMeshBuffer<uint>(meshData.bufferIdx, meshData.normalsOffset, vertexId));
+	}
+	return LoadMeshBuffer<float3>(meshData.bufferIdx, meshData.normalsOffset, vertexId);
+}
+
+float4 LoadMeshTangent(Mesh meshData, uint vertexId)
+{
+	if (meshData.flags & MeshFlag_OctahedralNormals)
+	{
+		return DecodeTangent16x2(LoadMeshBuffer<uint>(meshData.bufferIdx, meshData.tangentsOffset, vertexId));
+	}
+	return LoadMeshBuffer<float4>(meshData.bufferIdx, meshData.tangentsOffset, vertexId);
+}
+
 struct VertexData
 {
 	float3 pos;
@@ -111,23 +178,23 @@ float2 Interpolate(in float2 x0, in float2 x1, in float2 x2, float2 bary)
 
 VertexData LoadVertexData(Mesh meshData, uint triangleIndex, float2 barycentrics)
 {
-	uint i0 = LoadMeshBuffer<uint>(meshData.bufferIdx, meshData.indicesOffset, 3 * triangleIndex + 0);
-	uint i1 = LoadMeshBuffer<uint>(meshData.bufferIdx, meshData.indicesOffset, 3 * triangleIndex + 1);
-	uint i2 = LoadMeshBuffer<uint>(meshData.bufferIdx, meshData.indicesOffset, 3 * triangleIndex + 2);
+	uint i0 = LoadMeshIndex(meshData, 3 * triangleIndex + 0);
+	uint i1 = LoadMeshIndex(meshData, 3 * triangleIndex + 1);
+	uint i2 = LoadMeshIndex(meshData, 3 * triangleIndex + 2);
 
-	float3 pos0 = LoadMeshBuffer<float3>(meshData.bufferIdx, meshData.positionsOffset, i0);
-	float3 pos1 = LoadMeshBuffer<float3>(meshData.bufferIdx, meshData.positionsOffset, i1);
-	float3 pos2 = LoadMeshBuffer<float3>(meshData.bufferIdx, meshData.positionsOffset, i2);
+	float3 pos0 = LoadMeshPosition(meshData, i0);
+	float3 pos1 = LoadMeshPosition(meshData, i1);
+	float3 pos2 = LoadMeshPosition(meshData, i2);
 	float3 pos = Interpolate(pos0, pos1, pos2, barycentrics);
 
-	float2 uv0 = LoadMeshBuffer<float2>(meshData.bufferIdx, meshData.uvsOffset, i0);
-	float2 uv1 = LoadMeshBuffer<float2>(meshData.bufferIdx, meshData.uvsOffset, i1);
-	float2 uv2 = LoadMeshBuffer<float2>(meshData.bufferIdx, meshData.uvsOffset, i2);
+	float2 uv0 = LoadMeshUV(meshData, i0);
+	float2 uv1 = LoadMeshUV(meshData, i1);
+	float2 uv2 = LoadMeshUV(meshData, i2);
 	float2 uv = Interpolate(uv0, uv1, uv2, barycentrics);
 
-	float3 nor0 = LoadMeshBuffer<float3>(meshData.bufferIdx, meshData.normalsOffset, i0);
-	float3 nor1 = LoadMeshBuffer<float3>(meshData.bufferIdx, meshData.normalsOffset, i1);
-	float3 nor2 = LoadMeshBuffer<float3>(meshData.bufferIdx, meshData.normalsOffset, i2);
+	float3 nor0 = LoadMeshNormal(meshData, i0);
+	float3 nor1 = LoadMeshNormal(meshData, i1);
+	float3 nor2 = LoadMeshNormal(meshData, i2);
 	float3 nor = normalize(Interpolate(nor0, nor1, nor2, barycentrics));
 
 	VertexData vertex = (VertexData)0;
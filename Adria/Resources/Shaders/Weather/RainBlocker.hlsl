@@ -22,7 +22,7 @@ VSToPS RainBlockerVS(uint VertexID : SV_VertexID)
 	VSToPS output = (VSToPS)0;
 	Instance instanceData = GetInstanceData(ModelCB.instanceId);
 	Mesh meshData = GetMeshData(instanceData.meshIndex);
-	float3 pos = LoadMeshBuffer<float3>(meshData.bufferIdx, meshData.positionsOffset, VertexID);
+	float3 pos = LoadMeshPosition(meshData, VertexID);
 	float4 posWS = mul(float4(pos, 1.0f), instanceData.worldMatrix);
 	float4 posLS = mul(posWS, RainBlockerPassCB.rainViewProjectionMatrix);
 	output.Pos = posLS;
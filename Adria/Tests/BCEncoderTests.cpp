@@ -0,0 +1,280 @@
+#include <gtest/gtest.h>
+#include "Utilities/BCEncoder.h"
+#include "Utilities/Image.h"
+#include "Core/Paths.h"
+
+namespace adria
+{
+	namespace
+	{
+		//reference decoders written from the format specification, independent of the encoder
+		void DecodeColor565(Uint16 color, Int32 (&rgb)[3])
+		{
+			Int32 const r = (color >> 11) & 31, g = (color >> 5) & 63, b = color & 31;
+			rgb[0] = (r << 3) | (r >> 2);
+			rgb[1] = (g << 2) | (g >> 4);
+			rgb[2] = (b << 3) | (b >> 2);
+		}
+
+		void DecodeBC1Block(Uint8 const* block, Uint8* rgba, Bool allow_three_color = true)
+		{
+			Uint16 const c0 = (Uint16)(block[0] | (block[1] << 8));
+			Uint16 const c1 = (Uint16)(block[2] | (block[3] << 8));
+			Int32 palette[4][4] = {};
+			Int32 rgb0[3], rgb1[3];
+			DecodeColor565(c0, rgb0);
+			DecodeColor565(c1, rgb1);
+			Bool const four_color = c0 > c1 || !allow_three_color;
+			for (Uint32 c = 0; c < 3; ++c)
+			{
+				palette[0][c] = rgb0[c];
+				palette[1][c] = rgb1[c];
+				palette[2][c] = four_color ? (2 * rgb0[c] + rgb1[c] + 1) / 3 : (rgb0[c] + rgb1[c]) / 2;
+				palette[3][c] = four_color ? (rgb0[c] + 2 * rgb1[c] + 1) / 3 : 0;
+			}
+			palette[0][3] = palette[1][3] = palette[2][3] = 255;
+			palette[3][3] = four_color ? 255 : 0;
+
+			Uint32 const indices = block[4] | (block[5] << 8) | (block[6] << 16) | ((Uint32)block[7] << 24);
+			for (Uint32 i = 0; i < 16; ++i)
+			{
+				Int32 const* color = palette[(indices >> (2 * i)) & 3];
+				for (Uint32 c = 0; c < 4; ++c)
+				{
+					rgba[i * 4 + c] = (Uint8)color[c];
+				}
+			}
+		}
+
+		//decodes one channel of 16 texels, output stride is in bytes
+		void DecodeBC4Block(Uint8 const* block, Uint8* output, Uint32 stride)
+		{
+			Int32 const r0 = block[0], r1 = block[1];
+			Int32 palette[8] = { r0, r1 };
+			if (r0 > r1)
+			{
+				for (Int32 k = 2; k < 8; ++k) palette[k] = ((8 - k) * r0 + (k - 1) * r1 + 3) / 7;
+			}
+			else
+			{
+				for (Int32 k = 2; k < 6; ++k) palette[k] = ((6 - k) * r0 + (k - 1) * r1 + 2) / 5;
+				palette[6] = 0;
+				palette[7] = 255;
+			}
+			Uint64 indices = 0;
+			for (Uint32 i = 0; i < 6; ++i) indices |= (Uint64)block[2 + i] << (8 * i);
+			for (Uint32 i = 0; i < 16; ++i)
+			{
+				output[i * stride] = (Uint8)palette[(indices >> (3 * i)) & 7];
+			}
+		}
+
+		class BitReader
+		{
+		public:
+			explicit BitReader(Uint8 const* data) : data(data) {}
+			Uint32 Read(Uint32 count)
+			{
+				Uint32 value = 0;
+				for (Uint32 i = 0; i < count; ++i, ++position)
+				{
+					value |= ((data[position / 8] >> (position % 8)) & 1u) << i;
+				}
+				return value;
+			}
+		private:
+			Uint8 const* data;
+			Uint32 position = 0;
+		};
+
+		//the encoder only emits mode 6, anything else fails the decode
+		Bool DecodeBC7Block(Uint8 const* block, Uint8* rgba)
+		{
+			BitReader reader(block);
+			if (reader.Read(7) != 0x40)
+			{
+				return false;
+			}
+			Int32 endpoints[2][4];
+			for (Uint32 c = 0; c < 4; ++c)
+			{
+				endpoints[0][c] = reader.Read(7);
+				endpoints[1][c] = reader.Read(7);
+			}
+			Uint32 const p0 = reader.Read(1), p1 = reader.Read(1);
+			for (Uint32 c = 0; c < 4; ++c)
+			{
+				endpoints[0][c] = (endpoints[0][c] << 1) | p0;
+				endpoints[1][c] = (endpoints[1][c] << 1) | p1;
+			}
+			static constexpr Int32 Weights[16] = { 0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64 };
+			for (Uint32 i = 0; i < 16; ++i)
+			{
+				Int32 const weight = Weights[reader.Read(i == 0 ? 3 : 4)];
+				for (Uint32 c = 0; c < 4; ++c)
+				{
+					rgba[i * 4 + c] = (Uint8)(((64 - weight) * endpoints[0][c] + weight * endpoints[1][c] + 32) >> 6);
+				}
+			}
+			return true;
+		}
+
+		//decodes a surface to rgba8, channels a format does not store are left as they were in rgba
+		Bool DecodeSurfaceBC(GfxFormat format, Uint8 const* input, Uint32 width, Uint32 height, Uint8* rgba)
+		{
+			Uint32 const blocks_x = (width + 3) / 4;
+			Uint32 const blocks_y = (height + 3) / 4;
+			Uint32 const block_size = GetGfxFormatStride(format);
+			for (Uint32 block_y = 0; block_y < blocks_y; ++block_y)
+			{
+				for (Uint32 block_x = 0; block_x < blocks_x; ++block_x)
+				{
+					Uint8 const* block = input + ((Uint64)block_y * blocks_x + block_x) * block_size;
+					Uint8 texels[64];
+					for (Uint32 i = 0; i < 16; ++i)
+					{
+						Uint64 const x = std::min(block_x * 4 + i % 4, width - 1);
+						Uint64 const y = std::min(block_y * 4 + i / 4, height - 1);
+						memcpy(texels + i * 4, rgba + (y * width + x) * 4, 4);
+					}
+					switch (format)
+					{
+					case GfxFormat::BC1_UNORM: DecodeBC1Block(block, texels); break;
+					case GfxFormat::BC3_UNORM: DecodeBC1Block(block + 8, texels, false); DecodeBC4Block(block, texels + 3, 4); break;
+					case GfxFormat::BC4_UNORM: DecodeBC4Block(block, texels, 4); break;
+					case GfxFormat::BC5_UNORM: DecodeBC4Block(block, texels, 4); DecodeBC4Block(block + 8, texels + 1, 4); break;
+					case GfxFormat::BC7_UNORM: if (!DecodeBC7Block(block, texels)) return false; break;
+					default: return false;
+					}
+					for (Uint32 i = 0; i < 16; ++i)
+					{
+						Uint32 const x = block_x * 4 + i % 4;
+						Uint32 const y = block_y * 4 + i / 4;
+						if (x < width && y < height)
+						{
+							memcpy(rgba + ((Uint64)y * width + x) * 4, texels + i * 4, 4);
+						}
+					}
+				}
+			}
+			return true;
+		}
+
+		//psnr over the channels in channel_mask, both surfaces are rgba8
+		Float64 ComputePSNR(std::vector<Uint8> const& reference, std::vector<Uint8> const& decoded, Uint32 channel_mask)
+		{
+			Float64 squared_error = 0.0;
+			Uint64 sample_count = 0;
+			for (Uint64 i = 0; i < reference.size(); ++i)
+			{
+				if (channel_mask & (1u << (i % 4)))
+				{
+					Float64 const difference = (Float64)reference[i] - decoded[i];
+					squared_error += difference * difference;
+					++sample_count;
+				}
+			}
+			Float64 const mse = squared_error / sample_count;
+			return mse == 0.0 ? 100.0 : 10.0 * std::log10(255.0 * 255.0 / mse);
+		}
+
+		//256x256 from the center of a model texture, large enough to average over real content while keeping the encode fast
+		std::vector<Uint8> LoadTestTexture(Char const* model_texture, Uint32 size = 256)
+		{
+			Image img(paths::ModelsDir + model_texture);
+			if (img.Format() != GfxFormat::R8G8B8A8_UNORM || img.Width() < size || img.Height() < size)
+			{
+				return {};
+			}
+			std::vector<Uint8> texels((Uint64)size * size * 4);
+			Uint32 const x0 = (img.Width() - size) / 2, y0 = (img.Height() - size) / 2;
+			for (Uint32 y = 0; y < size; ++y)
+			{
+				memcpy(&texels[(Uint64)y * size * 4], img.Data() + ((Uint64)(y0 + y) * img.Width() + x0) * 4, size * 4);
+			}
+			return texels;
+		}
+
+		Float64 CompressAndMeasure(GfxFormat format, std::vector<Uint8> const& texels, Uint32 width, Uint32 height, Uint32 channel_mask)
+		{
+			std::vector<Uint8> compressed(GetTextureByteSize(format, width, height));
+			CompressSurfaceBC(format, texels.data(), width, height, compressed.data());
+			std::vector<Uint8> decoded = texels;
+			if (!DecodeSurfaceBC(format, compressed.data(), width, height, decoded.data()))
+			{
+				return 0.0;
+			}
+			return ComputePSNR(texels, decoded, channel_mask);
+		}
+
+		constexpr Uint32 ChannelMask_R = 0x1, ChannelMask_RG = 0x3, ChannelMask_RGB = 0x7, ChannelMask_A = 0x8, ChannelMask_RGBA = 0xf;
+	}
+
+	TEST(BCEncoder, ConstantBlocks)
+	{
+		std::vector<Uint8> texels(16 * 4);
+		for (Uint32 i = 0; i < 16; ++i)
+		{
+			texels[i * 4 + 0] = 200; texels[i * 4 + 1] = 33; texels[i * 4 + 2] = 99; texels[i * 4 + 3] = 180;
+		}
+		EXPECT_EQ(CompressAndMeasure(GfxFormat::BC4_UNORM, texels, 4, 4, ChannelMask_R), 100.0);
+		EXPECT_EQ(CompressAndMeasure(GfxFormat::BC5_UNORM, texels, 4, 4, ChannelMask_RG), 100.0);
+		//mode 6 endpoints share one p-bit across all channels, so channels of mixed parity may land one code off
+		EXPECT_GT(CompressAndMeasure(GfxFormat::BC7_UNORM, texels, 4, 4, ChannelMask_RGBA), 48.0);
+		//565 endpoints can not hit every color, the interpolated palette entries get within a few codes
+		EXPECT_GT(CompressAndMeasure(GfxFormat::BC1_UNORM, texels, 4, 4, ChannelMask_RGB), 42.0);
+		EXPECT_EQ(CompressAndMeasure(GfxFormat::BC3_UNORM, texels, 4, 4, ChannelMask_A), 100.0);
+	}
+
+	//thresholds sit a few dB below what the encoder reaches on these crops, they catch regressions not small tuning changes
+	TEST(BCEncoder, ColorPSNR)
+	{
+		std::vector<Uint8> const albedo = LoadTestTexture("ToyCar/ToyCar_basecolor.png");
+		ASSERT_FALSE(albedo.empty());
+		EXPECT_GT(CompressAndMeasure(GfxFormat::BC1_UNORM, albedo, 256, 256, ChannelMask_RGB), 40.0);
+		EXPECT_GT(CompressAndMeasure(GfxFormat::BC7_UNORM, albedo, 256, 256, ChannelMask_RGB), 50.0);
+	}
+
+	TEST(BCEncoder, AlphaPSNR)
+	{
+		std::vector<Uint8> texels = LoadTestTexture("ToyCar/ToyCar_basecolor.png");
+		ASSERT_FALSE(texels.empty());
+		for (Uint64 i = 0; i < texels.size() / 4; ++i)
+		{
+			Uint32 const x = i % 256, y = (Uint32)(i / 256);
+			texels[i * 4 + 3] = (Uint8)((x + y) / 2);
+		}
+		EXPECT_GT(CompressAndMeasure(GfxFormat::BC3_UNORM, texels, 256, 256, ChannelMask_A), 50.0);
+		EXPECT_GT(CompressAndMeasure(GfxFormat::BC7_UNORM, texels, 256, 256, ChannelMask_A), 55.0);
+		EXPECT_GT(CompressAndMeasure(GfxFormat::BC3_UNORM, texels, 256, 256, ChannelMask_RGB), 40.0);
+	}
+
+	TEST(BCEncoder, SingleChannelPSNR)
+	{
+		std::vector<Uint8> const orm = LoadTestTexture("ToyCar/ToyCar_occlusion_roughness_metallic.png");
+		ASSERT_FALSE(orm.empty());
+		EXPECT_GT(CompressAndMeasure(GfxFormat::BC4_UNORM, orm, 256, 256, ChannelMask_R), 45.0);
+	}
+
+	TEST(BCEncoder, NormalMapPSNR)
+	{
+		std::vector<Uint8> const normals = LoadTestTexture("ToyCar/ToyCar_normal.png");
+		ASSERT_FALSE(normals.empty());
+		EXPECT_GT(CompressAndMeasure(GfxFormat::BC5_UNORM, normals, 256, 256, ChannelMask_RG), 37.0);
+	}
+
+	//edge blocks replicate the last row and column, the texels inside the surface decode like any other
+	TEST(BCEncoder, PartialEdgeBlocks)
+	{
+		std::vector<Uint8> const full = LoadTestTexture("ToyCar/ToyCar_basecolor.png", 64);
+		ASSERT_FALSE(full.empty());
+		Uint32 const width = 61, height = 38;
+		std::vector<Uint8> texels((Uint64)width * height * 4);
+		for (Uint32 y = 0; y < height; ++y)
+		{
+			memcpy(&texels[(Uint64)y * width * 4], &full[(Uint64)y * 64 * 4], width * 4);
+		}
+		EXPECT_GT(CompressAndMeasure(GfxFormat::BC7_UNORM, texels, width, height, ChannelMask_RGB), 48.0);
+		EXPECT_GT(CompressAndMeasure(GfxFormat::BC1_UNORM, texels, width, height, ChannelMask_RGB), 38.0);
+	}
+}
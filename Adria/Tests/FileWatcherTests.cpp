@@ -0,0 +1,144 @@
+#include <gtest/gtest.h>
+#include <fstream>
+#include "Utilities/FileWatcher.h"
+
+namespace fs = std::filesystem;
+
+namespace adria
+{
+	namespace
+	{
+		constexpr std::chrono::milliseconds TestDebounceTime{ 200 };
+		//generous so a loaded machine does not fail the test, a passing run returns as soon as the changes arrive
+		constexpr std::chrono::seconds ChangeTimeout{ 10 };
+
+		using FileChange = std::pair<std::string, FileStatus>;
+
+		//scripted edits in a temporary directory, changes are collected the way the shader manager does it, by calling CheckWatchedFiles every frame
+		class FileWatcherTest : public ::testing::Test
+		{
+		protected:
+			void SetUp() override
+			{
+				dir = fs::temp_directory_path() / "AdriaFileWatcherTests";
+				fs::remove_all(dir);
+				fs::create_directories(dir);
+			}
+			void TearDown() override
+			{
+				std::error_code ec;
+				fs::remove_all(dir, ec);
+			}
+
+			std::unique_ptr<FileWatcher> CreateWatcher()
+			{
+				auto watcher = std::make_unique<FileWatcher>(TestDebounceTime);
+				watcher->GetFileModifiedEvent().AddLambda([this](std::string const& file, FileStatus status) { changes.emplace_back(file, status); });
+				watcher->AddPathToWatch(dir.string());
+				return watcher;
+			}
+
+			std::string GetPath(Char const* name) const
+			{
+				return (dir / name).string();
+			}
+			static void WriteFile(std::string const& path, std::string const& contents)
+			{
+				std::ofstream(path, std::ios::binary | std::ios::trunc) << contents;
+			}
+
+			//waits for the expected number of changes, then for one more debounce period so extra changes would show up too
+			std::vector<FileChange> CollectChanges(FileWatcher& watcher, Uint64 expected_count)
+			{
+				auto const deadline = std::chrono::steady_clock::now() + ChangeTimeout;
+				while (changes.size() < expected_count && std::chrono::steady_clock::now() < deadline)
+				{
+					std::this_thread::sleep_for(std::chrono::milliseconds(10));
+					watcher.CheckWatchedFiles();
+				}
+				std::this_thread::sleep_for(TestDebounceTime * 2);
+				watcher.CheckWatchedFiles();
+				return std::exchange(changes, {});
+			}
+
+			fs::path dir;
+			std::vector<FileChange> changes;
+		};
+	}
+
+	TEST_F(FileWatcherTest, ModifiedFileIsReported)
+	{
+		std::string const shader = GetPath("Shader.hlsl");
+		WriteFile(shader, "float4 main() : SV_Target { return 0; }");
+		std::unique_ptr<FileWatcher> watcher = CreateWatcher();
+
+		WriteFile(shader, "float4 main() : SV_Target { return 1; }");
+		EXPECT_EQ(CollectChanges(*watcher, 1), (std::vector<FileChange>{ { shader, FileStatus::Modified } }));
+	}
+
+	//an editor saving in several writes must trigger one recompile, and only after the file has been quiet for the debounce time
+	TEST_F(FileWatcherTest, BurstOfWritesIsCoalesced)
+	{
+		std::string const shader = GetPath("Shader.hlsl");
+		WriteFile(shader, "");
+		std::unique_ptr<FileWatcher> watcher = CreateWatcher();
+
+		for (Uint32 i = 0; i < 20; ++i)
+		{
+			std::ofstream(shader, std::ios::binary | std::ios::app) << "line " << i << "\n";
+		}
+		watcher->CheckWatchedFiles();
+		EXPECT_TRUE(changes.empty());
+		EXPECT_EQ(CollectChanges(*watcher, 1), (std::vector<FileChange>{ { shader, FileStatus::Modified } }));
+	}
+
+	TEST_F(FileWatcherTest, CreatedAndDeletedFilesAreReported)
+	{
+		std::string const removed = GetPath("Removed.hlsli");
+		WriteFile(removed, "#define REMOVED 1");
+		std::unique_ptr<FileWatcher> watcher = CreateWatcher();
+
+		std::string const created = GetPath("Created.hlsli");
+		WriteFile(created, "#define CREATED 1");
+		fs::remove(removed);
+		EXPECT_EQ(CollectChanges(*watcher, 2), (std::vector<FileChange>{ { created, FileStatus::Created }, { removed, FileStatus::Deleted } }));
+	}
+
+	//temporary files of editors come and go within the debounce time and never reach the listeners
+	TEST_F(FileWatcherTest, FileCreatedAndDeletedWithinDebounceIsDropped)
+	{
+		std::unique_ptr<FileWatcher> watcher = CreateWatcher();
+		std::string const temporary = GetPath("Shader.hlsl.tmp");
+		WriteFile(temporary, "temporary");
+		fs::remove(temporary);
+		EXPECT_TRUE(CollectChanges(*watcher, 0).empty());
+	}
+
+	TEST_F(FileWatcherTest, NewSubdirectoryIsWatched)
+	{
+		std::unique_ptr<FileWatcher> watcher = CreateWatcher();
+		fs::create_directories(dir / "Include");
+		std::string const include = GetPath("Include/Common.hlsli");
+		WriteFile(include, "#define ONE 1");
+		EXPECT_EQ(CollectChanges(*watcher, 1), (std::vector<FileChange>{ { include, FileStatus::Created } }));
+
+		WriteFile(include, "#define ONE 2");
+		EXPECT_EQ(CollectChanges(*watcher, 1), (std::vector<FileChange>{ { include, FileStatus::Modified } }));
+	}
+
+	TEST_F(FileWatcherTest, NonRecursiveWatchIgnoresSubdirectories)
+	{
+		fs::create_directories(dir / "Include");
+		std::string const include = GetPath("Include/Common.hlsli");
+		WriteFile(include, "#define ONE 1");
+		std::string const shader = GetPath("Shader.hlsl");
+		WriteFile(shader, "");
+
+		FileWatcher watcher(TestDebounceTime);
+		watcher.GetFileModifiedEvent().AddLambda([this](std::string const& file, FileStatus status) { changes.emplace_back(file, status); });
+		watcher.AddPathToWatch(dir.string(), false);
+		WriteFile(include, "#define ONE 2");
+		WriteFile(shader, "shader");
+		EXPECT_EQ(CollectChanges(watcher, 1), (std::vector<FileChange>{ { shader, FileStatus::Modified } }));
+	}
+}
@@ -0,0 +1,147 @@
+#include <gtest/gtest.h>
+#include "Math/FrustumCulling.h"
+#include "Utilities/Random.h"
+
+using namespace DirectX;
+
+namespace adria
+{
+	namespace
+	{
+		//boxes scattered around a frustum looking down +z from the origin, many of them straddle its planes
+		std::vector<BoundingBox> MakeRandomBoxes(Uint64 count, Uint32 seed)
+		{
+			RealRandomGenerator<Float> random_position(-150.0f, 150.0f, std::mt19937{ seed });
+			RealRandomGenerator<Float> random_extent(0.1f, 8.0f, std::mt19937{ seed + 1 });
+			std::vector<BoundingBox> boxes(count);
+			for (BoundingBox& box : boxes)
+			{
+				box.Center = XMFLOAT3(random_position(), random_position(), random_position() + 100.0f);
+				box.Extents = XMFLOAT3(random_extent(), random_extent(), random_extent());
+			}
+			return boxes;
+		}
+
+		BoundingFrustum MakeTestFrustum()
+		{
+			BoundingFrustum frustum(XMMatrixPerspectiveFovLH(1.0f, 16.0f / 9.0f, 0.1f, 200.0f));
+			frustum.Transform(frustum, XMMatrixRotationRollPitchYaw(0.1f, 0.3f, 0.0f));
+			return frustum;
+		}
+
+		AABBStreams MakeStreams(std::vector<BoundingBox> const& boxes)
+		{
+			AABBStreams streams;
+			streams.Resize(boxes.size());
+			for (Uint64 i = 0; i < boxes.size(); ++i)
+			{
+				streams.Set(i, boxes[i]);
+			}
+			return streams;
+		}
+
+		//the stream test is the per plane box test of DirectXMath, ContainedBy with the same planes is its scalar reference
+		std::vector<Uint32> CullReference(BoundingFrustum const& frustum, std::vector<BoundingBox> const& boxes)
+		{
+			XMVECTOR planes[6];
+			frustum.GetPlanes(&planes[0], &planes[1], &planes[2], &planes[3], &planes[4], &planes[5]);
+			std::vector<Uint32> visible_indices;
+			for (Uint64 i = 0; i < boxes.size(); ++i)
+			{
+				if (boxes[i].ContainedBy(planes[0], planes[1], planes[2], planes[3], planes[4], planes[5]) != DISJOINT)
+				{
+					visible_indices.push_back((Uint32)i);
+				}
+			}
+			return visible_indices;
+		}
+	}
+
+	TEST(FrustumCulling, MatchesScalarReference)
+	{
+		//not a multiple of the stream width or of 64, so the padded tail and the partial last visibility word are covered
+		Uint64 const box_count = 10007;
+		std::vector<BoundingBox> const boxes = MakeRandomBoxes(box_count, 11);
+		BoundingFrustum const frustum = MakeTestFrustum();
+		AABBStreams const streams = MakeStreams(boxes);
+
+		std::vector<Uint32> visible_indices;
+		std::vector<Uint64> visibility((box_count + 63) / 64, ~0ull);
+		CullAABBs(GetFrustumPlanes(frustum), streams, 0, box_count, visible_indices, visibility.data());
+
+		std::vector<Uint32> const reference_indices = CullReference(frustum, boxes);
+		ASSERT_FALSE(reference_indices.empty());
+		ASSERT_LT(reference_indices.size(), box_count);
+		EXPECT_EQ(visible_indices, reference_indices);
+		for (Uint64 i = 0; i < box_count; ++i)
+		{
+			Bool const visible = std::binary_search(reference_indices.begin(), reference_indices.end(), (Uint32)i);
+			EXPECT_EQ((visibility[i / 64] >> (i % 64)) & 1, visible ? 1u : 0u) << "box " << i;
+		}
+		EXPECT_EQ(visibility.back() >> (box_count % 64), 0u);
+	}
+
+	//the plane test is conservative, it can keep boxes near frustum corners but must never drop a visible one
+	TEST(FrustumCulling, NeverCullsIntersectingBoxes)
+	{
+		Uint64 const box_count = 10000;
+		std::vector<BoundingBox> const boxes = MakeRandomBoxes(box_count, 23);
+		BoundingFrustum const frustum = MakeTestFrustum();
+		AABBStreams const streams = MakeStreams(boxes);
+
+		std::vector<Uint32> visible_indices;
+		std::vector<Uint64> visibility((box_count + 63) / 64);
+		CullAABBs(GetFrustumPlanes(frustum), streams, 0, box_count, visible_indices, visibility.data());
+		for (Uint64 i = 0; i < box_count; ++i)
+		{
+			if (frustum.Intersects(boxes[i]))
+			{
+				EXPECT_TRUE((visibility[i / 64] >> (i % 64)) & 1) << "box " << i;
+			}
+		}
+	}
+
+	TEST(FrustumCulling, ChunkedCullingMatchesSingleRange)
+	{
+		Uint64 const box_count = 5000, chunk_size = 640;
+		std::vector<BoundingBox> const boxes = MakeRandomBoxes(box_count, 37);
+		FrustumPlanes const planes = GetFrustumPlanes(MakeTestFrustum());
+		AABBStreams const streams = MakeStreams(boxes);
+
+		std::vector<Uint32> visible_indices;
+		std::vector<Uint64> visibility((box_count + 63) / 64);
+		CullAABBs(planes, streams, 0, box_count, visible_indices, visibility.data());
+
+		std::vector<Uint32> chunked_visible_indices;
+		std::vector<Uint64> chunked_visibility((box_count + 63) / 64);
+		for (Uint64 begin = 0; begin < box_count; begin += chunk_size)
+		{
+			CullAABBs(planes, streams, begin, std::min(begin + chunk_size, box_count), chunked_visible_indices, chunked_visibility.data());
+		}
+		EXPECT_EQ(chunked_visible_indices, visible_indices);
+		EXPECT_EQ(chunked_visibility, visibility);
+	}
+
+	TEST(FrustumCulling, BoxPlanesMatchBoxIntersection)
+	{
+		Uint64 const box_count = 10000;
+		std::vector<BoundingBox> const boxes = MakeRandomBoxes(box_count, 53);
+		BoundingBox const view_box(XMFLOAT3(20.0f, -10.0f, 90.0f), XMFLOAT3(60.0f, 40.0f, 80.0f));
+		AABBStreams const streams = MakeStreams(boxes);
+
+		std::vector<Uint32> visible_indices;
+		std::vector<Uint64> visibility((box_count + 63) / 64);
+		CullAABBs(GetBoxPlanes(view_box), streams, 0, box_count, visible_indices, visibility.data());
+
+		std::vector<Uint32> reference_indices;
+		for (Uint64 i = 0; i < box_count; ++i)
+		{
+			if (view_box.Intersects(boxes[i]))
+			{
+				reference_indices.push_back((Uint32)i);
+			}
+		}
+		ASSERT_FALSE(reference_indices.empty());
+		EXPECT_EQ(visible_indices, reference_indices);
+	}
+}
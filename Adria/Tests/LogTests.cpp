@@ -0,0 +1,93 @@
+#include <gtest/gtest.h>
+#include <thread>
+#include "Logging/Log.h"
+
+namespace adria
+{
+	namespace
+	{
+		struct LoggedMessage
+		{
+			Uint32 producer;
+			Uint32 index;
+			Uint64 length;
+		};
+
+		//sinks are only called from the consumer thread and read after Flush, so no locking is needed
+		class RecordingLogSink : public ILogSink
+		{
+		public:
+			virtual void Log(LogLevel, LogChannel, Char const* entry, Char const*, Uint32) override
+			{
+				LoggedMessage message{};
+				if (sscanf(entry, "%u %u", &message.producer, &message.index) == 2)
+				{
+					message.length = strlen(entry);
+					messages.push_back(message);
+				}
+			}
+			virtual void Flush() override
+			{
+				++flush_count;
+			}
+
+			std::vector<LoggedMessage> messages;
+			Uint32 flush_count = 0;
+		};
+	}
+
+	//more messages than ring slots so producers have to wait for the consumer, each producer's messages still arrive in order
+	TEST(LogManager, ProducersDeliverEveryMessageInOrder)
+	{
+		Uint32 const producer_count = 8;
+		Uint32 const message_count = 2048;
+		LogManager log_manager;
+		RecordingLogSink* sink = log_manager.Register<RecordingLogSink>();
+
+		std::vector<std::thread> producers;
+		for (Uint32 producer = 0; producer < producer_count; ++producer)
+		{
+			producers.emplace_back([&log_manager, producer]()
+				{
+					for (Uint32 i = 0; i < message_count; ++i)
+					{
+						log_manager.LogFormat(LogLevel::LOG_INFO, LogChannel::Renderer, __FILE__, __LINE__, "%u %u", producer, i);
+					}
+				});
+		}
+		for (std::thread& producer : producers)
+		{
+			producer.join();
+		}
+		log_manager.Flush();
+
+		ASSERT_EQ(sink->messages.size(), producer_count * message_count);
+		std::vector<Uint32> next_index(producer_count, 0);
+		for (LoggedMessage const& message : sink->messages)
+		{
+			ASSERT_LT(message.producer, producer_count);
+			ASSERT_EQ(message.index, next_index[message.producer]) << "producer " << message.producer;
+			++next_index[message.producer];
+		}
+		EXPECT_GE(sink->flush_count, 1u);
+	}
+
+	TEST(LogManager, LongMessagesAreDeliveredWhole)
+	{
+		LogManager log_manager;
+		RecordingLogSink* sink = log_manager.Register<RecordingLogSink>();
+		std::string const padding(1000, 'x');
+		for (Uint32 i = 0; i < 16; ++i)
+		{
+			log_manager.LogFormat(LogLevel::LOG_INFO, LogChannel::Renderer, __FILE__, __LINE__, "0 %u %s", i, padding.c_str());
+			log_manager.Log(LogLevel::LOG_INFO, LogChannel::Renderer, ("1 " + std::to_string(i) + " " + padding).c_str(), __FILE__, __LINE__);
+		}
+		log_manager.Flush();
+
+		ASSERT_EQ(sink->messages.size(), 32u);
+		for (LoggedMessage const& message : sink->messages)
+		{
+			EXPECT_EQ(message.length, 2 + std::to_string(message.index).size() + 1 + padding.size());
+		}
+	}
+}
@@ -0,0 +1,91 @@
+#include <gtest/gtest.h>
+#include <thread>
+#include "Utilities/MemoryTracker.h"
+
+namespace adria
+{
+	namespace
+	{
+		//the counters are global, so every test works relative to the usage it starts with
+		constexpr MemoryCategory TestCategory = MemoryCategory::ModelImport;
+	}
+
+	TEST(MemoryTracker, ConcurrentAllocationsReturnToZero)
+	{
+		constexpr Uint32 ThreadCount = 8;
+		constexpr Uint32 BlockCount = 1000;
+		constexpr Uint64 BlockSize = 64;
+
+		Uint64 const base = MemoryTracker::GetCurrent(TestCategory);
+		MemoryTracker::ResetPeak(TestCategory);
+
+		//every thread holds all of its blocks at once before freeing them
+		std::vector<std::thread> threads;
+		for (Uint32 t = 0; t < ThreadCount; ++t)
+		{
+			threads.emplace_back([]()
+				{
+					for (Uint32 i = 0; i < BlockCount; ++i)
+					{
+						MemoryTracker::Allocate(TestCategory, BlockSize);
+					}
+					for (Uint32 i = 0; i < BlockCount; ++i)
+					{
+						MemoryTracker::Free(TestCategory, BlockSize);
+					}
+				});
+		}
+		for (std::thread& thread : threads)
+		{
+			thread.join();
+		}
+
+		EXPECT_EQ(MemoryTracker::GetCurrent(TestCategory), base);
+		Uint64 const peak = MemoryTracker::GetPeak(TestCategory) - base;
+		EXPECT_GE(peak, BlockCount * BlockSize);
+		EXPECT_LE(peak, ThreadCount * BlockCount * BlockSize);
+	}
+
+	TEST(MemoryTracker, PeakIsKeptUntilReset)
+	{
+		Uint64 const base = MemoryTracker::GetCurrent(TestCategory);
+		MemoryTracker::ResetPeak(TestCategory);
+		EXPECT_EQ(MemoryTracker::GetPeak(TestCategory), base);
+
+		MemoryTracker::Allocate(TestCategory, 300);
+		MemoryTracker::Allocate(TestCategory, 200);
+		MemoryTracker::Free(TestCategory, 300);
+		EXPECT_EQ(MemoryTracker::GetCurrent(TestCategory), base + 200);
+		EXPECT_EQ(MemoryTracker::GetPeak(TestCategory), base + 500);
+
+		//the peak restarts from the current usage, not from zero
+		MemoryTracker::ResetPeak(TestCategory);
+		EXPECT_EQ(MemoryTracker::GetPeak(TestCategory), base + 200);
+		MemoryTracker::Allocate(TestCategory, 100);
+		MemoryTracker::Free(TestCategory, 300);
+		EXPECT_EQ(MemoryTracker::GetPeak(TestCategory), base + 300);
+		EXPECT_EQ(MemoryTracker::GetCurrent(TestCategory), base);
+	}
+
+	//the vector is accounted for by its capacity, copies count on their own and everything is returned on destruction
+	TEST(MemoryTracker, TrackedVectorAccountsForCapacity)
+	{
+		using TestVector = TrackedVector<Uint32, TestCategory>;
+		Uint64 const base = MemoryTracker::GetCurrent(TestCategory);
+		{
+			TestVector values;
+			values.reserve(1000);
+			EXPECT_EQ(MemoryTracker::GetCurrent(TestCategory), base + 1000 * sizeof(Uint32));
+			values.resize(10, 7u);
+			EXPECT_EQ(MemoryTracker::GetCurrent(TestCategory), base + 1000 * sizeof(Uint32));
+
+			TestVector const copy = values;
+			EXPECT_EQ(MemoryTracker::GetCurrent(TestCategory), base + (1000 + copy.capacity()) * sizeof(Uint32));
+
+			//moving hands the allocation over without counting it twice
+			TestVector const moved = std::move(values);
+			EXPECT_EQ(MemoryTracker::GetCurrent(TestCategory), base + (1000 + copy.capacity()) * sizeof(Uint32));
+		}
+		EXPECT_EQ(MemoryTracker::GetCurrent(TestCategory), base);
+	}
+}
@@ -0,0 +1,191 @@
+#include <gtest/gtest.h>
+#include "Utilities/MipGenerator.h"
+#include "Utilities/Random.h"
+
+namespace adria
+{
+	namespace
+	{
+		Uint64 GetMipChainTexelCount(Uint32 width, Uint32 height, Uint32 mip_levels)
+		{
+			Uint64 texel_count = 0;
+			for (Uint32 mip = 0; mip < mip_levels; ++mip)
+			{
+				texel_count += (Uint64)std::max(width >> mip, 1u) * std::max(height >> mip, 1u);
+			}
+			return texel_count;
+		}
+
+		//rgba8 chain with mip 0 filled by f(x, y, texel)
+		template<typename F>
+		std::vector<Uint8> MakeMipChainRGBA8(Uint32 width, Uint32 height, F&& f)
+		{
+			std::vector<Uint8> data(GetMipChainTexelCount(width, height, GetMipLevelCount(width, height)) * 4, 0);
+			for (Uint32 y = 0; y < height; ++y)
+			{
+				for (Uint32 x = 0; x < width; ++x)
+				{
+					f(x, y, &data[((Uint64)y * width + x) * 4]);
+				}
+			}
+			return data;
+		}
+
+		Uint8 const* GetMipRGBA8(std::vector<Uint8> const& data, Uint32 width, Uint32 height, Uint32 mip)
+		{
+			return data.data() + GetMipChainTexelCount(width, height, mip) * 4;
+		}
+
+		Float ComputeCoverage(Uint8 const* texels, Uint64 texel_count, Float alpha_cutoff)
+		{
+			Uint64 covered = 0;
+			for (Uint64 i = 0; i < texel_count; ++i)
+			{
+				covered += texels[i * 4 + 3] > alpha_cutoff * 255.0f;
+			}
+			return (Float)covered / texel_count;
+		}
+
+		Float SRGBToLinear(Float c)
+		{
+			return c <= 0.04045f ? c / 12.92f : std::pow((c + 0.055f) / 1.055f, 2.4f);
+		}
+		Float LinearToSRGB(Float l)
+		{
+			return l <= 0.0031308f ? l * 12.92f : 1.055f * std::pow(l, 1.0f / 2.4f) - 0.055f;
+		}
+	}
+
+	TEST(MipGenerator, MipLevelCount)
+	{
+		EXPECT_EQ(GetMipLevelCount(1, 1), 1u);
+		EXPECT_EQ(GetMipLevelCount(2048, 1024), 12u);
+		EXPECT_EQ(GetMipLevelCount(5, 3), 3u);
+		EXPECT_EQ(GetMipLevelCount(1, 300), 9u);
+	}
+
+	TEST(MipGenerator, ConstantColorSurvivesChain)
+	{
+		Uint32 const width = 37, height = 20;
+		Uint32 const mip_levels = GetMipLevelCount(width, height);
+		for (Bool srgb : { false, true })
+		{
+			std::vector<Uint8> data = MakeMipChainRGBA8(width, height, [](Uint32, Uint32, Uint8* texel)
+				{
+					texel[0] = 17; texel[1] = 128; texel[2] = 240; texel[3] = 99;
+				});
+			GenerateMipChainRGBA8(data.data(), width, height, mip_levels, srgb);
+			for (Uint64 i = 0; i < data.size(); i += 4)
+			{
+				ASSERT_NEAR(data[i + 0], 17, srgb ? 1 : 0) << "srgb " << srgb << ", texel " << i / 4;
+				ASSERT_NEAR(data[i + 1], 128, srgb ? 1 : 0) << "srgb " << srgb << ", texel " << i / 4;
+				ASSERT_NEAR(data[i + 2], 240, srgb ? 1 : 0) << "srgb " << srgb << ", texel " << i / 4;
+				ASSERT_EQ(data[i + 3], 99) << "srgb " << srgb << ", texel " << i / 4;
+			}
+		}
+	}
+
+	//a black and white checker averages to half intensity, in sRGB that is half of the linear light and not code value 128
+	TEST(MipGenerator, CheckerAveragesInLinearSpace)
+	{
+		Uint32 const width = 16, height = 16;
+		Uint8 const expected_srgb = (Uint8)(LinearToSRGB(0.5f * (SRGBToLinear(0.0f) + SRGBToLinear(1.0f))) * 255.0f + 0.5f);
+		for (Bool srgb : { false, true })
+		{
+			std::vector<Uint8> data = MakeMipChainRGBA8(width, height, [](Uint32 x, Uint32 y, Uint8* texel)
+				{
+					Uint8 const value = (x + y) % 2 ? 255 : 0;
+					texel[0] = texel[1] = texel[2] = value;
+					texel[3] = 255;
+				});
+			GenerateMipChainRGBA8(data.data(), width, height, GetMipLevelCount(width, height), srgb);
+			Uint8 const* mip1 = GetMipRGBA8(data, width, height, 1);
+			for (Uint64 i = 0; i < (width / 2) * (height / 2); ++i)
+			{
+				ASSERT_EQ(mip1[i * 4], srgb ? expected_srgb : 128) << "srgb " << srgb << ", texel " << i;
+				ASSERT_EQ(mip1[i * 4 + 3], 255);
+			}
+		}
+		EXPECT_EQ(expected_srgb, 188);
+	}
+
+	//the 1 texel wide source clamps the column, so the next level averages pairs of rows
+	TEST(MipGenerator, OddSizesClampLastColumn)
+	{
+		Uint8 const column[] = { 0, 100, 200, 40 };
+		std::vector<Uint8> data = MakeMipChainRGBA8(1, 4, [&](Uint32, Uint32 y, Uint8* texel)
+			{
+				texel[0] = texel[1] = texel[2] = texel[3] = column[y];
+			});
+		GenerateMipChainRGBA8(data.data(), 1, 4, 3, false);
+		Uint8 const* mip1 = GetMipRGBA8(data, 1, 4, 1);
+		EXPECT_EQ(mip1[0], 50);
+		EXPECT_EQ(mip1[4], 120);
+		Uint8 const* mip2 = GetMipRGBA8(data, 1, 4, 2);
+		EXPECT_EQ(mip2[0], 85);
+	}
+
+	//sparse opaque texels over mostly transparent ones, a plain box filter pulls every level towards the mean alpha which is below the cutoff
+	TEST(MipGenerator, AlphaCoverageIsPreserved)
+	{
+		Uint32 const width = 256, height = 256;
+		Uint32 const mip_levels = GetMipLevelCount(width, height);
+		Float const alpha_cutoff = 0.5f;
+		std::vector<Uint8> alphas((Uint64)width * height);
+		RealRandomGenerator<Float> random_alpha(0.0f, 1.0f, std::mt19937{ 42 });
+		for (Uint8& alpha : alphas)
+		{
+			alpha = (Uint8)(std::pow(random_alpha(), 4.0f) * 255.0f + 0.5f);
+		}
+		auto Foliage = [&](Uint32 x, Uint32 y, Uint8* texel)
+			{
+				texel[0] = texel[1] = texel[2] = 255;
+				texel[3] = alphas[(Uint64)y * width + x];
+			};
+
+		std::vector<Uint8> data = MakeMipChainRGBA8(width, height, Foliage);
+		Float const coverage = ComputeCoverage(data.data(), (Uint64)width * height, alpha_cutoff);
+		GenerateMipChainRGBA8(data.data(), width, height, mip_levels, true, alpha_cutoff);
+
+		std::vector<Uint8> unscaled_data = MakeMipChainRGBA8(width, height, Foliage);
+		GenerateMipChainRGBA8(unscaled_data.data(), width, height, mip_levels, true);
+		EXPECT_EQ(ComputeCoverage(GetMipRGBA8(unscaled_data, width, height, 3), 32 * 32, alpha_cutoff), 0.0f);
+
+		//small levels can only represent coverage in steps of one texel
+		for (Uint32 mip = 1; mip < mip_levels; ++mip)
+		{
+			Uint64 const texel_count = (Uint64)std::max(width >> mip, 1u) * std::max(height >> mip, 1u);
+			if (texel_count < 64)
+			{
+				break;
+			}
+			Float const mip_coverage = ComputeCoverage(GetMipRGBA8(data, width, height, mip), texel_count, alpha_cutoff);
+			EXPECT_NEAR(mip_coverage, coverage, 0.05f) << "mip " << mip;
+		}
+		//color is untouched by the alpha fix up
+		EXPECT_EQ(GetMipRGBA8(data, width, height, 2)[0], 255);
+	}
+
+	TEST(MipGenerator, RGBA32FAveragesTexels)
+	{
+		Uint32 const width = 4, height = 2;
+		Uint32 const mip_levels = GetMipLevelCount(width, height);
+		std::vector<Float> data(GetMipChainTexelCount(width, height, mip_levels) * 4, 0.0f);
+		for (Uint32 i = 0; i < width * height; ++i)
+		{
+			data[i * 4 + 0] = (Float)i;
+			data[i * 4 + 1] = 1.0f;
+			data[i * 4 + 2] = -2.0f * i;
+			data[i * 4 + 3] = 0.5f;
+		}
+		GenerateMipChainRGBA32F(data.data(), width, height, mip_levels);
+		Float const* mip1 = data.data() + width * height * 4;
+		EXPECT_FLOAT_EQ(mip1[0], (0 + 1 + 4 + 5) / 4.0f);
+		EXPECT_FLOAT_EQ(mip1[4], (2 + 3 + 6 + 7) / 4.0f);
+		EXPECT_FLOAT_EQ(mip1[1], 1.0f);
+		EXPECT_FLOAT_EQ(mip1[2], -2.0f * (0 + 1 + 4 + 5) / 4.0f);
+		Float const* mip2 = mip1 + 2 * 4;
+		EXPECT_FLOAT_EQ(mip2[0], 3.5f);
+		EXPECT_FLOAT_EQ(mip2[3], 0.5f);
+	}
+}
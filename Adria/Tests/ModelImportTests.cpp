@@ -0,0 +1,111 @@
+#include <gtest/gtest.h>
+#include <fstream>
+#include "Rendering/SceneLoader.h"
+#include "Rendering/ModelCache.h"
+#include "Rendering/GeometryBufferCache.h"
+#include "Graphics/Null/NullDevice.h"
+#include "Core/Paths.h"
+#include "Utilities/ThreadPool.h"
+
+namespace adria
+{
+	namespace
+	{
+		std::vector<Char> ReadFileBytes(std::string const& path)
+		{
+			std::ifstream file(path, std::ios::binary);
+			return std::vector<Char>(std::istreambuf_iterator<Char>(file), std::istreambuf_iterator<Char>());
+		}
+
+		//cooks the model and returns the cache file exactly as written
+		std::vector<Char> CookModelBytes(ModelParameters const& params, Bool build_meshlets)
+		{
+			if (!SceneLoader::CookModel(params, build_meshlets))
+			{
+				return {};
+			}
+			return ReadFileBytes(GetModelCachePath(params, GetModelCookOptionsHash(params, build_meshlets)));
+		}
+	}
+
+	//without workers ParallelFor runs the jobs in order on the calling thread, with workers the primitives finish in any order,
+	//the cooked file must not depend on it
+	TEST(ModelImport, ParallelImportMatchesSerial)
+	{
+		struct TestModel
+		{
+			Char const* dir;
+			Char const* file;
+		};
+		for (TestModel const& model : { TestModel{ "ToyCar", "ToyCar.gltf" }, TestModel{ "pica_pica", "scene.gltf" } })
+		{
+			ModelParameters params{};
+			params.textures_path = paths::ModelsDir + model.dir + "/";
+			params.model_path = params.textures_path + model.file;
+			for (Bool build_meshlets : { false, true })
+			{
+				std::vector<Char> const serial = CookModelBytes(params, build_meshlets);
+				ASSERT_FALSE(serial.empty()) << model.dir;
+
+				g_ThreadPool.Initialize(4);
+				ASSERT_GT(g_ThreadPool.GetWorkerCount(), 1u);
+				std::vector<Char> const parallel = CookModelBytes(params, build_meshlets);
+				g_ThreadPool.Shutdown();
+
+				ASSERT_EQ(serial.size(), parallel.size()) << model.dir << ", meshlets " << build_meshlets;
+				auto mismatch = std::mismatch(serial.begin(), serial.end(), parallel.begin());
+				EXPECT_TRUE(mismatch.first == serial.end()) << model.dir << ", meshlets " << build_meshlets
+					<< ", first difference at byte " << (mismatch.first - serial.begin());
+			}
+		}
+	}
+
+	//the mesh streams and the cooked blob are the only copies of the geometry, the blob is written in place and no
+	//intermediate geometry buffer is allocated next to them
+	TEST(ModelImport, PeakHoldsStreamsAndCookedBlobOnly)
+	{
+		ModelParameters params{};
+		params.textures_path = paths::ModelsDir + "ToyCar/";
+		params.model_path = params.textures_path + "ToyCar.gltf";
+		for (Bool build_meshlets : { false, true })
+		{
+			Uint64 const base = MemoryTracker::GetCurrent(MemoryCategory::ModelImport);
+			{
+				CookedModel cooked_model;
+				ModelImportStats stats{};
+				ASSERT_TRUE(SceneLoader::CookModel(params, build_meshlets, &cooked_model, &stats));
+				EXPECT_GT(stats.stream_bytes, 0u);
+				EXPECT_GT(stats.cooked_bytes, cooked_model.GetGeometry().size());
+				EXPECT_EQ(stats.peak_bytes, std::max(stats.stream_peak_bytes, stats.stream_bytes + stats.cooked_bytes)) << "meshlets " << build_meshlets;
+				//the streams are gone, the cooked model owns the blob
+				EXPECT_EQ(MemoryTracker::GetCurrent(MemoryCategory::ModelImport), base + stats.cooked_bytes);
+			}
+			EXPECT_EQ(MemoryTracker::GetCurrent(MemoryCategory::ModelImport), base);
+		}
+	}
+
+	//the null device completes copies as soon as they are submitted, staging is still only freed by ReleaseCompletedUploads
+	TEST(ModelImport, CompletedUploadsReleaseGeometryStaging)
+	{
+		NullDevice gfx(nullptr);
+		g_GeometryBufferCache.Initialize(&gfx);
+		Uint64 const base = MemoryTracker::GetCurrent(MemoryCategory::GeometryStaging);
+		{
+			std::vector<Uint8> const geometry(4096, 0xab);
+			ArcGeometryBufferHandle handle = g_GeometryBufferCache.CreateAndInitializeGeometryBuffer(geometry);
+			GfxBuffer* geometry_buffer = g_GeometryBufferCache.GetGeometryBuffer(handle);
+			ASSERT_NE(geometry_buffer, nullptr);
+			EXPECT_EQ(geometry_buffer->GetSize(), geometry.size());
+			EXPECT_EQ(MemoryTracker::GetCurrent(MemoryCategory::GeometryStaging), base + geometry.size());
+
+			//creating the next buffer releases the finished upload before staging its own data
+			std::vector<Uint8> const second_geometry(1024, 0xcd);
+			ArcGeometryBufferHandle second_handle = g_GeometryBufferCache.CreateAndInitializeGeometryBuffer(second_geometry);
+			EXPECT_EQ(MemoryTracker::GetCurrent(MemoryCategory::GeometryStaging), base + second_geometry.size());
+
+			g_GeometryBufferCache.ReleaseCompletedUploads();
+			EXPECT_EQ(MemoryTracker::GetCurrent(MemoryCategory::GeometryStaging), base);
+		}
+		g_GeometryBufferCache.Shutdown();
+	}
+}
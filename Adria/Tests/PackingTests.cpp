@@ -0,0 +1,120 @@
+#include <gtest/gtest.h>
+#include "Math/Packing.h"
+#include "Utilities/Random.h"
+
+namespace adria
+{
+	namespace
+	{
+		std::vector<Vector3> MakeTestDirections()
+		{
+			std::vector<Vector3> directions =
+			{
+				Vector3(1, 0, 0), Vector3(-1, 0, 0), Vector3(0, 1, 0), Vector3(0, -1, 0), Vector3(0, 0, 1), Vector3(0, 0, -1),
+				Vector3(1, 1, 1), Vector3(-1, 1, -1), Vector3(1, -1, -1), Vector3(1e-4f, 0.0f, -1.0f)
+			};
+			RealRandomGenerator<Float> random(-1.0f, 1.0f, std::mt19937{ 42 });
+			while (directions.size() < 20000)
+			{
+				Vector3 const v(random(), random(), random());
+				if (v.LengthSquared() > 1e-4f && v.LengthSquared() <= 1.0f)
+				{
+					directions.push_back(v);
+				}
+			}
+			for (Vector3& direction : directions)
+			{
+				direction.Normalize();
+			}
+			return directions;
+		}
+
+		//in double, a float acos cannot resolve angles below ~0.02 degrees
+		Float64 AngleDegrees(Vector3 const& a, Vector3 const& b)
+		{
+			Float64 const dot = (Float64)a.x * b.x + (Float64)a.y * b.y + (Float64)a.z * b.z;
+			Float64 const length = std::sqrt(((Float64)a.x * a.x + (Float64)a.y * a.y + (Float64)a.z * a.z) * ((Float64)b.x * b.x + (Float64)b.y * b.y + (Float64)b.z * b.z));
+			return std::acos(std::clamp(dot / length, -1.0, 1.0)) * 180.0 / 3.14159265358979323846;
+		}
+	}
+
+	//snorm16 over the bounds, every axis is off by at most half a step of its extent
+	TEST(Packing, PositionSnorm16RoundTrip)
+	{
+		Vector3 const center(10.0f, -250.0f, 3.0f);
+		Vector3 const extents(5.0f, 1000.0f, 0.01f);
+		RealRandomGenerator<Float> random(-1.0f, 1.0f, std::mt19937{ 7 });
+		for (Uint32 i = 0; i < 10000; ++i)
+		{
+			Vector3 const position = center + Vector3(random(), random(), random()) * extents;
+			Vector3 const unpacked = UnpackPositionSnorm16x4(PackPositionSnorm16x4(position, center, extents), center, extents);
+			ASSERT_NEAR(unpacked.x, position.x, extents.x / 32767.0f * 0.5f + 1e-5f) << "position " << i;
+			ASSERT_NEAR(unpacked.y, position.y, extents.y / 32767.0f * 0.5f + 1e-3f) << "position " << i;
+			ASSERT_NEAR(unpacked.z, position.z, extents.z / 32767.0f * 0.5f + 1e-6f) << "position " << i;
+		}
+		//corners of the bounds are exact
+		Vector3 const corner = center + extents;
+		Vector3 const unpacked_corner = UnpackPositionSnorm16x4(PackPositionSnorm16x4(corner, center, extents), center, extents);
+		EXPECT_NEAR(unpacked_corner.y, corner.y, 1e-3f);
+	}
+
+	TEST(Packing, PositionFlatBounds)
+	{
+		Vector3 const center(1.0f, 2.0f, 3.0f);
+		Vector3 const extents(1.0f, 0.0f, 1.0f);
+		Vector3 const unpacked = UnpackPositionSnorm16x4(PackPositionSnorm16x4(Vector3(1.5f, 2.0f, 2.5f), center, extents), center, extents);
+		EXPECT_NEAR(unpacked.x, 1.5f, 1e-4f);
+		EXPECT_EQ(unpacked.y, 2.0f);
+		EXPECT_NEAR(unpacked.z, 2.5f, 1e-4f);
+	}
+
+	//16 bit octahedral normals stay well below a hundredth of a degree, including the folded lower hemisphere
+	TEST(Packing, NormalOctahedronRoundTrip)
+	{
+		Float64 max_error = 0.0;
+		for (Vector3 const& normal : MakeTestDirections())
+		{
+			Vector3 const unpacked = UnpackNormalOctahedron16x2(PackNormalOctahedron16x2(normal));
+			EXPECT_NEAR(unpacked.Length(), 1.0f, 1e-5f);
+			max_error = std::max(max_error, AngleDegrees(normal, unpacked));
+		}
+		EXPECT_LT(max_error, 0.01);
+	}
+
+	TEST(Packing, DegenerateNormalFallsBackToUp)
+	{
+		Vector3 const unpacked = UnpackNormalOctahedron16x2(PackNormalOctahedron16x2(Vector3(0.0f, 0.0f, 0.0f)));
+		EXPECT_NEAR(unpacked.z, 1.0f, 1e-5f);
+	}
+
+	//the second component gives one bit to the bitangent sign, so tangents are a bit coarser than normals
+	TEST(Packing, TangentOctahedronRoundTrip)
+	{
+		Float64 max_error = 0.0;
+		Uint32 index = 0;
+		for (Vector3 const& direction : MakeTestDirections())
+		{
+			Float const sign = index++ % 2 ? -1.0f : 1.0f;
+			Vector4 const unpacked = UnpackTangentOctahedron16x2(PackTangentOctahedron16x2(Vector4(direction.x, direction.y, direction.z, sign)));
+			ASSERT_EQ(unpacked.w, sign);
+			max_error = std::max(max_error, AngleDegrees(direction, Vector3(unpacked.x, unpacked.y, unpacked.z)));
+		}
+		EXPECT_LT(max_error, 0.02);
+	}
+
+	//half floats keep 11 significant bits, within [-1, 1] that is inside the 1/4096 budget the cook uses to choose half uvs
+	TEST(Packing, HalfUVRoundTrip)
+	{
+		RealRandomGenerator<Float> random(-1.0f, 1.0f, std::mt19937{ 3 });
+		for (Uint32 i = 0; i < 10000; ++i)
+		{
+			Vector2 const uv(random(), random());
+			Vector2 const unpacked = UnpackTwoFloatsFromUint32(PackTwoFloatsToUint32(uv.x, uv.y));
+			ASSERT_LE(std::abs(unpacked.x - uv.x), 1.0f / 4096.0f) << "uv " << i;
+			ASSERT_LE(std::abs(unpacked.y - uv.y), 1.0f / 4096.0f) << "uv " << i;
+		}
+		//tiled uvs exceed the budget, which is why the cook falls back to the float stream for them
+		Float const tiled = 37.123f;
+		EXPECT_GT(std::abs(UnpackTwoFloatsFromUint32(PackTwoFloatsToUint32(tiled, 0.0f)).x - tiled), 1.0f / 4096.0f);
+	}
+}
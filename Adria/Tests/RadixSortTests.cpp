@@ -0,0 +1,62 @@
+#include <gtest/gtest.h>
+#include "Utilities/RadixSort.h"
+#include "Utilities/ThreadPool.h"
+#include "Utilities/Random.h"
+
+namespace adria
+{
+	namespace
+	{
+		//few distinct keys so equal keys are common and stability is observable, values record the input order
+		std::vector<RadixSortItem> MakeRandomItems(Uint64 count, Uint64 key_mask, Uint32 seed)
+		{
+			IntRandomGenerator<Uint64, std::mt19937_64> random_key(0, std::numeric_limits<Uint64>::max(), std::mt19937_64{ seed });
+			std::vector<RadixSortItem> items(count);
+			for (Uint64 i = 0; i < count; ++i)
+			{
+				items[i] = RadixSortItem{ .key = random_key() & key_mask, .value = (Uint32)i };
+			}
+			return items;
+		}
+
+		void ExpectMatchesStableSort(std::vector<RadixSortItem> items)
+		{
+			std::vector<RadixSortItem> reference = items;
+			std::stable_sort(reference.begin(), reference.end(), [](RadixSortItem const& lhs, RadixSortItem const& rhs) { return lhs.key < rhs.key; });
+			std::vector<RadixSortItem> scratch(items.size());
+			RadixSort(items, scratch);
+			ASSERT_EQ(items.size(), reference.size());
+			for (Uint64 i = 0; i < items.size(); ++i)
+			{
+				ASSERT_EQ(items[i].key, reference[i].key) << "item " << i << " of " << items.size();
+				ASSERT_EQ(items[i].value, reference[i].value) << "item " << i << " of " << items.size();
+			}
+		}
+	}
+
+	TEST(RadixSort, MatchesStableSort)
+	{
+		for (Uint64 count : { 0, 1, 2, 100, 8191, 50000 })
+		{
+			ExpectMatchesStableSort(MakeRandomItems(count, 0xf0f0'0000'00ff'0f00ull, (Uint32)count));
+		}
+	}
+
+	//draw keys only use some bytes, passes over bytes shared by every key are skipped and must not break the ping pong between buffers
+	TEST(RadixSort, SkippedPassesKeepResult)
+	{
+		ExpectMatchesStableSort(MakeRandomItems(10000, 0xff00'0000'0000'0000ull, 1));
+		ExpectMatchesStableSort(MakeRandomItems(10000, 0x0000'0000'0000'00ffull, 2));
+		ExpectMatchesStableSort(MakeRandomItems(10000, 0, 3));
+		ExpectMatchesStableSort(MakeRandomItems(10000, 0x00ff'0000'ff00'0000ull, 4));
+	}
+
+	//large inputs split into chunks on the pool, the result has to be the same stable order
+	TEST(RadixSort, ParallelMatchesStableSort)
+	{
+		g_ThreadPool.Initialize(3);
+		ExpectMatchesStableSort(MakeRandomItems(200000, 0xffff'0000'ffff'00ffull, 5));
+		ExpectMatchesStableSort(MakeRandomItems(100003, 0x0000'0000'0000'0f0full, 6));
+		g_ThreadPool.Shutdown();
+	}
+}
@@ -0,0 +1,125 @@
+#include <atomic>
+#include <new>
+#include "RenderGraphTestUtil.h"
+
+//the test binary replaces the global allocation functions, so every heap allocation made while counting is seen,
+//not only the ones the render graph allocator knows about
+namespace
+{
+	std::atomic<adria::Bool>	g_CountHeapAllocations = false;
+	std::atomic<adria::Uint64> g_HeapAllocationCount = 0;
+
+	void* CountedAllocate(std::size_t size, std::size_t alignment)
+	{
+		if (g_CountHeapAllocations.load(std::memory_order_relaxed))
+		{
+			g_HeapAllocationCount.fetch_add(1, std::memory_order_relaxed);
+		}
+		size = std::max<std::size_t>(size, 1);
+		void* ptr = alignment > __STDCPP_DEFAULT_NEW_ALIGNMENT__ ? std::aligned_alloc(alignment, (size + alignment - 1) / alignment * alignment) : std::malloc(size);
+		if (!ptr)
+		{
+			throw std::bad_alloc();
+		}
+		return ptr;
+	}
+}
+
+void* operator new(std::size_t size) { return CountedAllocate(size, __STDCPP_DEFAULT_NEW_ALIGNMENT__); }
+void* operator new[](std::size_t size) { return CountedAllocate(size, __STDCPP_DEFAULT_NEW_ALIGNMENT__); }
+void* operator new(std::size_t size, std::align_val_t alignment) { return CountedAllocate(size, (std::size_t)alignment); }
+void* operator new[](std::size_t size, std::align_val_t alignment) { return CountedAllocate(size, (std::size_t)alignment); }
+void operator delete(void* ptr) noexcept { std::free(ptr); }
+void operator delete[](void* ptr) noexcept { std::free(ptr); }
+void operator delete(void* ptr, std::size_t) noexcept { std::free(ptr); }
+void operator delete[](void* ptr, std::size_t) noexcept { std::free(ptr); }
+void operator delete(void* ptr, std::align_val_t) noexcept { std::free(ptr); }
+void operator delete[](void* ptr, std::align_val_t) noexcept { std::free(ptr); }
+void operator delete(void* ptr, std::size_t, std::align_val_t) noexcept { std::free(ptr); }
+void operator delete[](void* ptr, std::size_t, std::align_val_t) noexcept { std::free(ptr); }
+
+namespace adria
+{
+	namespace
+	{
+		struct AllocationTestData
+		{
+			Uint32 frame_index;
+		};
+
+		struct AllocationTestPassData
+		{
+			RGRenderTargetId color;
+			RGTextureReadOnlyId color_read;
+			RGBufferReadWriteId buffer;
+		};
+
+		//every kind of declaration the renderer makes: blackboard data, events, views, pass data and lambda captures
+		void BuildAllocationTestGraph(RenderGraph& rg)
+		{
+			rg.GetBlackboard().Add<AllocationTestData>({ 7u });
+			RG_SCOPE(rg, "Allocation Test");
+			for (Uint32 i = 0; i < 16; ++i)
+			{
+				std::array<Uint64, 8> capture{ i };
+				rg.AddPass<AllocationTestPassData>("Write Pass",
+					[=](AllocationTestPassData& data, RenderGraphBuilder& builder)
+					{
+						RGResourceName const color_name = i % 2 ? RG_NAME(AllocationColorOdd) : RG_NAME(AllocationColorEven);
+						if (i < 2)
+						{
+							builder.DeclareTexture(color_name, MakeTestTextureDesc());
+							builder.DeclareBuffer(RG_NAME_IDX(AllocationBuffer, i), MakeTestBufferDesc());
+						}
+						else
+						{
+							data.color_read = builder.ReadTexture(i % 2 ? RG_NAME(AllocationColorEven) : RG_NAME(AllocationColorOdd));
+						}
+						data.color = builder.WriteRenderTarget(color_name, RGLoadStoreAccessOp::Clear_Preserve);
+						data.buffer = builder.WriteBuffer(RG_NAME_IDX(AllocationBuffer, i % 2));
+						builder.SetViewport(256, 256);
+					},
+					[=](AllocationTestPassData const& data, RenderGraphContext&) mutable
+					{
+						capture[1] += data.color.GetViewId();
+					}, RGPassType::Graphics, RGPassFlags::ForceNoCull);
+			}
+		}
+	}
+
+	//once the persistent allocator and the compile cache are warm, a frame with an unchanged graph must not touch the heap
+	TEST_F(RenderGraphTest, SteadyStateFrameDoesNotAllocate)
+	{
+		RGCompileCache cache;
+		auto RunCountedFrame = [&]()
+			{
+				Uint64 graph_heap_allocations = 0;
+				gfx.BeginFrame();
+				g_HeapAllocationCount = 0;
+				g_CountHeapAllocations = true;
+				{
+					RenderGraph rg(pool, &cache, &allocator);
+					Uint64 const graph_heap_allocations_at_start = RenderGraphTestAccess::GetHeapAllocationCount(rg);
+					BuildAllocationTestGraph(rg);
+					rg.Compile();
+					rg.Execute();
+					graph_heap_allocations = RenderGraphTestAccess::GetHeapAllocationCount(rg) - graph_heap_allocations_at_start;
+				}
+				g_CountHeapAllocations = false;
+				gfx.EndFrame();
+				return std::make_pair(graph_heap_allocations, g_HeapAllocationCount.load());
+			};
+
+		//the first frame creates the pool resources and compiles the graph, it has to be seen allocating
+		auto const [cold_graph_heap_allocations, cold_heap_allocations] = RunCountedFrame();
+		EXPECT_GT(cold_heap_allocations, 0u);
+		for (Uint32 i = 0; i < 3; ++i)
+		{
+			RunCountedFrame();
+		}
+		auto const [graph_heap_allocations, heap_allocations] = RunCountedFrame();
+		EXPECT_EQ(cache.GetMissCount(), 1u);
+		EXPECT_EQ(graph_heap_allocations, 0u);
+		EXPECT_EQ(heap_allocations, 0u);
+	}
+}
@@ -0,0 +1,161 @@
+#include <gtest/gtest.h>
+#include "RenderGraph/RenderGraphResourceSet.h"
+#include "RenderGraph/RenderGraphResourceId.h"
+
+namespace adria
+{
+	namespace
+	{
+		Bool IsPointerAligned(void const* ptr, Uint64 alignment)
+		{
+			return reinterpret_cast<Uint64>(ptr) % alignment == 0;
+		}
+
+		struct DestructorCounter
+		{
+			explicit DestructorCounter(Uint32& count) : count(count) {}
+			~DestructorCounter() { ++count; }
+			Uint32& count;
+		};
+	}
+
+	TEST(RenderGraphAllocator, AllocationsAreAligned)
+	{
+		RGAllocator allocator(1024);
+		for (Uint64 alignment : { 1ull, 4ull, 16ull, 64ull, 256ull })
+		{
+			void* small = allocator.Allocate(3, 1);
+			void* aligned = allocator.Allocate(8, alignment);
+			EXPECT_NE(small, nullptr);
+			EXPECT_TRUE(IsPointerAligned(aligned, alignment)) << "alignment " << alignment;
+		}
+	}
+
+	TEST(RenderGraphAllocator, OverflowBlocksAreAligned)
+	{
+		RGAllocator allocator(64);
+		for (Uint32 i = 0; i < 16; ++i)
+		{
+			void* allocation = allocator.Allocate(48, 256);
+			EXPECT_TRUE(IsPointerAligned(allocation, 256)) << "allocation " << i;
+			std::memset(allocation, 0xab, 48);
+		}
+		EXPECT_GT(allocator.GetOverflowBlockCount(), 0u);
+	}
+
+	TEST(RenderGraphAllocator, OverflowOnlyWhenBlockIsFull)
+	{
+		RGAllocator allocator(1024);
+		for (Uint32 i = 0; i < 16; ++i)
+		{
+			std::ignore = allocator.Allocate(64, 1);
+		}
+		EXPECT_EQ(allocator.GetOverflowBlockCount(), 0u);
+		std::ignore = allocator.Allocate(1, 1);
+		EXPECT_EQ(allocator.GetOverflowBlockCount(), 1u);
+		EXPECT_EQ(allocator.GetAllocationCount(), 17u);
+		EXPECT_EQ(allocator.GetSize(), 16u * 64u + 1u);
+	}
+
+	TEST(RenderGraphAllocator, AllocationLargerThanBlock)
+	{
+		RGAllocator allocator(64);
+		Uint8* allocation = allocator.AllocateArray<Uint8>(4096);
+		std::memset(allocation, 0xcd, 4096);
+		EXPECT_GE(allocator.GetCapacity(), 4096u + 64u);
+	}
+
+	TEST(RenderGraphAllocator, DestroysNonTrivialObjects)
+	{
+		Uint32 destroyed = 0;
+		{
+			RGAllocator allocator(64);
+			for (Uint32 i = 0; i < 8; ++i)
+			{
+				std::ignore = allocator.AllocateObject<DestructorCounter>(destroyed);
+			}
+			EXPECT_EQ(destroyed, 0u);
+		}
+		EXPECT_EQ(destroyed, 8u);
+	}
+
+	//a frame that overflowed grows the allocator once, the same frame after the reset fits in the merged block
+	TEST(RenderGraphAllocator, ResetDestroysObjectsAndMergesBlocks)
+	{
+		Uint32 destroyed = 0;
+		RGAllocator allocator(256);
+		auto RunFrame = [&]()
+			{
+				for (Uint32 i = 0; i < 8; ++i)
+				{
+					std::ignore = allocator.AllocateObject<DestructorCounter>(destroyed);
+					std::ignore = allocator.Allocate(100, 16);
+				}
+			};
+
+		RunFrame();
+		EXPECT_GT(allocator.GetOverflowBlockCount(), 0u);
+		Uint64 const capacity = allocator.GetCapacity();
+		allocator.Reset();
+		EXPECT_EQ(destroyed, 8u);
+		EXPECT_EQ(allocator.GetAllocationCount(), 0u);
+		EXPECT_EQ(allocator.GetCapacity(), capacity);
+
+		Uint64 const heap_allocations = allocator.GetHeapAllocationCount();
+		RunFrame();
+		EXPECT_EQ(allocator.GetOverflowBlockCount(), 0u);
+		EXPECT_EQ(allocator.GetHeapAllocationCount(), heap_allocations);
+		allocator.Reset();
+		EXPECT_EQ(destroyed, 16u);
+	}
+
+	//sets initialized with the resource count switch to an id -> slot table past a threshold, both lookups have to agree
+	TEST(RenderGraphResourceSet, InsertAndContains)
+	{
+		Uint32 const resource_count = 200;
+		for (Uint64 indexed_count : { 0u, resource_count })
+		{
+			RGAllocator allocator(256);
+			RGResourceSet<RGTextureId> set;
+			set.Initialize(allocator, indexed_count);
+			std::vector<Uint32> inserted;
+			for (Uint32 i = 0; i < resource_count; i += 3)
+			{
+				set.insert(RGTextureId(i));
+				set.insert(RGTextureId(i));
+				inserted.push_back(i);
+			}
+			ASSERT_EQ(set.size(), inserted.size());
+			Uint64 slot = 0;
+			for (RGTextureId id : set)
+			{
+				EXPECT_EQ(id.id, inserted[slot++]);
+			}
+			for (Uint32 i = 0; i < resource_count; ++i)
+			{
+				EXPECT_EQ(set.contains(RGTextureId(i)), i % 3 == 0) << "id " << i << ", indexed " << indexed_count;
+			}
+		}
+	}
+
+	TEST(RenderGraphResourceStateMap, UpdatesStateInPlace)
+	{
+		Uint32 const resource_count = 100;
+		RGAllocator allocator(256);
+		RGResourceStateMap<RGBufferId> state_map;
+		state_map.Initialize(allocator, resource_count);
+		for (Uint32 i = 0; i < resource_count; ++i)
+		{
+			state_map[RGBufferId(i)] = GfxResourceState::CopySrc;
+		}
+		for (Uint32 i = 0; i < resource_count; i += 2)
+		{
+			state_map[RGBufferId(i)] = GfxResourceState::ComputeUAV;
+		}
+		EXPECT_EQ(state_map.size(), resource_count);
+		for (Uint32 i = 0; i < resource_count; ++i)
+		{
+			EXPECT_EQ(state_map.at(RGBufferId(i)), i % 2 == 0 ? GfxResourceState::ComputeUAV : GfxResourceState::CopySrc);
+		}
+	}
+}
@@ -0,0 +1,137 @@
+#include "RenderGraphTestUtil.h"
+
+namespace adria
+{
+	namespace
+	{
+		void BuildSplitWindowGraph(RenderGraph& rg)
+		{
+			rg.AddPass<void>("Write Pass",
+				[=](RenderGraphBuilder& builder)
+				{
+					builder.DeclareTexture(RG_NAME(SplitTexture), MakeTestTextureDesc(64, 64));
+					builder.DeclareBuffer(RG_NAME_IDX(SplitBuffer, 0), MakeTestBufferDesc());
+					std::ignore = builder.WriteTexture(RG_NAME(SplitTexture));
+					std::ignore = builder.WriteBuffer(RG_NAME_IDX(SplitBuffer, 0));
+				},
+				[=](RenderGraphContext&) {}, RGPassType::Compute);
+			for (Uint32 i = 1; i < 3; ++i)
+			{
+				rg.AddPass<void>("Unrelated Pass",
+					[=](RenderGraphBuilder& builder)
+					{
+						builder.DeclareBuffer(RG_NAME_IDX(SplitBuffer, i), MakeTestBufferDesc());
+						std::ignore = builder.ReadBuffer(RG_NAME_IDX(SplitBuffer, i - 1));
+						std::ignore = builder.WriteBuffer(RG_NAME_IDX(SplitBuffer, i));
+					},
+					[=](RenderGraphContext&) {}, RGPassType::Compute);
+			}
+			rg.AddPass<void>("Read Pass",
+				[=](RenderGraphBuilder& builder)
+				{
+					std::ignore = builder.ReadBuffer(RG_NAME_IDX(SplitBuffer, 2));
+					std::ignore = builder.ReadTexture(RG_NAME(SplitTexture));
+				},
+				[=](RenderGraphContext&) {}, RGPassType::Compute, RGPassFlags::ForceNoCull);
+		}
+
+		void BuildFanOutGraph(RenderGraph& rg, Uint32 texture_count)
+		{
+			rg.AddPass<void>("Write Pass",
+				[=](RenderGraphBuilder& builder)
+				{
+					for (Uint32 i = 0; i < texture_count; ++i)
+					{
+						builder.DeclareTexture(RG_NAME_IDX(FanOutTexture, i), MakeTestTextureDesc(64, 64));
+						std::ignore = builder.WriteTexture(RG_NAME_IDX(FanOutTexture, i));
+					}
+				},
+				[=](RenderGraphContext&) {}, RGPassType::Compute);
+			rg.AddPass<void>("Read Pass",
+				[=](RenderGraphBuilder& builder)
+				{
+					for (Uint32 i = 0; i < texture_count; ++i)
+					{
+						std::ignore = builder.ReadTexture(RG_NAME_IDX(FanOutTexture, i));
+					}
+				},
+				[=](RenderGraphContext&) {}, RGPassType::Compute, RGPassFlags::ForceNoCull);
+		}
+	}
+
+	class RenderGraphBarrierTest : public RenderGraphTest
+	{
+	protected:
+		template<typename BuildFunc>
+		NullFrameStats RunCountedFrame(BuildFunc&& build, Bool split_barriers)
+		{
+			split_barriers_override.Set(split_barriers ? "1" : "0");
+			RunFrame(std::forward<BuildFunc>(build));
+			return GetLastFrameStats();
+		}
+
+		ScopedConsoleVariable split_barriers_override{ "rg.SplitBarriers", "1" };
+	};
+
+	//the texture is written in level 0 and read in level 3, so its transition can begin right after level 0
+	TEST_F(RenderGraphBarrierTest, SplitsTransitionAcrossIdleLevels)
+	{
+		NullFrameStats const full = RunCountedFrame(BuildSplitWindowGraph, false);
+		NullFrameStats const split = RunCountedFrame(BuildSplitWindowGraph, true);
+		EXPECT_EQ(full.split_barriers, 0u);
+		EXPECT_EQ(split.split_barriers, 2u);
+		EXPECT_EQ(split.barriers, full.barriers + 1);
+	}
+
+	TEST_F(RenderGraphBarrierTest, AdjacentLevelsDoNotSplit)
+	{
+		NullFrameStats const stats = RunCountedFrame([](RenderGraph& rg) { BuildFanOutGraph(rg, 1); }, true);
+		EXPECT_EQ(stats.split_barriers, 0u);
+	}
+
+	//every texture needs its creation, the write to read transition and the release, the transitions of a level go out in one batch
+	TEST_F(RenderGraphBarrierTest, BarriersOfLevelShareOneBatch)
+	{
+		NullFrameStats const one = RunCountedFrame([](RenderGraph& rg) { BuildFanOutGraph(rg, 1); }, true);
+		NullFrameStats const four = RunCountedFrame([](RenderGraph& rg) { BuildFanOutGraph(rg, 4); }, true);
+		EXPECT_EQ(one.barriers, 3u);
+		EXPECT_EQ(four.barriers, 4 * one.barriers);
+		EXPECT_EQ(one.barrier_batches, 3u);
+		EXPECT_EQ(four.barrier_batches, one.barrier_batches);
+	}
+
+	TEST_F(RenderGraphBarrierTest, NoBarrierBetweenReadsInSameState)
+	{
+		auto BuildGraph = [](RenderGraph& rg, Bool second_read)
+			{
+				rg.AddPass<void>("Write Pass",
+					[=](RenderGraphBuilder& builder)
+					{
+						builder.DeclareTexture(RG_NAME(ReadTexture), MakeTestTextureDesc(64, 64));
+						std::ignore = builder.WriteTexture(RG_NAME(ReadTexture));
+					},
+					[=](RenderGraphContext&) {}, RGPassType::Compute);
+				rg.AddPass<void>("First Read Pass",
+					[=](RenderGraphBuilder& builder)
+					{
+						builder.DeclareBuffer(RG_NAME(ReadBuffer), MakeTestBufferDesc());
+						std::ignore = builder.ReadTexture(RG_NAME(ReadTexture));
+						std::ignore = builder.WriteBuffer(RG_NAME(ReadBuffer));
+					},
+					[=](RenderGraphContext&) {}, RGPassType::Compute);
+				rg.AddPass<void>("Second Read Pass",
+					[=](RenderGraphBuilder& builder)
+					{
+						std::ignore = builder.ReadBuffer(RG_NAME(ReadBuffer));
+						if (second_read)
+						{
+							std::ignore = builder.ReadTexture(RG_NAME(ReadTexture));
+						}
+					},
+					[=](RenderGraphContext&) {}, RGPassType::Compute, RGPassFlags::ForceNoCull);
+			};
+		NullFrameStats const one_read = RunCountedFrame([&](RenderGraph& rg) { BuildGraph(rg, false); }, true);
+		NullFrameStats const two_reads = RunCountedFrame([&](RenderGraph& rg) { BuildGraph(rg, true); }, true);
+		EXPECT_EQ(two_reads.barriers, one_read.barriers);
+	}
+}
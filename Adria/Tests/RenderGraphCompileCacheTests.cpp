@@ -0,0 +1,123 @@
+#include "RenderGraphTestUtil.h"
+
+namespace adria
+{
+	namespace
+	{
+		struct TestGraphParams
+		{
+			Float clear_red = 0.0f;
+			Uint32 read_mip_count = 1;
+			Uint32 buffer_read_offset = 0;
+			Bool extra_pass = false;
+		};
+
+		void BuildTestGraph(RenderGraph& rg, TestGraphParams const& params)
+		{
+			rg.AddPass<void>("Write Pass",
+				[=](RenderGraphBuilder& builder)
+				{
+					RGTextureDesc color_desc = MakeTestTextureDesc();
+					color_desc.mip_levels = 2;
+					color_desc.clear_value = GfxClearValue(params.clear_red, 0.0f, 0.0f, 0.0f);
+					builder.DeclareTexture(RG_NAME(TestColor), color_desc);
+					builder.DeclareBuffer(RG_NAME(TestBuffer), MakeTestBufferDesc());
+					builder.WriteRenderTarget(RG_NAME(TestColor), RGLoadStoreAccessOp::Clear_Preserve, 0, 1);
+					std::ignore = builder.WriteBuffer(RG_NAME(TestBuffer));
+					builder.SetViewport(256, 256);
+				},
+				[=](RenderGraphContext&) {});
+
+			rg.AddPass<void>("Read Pass",
+				[=](RenderGraphBuilder& builder)
+				{
+					std::ignore = builder.ReadTexture(RG_NAME(TestColor), ReadAccess_AllShader, 0, params.read_mip_count);
+					std::ignore = builder.ReadBuffer(RG_NAME(TestBuffer), ReadAccess_AllShader, params.buffer_read_offset);
+				},
+				[=](RenderGraphContext&) {}, RGPassType::Compute, RGPassFlags::ForceNoCull);
+
+			if (params.extra_pass)
+			{
+				rg.AddPass<void>("Extra Pass",
+					[=](RenderGraphBuilder& builder)
+					{
+						builder.DummyReadTexture(RG_NAME(TestColor));
+					},
+					[=](RenderGraphContext&) {}, RGPassType::Compute, RGPassFlags::ForceNoCull);
+			}
+		}
+	}
+
+	class RenderGraphCompileCacheTest : public RenderGraphTest
+	{
+	protected:
+		void RunTestFrame(TestGraphParams const& params)
+		{
+			RunFrame([&](RenderGraph& rg) { BuildTestGraph(rg, params); }, &cache);
+		}
+
+		RGCompileCache cache;
+	};
+
+	TEST_F(RenderGraphCompileCacheTest, UnchangedTopologyHits)
+	{
+		RunTestFrame({});
+		RunTestFrame({});
+		RunTestFrame({});
+		EXPECT_EQ(cache.GetMissCount(), 1u);
+		EXPECT_EQ(cache.GetHitCount(), 2u);
+	}
+
+	TEST_F(RenderGraphCompileCacheTest, CachedFrameRecordsSameBarriers)
+	{
+		RunTestFrame({});
+		Uint64 const cold_barriers = GetLastFrameStats().barriers;
+		RunTestFrame({});
+		ASSERT_EQ(cache.GetHitCount(), 1u);
+		EXPECT_EQ(GetLastFrameStats().barriers, cold_barriers);
+	}
+
+	TEST_F(RenderGraphCompileCacheTest, ClearValueChangeInvalidates)
+	{
+		RunTestFrame({});
+		RunTestFrame({ .clear_red = 1.0f });
+		EXPECT_EQ(cache.GetMissCount(), 2u);
+		EXPECT_EQ(cache.GetHitCount(), 0u);
+		RunTestFrame({ .clear_red = 1.0f });
+		EXPECT_EQ(cache.GetHitCount(), 1u);
+	}
+
+	TEST_F(RenderGraphCompileCacheTest, TextureViewChangeInvalidates)
+	{
+		RunTestFrame({});
+		RunTestFrame({ .read_mip_count = 2 });
+		EXPECT_EQ(cache.GetMissCount(), 2u);
+		EXPECT_EQ(cache.GetHitCount(), 0u);
+	}
+
+	TEST_F(RenderGraphCompileCacheTest, BufferViewChangeInvalidates)
+	{
+		RunTestFrame({});
+		RunTestFrame({ .buffer_read_offset = 256 });
+		EXPECT_EQ(cache.GetMissCount(), 2u);
+		EXPECT_EQ(cache.GetHitCount(), 0u);
+	}
+
+	TEST_F(RenderGraphCompileCacheTest, PassChangeInvalidates)
+	{
+		RunTestFrame({});
+		RunTestFrame({ .extra_pass = true });
+		RunTestFrame({});
+		EXPECT_EQ(cache.GetMissCount(), 3u);
+		EXPECT_EQ(cache.GetHitCount(), 0u);
+	}
+
+	TEST_F(RenderGraphCompileCacheTest, InvalidateForcesRecompile)
+	{
+		RunTestFrame({});
+		cache.Invalidate();
+		RunTestFrame({});
+		EXPECT_EQ(cache.GetMissCount(), 2u);
+		EXPECT_EQ(cache.GetHitCount(), 0u);
+	}
+}
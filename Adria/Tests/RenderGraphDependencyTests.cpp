@@ -0,0 +1,224 @@
+#include "RenderGraphTestUtil.h"
+#include "Utilities/Random.h"
+
+namespace adria
+{
+	namespace
+	{
+		struct TestPassDesc
+		{
+			std::vector<Uint32> texture_reads;
+			std::vector<Uint32> texture_writes;
+			std::vector<Uint32> buffer_reads;
+			std::vector<Uint32> buffer_writes;
+		};
+
+		//pass 0 declares and writes every resource, test passes follow it so pass k of the list is graph pass k + 1
+		void BuildTestGraph(RenderGraph& rg, Uint32 texture_count, Uint32 buffer_count, std::vector<TestPassDesc> const& pass_descs)
+		{
+			rg.AddPass<void>("Declare Pass",
+				[=](RenderGraphBuilder& builder)
+				{
+					for (Uint32 i = 0; i < texture_count; ++i)
+					{
+						builder.DeclareTexture(RG_NAME_IDX(DependencyTexture, i), MakeTestTextureDesc(64, 64));
+						std::ignore = builder.WriteTexture(RG_NAME_IDX(DependencyTexture, i));
+					}
+					for (Uint32 i = 0; i < buffer_count; ++i)
+					{
+						builder.DeclareBuffer(RG_NAME_IDX(DependencyBuffer, i), MakeTestBufferDesc());
+						std::ignore = builder.WriteBuffer(RG_NAME_IDX(DependencyBuffer, i));
+					}
+				},
+				[=](RenderGraphContext&) {}, RGPassType::Compute, RGPassFlags::ForceNoCull);
+
+			for (TestPassDesc const& pass_desc : pass_descs)
+			{
+				rg.AddPass<void>("Test Pass",
+					[=](RenderGraphBuilder& builder)
+					{
+						for (Uint32 i : pass_desc.texture_reads)  std::ignore = builder.ReadTexture(RG_NAME_IDX(DependencyTexture, i));
+						for (Uint32 i : pass_desc.texture_writes) std::ignore = builder.WriteTexture(RG_NAME_IDX(DependencyTexture, i));
+						for (Uint32 i : pass_desc.buffer_reads)   std::ignore = builder.ReadBuffer(RG_NAME_IDX(DependencyBuffer, i));
+						for (Uint32 i : pass_desc.buffer_writes)  std::ignore = builder.WriteBuffer(RG_NAME_IDX(DependencyBuffer, i));
+					},
+					[=](RenderGraphContext&) {}, RGPassType::Compute, RGPassFlags::ForceNoCull);
+			}
+		}
+
+		Bool HasEdge(std::vector<std::vector<Uint64>> const& adjacency_lists, Uint64 from, Uint64 to)
+		{
+			return std::find(adjacency_lists[from].begin(), adjacency_lists[from].end(), to) != adjacency_lists[from].end();
+		}
+
+		Bool Contains(std::vector<Uint32> const& ids, Uint32 id)
+		{
+			return std::find(ids.begin(), ids.end(), id) != ids.end();
+		}
+
+		//two accesses to the same resource conflict unless both are reads
+		Bool HasHazard(std::vector<Uint32> const& reads_a, std::vector<Uint32> const& writes_a,
+					   std::vector<Uint32> const& reads_b, std::vector<Uint32> const& writes_b)
+		{
+			for (Uint32 id : writes_a)
+			{
+				if (Contains(reads_b, id) || Contains(writes_b, id)) return true;
+			}
+			for (Uint32 id : reads_a)
+			{
+				if (Contains(writes_b, id)) return true;
+			}
+			return false;
+		}
+	}
+
+	class RenderGraphDependencyTest : public RenderGraphTest
+	{
+	protected:
+		void CompileTestGraph(Uint32 texture_count, Uint32 buffer_count, std::vector<TestPassDesc> const& pass_descs)
+		{
+			RunFrame([&](RenderGraph& rg) { BuildTestGraph(rg, texture_count, buffer_count, pass_descs); },
+				[&](RenderGraph const& rg)
+				{
+					adjacency_lists = RenderGraphTestAccess::GetAdjacencyLists(rg);
+					sorted_passes = RenderGraphTestAccess::GetTopologicallySortedPasses(rg);
+					level_count = RenderGraphTestAccess::GetDependencyLevelCount(rg);
+				});
+		}
+
+		std::vector<std::vector<Uint64>> adjacency_lists;
+		std::vector<Uint64> sorted_passes;
+		Uint64 level_count = 0;
+	};
+
+	TEST_F(RenderGraphDependencyTest, ReadAfterWrite)
+	{
+		CompileTestGraph(1, 1, { { .texture_writes = { 0 }, .buffer_writes = { 0 } }, { .texture_reads = { 0 } }, { .buffer_reads = { 0 } } });
+		EXPECT_TRUE(HasEdge(adjacency_lists, 1, 2));
+		EXPECT_TRUE(HasEdge(adjacency_lists, 1, 3));
+		EXPECT_FALSE(HasEdge(adjacency_lists, 2, 3));
+		EXPECT_EQ(level_count, 3u);
+	}
+
+	TEST_F(RenderGraphDependencyTest, WriteAfterRead)
+	{
+		CompileTestGraph(1, 1, { { .texture_reads = { 0 }, .buffer_reads = { 0 } }, { .texture_writes = { 0 } }, { .buffer_writes = { 0 } } });
+		EXPECT_TRUE(HasEdge(adjacency_lists, 1, 2));
+		EXPECT_TRUE(HasEdge(adjacency_lists, 1, 3));
+		EXPECT_FALSE(HasEdge(adjacency_lists, 2, 3));
+	}
+
+	TEST_F(RenderGraphDependencyTest, WriteAfterWrite)
+	{
+		CompileTestGraph(1, 1, { { .texture_writes = { 0 } }, { .texture_writes = { 0 } }, { .buffer_writes = { 0 } }, { .buffer_writes = { 0 } } });
+		EXPECT_TRUE(HasEdge(adjacency_lists, 1, 2));
+		EXPECT_TRUE(HasEdge(adjacency_lists, 3, 4));
+		EXPECT_FALSE(HasEdge(adjacency_lists, 2, 3));
+	}
+
+	TEST_F(RenderGraphDependencyTest, ReadersShareLevel)
+	{
+		CompileTestGraph(1, 0, { { .texture_reads = { 0 } }, { .texture_reads = { 0 } }, { .texture_reads = { 0 } } });
+		EXPECT_EQ(adjacency_lists[0].size(), 3u);
+		for (Uint64 i = 1; i < adjacency_lists.size(); ++i)
+		{
+			EXPECT_TRUE(adjacency_lists[i].empty()) << "pass " << i;
+		}
+		EXPECT_EQ(level_count, 2u);
+	}
+
+	TEST_F(RenderGraphDependencyTest, EdgesAreNotDuplicated)
+	{
+		CompileTestGraph(3, 3, { { .texture_reads = { 0, 1, 2 }, .buffer_reads = { 0, 1, 2 } } });
+		EXPECT_EQ(adjacency_lists[0].size(), 1u);
+	}
+
+	TEST_F(RenderGraphDependencyTest, DeepChainSortsWithoutRecursion)
+	{
+		Uint32 const pass_count = 20000;
+		std::vector<TestPassDesc> pass_descs(pass_count, TestPassDesc{ .buffer_writes = { 0 } });
+		CompileTestGraph(0, 1, pass_descs);
+		ASSERT_EQ(sorted_passes.size(), pass_count + 1);
+		for (Uint64 i = 0; i < sorted_passes.size(); ++i)
+		{
+			ASSERT_EQ(sorted_passes[i], i);
+		}
+		EXPECT_EQ(level_count, pass_count + 1);
+	}
+
+	//every edge has to be a real hazard and every hazard has to be ordered by some path of edges
+	TEST_F(RenderGraphDependencyTest, RandomizedGraphMatchesPairwiseReference)
+	{
+		Uint32 const texture_count = 6, buffer_count = 6, pass_count = 48;
+		IntRandomGenerator<Uint32> random_id(0, 5, std::mt19937{ 42 });
+		IntRandomGenerator<Uint32> random_access(0, 3, std::mt19937{ 7 });
+
+		std::vector<TestPassDesc> pass_descs(pass_count);
+		for (TestPassDesc& pass_desc : pass_descs)
+		{
+			for (Uint32 k = 0; k < 3; ++k)
+			{
+				Uint32 const id = random_id();
+				Uint32 const access = random_access();
+				std::vector<Uint32>& reads = access < 2 ? pass_desc.texture_reads : pass_desc.buffer_reads;
+				std::vector<Uint32>& writes = access < 2 ? pass_desc.texture_writes : pass_desc.buffer_writes;
+				if (Contains(reads, id) || Contains(writes, id)) continue;
+				(access % 2 == 0 ? reads : writes).push_back(id);
+			}
+		}
+		pass_descs.insert(pass_descs.begin(), TestPassDesc{});
+		for (Uint32 i = 0; i < texture_count; ++i) pass_descs[0].texture_writes.push_back(i);
+		for (Uint32 i = 0; i < buffer_count; ++i) pass_descs[0].buffer_writes.push_back(i);
+
+		std::vector<TestPassDesc> test_pass_descs(pass_descs.begin() + 1, pass_descs.end());
+		CompileTestGraph(texture_count, buffer_count, test_pass_descs);
+		Uint64 const graph_pass_count = pass_descs.size();
+		ASSERT_EQ(adjacency_lists.size(), graph_pass_count);
+
+		auto PassHazard = [&](Uint64 i, Uint64 j)
+			{
+				TestPassDesc const& a = pass_descs[i];
+				TestPassDesc const& b = pass_descs[j];
+				return HasHazard(a.texture_reads, a.texture_writes, b.texture_reads, b.texture_writes) ||
+					   HasHazard(a.buffer_reads, a.buffer_writes, b.buffer_reads, b.buffer_writes);
+			};
+
+		std::vector<std::vector<Bool>> reachable(graph_pass_count, std::vector<Bool>(graph_pass_count, false));
+		for (Uint64 i = graph_pass_count; i-- > 0;)
+		{
+			std::vector<Uint64> sorted_edges = adjacency_lists[i];
+			std::sort(sorted_edges.begin(), sorted_edges.end());
+			EXPECT_EQ(std::unique(sorted_edges.begin(), sorted_edges.end()), sorted_edges.end()) << "pass " << i;
+			for (Uint64 j : adjacency_lists[i])
+			{
+				ASSERT_LT(i, j);
+				EXPECT_TRUE(PassHazard(i, j)) << "edge " << i << " -> " << j;
+				reachable[i][j] = true;
+				for (Uint64 k = 0; k < graph_pass_count; ++k)
+				{
+					if (reachable[j][k]) reachable[i][k] = true;
+				}
+			}
+		}
+		for (Uint64 i = 0; i < graph_pass_count; ++i)
+		{
+			for (Uint64 j = i + 1; j < graph_pass_count; ++j)
+			{
+				if (PassHazard(i, j))
+				{
+					EXPECT_TRUE(reachable[i][j]) << "unordered hazard " << i << " -> " << j;
+				}
+			}
+		}
+
+		std::vector<Uint64> position(graph_pass_count);
+		for (Uint64 i = 0; i < sorted_passes.size(); ++i) position[sorted_passes[i]] = i;
+		for (Uint64 i = 0; i < graph_pass_count; ++i)
+		{
+			for (Uint64 j : adjacency_lists[i])
+			{
+				EXPECT_LT(position[i], position[j]);
+			}
+		}
+	}
+}
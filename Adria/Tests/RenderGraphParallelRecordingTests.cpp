@@ -0,0 +1,158 @@
+#include <mutex>
+#include "RenderGraphTestUtil.h"
+#include "Utilities/ThreadPool.h"
+
+namespace adria
+{
+	namespace
+	{
+		constexpr Uint32 ChainCount = 4;
+		constexpr Uint32 ChainLength = 16;
+
+		struct RecordedPass
+		{
+			Uint32 pass;
+			GfxCommandList* cmd_list;
+		};
+
+		struct PassRecorder
+		{
+			std::mutex mutex;
+			std::vector<RecordedPass> recorded;
+
+			void Record(Uint32 pass, GfxCommandList* cmd_list)
+			{
+				std::lock_guard lock(mutex);
+				recorded.push_back(RecordedPass{ pass, cmd_list });
+			}
+		};
+
+		//independent chains that alternate between writing and reading their texture, every level holds one pass of each chain
+		void BuildChainsGraph(RenderGraph& rg, PassRecorder& recorder)
+		{
+			for (Uint32 k = 0; k < ChainLength; ++k)
+			{
+				for (Uint32 c = 0; c < ChainCount; ++c)
+				{
+					Uint32 const pass = k * ChainCount + c;
+					rg.AddPass<void>("Chain Pass",
+						[=](RenderGraphBuilder& builder)
+						{
+							if (k == 0)
+							{
+								builder.DeclareTexture(RG_NAME_IDX(ParallelChainTexture, c), MakeTestTextureDesc(64, 64));
+							}
+							if (k % 2 == 0)
+							{
+								std::ignore = builder.WriteTexture(RG_NAME_IDX(ParallelChainTexture, c));
+							}
+							else
+							{
+								std::ignore = builder.ReadTexture(RG_NAME_IDX(ParallelChainTexture, c));
+							}
+						},
+						[=, &recorder](RenderGraphContext& context)
+						{
+							GfxCommandList* cmd_list = context.GetCommandList();
+							cmd_list->Dispatch(1, 1, 1);
+							recorder.Record(pass, cmd_list);
+						}, RGPassType::Compute, RGPassFlags::ForceNoCull);
+				}
+			}
+		}
+	}
+
+	class RenderGraphParallelRecordingTest : public RenderGraphTest, public testing::WithParamInterface<Bool>
+	{
+	protected:
+		static void SetUpTestSuite()
+		{
+			g_ThreadPool.Initialize(4);
+		}
+		static void TearDownTestSuite()
+		{
+			g_ThreadPool.Shutdown();
+		}
+
+		void RunChainsFrame(PassRecorder& recorder, Bool parallel)
+		{
+			gfx.BeginFrame();
+			{
+				RenderGraph rg(pool);
+				BuildChainsGraph(rg, recorder);
+				rg.Compile();
+				batch_count = RenderGraphTestAccess::GetExecutionBatchCount(rg);
+				if (parallel)
+				{
+					RenderGraphTestAccess::ExecuteMultithreaded(rg);
+				}
+				else
+				{
+					rg.Execute();
+				}
+			}
+			gfx.EndFrame();
+		}
+
+		//one pass per command list so every batch boundary is exercised
+		ScopedConsoleVariable min_passes_per_command_list{ "rg.MinPassesPerCommandList", "1" };
+		ScopedConsoleVariable split_barriers{ "rg.SplitBarriers", GetParam() ? "1" : "0" };
+		Uint64 batch_count = 0;
+	};
+
+	TEST_P(RenderGraphParallelRecordingTest, MatchesSerialRecording)
+	{
+		PassRecorder serial;
+		RunChainsFrame(serial, false);
+		NullFrameStats const serial_stats = GetLastFrameStats();
+
+		PassRecorder parallel;
+		RunChainsFrame(parallel, true);
+		NullFrameStats const parallel_stats = GetLastFrameStats();
+
+		if (g_ThreadPool.GetWorkerCount() > 1)
+		{
+			EXPECT_GT(batch_count, 1u);
+		}
+
+		ASSERT_EQ(serial.recorded.size(), ChainCount * ChainLength);
+		ASSERT_EQ(parallel.recorded.size(), serial.recorded.size());
+		for (RecordedPass const& recorded : serial.recorded)
+		{
+			EXPECT_EQ(recorded.cmd_list, serial.recorded.front().cmd_list);
+		}
+
+		//every command list holds a contiguous run of the serial order, concatenated in batch order they give the serial order back
+		std::vector<std::vector<Uint32>> cmd_list_passes;
+		std::vector<GfxCommandList*> cmd_lists;
+		for (RecordedPass const& recorded : parallel.recorded)
+		{
+			auto it = std::find(cmd_lists.begin(), cmd_lists.end(), recorded.cmd_list);
+			if (it == cmd_lists.end())
+			{
+				cmd_lists.push_back(recorded.cmd_list);
+				cmd_list_passes.emplace_back();
+				it = cmd_lists.end() - 1;
+			}
+			cmd_list_passes[it - cmd_lists.begin()].push_back(recorded.pass);
+		}
+		EXPECT_EQ(cmd_lists.size(), batch_count);
+
+		std::vector<Uint32> serial_order;
+		for (RecordedPass const& recorded : serial.recorded) serial_order.push_back(recorded.pass);
+		auto SerialPosition = [&](Uint32 pass) { return std::find(serial_order.begin(), serial_order.end(), pass) - serial_order.begin(); };
+		std::sort(cmd_list_passes.begin(), cmd_list_passes.end(), [&](auto const& a, auto const& b) { return SerialPosition(a.front()) < SerialPosition(b.front()); });
+
+		std::vector<Uint32> parallel_order;
+		for (std::vector<Uint32> const& passes : cmd_list_passes)
+		{
+			parallel_order.insert(parallel_order.end(), passes.begin(), passes.end());
+		}
+		EXPECT_EQ(parallel_order, serial_order);
+
+		EXPECT_EQ(parallel_stats.dispatches, serial_stats.dispatches);
+		EXPECT_EQ(parallel_stats.barriers, serial_stats.barriers);
+	}
+
+	INSTANTIATE_TEST_SUITE_P(SplitBarriers, RenderGraphParallelRecordingTest, testing::Bool());
+}
@@ -0,0 +1,138 @@
+#include <gtest/gtest.h>
+#include "RenderGraph/RenderGraphResourceAliasing.h"
+#include "Utilities/Random.h"
+
+namespace adria
+{
+	namespace
+	{
+		constexpr Uint64 ScratchSize = 64 * 1024;
+
+		Bool MemoryOverlaps(Uint64 offset_a, Uint64 size_a, Uint64 offset_b, Uint64 size_b)
+		{
+			return offset_a < offset_b + size_b && offset_b < offset_a + size_a;
+		}
+
+		Bool LifetimesOverlap(RGAliasingRequest const& a, RGAliasingRequest const& b)
+		{
+			return a.first_pass <= b.last_pass && b.first_pass <= a.last_pass;
+		}
+
+		void ExpectValidPlacement(std::span<RGAliasingRequest const> requests, std::span<Uint64 const> offsets, RGAliasingStats const& stats)
+		{
+			ASSERT_EQ(offsets.size(), requests.size());
+			for (Uint64 i = 0; i < requests.size(); ++i)
+			{
+				EXPECT_EQ(offsets[i] % std::max<Uint64>(requests[i].alignment, 1), 0u) << "request " << i;
+				EXPECT_LE(offsets[i] + requests[i].size, stats.heap_size) << "request " << i;
+				for (Uint64 j = i + 1; j < requests.size(); ++j)
+				{
+					if (LifetimesOverlap(requests[i], requests[j]))
+					{
+						EXPECT_FALSE(MemoryOverlaps(offsets[i], requests[i].size, offsets[j], requests[j].size)) << "requests " << i << " and " << j;
+					}
+				}
+			}
+		}
+	}
+
+	TEST(RenderGraphResourceAliasing, EmptyInput)
+	{
+		RGAllocator allocator(ScratchSize);
+		RGAliasingStats const stats = SolveResourceAliasing({}, {}, allocator);
+		EXPECT_EQ(stats.heap_size, 0u);
+		EXPECT_EQ(stats.naive_size, 0u);
+		EXPECT_EQ(stats.resource_count, 0u);
+	}
+
+	TEST(RenderGraphResourceAliasing, DisjointLifetimesShareMemory)
+	{
+		RGAliasingRequest const requests[] =
+		{
+			{ .size = 1024, .alignment = 256, .first_pass = 0, .last_pass = 1 },
+			{ .size = 512,  .alignment = 256, .first_pass = 2, .last_pass = 3 },
+			{ .size = 768,  .alignment = 256, .first_pass = 4, .last_pass = 9 },
+		};
+		RGAllocator allocator(ScratchSize);
+		std::vector<Uint64> offsets(std::size(requests));
+		RGAliasingStats const stats = SolveResourceAliasing(requests, offsets, allocator);
+
+		EXPECT_EQ(offsets, (std::vector<Uint64>{ 0, 0, 0 }));
+		EXPECT_EQ(stats.heap_size, 1024u);
+		EXPECT_EQ(stats.naive_size, 1024u + 512u + 768u);
+		EXPECT_EQ(stats.resource_count, 3u);
+	}
+
+	TEST(RenderGraphResourceAliasing, OverlappingLifetimesDoNotShareMemory)
+	{
+		RGAliasingRequest const requests[] =
+		{
+			{ .size = 1000, .alignment = 1,   .first_pass = 0, .last_pass = 5 },
+			{ .size = 100,  .alignment = 256, .first_pass = 3, .last_pass = 4 },
+			{ .size = 100,  .alignment = 256, .first_pass = 5, .last_pass = 6 },
+		};
+		RGAllocator allocator(ScratchSize);
+		std::vector<Uint64> offsets(std::size(requests));
+		RGAliasingStats const stats = SolveResourceAliasing(requests, offsets, allocator);
+
+		ExpectValidPlacement(requests, offsets, stats);
+		EXPECT_EQ(offsets[0], 0u);
+		//both small resources are live alongside the big one but not alongside each other
+		EXPECT_EQ(offsets[1], 1024u);
+		EXPECT_EQ(offsets[2], 1024u);
+		EXPECT_EQ(stats.heap_size, 1124u);
+	}
+
+	TEST(RenderGraphResourceAliasing, ReusesBestFittingGap)
+	{
+		//1 is dead by the time 3 starts, 3 reuses its memory instead of growing the heap
+		RGAliasingRequest const requests[] =
+		{
+			{ .size = 256, .alignment = 256, .first_pass = 0, .last_pass = 9 },
+			{ .size = 512, .alignment = 256, .first_pass = 0, .last_pass = 1 },
+			{ .size = 512, .alignment = 256, .first_pass = 0, .last_pass = 9 },
+			{ .size = 256, .alignment = 256, .first_pass = 4, .last_pass = 6 },
+		};
+		RGAllocator allocator(ScratchSize);
+		std::vector<Uint64> offsets(std::size(requests));
+		RGAliasingStats const stats = SolveResourceAliasing(requests, offsets, allocator);
+
+		ExpectValidPlacement(requests, offsets, stats);
+		EXPECT_EQ(stats.heap_size, 1280u);
+		EXPECT_EQ(offsets[3], 0u);
+	}
+
+	TEST(RenderGraphResourceAliasing, RandomizedPlacementIsValidAndNeverWorseThanNaive)
+	{
+		RealRandomGenerator<Float> random(0.0f, 1.0f, std::mt19937{ 1234u });
+		for (Uint32 iteration = 0; iteration < 50; ++iteration)
+		{
+			std::vector<RGAliasingRequest> requests(1 + Uint32(random() * 64));
+			for (RGAliasingRequest& request : requests)
+			{
+				request.size = 1 + Uint64(random() * 4 * 1024 * 1024);
+				request.alignment = random() < 0.5f ? 64 * 1024 : 4 * 1024 * 1024;
+				request.first_pass = Uint32(random() * 100);
+				request.last_pass = request.first_pass + Uint32(random() * 20);
+			}
+
+			RGAllocator allocator(ScratchSize);
+			std::vector<Uint64> offsets(requests.size());
+			RGAliasingStats const stats = SolveResourceAliasing(requests, offsets, allocator);
+			ExpectValidPlacement(requests, offsets, stats);
+			EXPECT_LE(stats.heap_size, stats.naive_size);
+			EXPECT_EQ(stats.resource_count, requests.size());
+
+			//the heap can never be smaller than the memory live during the busiest pass
+			for (Uint32 pass = 0; pass < 120; ++pass)
+			{
+				Uint64 live_size = 0;
+				for (RGAliasingRequest const& request : requests)
+				{
+					if (request.first_pass <= pass && pass <= request.last_pass) live_size += request.size;
+				}
+				EXPECT_GE(stats.heap_size, live_size);
+			}
+		}
+	}
+}
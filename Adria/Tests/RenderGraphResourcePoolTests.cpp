@@ -0,0 +1,194 @@
+#include <gtest/gtest.h>
+#include "RenderGraph/RenderGraphResourcePool.h"
+#include "Graphics/Null/NullDevice.h"
+#include "Core/ConsoleManager.h"
+
+namespace adria
+{
+	namespace
+	{
+		constexpr Uint64 MB = 1024 * 1024;
+
+		//a 512x512 rgba8 texture without mips takes exactly 1 MB on the null device
+		GfxTextureDesc MakePoolTextureDesc(Uint32 size = 512)
+		{
+			GfxTextureDesc desc{};
+			desc.width = size;
+			desc.height = size;
+			desc.format = GfxFormat::R8G8B8A8_UNORM;
+			desc.bind_flags = GfxBindFlag::ShaderResource | GfxBindFlag::RenderTarget;
+			return desc;
+		}
+
+		GfxBufferDesc MakePoolBufferDesc(Uint64 size = MB)
+		{
+			GfxBufferDesc desc{};
+			desc.size = size;
+			desc.stride = 4;
+			desc.bind_flags = GfxBindFlag::ShaderResource | GfxBindFlag::UnorderedAccess;
+			desc.misc_flags = GfxBufferMiscFlag::BufferStructured;
+			return desc;
+		}
+
+		//the pool on the null device, the budget console variables are restored after each test
+		class RenderGraphResourcePoolTest : public testing::Test
+		{
+		protected:
+			RenderGraphResourcePoolTest() : gfx(nullptr), pool(&gfx) {}
+
+			void SetUp() override
+			{
+				budget = g_ConsoleManager.FindConsoleVariable("rg.Pool.Budget");
+				max_idle_frames = g_ConsoleManager.FindConsoleVariable("rg.Pool.MaxIdleFrames");
+				ASSERT_NE(budget, nullptr);
+				ASSERT_NE(max_idle_frames, nullptr);
+				saved_budget = budget->GetInt();
+				saved_max_idle_frames = max_idle_frames->GetInt();
+			}
+			void TearDown() override
+			{
+				budget->Set(saved_budget);
+				max_idle_frames->Set(saved_max_idle_frames);
+			}
+
+			//returns the evictions of all ticked frames
+			Uint32 Tick(Uint32 frame_count = 1)
+			{
+				Uint32 evictions = 0;
+				for (Uint32 i = 0; i < frame_count; ++i)
+				{
+					pool.Tick();
+					evictions += pool.GetStats().evictions;
+				}
+				return evictions;
+			}
+
+			NullDevice gfx;
+			RGResourcePool pool;
+			IConsoleVariable* budget = nullptr;
+			IConsoleVariable* max_idle_frames = nullptr;
+			Int saved_budget = 0;
+			Int saved_max_idle_frames = 0;
+		};
+	}
+
+	TEST_F(RenderGraphResourcePoolTest, ReleasedResourcesAreReused)
+	{
+		GfxTexture* texture = pool.AllocateTexture(MakePoolTextureDesc());
+		GfxBuffer* buffer = pool.AllocateBuffer(MakePoolBufferDesc());
+		Tick();
+		EXPECT_EQ(pool.GetStats().misses, 2u);
+		EXPECT_EQ(pool.GetStats().hits, 0u);
+		EXPECT_EQ(pool.GetStats().live_bytes, 2 * MB);
+
+		pool.ReleaseTexture(texture);
+		pool.ReleaseBuffer(buffer);
+		EXPECT_EQ(pool.GetStats().live_bytes, 0u);
+		EXPECT_EQ(pool.GetStats().pooled_bytes, 2 * MB);
+		Tick();
+
+		EXPECT_EQ(pool.AllocateTexture(MakePoolTextureDesc()), texture);
+		EXPECT_EQ(pool.AllocateBuffer(MakePoolBufferDesc()), buffer);
+		//different descriptions land in different buckets, an active resource is never handed out twice
+		GfxTexture* smaller_texture = pool.AllocateTexture(MakePoolTextureDesc(256));
+		GfxTexture* second_texture = pool.AllocateTexture(MakePoolTextureDesc());
+		EXPECT_NE(smaller_texture, texture);
+		EXPECT_NE(second_texture, texture);
+		Tick();
+		EXPECT_EQ(pool.GetStats().hits, 2u);
+		EXPECT_EQ(pool.GetStats().misses, 2u);
+		EXPECT_EQ(pool.GetStats().pooled_bytes, 0u);
+	}
+
+	//a texture asking for fewer bind flags than an idle one can take it, the other way around it cannot
+	TEST_F(RenderGraphResourcePoolTest, CompatibleTexturesShareBuckets)
+	{
+		GfxTexture* texture = pool.AllocateTexture(MakePoolTextureDesc());
+		pool.ReleaseTexture(texture);
+		GfxTextureDesc shader_resource_desc = MakePoolTextureDesc();
+		shader_resource_desc.bind_flags = GfxBindFlag::ShaderResource;
+		EXPECT_EQ(pool.AllocateTexture(shader_resource_desc), texture);
+		pool.ReleaseTexture(texture);
+
+		pool.ReleaseTexture(pool.AllocateTexture(shader_resource_desc));
+		GfxTextureDesc unordered_access_desc = MakePoolTextureDesc();
+		unordered_access_desc.bind_flags = GfxBindFlag::ShaderResource | GfxBindFlag::UnorderedAccess;
+		EXPECT_NE(pool.AllocateTexture(unordered_access_desc), texture);
+	}
+
+	//over budget the idle resources that were released first go first, until the pool fits again
+	TEST_F(RenderGraphResourcePoolTest, OverBudgetEvictsLeastRecentlyUsed)
+	{
+		budget->Set(1);
+		max_idle_frames->Set(1000);
+		GfxTexture* textures[3];
+		for (GfxTexture*& texture : textures)
+		{
+			texture = pool.AllocateTexture(MakePoolTextureDesc());
+		}
+		EXPECT_EQ(pool.GetStats().live_bytes, 3 * MB);
+		for (GfxTexture* texture : textures)
+		{
+			pool.ReleaseTexture(texture);
+			EXPECT_EQ(Tick(), 0u);
+		}
+
+		//resources released in the last few frames can still be used by the gpu and are never evicted
+		EXPECT_EQ(Tick(2), 0u);
+		EXPECT_EQ(pool.GetStats().pooled_bytes, 3 * MB);
+		EXPECT_EQ(Tick(10), 2u);
+		EXPECT_EQ(pool.GetStats().pooled_bytes, 1 * MB);
+		EXPECT_EQ(pool.AllocateTexture(MakePoolTextureDesc()), textures[2]);
+	}
+
+	TEST_F(RenderGraphResourcePoolTest, UnderBudgetKeepsIdleResourcesUntilMaxIdleFrames)
+	{
+		max_idle_frames->Set(20);
+		pool.ReleaseBuffer(pool.AllocateBuffer(MakePoolBufferDesc()));
+		EXPECT_EQ(Tick(20), 0u);
+		EXPECT_EQ(pool.GetStats().pooled_bytes, MB);
+		EXPECT_EQ(Tick(2), 1u);
+		EXPECT_EQ(pool.GetStats().pooled_bytes, 0u);
+		EXPECT_EQ(pool.GetStats().peak_bytes, MB);
+	}
+
+	//growing a heap replaces it, resources placed in the old one go with it while smaller requests keep the current heap
+	TEST_F(RenderGraphResourcePoolTest, HeapRegrowthDropsPlacedResources)
+	{
+		GfxHeap* heap = pool.AllocateHeap(GfxHeapUsage::RenderTargets, 4 * MB);
+		EXPECT_EQ(pool.GetStats().heap_bytes, 4 * MB);
+		GfxTexture* placed_texture = pool.AllocatePlacedTexture(MakePoolTextureDesc(), heap, MB);
+		pool.ReleaseTexture(placed_texture);
+		EXPECT_EQ(pool.AllocateHeap(GfxHeapUsage::RenderTargets, 2 * MB), heap);
+		EXPECT_EQ(pool.AllocatePlacedTexture(MakePoolTextureDesc(), heap, MB), placed_texture);
+		//placed memory is accounted for by the heap
+		EXPECT_EQ(pool.GetStats().live_bytes, 0u);
+
+		GfxHeap* buffer_heap = pool.AllocateHeap(GfxHeapUsage::Buffers, MB);
+		GfxBuffer* placed_buffer = pool.AllocatePlacedBuffer(MakePoolBufferDesc(), buffer_heap, 0);
+		Tick();
+		EXPECT_EQ(pool.GetStats().misses, 2u);
+		EXPECT_EQ(pool.GetStats().hits, 1u);
+
+		GfxHeap* grown_heap = pool.AllocateHeap(GfxHeapUsage::RenderTargets, 8 * MB);
+		EXPECT_EQ(grown_heap->GetDesc().size, 8 * MB);
+		EXPECT_EQ(pool.GetStats().heap_bytes, 9 * MB);
+		EXPECT_EQ(pool.GetStats().peak_bytes, 9 * MB);
+		pool.AllocatePlacedTexture(MakePoolTextureDesc(), grown_heap, MB);
+		//the other heap and its resources are untouched
+		pool.ReleaseBuffer(placed_buffer);
+		EXPECT_EQ(pool.AllocatePlacedBuffer(MakePoolBufferDesc(), buffer_heap, 0), placed_buffer);
+		Tick();
+		EXPECT_EQ(pool.GetStats().misses, 1u);
+		EXPECT_EQ(pool.GetStats().hits, 1u);
+	}
+
+	//placed resources cost no memory of their own, so they are dropped once idle for a few frames whatever the budget
+	TEST_F(RenderGraphResourcePoolTest, IdlePlacedResourcesAreDroppedQuickly)
+	{
+		max_idle_frames->Set(1000);
+		GfxHeap* heap = pool.AllocateHeap(GfxHeapUsage::Buffers, 4 * MB);
+		pool.ReleaseBuffer(pool.AllocatePlacedBuffer(MakePoolBufferDesc(), heap, 0));
+		EXPECT_EQ(Tick(10), 1u);
+	}
+}
@@ -0,0 +1,120 @@
+#pragma once
+#include <gtest/gtest.h>
+#include "RenderGraph/RenderGraph.h"
+#include "Graphics/Null/NullDevice.h"
+#include "Core/ConsoleManager.h"
+
+namespace adria
+{
+	//exposes compilation results that are private to the render graph
+	struct RenderGraphTestAccess
+	{
+		//copied out of the graph allocator, which is reset together with the graph
+		static std::vector<std::vector<Uint64>> GetAdjacencyLists(RenderGraph const& rg)
+		{
+			std::vector<std::vector<Uint64>> adjacency_lists;
+			for (auto const& adjacency_list : rg.adjacency_lists)
+			{
+				adjacency_lists.emplace_back(adjacency_list.begin(), adjacency_list.end());
+			}
+			return adjacency_lists;
+		}
+		static std::vector<Uint64> GetTopologicallySortedPasses(RenderGraph const& rg)
+		{
+			return std::vector<Uint64>(rg.topologically_sorted_passes.begin(), rg.topologically_sorted_passes.end());
+		}
+		static Uint64 GetDependencyLevelCount(RenderGraph const& rg) { return rg.dependency_levels.size(); }
+		static Uint64 GetExecutionBatchCount(RenderGraph const& rg) { return rg.BuildExecutionBatches().size(); }
+		static Uint64 GetHeapAllocationCount(RenderGraph const& rg) { return rg.GetHeapAllocationCount(); }
+		static void ExecuteMultithreaded(RenderGraph& rg) { rg.Execute_Multithreaded(); }
+	};
+
+	//overrides a console variable for the lifetime of the object and restores the value it had before
+	class ScopedConsoleVariable
+	{
+	public:
+		ScopedConsoleVariable(Char const* name, Char const* value) : cvar(g_ConsoleManager.FindConsoleVariable(name))
+		{
+			EXPECT_NE(cvar, nullptr) << name;
+			if (cvar)
+			{
+				previous_value = cvar->GetString();
+				Set(value);
+			}
+		}
+		~ScopedConsoleVariable()
+		{
+			if (cvar)
+			{
+				EXPECT_TRUE(cvar->Set(previous_value.c_str())) << cvar->GetName();
+			}
+		}
+		ADRIA_NONCOPYABLE_NONMOVABLE(ScopedConsoleVariable)
+
+		void Set(Char const* value)
+		{
+			if (cvar)
+			{
+				EXPECT_TRUE(cvar->Set(value)) << cvar->GetName() << " = " << value;
+			}
+		}
+
+	private:
+		IConsoleVariable* cvar;
+		std::string previous_value;
+	};
+
+	//render graph tests run on the null device, so graphs are compiled and recorded without a gpu
+	class RenderGraphTest : public testing::Test
+	{
+	protected:
+		RenderGraphTest() : gfx(nullptr), pool(&gfx), allocator(RenderGraph::DefaultAllocatorSize) {}
+
+		template<typename BuildFunc>
+		void RunFrame(BuildFunc&& build, RGCompileCache* cache = nullptr)
+		{
+			RunFrame(std::forward<BuildFunc>(build), [](RenderGraph const&) {}, cache);
+		}
+
+		//inspect is called between compilation and execution
+		template<typename BuildFunc, typename InspectFunc>
+		void RunFrame(BuildFunc&& build, InspectFunc&& inspect, RGCompileCache* cache = nullptr)
+		{
+			gfx.BeginFrame();
+			{
+				RenderGraph rg(pool, cache, &allocator);
+				build(rg);
+				rg.Compile();
+				inspect(static_cast<RenderGraph const&>(rg));
+				rg.Execute();
+			}
+			gfx.EndFrame();
+		}
+
+		NullFrameStats const& GetLastFrameStats() const { return gfx.GetLastFrameStats(); }
+
+	protected:
+		NullDevice gfx;
+		RGResourcePool pool;
+		//persistent like the renderer's, so graphs of consecutive frames reuse its memory
+		RGAllocator allocator;
+	};
+
+	inline RGTextureDesc MakeTestTextureDesc(Uint32 width = 256, Uint32 height = 256, GfxFormat format = GfxFormat::R8G8B8A8_UNORM)
+	{
+		RGTextureDesc desc{};
+		desc.width = width;
+		desc.height = height;
+		desc.format = format;
+		return desc;
+	}
+
+	inline RGBufferDesc MakeTestBufferDesc(Uint64 size = 4096, Uint32 stride = 4)
+	{
+		RGBufferDesc desc{};
+		desc.size = size;
+		desc.stride = stride;
+		desc.misc_flags = GfxBufferMiscFlag::BufferStructured;
+		return desc;
+	}
+}
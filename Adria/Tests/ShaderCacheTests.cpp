@@ -0,0 +1,197 @@
+#include <gtest/gtest.h>
+#include <fstream>
+#include "Graphics/GfxShaderCache.h"
+
+namespace fs = std::filesystem;
+
+namespace adria
+{
+	namespace
+	{
+		//the cache only sees keys, dependency files and opaque blobs, so entries are stored directly without compiling anything
+		class ShaderCacheTest : public ::testing::Test
+		{
+		protected:
+			void SetUp() override
+			{
+				dir = fs::temp_directory_path() / "AdriaShaderCacheTests";
+				fs::remove_all(dir);
+				fs::create_directories(dir);
+				pack_path = (dir / "ShaderCache.pack").string();
+			}
+			void TearDown() override
+			{
+				std::error_code ec;
+				fs::remove_all(dir, ec);
+			}
+
+			std::string WriteSource(Char const* name, std::string const& contents) const
+			{
+				std::string const path = (dir / name).string();
+				std::ofstream(path, std::ios::binary | std::ios::trunc) << contents;
+				return path;
+			}
+
+			static void Store(GfxShaderCache& cache, Uint64 key, std::vector<std::string> const& dependencies, std::string const& binary)
+			{
+				Uint64 const shader_hash[2] = { key * 3, key * 7 };
+				std::string const reflection = "reflection of " + binary;
+				cache.Store(key, dependencies, shader_hash, std::span(reinterpret_cast<Uint8 const*>(binary.data()), binary.size()),
+					std::span(reinterpret_cast<Uint8 const*>(reflection.data()), reflection.size()));
+			}
+
+			static std::string ToString(std::span<Uint8 const> bytes)
+			{
+				return std::string(reinterpret_cast<Char const*>(bytes.data()), bytes.size());
+			}
+
+			fs::path dir;
+			std::string pack_path;
+		};
+	}
+
+	TEST_F(ShaderCacheTest, MissingPackLeavesCacheEmpty)
+	{
+		GfxShaderCache cache;
+		EXPECT_FALSE(cache.Open(pack_path));
+		EXPECT_EQ(cache.GetPackedEntryCount(), 0u);
+		GfxShaderCacheRecord record;
+		EXPECT_FALSE(cache.Lookup(1, record));
+	}
+
+	TEST_F(ShaderCacheTest, StoredEntriesHitBeforeAndAfterSave)
+	{
+		std::string const source = WriteSource("Shader.hlsl", "float4 main() : SV_Target { return 1; }");
+		std::string const common = WriteSource("Common.hlsli", "#define ONE 1");
+		{
+			GfxShaderCache cache;
+			cache.Open(pack_path);
+			Store(cache, 20, { source, common }, "binary 20");
+			Store(cache, 10, { source }, "binary 10");
+
+			GfxShaderCacheRecord record;
+			ASSERT_TRUE(cache.Lookup(20, record));
+			EXPECT_EQ(ToString(record.binary), "binary 20");
+			EXPECT_FALSE(cache.Lookup(30, record));
+			ASSERT_TRUE(cache.Save());
+		}
+
+		GfxShaderCache cache;
+		ASSERT_TRUE(cache.Open(pack_path));
+		EXPECT_EQ(cache.GetPackedEntryCount(), 2u);
+		for (Uint64 key : { 10, 20 })
+		{
+			GfxShaderCacheRecord record;
+			ASSERT_TRUE(cache.Lookup(key, record)) << "key " << key;
+			EXPECT_EQ(ToString(record.binary), "binary " + std::to_string(key));
+			EXPECT_EQ(ToString(record.reflection), "reflection of binary " + std::to_string(key));
+			EXPECT_EQ(record.shader_hash[0], key * 3);
+			EXPECT_EQ(record.shader_hash[1], key * 7);
+		}
+		GfxShaderCacheRecord record;
+		ASSERT_TRUE(cache.Lookup(20, record));
+		EXPECT_EQ(record.dependencies, (std::vector<std::string>{ source, common }));
+		EXPECT_FALSE(cache.Lookup(15, record));
+	}
+
+	//file hashes are reused until RefreshDependencies, after it only the entries including the edited file miss
+	TEST_F(ShaderCacheTest, EditedIncludeInvalidatesDependentEntries)
+	{
+		std::string const shader_a = WriteSource("A.hlsl", "#include \"Common.hlsli\"");
+		std::string const shader_b = WriteSource("B.hlsl", "float4 main() : SV_Target { return 0; }");
+		std::string const common = WriteSource("Common.hlsli", "#define ONE 1");
+		{
+			GfxShaderCache cache;
+			cache.Open(pack_path);
+			Store(cache, 1, { shader_a, common }, "a");
+			Store(cache, 2, { shader_b }, "b");
+			ASSERT_TRUE(cache.Save());
+		}
+
+		GfxShaderCache cache;
+		ASSERT_TRUE(cache.Open(pack_path));
+		GfxShaderCacheRecord record;
+		ASSERT_TRUE(cache.Lookup(1, record));
+
+		WriteSource("Common.hlsli", "#define ONE 2");
+		EXPECT_TRUE(cache.Lookup(1, record));
+		cache.RefreshDependencies();
+		EXPECT_FALSE(cache.Lookup(1, record));
+		EXPECT_TRUE(cache.Lookup(2, record));
+
+		//recompiling stores the entry again, saving keeps it and the untouched one
+		Store(cache, 1, { shader_a, common }, "a recompiled");
+		ASSERT_TRUE(cache.Lookup(1, record));
+		EXPECT_EQ(ToString(record.binary), "a recompiled");
+		ASSERT_TRUE(cache.Save());
+		EXPECT_EQ(cache.GetPackedEntryCount(), 2u);
+		ASSERT_TRUE(cache.Lookup(1, record));
+		EXPECT_EQ(ToString(record.binary), "a recompiled");
+		ASSERT_TRUE(cache.Lookup(2, record));
+		EXPECT_EQ(ToString(record.binary), "b");
+	}
+
+	TEST_F(ShaderCacheTest, OutdatedEntriesAreDroppedOnSave)
+	{
+		std::string const shader_a = WriteSource("A.hlsl", "a");
+		std::string const shader_b = WriteSource("B.hlsl", "b");
+		{
+			GfxShaderCache cache;
+			cache.Open(pack_path);
+			Store(cache, 1, { shader_a }, "a");
+			Store(cache, 2, { shader_b }, "b");
+			ASSERT_TRUE(cache.Save());
+		}
+
+		WriteSource("A.hlsl", "a edited");
+		GfxShaderCache cache;
+		ASSERT_TRUE(cache.Open(pack_path));
+		Store(cache, 3, { shader_b }, "c");
+		ASSERT_TRUE(cache.Save());
+		EXPECT_EQ(cache.GetPackedEntryCount(), 2u);
+		GfxShaderCacheRecord record;
+		EXPECT_FALSE(cache.Lookup(1, record));
+		EXPECT_TRUE(cache.Lookup(2, record));
+		EXPECT_TRUE(cache.Lookup(3, record));
+	}
+
+	TEST_F(ShaderCacheTest, MissingDependencyNeverHits)
+	{
+		std::string const source = WriteSource("Shader.hlsl", "source");
+		std::string const removed = WriteSource("Removed.hlsli", "include");
+		GfxShaderCache cache;
+		cache.Open(pack_path);
+		Store(cache, 1, { source, (dir / "NeverExisted.hlsli").string() }, "missing");
+		Store(cache, 2, { source, removed }, "removed");
+		ASSERT_TRUE(cache.Save());
+
+		GfxShaderCacheRecord record;
+		EXPECT_FALSE(cache.Lookup(1, record));
+		EXPECT_TRUE(cache.Lookup(2, record));
+		fs::remove(removed);
+		cache.RefreshDependencies();
+		EXPECT_FALSE(cache.Lookup(2, record));
+	}
+
+	TEST_F(ShaderCacheTest, DamagedPackIsRejected)
+	{
+		std::string const source = WriteSource("Shader.hlsl", "source");
+		{
+			GfxShaderCache cache;
+			cache.Open(pack_path);
+			Store(cache, 1, { source }, "binary");
+			ASSERT_TRUE(cache.Save());
+		}
+
+		fs::resize_file(pack_path, fs::file_size(pack_path) - 1);
+		GfxShaderCache truncated_cache;
+		EXPECT_FALSE(truncated_cache.Open(pack_path));
+		GfxShaderCacheRecord record;
+		EXPECT_FALSE(truncated_cache.Lookup(1, record));
+
+		std::ofstream(pack_path, std::ios::binary | std::ios::trunc) << "not a shader cache, but long enough to hold a pack header";
+		GfxShaderCache garbage_cache;
+		EXPECT_FALSE(garbage_cache.Open(pack_path));
+		EXPECT_EQ(garbage_cache.GetPackedEntryCount(), 0u);
+	}
+}
@@ -0,0 +1,137 @@
+#include <gtest/gtest.h>
+#include <thread>
+#include "Utilities/ThreadPool.h"
+
+namespace adria
+{
+	namespace
+	{
+		class ThreadPoolTest : public testing::Test
+		{
+		protected:
+			void SetUp() override
+			{
+				g_ThreadPool.Initialize(3);
+			}
+			void TearDown() override
+			{
+				g_ThreadPool.Shutdown();
+			}
+		};
+	}
+
+	TEST_F(ThreadPoolTest, ParallelForVisitsEveryIndexOnce)
+	{
+		Uint64 const count = 10000;
+		for (Uint64 grain : { Uint64(1), Uint64(7), Uint64(64), count, 2 * count })
+		{
+			std::vector<std::atomic<Uint32>> visits(count);
+			g_ThreadPool.ParallelFor(0, count, grain, [&](Uint64 i) { visits[i].fetch_add(1, std::memory_order_relaxed); });
+			for (Uint64 i = 0; i < count; ++i)
+			{
+				ASSERT_EQ(visits[i].load(), 1u) << "index " << i << ", grain " << grain;
+			}
+		}
+	}
+
+	//jobs that wait on their own nested jobs keep executing other jobs, so nesting deeper than the worker count cannot deadlock
+	TEST_F(ThreadPoolTest, NestedParallelForCompletes)
+	{
+		std::atomic<Uint64> sum = 0;
+		g_ThreadPool.ParallelFor(0, 64, 1, [&](Uint64 i)
+			{
+				g_ThreadPool.ParallelFor(0, 64, 1, [&](Uint64 j) { sum.fetch_add(i * 64 + j, std::memory_order_relaxed); });
+			});
+		EXPECT_EQ(sum.load(), 4096ull * 4095ull / 2);
+	}
+
+	TEST_F(ThreadPoolTest, DispatchFromExternalThread)
+	{
+		std::atomic<Uint32> executed = 0;
+		std::thread external_thread([&]()
+			{
+				JobCounter counter;
+				for (Uint32 i = 0; i < 1000; ++i)
+				{
+					g_ThreadPool.Dispatch(counter, [&executed]() { executed.fetch_add(1, std::memory_order_relaxed); });
+				}
+				g_ThreadPool.Wait(counter);
+				EXPECT_TRUE(counter.IsDone());
+			});
+		external_thread.join();
+		EXPECT_EQ(executed.load(), 1000u);
+	}
+
+	//more jobs than one worker ring holds, slots are recycled while the caller helps executing them
+	TEST_F(ThreadPoolTest, DispatchMoreJobsThanCapacity)
+	{
+		std::atomic<Uint32> executed = 0;
+		JobCounter counter;
+		for (Uint32 i = 0; i < 20000; ++i)
+		{
+			g_ThreadPool.Dispatch(counter, [&executed]() { executed.fetch_add(1, std::memory_order_relaxed); });
+		}
+		g_ThreadPool.Wait(counter);
+		EXPECT_EQ(executed.load(), 20000u);
+	}
+
+	TEST_F(ThreadPoolTest, SubmitReturnsResult)
+	{
+		std::future<Uint64> result = g_ThreadPool.Submit([](Uint64 a, Uint64 b) { return a * b; }, 6ull, 7ull);
+		EXPECT_EQ(result.get(), 42u);
+	}
+
+	//the owner pops while thieves steal, every pushed item has to be taken exactly once
+	TEST(WorkStealingDeque, ConcurrentStealsTakeEveryItemOnce)
+	{
+		static constexpr Uint64 ItemCount = 100000;
+		WorkStealingDeque<Uint32, 1024> deque;
+		std::vector<std::atomic<Uint32>> taken(ItemCount);
+		std::atomic<Bool> owner_done = false;
+
+		std::vector<std::thread> thieves;
+		for (Uint32 t = 0; t < 3; ++t)
+		{
+			thieves.emplace_back([&]()
+				{
+					Uint32 item = 0;
+					while (!owner_done.load(std::memory_order_acquire) || !deque.Empty())
+					{
+						if (deque.Steal(item))
+						{
+							taken[item].fetch_add(1, std::memory_order_relaxed);
+						}
+					}
+				});
+		}
+
+		Uint32 item = 0;
+		for (Uint32 i = 0; i < ItemCount; ++i)
+		{
+			while (!deque.Push(i))
+			{
+				if (deque.Pop(item))
+				{
+					taken[item].fetch_add(1, std::memory_order_relaxed);
+				}
+			}
+			if (i % 3 == 0 && deque.Pop(item))
+			{
+				taken[item].fetch_add(1, std::memory_order_relaxed);
+			}
+		}
+		while (deque.Pop(item))
+		{
+			taken[item].fetch_add(1, std::memory_order_relaxed);
+		}
+		owner_done.store(true, std::memory_order_release);
+		for (std::thread& thief : thieves)
+		{
+			thief.join();
+		}
+		for (Uint64 i = 0; i < ItemCount; ++i)
+		{
+			ASSERT_EQ(taken[i].load(), 1u) << "item " << i;
+		}
+	}
+}
@@ -0,0 +1,617 @@
+#include "BCEncoder.h"
+#include "Utilities/ThreadPool.h"
+
+namespace adria
+{
+	namespace
+	{
+		//principal axis of the block texels, power iteration on the covariance matrix
+		template<Uint32 N>
+		void ComputePrincipalAxis(Float const (&texels)[16][N], Float (&mean)[N], Float (&axis)[N])
+		{
+			for (Uint32 c = 0; c < N; ++c)
+			{
+				mean[c] = 0.0f;
+				for (Uint32 i = 0; i < 16; ++i)
+				{
+					mean[c] += texels[i][c];
+				}
+				mean[c] /= 16.0f;
+			}
+
+			Float covariance[N][N] = {};
+			for (Uint32 i = 0; i < 16; ++i)
+			{
+				for (Uint32 a = 0; a < N; ++a)
+				{
+					for (Uint32 b = a; b < N; ++b)
+					{
+						covariance[a][b] += (texels[i][a] - mean[a]) * (texels[i][b] - mean[b]);
+					}
+				}
+			}
+			Uint32 largest = 0;
+			for (Uint32 a = 0; a < N; ++a)
+			{
+				for (Uint32 b = 0; b < a; ++b)
+				{
+					covariance[a][b] = covariance[b][a];
+				}
+				if (covariance[a][a] > covariance[largest][largest])
+				{
+					largest = a;
+				}
+			}
+
+			for (Uint32 c = 0; c < N; ++c)
+			{
+				axis[c] = covariance[largest][c];
+			}
+			for (Uint32 iteration = 0; iteration < 8; ++iteration)
+			{
+				Float next[N] = {};
+				Float max_component = 0.0f;
+				for (Uint32 a = 0; a < N; ++a)
+				{
+					for (Uint32 b = 0; b < N; ++b)
+					{
+						next[a] += covariance[a][b] * axis[b];
+					}
+					max_component = std::max(max_component, std::abs(next[a]));
+				}
+				if (max_component < 1e-6f)
+				{
+					break;
+				}
+				for (Uint32 c = 0; c < N; ++c)
+				{
+					axis[c] = next[c] / max_component;
+				}
+			}
+
+			Float length_sq = 0.0f;
+			for (Uint32 c = 0; c < N; ++c)
+			{
+				length_sq += axis[c] * axis[c];
+			}
+			Float const inv_length = length_sq > 1e-12f ? 1.0f / std::sqrt(length_sq) : 0.0f;
+			for (Uint32 c = 0; c < N; ++c)
+			{
+				axis[c] = length_sq > 1e-12f ? axis[c] * inv_length : 1.0f / std::sqrt((Float)N);
+			}
+		}
+
+		//endpoints along the principal axis that enclose every texel of the block
+		template<Uint32 N>
+		void ComputeAxisEndpoints(Float const (&texels)[16][N], Float (&endpoint0)[N], Float (&endpoint1)[N])
+		{
+			Float mean[N], axis[N];
+			ComputePrincipalAxis(texels, mean, axis);
+			Float min_projection = FLT_MAX, max_projection = -FLT_MAX;
+			for (Uint32 i = 0; i < 16; ++i)
+			{
+				Float projection = 0.0f;
+				for (Uint32 c = 0; c < N; ++c)
+				{
+					projection += (texels[i][c] - mean[c]) * axis[c];
+				}
+				min_projection = std::min(min_projection, projection);
+				max_projection = std::max(max_projection, projection);
+			}
+			for (Uint32 c = 0; c < N; ++c)
+			{
+				endpoint0[c] = mean[c] + axis[c] * max_projection;
+				endpoint1[c] = mean[c] + axis[c] * min_projection;
+			}
+		}
+
+		//least squares endpoints for fixed indices, weights[i] is how much of endpoint0 texel i receives
+		template<Uint32 N>
+		Bool SolveEndpoints(Float const (&texels)[16][N], Float const (&weights)[16], Float (&endpoint0)[N], Float (&endpoint1)[N])
+		{
+			Float aa = 0.0f, ab = 0.0f, bb = 0.0f;
+			Float ax[N] = {}, bx[N] = {};
+			for (Uint32 i = 0; i < 16; ++i)
+			{
+				Float const a = weights[i];
+				Float const b = 1.0f - a;
+				aa += a * a;
+				ab += a * b;
+				bb += b * b;
+				for (Uint32 c = 0; c < N; ++c)
+				{
+					ax[c] += a * texels[i][c];
+					bx[c] += b * texels[i][c];
+				}
+			}
+			Float const determinant = aa * bb - ab * ab;
+			if (std::abs(determinant) < 1e-6f)
+			{
+				return false;
+			}
+			Float const inv_determinant = 1.0f / determinant;
+			for (Uint32 c = 0; c < N; ++c)
+			{
+				endpoint0[c] = std::clamp((bb * ax[c] - ab * bx[c]) * inv_determinant, 0.0f, 255.0f);
+				endpoint1[c] = std::clamp((aa * bx[c] - ab * ax[c]) * inv_determinant, 0.0f, 255.0f);
+			}
+			return true;
+		}
+
+		template<Uint32 N>
+		void LoadBlock(Uint8 const* rgba_block, Float (&texels)[16][N])
+		{
+			for (Uint32 i = 0; i < 16; ++i)
+			{
+				for (Uint32 c = 0; c < N; ++c)
+				{
+					texels[i][c] = rgba_block[i * 4 + c];
+				}
+			}
+		}
+
+		Uint16 PackRGB565(Float const (&rgb)[3])
+		{
+			Uint32 const r = (Uint32)std::clamp(rgb[0] * (31.0f / 255.0f) + 0.5f, 0.0f, 31.0f);
+			Uint32 const g = (Uint32)std::clamp(rgb[1] * (63.0f / 255.0f) + 0.5f, 0.0f, 63.0f);
+			Uint32 const b = (Uint32)std::clamp(rgb[2] * (31.0f / 255.0f) + 0.5f, 0.0f, 31.0f);
+			return (Uint16)((r << 11) | (g << 5) | b);
+		}
+		void UnpackRGB565(Uint16 color, Float (&rgb)[3])
+		{
+			Uint32 const r = (color >> 11) & 31;
+			Uint32 const g = (color >> 5) & 63;
+			Uint32 const b = color & 31;
+			rgb[0] = (Float)((r << 3) | (r >> 2));
+			rgb[1] = (Float)((g << 2) | (g >> 4));
+			rgb[2] = (Float)((b << 3) | (b >> 2));
+		}
+
+		struct BC1Fit
+		{
+			Uint16 color0;
+			Uint16 color1;
+			Uint32 indices;
+			Float  error;
+		};
+
+		//always produces the four color mode, color0 > color1
+		BC1Fit FitBC1Indices(Float const (&texels)[16][3], Uint16 color0, Uint16 color1)
+		{
+			if (color0 < color1)
+			{
+				std::swap(color0, color1);
+			}
+			BC1Fit fit{ color0, color1, 0, 0.0f };
+
+			Float palette[4][3];
+			UnpackRGB565(color0, palette[0]);
+			UnpackRGB565(color1, palette[1]);
+			for (Uint32 c = 0; c < 3; ++c)
+			{
+				palette[2][c] = (2.0f * palette[0][c] + palette[1][c]) / 3.0f;
+				palette[3][c] = (palette[0][c] + 2.0f * palette[1][c]) / 3.0f;
+			}
+			//equal colors decode in the three color mode where index 3 is black
+			Uint32 const palette_size = color0 == color1 ? 1 : 4;
+			for (Uint32 i = 0; i < 16; ++i)
+			{
+				Uint32 best_index = 0;
+				Float best_error = FLT_MAX;
+				for (Uint32 j = 0; j < palette_size; ++j)
+				{
+					Float error = 0.0f;
+					for (Uint32 c = 0; c < 3; ++c)
+					{
+						Float const d = texels[i][c] - palette[j][c];
+						error += d * d;
+					}
+					if (error < best_error)
+					{
+						best_error = error;
+						best_index = j;
+					}
+				}
+				fit.indices |= best_index << (2 * i);
+				fit.error += best_error;
+			}
+			return fit;
+		}
+
+		void WriteBC1Block(BC1Fit const& fit, Uint8* output)
+		{
+			output[0] = (Uint8)(fit.color0 & 0xff);
+			output[1] = (Uint8)(fit.color0 >> 8);
+			output[2] = (Uint8)(fit.color1 & 0xff);
+			output[3] = (Uint8)(fit.color1 >> 8);
+			memcpy(output + 4, &fit.indices, sizeof(fit.indices));
+		}
+
+		struct BC4Fit
+		{
+			Uint8  endpoint0;
+			Uint8  endpoint1;
+			Uint64 indices;
+			Float  error;
+		};
+
+		BC4Fit FitBC4Indices(Float const (&values)[16], Uint8 endpoint0, Uint8 endpoint1)
+		{
+			Float palette[8];
+			palette[0] = endpoint0;
+			palette[1] = endpoint1;
+			if (endpoint0 > endpoint1)
+			{
+				for (Uint32 i = 1; i < 7; ++i)
+				{
+					palette[i + 1] = ((7 - i) * endpoint0 + i * endpoint1) / 7.0f;
+				}
+			}
+			else
+			{
+				for (Uint32 i = 1; i < 5; ++i)
+				{
+					palette[i + 1] = ((5 - i) * endpoint0 + i * endpoint1) / 5.0f;
+				}
+				palette[6] = 0.0f;
+				palette[7] = 255.0f;
+			}
+
+			BC4Fit fit{ endpoint0, endpoint1, 0, 0.0f };
+			for (Uint32 i = 0; i < 16; ++i)
+			{
+				Uint64 best_index = 0;
+				Float best_error = FLT_MAX;
+				for (Uint32 j = 0; j < 8; ++j)
+				{
+					Float const error = (values[i] - palette[j]) * (values[i] - palette[j]);
+					if (error < best_error)
+					{
+						best_error = error;
+						best_index = j;
+					}
+				}
+				fit.indices |= best_index << (3 * i);
+				fit.error += best_error;
+			}
+			return fit;
+		}
+
+		void EncodeBC4Channel(Uint8 const* rgba_block, Uint32 channel, Uint8* output)
+		{
+			Float values[16];
+			Uint8 min_value = 255, max_value = 0;
+			for (Uint32 i = 0; i < 16; ++i)
+			{
+				Uint8 const value = rgba_block[i * 4 + channel];
+				values[i] = value;
+				min_value = std::min(min_value, value);
+				max_value = std::max(max_value, value);
+			}
+
+			BC4Fit best = FitBC4Indices(values, max_value, min_value);
+			if (max_value > min_value)
+			{
+				static constexpr Float Weights[8] = { 1.0f, 0.0f, 6.0f / 7.0f, 5.0f / 7.0f, 4.0f / 7.0f, 3.0f / 7.0f, 2.0f / 7.0f, 1.0f / 7.0f };
+				Float texels[16][1], weights[16];
+				for (Uint32 i = 0; i < 16; ++i)
+				{
+					texels[i][0] = values[i];
+					weights[i] = Weights[(best.indices >> (3 * i)) & 7];
+				}
+				Float endpoint0[1], endpoint1[1];
+				if (SolveEndpoints(texels, weights, endpoint0, endpoint1))
+				{
+					Uint8 const refined0 = (Uint8)(endpoint0[0] + 0.5f);
+					Uint8 const refined1 = (Uint8)(endpoint1[0] + 0.5f);
+					if (refined0 > refined1)
+					{
+						BC4Fit const fit = FitBC4Indices(values, refined0, refined1);
+						if (fit.error < best.error)
+						{
+							best = fit;
+						}
+					}
+				}
+			}
+			//the six value mode stores exact 0 and 255 and spends the interpolated values on the rest of the block
+			if (min_value == 0 || max_value == 255)
+			{
+				Uint8 inner_min = 255, inner_max = 0;
+				for (Float value : values)
+				{
+					if (value > 0.0f && value < 255.0f)
+					{
+						inner_min = std::min(inner_min, (Uint8)value);
+						inner_max = std::max(inner_max, (Uint8)value);
+					}
+				}
+				if (inner_min > inner_max)
+				{
+					inner_min = inner_max = 0;
+				}
+				BC4Fit const fit = FitBC4Indices(values, inner_min, inner_max);
+				if (fit.error < best.error)
+				{
+					best = fit;
+				}
+			}
+
+			output[0] = best.endpoint0;
+			output[1] = best.endpoint1;
+			for (Uint32 i = 0; i < 6; ++i)
+			{
+				output[2 + i] = (Uint8)(best.indices >> (8 * i));
+			}
+		}
+
+		static constexpr Uint32 BC7Weights4[16] = { 0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64 };
+
+		struct BC7Mode6Fit
+		{
+			Uint8 endpoints[2][4];
+			Uint8 pbits[2];
+			Uint8 indices[16];
+			Float error;
+		};
+
+		//7 bit endpoint plus a p-bit, the p-bit is chosen to minimize the endpoint's own error
+		void QuantizeBC7Endpoint(Float const (&endpoint)[4], Uint8 (&quantized)[4], Uint8& pbit)
+		{
+			Float best_error = FLT_MAX;
+			for (Uint8 p = 0; p < 2; ++p)
+			{
+				Uint8 candidate[4];
+				Float error = 0.0f;
+				for (Uint32 c = 0; c < 4; ++c)
+				{
+					candidate[c] = (Uint8)std::clamp((endpoint[c] - p) * 0.5f + 0.5f, 0.0f, 127.0f);
+					Float const d = (Float)((candidate[c] << 1) | p) - endpoint[c];
+					error += d * d;
+				}
+				if (error < best_error)
+				{
+					best_error = error;
+					pbit = p;
+					memcpy(quantized, candidate, sizeof(candidate));
+				}
+			}
+		}
+
+		BC7Mode6Fit FitBC7Indices(Float const (&texels)[16][4], Float const (&endpoint0)[4], Float const (&endpoint1)[4])
+		{
+			BC7Mode6Fit fit{};
+			QuantizeBC7Endpoint(endpoint0, fit.endpoints[0], fit.pbits[0]);
+			QuantizeBC7Endpoint(endpoint1, fit.endpoints[1], fit.pbits[1]);
+
+			Float palette[16][4];
+			Float direction[4];
+			Float direction_length_sq = 0.0f;
+			for (Uint32 c = 0; c < 4; ++c)
+			{
+				Uint32 const e0 = (fit.endpoints[0][c] << 1) | fit.pbits[0];
+				Uint32 const e1 = (fit.endpoints[1][c] << 1) | fit.pbits[1];
+				for (Uint32 j = 0; j < 16; ++j)
+				{
+					palette[j][c] = (Float)(((64 - BC7Weights4[j]) * e0 + BC7Weights4[j] * e1 + 32) >> 6);
+				}
+				direction[c] = (Float)e1 - (Float)e0;
+				direction_length_sq += direction[c] * direction[c];
+			}
+			Float const inv_direction_length_sq = direction_length_sq > 0.0f ? 1.0f / direction_length_sq : 0.0f;
+
+			//the projection onto the endpoint segment picks the closest weight, its neighbours absorb the palette rounding
+			for (Uint32 i = 0; i < 16; ++i)
+			{
+				Float projection = 0.0f;
+				for (Uint32 c = 0; c < 4; ++c)
+				{
+					projection += (texels[i][c] - palette[0][c]) * direction[c];
+				}
+				Float const weight = std::clamp(projection * inv_direction_length_sq, 0.0f, 1.0f) * 64.0f;
+				Uint32 nearest = 0;
+				while (nearest < 15 && BC7Weights4[nearest + 1] <= weight)
+				{
+					++nearest;
+				}
+				Uint8 const first_candidate = (Uint8)(nearest > 0 ? nearest - 1 : 0);
+				Uint8 const last_candidate = (Uint8)std::min(nearest + 2, 15u);
+
+				Uint8 best_index = 0;
+				Float best_error = FLT_MAX;
+				for (Uint8 j = first_candidate; j <= last_candidate; ++j)
+				{
+					Float error = 0.0f;
+					for (Uint32 c = 0; c < 4; ++c)
+					{
+						Float const d = texels[i][c] - palette[j][c];
+						error += d * d;
+					}
+					if (error < best_error)
+					{
+						best_error = error;
+						best_index = j;
+					}
+				}
+				fit.indices[i] = best_index;
+				fit.error += best_error;
+			}
+			return fit;
+		}
+
+		class BlockBitWriter
+		{
+		public:
+			explicit BlockBitWriter(Uint8* data) : data(data) {}
+
+			void Write(Uint32 value, Uint32 bit_count)
+			{
+				for (Uint32 bit = 0; bit < bit_count; ++bit, ++position)
+				{
+					data[position >> 3] |= (Uint8)(((value >> bit) & 1) << (position & 7));
+				}
+			}
+
+		private:
+			Uint8* data;
+			Uint32 position = 0;
+		};
+	}
+
+	void EncodeBC1Block(Uint8 const* rgba_block, Uint8* output)
+	{
+		static constexpr Float Weights[4] = { 1.0f, 0.0f, 2.0f / 3.0f, 1.0f / 3.0f };
+
+		Float texels[16][3];
+		LoadBlock(rgba_block, texels);
+		Float endpoint0[3], endpoint1[3];
+		ComputeAxisEndpoints(texels, endpoint0, endpoint1);
+
+		BC1Fit best = FitBC1Indices(texels, PackRGB565(endpoint0), PackRGB565(endpoint1));
+		for (Uint32 iteration = 0; iteration < 2; ++iteration)
+		{
+			Float weights[16];
+			for (Uint32 i = 0; i < 16; ++i)
+			{
+				weights[i] = Weights[(best.indices >> (2 * i)) & 3];
+			}
+			if (!SolveEndpoints(texels, weights, endpoint0, endpoint1))
+			{
+				break;
+			}
+			BC1Fit const fit = FitBC1Indices(texels, PackRGB565(endpoint0), PackRGB565(endpoint1));
+			if (fit.error >= best.error)
+			{
+				break;
+			}
+			best = fit;
+		}
+		WriteBC1Block(best, output);
+	}
+
+	void EncodeBC3Block(Uint8 const* rgba_block, Uint8* output)
+	{
+		EncodeBC4Channel(rgba_block, 3, output);
+		EncodeBC1Block(rgba_block, output + 8);
+	}
+
+	void EncodeBC4Block(Uint8 const* rgba_block, Uint8* output)
+	{
+		EncodeBC4Channel(rgba_block, 0, output);
+	}
+
+	void EncodeBC5Block(Uint8 const* rgba_block, Uint8* output)
+	{
+		EncodeBC4Channel(rgba_block, 0, output);
+		EncodeBC4Channel(rgba_block, 1, output + 8);
+	}
+
+	void EncodeBC7Block(Uint8 const* rgba_block, Uint8* output)
+	{
+		Float texels[16][4];
+		LoadBlock(rgba_block, texels);
+		Float endpoint0[4], endpoint1[4];
+		ComputeAxisEndpoints(texels, endpoint0, endpoint1);
+
+		BC7Mode6Fit best = FitBC7Indices(texels, endpoint0, endpoint1);
+		for (Uint32 iteration = 0; iteration < 2; ++iteration)
+		{
+			Float weights[16];
+			for (Uint32 i = 0; i < 16; ++i)
+			{
+				weights[i] = 1.0f - BC7Weights4[best.indices[i]] / 64.0f;
+			}
+			if (!SolveEndpoints(texels, weights, endpoint0, endpoint1))
+			{
+				break;
+			}
+			BC7Mode6Fit const fit = FitBC7Indices(texels, endpoint0, endpoint1);
+			if (fit.error >= best.error)
+			{
+				break;
+			}
+			best = fit;
+		}
+
+		//the anchor index is stored without its top bit, flipping the endpoints makes it implicit zero
+		if (best.indices[0] & 8)
+		{
+			std::swap(best.endpoints[0], best.endpoints[1]);
+			std::swap(best.pbits[0], best.pbits[1]);
+			for (Uint8& index : best.indices)
+			{
+				index = 15 - index;
+			}
+		}
+
+		memset(output, 0, 16);
+		BlockBitWriter writer(output);
+		writer.Write(1u << 6, 7);
+		for (Uint32 c = 0; c < 4; ++c)
+		{
+			writer.Write(best.endpoints[0][c], 7);
+			writer.Write(best.endpoints[1][c], 7);
+		}
+		writer.Write(best.pbits[0], 1);
+		writer.Write(best.pbits[1], 1);
+		writer.Write(best.indices[0], 3);
+		for (Uint32 i = 1; i < 16; ++i)
+		{
+			writer.Write(best.indices[i], 4);
+		}
+	}
+
+	Bool IsBCEncoderFormat(GfxFormat format)
+	{
+		switch (format)
+		{
+		case GfxFormat::BC1_UNORM:
+		case GfxFormat::BC3_UNORM:
+		case GfxFormat::BC4_UNORM:
+		case GfxFormat::BC5_UNORM:
+		case GfxFormat::BC7_UNORM:
+			return true;
+		}
+		return false;
+	}
+
+	void CompressSurfaceBC(GfxFormat format, Uint8 const* rgba, Uint32 width, Uint32 height, Uint8* output)
+	{
+		using BlockEncoder = void(*)(Uint8 const*, Uint8*);
+		BlockEncoder encode_block = nullptr;
+		switch (format)
+		{
+		case GfxFormat::BC1_UNORM: encode_block = EncodeBC1Block; break;
+		case GfxFormat::BC3_UNORM: encode_block = EncodeBC3Block; break;
+		case GfxFormat::BC4_UNORM: encode_block = EncodeBC4Block; break;
+		case GfxFormat::BC5_UNORM: encode_block = EncodeBC5Block; break;
+		case GfxFormat::BC7_UNORM: encode_block = EncodeBC7Block; break;
+		default:
+			ADRIA_ASSERT_MSG(false, "Unsupported BC encoder format!");
+			return;
+		}
+
+		Uint32 const blocks_x = DivideAndRoundUp(width, 4);
+		Uint32 const blocks_y = DivideAndRoundUp(height, 4);
+		Uint32 const block_size = GetGfxFormatStride(format);
+		//small mips are batched into one job, large ones get a job per block row
+		Uint64 const grain = std::max<Uint64>(1, 256 / blocks_x);
+		g_ThreadPool.ParallelFor(0, blocks_y, grain, [&](Uint64 block_y)
+			{
+				Uint8 block[64];
+				for (Uint32 block_x = 0; block_x < blocks_x; ++block_x)
+				{
+					for (Uint32 y = 0; y < 4; ++y)
+					{
+						Uint64 const row = std::min<Uint64>(block_y * 4 + y, height - 1);
+						for (Uint32 x = 0; x < 4; ++x)
+						{
+							Uint64 const column = std::min(block_x * 4 + x, width - 1);
+							memcpy(block + (y * 4 + x) * 4, rgba + (row * width + column) * 4, 4);
+						}
+					}
+					encode_block(block, output + ((Uint64)block_y * blocks_x + block_x) * block_size);
+				}
+			});
+	}
+}
@@ -0,0 +1,18 @@
+#pragma once
+#include "Graphics/GfxFormat.h"
+
+namespace adria
+{
+	//block encoders take 16 rgba8 texels of a 4x4 block in row order.
+	//BC1 ignores alpha, BC4 encodes red, BC5 red and green, BC7 only uses mode 6
+	void EncodeBC1Block(Uint8 const* rgba_block, Uint8* output);
+	void EncodeBC3Block(Uint8 const* rgba_block, Uint8* output);
+	void EncodeBC4Block(Uint8 const* rgba_block, Uint8* output);
+	void EncodeBC5Block(Uint8 const* rgba_block, Uint8* output);
+	void EncodeBC7Block(Uint8 const* rgba_block, Uint8* output);
+
+	Bool IsBCEncoderFormat(GfxFormat format);
+	//compresses a tightly packed rgba8 surface into format, block rows are encoded in parallel on the thread pool.
+	//Edge blocks of surfaces that are not a multiple of 4 replicate the last row and column
+	void CompressSurfaceBC(GfxFormat format, Uint8 const* rgba, Uint32 width, Uint32 height, Uint8* output);
+}
@@ -1,5 +1,7 @@
 #include "DynamicLibrary.h"
+#if !defined(ADRIA_USE_FMT)
 #include <format>
+#endif
 #ifdef _WIN32
 #include <Windows.h>
 #else
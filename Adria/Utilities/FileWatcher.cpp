@@ -0,0 +1,319 @@
+#include "FileWatcher.h"
+#if defined(ADRIA_PLATFORM_LINUX)
+#include <sys/inotify.h>
+#include <poll.h>
+#include <unistd.h>
+#endif
+
+namespace fs = std::filesystem;
+
+namespace adria
+{
+#if defined(ADRIA_PLATFORM_LINUX)
+	static constexpr Uint32 NotifyDirectoryMask = IN_CREATE | IN_DELETE | IN_MODIFY | IN_CLOSE_WRITE | IN_ATTRIB | IN_MOVED_FROM | IN_MOVED_TO;
+#endif
+
+	FileWatcher::FileWatcher(std::chrono::milliseconds debounce_time) : debounce_time(debounce_time)
+	{
+#if defined(ADRIA_PLATFORM_LINUX)
+		inotify_fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+#endif
+		watch_thread = std::thread(&FileWatcher::WatchThread, this);
+	}
+
+	FileWatcher::~FileWatcher()
+	{
+		{
+			std::lock_guard lock(stop_mutex);
+			stop = true;
+		}
+		stop_condition.notify_one();
+		watch_thread.join();
+#if defined(ADRIA_PLATFORM_LINUX)
+		if (inotify_fd >= 0)
+		{
+			close(inotify_fd);
+		}
+#endif
+		file_modified_event.RemoveAll();
+	}
+
+	void FileWatcher::AddPathToWatch(std::string const& path, Bool recursive)
+	{
+		std::lock_guard lock(watch_mutex);
+		watched_paths.emplace_back(path, recursive);
+		AddDirectory(path, recursive, false);
+	}
+
+	Bool FileWatcher::HasPendingChanges() const
+	{
+		if (pending_count.load(std::memory_order_relaxed) == 0)
+		{
+			return false;
+		}
+		Clock::time_point const now = Clock::now();
+		std::lock_guard lock(pending_mutex);
+		for (auto const& [file, change] : pending_changes)
+		{
+			if (now - change.time >= debounce_time)
+			{
+				return true;
+			}
+		}
+		return false;
+	}
+
+	void FileWatcher::CheckWatchedFiles()
+	{
+		if (pending_count.load(std::memory_order_relaxed) == 0)
+		{
+			return;
+		}
+
+		std::vector<std::pair<std::string, FileStatus>> changes;
+		{
+			Clock::time_point const now = Clock::now();
+			std::lock_guard lock(pending_mutex);
+			for (auto it = pending_changes.begin(); it != pending_changes.end();)
+			{
+				if (now - it->second.time >= debounce_time)
+				{
+					changes.emplace_back(it->first, it->second.status);
+					it = pending_changes.erase(it);
+				}
+				else
+				{
+					++it;
+				}
+			}
+			pending_count.store((Uint32)pending_changes.size(), std::memory_order_relaxed);
+		}
+
+		std::sort(changes.begin(), changes.end());
+		for (auto const& [file, status] : changes)
+		{
+			file_modified_event.Broadcast(file, status);
+		}
+	}
+
+	void FileWatcher::WatchThread()
+	{
+		while (true)
+		{
+#if defined(ADRIA_PLATFORM_LINUX)
+			if (inotify_fd >= 0)
+			{
+				{
+					std::lock_guard lock(stop_mutex);
+					if (stop)
+					{
+						return;
+					}
+				}
+				pollfd poll_fd{ inotify_fd, POLLIN, 0 };
+				if (poll(&poll_fd, 1, (Int)PollInterval.count()) > 0)
+				{
+					std::lock_guard lock(watch_mutex);
+					ReadNotifyEvents();
+				}
+				continue;
+			}
+#endif
+			{
+				std::unique_lock lock(stop_mutex);
+				if (stop_condition.wait_for(lock, PollInterval, [this] { return stop; }))
+				{
+					return;
+				}
+			}
+			std::lock_guard lock(watch_mutex);
+			PollWatchedPaths();
+		}
+	}
+
+	void FileWatcher::PushChange(std::string const& file, FileStatus status)
+	{
+		std::lock_guard lock(pending_mutex);
+		auto [it, inserted] = pending_changes.try_emplace(file, status, Clock::now());
+		if (!inserted)
+		{
+			PendingChange& change = it->second;
+			if (change.status == FileStatus::Created && status == FileStatus::Deleted)
+			{
+				pending_changes.erase(it);
+			}
+			else
+			{
+				if (change.status == FileStatus::Deleted && status == FileStatus::Created)
+				{
+					change.status = FileStatus::Modified;
+				}
+				else if (change.status != FileStatus::Created)
+				{
+					change.status = status;
+				}
+				change.time = Clock::now();
+			}
+		}
+		pending_count.store((Uint32)pending_changes.size(), std::memory_order_relaxed);
+	}
+
+	void FileWatcher::AddDirectory(std::string const& directory, Bool recursive, Bool report_created)
+	{
+#if defined(ADRIA_PLATFORM_LINUX)
+		if (inotify_fd >= 0)
+		{
+			//files created before the watch is in place are picked up by the scan below
+			Int const watch_descriptor = inotify_add_watch(inotify_fd, directory.c_str(), NotifyDirectoryMask);
+			if (watch_descriptor >= 0)
+			{
+				watch_descriptors[watch_descriptor] = WatchedPath{ directory, recursive };
+			}
+		}
+#endif
+		std::error_code ec;
+		for (fs::directory_iterator it(directory, ec), end; !ec && it != end; it.increment(ec))
+		{
+			std::string const path = it->path().string();
+			if (it->is_directory(ec))
+			{
+				if (recursive)
+				{
+					AddDirectory(path, recursive, report_created);
+				}
+			}
+			else if (it->is_regular_file(ec))
+			{
+				auto [file_it, inserted] = files_map.try_emplace(path, fs::last_write_time(path, ec));
+				if (inserted && report_created)
+				{
+					PushChange(path, FileStatus::Created);
+				}
+			}
+		}
+	}
+
+	void FileWatcher::PollWatchedPaths()
+	{
+		std::unordered_set<std::string> existing_files;
+		existing_files.reserve(files_map.size());
+		for (WatchedPath const& watched_path : watched_paths)
+		{
+			std::error_code ec;
+			auto PollFile = [&](fs::directory_entry const& entry)
+				{
+					if (!entry.is_regular_file(ec))
+					{
+						return;
+					}
+					std::string const path = entry.path().string();
+					fs::file_time_type const last_write_time = entry.last_write_time(ec);
+					existing_files.insert(path);
+					auto [it, inserted] = files_map.try_emplace(path, last_write_time);
+					if (inserted)
+					{
+						PushChange(path, FileStatus::Created);
+					}
+					else if (it->second != last_write_time)
+					{
+						it->second = last_write_time;
+						PushChange(path, FileStatus::Modified);
+					}
+				};
+			if (watched_path.recursive)
+			{
+				for (fs::recursive_directory_iterator it(watched_path.path, ec), end; !ec && it != end; it.increment(ec))
+				{
+					PollFile(*it);
+				}
+			}
+			else
+			{
+				for (fs::directory_iterator it(watched_path.path, ec), end; !ec && it != end; it.increment(ec))
+				{
+					PollFile(*it);
+				}
+			}
+		}
+
+		for (auto it = files_map.begin(); it != files_map.end();)
+		{
+			if (!existing_files.contains(it->first))
+			{
+				PushChange(it->first, FileStatus::Deleted);
+				it = files_map.erase(it);
+			}
+			else
+			{
+				++it;
+			}
+		}
+	}
+
+#if defined(ADRIA_PLATFORM_LINUX)
+	void FileWatcher::ReadNotifyEvents()
+	{
+		alignas(inotify_event) Char buffer[4096];
+		while (true)
+		{
+			ssize_t const read_size = read(inotify_fd, buffer, sizeof(buffer));
+			if (read_size <= 0)
+			{
+				return;
+			}
+
+			for (Char const* ptr = buffer; ptr < buffer + read_size;)
+			{
+				inotify_event const* event = reinterpret_cast<inotify_event const*>(ptr);
+				ptr += sizeof(inotify_event) + event->len;
+
+				//the kernel dropped events, fall back to a full scan to find out what changed
+				if (event->mask & IN_Q_OVERFLOW)
+				{
+					PollWatchedPaths();
+					continue;
+				}
+				auto watch_it = watch_descriptors.find(event->wd);
+				if (watch_it == watch_descriptors.end())
+				{
+					continue;
+				}
+				if (event->mask & IN_IGNORED)
+				{
+					watch_descriptors.erase(watch_it);
+					continue;
+				}
+				if (event->len == 0)
+				{
+					continue;
+				}
+
+				WatchedPath const watched_directory = watch_it->second;
+				std::string const path = (fs::path(watched_directory.path) / event->name).string();
+				if (event->mask & IN_ISDIR)
+				{
+					if ((event->mask & (IN_CREATE | IN_MOVED_TO)) && watched_directory.recursive)
+					{
+						AddDirectory(path, true, true);
+					}
+					continue;
+				}
+
+				std::error_code ec;
+				if (event->mask & (IN_DELETE | IN_MOVED_FROM))
+				{
+					if (files_map.erase(path) > 0)
+					{
+						PushChange(path, FileStatus::Deleted);
+					}
+				}
+				else if (event->mask & (IN_CREATE | IN_MOVED_TO | IN_MODIFY | IN_CLOSE_WRITE | IN_ATTRIB))
+				{
+					auto [it, inserted] = files_map.insert_or_assign(path, fs::last_write_time(path, ec));
+					PushChange(path, inserted ? FileStatus::Created : FileStatus::Modified);
+				}
+			}
+		}
+	}
+#endif
+}
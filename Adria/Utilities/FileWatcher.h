@@ -1,4 +1,5 @@
 #pragma once
+#include <atomic>
 #include "Utilities/Delegate.h"
 
 namespace adria
@@ -10,50 +11,70 @@ namespace adria
 		Deleted
 	};
 
-	DECLARE_EVENT(FileModifiedEvent, FileWatcher, std::string const&)
+	DECLARE_EVENT(FileModifiedEvent, FileWatcher, std::string const&, FileStatus)
+
+	//watches directories on a background thread, with inotify on Linux and by polling timestamps elsewhere.
+	//Changes to the same file are coalesced and only delivered once the file has been quiet for the debounce time,
+	//CheckWatchedFiles broadcasts them on the calling thread
 	class FileWatcher
 	{
-	public:
-		FileWatcher() = default;
-		~FileWatcher()
-		{
-			file_modified_event.RemoveAll();
-		}
+		using Clock = std::chrono::steady_clock;
 
-		void AddPathToWatch(std::string const& path, Bool recursive = true)
+		struct PendingChange
 		{
-			if (recursive)
-			{
-				for (auto& path : std::filesystem::recursive_directory_iterator(path))
-				{
-					if (path.is_regular_file()) files_map[path.path().string()] = std::filesystem::last_write_time(path);
-				}
-			}
-			else
-			{
-				for (auto& path : std::filesystem::directory_iterator(path))
-				{
-					if (path.is_regular_file()) files_map[path.path().string()] = std::filesystem::last_write_time(path);
-				}
-			}
-		}
-		void CheckWatchedFiles()
+			FileStatus status;
+			Clock::time_point time;
+		};
+		struct WatchedPath
 		{
-			for (auto const& [file, ft] : files_map)
-			{
-				auto current_file_last_write_time = std::filesystem::last_write_time(file);
-				if (files_map[file] != current_file_last_write_time)
-				{
-					files_map[file] = current_file_last_write_time;
-					file_modified_event.Broadcast(file);
-				}
-			}
-		}
+			std::string path;
+			Bool recursive;
+		};
+
+	public:
+		static constexpr std::chrono::milliseconds DefaultDebounceTime{ 100 };
+		static constexpr std::chrono::milliseconds PollInterval{ 250 };
+
+	public:
+		explicit FileWatcher(std::chrono::milliseconds debounce_time = DefaultDebounceTime);
+		ADRIA_NONCOPYABLE_NONMOVABLE(FileWatcher)
+		~FileWatcher();
+
+		void AddPathToWatch(std::string const& path, Bool recursive = true);
+		//cheap enough to call every frame
+		Bool HasPendingChanges() const;
+		void CheckWatchedFiles();
 
 		FileModifiedEvent& GetFileModifiedEvent() { return file_modified_event; }
 
 	private:
-		std::unordered_map<std::string, std::filesystem::file_time_type> files_map;
 		FileModifiedEvent file_modified_event;
+		std::chrono::milliseconds const debounce_time;
+
+		mutable std::mutex pending_mutex;
+		std::unordered_map<std::string, PendingChange> pending_changes;
+		std::atomic<Uint32> pending_count = 0;
+
+		std::mutex watch_mutex;
+		std::vector<WatchedPath> watched_paths;
+		std::unordered_map<std::string, std::filesystem::file_time_type> files_map;
+#if defined(ADRIA_PLATFORM_LINUX)
+		Int inotify_fd = -1;
+		std::unordered_map<Int, WatchedPath> watch_descriptors;
+#endif
+
+		std::thread watch_thread;
+		std::mutex stop_mutex;
+		std::condition_variable stop_condition;
+		Bool stop = false;
+
+	private:
+		void WatchThread();
+		void PushChange(std::string const& file, FileStatus status);
+		void AddDirectory(std::string const& directory, Bool recursive, Bool report_created);
+		void PollWatchedPaths();
+#if defined(ADRIA_PLATFORM_LINUX)
+		void ReadNotifyEvents();
+#endif
 	};
-}
\ No newline at end of file
+}
@@ -3,6 +3,8 @@
 #include <stb_image.h>
 #include "Utilities/PathHelpers.h"
 #include "Utilities/StringConversions.h"
+#include "Utilities/MipGenerator.h"
+#include "Utilities/BCEncoder.h"
 
 // Define DXGI_FORMAT values for non-Windows platforms
 #if !defined(ADRIA_PLATFORM_WINDOWS)
@@ -96,6 +98,67 @@ namespace adria
 		ADRIA_ASSERT(result);
 	}
 
+	Image::Image(GfxFormat format, Uint32 width, Uint32 height, Uint32 mip_levels, std::vector<Uint8>&& pixels)
+		: width(width), height(height), depth(1), mip_levels(mip_levels), pixels(std::move(pixels)), is_hdr(format == GfxFormat::R32G32B32A32_FLOAT), format(format)
+	{
+		ADRIA_ASSERT(this->pixels.size() == GetTextureByteSize(format, width, height, 1, mip_levels));
+	}
+
+	void Image::GenerateMips(Bool srgb, Float alpha_cutoff)
+	{
+		if (mip_levels != 1 || depth != 1 || is_cubemap || next_image)
+		{
+			return;
+		}
+		if (format != GfxFormat::R8G8B8A8_UNORM && format != GfxFormat::R32G32B32A32_FLOAT)
+		{
+			return;
+		}
+		Uint32 const mip_count = GetMipLevelCount(width, height);
+		if (mip_count == 1)
+		{
+			return;
+		}
+
+		pixels.resize(GetTextureByteSize(format, width, height, 1, mip_count));
+		if (format == GfxFormat::R8G8B8A8_UNORM)
+		{
+			GenerateMipChainRGBA8(pixels.data(), width, height, mip_count, srgb, alpha_cutoff);
+		}
+		else
+		{
+			GenerateMipChainRGBA32F(reinterpret_cast<Float*>(pixels.data()), width, height, mip_count);
+		}
+		mip_levels = mip_count;
+	}
+
+	void Image::Compress(GfxFormat compressed_format)
+	{
+		ADRIA_ASSERT(IsBCEncoderFormat(compressed_format));
+		if (format != GfxFormat::R8G8B8A8_UNORM || depth != 1 || is_cubemap || next_image)
+		{
+			return;
+		}
+		if (width % 4 != 0 || height % 4 != 0)
+		{
+			return;
+		}
+
+		std::vector<Uint8> compressed_pixels(GetTextureByteSize(compressed_format, width, height, 1, mip_levels));
+		Uint64 src_offset = 0;
+		Uint64 dst_offset = 0;
+		for (Uint32 mip = 0; mip < mip_levels; ++mip)
+		{
+			Uint32 const mip_width = std::max(width >> mip, 1u);
+			Uint32 const mip_height = std::max(height >> mip, 1u);
+			CompressSurfaceBC(compressed_format, pixels.data() + src_offset, mip_width, mip_height, compressed_pixels.data() + dst_offset);
+			src_offset += GetTextureMipByteSize(format, width, height, 1, mip);
+			dst_offset += GetTextureMipByteSize(compressed_format, width, height, 1, mip);
+		}
+		pixels = std::move(compressed_pixels);
+		format = compressed_format;
+	}
+
 	Uint64 Image::SetData(Uint32 _width, Uint32 _height, Uint32 _depth, Uint32 _mip_levels, void const* _data)
 	{
 		width = std::max(_width, 1u);
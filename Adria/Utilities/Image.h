@@ -8,6 +8,7 @@ namespace adria
 	public:
 		explicit Image(GfxFormat format) : format(format) {}
 		explicit Image(std::string_view file_path);
+		Image(GfxFormat format, Uint32 width, Uint32 height, Uint32 mip_levels, std::vector<Uint8>&& pixels);
 
 		Uint32 Width() const
 		{
@@ -26,6 +27,7 @@ namespace adria
 			return mip_levels;
 		}
 		GfxFormat Format() const { return format; }
+		Uint64 DataSize() const { return pixels.size(); }
 		Bool IsHDR() const { return is_hdr; }
 		Bool IsCubemap() const { return is_cubemap; }
 
@@ -36,6 +38,11 @@ namespace adria
 
 		Image const* NextImage() const { return next_image.get(); }
 
+		//builds the full mip chain of single level 2D rgba8 and rgba32f images, other images are left unchanged
+		void GenerateMips(Bool srgb, Float alpha_cutoff = 0.0f);
+		//block compresses every mip of a 2D rgba8 image whose size is a multiple of 4, other images are left unchanged
+		void Compress(GfxFormat compressed_format);
+
 	private:
 		Uint32 width = 0;
 		Uint32 height = 0;
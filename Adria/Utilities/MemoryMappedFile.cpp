@@ -0,0 +1,98 @@
+#include "MemoryMappedFile.h"
+#ifdef _WIN32
+#include <Windows.h>
+#else
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace adria
+{
+	MemoryMappedFile::MemoryMappedFile(Char const* filename)
+	{
+		Open(filename);
+	}
+
+	MemoryMappedFile::~MemoryMappedFile()
+	{
+		Close();
+	}
+
+	Bool MemoryMappedFile::Open(Char const* filename)
+	{
+		Close();
+#ifdef _WIN32
+		HANDLE file = CreateFileA(filename, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+		if (file == INVALID_HANDLE_VALUE)
+		{
+			return false;
+		}
+		LARGE_INTEGER file_size{};
+		if (!GetFileSizeEx(file, &file_size) || file_size.QuadPart == 0)
+		{
+			CloseHandle(file);
+			return false;
+		}
+		HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+		if (!mapping)
+		{
+			CloseHandle(file);
+			return false;
+		}
+		void* view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+		if (!view)
+		{
+			CloseHandle(mapping);
+			CloseHandle(file);
+			return false;
+		}
+		file_handle = file;
+		mapping_handle = mapping;
+		data = static_cast<Uint8 const*>(view);
+		size = (Uint64)file_size.QuadPart;
+#else
+		Int const fd = open(filename, O_RDONLY);
+		if (fd < 0)
+		{
+			return false;
+		}
+		struct stat file_stat{};
+		if (fstat(fd, &file_stat) != 0 || file_stat.st_size == 0)
+		{
+			close(fd);
+			return false;
+		}
+		void* view = mmap(nullptr, (size_t)file_stat.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+		close(fd);
+		if (view == MAP_FAILED)
+		{
+			return false;
+		}
+		madvise(view, (size_t)file_stat.st_size, MADV_SEQUENTIAL);
+		data = static_cast<Uint8 const*>(view);
+		size = (Uint64)file_stat.st_size;
+#endif
+		return true;
+	}
+
+	void MemoryMappedFile::Close()
+	{
+		if (!data)
+		{
+			return;
+		}
+#ifdef _WIN32
+		UnmapViewOfFile(data);
+		CloseHandle((HANDLE)mapping_handle);
+		CloseHandle((HANDLE)file_handle);
+		mapping_handle = nullptr;
+		file_handle = nullptr;
+#else
+		munmap(const_cast<Uint8*>(data), (size_t)size);
+#endif
+		data = nullptr;
+		size = 0;
+	}
+}
@@ -0,0 +1,29 @@
+#pragma once
+
+namespace adria
+{
+	//read only view of a whole file
+	class MemoryMappedFile final
+	{
+	public:
+		MemoryMappedFile() = default;
+		explicit MemoryMappedFile(Char const* filename);
+		ADRIA_NONCOPYABLE_NONMOVABLE(MemoryMappedFile)
+		~MemoryMappedFile();
+
+		Bool IsOpen() const { return data != nullptr; }
+		Bool Open(Char const* filename);
+		void Close();
+
+		Uint8 const* GetData() const { return data; }
+		Uint64 GetSize() const { return size; }
+
+	private:
+		Uint8 const* data = nullptr;
+		Uint64 size = 0;
+#if defined(_WIN32)
+		void* file_handle = nullptr;
+		void* mapping_handle = nullptr;
+#endif
+	};
+}
@@ -0,0 +1,37 @@
+#include "MemoryTracker.h"
+
+namespace adria
+{
+	MemoryTracker::Counters MemoryTracker::counters[(Uint64)MemoryCategory::Count];
+
+	void MemoryTracker::Allocate(MemoryCategory category, Uint64 size)
+	{
+		Counters& category_counters = counters[(Uint64)category];
+		Uint64 const current = category_counters.current.fetch_add(size, std::memory_order_relaxed) + size;
+		Uint64 peak = category_counters.peak.load(std::memory_order_relaxed);
+		while (current > peak && !category_counters.peak.compare_exchange_weak(peak, current, std::memory_order_relaxed));
+	}
+
+	void MemoryTracker::Free(MemoryCategory category, Uint64 size)
+	{
+		Counters& category_counters = counters[(Uint64)category];
+		ADRIA_ASSERT(category_counters.current.load(std::memory_order_relaxed) >= size);
+		category_counters.current.fetch_sub(size, std::memory_order_relaxed);
+	}
+
+	Uint64 MemoryTracker::GetCurrent(MemoryCategory category)
+	{
+		return counters[(Uint64)category].current.load(std::memory_order_relaxed);
+	}
+
+	Uint64 MemoryTracker::GetPeak(MemoryCategory category)
+	{
+		return counters[(Uint64)category].peak.load(std::memory_order_relaxed);
+	}
+
+	void MemoryTracker::ResetPeak(MemoryCategory category)
+	{
+		Counters& category_counters = counters[(Uint64)category];
+		category_counters.peak.store(category_counters.current.load(std::memory_order_relaxed), std::memory_order_relaxed);
+	}
+}
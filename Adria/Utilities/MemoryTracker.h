@@ -0,0 +1,66 @@
+#pragma once
+#include <atomic>
+
+namespace adria
+{
+	enum class MemoryCategory : Uint8
+	{
+		ModelImport,
+		GeometryStaging,
+		TextureStaging,
+		Count
+	};
+
+	//byte counters of tagged cpu allocations, current and peak per category. Safe to use from worker threads
+	class MemoryTracker
+	{
+	public:
+		static void Allocate(MemoryCategory category, Uint64 size);
+		static void Free(MemoryCategory category, Uint64 size);
+
+		static Uint64 GetCurrent(MemoryCategory category);
+		static Uint64 GetPeak(MemoryCategory category);
+		//restarts peak tracking from the current usage
+		static void ResetPeak(MemoryCategory category);
+
+	private:
+		struct Counters
+		{
+			std::atomic<Uint64> current = 0;
+			std::atomic<Uint64> peak = 0;
+		};
+		static Counters counters[(Uint64)MemoryCategory::Count];
+	};
+
+	template<typename T, MemoryCategory Category>
+	struct TrackedAllocator
+	{
+		using value_type = T;
+		template<typename U>
+		struct rebind
+		{
+			using other = TrackedAllocator<U, Category>;
+		};
+
+		TrackedAllocator() = default;
+		template<typename U>
+		TrackedAllocator(TrackedAllocator<U, Category> const&) {}
+
+		T* allocate(Uint64 count)
+		{
+			MemoryTracker::Allocate(Category, count * sizeof(T));
+			return std::allocator<T>{}.allocate(count);
+		}
+		void deallocate(T* ptr, Uint64 count)
+		{
+			MemoryTracker::Free(Category, count * sizeof(T));
+			std::allocator<T>{}.deallocate(ptr, count);
+		}
+
+		template<typename U>
+		Bool operator==(TrackedAllocator<U, Category> const&) const { return true; }
+	};
+
+	template<typename T, MemoryCategory Category>
+	using TrackedVector = std::vector<T, TrackedAllocator<T, Category>>;
+}
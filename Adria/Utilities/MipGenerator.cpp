@@ -0,0 +1,185 @@
+#include "MipGenerator.h"
+
+using namespace DirectX;
+
+namespace adria
+{
+	namespace
+	{
+		struct SRGBTables
+		{
+			Float to_linear[256];
+			Uint8 from_linear[4096];
+
+			SRGBTables()
+			{
+				for (Uint32 i = 0; i < 256; ++i)
+				{
+					Float const c = i / 255.0f;
+					to_linear[i] = c <= 0.04045f ? c / 12.92f : std::pow((c + 0.055f) / 1.055f, 2.4f);
+				}
+				for (Uint32 i = 0; i < 4096; ++i)
+				{
+					Float const l = i / 4095.0f;
+					Float const c = l <= 0.0031308f ? l * 12.92f : 1.055f * std::pow(l, 1.0f / 2.4f) - 0.055f;
+					from_linear[i] = (Uint8)std::clamp(c * 255.0f + 0.5f, 0.0f, 255.0f);
+				}
+			}
+		};
+		SRGBTables const& GetSRGBTables()
+		{
+			static SRGBTables const tables;
+			return tables;
+		}
+
+		//two channels per 32 bit lane, the sum of four bytes fits in the 16 bit gaps
+		inline Uint32 AverageRGBA8(Uint32 p0, Uint32 p1, Uint32 p2, Uint32 p3)
+		{
+			constexpr Uint32 Mask = 0x00FF00FF;
+			constexpr Uint32 Round = 0x00020002;
+			Uint32 const even = ((p0 & Mask) + (p1 & Mask) + (p2 & Mask) + (p3 & Mask) + Round) >> 2;
+			Uint32 const odd = (((p0 >> 8) & Mask) + ((p1 >> 8) & Mask) + ((p2 >> 8) & Mask) + ((p3 >> 8) & Mask) + Round) >> 2;
+			return (even & Mask) | ((odd & Mask) << 8);
+		}
+
+		inline XMVECTOR LoadLinear(Uint8 const* texel, SRGBTables const& tables)
+		{
+			return XMVectorSet(tables.to_linear[texel[0]], tables.to_linear[texel[1]], tables.to_linear[texel[2]], texel[3] * (1.0f / 255.0f));
+		}
+
+		inline void StoreSRGB(Uint8* texel, FXMVECTOR linear, SRGBTables const& tables)
+		{
+			XMFLOAT4 value;
+			XMStoreFloat4(&value, XMVectorSaturate(linear));
+			texel[0] = tables.from_linear[(Uint32)(value.x * 4095.0f + 0.5f)];
+			texel[1] = tables.from_linear[(Uint32)(value.y * 4095.0f + 0.5f)];
+			texel[2] = tables.from_linear[(Uint32)(value.z * 4095.0f + 0.5f)];
+			texel[3] = (Uint8)(value.w * 255.0f + 0.5f);
+		}
+
+		//calls filter(dst_index, src_index00, src_index10, src_index01, src_index11), odd source sizes clamp the last row and column
+		template<typename F>
+		void DownsampleLevel(Uint32 src_width, Uint32 src_height, F&& filter)
+		{
+			Uint32 const dst_width = std::max(src_width >> 1, 1u);
+			Uint32 const dst_height = std::max(src_height >> 1, 1u);
+			for (Uint32 y = 0; y < dst_height; ++y)
+			{
+				Uint64 const row0 = (Uint64)std::min(2 * y, src_height - 1) * src_width;
+				Uint64 const row1 = (Uint64)std::min(2 * y + 1, src_height - 1) * src_width;
+				for (Uint32 x = 0; x < dst_width; ++x)
+				{
+					Uint64 const x0 = std::min(2 * x, src_width - 1);
+					Uint64 const x1 = std::min(2 * x + 1, src_width - 1);
+					filter((Uint64)y * dst_width + x, row0 + x0, row0 + x1, row1 + x0, row1 + x1);
+				}
+			}
+		}
+
+		inline Uint8 ScaleAlpha(Uint8 alpha, Float alpha_scale)
+		{
+			return (Uint8)std::min(alpha * alpha_scale + 0.5f, 255.0f);
+		}
+
+		//coverage is measured on the quantized alpha so the search can not settle on a scale that rounds onto the cutoff
+		Float ComputeAlphaCoverage(Uint8 const* texels, Uint64 texel_count, Float alpha_cutoff, Float alpha_scale)
+		{
+			Float const threshold = alpha_cutoff * 255.0f;
+			Uint64 covered = 0;
+			for (Uint64 i = 0; i < texel_count; ++i)
+			{
+				covered += ScaleAlpha(texels[i * 4 + 3], alpha_scale) > threshold;
+			}
+			return (Float)covered / texel_count;
+		}
+
+		void PreserveAlphaCoverage(Uint8* texels, Uint64 texel_count, Float alpha_cutoff, Float target_coverage)
+		{
+			Float min_scale = 0.0f;
+			Float max_scale = 4.0f;
+			for (Uint32 i = 0; i < 12; ++i)
+			{
+				Float const scale = 0.5f * (min_scale + max_scale);
+				if (ComputeAlphaCoverage(texels, texel_count, alpha_cutoff, scale) < target_coverage)
+				{
+					min_scale = scale;
+				}
+				else
+				{
+					max_scale = scale;
+				}
+			}
+			Float const alpha_scale = max_scale;
+			for (Uint64 i = 0; i < texel_count; ++i)
+			{
+				texels[i * 4 + 3] = ScaleAlpha(texels[i * 4 + 3], alpha_scale);
+			}
+		}
+	}
+
+	void GenerateMipChainRGBA8(Uint8* data, Uint32 width, Uint32 height, Uint32 mip_levels, Bool srgb, Float alpha_cutoff)
+	{
+		SRGBTables const& tables = GetSRGBTables();
+		Float const target_coverage = alpha_cutoff > 0.0f ? ComputeAlphaCoverage(data, (Uint64)width * height, alpha_cutoff, 1.0f) : 0.0f;
+		Bool const preserve_coverage = target_coverage > 0.0f;
+
+		//levels are filtered from the unscaled previous level, the alpha coverage fix up is applied once a level is no longer needed as a source
+		Uint8* src = data;
+		for (Uint32 mip = 1; mip < mip_levels; ++mip)
+		{
+			Uint32 const src_width = std::max(width >> (mip - 1), 1u);
+			Uint32 const src_height = std::max(height >> (mip - 1), 1u);
+			Uint8* dst = src + (Uint64)src_width * src_height * 4;
+			if (srgb)
+			{
+				DownsampleLevel(src_width, src_height, [&](Uint64 d, Uint64 s00, Uint64 s10, Uint64 s01, Uint64 s11)
+					{
+						XMVECTOR sum = XMVectorAdd(LoadLinear(src + s00 * 4, tables), LoadLinear(src + s10 * 4, tables));
+						sum = XMVectorAdd(sum, XMVectorAdd(LoadLinear(src + s01 * 4, tables), LoadLinear(src + s11 * 4, tables)));
+						StoreSRGB(dst + d * 4, XMVectorScale(sum, 0.25f), tables);
+					});
+			}
+			else
+			{
+				Uint32 const* src_texels = reinterpret_cast<Uint32 const*>(src);
+				Uint32* dst_texels = reinterpret_cast<Uint32*>(dst);
+				DownsampleLevel(src_width, src_height, [&](Uint64 d, Uint64 s00, Uint64 s10, Uint64 s01, Uint64 s11)
+					{
+						dst_texels[d] = AverageRGBA8(src_texels[s00], src_texels[s10], src_texels[s01], src_texels[s11]);
+					});
+			}
+
+			if (preserve_coverage && mip > 1)
+			{
+				PreserveAlphaCoverage(src, (Uint64)src_width * src_height, alpha_cutoff, target_coverage);
+			}
+			src = dst;
+		}
+		if (preserve_coverage && mip_levels > 1)
+		{
+			Uint32 const last_width = std::max(width >> (mip_levels - 1), 1u);
+			Uint32 const last_height = std::max(height >> (mip_levels - 1), 1u);
+			PreserveAlphaCoverage(src, (Uint64)last_width * last_height, alpha_cutoff, target_coverage);
+		}
+	}
+
+	void GenerateMipChainRGBA32F(Float* data, Uint32 width, Uint32 height, Uint32 mip_levels)
+	{
+		Float* src = data;
+		for (Uint32 mip = 1; mip < mip_levels; ++mip)
+		{
+			Uint32 const src_width = std::max(width >> (mip - 1), 1u);
+			Uint32 const src_height = std::max(height >> (mip - 1), 1u);
+			Float* dst = src + (Uint64)src_width * src_height * 4;
+			XMFLOAT4 const* src_texels = reinterpret_cast<XMFLOAT4 const*>(src);
+			XMFLOAT4* dst_texels = reinterpret_cast<XMFLOAT4*>(dst);
+			DownsampleLevel(src_width, src_height, [&](Uint64 d, Uint64 s00, Uint64 s10, Uint64 s01, Uint64 s11)
+				{
+					XMVECTOR sum = XMVectorAdd(XMLoadFloat4(&src_texels[s00]), XMLoadFloat4(&src_texels[s10]));
+					sum = XMVectorAdd(sum, XMVectorAdd(XMLoadFloat4(&src_texels[s01]), XMLoadFloat4(&src_texels[s11])));
+					XMStoreFloat4(&dst_texels[d], XMVectorScale(sum, 0.25f));
+				});
+			src = dst;
+		}
+	}
+}
@@ -0,0 +1,14 @@
+#pragma once
+
+namespace adria
+{
+	inline Uint32 GetMipLevelCount(Uint32 width, Uint32 height)
+	{
+		return (Uint32)std::bit_width(std::max(std::max(width, height), 1u));
+	}
+
+	//fills mip levels [1, mip_levels) of a tightly packed chain from mip 0 at the start of data, every level is a 2x2 box filter of the previous one.
+	//sRGB data is filtered in linear space, alpha_cutoff > 0 rescales the alpha of every level so it keeps the alpha test coverage of mip 0
+	void GenerateMipChainRGBA8(Uint8* data, Uint32 width, Uint32 height, Uint32 mip_levels, Bool srgb, Float alpha_cutoff = 0.0f);
+	void GenerateMipChainRGBA32F(Float* data, Uint32 width, Uint32 height, Uint32 mip_levels);
+}
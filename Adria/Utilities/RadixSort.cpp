@@ -0,0 +1,87 @@
+#include "RadixSort.h"
+#include "ThreadPool.h"
+
+namespace adria
+{
+	static constexpr Uint32 RadixBits = 8;
+	static constexpr Uint32 RadixSize = 1u << RadixBits;
+	static constexpr Uint32 PassCount = 64 / RadixBits;
+	static constexpr Uint64 MinChunkSize = 8192;
+	//below this the eight histogram and scatter passes cost more than a comparison sort
+	static constexpr Uint64 MinRadixSortSize = 2048;
+
+	void RadixSort(std::span<RadixSortItem> items, std::span<RadixSortItem> scratch)
+	{
+		Uint64 const count = items.size();
+		ADRIA_ASSERT(scratch.size() >= count);
+		if (count <= 1)
+		{
+			return;
+		}
+		if (count < MinRadixSortSize)
+		{
+			std::stable_sort(items.begin(), items.end(), [](RadixSortItem const& lhs, RadixSortItem const& rhs) { return lhs.key < rhs.key; });
+			return;
+		}
+
+		Uint64 const chunk_count = std::clamp<Uint64>(count / MinChunkSize, 1, std::max<Uint64>(g_ThreadPool.GetWorkerCount(), 1) * 2);
+		Uint64 const chunk_size = (count + chunk_count - 1) / chunk_count;
+		std::vector<std::array<Uint64, RadixSize>> histograms(chunk_count);
+
+		RadixSortItem* src = items.data();
+		RadixSortItem* dst = scratch.data();
+		for (Uint32 pass = 0; pass < PassCount; ++pass)
+		{
+			Uint32 const shift = pass * RadixBits;
+			g_ThreadPool.ParallelFor(0, chunk_count, 1, [&](Uint64 chunk)
+				{
+					std::array<Uint64, RadixSize>& histogram = histograms[chunk];
+					histogram.fill(0);
+					Uint64 const end = std::min((chunk + 1) * chunk_size, count);
+					for (Uint64 i = chunk * chunk_size; i < end; ++i)
+					{
+						++histogram[(src[i].key >> shift) & (RadixSize - 1)];
+					}
+				});
+
+			Uint64 const first_digit = (src[0].key >> shift) & (RadixSize - 1);
+			Uint64 first_digit_count = 0;
+			for (std::array<Uint64, RadixSize> const& histogram : histograms)
+			{
+				first_digit_count += histogram[first_digit];
+			}
+			if (first_digit_count == count)
+			{
+				continue;
+			}
+
+			//chunk histograms become the scatter offsets, digit major so equal keys keep their order across chunks
+			Uint64 offset = 0;
+			for (Uint32 digit = 0; digit < RadixSize; ++digit)
+			{
+				for (std::array<Uint64, RadixSize>& histogram : histograms)
+				{
+					Uint64 const digit_count = histogram[digit];
+					histogram[digit] = offset;
+					offset += digit_count;
+				}
+			}
+
+			g_ThreadPool.ParallelFor(0, chunk_count, 1, [&](Uint64 chunk)
+				{
+					std::array<Uint64, RadixSize>& offsets = histograms[chunk];
+					Uint64 const end = std::min((chunk + 1) * chunk_size, count);
+					for (Uint64 i = chunk * chunk_size; i < end; ++i)
+					{
+						dst[offsets[(src[i].key >> shift) & (RadixSize - 1)]++] = src[i];
+					}
+				});
+			std::swap(src, dst);
+		}
+
+		if (src != items.data())
+		{
+			std::copy(src, src + count, items.data());
+		}
+	}
+}
@@ -0,0 +1,14 @@
+#pragma once
+
+namespace adria
+{
+	struct RadixSortItem
+	{
+		Uint64 key;
+		Uint32 value;
+	};
+
+	//stable LSD radix sort on the 64 bit keys, one byte per pass, passes in which every key has the same byte are skipped.
+	//Large inputs build histograms and scatter on the thread pool, the result does not depend on the number of workers
+	void RadixSort(std::span<RadixSortItem> items, std::span<RadixSortItem> scratch);
+}
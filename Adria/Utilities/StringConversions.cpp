@@ -157,7 +157,14 @@ namespace adria
 
 	std::string Vector3ToString(Vector3 const& val)
 	{
-		return "(" + std::to_string(val.x) + "," + std::to_string(val.y) + "," + std::to_string(val.z) + ")";
+		std::string result = "(";
+		result += std::to_string(val.x);
+		result += ',';
+		result += std::to_string(val.y);
+		result += ',';
+		result += std::to_string(val.z);
+		result += ')';
+		return result;
 	}
 
 	std::vector<std::string> SplitString(const std::string& text, Char delimeter)
@@ -0,0 +1,199 @@
+#include "ThreadPool.h"
+
+namespace adria
+{
+	void ThreadPool::Initialize(Uint pool_size)
+	{
+		done = false;
+		static const Uint max_threads = std::thread::hardware_concurrency();
+		//at least one background thread so submitted tasks always make progress
+		Uint const num_threads = std::max<Uint>(pool_size == 0 ? max_threads - 1 : std::min(max_threads - 1, pool_size), 1);
+
+		//worker 0 is the thread that initializes the pool, it only executes jobs while waiting
+		workers.reserve(num_threads + 1);
+		for (Uint i = 0; i <= num_threads; ++i)
+		{
+			workers.push_back(std::make_unique<Worker>());
+		}
+		worker_index = 0;
+
+		threads.reserve(num_threads);
+		for (Uint i = 0; i < num_threads; ++i)
+		{
+			threads.emplace_back(&ThreadPool::ThreadWork, this, Int32(i + 1));
+		}
+	}
+
+	void ThreadPool::Shutdown()
+	{
+		if (!done)
+		{
+			done = true;
+			work_epoch.fetch_add(1, std::memory_order_seq_cst);
+			work_epoch.notify_all();
+			for (Uint i = 0; i < threads.size(); ++i)
+			{
+				if (threads[i].joinable())
+				{
+					threads[i].join();
+				}
+			}
+			threads.clear();
+			workers.clear();
+			worker_index = -1;
+		}
+	}
+
+	void ThreadPool::Wait(JobCounter& counter)
+	{
+		while (!counter.IsDone())
+		{
+			if (!TryExecuteJob())
+			{
+				std::this_thread::yield();
+			}
+		}
+	}
+
+	ThreadPool::Job* ThreadPool::AllocateJob()
+	{
+		if (worker_index < 0)
+		{
+			return AllocateExternalJob();
+		}
+
+		//slots can stay in use for a long time, e.g. by a job further up this thread's stack that waits on nested jobs, so busy slots are skipped
+		Worker& worker = *workers[worker_index];
+		while (true)
+		{
+			for (Uint64 i = 0; i < JobCapacity; ++i)
+			{
+				Job* job = &worker.job_pool[worker.job_pool_index++ & (JobCapacity - 1)];
+				if (!job->in_use.load(std::memory_order_acquire))
+				{
+					job->in_use.store(true, std::memory_order_relaxed);
+					return job;
+				}
+			}
+			if (!TryExecuteJob())
+			{
+				std::this_thread::yield();
+			}
+		}
+	}
+
+	ThreadPool::Job* ThreadPool::AllocateExternalJob()
+	{
+		std::lock_guard<std::mutex> lock(external_job_pool_mutex);
+		while (true)
+		{
+			for (Uint64 i = 0; i < JobCapacity; ++i)
+			{
+				Job* job = &external_job_pool[external_job_pool_index++ & (JobCapacity - 1)];
+				if (!job->in_use.load(std::memory_order_acquire))
+				{
+					job->in_use.store(true, std::memory_order_relaxed);
+					return job;
+				}
+			}
+			std::this_thread::yield();
+		}
+	}
+
+	void ThreadPool::PushJob(Job* job)
+	{
+		if (worker_index >= 0)
+		{
+			if (!workers[worker_index]->jobs.Push(job))
+			{
+				ExecuteJob(job);
+				return;
+			}
+		}
+		else
+		{
+			external_job_count.fetch_add(1, std::memory_order_relaxed);
+			external_jobs.Push(job);
+		}
+		WakeWorker();
+	}
+
+	void ThreadPool::WakeWorker()
+	{
+		std::atomic_thread_fence(std::memory_order_seq_cst);
+		if (sleeping_workers.load(std::memory_order_relaxed) > 0)
+		{
+			work_epoch.fetch_add(1, std::memory_order_relaxed);
+			work_epoch.notify_one();
+		}
+	}
+
+	Bool ThreadPool::TryExecuteJob()
+	{
+		Job* job = nullptr;
+		if (worker_index >= 0 && workers[worker_index]->jobs.Pop(job))
+		{
+			ExecuteJob(job);
+			return true;
+		}
+		if (external_job_count.load(std::memory_order_relaxed) > 0 && external_jobs.TryPop(job))
+		{
+			external_job_count.fetch_sub(1, std::memory_order_relaxed);
+			ExecuteJob(job);
+			return true;
+		}
+
+		Uint64 const worker_count = workers.size();
+		Uint64 const first_victim = worker_index >= 0 ? worker_index + 1 : 0;
+		for (Uint64 i = 0; i < worker_count; ++i)
+		{
+			Uint64 const victim = (first_victim + i) % worker_count;
+			if (Int32(victim) != worker_index && workers[victim]->jobs.Steal(job))
+			{
+				ExecuteJob(job);
+				return true;
+			}
+		}
+		return false;
+	}
+
+	Bool ThreadPool::TryExecuteBackgroundJob()
+	{
+		Job* job = nullptr;
+		if (!background_jobs.IsDone() && background_job_queue.TryPop(job))
+		{
+			ExecuteJob(job);
+			return true;
+		}
+		return false;
+	}
+
+	void ThreadPool::ExecuteJob(Job* job)
+	{
+		job->function();
+		job->function.Reset();
+		JobCounter* counter = job->counter;
+		job->in_use.store(false, std::memory_order_release);
+		counter->pending.fetch_sub(1, std::memory_order_acq_rel);
+	}
+
+	void ThreadPool::ThreadWork(Int32 index)
+	{
+		worker_index = index;
+		while (!done.load(std::memory_order_acquire))
+		{
+			if (TryExecuteJob() || TryExecuteBackgroundJob())
+			{
+				continue;
+			}
+
+			sleeping_workers.fetch_add(1, std::memory_order_seq_cst);
+			Uint32 const epoch = work_epoch.load(std::memory_order_seq_cst);
+			if (!TryExecuteJob() && !TryExecuteBackgroundJob() && !done.load(std::memory_order_acquire))
+			{
+				work_epoch.wait(epoch, std::memory_order_seq_cst);
+			}
+			sleeping_workers.fetch_sub(1, std::memory_order_relaxed);
+		}
+	}
+}
@@ -1,103 +1,210 @@
 #pragma once
 #include <future>
 #include <type_traits>
+#include <ranges>
+#include <atomic>
 #include "ConcurrentQueue.h"
+#include "WorkStealingDeque.h"
 #include "Singleton.h"
 
 namespace adria
 {
+	//type erased callable stored inline, a callable that does not fit is a compile error instead of a heap allocation
+	template<Uint64 Size>
+	class InlineTask
+	{
+	public:
+		InlineTask() = default;
+		ADRIA_NONCOPYABLE_NONMOVABLE(InlineTask)
+		~InlineTask()
+		{
+			Reset();
+		}
+
+		template<typename F>
+		void Emplace(F&& f)
+		{
+			using CallableType = std::decay_t<F>;
+			static_assert(sizeof(CallableType) <= Size, "Task does not fit in the inline storage, capture less or capture by reference");
+			static_assert(alignof(CallableType) <= alignof(std::max_align_t));
+			Reset();
+			new (storage) CallableType(std::forward<F>(f));
+			invoke = [](void* callable) { (*static_cast<CallableType*>(callable))(); };
+			destroy = [](void* callable) { static_cast<CallableType*>(callable)->~CallableType(); };
+		}
+		void Reset()
+		{
+			if (destroy)
+			{
+				destroy(storage);
+				invoke = nullptr;
+				destroy = nullptr;
+			}
+		}
+		void operator()()
+		{
+			invoke(storage);
+		}
+
+	private:
+		alignas(std::max_align_t) Uint8 storage[Size];
+		void(*invoke)(void*) = nullptr;
+		void(*destroy)(void*) = nullptr;
+	};
+
+	//number of outstanding jobs of a group, ThreadPool::Wait executes other jobs until it drops to zero
+	class JobCounter
+	{
+		friend class ThreadPool;
+	public:
+		JobCounter() = default;
+		ADRIA_NONCOPYABLE_NONMOVABLE(JobCounter)
+
+		Bool IsDone() const { return pending.load(std::memory_order_acquire) == 0; }
+
+	private:
+		std::atomic<Uint32> pending = 0;
+	};
+
 	class ThreadPool : public Singleton<ThreadPool>
 	{
 		friend class Singleton<ThreadPool>;
+
+		static constexpr Uint64 JobCapacity = 4096;
+		static constexpr Uint64 JobFunctionSize = 64;
+
+		struct Job
+		{
+			InlineTask<JobFunctionSize> function;
+			JobCounter* counter = nullptr;
+			std::atomic<Bool> in_use = false;
+		};
+
+		//every worker allocates jobs from its own ring and pushes them to its own deque, idle workers steal from the others
+		struct Worker
+		{
+			WorkStealingDeque<Job*, JobCapacity> jobs;
+			std::unique_ptr<Job[]> job_pool = std::make_unique<Job[]>(JobCapacity);
+			Uint64 job_pool_index = 0;
+		};
+
 	public:
 
 		ADRIA_NONCOPYABLE_NONMOVABLE(ThreadPool)
 		~ThreadPool() = default;
 
-		void Initialize(Uint pool_size = std::thread::hardware_concurrency() - 1)
+		void Initialize(Uint pool_size = std::thread::hardware_concurrency() - 1);
+		void Shutdown();
+
+		Uint GetWorkerCount() const { return (Uint)workers.size(); }
+
+		template<typename F>
+		void Dispatch(JobCounter& counter, F&& f)
 		{
-			done = false;
-			static const Uint max_threads = std::thread::hardware_concurrency();
-			Uint const num_threads = pool_size == 0 ? max_threads - 1 : std::min(max_threads - 1, pool_size);
-			threads.reserve(num_threads);
-			for (Uint i = 0; i < num_threads; ++i)
-			{
-				threads.emplace_back(std::bind(&ThreadPool::ThreadWork, this));
-			}
+			Job* job = AllocateJob();
+			job->function.Emplace(std::forward<F>(f));
+			job->counter = &counter;
+			counter.pending.fetch_add(1, std::memory_order_relaxed);
+			PushJob(job);
 		}
-		void Shutdown()
+
+		//executes pending jobs on the calling thread until every job of the counter has finished
+		void Wait(JobCounter& counter);
+
+		//calls f(i) for every i in [begin, end), grain is the number of consecutive indices handled by one job
+		template<typename F>
+		void ParallelFor(Uint64 begin, Uint64 end, Uint64 grain, F&& f)
 		{
-			if (!done)
+			if (begin >= end)
 			{
+				return;
+			}
+			grain = std::max<Uint64>(grain, 1);
+			Uint64 const first_chunk_end = std::min(begin + grain, end);
+			if (first_chunk_end < end && workers.size() > 1)
+			{
+				JobCounter counter;
+				for (Uint64 chunk_begin = first_chunk_end; chunk_begin < end; chunk_begin += grain)
 				{
-					std::unique_lock<std::mutex> lk(cond_mutex);
-					done = true;
-					cond_var.notify_all();
+					Uint64 const chunk_end = std::min(chunk_begin + grain, end);
+					Dispatch(counter, [&f, chunk_begin, chunk_end]()
+						{
+							for (Uint64 i = chunk_begin; i < chunk_end; ++i)
+							{
+								f(i);
+							}
+						});
 				}
-				for (Uint i = 0; i < threads.size(); ++i)
+				for (Uint64 i = begin; i < first_chunk_end; ++i)
 				{
-					if (threads[i].joinable())
-					{
-						threads[i].join();
-					}
+					f(i);
+				}
+				Wait(counter);
+			}
+			else
+			{
+				for (Uint64 i = begin; i < end; ++i)
+				{
+					f(i);
 				}
 			}
 		}
 
+		template<std::ranges::random_access_range R, typename F>
+		void ParallelForEach(R&& range, Uint64 grain, F&& f)
+		{
+			auto first = std::ranges::begin(range);
+			ParallelFor(0, (Uint64)std::ranges::size(range), grain, [&first, &f](Uint64 i) { f(first[i]); });
+		}
+
+		//for tasks that outlive the caller and may block, they only run on idle workers and never inside Wait.
+		//The packaged task is a heap allocation so prefer Dispatch for frame work
 		template<typename F, typename... Args>
-		auto Submit(F&& f, Args&&... args) 
+		auto Submit(F&& f, Args&&... args)
 		{
 			using ReturnType = std::invoke_result_t<std::decay_t<F>, std::decay_t<Args>...>;
 			auto bind_f = std::bind(std::forward<F>(f), std::forward<Args>(args)...);
 			auto wrapped_task = std::make_shared<std::packaged_task<ReturnType()>>(bind_f);
 			std::future<ReturnType> result_future = wrapped_task->get_future();
-			auto void_task = [wrapped_task]() {(*wrapped_task)(); };
-			task_queue.Push(std::move(void_task));
-			cond_var.notify_one();
+
+			Job* job = AllocateExternalJob();
+			job->function.Emplace([wrapped_task]() { (*wrapped_task)(); });
+			job->counter = &background_jobs;
+			background_jobs.pending.fetch_add(1, std::memory_order_relaxed);
+			background_job_queue.Push(job);
+			WakeWorker();
 			return result_future;
 		}
 
 	private:
+		std::vector<std::unique_ptr<Worker>> workers;
 		std::vector<std::thread> threads;
-		ConcurrentQueue<std::function<void()>> task_queue;
-		Bool done = false;
-		std::condition_variable cond_var;
-		std::mutex cond_mutex;
+		//jobs dispatched from threads that are not workers
+		ConcurrentQueue<Job*> external_jobs;
+		std::atomic<Uint32> external_job_count = 0;
+		std::unique_ptr<Job[]> external_job_pool = std::make_unique<Job[]>(JobCapacity);
+		Uint64 external_job_pool_index = 0;
+		std::mutex external_job_pool_mutex;
 
-	private:
-		ThreadPool() = default;
+		ConcurrentQueue<Job*> background_job_queue;
+		JobCounter background_jobs;
+		std::atomic<Bool> done = false;
+		std::atomic<Uint32> work_epoch = 0;
+		std::atomic<Uint32> sleeping_workers = 0;
 
-		void ThreadWork()
-		{
-			std::function <void()> task;
-			Bool pop_success;
+		static inline thread_local Int32 worker_index = -1;
 
-			while (true)
-			{
-				{
-					std::unique_lock<std::mutex> lk(cond_mutex);
-					while (!done && task_queue.Empty())
-					{
-						cond_var.wait(lk);
-					}
-
-					if (done)
-					{
-						return;
-					}
-					else
-					{
-						pop_success = task_queue.TryPop(task);
-					}
-				}
+	private:
+		ThreadPool() = default;
 
-				if (pop_success)
-				{
-					task();
-					task = nullptr;
-				}
-			}
-		}
+		Job* AllocateJob();
+		Job* AllocateExternalJob();
+		void PushJob(Job* job);
+		void WakeWorker();
+		Bool TryExecuteJob();
+		Bool TryExecuteBackgroundJob();
+		void ExecuteJob(Job* job);
+		void ThreadWork(Int32 index);
 	};
 	#define g_ThreadPool ThreadPool::Get()
-}
\ No newline at end of file
+}
@@ -0,0 +1,79 @@
+#pragma once
+#include <atomic>
+
+namespace adria
+{
+	//fixed capacity Chase-Lev deque: the owning thread pushes and pops at the bottom, other threads steal from the top.
+	//Memory orders follow "Correct and Efficient Work-Stealing for Weak Memory Models" (Le et al.)
+	template<typename T, Uint64 Capacity> requires std::is_trivially_copyable_v<T> && ((Capacity & (Capacity - 1)) == 0)
+	class WorkStealingDeque
+	{
+		static constexpr Int64 Mask = Int64(Capacity - 1);
+
+	public:
+		WorkStealingDeque() = default;
+		ADRIA_NONCOPYABLE_NONMOVABLE(WorkStealingDeque)
+
+		Bool Push(T item)
+		{
+			Int64 const b = bottom.load(std::memory_order_relaxed);
+			Int64 const t = top.load(std::memory_order_acquire);
+			if (b - t >= Int64(Capacity))
+			{
+				return false;
+			}
+			buffer[b & Mask].store(item, std::memory_order_relaxed);
+			bottom.store(b + 1, std::memory_order_release);
+			return true;
+		}
+
+		Bool Pop(T& item)
+		{
+			Int64 const b = bottom.load(std::memory_order_relaxed) - 1;
+			bottom.store(b, std::memory_order_relaxed);
+			std::atomic_thread_fence(std::memory_order_seq_cst);
+			Int64 t = top.load(std::memory_order_relaxed);
+			if (t > b)
+			{
+				bottom.store(b + 1, std::memory_order_relaxed);
+				return false;
+			}
+
+			item = buffer[b & Mask].load(std::memory_order_relaxed);
+			if (t == b)
+			{
+				//last element, race against thieves for it
+				Bool const won = top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed);
+				bottom.store(b + 1, std::memory_order_relaxed);
+				return won;
+			}
+			return true;
+		}
+
+		Bool Steal(T& item)
+		{
+			Int64 t = top.load(std::memory_order_acquire);
+			std::atomic_thread_fence(std::memory_order_seq_cst);
+			Int64 const b = bottom.load(std::memory_order_acquire);
+			if (t >= b)
+			{
+				return false;
+			}
+
+			item = buffer[t & Mask].load(std::memory_order_relaxed);
+			return top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed);
+		}
+
+		Bool Empty() const
+		{
+			Int64 const b = bottom.load(std::memory_order_relaxed);
+			Int64 const t = top.load(std::memory_order_relaxed);
+			return b <= t;
+		}
+
+	private:
+		alignas(64) std::atomic<Int64> top = 0;
+		alignas(64) std::atomic<Int64> bottom = 0;
+		alignas(64) std::atomic<T> buffer[Capacity];
+	};
+}
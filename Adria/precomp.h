@@ -28,8 +28,14 @@
 #include <type_traits>
 #include <filesystem>
 #include <chrono>
+#if defined(ADRIA_USE_FMT)
+#include <fmt/format.h>
+namespace std { using fmt::format; }
+#else
 #include <format>
+#endif
 #include <concepts>
+#include <bit>
 
 #if defined(_WIN32) || defined(_WIN64)
 #include <d3d12.h>
@@ -5,6 +5,11 @@
 
 #include <cstdint>
 
+// MSVC calling convention keyword, not understood by GCC
+#ifndef __cdecl
+#define __cdecl
+#endif
+
 // Windows RECT structure
 typedef struct tagRECT {
     long left;